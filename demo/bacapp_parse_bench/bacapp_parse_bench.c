@@ -0,0 +1,373 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * bacapp_parse_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Checks bacapp_parse_application_data against a corpus of value strings and
+ * their expected encoding, then measures parse throughput on the kind of
+ * strings writeprop/writepropm and the web service pass in.
+ *
+ *   ./bacapp_parse_bench --rounds 200000 --json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/app.h"
+#include "bacnet/config.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacnet_buf.h"
+#include "misc/cJSON.h"
+#include "debug.h"
+
+typedef struct parse_case_s {
+    const char *input;
+    const char *expected;           /* encoding in hex, NULL if parsing shall fail */
+} parse_case_t;
+
+static const parse_case_t parse_cases[] = {
+    {"null", "00"},
+    {"NULL", "00"},
+    {" null ", "00"},
+    {"\tNULL\t", "00"},
+    {"Null", NULL},
+    {"true", "11"},
+    {"TRUE", "11"},
+    {"True", "11"},
+    {"false", "10"},
+    {"FALSE", "10"},
+    {"False", "10"},
+    {"tRue", NULL},
+    {"u0", "2100"},
+    {"U42", "212a"},
+    {"u4294967295", "24ffffffff"},
+    {"u 5", NULL},
+    {"u5 ", "2105"},
+    {" u5", "2105"},
+    {"s0", "3100"},
+    {"s-1", "31ff"},
+    {"S2147483647", "347fffffff"},
+    {"s-2147483648", "3480000000"},
+    {"s+1", NULL},
+    {"f1.5", "443fc00000"},
+    {"F-0.25", "44be800000"},
+    {"f3.", "4440400000"},
+    {"f10", "4441200000"},
+    {"f0.125", "443e000000"},
+    {"lf2.5", "55084004000000000000"},
+    {"LF-1", "5508bff0000000000000"},
+    {"Lf1", NULL},
+    {"lf1.", "55083ff0000000000000"},
+    {"e3", "9103"},
+    {"E0", "9100"},
+    {"e4294967295", "94ffffffff"},
+    {"b", "8100"},
+    {"b1", "820780"},
+    {"b10110", "8203b0"},
+    {"B111100001", "8307f080"},
+    {"b102", NULL},
+    {"x", "60"},
+    {"x0a", "610a"},
+    {"XDEADbeef", "64deadbeef"},
+    {"x0", NULL},
+    {"xzz", NULL},
+    {"X00ff10", "6300ff10"},
+    {"c:hello", "75060068656c6c6f"},
+    {"c: hi", "7400206869"},
+    {"c:hi there ", "7509006869207468657265"},
+    {"c0:abc", "7400616263"},
+    {"c4:abc", "7404616263"},
+    {"cx", "7100"},
+    {"cx4142", "73004142"},
+    {"c9:abc", NULL},
+    {"c:", "7100"},
+    {"C3:x", "720378"},
+    {"c", NULL},
+    {"cx414", NULL},
+    {"d2024.1.2.3", "a47c010203"},
+    {"d...", "a4ffffffff"},
+    {"d2024...", "a47cffffff"},
+    {"d.12.31.", "a4ff0c1fff"},
+    {"d1899.1.1.1", NULL},
+    {"d2024.13.1.1", NULL},
+    {"d24.1.1.1", NULL},
+    {"d2024.1.1.8", NULL},
+    {"d2154.12.31.7", "a4fe0c1f07"},
+    {"d2155.1.1.1", NULL},
+    {"d2024.0.1.1", NULL},
+    {"d2024.1.32.1", NULL},
+    {"t12:30:45.50", "b40c1e2d32"},
+    {"t::.", "b4ffffffff"},
+    {"t1:2:3.4", "b401020304"},
+    {"t24:0:0.0", NULL},
+    {"t12:60:0.0", NULL},
+    {"t23:59:59.99", "b4173b3b63"},
+    {"t1:2:3.100", NULL},
+    {"T::5.", "b4ffff05ff"},
+    {"o8.1", "c402000001"},
+    {"O0.4194303", "c4003fffff"},
+    {"o8.4194304", NULL},
+    {"o1023.1", "c4ffc00001"},
+    {"o200.1", "c432000001"},
+    {"3:u5", "3905"},
+    {"3: u5", "3905"},
+    {"20:f1.5", "fc143fc00000"},
+    {"1:null", "18"},
+    {"2:true", "2901"},
+    {"2:false", "2900"},
+    {"0:b101", "0a05a0"},
+    {"5:c:xyz", "5c0078797a"},
+    {"16:x0102", "fa100102"},
+    {"256:u1", NULL},
+    {"3 :u5", NULL},
+    {"14:e7", "e907"},
+    {"15:s-5", "f90ffb"},
+    {"7:d2024.6.1.6", "7c7c060106"},
+    {"8:t1:2:3.4", "8c01020304"},
+    {"9:o8.1", "9c02000001"},
+    {"4:lf1.5", "4d083ff8000000000000"},
+    {"3?0a0b", "3a0a0b"},
+    {"3?", "38"},
+    {"16?ff", "f910ff"},
+    {"3?0", NULL},
+    {"1{u5}1", "1e21051f"},
+    {"1{u5}", "1e21051f"},
+    {"1{2{u5}2}1", "1e2e21052f1f"},
+    {"1{,u5,}1", "1e21051f"},
+    {"1{ u5 , u6 }1", "1e210521061f"},
+    {"0{1:u5,2:c:ab}0", "0e19052b0061620f"},
+    {"}1", NULL},
+    {"1{u5}2", NULL},
+    {"1{}1", "1e1f"},
+    {"1{", NULL},
+    {"2{1{u5}1}2", "2e1e21051f2f"},
+    {"20{u1}20", "fe142101ff14"},
+    {"1{u5} 1", NULL},
+    {"u4294967296", NULL},
+    {"e4294967296", NULL},
+    {"s2147483648", NULL},
+    {"s-2147483649", NULL},
+    {"99999999999:u1", NULL},
+    {"1{,u5,}", "1e21051f"},
+    {"}", NULL},
+    {"1{u5}}", NULL},
+    {"c:a}b", "7400617d62"},
+    {"u5,u6,u7", "210521062107"},
+    {"u5,,u6", "21052106"},
+    {"", NULL},
+    {"   ", NULL},
+    {"foo", NULL},
+    {"u", NULL},
+    {"s-", NULL},
+    {"f-", NULL},
+    {"f.5", NULL},
+    {"12", NULL},
+    {"1{2{3{4{5{6{7{8{9{10{11{12{13{14{15{16{u1}16}15}14}13}12}11}10}9}8}7}6}5}4}3}2}1", "1e2e3e4e5e6e7e8e9eaebecedeeefe0ffe102101ff10ff0fefdfcfbfaf9f8f7f6f5f4f3f2f1f"},
+    {"1{2{3{4{5{6{7{8{9{10{11{12{13{14{15{16{17{u1}17}16}15}14}13}12}11}10}9}8}7}6}5}4}3}2}1", NULL},
+};
+
+#define PARSE_CASE_COUNT            (sizeof(parse_cases) / sizeof(parse_cases[0]))
+
+static const char *bench_inputs[] = {
+    "f21.5",
+    "null",
+    "u1",
+    "e1",
+    "true",
+    "c:Zone 1 Temperature Setpoint",
+    "b0100",
+    "d2024.6.1.6",
+    "t8:30:0.0",
+    "1{0:o0.1,1:e85,2{f20.5}2}1",
+    "0{0:d2024.6.1.6,1:t8:0:0.0}0,0{0:d2024.6.1.6,1:t17:30:0.0}0",
+    "u5,u6,u7,u8,u9,u10,u11,u12",
+};
+
+#define BENCH_INPUT_COUNT           (sizeof(bench_inputs) / sizeof(bench_inputs[0]))
+
+static struct {
+    uint32_t rounds;
+    bool verbose;
+    bool json;
+} opt = {
+    .rounds = 200000,
+};
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void to_hex(const uint8_t *data, uint32_t len, char *hex)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        sprintf(hex + i * 2, "%02x", data[i]);
+    }
+    hex[len * 2] = 0;
+}
+
+/* return the number of cases whose result differs from the expected one */
+static uint32_t check_corpus(void)
+{
+    DECLARE_BACNET_BUF(apdu, MAX_APDU);
+    char hex[MAX_APDU * 2 + 1];
+    const parse_case_t *c;
+    uint32_t i, failed;
+    bool ok;
+
+    failed = 0;
+    for (i = 0; i < PARSE_CASE_COUNT; i++) {
+        c = &parse_cases[i];
+        bacnet_buf_init(&apdu.buf, MAX_APDU);
+        ok = bacapp_parse_application_data(&apdu.buf, c->input);
+        to_hex(apdu.buf.data, apdu.buf.data_len, hex);
+
+        if ((ok != (c->expected != NULL)) || (ok && strcmp(hex, c->expected))) {
+            printf("mismatch \"%s\": %s %s, expected %s\r\n", c->input, ok? "ok": "failed", hex,
+                c->expected? c->expected: "failed");
+            failed++;
+        } else if (opt.verbose) {
+            printf("%-40s %s\r\n", c->input, ok? hex: "failed");
+        }
+    }
+
+    return failed;
+}
+
+static double bench_parse(uint32_t rounds, uint64_t *bytes, uint32_t *failed)
+{
+    DECLARE_BACNET_BUF(apdu, MAX_APDU);
+    uint64_t begin, elapsed;
+    uint32_t i, j;
+
+    *bytes = 0;
+    *failed = 0;
+    for (j = 0; j < BENCH_INPUT_COUNT; j++) {
+        *bytes += strlen(bench_inputs[j]);
+    }
+    *bytes *= rounds;
+
+    begin = now_us();
+    for (i = 0; i < rounds; i++) {
+        for (j = 0; j < BENCH_INPUT_COUNT; j++) {
+            bacnet_buf_init(&apdu.buf, MAX_APDU);
+            if (!bacapp_parse_application_data(&apdu.buf, bench_inputs[j])) {
+                (*failed)++;
+            }
+        }
+    }
+    elapsed = now_us() - begin;
+
+    return elapsed? elapsed: 1;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --rounds N          passes over the bench strings (200000)\r\n"
+        "  --verbose           print the encoding of every corpus case\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"rounds", required_argument, NULL, 'r'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'r': opt.rounds = strtoul(optarg, NULL, 0); break;
+        case 'v': opt.verbose = true; break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t mismatched, failed, parses;
+    uint64_t bytes;
+    double elapsed_us;
+    cJSON *report;
+    char *str;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    /* the corpus has many invalid strings, keep their errors quiet */
+    app_set_dbg_level(0);
+
+    mismatched = check_corpus();
+    elapsed_us = bench_parse(opt.rounds, &bytes, &failed);
+    parses = opt.rounds * BENCH_INPUT_COUNT;
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "corpus_cases", PARSE_CASE_COUNT);
+    cJSON_AddNumberToObject(report, "corpus_mismatched", mismatched);
+    cJSON_AddNumberToObject(report, "parses", parses);
+    cJSON_AddNumberToObject(report, "parse_failed", failed);
+    cJSON_AddNumberToObject(report, "ns_per_parse", elapsed_us * 1000.0 / parses);
+    cJSON_AddNumberToObject(report, "parses_per_sec", parses * 1000000.0 / elapsed_us);
+    cJSON_AddNumberToObject(report, "mbytes_per_sec", bytes / elapsed_us);
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("corpus %u cases, %u mismatched\r\n", (uint32_t)PARSE_CASE_COUNT, mismatched);
+        printf("parse  %10.1f ns %12.0f parses/s %8.1f MB/s\r\n", elapsed_us * 1000.0 / parses,
+            parses * 1000000.0 / elapsed_us, bytes / elapsed_us);
+    }
+
+    cJSON_Delete(report);
+
+    return (mismatched || failed)? -EPERM: OK;
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * bactext_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Renders an object-list reply as JSON text the way the web service does,
+ * naming every object type, property and unit, once through the bactext
+ * direct-indexed tables and once through the linear INDTEXT_DATA scan they
+ * replaced. Reverse name lookups are timed the same way. Every table is
+ * checked against the linear scan before anything is timed.
+ *
+ *   ./bactext_bench --objects 1000 --rounds 200 --json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/app.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bactext.h"
+#include "bacnet/indtext.h"
+#include "misc/cJSON.h"
+#include "debug.h"
+
+#define MAX_OBJECTS                 (65536)
+#define REPLY_SIZE                  (4 * 1024 * 1024)
+
+extern INDTEXT_DATA bacnet_object_type_names[];
+extern INDTEXT_DATA bacnet_property_names[];
+extern INDTEXT_DATA bacnet_event_state_names[];
+extern INDTEXT_DATA bacnet_engineering_unit_names[];
+extern INDTEXT_DATA bacnet_binary_polarity_names[];
+extern INDTEXT_DATA bacnet_binary_present_value_names[];
+extern INDTEXT_DATA bacnet_reliability_names[];
+extern INDTEXT_DATA bacnet_device_status_names[];
+extern INDTEXT_DATA bacnet_segmentation_names[];
+extern INDTEXT_DATA bacnet_node_type_names[];
+extern INDTEXT_DATA bacnet_day_of_week_names[];
+extern INDTEXT_DATA bacnet_month_names[];
+extern INDTEXT_DATA bacnet_error_class_names[];
+extern INDTEXT_DATA bacnet_error_code_names[];
+
+static const char ASHRAE_Reserved_String[] = "Reserved for Use by ASHRAE";
+static const char Vendor_Proprietary_String[] = "Vendor Proprietary Value";
+
+typedef struct {
+    const char *name;
+    INDTEXT_DATA *list;
+    uint32_t split;
+    const char *(*by_index)(uint32_t index);
+    int (*by_name)(const char *name);
+} text_table_t;
+
+static const text_table_t tables[] = {
+    {"object_type", bacnet_object_type_names, 128, bactext_object_type_name,
+        bactext_object_type_index},
+    {"property", bacnet_property_names, 512, bactext_property_name, bactext_property_index},
+    {"event_state", bacnet_event_state_names, 0, bactext_event_state_name,
+        bactext_event_state_index},
+    {"engineering_unit", bacnet_engineering_unit_names, 256, bactext_engineering_unit_name,
+        bactext_engineering_unit_index},
+    {"binary_polarity", bacnet_binary_polarity_names, 0, bactext_binary_polarity_name,
+        bactext_binary_polarity_index},
+    {"binary_present_value", bacnet_binary_present_value_names, 0,
+        bactext_binary_present_value_name, bactext_binary_present_value_index},
+    {"reliability", bacnet_reliability_names, 0, bactext_reliability_name,
+        bactext_reliability_index},
+    {"device_status", bacnet_device_status_names, 0, bactext_device_status_name,
+        bactext_device_status_index},
+    {"segmentation", bacnet_segmentation_names, 0, bactext_segmentation_name,
+        bactext_segmentation_index},
+    {"node_type", bacnet_node_type_names, 0, bactext_node_type_name, bactext_node_type_index},
+    {"day_of_week", bacnet_day_of_week_names, 0, bactext_day_of_week_name,
+        bactext_day_of_week_index},
+    {"month", bacnet_month_names, 0, bactext_month_name, bactext_month_index},
+    {"error_class", bacnet_error_class_names, FIRST_PROPRIETARY_ERROR_CLASS,
+        bactext_error_class_name, bactext_error_class_index},
+    {"error_code", bacnet_error_code_names, FIRST_PROPRIETARY_ERROR_CLASS,
+        bactext_error_code_name, bactext_error_code_index},
+};
+
+/* the properties every object of the reply lists, Units only on analog objects */
+static const uint32_t reply_props[] = {
+    PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_PRESENT_VALUE,
+    PROP_DESCRIPTION, PROP_STATUS_FLAGS, PROP_EVENT_STATE, PROP_RELIABILITY,
+    PROP_OUT_OF_SERVICE, PROP_PRIORITY_ARRAY, PROP_RELINQUISH_DEFAULT, PROP_PROPERTY_LIST,
+};
+
+static const uint32_t reply_types[] = {
+    OBJECT_ANALOG_INPUT, OBJECT_ANALOG_OUTPUT, OBJECT_ANALOG_VALUE, OBJECT_BINARY_INPUT,
+    OBJECT_BINARY_OUTPUT, OBJECT_BINARY_VALUE, OBJECT_MULTI_STATE_INPUT,
+    OBJECT_MULTI_STATE_OUTPUT, OBJECT_MULTI_STATE_VALUE, OBJECT_TRENDLOG,
+};
+
+static struct {
+    uint32_t objects;
+    uint32_t rounds;
+    bool json;
+} opt = {
+    .objects = 1000,
+    .rounds = 200,
+};
+
+static char reply[REPLY_SIZE];
+
+/* keeps the results alive */
+static volatile uint32_t sink;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static const char *linear_name(const text_table_t *table, uint32_t index)
+{
+    if (table->split == 0) {
+        return indtext_by_index_default(table->list, index, ASHRAE_Reserved_String);
+    }
+
+    return indtext_by_index_split_default(table->list, index, table->split,
+        ASHRAE_Reserved_String, Vendor_Proprietary_String);
+}
+
+static int linear_index(const text_table_t *table, const char *name)
+{
+    INDTEXT_DATA *data;
+
+    for (data = table->list; data->pString; data++) {
+        if (strcasecmp(data->pString, name) == 0) {
+            return data->index;
+        }
+    }
+
+    return -EPERM;
+}
+
+static uint32_t check_tables(void)
+{
+    static const uint32_t far[] = {
+        4095, 4096, 65535, 65536, 0x3FFFFF, 0xFFFFFFFF,
+    };
+    const text_table_t *table;
+    INDTEXT_DATA *data;
+    char upper[128];
+    uint32_t failed, i, j;
+
+    failed = 0;
+    for (i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        table = &tables[i];
+        for (j = 0; j < 1024 + sizeof(far) / sizeof(far[0]); j++) {
+            uint32_t index = (j < 1024)? j: far[j - 1024];
+            if (strcmp(table->by_index(index), linear_name(table, index)) != 0) {
+                printf("%s: %s name of %u differs\r\n", __func__, table->name, index);
+                failed++;
+            }
+        }
+
+        for (data = table->list; data->pString; data++) {
+            for (j = 0; data->pString[j] && (j < sizeof(upper) - 1); j++) {
+                upper[j] = toupper((uint8_t)data->pString[j]);
+            }
+            upper[j] = 0;
+            if ((table->by_name(data->pString) != linear_index(table, data->pString))
+                    || (table->by_name(upper) != linear_index(table, data->pString))) {
+                printf("%s: %s index of \"%s\" differs\r\n", __func__, table->name,
+                    data->pString);
+                failed++;
+            }
+        }
+
+        if ((table->by_name("no-such-name") != -EPERM) || (table->by_name(NULL) != -EINVAL)) {
+            printf("%s: %s unknown name not rejected\r\n", __func__, table->name);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/* one object-list reply, each object with its type, instance, properties and units */
+static uint32_t render_reply(uint32_t n, bool linear)
+{
+    const text_table_t *type_table, *prop_table, *unit_table;
+    uint32_t i, j, type, len;
+
+    type_table = &tables[0];
+    prop_table = &tables[1];
+    unit_table = &tables[3];
+
+    len = snprintf(reply, REPLY_SIZE, "{\"object_list\":[");
+    for (i = 0; i < n; i++) {
+        type = reply_types[i % (sizeof(reply_types) / sizeof(reply_types[0]))];
+        len += snprintf(reply + len, REPLY_SIZE - len, "%s{\"type\":\"%s\",\"instance\":%u,"
+            "\"properties\":[", i? ",": "",
+            linear? linear_name(type_table, type): bactext_object_type_name(type), i);
+        for (j = 0; j < sizeof(reply_props) / sizeof(reply_props[0]); j++) {
+            len += snprintf(reply + len, REPLY_SIZE - len, "%s\"%s\"", j? ",": "",
+                linear? linear_name(prop_table, reply_props[j]):
+                bactext_property_name(reply_props[j]));
+        }
+        if (type <= OBJECT_ANALOG_VALUE) {
+            len += snprintf(reply + len, REPLY_SIZE - len, "],\"%s\":\"%s\"}",
+                linear? linear_name(prop_table, PROP_UNITS): bactext_property_name(PROP_UNITS),
+                linear? linear_name(unit_table, i % 190): bactext_engineering_unit_name(i % 190));
+        } else {
+            len += snprintf(reply + len, REPLY_SIZE - len, "]}");
+        }
+        if (len >= REPLY_SIZE - 1024) {
+            break;
+        }
+    }
+    len += snprintf(reply + len, REPLY_SIZE - len, "]}");
+
+    return len;
+}
+
+static void add_result(cJSON *report, const char *name, uint64_t ns, uint64_t ops,
+                const char *unit)
+{
+    double per_op;
+
+    per_op = ops? (double)ns / ops: 0;
+    cJSON_AddNumberToObject(report, name, per_op);
+    if (!opt.json) {
+        printf("%-28s %10.2f ns/%s\r\n", name, per_op, unit);
+    }
+}
+
+static void bench(cJSON *report, uint32_t n, uint32_t rounds)
+{
+    const text_table_t *prop_table;
+    INDTEXT_DATA *data;
+    uint64_t begin, lookups;
+    uint32_t r, len, count;
+
+    len = render_reply(n, false);
+    if (len != render_reply(n, true)) {
+        printf("%s: rendered replies differ\r\n", __func__);
+    }
+    cJSON_AddNumberToObject(report, "reply_bytes", len);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        sink += render_reply(n, false);
+    }
+    add_result(report, "render_direct", now_ns() - begin, (uint64_t)n * rounds, "object");
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        sink += render_reply(n, true);
+    }
+    add_result(report, "render_linear", now_ns() - begin, (uint64_t)n * rounds, "object");
+
+    /* the name lookups alone, without the formatting */
+    prop_table = &tables[1];
+    for (count = 0; prop_table->list[count].pString; count++) {
+        ;
+    }
+
+    lookups = (uint64_t)count * rounds * 10;
+    begin = now_ns();
+    for (r = 0; r < rounds * 10; r++) {
+        for (data = prop_table->list; data->pString; data++) {
+            sink += (uintptr_t)bactext_property_name(data->index);
+        }
+    }
+    add_result(report, "property_name_direct", now_ns() - begin, lookups, "lookup");
+
+    begin = now_ns();
+    for (r = 0; r < rounds * 10; r++) {
+        for (data = prop_table->list; data->pString; data++) {
+            sink += (uintptr_t)linear_name(prop_table, data->index);
+        }
+    }
+    add_result(report, "property_name_linear", now_ns() - begin, lookups, "lookup");
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (data = prop_table->list; data->pString; data++) {
+            sink += bactext_property_index(data->pString);
+        }
+    }
+    lookups = (uint64_t)count * rounds;
+    add_result(report, "property_index_hash", now_ns() - begin, lookups, "lookup");
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (data = prop_table->list; data->pString; data++) {
+            sink += linear_index(prop_table, data->pString);
+        }
+    }
+    add_result(report, "property_index_linear", now_ns() - begin, lookups, "lookup");
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --objects N         objects in the reply (1000, at most 65536)\r\n"
+        "  --rounds N          replies rendered per variant (200)\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"objects", required_argument, NULL, 'n'},
+        {"rounds", required_argument, NULL, 'r'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'n': opt.objects = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.rounds = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.objects == 0) || (opt.objects > MAX_OBJECTS) || (opt.rounds == 0)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *report;
+    uint32_t failed;
+    char *str;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    app_set_dbg_level(DEBUG_LEVEL_WARN | DEBUG_LEVEL_ERROR);
+
+    failed = check_tables();
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "objects", opt.objects);
+    cJSON_AddNumberToObject(report, "rounds", opt.rounds);
+    cJSON_AddNumberToObject(report, "check_failed", failed);
+    if (!opt.json) {
+        printf("objects %u, rounds %u, %u check failed\r\n", opt.objects, opt.rounds, failed);
+    }
+
+    bench(report, opt.objects, opt.rounds);
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    }
+
+    cJSON_Delete(report);
+
+    return failed? -EPERM: OK;
+}
@@ -0,0 +1,909 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * bench_suite.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Regression benchmark of the hot paths of the stack, run by "make bench".
+ * Every case reports ns/op and libbacnet heap allocations per op, keeping the
+ * fastest of --repeat passes. Workloads are generated from --seed, so two
+ * builds run on the same machine see the same requests:
+ *   npdu_encode_pci/npdu_decode_pci      routed NPCI of 1k peers
+ *   object_find                          random lookups in a 10k object DB
+ *   apdu_handler                         ReadProperty dispatch on that DB
+ *   handler_read_property_multiple       4 objects x 3 properties
+ *   tsm_alloc_invokeID/tsm_free_invokeID 2k invokers over 1k peers
+ *   el_timer_create/el_timer_destroy     2k live timers
+ *
+ *   ./bench_suite --json --output new.json
+ *   ./bench_suite --baseline old.json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/app.h"
+#include "bacnet/apdu.h"
+#include "bacnet/tsm.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/service/rp.h"
+#include "bacnet/service/rpm.h"
+#include "bacnet/object/object.h"
+#include "bacnet/network/npdu.h"
+#include "misc/eventloop.h"
+#include "misc/cJSON.h"
+#include "debug.h"
+
+#define BENCH_OBJECTS               (10000)
+#define BENCH_PEERS                 (1024)
+#define BENCH_INVOKERS              (2048)
+#define BENCH_TIMERS                (2048)
+
+#define NPDU_OPS                    (64 * BENCH_PEERS)
+#define FIND_OPS                    (1 << 18)
+#define RP_REQUESTS                 (1024)
+#define RP_OPS                      (64 * RP_REQUESTS)
+#define RPM_OBJECTS                 (4)
+#define RPM_OPS                     (16384)
+#define TSM_CYCLES                  (16)
+#define TIMER_CYCLES                (16)
+
+static const char *bench_types[] = {
+    "AI",
+    "AO",
+    "AV",
+    "BI",
+    "BO",
+    "BV",
+};
+
+static const BACNET_OBJECT_TYPE bench_type_ids[] = {
+    OBJECT_ANALOG_INPUT,
+    OBJECT_ANALOG_OUTPUT,
+    OBJECT_ANALOG_VALUE,
+    OBJECT_BINARY_INPUT,
+    OBJECT_BINARY_OUTPUT,
+    OBJECT_BINARY_VALUE,
+};
+
+#define BENCH_TYPE_COUNT            (sizeof(bench_types) / sizeof(bench_types[0]))
+#define PER_TYPE                    (BENCH_OBJECTS / BENCH_TYPE_COUNT)
+
+typedef struct bench_sample_s {
+    uint64_t ns;
+    uint64_t allocs;
+    uint64_t ops;
+    uint64_t begin;
+    uint64_t begin_allocs;
+} bench_sample_t;
+
+typedef struct bench_case_s {
+    const char *name;
+    int (*run)(bench_sample_t *sample);
+} bench_case_t;
+
+typedef struct text_buf_s {
+    char *data;
+    size_t len;
+    size_t size;
+} text_buf_t;
+
+static struct {
+    uint32_t seed;
+    uint32_t repeat;
+    const char *filter;
+    const char *output;
+    const char *baseline;
+    bool json;
+} opt = {
+    .seed = 1,
+    .repeat = 5,
+};
+
+/* counted by the --wrap'ed allocators below */
+static uint64_t alloc_count;
+
+static uint32_t rand_state;
+
+static bacnet_addr_t peers[BENCH_PEERS];
+
+static bacnet_addr_t local_src;
+
+static tsm_invoker_t *invokers[BENCH_INVOKERS];
+
+static el_timer_t *timers[BENCH_TIMERS];
+
+/* keeps the results alive */
+static volatile uint32_t sink;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    alloc_count++;
+
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    alloc_count++;
+
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    alloc_count++;
+
+    return __real_realloc(ptr, size);
+}
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* xorshift32, the sequence only depends on --seed */
+static uint32_t bench_rand(void)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static void sample_begin(bench_sample_t *sample)
+{
+    sample->begin_allocs = alloc_count;
+    sample->begin = now_ns();
+}
+
+static void sample_end(bench_sample_t *sample, uint64_t ops)
+{
+    sample->ns += now_ns() - sample->begin;
+    sample->allocs += alloc_count - sample->begin_allocs;
+    sample->ops += ops;
+}
+
+static int text_printf(text_buf_t *buf, const char *fmt, ...)
+{
+    va_list ap;
+    char *data;
+    int len;
+
+    for (;;) {
+        va_start(ap, fmt);
+        len = vsnprintf(buf->data + buf->len, buf->size - buf->len, fmt, ap);
+        va_end(ap);
+        if (len < 0) {
+            return -EINVAL;
+        }
+        if (buf->len + len < buf->size) {
+            buf->len += len;
+            return OK;
+        }
+
+        data = (char *)realloc(buf->data, buf->size * 2);
+        if (data == NULL) {
+            return -ENOMEM;
+        }
+        buf->data = data;
+        buf->size *= 2;
+    }
+}
+
+/* the 10k object DB, same shape as the object_bench one */
+cJSON *bacnet_get_app_cfg(void)
+{
+    text_buf_t buf;
+    cJSON *cfg;
+    uint32_t i, t;
+    int rv;
+
+    buf.size = 4096;
+    buf.len = 0;
+    buf.data = (char *)malloc(buf.size);
+    if (buf.data == NULL) {
+        return NULL;
+    }
+
+    rv = text_printf(&buf, "{\n\t\"Device_Id\": 1,\n\t\"Device_Name\": \"bench_suite\",\n"
+        "\t\"Object_List\": [");
+    for (t = 0; (t < BENCH_TYPE_COUNT) && (rv == OK); t++) {
+        rv = text_printf(&buf, "%s{\n\t\t\"Type\": \"%s\",\n\t\t\"Instance_List\": [",
+            t? ", ": "", bench_types[t]);
+        for (i = 0; (i < PER_TYPE) && (rv == OK); i++) {
+            rv = text_printf(&buf, "%s{\n\t\t\t\"Name\": \"%s_%u\",\n"
+                "\t\t\t\"Out_Of_Service\": false", i? ", ": "", bench_types[t], i);
+            if ((rv == OK) && (t < 3)) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Units\": 62");
+            } else if (rv == OK) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Active_Text\": \"on\","
+                    "\n\t\t\t\"Inactive_Text\": \"off\",\n\t\t\t\"Polarity\": 0");
+            }
+            if ((rv == OK) && ((t == 1) || (t == 2) || (t == 4))) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Relinquish_Default\": 0");
+            }
+            if (rv == OK) {
+                rv = text_printf(&buf, "\n\t\t}");
+            }
+        }
+        if (rv == OK) {
+            rv = text_printf(&buf, "]\n\t}");
+        }
+    }
+    if (rv == OK) {
+        rv = text_printf(&buf, "]\n}\n");
+    }
+
+    cfg = (rv == OK)? cJSON_Parse(buf.data): NULL;
+    free(buf.data);
+
+    return cfg;
+}
+
+/* peer i sits behind router network 100 + i / 256 with a B/IP mac */
+static void make_peers(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_PEERS; i++) {
+        peers[i].net = 100 + i / 256;
+        peers[i].len = 6;
+        peers[i].adr[0] = 192;
+        peers[i].adr[1] = 168;
+        peers[i].adr[2] = i >> 8;
+        peers[i].adr[3] = i & 0xFF;
+        peers[i].adr[4] = 0xBA;
+        peers[i].adr[5] = 0xC0;
+    }
+
+    local_src.net = 0;
+    local_src.len = 6;
+    memcpy(local_src.adr, peers[0].adr, 6);
+}
+
+static void random_object(BACNET_OBJECT_TYPE *type, uint32_t *instance)
+{
+    uint32_t r;
+
+    r = bench_rand();
+    *type = bench_type_ids[r % BENCH_TYPE_COUNT];
+    *instance = (r >> 8) % PER_TYPE;
+}
+
+static int bench_npdu_encode(bench_sample_t *sample)
+{
+    static npci_info_t pci[BENCH_PEERS];
+    DECLARE_BACNET_BUF(npdu, MAX_APDU);
+    bacnet_addr_t src;
+    uint32_t i, n;
+
+    src.net = 5;
+    src.len = 1;
+    src.adr[0] = 1;
+    for (i = 0; i < BENCH_PEERS; i++) {
+        if (npdu_get_npci_info(&pci[i], &peers[i], &src, PRIORITY_NORMAL, true,
+                INVALID_NETWORK_MESSAGE_TYPE) < 0) {
+            return -EPERM;
+        }
+    }
+
+    (void)bacnet_buf_init(&npdu.buf, MAX_APDU);
+    npdu.buf.data_len = MAX_APDU;
+
+    sample_begin(sample);
+    for (n = 0; n < NPDU_OPS; n++) {
+        if (npdu_encode_pci(&npdu.buf, &pci[n % BENCH_PEERS]) < 0) {
+            return -EPERM;
+        }
+        sink += npdu.buf.data[2];
+    }
+    sample_end(sample, NPDU_OPS);
+
+    return OK;
+}
+
+static int bench_npdu_decode(bench_sample_t *sample)
+{
+    static uint8_t headers[BENCH_PEERS][MAX_NPCI_LEN + 16];
+    DECLARE_BACNET_BUF(npdu, MAX_APDU);
+    npci_info_t pci;
+    bacnet_addr_t src;
+    uint32_t i, n;
+
+    src.net = 5;
+    src.len = 1;
+    src.adr[0] = 1;
+    (void)bacnet_buf_init(&npdu.buf, MAX_APDU);
+    for (i = 0; i < BENCH_PEERS; i++) {
+        if (npdu_get_npci_info(&pci, &peers[i], &src, PRIORITY_NORMAL, true,
+                INVALID_NETWORK_MESSAGE_TYPE) < 0) {
+            return -EPERM;
+        }
+        npdu.buf.data = headers[i];
+        npdu.buf.data_len = sizeof(headers[i]);
+        if (npdu_encode_pci(&npdu.buf, &pci) < 0) {
+            return -EPERM;
+        }
+    }
+
+    sample_begin(sample);
+    for (n = 0; n < NPDU_OPS; n++) {
+        npdu.buf.data = headers[n % BENCH_PEERS];
+        npdu.buf.data_len = sizeof(headers[0]);
+        if (npdu_decode_pci(&npdu.buf, &pci) < 0) {
+            return -EPERM;
+        }
+        sink += pci.nud_offset;
+    }
+    sample_end(sample, NPDU_OPS);
+
+    return OK;
+}
+
+static int bench_object_find(bench_sample_t *sample)
+{
+    static BACNET_OBJECT_TYPE types[4096];
+    static uint32_t instances[4096];
+    uint32_t i, missed;
+
+    for (i = 0; i < 4096; i++) {
+        random_object(&types[i], &instances[i]);
+    }
+
+    missed = 0;
+    sample_begin(sample);
+    for (i = 0; i < FIND_OPS; i++) {
+        if (object_find(types[i & 4095], instances[i & 4095]) == NULL) {
+            missed++;
+        }
+    }
+    sample_end(sample, FIND_OPS);
+
+    return missed? -EPERM: OK;
+}
+
+static uint8_t bench_reply_type(bacnet_buf_t *reply)
+{
+    return reply->data_len? (reply->data[0] >> 4): 0xFF;
+}
+
+static int bench_apdu_handler(bench_sample_t *sample)
+{
+    static uint8_t requests[RP_REQUESTS][32];
+    static uint32_t request_len[RP_REQUESTS];
+    DECLARE_BACNET_BUF(apdu, MAX_APDU);
+    DECLARE_BACNET_BUF(reply, MAX_APDU);
+    BACNET_OBJECT_TYPE type;
+    uint32_t instance, i, n;
+
+    for (i = 0; i < RP_REQUESTS; i++) {
+        random_object(&type, &instance);
+        (void)bacnet_buf_init(&apdu.buf, MAX_APDU);
+        if (rp_encode_apdu(&apdu.buf, i & 0xFF, type, instance, PROP_PRESENT_VALUE,
+                BACNET_ARRAY_ALL) < 0) {
+            return -EPERM;
+        }
+        if (apdu.buf.data_len > sizeof(requests[i])) {
+            return -EPERM;
+        }
+        memcpy(requests[i], apdu.buf.data, apdu.buf.data_len);
+        request_len[i] = apdu.buf.data_len;
+    }
+
+    apdu.buf.data = requests[0];
+    apdu.buf.data_len = request_len[0];
+    (void)bacnet_buf_init(&reply.buf, MAX_APDU);
+    apdu_handler(&apdu.buf, true, &reply.buf, &local_src);
+    if (bench_reply_type(&reply.buf) != PDU_TYPE_COMPLEX_ACK) {
+        return -EPERM;
+    }
+
+    sample_begin(sample);
+    for (n = 0; n < RP_OPS; n++) {
+        apdu.buf.data = requests[n % RP_REQUESTS];
+        apdu.buf.data_len = request_len[n % RP_REQUESTS];
+        (void)bacnet_buf_init(&reply.buf, MAX_APDU);
+        apdu_handler(&apdu.buf, true, &reply.buf, &local_src);
+        sink += reply.buf.data_len;
+    }
+    sample_end(sample, RP_OPS);
+
+    return OK;
+}
+
+static int bench_rpm_handler(bench_sample_t *sample)
+{
+    static const BACNET_PROPERTY_ID props[] = {
+        PROP_PRESENT_VALUE,
+        PROP_STATUS_FLAGS,
+        PROP_OBJECT_NAME,
+    };
+    DECLARE_BACNET_BUF(request, MAX_APDU);
+    DECLARE_BACNET_BUF(reply, MAX_APDU);
+    BACNET_CONFIRMED_SERVICE_DATA service_data;
+    BACNET_OBJECT_TYPE type;
+    uint32_t instance, i, j, n;
+
+    (void)bacnet_buf_init(&request.buf, MAX_APDU);
+    for (i = 0; i < RPM_OBJECTS; i++) {
+        random_object(&type, &instance);
+        if (!rpm_req_encode_object(&request.buf, type, instance)) {
+            return -EPERM;
+        }
+        for (j = 0; j < sizeof(props) / sizeof(props[0]); j++) {
+            if (!rpm_req_encode_property(&request.buf, props[j], BACNET_ARRAY_ALL)) {
+                return -EPERM;
+            }
+        }
+    }
+    if (!rpm_req_encode_end(&request.buf, 1)) {
+        return -EPERM;
+    }
+
+    /* what apdu_handler hands the service handler, 4 bytes of confirmed PCI */
+    memset(&service_data, 0, sizeof(service_data));
+    service_data.max_resp = MAX_APDU;
+    service_data.invoke_id = 1;
+    service_data.service_choice = SERVICE_CONFIRMED_READ_PROP_MULTIPLE;
+    service_data.service_request = request.buf.data + 4;
+    service_data.service_request_len = request.buf.data_len - 4;
+    service_data.pci_len = 4;
+
+    (void)bacnet_buf_init(&reply.buf, MAX_APDU);
+    handler_read_property_multiple(&service_data, &reply.buf, &local_src);
+    if (bench_reply_type(&reply.buf) != PDU_TYPE_COMPLEX_ACK) {
+        return -EPERM;
+    }
+
+    sample_begin(sample);
+    for (n = 0; n < RPM_OPS; n++) {
+        (void)bacnet_buf_init(&reply.buf, MAX_APDU);
+        handler_read_property_multiple(&service_data, &reply.buf, &local_src);
+        sink += reply.buf.data_len;
+    }
+    sample_end(sample, RPM_OPS);
+
+    return OK;
+}
+
+static void bench_invoker_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu,
+                BACNET_PDU_TYPE apdu_type)
+{
+    return;
+}
+
+static int tsm_fill(bench_sample_t *sample)
+{
+    uint32_t i;
+
+    if (sample) {
+        sample_begin(sample);
+    }
+    for (i = 0; i < BENCH_INVOKERS; i++) {
+        invokers[i] = tsm_alloc_invokeID(&peers[i % BENCH_PEERS],
+            SERVICE_CONFIRMED_READ_PROPERTY, bench_invoker_handler, NULL);
+        if (invokers[i] == NULL) {
+            return -EPERM;
+        }
+    }
+    if (sample) {
+        sample_end(sample, BENCH_INVOKERS);
+    }
+
+    return OK;
+}
+
+static void tsm_drain(bench_sample_t *sample)
+{
+    uint32_t i;
+
+    if (sample) {
+        sample_begin(sample);
+    }
+    for (i = 0; i < BENCH_INVOKERS; i++) {
+        if (invokers[i]) {
+            tsm_free_invokeID(invokers[i]);
+            invokers[i] = NULL;
+        }
+    }
+    if (sample) {
+        sample_end(sample, BENCH_INVOKERS);
+    }
+}
+
+static int bench_tsm_alloc(bench_sample_t *sample)
+{
+    uint32_t n;
+    int rv;
+
+    for (n = 0; n < TSM_CYCLES; n++) {
+        rv = tsm_fill(sample);
+        tsm_drain(NULL);
+        if (rv < 0) {
+            return rv;
+        }
+    }
+
+    return OK;
+}
+
+static int bench_tsm_free(bench_sample_t *sample)
+{
+    uint32_t n;
+    int rv;
+
+    for (n = 0; n < TSM_CYCLES; n++) {
+        rv = tsm_fill(NULL);
+        tsm_drain(sample);
+        if (rv < 0) {
+            return rv;
+        }
+    }
+
+    return OK;
+}
+
+static void timers_drain(bench_sample_t *sample)
+{
+    uint32_t i;
+
+    if (sample) {
+        sample_begin(sample);
+    }
+    for (i = 0; i < BENCH_TIMERS; i++) {
+        if (timers[i]) {
+            (void)el_timer_destroy(&el_default_loop, timers[i]);
+            timers[i] = NULL;
+        }
+    }
+    if (sample) {
+        sample_end(sample, BENCH_TIMERS);
+    }
+}
+
+/* timeouts spread like APDU timers, 1 ms to 60 s */
+static int timers_fill(bench_sample_t *sample)
+{
+    static unsigned timeouts[BENCH_TIMERS];
+    uint32_t i;
+
+    for (i = 0; i < BENCH_TIMERS; i++) {
+        timeouts[i] = 1 + bench_rand() % 60000;
+    }
+
+    if (sample) {
+        sample_begin(sample);
+    }
+    for (i = 0; i < BENCH_TIMERS; i++) {
+        timers[i] = el_timer_create(&el_default_loop, timeouts[i]);
+        if (timers[i] == NULL) {
+            return -EPERM;
+        }
+    }
+    if (sample) {
+        sample_end(sample, BENCH_TIMERS);
+    }
+
+    return OK;
+}
+
+static int bench_timer_create(bench_sample_t *sample)
+{
+    uint32_t n;
+    int rv;
+
+    for (n = 0; n < TIMER_CYCLES; n++) {
+        rv = timers_fill(sample);
+        timers_drain(NULL);
+        if (rv < 0) {
+            return rv;
+        }
+    }
+
+    return OK;
+}
+
+static int bench_timer_destroy(bench_sample_t *sample)
+{
+    uint32_t n;
+    int rv;
+
+    for (n = 0; n < TIMER_CYCLES; n++) {
+        rv = timers_fill(NULL);
+        timers_drain(sample);
+        if (rv < 0) {
+            return rv;
+        }
+    }
+
+    return OK;
+}
+
+static const bench_case_t bench_cases[] = {
+    {"npdu_encode_pci", bench_npdu_encode},
+    {"npdu_decode_pci", bench_npdu_decode},
+    {"object_find", bench_object_find},
+    {"apdu_handler", bench_apdu_handler},
+    {"handler_read_property_multiple", bench_rpm_handler},
+    {"tsm_alloc_invokeID", bench_tsm_alloc},
+    {"tsm_free_invokeID", bench_tsm_free},
+    {"el_timer_create", bench_timer_create},
+    {"el_timer_destroy", bench_timer_destroy},
+};
+
+#define BENCH_CASE_COUNT            (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+static cJSON *load_baseline(const char *file)
+{
+    cJSON *root;
+    FILE *fp;
+    char *text;
+    long len;
+
+    fp = fopen(file, "r");
+    if (fp == NULL) {
+        printf("open %s failed\r\n", file);
+        return NULL;
+    }
+
+    root = NULL;
+    (void)fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    (void)fseek(fp, 0, SEEK_SET);
+    text = (len > 0)? (char *)malloc(len + 1): NULL;
+    if (text && (fread(text, 1, len, fp) == (size_t)len)) {
+        text[len] = 0;
+        root = cJSON_Parse(text);
+    }
+    free(text);
+    fclose(fp);
+
+    if (root == NULL) {
+        printf("parse %s failed\r\n", file);
+    }
+
+    return root;
+}
+
+static double baseline_ns(cJSON *baseline, const char *name)
+{
+    cJSON *tmp;
+
+    tmp = baseline? cJSON_GetObjectItem(baseline, "results"): NULL;
+    tmp = tmp? cJSON_GetObjectItem(tmp, name): NULL;
+    tmp = tmp? cJSON_GetObjectItem(tmp, "ns_per_op"): NULL;
+
+    return (tmp && (tmp->type == cJSON_Number))? tmp->valuedouble: 0;
+}
+
+/* fastest of --repeat passes, each pass restarts the random sequence */
+static int run_case(const bench_case_t *bench, cJSON *results, cJSON *baseline)
+{
+    bench_sample_t sample, best;
+    double ns, base;
+    cJSON *item;
+    uint32_t r;
+    int rv;
+
+    memset(&best, 0, sizeof(best));
+    for (r = 0; r < opt.repeat; r++) {
+        rand_state = opt.seed? opt.seed: 1;
+        memset(&sample, 0, sizeof(sample));
+        rv = bench->run(&sample);
+        if ((rv < 0) || (sample.ops == 0)) {
+            printf("%-32s failed(%d)\r\n", bench->name, rv);
+            return -EPERM;
+        }
+        if ((best.ops == 0) || (sample.ns * best.ops < best.ns * sample.ops)) {
+            best = sample;
+        }
+    }
+
+    ns = (double)best.ns / best.ops;
+    item = cJSON_CreateObject();
+    if (item == NULL) {
+        return -ENOMEM;
+    }
+    cJSON_AddNumberToObject(item, "ns_per_op", ns);
+    cJSON_AddNumberToObject(item, "allocs_per_op", (double)best.allocs / best.ops);
+    cJSON_AddNumberToObject(item, "ops", best.ops);
+    cJSON_AddItemToObject(results, bench->name, item);
+
+    if (!opt.json) {
+        printf("%-32s %10.1f ns/op %8.3f allocs/op", bench->name, ns,
+            (double)best.allocs / best.ops);
+        base = baseline_ns(baseline, bench->name);
+        if (base > 0) {
+            printf(" %+7.1f%%", (ns - base) * 100 / base);
+        }
+        printf("\r\n");
+    }
+
+    return OK;
+}
+
+static int bench_setup(void)
+{
+    int rv;
+
+    rv = el_loop_init(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    rv = app_startup();
+    if (rv < 0) {
+        printf("app startup failed(%d)\r\n", rv);
+        return rv;
+    }
+    app_set_dbg_level(DEBUG_LEVEL_ERROR);
+
+    apdu_set_default_service_handler();
+    make_peers();
+
+    return OK;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --seed N            workload seed (1)\r\n"
+        "  --repeat N          passes per case, the fastest is kept (5)\r\n"
+        "  --filter TEXT       only cases whose name contains TEXT\r\n"
+        "  --output FILE       also write the json report to FILE\r\n"
+        "  --baseline FILE     show the change against an earlier json report\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"seed", required_argument, NULL, 's'},
+        {"repeat", required_argument, NULL, 'r'},
+        {"filter", required_argument, NULL, 'f'},
+        {"output", required_argument, NULL, 'o'},
+        {"baseline", required_argument, NULL, 'b'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 's': opt.seed = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.repeat = strtoul(optarg, NULL, 0); break;
+        case 'f': opt.filter = optarg; break;
+        case 'o': opt.output = optarg; break;
+        case 'b': opt.baseline = optarg; break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if (opt.repeat == 0) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *report, *results, *baseline;
+    uint32_t i, failed;
+    FILE *fp;
+    char *str;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    app_set_dbg_level(DEBUG_LEVEL_WARN | DEBUG_LEVEL_ERROR);
+
+    baseline = NULL;
+    if (opt.baseline) {
+        baseline = load_baseline(opt.baseline);
+        if (baseline == NULL) {
+            return -EINVAL;
+        }
+    }
+
+    if (bench_setup() < 0) {
+        cJSON_Delete(baseline);
+        return -EPERM;
+    }
+
+    report = cJSON_CreateObject();
+    results = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "seed", opt.seed);
+    cJSON_AddNumberToObject(report, "repeat", opt.repeat);
+    cJSON_AddNumberToObject(report, "objects", object_list_count());
+    cJSON_AddNumberToObject(report, "peers", BENCH_PEERS);
+    cJSON_AddNumberToObject(report, "invokers", BENCH_INVOKERS);
+#ifdef DEBUG
+    cJSON_AddTrueToObject(report, "debug_build");
+#else
+    cJSON_AddFalseToObject(report, "debug_build");
+#endif
+    cJSON_AddItemToObject(report, "results", results);
+    if (!opt.json) {
+        printf("seed %u, repeat %u, %u objects, %u peers, %u invokers\r\n", opt.seed,
+            opt.repeat, object_list_count(), BENCH_PEERS, BENCH_INVOKERS);
+    }
+
+    failed = 0;
+    for (i = 0; i < BENCH_CASE_COUNT; i++) {
+        if (opt.filter && (strstr(bench_cases[i].name, opt.filter) == NULL)) {
+            continue;
+        }
+        if (run_case(&bench_cases[i], results, baseline) < 0) {
+            failed++;
+        }
+    }
+    cJSON_AddNumberToObject(report, "failed", failed);
+
+    str = cJSON_Print(report);
+    if (str) {
+        if (opt.json) {
+            printf("%s\r\n", str);
+        }
+        if (opt.output) {
+            fp = fopen(opt.output, "w");
+            if (fp) {
+                fprintf(fp, "%s\n", str);
+                fclose(fp);
+            } else {
+                printf("write %s failed\r\n", opt.output);
+                failed++;
+            }
+        }
+        free(str);
+    }
+
+    cJSON_Delete(report);
+    cJSON_Delete(baseline);
+    app_stop();
+
+    return failed? -EPERM: OK;
+}
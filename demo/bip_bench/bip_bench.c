@@ -0,0 +1,476 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * bip_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Receive scaling benchmark of a B/IP BBMD port. For every rx_threads from 1
+ * to --threads a child process runs the stack as a BBMD with --fds registered
+ * foreign devices, the parent blasts Distribute-Broadcast-To-Network Who-Is
+ * from --senders sockets, so each packet is fanned out to the FDT and
+ * delivered to the network layer. Reports packets processed per second.
+ *
+ *   ./bip_bench --threads 4 --fds 100 --senders 64 --seconds 3
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/apdu.h"
+#include "bacnet/bip.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+
+#define BENCH_DEVICE_ID             (1000)
+#define BENCH_MAX_SENDERS           (256)
+#define BENCH_MAX_FDS               (149)
+
+/* Distribute-Broadcast-To-Network of Who-Is 4194300-4194301, no I-Am reply */
+static const uint8_t dbtn_who_is[] = {
+    0x81, 0x09, 0x00, 0x10,
+    0x01, 0x00,
+    0x10, 0x08,
+    0x0B, 0x3F, 0xFF, 0xFC,
+    0x1B, 0x3F, 0xFF, 0xFD,
+};
+
+static struct {
+    const char *ifname;
+    const char *ip;
+    uint16_t port;
+    uint32_t threads;
+    uint32_t fds;
+    uint32_t senders;
+    uint32_t seconds;
+    bool json;
+} opt = {
+    .ifname = "lo",
+    .ip = "127.0.0.1",
+    .port = 47808,
+    .threads = 4,
+    .fds = 100,
+    .senders = 64,
+    .seconds = 3,
+};
+
+/* rx_threads of the stack in current child */
+static uint32_t rx_threads;
+
+static volatile bool sending;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+
+    cfg = cJSON_CreateObject();
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "ETH");
+    cJSON_AddStringToObject(res, "ifname", opt.ifname);
+    cJSON_AddItemToObject(cfg, "eth0", res);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *array, *port;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "route_table", cJSON_CreateArray());
+
+    array = cJSON_CreateArray();
+    port = cJSON_CreateObject();
+    cJSON_AddTrueToObject(port, "enable");
+    cJSON_AddNumberToObject(port, "net_num", 1);
+    cJSON_AddStringToObject(port, "dl_type", "BIP");
+    cJSON_AddStringToObject(port, "resource_name", "eth0");
+    cJSON_AddNumberToObject(port, "udp_port", opt.port);
+    cJSON_AddNumberToObject(port, "rx_threads", rx_threads);
+    cJSON_AddItemToObject(port, "bbmd", cJSON_CreateObject());
+    cJSON_AddItemToArray(array, port);
+    cJSON_AddItemToObject(cfg, "port", array);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", BENCH_DEVICE_ID);
+    cJSON_AddStringToObject(cfg, "Device_Name", "bip bench");
+    cJSON_AddItemToObject(cfg, "Object_List", cJSON_CreateArray());
+
+    return cfg;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int udp_socket(struct sockaddr_in *bbmd)
+{
+    struct sockaddr_in sin = {};
+    int fd;
+
+    fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd < 0) {
+        printf("create socket failed cause %s\r\n", strerror(errno));
+        return -EPERM;
+    }
+
+    sin.sin_family = AF_INET;
+    sin.sin_addr = bbmd->sin_addr;
+    sin.sin_port = 0;
+    if (bind(fd, (struct sockaddr *)&sin, sizeof(sin)) < 0) {
+        printf("bind failed cause %s\r\n", strerror(errno));
+        close(fd);
+        return -EPERM;
+    }
+
+    return fd;
+}
+
+/* register opt.fds foreign devices, the sockets are kept open as sinks of the fan-out */
+static int register_fds(struct sockaddr_in *bbmd, int *sinks)
+{
+    uint8_t reg[6] = {0x81, 0x05, 0x00, 0x06, 0x02, 0x58};   /* ttl 600s */
+    uint8_t result[16];
+    struct pollfd pfd;
+    uint32_t i;
+    int rv;
+
+    for (i = 0; i < opt.fds; i++) {
+        sinks[i] = udp_socket(bbmd);
+        if (sinks[i] < 0) {
+            return -EPERM;
+        }
+
+        if (sendto(sinks[i], reg, sizeof(reg), 0, (struct sockaddr *)bbmd, sizeof(*bbmd)) < 0) {
+            printf("send register failed cause %s\r\n", strerror(errno));
+            return -EPERM;
+        }
+
+        pfd.fd = sinks[i];
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, 1000) <= 0) {
+            printf("no BVLC-Result for fd %u\r\n", i);
+            return -EPERM;
+        }
+
+        rv = recv(sinks[i], result, sizeof(result), 0);
+        if ((rv != 6) || (result[1] != 0x00) || (result[4] != 0) || (result[5] != 0)) {
+            printf("register fd %u failed\r\n", i);
+            return -EPERM;
+        }
+    }
+
+    return OK;
+}
+
+/* el_sync could wait long while the loop is flooded, a racy read is enough here */
+static double port_rx_ok(void)
+{
+    datalink_bip_t *bip;
+
+    bip = bip_next_port(NULL);
+
+    return bip? __atomic_load_n(&bip->dl.rx_ok, __ATOMIC_RELAXED): 0;
+}
+
+/* child: run the stack, report packets delivered per second through the pipe */
+static int run_stack(int ready_fd, int result_fd)
+{
+    struct sockaddr_in bbmd = {};
+    int sinks[BENCH_MAX_FDS];
+    uint64_t start_ns, end_ns;
+    double start_rx, end_rx;
+    char line[128];
+    int rv;
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    apdu_set_default_service_handler();
+
+    rv = el_loop_start(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop start failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    bbmd.sin_family = AF_INET;
+    bbmd.sin_addr.s_addr = inet_addr(opt.ip);
+    bbmd.sin_port = htons(opt.port);
+    rv = register_fds(&bbmd, sinks);
+    if (rv < 0) {
+        goto out;
+    }
+
+    /* parent starts sending now, skip the first half second */
+    if (write(ready_fd, "r", 1) != 1) {
+        rv = -EPERM;
+        goto out;
+    }
+    usleep(500000);
+
+    start_rx = port_rx_ok();
+    start_ns = now_ns();
+    sleep(opt.seconds);
+    end_rx = port_rx_ok();
+    end_ns = now_ns();
+
+    /* the child leaves by _exit */
+    fflush(stdout);
+
+    snprintf(line, sizeof(line), "%.0f %.0f\n", end_rx - start_rx,
+        (end_rx - start_rx) * 1e9 / (end_ns - start_ns));
+    if (write(result_fd, line, strlen(line)) < 0) {
+        return -EPERM;
+    }
+
+    return OK;
+
+out:
+    fflush(stdout);
+
+    return rv;
+}
+
+static void *sender_func(void *arg)
+{
+    struct sockaddr_in *bbmd;
+    int fd;
+
+    bbmd = (struct sockaddr_in *)arg;
+    fd = udp_socket(bbmd);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    while (sending) {
+        (void)sendto(fd, dbtn_who_is, sizeof(dbtn_who_is), 0, (struct sockaddr *)bbmd,
+            sizeof(*bbmd));
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+/* parent: one stack child per rx_threads, blast until the child reports */
+static int run_config(uint32_t threads, double *delivered, double *pps)
+{
+    struct sockaddr_in bbmd = {};
+    pthread_t senders[BENCH_MAX_SENDERS];
+    int ready[2], result[2];
+    char line[128];
+    pid_t child;
+    uint32_t i;
+    int status;
+    int rv;
+
+    if ((pipe(ready) < 0) || (pipe(result) < 0)) {
+        printf("pipe failed cause %s\r\n", strerror(errno));
+        return -EPERM;
+    }
+
+    rx_threads = threads;
+    fflush(stdout);
+    child = fork();
+    if (child < 0) {
+        printf("fork failed cause %s\r\n", strerror(errno));
+        return -EPERM;
+    }
+
+    if (child == 0) {
+        close(ready[0]);
+        close(result[0]);
+        /* daemonized stack threads are not joined, leave without cleanup */
+        _exit(run_stack(ready[1], result[1]) < 0? 1: 0);
+    }
+
+    close(ready[1]);
+    close(result[1]);
+
+    rv = -EPERM;
+    if (read(ready[0], line, 1) != 1) {
+        printf("stack with %u rx threads failed to start\r\n", threads);
+        goto out;
+    }
+
+    bbmd.sin_family = AF_INET;
+    bbmd.sin_addr.s_addr = inet_addr(opt.ip);
+    bbmd.sin_port = htons(opt.port);
+
+    sending = true;
+    for (i = 0; i < opt.senders; i++) {
+        if (pthread_create(&senders[i], NULL, sender_func, &bbmd) != 0) {
+            printf("create sender failed\r\n");
+            break;
+        }
+    }
+
+    memset(line, 0, sizeof(line));
+    if (read(result[0], line, sizeof(line) - 1) > 0
+            && sscanf(line, "%lf %lf", delivered, pps) == 2) {
+        rv = OK;
+    }
+
+    sending = false;
+    while (i > 0) {
+        (void)pthread_join(senders[--i], NULL);
+    }
+
+out:
+    kill(child, SIGKILL);
+    (void)waitpid(child, &status, 0);
+    close(ready[0]);
+    close(result[0]);
+
+    return rv;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --threads K         run with rx_threads 1..K (4)\r\n"
+        "  --fds N             registered foreign devices, at most %d (100)\r\n"
+        "  --senders S         source sockets of the load, spread by SO_REUSEPORT hash (64)\r\n"
+        "  --seconds T         measure time of each run (3)\r\n"
+        "  --ifname IF         interface of the BBMD port (lo)\r\n"
+        "  --ip ADDR           address of IF (127.0.0.1)\r\n"
+        "  --port PORT         udp port (47808)\r\n"
+        "  --json              print report as json\r\n\r\n", prog, BENCH_MAX_FDS);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"threads", required_argument, NULL, 't'},
+        {"fds", required_argument, NULL, 'f'},
+        {"senders", required_argument, NULL, 's'},
+        {"seconds", required_argument, NULL, 'T'},
+        {"ifname", required_argument, NULL, 'i'},
+        {"ip", required_argument, NULL, 'a'},
+        {"port", required_argument, NULL, 'p'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 't': opt.threads = strtoul(optarg, NULL, 0); break;
+        case 'f': opt.fds = strtoul(optarg, NULL, 0); break;
+        case 's': opt.senders = strtoul(optarg, NULL, 0); break;
+        case 'T': opt.seconds = strtoul(optarg, NULL, 0); break;
+        case 'i': opt.ifname = optarg; break;
+        case 'a': opt.ip = optarg; break;
+        case 'p': opt.port = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.threads == 0) || (opt.threads > 16) || (opt.fds > BENCH_MAX_FDS)
+            || (opt.senders == 0) || (opt.senders > BENCH_MAX_SENDERS) || (opt.seconds == 0)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *report, *runs, *run;
+    double delivered, pps, base;
+    uint32_t threads;
+    char *str;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    (void)signal(SIGPIPE, SIG_IGN);
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "fds", opt.fds);
+    cJSON_AddNumberToObject(report, "senders", opt.senders);
+    cJSON_AddNumberToObject(report, "cpus", sysconf(_SC_NPROCESSORS_ONLN));
+    runs = cJSON_CreateArray();
+    cJSON_AddItemToObject(report, "runs", runs);
+
+    if (!opt.json) {
+        printf("%-10s %12s %12s %8s\r\n", "rx_threads", "delivered", "pkts/s", "speedup");
+    }
+
+    base = 0;
+    rv = OK;
+    for (threads = 1; threads <= opt.threads; threads++) {
+        rv = run_config(threads, &delivered, &pps);
+        if (rv < 0) {
+            break;
+        }
+
+        if (base == 0) {
+            base = pps;
+        }
+
+        run = cJSON_CreateObject();
+        cJSON_AddNumberToObject(run, "rx_threads", threads);
+        cJSON_AddNumberToObject(run, "delivered", delivered);
+        cJSON_AddNumberToObject(run, "pkts_per_sec", pps);
+        cJSON_AddNumberToObject(run, "speedup", base > 0? pps / base: 0);
+        cJSON_AddItemToArray(runs, run);
+
+        if (!opt.json) {
+            printf("%-10u %12.0f %12.0f %8.2f\r\n", threads, delivered, pps,
+                base > 0? pps / base: 0);
+        }
+    }
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    }
+    cJSON_Delete(report);
+
+    return rv;
+}
@@ -0,0 +1,374 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * codec_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Microbenchmark of the bacdcode primitives: tag header decode, Unsigned,
+ * REAL and ObjectIdentifier values one at a time and through the array
+ * codecs, and skipping a constructed Object_List the way the RPM/RR ack
+ * decoders do. The array codecs are checked against the single value ones
+ * before anything is timed.
+ *
+ *   ./codec_bench --values 1000 --rounds 2000 --json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/app.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "misc/cJSON.h"
+#include "debug.h"
+
+#define MAX_VALUES                  (4096)
+
+static struct {
+    uint32_t values;
+    uint32_t rounds;
+    bool json;
+} opt = {
+    .values = 1000,
+    .rounds = 2000,
+};
+
+static float reals[MAX_VALUES];
+static uint32_t unsigneds[MAX_VALUES];
+static BACNET_OBJECT_ID ids[MAX_VALUES];
+
+static uint8_t buf[MAX_VALUES * 5 + 16];
+static uint8_t ref[MAX_VALUES * 5 + 16];
+
+/* keeps the decoded values alive */
+static volatile uint32_t sink;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void make_values(uint32_t n)
+{
+    uint32_t i;
+
+    srand(1);
+    for (i = 0; i < n; i++) {
+        reals[i] = (rand() % 20000) / 100.0f - 100.0f;
+        /* mostly small values, as in Priority_Array and Log_Buffer */
+        unsigneds[i] = (i % 4 == 3)? (uint32_t)rand(): (uint32_t)(rand() % 1000);
+        ids[i].type = (BACNET_OBJECT_TYPE)(i % 6);
+        ids[i].instance = i;
+    }
+}
+
+/* the array codecs against one value at a time, returns the number of mismatches */
+static uint32_t check_arrays(uint32_t n)
+{
+    float real_out[MAX_VALUES];
+    uint32_t unsigned_out[MAX_VALUES];
+    BACNET_OBJECT_ID id_out[MAX_VALUES];
+    uint32_t i, count, failed;
+    int len, ref_len;
+
+    failed = 0;
+
+    ref_len = 0;
+    for (i = 0; i < n; i++) {
+        ref_len += encode_application_real(&ref[ref_len], reals[i]);
+    }
+    len = encode_application_real_array(buf, reals, n);
+    count = n;
+    if ((len != ref_len) || memcmp(buf, ref, len)
+            || (decode_application_real_array(buf, len, real_out, &count) != len) || (count != n)
+            || memcmp(real_out, reals, n * sizeof(float))) {
+        printf("REAL array mismatch\r\n");
+        failed++;
+    }
+
+    ref_len = 0;
+    for (i = 0; i < n; i++) {
+        ref_len += encode_application_unsigned(&ref[ref_len], unsigneds[i]);
+    }
+    len = encode_application_unsigned_array(buf, unsigneds, n);
+    count = n;
+    if ((len != ref_len) || memcmp(buf, ref, len)
+            || (decode_application_unsigned_array(buf, len, unsigned_out, &count) != len)
+            || (count != n) || memcmp(unsigned_out, unsigneds, n * sizeof(uint32_t))) {
+        printf("Unsigned array mismatch\r\n");
+        failed++;
+    }
+
+    ref_len = 0;
+    for (i = 0; i < n; i++) {
+        ref_len += encode_application_object_id(&ref[ref_len], ids[i].type, ids[i].instance);
+    }
+    len = encode_application_object_id_array(buf, ids, n);
+    count = n;
+    if ((len != ref_len) || memcmp(buf, ref, len)
+            || (decode_application_object_id_array(buf, len, id_out, &count) != len)
+            || (count != n)) {
+        printf("ObjectIdentifier array mismatch\r\n");
+        failed++;
+    } else {
+        for (i = 0; i < n; i++) {
+            if ((id_out[i].type != ids[i].type) || (id_out[i].instance != ids[i].instance)) {
+                printf("ObjectIdentifier array mismatch at %u\r\n", i);
+                failed++;
+                break;
+            }
+        }
+    }
+
+    /* a closing tag ends the array early, a truncated value is an error */
+    len = encode_application_real_array(buf, reals, 2);
+    len += encode_closing_tag(&buf[len], 3);
+    count = n;
+    if ((decode_application_real_array(buf, len, real_out, &count) != 10) || (count != 2)
+            || (decode_application_real_array(buf, 7, real_out, &count) != -1)) {
+        printf("REAL array bounds mismatch\r\n");
+        failed++;
+    }
+
+    return failed;
+}
+
+static void add_result(cJSON *report, const char *name, uint64_t ns, uint64_t ops)
+{
+    double per_op;
+
+    per_op = ops? (double)ns / ops: 0;
+    cJSON_AddNumberToObject(report, name, per_op);
+    if (!opt.json) {
+        printf("%-28s %8.2f ns/value\r\n", name, per_op);
+    }
+}
+
+static void bench(cJSON *report, uint32_t n, uint32_t rounds)
+{
+    float real_out[MAX_VALUES];
+    uint32_t unsigned_out[MAX_VALUES];
+    BACNET_OBJECT_ID id_out[MAX_VALUES];
+    BACNET_OBJECT_TYPE type;
+    uint32_t value, count, r, i;
+    uint64_t begin;
+    uint8_t tag;
+    int len, pos;
+
+    /* tag headers of an unsigned list */
+    len = encode_application_unsigned_array(buf, unsigneds, n);
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        pos = 0;
+        while (pos < len) {
+            pos += decode_tag_number_and_value(&buf[pos], &tag, &value);
+            pos += value;
+            sink += tag;
+        }
+    }
+    add_result(report, "tag_decode", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0, pos = 0; i < n; i++) {
+            pos += decode_application_unsigned(&buf[pos], &unsigned_out[i]);
+        }
+        sink += unsigned_out[n - 1];
+    }
+    add_result(report, "unsigned_decode", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        count = n;
+        (void)decode_application_unsigned_array(buf, len, unsigned_out, &count);
+        sink += unsigned_out[n - 1];
+    }
+    add_result(report, "unsigned_decode_array", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0, pos = 0; i < n; i++) {
+            pos += encode_application_unsigned(&buf[pos], unsigneds[i]);
+        }
+        sink += buf[pos - 1];
+    }
+    add_result(report, "unsigned_encode", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        pos = encode_application_unsigned_array(buf, unsigneds, n);
+        sink += buf[pos - 1];
+    }
+    add_result(report, "unsigned_encode_array", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0, pos = 0; i < n; i++) {
+            pos += encode_application_real(&buf[pos], reals[i]);
+        }
+        sink += buf[pos - 1];
+    }
+    add_result(report, "real_encode", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        pos = encode_application_real_array(buf, reals, n);
+        sink += buf[pos - 1];
+    }
+    add_result(report, "real_encode_array", now_ns() - begin, (uint64_t)n * rounds);
+
+    len = encode_application_real_array(buf, reals, n);
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0, pos = 0; i < n; i++) {
+            pos += decode_application_real(&buf[pos], &real_out[i]);
+        }
+        sink += (uint32_t)real_out[n - 1];
+    }
+    add_result(report, "real_decode", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        count = n;
+        (void)decode_application_real_array(buf, len, real_out, &count);
+        sink += (uint32_t)real_out[n - 1];
+    }
+    add_result(report, "real_decode_array", now_ns() - begin, (uint64_t)n * rounds);
+
+    len = encode_application_object_id_array(buf, ids, n);
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0, pos = 0; i < n; i++) {
+            pos += decode_application_object_id(&buf[pos], &type, &value);
+            id_out[i].type = type;
+            id_out[i].instance = value;
+        }
+        sink += id_out[n - 1].instance;
+    }
+    add_result(report, "object_id_decode", now_ns() - begin, (uint64_t)n * rounds);
+
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        count = n;
+        (void)decode_application_object_id_array(buf, len, id_out, &count);
+        sink += id_out[n - 1].instance;
+    }
+    add_result(report, "object_id_decode_array", now_ns() - begin, (uint64_t)n * rounds);
+
+    /* an Object_List as the value of an RPM ack, found by skipping its tags */
+    len = encode_opening_tag(buf, 4);
+    len += encode_application_object_id_array(&buf[len], ids, n);
+    len += encode_closing_tag(&buf[len], 4);
+    buf[len++] = 0x1f;
+    begin = now_ns();
+    for (r = 0; r < rounds; r++) {
+        sink += decode_constructed_tag(buf, len, 4);
+    }
+    add_result(report, "constructed_skip", now_ns() - begin, (uint64_t)n * rounds);
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --values N          values per array (1000, at most 4096)\r\n"
+        "  --rounds N          passes over each array (2000)\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"values", required_argument, NULL, 'n'},
+        {"rounds", required_argument, NULL, 'r'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'n': opt.values = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.rounds = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.values < 2) || (opt.values > MAX_VALUES) || (opt.rounds == 0)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *report;
+    uint32_t failed;
+    char *str;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    app_set_dbg_level(DEBUG_LEVEL_WARN | DEBUG_LEVEL_ERROR);
+
+    make_values(opt.values);
+    failed = check_arrays(opt.values);
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "values", opt.values);
+    cJSON_AddNumberToObject(report, "rounds", opt.rounds);
+    cJSON_AddNumberToObject(report, "check_failed", failed);
+    if (!opt.json) {
+        printf("values %u, rounds %u, %u check failed\r\n", opt.values, opt.rounds, failed);
+    }
+
+    bench(report, opt.values, opt.rounds);
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    }
+
+    cJSON_Delete(report);
+
+    return failed? -EPERM: OK;
+}
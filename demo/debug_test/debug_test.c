@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <stdbool.h>
 
 #include "debug.h"
 #include "misc/cJSON.h"
@@ -80,6 +81,119 @@ static void debug_exit(void)
     client_fd = -1;
 }
 
+static int debug_read_full(uint8_t *buf, uint32_t len)
+{
+    ssize_t nread;
+    uint32_t done;
+
+    done = 0;
+    while (done < len) {
+        nread = read(client_fd, buf + done, len - done);
+        if (nread < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -EPERM;
+        }
+        if (nread == 0) {
+            return -EPERM;
+        }
+        done += nread;
+    }
+
+    return 0;
+}
+
+/* read json body of the echo */
+static cJSON *debug_read_reply(void)
+{
+    uint8_t hdr[8];
+    uint32_t data_len;
+    char *data;
+    cJSON *reply;
+
+    if (debug_read_full(hdr, sizeof(hdr)) < 0) {
+        printf("debug_read_reply: read header failed\r\n");
+        return NULL;
+    }
+
+    (void)decode_unsigned32(hdr + 4, &data_len);
+    if (data_len == 0) {
+        printf("debug_read_reply: empty reply\r\n");
+        return NULL;
+    }
+
+    data = (char *)malloc(data_len);
+    if (data == NULL) {
+        printf("debug_read_reply: malloc %d bytes failed\r\n", data_len);
+        return NULL;
+    }
+
+    reply = NULL;
+    if (debug_read_full((uint8_t *)data, data_len) < 0) {
+        printf("debug_read_reply: read body failed\r\n");
+        goto out;
+    }
+    data[data_len - 1] = 0;
+
+    reply = cJSON_Parse(data);
+    if (reply == NULL) {
+        printf("debug_read_reply: invalid reply\r\n");
+    }
+
+out:
+    free(data);
+
+    return reply;
+}
+
+static void debug_print_reply(void)
+{
+    cJSON *reply;
+    char *str;
+
+    reply = debug_read_reply();
+    if (reply == NULL) {
+        return;
+    }
+
+    str = cJSON_Print(reply);
+    if (str) {
+        printf("%s\r\n", str);
+        free(str);
+    }
+    cJSON_Delete(reply);
+}
+
+/* timestamp of the last trace record printed */
+static char trace_next[24];
+
+static bool trace_failed;
+
+static void debug_print_trace(void)
+{
+    cJSON *reply, *records, *tmp;
+
+    reply = debug_read_reply();
+    if (reply == NULL) {
+        trace_failed = true;
+        return;
+    }
+
+    records = cJSON_GetObjectItem(reply, "records");
+    if (records != NULL) {
+        cJSON_ArrayForEach(tmp, records) {
+            printf("%s\r\n", tmp->valuestring);
+        }
+    }
+
+    tmp = cJSON_GetObjectItem(reply, "next");
+    if ((tmp != NULL) && (tmp->type == cJSON_String)) {
+        (void)snprintf(trace_next, sizeof(trace_next), "%s", tmp->valuestring);
+    }
+    cJSON_Delete(reply);
+}
+
 static void debug_send_request(uint32_t choice, const char *argv)
 {
     cJSON *request;
@@ -108,6 +222,7 @@ static void debug_send_request(uint32_t choice, const char *argv)
     case DEBUG_SET_MSTP_DBG_STATUS:
     case DEBUG_SET_BIP_DBG_STATUS:
     case DEBUG_SET_ETHERNET_DBG_STATUS:
+    case DEBUG_SET_TRACE_CONSOLE_LEVEL:
         if (argv == NULL) {
             printf("debug_send_request: null dbg level\r\n");
             goto out;
@@ -130,8 +245,33 @@ static void debug_send_request(uint32_t choice, const char *argv)
         break;
     
     case DEBUG_SHOW_NETWORK_ROUTE_TABLE:
+    case DEBUG_SHOW_PERF_STATS:
+    case DEBUG_RESET_PERF_STATS:
+    case DEBUG_SHOW_OBJECT_MEMORY:
         /* do nothing */
         break;
+
+    case DEBUG_DUMP_TRACE:
+        if (argv != NULL) {
+            cJSON_AddStringToObject(request, "since", argv);
+        }
+        break;
+
+    case DEBUG_SET_PERF_STATUS:
+    case DEBUG_SET_TRACE_STATUS:
+        if (argv == NULL) {
+            printf("debug_send_request: null enable\r\n");
+            goto out;
+        }
+
+        value = strtol(argv, &endptr, 0);
+        if (((endptr != NULL) && (*endptr != '\0')) || (value < 0) || (value > 1)) {
+            printf("enable value should be 0 or 1\r\n");
+            goto out;
+        }
+
+        cJSON_AddNumberToObject(request, "enable", value);
+        break;
     
     default:
         printf("debug_send_request: invalid debug service choice(%d)\r\n", choice);
@@ -158,6 +298,11 @@ static void debug_send_request(uint32_t choice, const char *argv)
         
     if (write(client_fd, pkt, pkt_len) != pkt_len) {
         printf("debug_send_request: write data failed\r\n");
+        trace_failed = true;
+    } else if ((choice == DEBUG_SHOW_PERF_STATS) || (choice == DEBUG_SHOW_OBJECT_MEMORY)) {
+        debug_print_reply();
+    } else if (choice == DEBUG_DUMP_TRACE) {
+        debug_print_trace();
     }
     free(pkt);
 
@@ -395,6 +540,107 @@ static void debug_debug_parse(int argc, const char *argv[])
     printf("invalid argument: %s\r\n", argv[i]);
 }
 
+static void debug_perf_parse(int argc, const char *argv[])
+{
+    int i;
+
+    i = 0;
+    DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+
+    if (strcmp(argv[i], "show") == 0) {
+        i++;
+        DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 0);
+        debug_send_request(DEBUG_SHOW_PERF_STATS, NULL);
+        return;
+    } else if (strcmp(argv[i], "reset") == 0) {
+        i++;
+        DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 0);
+        debug_send_request(DEBUG_RESET_PERF_STATS, NULL);
+        return;
+    } else if (strcmp(argv[i], "set") == 0) {
+        i++;
+        DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+        if (strcmp(argv[i], "enable") == 0) {
+            i++;
+            DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+            DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 1);
+            debug_send_request(DEBUG_SET_PERF_STATUS, argv[i]);
+            return;
+        }
+    } else {
+        /* do nothing */
+    }
+
+    printf("invalid argument: %s\r\n", argv[i]);
+}
+
+static void debug_trace_parse(int argc, const char *argv[])
+{
+    int i;
+
+    i = 0;
+    DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+
+    if (strcmp(argv[i], "dump") == 0) {
+        i++;
+        DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 0);
+        debug_send_request(DEBUG_DUMP_TRACE, NULL);
+        return;
+    } else if (strcmp(argv[i], "follow") == 0) {
+        i++;
+        DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 0);
+        debug_send_request(DEBUG_DUMP_TRACE, NULL);
+        while (!trace_failed) {
+            usleep(200000);
+            debug_send_request(DEBUG_DUMP_TRACE, trace_next[0]? trace_next: NULL);
+        }
+        return;
+    } else if (strcmp(argv[i], "set") == 0) {
+        i++;
+        DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+        if (strcmp(argv[i], "enable") == 0) {
+            i++;
+            DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+            DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 1);
+            debug_send_request(DEBUG_SET_TRACE_STATUS, argv[i]);
+            return;
+        } else if (strcmp(argv[i], "console") == 0) {
+            i++;
+            DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+            DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 1);
+            debug_send_request(DEBUG_SET_TRACE_CONSOLE_LEVEL, argv[i]);
+            return;
+        }
+    } else {
+        /* do nothing */
+    }
+
+    printf("invalid argument: %s\r\n", argv[i]);
+}
+
+static void debug_object_parse(int argc, const char *argv[])
+{
+    int i;
+
+    i = 0;
+    DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+
+    if (strcmp(argv[i], "show") == 0) {
+        i++;
+        DEBUG_IF_NO_ARGUMENT_RETURN(argc - i);
+        if (strcmp(argv[i], "memory") == 0) {
+            i++;
+            DEBUG_IF_MORE_ARGUMENT_RETURN(argc - i, 0);
+            debug_send_request(DEBUG_SHOW_OBJECT_MEMORY, NULL);
+            return;
+        }
+    } else {
+        /* do nothing */
+    }
+
+    printf("invalid argument: %s\r\n", argv[i]);
+}
+
 static void debug_parse(int argc, const char *argv[])
 {
     DEBUG_IF_NO_ARGUMENT_RETURN(argc);
@@ -417,6 +663,12 @@ static void debug_parse(int argc, const char *argv[])
         debug_web_parse(argc - 1, &argv[1]);
     } else if (strcmp(argv[0], "debug") == 0) {
         debug_debug_parse(argc - 1, &argv[1]);
+    } else if (strcmp(argv[0], "perf") == 0) {
+        debug_perf_parse(argc - 1, &argv[1]);
+    } else if (strcmp(argv[0], "trace") == 0) {
+        debug_trace_parse(argc - 1, &argv[1]);
+    } else if (strcmp(argv[0], "object") == 0) {
+        debug_object_parse(argc - 1, &argv[1]);
     } else {
         printf("invalid argument: %s\r\n", argv[0]);
     }
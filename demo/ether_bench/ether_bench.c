@@ -0,0 +1,421 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * ether_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Receive benchmark of the Ethernet datalink. The stack runs an ETH port on
+ * one end of a veth pair, a child process blasts a mix of BACnet Who-Is,
+ * BACnet frames to other stations and non-BACnet frames from the other end.
+ * Reports frames delivered, kernel drops and cpu time of the stack process.
+ *
+ *   ip link add vbt0 type veth peer name vbt1
+ *   ip link set vbt0 up; ip link set vbt1 up
+ *   ./ether_bench --ifname vbt0 --peer vbt1 [--no-ring]
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/apdu.h"
+#include "bacnet/etherdl.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+
+#define BENCH_DEVICE_ID             (1000)
+
+/* Who-Is 4194300-4194301, processed by the stack without reply */
+static const uint8_t who_is_npdu[] = {
+    0x82, 0x82, 0x03,                               /* LLC */
+    0x01, 0x00,                                     /* NPDU */
+    0x10, 0x08,                                     /* Who-Is */
+    0x0B, 0x3F, 0xFF, 0xFC,
+    0x1B, 0x3F, 0xFF, 0xFD,
+};
+
+static const uint8_t other_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x99};
+static const uint8_t broadcast_mac[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+static struct {
+    const char *ifname;
+    const char *peer;
+    uint32_t frames;
+    uint32_t bacnet_pct;
+    uint32_t other_pct;
+    bool rx_ring;
+    bool json;
+} opt = {
+    .frames = 1000000,
+    .bacnet_pct = 20,
+    .other_pct = 20,
+    .rx_ring = true,
+};
+
+static volatile bool stopped;
+
+static void sig_handler(int sig)
+{
+    stopped = true;
+}
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+
+    cfg = cJSON_CreateObject();
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "ETH");
+    cJSON_AddStringToObject(res, "ifname", opt.ifname);
+    cJSON_AddItemToObject(cfg, "eth0", res);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *array, *port;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "route_table", cJSON_CreateArray());
+
+    array = cJSON_CreateArray();
+    port = cJSON_CreateObject();
+    cJSON_AddTrueToObject(port, "enable");
+    cJSON_AddNumberToObject(port, "net_num", 1);
+    cJSON_AddStringToObject(port, "dl_type", "ETH");
+    cJSON_AddStringToObject(port, "resource_name", "eth0");
+    cJSON_AddBoolToObject(port, "rx_ring", opt.rx_ring);
+    cJSON_AddItemToArray(array, port);
+    cJSON_AddItemToObject(cfg, "port", array);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", BENCH_DEVICE_ID);
+    cJSON_AddStringToObject(cfg, "Device_Name", "ether bench");
+    cJSON_AddItemToObject(cfg, "Object_List", cJSON_CreateArray());
+
+    return cfg;
+}
+
+static int open_peer(const char *ifname, uint8_t *mac)
+{
+    struct sockaddr_ll addr_ll = {};
+    struct ifreq ifr = {};
+    int fd;
+
+    fd = socket(PF_PACKET, SOCK_RAW, 0);
+    if (fd < 0) {
+        printf("create peer socket failed cause %s\r\n", strerror(errno));
+        return -EPERM;
+    }
+
+    strncpy(ifr.ifr_name, ifname, sizeof(ifr.ifr_name) - 1);
+    if ((ioctl(fd, SIOCGIFINDEX, &ifr) < 0)) {
+        printf("get ifindex of %s failed cause %s\r\n", ifname, strerror(errno));
+        goto err;
+    }
+    addr_ll.sll_family = PF_PACKET;
+    addr_ll.sll_ifindex = ifr.ifr_ifindex;
+
+    if (ioctl(fd, SIOCGIFHWADDR, &ifr) < 0) {
+        printf("get mac of %s failed cause %s\r\n", ifname, strerror(errno));
+        goto err;
+    }
+    memcpy(mac, ifr.ifr_hwaddr.sa_data, 6);
+
+    if (bind(fd, (struct sockaddr *)&addr_ll, sizeof(addr_ll)) < 0) {
+        printf("bind %s failed cause %s\r\n", ifname, strerror(errno));
+        goto err;
+    }
+
+    return fd;
+
+err:
+    close(fd);
+    return -EPERM;
+}
+
+static void build_frame(uint8_t *frame, uint32_t *len, const uint8_t *dst, const uint8_t *src,
+            bool bacnet)
+{
+    memcpy(&frame[0], dst, 6);
+    memcpy(&frame[6], src, 6);
+
+    if (bacnet) {
+        frame[12] = 0;
+        frame[13] = sizeof(who_is_npdu);
+        memcpy(&frame[14], who_is_npdu, sizeof(who_is_npdu));
+        *len = 14 + sizeof(who_is_npdu);
+        if (*len < 60) {
+            memset(&frame[*len], 0, 60 - *len);
+            *len = 60;
+        }
+    } else {
+        /* an IPv4 ethertype frame with junk payload */
+        frame[12] = 0x08;
+        frame[13] = 0x00;
+        memset(&frame[14], 0x45, 46);
+        *len = 60;
+    }
+}
+
+/* child process, send opt.frames frames as fast as the peer accepts */
+static void blast(int fd, const uint8_t *src)
+{
+    uint8_t frames[3][64];
+    uint32_t lens[3];
+    uint32_t i, kind;
+    uint64_t seed;
+
+    build_frame(frames[0], &lens[0], broadcast_mac, src, true);
+    build_frame(frames[1], &lens[1], other_mac, src, true);
+    build_frame(frames[2], &lens[2], broadcast_mac, src, false);
+
+    seed = 0x9E3779B97F4A7C15ULL;
+    for (i = 0; i < opt.frames; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        kind = seed % 100;
+        if (kind < opt.bacnet_pct) {
+            kind = 0;
+        } else if (kind < opt.bacnet_pct + opt.other_pct) {
+            kind = 1;
+        } else {
+            kind = 2;
+        }
+
+        while (send(fd, frames[kind], lens[kind], 0) < 0) {
+            if ((errno != ENOBUFS) && (errno != EAGAIN)) {
+                printf("send failed cause %s\r\n", strerror(errno));
+                _exit(1);
+            }
+            sched_yield();
+        }
+    }
+
+    _exit(0);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t cpu_ns(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return ((uint64_t)usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL
+        + ((uint64_t)usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+static cJSON *port_status(void)
+{
+    cJSON *status, *port;
+
+    el_sync(&el_default_loop);
+    status = ether_get_status(NULL);
+    el_unsync(&el_default_loop);
+
+    if (status == NULL) {
+        return NULL;
+    }
+
+    port = cJSON_DetachItemFromArray(cJSON_GetObjectItem(status, "result"), 0);
+    cJSON_Delete(status);
+
+    return port;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s --ifname IF --peer PEER [options]\r\n"
+        "  --ifname IF         interface of the stack ETH port\r\n"
+        "  --peer PEER         other end of the veth pair, frames are sent from it\r\n"
+        "  --frames N          frames to send (1000000)\r\n"
+        "  --bacnet PCT        percent of Who-Is to the stack (20)\r\n"
+        "  --other PCT         percent of BACnet frames to other stations (20), rest is non-BACnet\r\n"
+        "  --no-ring           receive with recv() instead of the TPACKET_V3 ring\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"ifname", required_argument, NULL, 'i'},
+        {"peer", required_argument, NULL, 'p'},
+        {"frames", required_argument, NULL, 'n'},
+        {"bacnet", required_argument, NULL, 'b'},
+        {"other", required_argument, NULL, 'o'},
+        {"no-ring", no_argument, NULL, 'r'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'i': opt.ifname = optarg; break;
+        case 'p': opt.peer = optarg; break;
+        case 'n': opt.frames = strtoul(optarg, NULL, 0); break;
+        case 'b': opt.bacnet_pct = strtoul(optarg, NULL, 0); break;
+        case 'o': opt.other_pct = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.rx_ring = false; break;
+        case 'j': opt.json = true; break;
+
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.ifname == NULL) || (opt.peer == NULL) || (opt.frames == 0)
+            || (opt.bacnet_pct + opt.other_pct > 100)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *port, *report;
+    uint8_t peer_mac[6];
+    uint64_t start_ns, start_cpu, elapsed_ns, cpu;
+    double last_rx, rx_all;
+    pid_t child;
+    int fd, status, rv;
+    char *str;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    fd = open_peer(opt.peer, peer_mac);
+    if (fd < 0) {
+        return fd;
+    }
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        close(fd);
+        return rv;
+    }
+
+    apdu_set_default_service_handler();
+
+    (void)signal(SIGINT, sig_handler);
+    (void)signal(SIGTERM, sig_handler);
+
+    rv = el_loop_start(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop start failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    start_ns = now_ns();
+    start_cpu = cpu_ns();
+
+    child = fork();
+    if (child < 0) {
+        printf("fork failed cause %s\r\n", strerror(errno));
+        rv = -EPERM;
+        goto out;
+    }
+    if (child == 0) {
+        blast(fd, peer_mac);
+    }
+
+    (void)waitpid(child, &status, 0);
+
+    /* wait until the stack drained what the kernel queued */
+    last_rx = -1;
+    for (;;) {
+        port = port_status();
+        if (port == NULL) {
+            rv = -EPERM;
+            goto out;
+        }
+        rx_all = cJSON_GetObjectItem(port, "rx_all")->valuedouble;
+        cJSON_Delete(port);
+        if ((rx_all == last_rx) || stopped) {
+            break;
+        }
+        last_rx = rx_all;
+        usleep(100000);
+    }
+
+    /* the last idle poll is not part of the run */
+    elapsed_ns = now_ns() - start_ns - 100000000ULL;
+    cpu = cpu_ns() - start_cpu;
+
+    report = port_status();
+    if (report == NULL) {
+        rv = -EPERM;
+        goto out;
+    }
+
+    cJSON_AddNumberToObject(report, "sent", opt.frames);
+    cJSON_AddNumberToObject(report, "elapsed_ns", elapsed_ns);
+    cJSON_AddNumberToObject(report, "cpu_ns", cpu);
+    cJSON_AddNumberToObject(report, "frames_per_sec", opt.frames * 1e9 / elapsed_ns);
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("\r\n%s rx on %s: sent %u, rx_all %.0f, rx_ok %.0f, rx_drops %.0f\r\n",
+            opt.rx_ring? "ring": "recv", opt.ifname, opt.frames,
+            cJSON_GetObjectItem(report, "rx_all")->valuedouble,
+            cJSON_GetObjectItem(report, "rx_ok")->valuedouble,
+            cJSON_GetObjectItem(report, "rx_drops")->valuedouble);
+        printf("  elapsed %.3fs, %.0f frames/s sent, stack cpu %.3fs, %.0f ns cpu/frame\r\n",
+            elapsed_ns / 1e9, opt.frames * 1e9 / elapsed_ns, cpu / 1e9,
+            (double)cpu / opt.frames);
+    }
+    cJSON_Delete(report);
+
+out:
+    close(fd);
+    bacnet_exit();
+
+    return rv;
+}
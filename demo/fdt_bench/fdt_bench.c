@@ -0,0 +1,379 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * fdt_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Foreign device table benchmark of a B/IP BBMD port. The BVLC handlers are
+ * called in process, without the event loop, to time registration, refresh,
+ * broadcast fan-out, deletion and the aging sweep of a table of --fds entries.
+ * Foreign devices are 127.1.x.y, the fan-out goes out on lo.
+ *
+ *   ./fdt_bench --fds 5000 --broadcasts 20
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/bacnet_buf.h"
+#include "bacnet/bip.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+
+/* internal of the bip datalink */
+extern int bvlc_receive_register_foreign_device(datalink_bip_t *bip, struct sockaddr_in *src,
+            bacnet_buf_t *mpdu);
+extern int bvlc_receive_delete_fdt_entry(datalink_bip_t *bip, struct sockaddr_in *src,
+            bacnet_buf_t *mpdu);
+extern int bvlc_fdt_forward_npdu(datalink_bip_t *bip, struct sockaddr_in *src,
+            bacnet_buf_t *npdu);
+extern int bvlc_fdt_sweep(datalink_bip_t *bip, unsigned now);
+
+#define BENCH_DEVICE_ID             (1000)
+#define BENCH_MAX_FDS               (65536)
+#define BENCH_FD_PORT               (47900)
+#define BENCH_TTL                   (600)
+#define BENCH_SWEEPS                (100)
+
+/* Who-Is 4194300-4194301, no I-Am reply */
+static const uint8_t who_is_npdu[] = {
+    0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF,
+    0x10, 0x08,
+};
+
+static struct {
+    const char *ifname;
+    uint16_t port;
+    uint32_t fds;
+    uint32_t broadcasts;
+    bool json;
+} opt = {
+    .ifname = "lo",
+    .port = 47808,
+    .fds = 5000,
+    .broadcasts = 20,
+};
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+
+    cfg = cJSON_CreateObject();
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "ETH");
+    cJSON_AddStringToObject(res, "ifname", opt.ifname);
+    cJSON_AddItemToObject(cfg, "eth0", res);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *array, *port, *bbmd;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "route_table", cJSON_CreateArray());
+
+    array = cJSON_CreateArray();
+    port = cJSON_CreateObject();
+    cJSON_AddTrueToObject(port, "enable");
+    cJSON_AddNumberToObject(port, "net_num", 1);
+    cJSON_AddStringToObject(port, "dl_type", "BIP");
+    cJSON_AddStringToObject(port, "resource_name", "eth0");
+    cJSON_AddNumberToObject(port, "udp_port", opt.port);
+    bbmd = cJSON_CreateObject();
+    cJSON_AddNumberToObject(bbmd, "fdt_max_size", opt.fds);
+    cJSON_AddItemToObject(port, "bbmd", bbmd);
+    cJSON_AddItemToArray(array, port);
+    cJSON_AddItemToObject(cfg, "port", array);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", BENCH_DEVICE_ID);
+    cJSON_AddStringToObject(cfg, "Device_Name", "fdt bench");
+    cJSON_AddItemToObject(cfg, "Object_List", cJSON_CreateArray());
+
+    return cfg;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void fd_addr(uint32_t i, struct sockaddr_in *sin)
+{
+    memset(sin, 0, sizeof(*sin));
+    sin->sin_family = AF_INET;
+    sin->sin_addr.s_addr = htonl(0x7F010000 + i + 1);
+    sin->sin_port = htons(BENCH_FD_PORT);
+}
+
+/* Register-Foreign-Device from every foreign device, returns ns per request */
+static int register_all(datalink_bip_t *bip, double *ns)
+{
+    DECLARE_BACNET_BUF(mpdu, 16);
+    struct sockaddr_in src;
+    uint64_t start;
+    uint32_t i;
+
+    start = now_ns();
+    for (i = 0; i < opt.fds; i++) {
+        fd_addr(i, &src);
+        (void)bacnet_buf_init(&mpdu.buf, 16);
+        mpdu.buf.data[0] = 0x81;
+        mpdu.buf.data[1] = 0x05;
+        mpdu.buf.data[2] = 0x00;
+        mpdu.buf.data[3] = 0x06;
+        mpdu.buf.data[4] = BENCH_TTL >> 8;
+        mpdu.buf.data[5] = BENCH_TTL & 0xFF;
+        mpdu.buf.data_len = 6;
+        if (bvlc_receive_register_foreign_device(bip, &src, &mpdu.buf) < 0) {
+            printf("register fd %u failed\r\n", i);
+            return -EPERM;
+        }
+    }
+    *ns = (double)(now_ns() - start) / opt.fds;
+
+    return OK;
+}
+
+/* Delete-Foreign-Device-Table-Entry of every second foreign device */
+static int delete_half(datalink_bip_t *bip, double *ns)
+{
+    DECLARE_BACNET_BUF(mpdu, 16);
+    struct sockaddr_in fd;
+    uint64_t start;
+    uint32_t i;
+
+    start = now_ns();
+    for (i = 0; i < opt.fds; i += 2) {
+        fd_addr(i, &fd);
+        (void)bacnet_buf_init(&mpdu.buf, 16);
+        mpdu.buf.data[0] = 0x81;
+        mpdu.buf.data[1] = 0x08;
+        mpdu.buf.data[2] = 0x00;
+        mpdu.buf.data[3] = 0x0A;
+        memcpy(&mpdu.buf.data[4], &fd.sin_addr.s_addr, 4);
+        memcpy(&mpdu.buf.data[8], &fd.sin_port, 2);
+        mpdu.buf.data_len = 10;
+        /* reply goes to the foreign device itself */
+        if (bvlc_receive_delete_fdt_entry(bip, &fd, &mpdu.buf) < 0) {
+            printf("delete fd %u failed\r\n", i);
+            return -EPERM;
+        }
+    }
+    *ns = (double)(now_ns() - start) / ((opt.fds + 1) / 2);
+
+    return OK;
+}
+
+/* fan a Who-Is out to the whole table, returns ns per broadcast */
+static int forward_all(datalink_bip_t *bip, double *ns)
+{
+    DECLARE_BACNET_BUF(npdu, 64);
+    struct sockaddr_in src = {};
+    uint64_t start;
+    uint32_t i;
+
+    src.sin_family = AF_INET;
+    src.sin_addr.s_addr = htonl(0x7F020001);
+    src.sin_port = htons(BENCH_FD_PORT);
+
+    start = now_ns();
+    for (i = 0; i < opt.broadcasts; i++) {
+        (void)bacnet_buf_init(&npdu.buf, 64);
+        memcpy(npdu.buf.data, who_is_npdu, sizeof(who_is_npdu));
+        npdu.buf.data_len = sizeof(who_is_npdu);
+        if (bvlc_fdt_forward_npdu(bip, &src, &npdu.buf) < 0) {
+            printf("forward broadcast %u failed\r\n", i);
+            return -EPERM;
+        }
+    }
+    *ns = (double)(now_ns() - start) / opt.broadcasts;
+
+    return OK;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --fds N             registered foreign devices, at most %d (5000)\r\n"
+        "  --broadcasts M      broadcasts fanned out to the table (20)\r\n"
+        "  --ifname IF         interface of the BBMD port (lo)\r\n"
+        "  --port PORT         udp port (47808)\r\n"
+        "  --json              print report as json\r\n\r\n", prog, BENCH_MAX_FDS);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"fds", required_argument, NULL, 'f'},
+        {"broadcasts", required_argument, NULL, 'b'},
+        {"ifname", required_argument, NULL, 'i'},
+        {"port", required_argument, NULL, 'p'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'f': opt.fds = strtoul(optarg, NULL, 0); break;
+        case 'b': opt.broadcasts = strtoul(optarg, NULL, 0); break;
+        case 'i': opt.ifname = optarg; break;
+        case 'p': opt.port = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.fds < 2) || (opt.fds > BENCH_MAX_FDS) || (opt.broadcasts == 0)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+static void report_add(cJSON *report, const char *name, double ns, double per)
+{
+    cJSON *item;
+
+    item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "ns_per_op", ns);
+    if (per > 0) {
+        cJSON_AddNumberToObject(item, "ns_per_entry", per);
+    }
+    cJSON_AddItemToObject(report, name, item);
+
+    if (!opt.json) {
+        if (per > 0) {
+            printf("%-20s %12.0f ns %10.1f ns/entry\r\n", name, ns, per);
+        } else {
+            printf("%-20s %12.0f ns\r\n", name, ns);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    datalink_bip_t *bip;
+    cJSON *report;
+    uint64_t start;
+    unsigned now;
+    double ns;
+    char *str;
+    int purged;
+    int left;
+    int i;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    bip = bip_next_port(NULL);
+    if (bip == NULL) {
+        printf("no bip port\r\n");
+        return -EPERM;
+    }
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "fds", opt.fds);
+    cJSON_AddNumberToObject(report, "broadcasts", opt.broadcasts);
+
+    rv = register_all(bip, &ns);
+    if (rv < 0) {
+        goto out;
+    }
+    report_add(report, "register", ns, 0);
+
+    rv = register_all(bip, &ns);
+    if (rv < 0) {
+        goto out;
+    }
+    report_add(report, "refresh", ns, 0);
+
+    rv = forward_all(bip, &ns);
+    if (rv < 0) {
+        goto out;
+    }
+    report_add(report, "forward", ns, ns / opt.fds);
+
+    now = el_current_millisecond();
+    start = now_ns();
+    for (i = 0; i < BENCH_SWEEPS; i++) {
+        purged = bvlc_fdt_sweep(bip, now);
+        if (purged != 0) {
+            printf("sweep purged %d live entries\r\n", purged);
+            rv = -EPERM;
+            goto out;
+        }
+    }
+    ns = (double)(now_ns() - start) / BENCH_SWEEPS;
+    report_add(report, "sweep_idle", ns, ns / opt.fds);
+
+    rv = delete_half(bip, &ns);
+    if (rv < 0) {
+        goto out;
+    }
+    report_add(report, "delete", ns, 0);
+
+    left = opt.fds / 2;
+    start = now_ns();
+    purged = bvlc_fdt_sweep(bip, now + BENCH_TTL * 1000 + 1);
+    ns = (double)(now_ns() - start);
+    if (purged != left) {
+        printf("sweep purged %d, expect %d\r\n", purged, left);
+        rv = -EPERM;
+        goto out;
+    }
+    report_add(report, "sweep_expire", ns, ns / left);
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    }
+
+out:
+    cJSON_Delete(report);
+
+    return rv;
+}
@@ -0,0 +1,981 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * intrinsic_test.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * End to end check of intrinsic reporting over the in-process virtual
+ * datalink. The stack is a device on bus intrinsic-bus (net 1, mac 1) with
+ * three Analog Values reporting to a Notification Class whose recipient is a
+ * local broadcast; a workstation endpoint (mac 2) on the same bus:
+ * - writes Present_Value across High_Limit and Low_Limit, in and out of the
+ *   Deadband, and checks Event_State and the EventNotifications it receives;
+ * - does the same with Time_Delay, held, expired and cancelled by a return
+ *   before the delay ran out;
+ * - pages through GetEventInformation with a 128 octet max APDU;
+ * - sends AcknowledgeAlarm with a wrong and the notified timestamp.
+ *
+ *   ./intrinsic_test --json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacnet_buf.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/bactext.h"
+#include "bacnet/config.h"
+#include "bacnet/apdu.h"
+#include "bacnet/app.h"
+#include "bacnet/network.h"
+#include "bacnet/virtualdl.h"
+#include "bacnet/object/object.h"
+#include "bacnet/service/event.h"
+#include "bacnet/service/wp.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "debug.h"
+
+#define TEST_BUS                    "intrinsic-bus"
+#define TEST_NET                    (1)
+#define TEST_DEVICE_MAC             (1)
+#define TEST_WORKSTATION_MAC        (2)
+#define TEST_DEVICE_ID              (1)
+
+#define TEST_OBJECTS                (3)
+#define TEST_HIGH_LIMIT             (80)
+#define TEST_LOW_LIMIT              (0)
+#define TEST_DEADBAND               (2)
+#define TEST_TIME_DELAY             (1)
+
+#define TEST_MAX_NOTES              (64)
+
+#define TEST_ALL_TRANSITIONS        ((1 << MAX_BACNET_EVENT_TRANSITION) - 1)
+
+/* time for a write to be answered and its notifications drained on the loop */
+#define TEST_SETTLE_MS              (300)
+#define TEST_REPLY_MS               (1000)
+
+typedef struct {
+    uint32_t instance;
+    uint32_t from;
+    uint32_t to;
+    bool ack_required;
+    uint8_t stamp[32];              /* the context 3 timeStamp as received */
+    int stamp_len;
+} note_t;
+
+typedef struct {
+    float value;
+    uint32_t state;                 /* Event_State after the write */
+    uint32_t from;                  /* MAX_EVENT_STATE when no notification */
+    uint32_t to;
+} step_t;
+
+static struct {
+    bool json;
+} opt;
+
+static vdl_endpoint_t *workstation;
+
+static note_t notes[TEST_MAX_NOTES];
+static uint32_t note_nums;
+
+static uint8_t next_invoke;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "VIRTUAL");
+    cJSON_AddStringToObject(res, "ifname", TEST_BUS);
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "intrinsic", res);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *ports, *port;
+
+    port = cJSON_CreateObject();
+    cJSON_AddTrueToObject(port, "enable");
+    cJSON_AddNumberToObject(port, "net_num", TEST_NET);
+    cJSON_AddStringToObject(port, "dl_type", "VIRTUAL");
+    cJSON_AddStringToObject(port, "resource_name", "intrinsic");
+    cJSON_AddNumberToObject(port, "mac", TEST_DEVICE_MAC);
+
+    ports = cJSON_CreateArray();
+    cJSON_AddItemToArray(ports, port);
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "port", ports);
+
+    return cfg;
+}
+
+static cJSON *create_bool_array(bool offnormal, bool fault, bool normal)
+{
+    cJSON *array;
+
+    array = cJSON_CreateArray();
+    cJSON_AddItemToArray(array, cJSON_CreateBool(offnormal));
+    cJSON_AddItemToArray(array, cJSON_CreateBool(fault));
+    cJSON_AddItemToArray(array, cJSON_CreateBool(normal));
+
+    return array;
+}
+
+static cJSON *create_av(uint32_t idx)
+{
+    cJSON *instance, *intrinsic;
+    char name[16];
+
+    intrinsic = cJSON_CreateObject();
+    cJSON_AddNumberToObject(intrinsic, "Notification_Class", 0);
+    cJSON_AddNumberToObject(intrinsic, "High_Limit", TEST_HIGH_LIMIT);
+    cJSON_AddNumberToObject(intrinsic, "Low_Limit", TEST_LOW_LIMIT);
+    cJSON_AddNumberToObject(intrinsic, "Deadband", TEST_DEADBAND);
+
+    snprintf(name, sizeof(name), "av%u", idx);
+    instance = cJSON_CreateObject();
+    cJSON_AddStringToObject(instance, "Name", name);
+    cJSON_AddNumberToObject(instance, "Units", UNITS_DEGREES_CELSIUS);
+    cJSON_AddFalseToObject(instance, "Out_Of_Service");
+    cJSON_AddTrueToObject(instance, "Writable");
+    cJSON_AddItemToObject(instance, "Intrinsic_Reporting", intrinsic);
+
+    return instance;
+}
+
+/* AV 0 ~ 2 report to NC 0, to-offnormal and to-normal need an acknowledgment */
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg, *list, *type, *instances, *instance, *recipients, *recipient, *priority;
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", TEST_DEVICE_ID);
+    cJSON_AddStringToObject(cfg, "Device_Name", "intrinsic_test");
+    list = cJSON_CreateArray();
+    cJSON_AddItemToObject(cfg, "Object_List", list);
+
+    type = cJSON_CreateObject();
+    cJSON_AddStringToObject(type, "Type", "AV");
+    instances = cJSON_CreateArray();
+    for (i = 0; i < TEST_OBJECTS; i++) {
+        cJSON_AddItemToArray(instances, create_av(i));
+    }
+    cJSON_AddItemToObject(type, "Instance_List", instances);
+    cJSON_AddItemToArray(list, type);
+
+    recipient = cJSON_CreateObject();
+    cJSON_AddNumberToObject(recipient, "Network", 0);
+    recipients = cJSON_CreateArray();
+    cJSON_AddItemToArray(recipients, recipient);
+
+    priority = cJSON_CreateArray();
+    cJSON_AddItemToArray(priority, cJSON_CreateNumber(10));
+    cJSON_AddItemToArray(priority, cJSON_CreateNumber(20));
+    cJSON_AddItemToArray(priority, cJSON_CreateNumber(30));
+
+    instance = cJSON_CreateObject();
+    cJSON_AddStringToObject(instance, "Name", "nc0");
+    cJSON_AddItemToObject(instance, "Priority", priority);
+    cJSON_AddItemToObject(instance, "Ack_Required", create_bool_array(true, false, true));
+    cJSON_AddItemToObject(instance, "Recipient_List", recipients);
+
+    type = cJSON_CreateObject();
+    cJSON_AddStringToObject(type, "Type", "NC");
+    instances = cJSON_CreateArray();
+    cJSON_AddItemToArray(instances, instance);
+    cJSON_AddItemToObject(type, "Instance_List", instances);
+    cJSON_AddItemToArray(list, type);
+
+    return cfg;
+}
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* @return: offset of the apdu, <0 for a network message or a bad npdu */
+static int npdu_skip(const uint8_t *pdu, int pdu_len)
+{
+    uint8_t control;
+    int len;
+
+    if ((pdu_len < 2) || (pdu[0] != BACNET_PROTOCOL_VERSION) || (pdu[1] & 0x80)) {
+        return -EINVAL;
+    }
+
+    control = pdu[1];
+    len = 2;
+    if (control & 0x20) {
+        if (len + 3 > pdu_len) {
+            return -EINVAL;
+        }
+        len += 3 + pdu[len + 2];
+    }
+    if (control & 0x08) {
+        if (len + 3 > pdu_len) {
+            return -EINVAL;
+        }
+        len += 3 + pdu[len + 2];
+    }
+    if (control & 0x20) {
+        len++;
+    }
+
+    return (len < pdu_len)? len: -EINVAL;
+}
+
+static void note_decode(const uint8_t *pdu, int pdu_len)
+{
+    static const uint8_t skipped[] = {4, 5, 6, 8};
+    BACNET_OBJECT_TYPE type;
+    BACNET_TIMESTAMP stamp;
+    note_t *note;
+    uint32_t value, i;
+    int len, dec_len;
+
+    if (note_nums >= TEST_MAX_NOTES) {
+        return;
+    }
+    note = &notes[note_nums];
+    memset(note, 0, sizeof(*note));
+
+    /* Tag 0: processIdentifier, Tag 1: initiatingDeviceIdentifier */
+    len = decode_context_unsigned(pdu, 0, &value);
+    if (len < 0) {
+        return;
+    }
+    dec_len = decode_context_object_id(&pdu[len], 1, &type, &value);
+    if (dec_len < 0) {
+        return;
+    }
+    len += dec_len;
+
+    /* Tag 2: eventObjectIdentifier */
+    dec_len = decode_context_object_id(&pdu[len], 2, &type, &note->instance);
+    if ((dec_len < 0) || (type != OBJECT_ANALOG_VALUE)) {
+        return;
+    }
+    len += dec_len;
+
+    /* Tag 3: timeStamp, kept as is for AcknowledgeAlarm which has it as tag 3 too */
+    dec_len = decode_context_timestamp(&pdu[len], 3, &stamp);
+    if ((dec_len < 0) || (dec_len > (int)sizeof(note->stamp))) {
+        return;
+    }
+    memcpy(note->stamp, &pdu[len], dec_len);
+    note->stamp_len = dec_len;
+    len += dec_len;
+
+    /* Tag 4: notificationClass, Tag 5: priority, Tag 6: eventType, Tag 8: notifyType */
+    for (i = 0; i < sizeof(skipped); i++) {
+        dec_len = decode_context_unsigned(&pdu[len], skipped[i], &value);
+        if (dec_len < 0) {
+            return;
+        }
+        len += dec_len;
+    }
+
+    /* Tag 9: AckRequired, Tag 10: fromState, Tag 11: toState */
+    dec_len = decode_context_boolean(&pdu[len], 9, &note->ack_required);
+    if (dec_len < 0) {
+        return;
+    }
+    len += dec_len;
+
+    dec_len = decode_context_enumerated(&pdu[len], 10, &note->from);
+    if (dec_len < 0) {
+        return;
+    }
+    len += dec_len;
+
+    if ((decode_context_enumerated(&pdu[len], 11, &note->to) < 0) || (len >= pdu_len)) {
+        return;
+    }
+
+    note_nums++;
+}
+
+/*
+ * Drain the workstation for up to timeout_ms: EventNotifications are kept in notes,
+ * the reply to invoke_id (<0 for none) ends the wait.
+ * @return: reply length, 0 if none
+ */
+static int bus_poll(uint32_t timeout_ms, int invoke_id, uint8_t *reply, int reply_size)
+{
+    uint8_t frame[VDL_MAX_NPDU];
+    uint8_t *apdu;
+    uint64_t end;
+    uint16_t src;
+    uint8_t pdu_type;
+    int len, offset;
+
+    end = now_ms() + timeout_ms;
+    do {
+        len = vdl_endpoint_recv(workstation, &src, frame, sizeof(frame));
+        if (len <= 0) {
+            usleep(1000);
+            continue;
+        }
+
+        offset = npdu_skip(frame, len);
+        if (offset < 0) {
+            continue;
+        }
+        apdu = &frame[offset];
+        len -= offset;
+        pdu_type = apdu[0] >> 4;
+
+        if ((pdu_type == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) && (len > 2)
+                && (apdu[1] == SERVICE_UNCONFIRMED_EVENT_NOTIFICATION)) {
+            note_decode(&apdu[2], len - 2);
+            continue;
+        }
+
+        if ((invoke_id >= 0) && (pdu_type >= PDU_TYPE_SIMPLE_ACK) && (len > 2)
+                && (apdu[1] == (uint8_t)invoke_id) && (len <= reply_size)) {
+            memcpy(reply, apdu, len);
+            return len;
+        }
+    } while (now_ms() < end);
+
+    return 0;
+}
+
+/* @return: reply length, 0 if no reply */
+static int confirmed_request(uint8_t service, const uint8_t *request, int request_len,
+            int max_apdu, uint8_t *reply, int reply_size)
+{
+    uint8_t frame[VDL_MAX_NPDU];
+    uint8_t invoke_id;
+    int len;
+
+    invoke_id = next_invoke++;
+
+    frame[0] = BACNET_PROTOCOL_VERSION;
+    frame[1] = 0x04;                /* expecting reply */
+    frame[2] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+    frame[3] = encode_max_segs_max_apdu(0, max_apdu);
+    frame[4] = invoke_id;
+    frame[5] = service;
+    len = 6;
+    memcpy(&frame[len], request, request_len);
+    len += request_len;
+
+    if (vdl_endpoint_send(workstation, TEST_DEVICE_MAC, frame, len) < 0) {
+        return 0;
+    }
+
+    return bus_poll(TEST_REPLY_MS, invoke_id, reply, reply_size);
+}
+
+/* @return: 1 if the write is acknowledged */
+static uint32_t write_property(uint32_t instance, BACNET_PROPERTY_ID property, uint8_t *value,
+            int value_len)
+{
+    DECLARE_BACNET_BUF(tx_apdu, MAX_APDU);
+    uint8_t reply[MAX_APDU];
+    int len;
+
+    (void)bacnet_buf_init(&tx_apdu.buf, MAX_APDU);
+    wp_req_encode(&tx_apdu.buf, OBJECT_ANALOG_VALUE, instance, property, BACNET_ARRAY_ALL);
+    memcpy(&tx_apdu.buf.data[tx_apdu.buf.data_len], value, value_len);
+    tx_apdu.buf.data_len += value_len;
+    (void)wp_req_encode_end(&tx_apdu.buf, 0, BACNET_MAX_PRIORITY);
+
+    len = confirmed_request(SERVICE_CONFIRMED_WRITE_PROPERTY, &tx_apdu.buf.data[4],
+        tx_apdu.buf.data_len - 4, MAX_APDU, reply, sizeof(reply));
+
+    return ((len > 0) && ((reply[0] >> 4) == PDU_TYPE_SIMPLE_ACK))? 1: 0;
+}
+
+static uint32_t write_value(uint32_t instance, float value)
+{
+    uint8_t data[8];
+
+    return write_property(instance, PROP_PRESENT_VALUE, data, encode_application_real(data, value));
+}
+
+static uint32_t event_state(uint32_t instance)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    uint8_t pdu[MAX_APDU];
+    uint32_t value;
+
+    memset(&rp_data, 0, sizeof(rp_data));
+    rp_data.object_type = OBJECT_ANALOG_VALUE;
+    rp_data.object_instance = instance;
+    rp_data.property_id = PROP_EVENT_STATE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = pdu;
+    rp_data.application_data_len = sizeof(pdu);
+
+    value = UINT32_MAX;
+    if (object_read_property(&rp_data, NULL) > 0) {
+        (void)decode_application_enumerated(pdu, &value);
+    }
+
+    return value;
+}
+
+/* Acked_Transitions as 1 << BACNET_EVENT_TRANSITION_BITS */
+static uint32_t acked_transitions(uint32_t instance)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    BACNET_BIT_STRING bits;
+    uint8_t pdu[MAX_APDU];
+    uint32_t value, i;
+
+    memset(&rp_data, 0, sizeof(rp_data));
+    rp_data.object_type = OBJECT_ANALOG_VALUE;
+    rp_data.object_instance = instance;
+    rp_data.property_id = PROP_ACKED_TRANSITIONS;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = pdu;
+    rp_data.application_data_len = sizeof(pdu);
+
+    if ((object_read_property(&rp_data, NULL) < 0)
+            || (decode_application_bitstring(pdu, &bits) < 0)) {
+        return UINT32_MAX;
+    }
+
+    value = 0;
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        if (bitstring_get_bit(&bits, i)) {
+            value |= 1 << i;
+        }
+    }
+
+    return value;
+}
+
+static const char *state_text(uint32_t state)
+{
+    return (state < MAX_EVENT_STATE)? bactext_event_state_name(state): "none";
+}
+
+/*
+ * Event_State of instance, and its notifications since first: one from -> to,
+ * or none when to is MAX_EVENT_STATE. Every transition of the test wants an ack.
+ */
+static bool expect_events(cJSON *report, const char *name, uint32_t instance, uint32_t first,
+            uint32_t state, uint32_t from, uint32_t to)
+{
+    cJSON *item;
+    uint32_t count, got_state, i;
+    note_t *last;
+    bool ok;
+
+    count = 0;
+    last = NULL;
+    for (i = first; i < note_nums; i++) {
+        if (notes[i].instance == instance) {
+            count++;
+            last = &notes[i];
+        }
+    }
+
+    got_state = event_state(instance);
+    if (to == MAX_EVENT_STATE) {
+        ok = (got_state == state) && (count == 0);
+    } else {
+        ok = (got_state == state) && (count == 1) && (last->from == from) && (last->to == to)
+            && last->ack_required;
+    }
+
+    item = cJSON_CreateObject();
+    cJSON_AddStringToObject(item, "event_state", state_text(got_state));
+    cJSON_AddNumberToObject(item, "notifications", count);
+    if (last) {
+        cJSON_AddStringToObject(item, "from", state_text(last->from));
+        cJSON_AddStringToObject(item, "to", state_text(last->to));
+        cJSON_AddBoolToObject(item, "ack_required", last->ack_required);
+    }
+    cJSON_AddBoolToObject(item, "pass", ok);
+    cJSON_AddItemToObject(report, name, item);
+
+    if (!opt.json) {
+        printf("%-20s %-12s", name, state_text(got_state));
+        if (last) {
+            printf(" %u notified, last %s -> %s%s", count, state_text(last->from),
+                state_text(last->to), last->ack_required? " ack": "");
+        } else {
+            printf(" not notified");
+        }
+        printf("%s\r\n", ok? "": " FAIL");
+        if (!ok) {
+            printf("%-20s %-12s %s -> %s\r\n", "  expected", state_text(state),
+                state_text(from), state_text(to));
+        }
+    }
+
+    return ok;
+}
+
+/* AV 0, no Time_Delay: every crossing notifies at once, the deadband holds the way back */
+static bool test_limits(cJSON *report)
+{
+    static const step_t steps[] = {
+        {50.0f, EVENT_STATE_NORMAL, MAX_EVENT_STATE, MAX_EVENT_STATE},
+        {90.0f, EVENT_STATE_HIGH_LIMIT, EVENT_STATE_NORMAL, EVENT_STATE_HIGH_LIMIT},
+        {79.0f, EVENT_STATE_HIGH_LIMIT, MAX_EVENT_STATE, MAX_EVENT_STATE},
+        {77.0f, EVENT_STATE_NORMAL, EVENT_STATE_HIGH_LIMIT, EVENT_STATE_NORMAL},
+        {-5.0f, EVENT_STATE_LOW_LIMIT, EVENT_STATE_NORMAL, EVENT_STATE_LOW_LIMIT},
+        {1.0f, EVENT_STATE_LOW_LIMIT, MAX_EVENT_STATE, MAX_EVENT_STATE},
+        {50.0f, EVENT_STATE_NORMAL, EVENT_STATE_LOW_LIMIT, EVENT_STATE_NORMAL},
+    };
+    char name[32];
+    uint32_t first, i;
+    bool ok;
+
+    ok = true;
+    for (i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        first = note_nums;
+        snprintf(name, sizeof(name), "AV0 = %g", steps[i].value);
+        if (!write_value(0, steps[i].value)) {
+            printf("%-20s write refused\r\n", name);
+            ok = false;
+            continue;
+        }
+        (void)bus_poll(TEST_SETTLE_MS, -1, NULL, 0);
+        ok &= expect_events(report, name, 0, first, steps[i].state, steps[i].from, steps[i].to);
+    }
+
+    return ok;
+}
+
+/* AV 1 with Time_Delay: held until the delay runs out, a return within it cancels */
+static bool test_time_delay(cJSON *report)
+{
+    uint8_t data[8];
+    uint32_t first;
+    bool ok;
+
+    if (!write_property(1, PROP_TIME_DELAY, data, encode_application_unsigned(data,
+            TEST_TIME_DELAY))) {
+        printf("%-20s write refused\r\n", "AV1 Time_Delay");
+        return false;
+    }
+
+    first = note_nums;
+    (void)write_value(1, 90.0f);
+    (void)bus_poll(TEST_SETTLE_MS, -1, NULL, 0);
+    ok = expect_events(report, "AV1 high, in delay", 1, first, EVENT_STATE_NORMAL,
+        MAX_EVENT_STATE, MAX_EVENT_STATE);
+
+    (void)bus_poll(TEST_TIME_DELAY * 1000, -1, NULL, 0);
+    ok &= expect_events(report, "AV1 delay expired", 1, first, EVENT_STATE_HIGH_LIMIT,
+        EVENT_STATE_NORMAL, EVENT_STATE_HIGH_LIMIT);
+
+    /* back in the limit for less than Time_Delay */
+    first = note_nums;
+    (void)write_value(1, 50.0f);
+    (void)bus_poll(TEST_TIME_DELAY * 1000 / 2, -1, NULL, 0);
+    (void)write_value(1, 90.0f);
+    (void)bus_poll(TEST_TIME_DELAY * 1000 + TEST_SETTLE_MS, -1, NULL, 0);
+    ok &= expect_events(report, "AV1 short return", 1, first, EVENT_STATE_HIGH_LIMIT,
+        MAX_EVENT_STATE, MAX_EVENT_STATE);
+
+    first = note_nums;
+    (void)write_value(1, 50.0f);
+    (void)bus_poll(TEST_TIME_DELAY * 1000 + TEST_SETTLE_MS, -1, NULL, 0);
+    ok &= expect_events(report, "AV1 back to normal", 1, first, EVENT_STATE_NORMAL,
+        EVENT_STATE_HIGH_LIMIT, EVENT_STATE_NORMAL);
+
+    return ok;
+}
+
+/*
+ * One GetEventInformation page after last_instance (<0 to start over).
+ * @return: summaries in the page, <0 if no proper reply
+ */
+static int event_information(int max_apdu, int last_instance, uint32_t *instances,
+            uint32_t max_nums, bool *more)
+{
+    uint8_t request[8], reply[MAX_APDU];
+    BACNET_OBJECT_TYPE type;
+    uint32_t len_value, instance;
+    uint8_t tag_number;
+    int request_len, reply_len, len, dec_len, depth, nums;
+
+    request_len = 0;
+    if (last_instance >= 0) {
+        request_len = encode_context_object_id(request, 0, OBJECT_ANALOG_VALUE, last_instance);
+    }
+
+    reply_len = confirmed_request(SERVICE_CONFIRMED_GET_EVENT_INFORMATION, request, request_len,
+        max_apdu, reply, sizeof(reply));
+    if ((reply_len < 4) || ((reply[0] >> 4) != PDU_TYPE_COMPLEX_ACK)
+            || (decode_opening_tag(&reply[3], 0) < 0)) {
+        return -EPERM;
+    }
+
+    /* each summary starts with its context 0 objectIdentifier */
+    nums = 0;
+    depth = 0;
+    len = 4;
+    while (len < reply_len) {
+        if (IS_OPENING_CLOSING_TAG(reply[len])) {
+            if (IS_OPENING_TAG(reply[len])) {
+                depth++;
+            } else if (depth-- == 0) {
+                break;
+            }
+            len++;
+            continue;
+        }
+
+        if ((depth == 0) && (decode_context_object_id(&reply[len], 0, &type, &instance) > 0)) {
+            if (nums < (int)max_nums) {
+                instances[nums] = instance;
+            }
+            nums++;
+        }
+
+        dec_len = decode_tag_number_and_value(&reply[len], &tag_number, &len_value);
+        if (dec_len < 0) {
+            return -EPERM;
+        }
+        len += dec_len + len_value;
+    }
+
+    if ((len >= reply_len) || (decode_closing_tag(&reply[len], 0) < 0)
+            || (decode_context_boolean(&reply[len + 1], 1, more) < 0)) {
+        return -EPERM;
+    }
+
+    return nums;
+}
+
+/* one GetEventInformation with a full size reply holds all summaries */
+static bool expect_summaries(cJSON *report, const char *name, int expect)
+{
+    uint32_t instances[TEST_OBJECTS + 1];
+    cJSON *item;
+    bool more, ok;
+    int nums;
+
+    more = false;
+    nums = event_information(MAX_APDU, -1, instances, TEST_OBJECTS + 1, &more);
+    ok = (nums == expect) && !more;
+
+    item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "summaries", nums);
+    cJSON_AddBoolToObject(item, "more_events", more);
+    cJSON_AddBoolToObject(item, "pass", ok);
+    cJSON_AddItemToObject(report, name, item);
+
+    if (!opt.json) {
+        printf("%-20s %d summaries, moreEvents %s%s\r\n", name, nums, more? "true": "false",
+            ok? "": " FAIL");
+    }
+
+    return ok;
+}
+
+/* a 128 octet reply holds one summary, the pages come in object identifier order */
+static bool test_paging(cJSON *report)
+{
+    uint32_t instances[TEST_OBJECTS + 1];
+    uint32_t pages, items;
+    int last, nums;
+    bool more, ordered, ok;
+    cJSON *item;
+
+    pages = 0;
+    items = 0;
+    ordered = true;
+    last = -1;
+    more = false;
+    do {
+        nums = event_information(128, last, instances, 1, &more);
+        if ((nums <= 0) || (pages > TEST_OBJECTS)) {
+            break;
+        }
+        if ((int)instances[0] <= last) {
+            ordered = false;
+        }
+        last = instances[0];
+        items += nums;
+        pages++;
+    } while (more);
+
+    ok = (pages == TEST_OBJECTS) && (items == TEST_OBJECTS) && ordered && !more;
+
+    item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "pages", pages);
+    cJSON_AddNumberToObject(item, "summaries", items);
+    cJSON_AddBoolToObject(item, "ordered", ordered);
+    cJSON_AddBoolToObject(item, "pass", ok);
+    cJSON_AddItemToObject(report, "GEI 128 octet pages", item);
+
+    if (!opt.json) {
+        printf("%-20s %u pages, %u summaries, %s%s\r\n", "GEI 128 octet pages", pages, items,
+            ordered? "in order": "out of order", ok? "": " FAIL");
+    }
+
+    return ok;
+}
+
+/* latest notification of instance into state, NULL if none */
+static note_t *note_find(uint32_t instance, uint32_t to)
+{
+    int i;
+
+    for (i = (int)note_nums - 1; i >= 0; i--) {
+        if ((notes[i].instance == instance) && (notes[i].to == to)) {
+            return &notes[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* @return: MAX_BACNET_ERROR_CODE for a SimpleAck, the error code of an Error, else UINT32_MAX */
+static uint32_t alarm_ack(uint32_t instance, BACNET_EVENT_STATE state, const uint8_t *stamp,
+            int stamp_len)
+{
+    BACNET_CHARACTER_STRING source;
+    uint8_t request[MAX_APDU], reply[MAX_APDU];
+    uint32_t error_class, error_code;
+    int len, reply_len;
+
+    characterstring_init_ansi(&source, "intrinsic_test", strlen("intrinsic_test"));
+
+    len = encode_context_unsigned(request, 0, 1);
+    len += encode_context_object_id(&request[len], 1, OBJECT_ANALOG_VALUE, instance);
+    len += encode_context_enumerated(&request[len], 2, state);
+    memcpy(&request[len], stamp, stamp_len);
+    len += stamp_len;
+    len += encode_context_character_string(&request[len], 4, &source);
+    len += encode_context_timestamp(&request[len], 5, time(NULL));
+
+    reply_len = confirmed_request(SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM, request, len, MAX_APDU,
+        reply, sizeof(reply));
+    if (reply_len < 3) {
+        return UINT32_MAX;
+    }
+
+    if ((reply[0] >> 4) == PDU_TYPE_SIMPLE_ACK) {
+        return MAX_BACNET_ERROR_CODE;
+    }
+
+    if (((reply[0] >> 4) != PDU_TYPE_ERROR)
+            || ((len = decode_application_enumerated(&reply[3], &error_class)) < 0)
+            || (decode_application_enumerated(&reply[3 + len], &error_code) < 0)) {
+        return UINT32_MAX;
+    }
+
+    return error_code;
+}
+
+/* got is what alarm_ack returned */
+static bool expect_ack(cJSON *report, const char *name, uint32_t got, uint32_t expect)
+{
+    const char *text;
+    bool ok;
+
+    if (got == MAX_BACNET_ERROR_CODE) {
+        text = "SimpleAck";
+    } else if (got == UINT32_MAX) {
+        text = "no reply";
+    } else {
+        text = bactext_error_code_name(got);
+    }
+
+    ok = (got == expect);
+    cJSON_AddStringToObject(report, name, text);
+    if (!opt.json) {
+        printf("%-20s %s%s\r\n", name, text, ok? "": " FAIL");
+    }
+
+    return ok;
+}
+
+static bool expect_acked(cJSON *report, const char *name, uint32_t instance, uint32_t expect)
+{
+    uint32_t acked;
+    bool ok;
+
+    acked = acked_transitions(instance);
+    ok = (acked == expect);
+    cJSON_AddNumberToObject(report, name, acked);
+    if (!opt.json) {
+        printf("%-20s to-offnormal %s, to-fault %s, to-normal %s%s\r\n", name,
+            (acked & (1 << TRANSITION_TO_OFFNORMAL))? "acked": "unacked",
+            (acked & (1 << TRANSITION_TO_FAULT))? "acked": "unacked",
+            (acked & (1 << TRANSITION_TO_NORMAL))? "acked": "unacked", ok? "": " FAIL");
+    }
+
+    return ok;
+}
+
+/*
+ * AV 2 goes high and stays there. AV 0 and AV 1 are back to normal, but their
+ * transitions wait for an acknowledgment, so all three are summarized.
+ */
+static bool test_acknowledge(cJSON *report)
+{
+    uint8_t stamp[32];
+    note_t *note;
+    int stamp_len;
+    bool ok;
+
+    (void)write_value(2, 90.0f);
+    (void)bus_poll(TEST_SETTLE_MS, -1, NULL, 0);
+
+    ok = expect_summaries(report, "GEI unacked", TEST_OBJECTS);
+    ok &= test_paging(report);
+
+    note = note_find(2, EVENT_STATE_HIGH_LIMIT);
+    if (note == NULL) {
+        printf("%-20s not notified\r\n", "AV2 high");
+        return false;
+    }
+
+    /* a timestamp an hour before the transition */
+    stamp_len = encode_context_timestamp(stamp, 3, time(NULL) - 3600);
+    ok &= expect_ack(report, "ack AV2 old stamp", alarm_ack(2, EVENT_STATE_HIGH_LIMIT, stamp,
+        stamp_len), ERROR_CODE_INVALID_TIME_STAMP);
+    ok &= expect_ack(report, "ack unknown object", alarm_ack(TEST_OBJECTS + 5,
+        EVENT_STATE_HIGH_LIMIT, note->stamp, note->stamp_len), ERROR_CODE_UNKNOWN_OBJECT);
+    ok &= expect_acked(report, "AV2 before ack", 2,
+        TEST_ALL_TRANSITIONS & ~(1 << TRANSITION_TO_OFFNORMAL));
+    ok &= expect_ack(report, "ack AV2", alarm_ack(2, EVENT_STATE_HIGH_LIMIT, note->stamp,
+        note->stamp_len), MAX_BACNET_ERROR_CODE);
+    ok &= expect_acked(report, "AV2 after ack", 2, TEST_ALL_TRANSITIONS);
+
+    /* AV 2 is acked but still high, AV 0 leaves the summaries once both its transitions are */
+    ok &= expect_summaries(report, "GEI AV2 acked", TEST_OBJECTS);
+
+    note = note_find(0, EVENT_STATE_LOW_LIMIT);
+    ok &= expect_ack(report, "ack AV0 low", note? alarm_ack(0, EVENT_STATE_LOW_LIMIT,
+        note->stamp, note->stamp_len): UINT32_MAX, MAX_BACNET_ERROR_CODE);
+    note = note_find(0, EVENT_STATE_NORMAL);
+    ok &= expect_ack(report, "ack AV0 normal", note? alarm_ack(0, EVENT_STATE_NORMAL,
+        note->stamp, note->stamp_len): UINT32_MAX, MAX_BACNET_ERROR_CODE);
+    ok &= expect_summaries(report, "GEI AV0 acked", TEST_OBJECTS - 1);
+
+    return ok;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *report;
+    char *str;
+    bool ok;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    workstation = vdl_endpoint_create(TEST_BUS, TEST_WORKSTATION_MAC, 256);
+    if (workstation == NULL) {
+        printf("create workstation endpoint failed\r\n");
+        return -EPERM;
+    }
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        vdl_endpoint_destroy(workstation);
+        return rv;
+    }
+
+    apdu_set_default_service_handler();
+
+    rv = el_loop_start(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop start failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    report = cJSON_CreateObject();
+
+    /* the first pass of intrinsic reporting runs on the loop, nothing is out of range */
+    (void)bus_poll(TEST_SETTLE_MS, -1, NULL, 0);
+    cJSON_AddNumberToObject(report, "notified at start", note_nums);
+    if (!opt.json) {
+        printf("%-20s %u notified\r\n", "at start", note_nums);
+    }
+    ok = (note_nums == 0);
+
+    ok &= test_limits(report);
+    ok &= test_time_delay(report);
+    ok &= test_acknowledge(report);
+    cJSON_AddStringToObject(report, "result", ok? "pass": "fail");
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("%-20s %s\r\n", "result", ok? "pass": "fail");
+    }
+
+    cJSON_Delete(report);
+    rv = ok? OK: -EPERM;
+
+out:
+    bacnet_exit();
+    vdl_endpoint_destroy(workstation);
+
+    return rv? -EPERM: OK;
+}
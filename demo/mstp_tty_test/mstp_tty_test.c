@@ -0,0 +1,556 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * mstp_tty_test.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Bus test of the termios MS/TP datalink without hardware. --nodes pty pairs
+ * are created, every MS/TP port of the stack opens one pty slave and a bridge
+ * thread copies the octets written to any pty master to all the others, like
+ * a RS-485 segment. Checks that the ring is formed, then reports the token
+ * rotation rate, Test_Request round trip latency and delivery of large COBS
+ * encoded frames. The last large npdu is queued at life safety priority behind
+ * the others and should wait for about one token rotation, the max wait of
+ * normal priority includes the npdus queued before the ring was formed.
+ *
+ *   ./mstp_tty_test --nodes 4 --baudrate 115200 --tests 100 --seconds 3
+ *
+ * History
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/apdu.h"
+#include "bacnet/mstp.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "misc/threadpool.h"
+
+#define TEST_DEVICE_ID              (1000)
+#define TEST_MAX_NODES              (16)
+#define TEST_LARGE_NPDU_LEN         (1400)
+
+static struct {
+    uint32_t nodes;
+    uint32_t baudrate;
+    uint32_t tests;
+    uint32_t large;
+    uint32_t seconds;
+    uint32_t rt_priority;
+    bool json;
+} opt = {
+    .nodes = 4,
+    .baudrate = 115200,
+    .tests = 100,
+    .large = 20,
+    .seconds = 3,
+    .rt_priority = 0,
+};
+
+static int masters[TEST_MAX_NODES];
+
+static char slaves[TEST_MAX_NODES][64];
+
+static volatile bool bridging;
+
+static sem_t test_done;
+
+static mstp_test_result_t test_result;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+    char name[16];
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    for (i = 0; i < opt.nodes; i++) {
+        res = cJSON_CreateObject();
+        cJSON_AddStringToObject(res, "type", "TTY");
+        cJSON_AddStringToObject(res, "ifname", slaves[i]);
+        snprintf(name, sizeof(name), "tty%u", i);
+        cJSON_AddItemToObject(cfg, name, res);
+    }
+
+    return cfg;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *array, *port;
+    char name[16];
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "route_table", cJSON_CreateArray());
+
+    array = cJSON_CreateArray();
+    for (i = 0; i < opt.nodes; i++) {
+        port = cJSON_CreateObject();
+        snprintf(name, sizeof(name), "tty%u", i);
+        cJSON_AddTrueToObject(port, "enable");
+        cJSON_AddNumberToObject(port, "net_num", i + 1);
+        cJSON_AddStringToObject(port, "dl_type", "MSTP");
+        cJSON_AddStringToObject(port, "resource_name", name);
+        cJSON_AddNumberToObject(port, "baudrate", opt.baudrate);
+        cJSON_AddNumberToObject(port, "this_station", i);
+        cJSON_AddNumberToObject(port, "max_master", opt.nodes - 1);
+        cJSON_AddNumberToObject(port, "rt_priority", opt.rt_priority);
+        cJSON_AddNumberToObject(port, "tx_buf_size", 65536);
+        cJSON_AddItemToArray(array, port);
+    }
+    cJSON_AddItemToObject(cfg, "port", array);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", TEST_DEVICE_ID);
+    cJSON_AddStringToObject(cfg, "Device_Name", "mstp tty test");
+    cJSON_AddItemToObject(cfg, "Object_List", cJSON_CreateArray());
+
+    return cfg;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int open_ptys(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < opt.nodes; i++) {
+        masters[i] = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (masters[i] < 0 || grantpt(masters[i]) < 0 || unlockpt(masters[i]) < 0
+                || ptsname_r(masters[i], slaves[i], sizeof(slaves[i])) != 0) {
+            printf("create pty %u failed cause %s\r\n", i, strerror(errno));
+            return -EPERM;
+        }
+    }
+
+    return OK;
+}
+
+/* octets written by any node are seen by all other nodes */
+static void *bridge_func(void *arg)
+{
+    struct pollfd fds[TEST_MAX_NODES];
+    uint8_t buf[512];
+    uint32_t i, j;
+    int n;
+
+    for (i = 0; i < opt.nodes; i++) {
+        fds[i].fd = masters[i];
+        fds[i].events = POLLIN;
+    }
+
+    while (bridging) {
+        if (poll(fds, opt.nodes, 100) <= 0) {
+            continue;
+        }
+
+        for (i = 0; i < opt.nodes; i++) {
+            if (!(fds[i].revents & POLLIN)) {
+                continue;
+            }
+            n = read(masters[i], buf, sizeof(buf));
+            if (n <= 0) {
+                continue;
+            }
+            for (j = 0; j < opt.nodes; j++) {
+                if (j != i && write(masters[j], buf, n) != n) {
+                    printf("bridge to node %u dropped\r\n", j);
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static datalink_mstp_t *get_port(uint32_t idx)
+{
+    datalink_mstp_t *port;
+
+    port = mstp_next_port(NULL);
+    while (port && idx--) {
+        port = mstp_next_port(port);
+    }
+
+    return port;
+}
+
+static double mib_number(datalink_mstp_t *port, const char *name)
+{
+    cJSON *mib, *item;
+    double value;
+
+    mib = port->dl.get_port_mib(&port->dl);
+    if (mib == NULL) {
+        return 0;
+    }
+
+    item = cJSON_GetObjectItem(mib, name);
+    value = (item && item->type == cJSON_Number)? item->valuedouble: 0;
+    cJSON_Delete(mib);
+
+    return value;
+}
+
+/* every node passes the token to its successor and nobody is sole master */
+static bool ring_formed(void)
+{
+    datalink_mstp_t *port;
+    cJSON *mib, *item;
+    bool ok;
+    uint32_t i;
+
+    for (i = 0; i < opt.nodes; i++) {
+        port = get_port(i);
+        mib = port->dl.get_port_mib(&port->dl);
+        if (mib == NULL) {
+            return false;
+        }
+        item = cJSON_GetObjectItem(mib, "next_station");
+        ok = item && (item->valueint == (i + 1) % opt.nodes);
+        item = cJSON_GetObjectItem(mib, "sole_master");
+        ok = ok && item && (item->type == cJSON_False);
+        cJSON_Delete(mib);
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_callback(void *context, mstp_test_result_t result)
+{
+    test_result = result;
+    sem_post(&test_done);
+}
+
+static int run_tests(datalink_mstp_t *port, double *avg_us, double *max_us, uint32_t *passed)
+{
+    uint8_t data[64];
+    struct timespec ts;
+    uint64_t start, ns, sum;
+    uint32_t i;
+    int rv;
+
+    sum = 0;
+    *max_us = 0;
+    *passed = 0;
+    for (i = 0; i < opt.tests; i++) {
+        memset(data, i, sizeof(data));
+        start = now_ns();
+        rv = mstp_test_remote(port, 1, data, sizeof(data), test_callback, NULL);
+        if (rv < 0) {
+            printf("test remote failed(%d)\r\n", rv);
+            return rv;
+        }
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += 2;
+        if (sem_timedwait(&test_done, &ts) < 0) {
+            printf("test %u timeout\r\n", i);
+            return -ETIMEDOUT;
+        }
+        ns = now_ns() - start;
+
+        sum += ns;
+        if (ns / 1000.0 > *max_us) {
+            *max_us = ns / 1000.0;
+        }
+        if (test_result.success && test_result.remote_mac == 1) {
+            (*passed)++;
+        }
+    }
+
+    *avg_us = opt.tests? sum / 1000.0 / opt.tests: 0;
+
+    return OK;
+}
+
+/* max_wait_ms of a priority in tx_prio of the mib */
+static double prio_max_wait(datalink_mstp_t *port, const char *prio)
+{
+    cJSON *mib, *array, *item, *name;
+    double value;
+
+    value = -1;
+    mib = port->dl.get_port_mib(&port->dl);
+    if (mib == NULL) {
+        return value;
+    }
+
+    array = cJSON_GetObjectItem(mib, "tx_prio");
+    if (array) {
+        cJSON_ArrayForEach(item, array) {
+            name = cJSON_GetObjectItem(item, "priority");
+            if (name && !strcmp(name->valuestring, prio)) {
+                value = cJSON_GetObjectItem(item, "max_wait_ms")->valuedouble;
+            }
+        }
+    }
+    cJSON_Delete(mib);
+
+    return value;
+}
+
+/* npdus longer than 501 octets go as COBS encoded extended data frames */
+static int send_large(datalink_mstp_t *from, datalink_mstp_t *to, uint32_t *delivered)
+{
+    DECLARE_BACNET_BUF(npdu, TEST_LARGE_NPDU_LEN);
+    bacnet_addr_t dst;
+    double start;
+    uint32_t i;
+    int rv;
+
+    start = mib_number(to, "rx_ok");
+
+    dst.net = 0;
+    dst.len = 1;
+    dst.adr[0] = 1;
+    for (i = 0; i < opt.large; i++) {
+        bacnet_buf_init(&npdu.buf, TEST_LARGE_NPDU_LEN);
+        /* network layer message of a proprietary type, dropped after delivery */
+        npdu.buf.data[0] = 0x01;
+        npdu.buf.data[1] = 0x80;
+        npdu.buf.data[2] = 0x80;
+        npdu.buf.data[3] = 0x01;
+        npdu.buf.data[4] = 0x04;
+        memset(&npdu.buf.data[5], i, TEST_LARGE_NPDU_LEN - 5);
+        npdu.buf.data_len = TEST_LARGE_NPDU_LEN;
+
+        rv = from->dl.send_pdu(&from->dl, &dst, &npdu.buf,
+            (i + 1 == opt.large)? PRIORITY_LIFE_SAFETY: PRIORITY_NORMAL, true);
+        if (rv < 0) {
+            printf("send large npdu %u failed(%d)\r\n", i, rv);
+            return rv;
+        }
+    }
+
+    /* let the queue drain with the token */
+    for (i = 0; i < 100; i++) {
+        if (mib_number(to, "rx_ok") - start >= opt.large) {
+            break;
+        }
+        usleep(20000);
+    }
+    *delivered = mib_number(to, "rx_ok") - start;
+
+    return OK;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --nodes N           master nodes on the bus, 2..%d (4)\r\n"
+        "  --baudrate B        baudrate of the ports (115200)\r\n"
+        "  --tests T           Test_Request round trips from node 0 to node 1 (100)\r\n"
+        "  --large L           npdus of %d octets from node 0 to node 1 (20)\r\n"
+        "  --seconds S         token rotation measure time (3)\r\n"
+        "  --rt_priority P     SCHED_FIFO priority of the tty threads, 0 for normal (0)\r\n"
+        "  --json              print report as json\r\n\r\n", prog, TEST_MAX_NODES,
+        TEST_LARGE_NPDU_LEN);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"nodes", required_argument, NULL, 'n'},
+        {"baudrate", required_argument, NULL, 'b'},
+        {"tests", required_argument, NULL, 't'},
+        {"large", required_argument, NULL, 'l'},
+        {"seconds", required_argument, NULL, 's'},
+        {"rt_priority", required_argument, NULL, 'r'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'n': opt.nodes = strtoul(optarg, NULL, 0); break;
+        case 'b': opt.baudrate = strtoul(optarg, NULL, 0); break;
+        case 't': opt.tests = strtoul(optarg, NULL, 0); break;
+        case 'l': opt.large = strtoul(optarg, NULL, 0); break;
+        case 's': opt.seconds = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.rt_priority = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.nodes < 2) || (opt.nodes > TEST_MAX_NODES) || (opt.seconds == 0)
+            || (opt.rt_priority > 99)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    datalink_mstp_t *node0, *node1;
+    pthread_t bridge;
+    cJSON *report;
+    double start_tokens, rotations, avg_us, max_us, normal_wait, urgent_wait;
+    uint64_t start_ns, wait_ns;
+    uint32_t passed, delivered;
+    bool formed, ok;
+    char *str;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    (void)signal(SIGPIPE, SIG_IGN);
+    sem_init(&test_done, 0, 0);
+
+    if (open_ptys() < 0) {
+        return -EPERM;
+    }
+
+    bridging = true;
+    if (pthread_create(&bridge, NULL, bridge_func, NULL) != 0) {
+        printf("create bridge thread failed\r\n");
+        return -EPERM;
+    }
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    apdu_set_default_service_handler();
+
+    rv = el_loop_start(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop start failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    /* test results are called back from the pool */
+    rv = tp_pool_start(&tp_default_pool);
+    if (rv < 0) {
+        printf("thread pool start failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    node0 = get_port(0);
+    node1 = get_port(1);
+    if (node0 == NULL || node1 == NULL) {
+        printf("mstp ports not created\r\n");
+        rv = -EPERM;
+        goto out;
+    }
+
+    /* Tno_token plus the slots, then one round of poll for master */
+    start_ns = now_ns();
+    formed = false;
+    while (now_ns() - start_ns < 5000000000ULL) {
+        formed = ring_formed();
+        if (formed) {
+            break;
+        }
+        usleep(10000);
+    }
+    wait_ns = now_ns() - start_ns;
+
+    start_tokens = mib_number(node0, "tokenCount");
+    start_ns = now_ns();
+    sleep(opt.seconds);
+    rotations = (mib_number(node0, "tokenCount") - start_tokens) * 1e9 / (now_ns() - start_ns);
+
+    avg_us = max_us = 0;
+    passed = delivered = 0;
+    rv = formed? run_tests(node0, &avg_us, &max_us, &passed): -EPERM;
+    if (rv == OK) {
+        rv = send_large(node0, node1, &delivered);
+    }
+    normal_wait = prio_max_wait(node0, "normal");
+    urgent_wait = prio_max_wait(node0, "life_safety");
+    ok = formed && (rv == OK) && (passed == opt.tests) && (delivered == opt.large)
+        && ((rotations == 0) || (urgent_wait <= 2000 / rotations + 10));
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "nodes", opt.nodes);
+    cJSON_AddNumberToObject(report, "baudrate", opt.baudrate);
+    cJSON_AddNumberToObject(report, "ring_formed_ms", formed? wait_ns / 1e6: -1);
+    cJSON_AddNumberToObject(report, "token_rotations_per_sec", rotations);
+    cJSON_AddNumberToObject(report, "tests", opt.tests);
+    cJSON_AddNumberToObject(report, "tests_passed", passed);
+    cJSON_AddNumberToObject(report, "test_avg_us", avg_us);
+    cJSON_AddNumberToObject(report, "test_max_us", max_us);
+    cJSON_AddNumberToObject(report, "large_sent", opt.large);
+    cJSON_AddNumberToObject(report, "large_delivered", delivered);
+    cJSON_AddNumberToObject(report, "normal_max_wait_ms", normal_wait);
+    cJSON_AddNumberToObject(report, "life_safety_max_wait_ms", urgent_wait);
+    cJSON_AddItemToObject(report, "node0", node0->dl.get_port_mib(&node0->dl));
+    cJSON_AddStringToObject(report, "result", ok? "pass": "fail");
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("%-24s %s\r\n", "ring formed", formed? "yes": "no");
+        printf("%-24s %.1f ms\r\n", "ring formed after", wait_ns / 1e6);
+        printf("%-24s %.1f /s\r\n", "token rotations", rotations);
+        printf("%-24s %u/%u\r\n", "test frames passed", passed, opt.tests);
+        printf("%-24s %.1f us avg, %.1f us max\r\n", "test round trip", avg_us, max_us);
+        printf("%-24s %u/%u\r\n", "large npdus delivered", delivered, opt.large);
+        printf("%-24s %.0f ms normal, %.0f ms life safety\r\n", "max queue wait",
+            normal_wait, urgent_wait);
+        printf("%-24s %s\r\n", "result", ok? "pass": "fail");
+    }
+    cJSON_Delete(report);
+
+    rv = ok? OK: -EPERM;
+
+out:
+    fflush(stdout);
+    bridging = false;
+    (void)pthread_join(bridge, NULL);
+
+    /* the tty threads are still running, leave without bacnet_exit */
+    _exit(rv < 0? 1: 0);
+}
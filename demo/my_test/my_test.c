@@ -129,7 +129,7 @@ static void my_av_instance_delete(object_av_t *av)
     }
     
     object_detach(instance);
-    free(instance);
+    object_free(instance);
 
     return;
 }
@@ -171,13 +171,11 @@ static object_av_t *my_av_instance_create(cJSON *object, uint32_t instance, obje
 
     av = NULL;
     if (writable) {
-        av_writable = (object_av_writable_t *)malloc(sizeof(object_av_writable_t));
+        av_writable = (object_av_writable_t *)object_alloc(OBJECT_ANALOG_VALUE, sizeof(object_av_writable_t));
         if (!av_writable) {
             printf("%s: not enough memory\r\n", __func__);
             return NULL;
         }
-        
-        memset(av_writable, 0, sizeof(*av_writable));
         av = av_writable;
         av->present = 0.0;
     } else if (commandable) {
@@ -187,45 +185,41 @@ static object_av_t *my_av_instance_create(cJSON *object, uint32_t instance, obje
             return NULL;
         }
 
-        av_commandable = (object_av_commandable_t *)malloc(sizeof(object_av_commandable_t));
+        av_commandable = (object_av_commandable_t *)object_alloc(OBJECT_ANALOG_VALUE, sizeof(object_av_commandable_t));
         if (!av_commandable) {
             printf("%s: not enough memory\r\n", __func__);
             return NULL;
         }
-
-        memset(av_commandable, 0, sizeof(*av_commandable));
         av_commandable->relinquish_default = tmp->valuedouble;
         av_commandable->active_bit = BACNET_MAX_PRIORITY;
         av = &av_commandable->base;
         av->present = tmp->valuedouble;
     } else {
-        av = (object_av_t *)malloc(sizeof(object_av_t));
+        av = (object_av_t *)object_alloc(OBJECT_ANALOG_VALUE, sizeof(object_av_t));
         if (!av) {
             printf("%s: not enough memory\r\n", __func__);
             return NULL;
         }
-        
-        memset(av, 0, sizeof(*av));
         av->present = 0.0;
     }
 
     tmp = cJSON_GetObjectItem(object, "Name");
     if ((tmp == NULL) || (tmp->type != cJSON_String)) {
         printf("%s: get Name item failed\r\n", __func__);
-        free(av);
+        object_free(&av->base.base);
         return NULL;
     }
 
-    if (!vbuf_fr_str(&av->base.base.object_name.vbuf, tmp->valuestring, OBJECT_NAME_MAX_LEN)) {
+    if (!object_set_name(&av->base.base, tmp->valuestring)) {
         printf("%s: set object name overflow\r\n", __func__);
-        free(av);
+        object_free(&av->base.base);
         return NULL;
     }
 
     tmp = cJSON_GetObjectItem(object, "Out_Of_Service");
     if ((tmp == NULL) || ((tmp->type != cJSON_False) && (tmp->type != cJSON_True))) {
         printf("%s: get Out_Of_Service item failed\r\n", __func__);
-        free(av);
+        object_free(&av->base.base);
         return NULL;
     }
     av->base.Out_Of_Service = (tmp->type == cJSON_True)? true: false;
@@ -233,7 +227,7 @@ static object_av_t *my_av_instance_create(cJSON *object, uint32_t instance, obje
     tmp = cJSON_GetObjectItem(object, "Units");
     if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
         printf("%s: get Units item failed\r\n", __func__);
-        free(av);
+        object_free(&av->base.base);
         return NULL;
     }
     av->units = (BACNET_ENGINEERING_UNITS)(uint32_t)tmp->valueint;
@@ -243,7 +237,7 @@ static object_av_t *my_av_instance_create(cJSON *object, uint32_t instance, obje
 
     if (!object_add(&av->base.base)) {
         printf("%s: object add failed\r\n", __func__);
-        free(av);
+        object_free(&av->base.base);
         return NULL;
     }
 
@@ -693,6 +687,7 @@ static int my_object_list_init(void)
     av_type = NULL;
     
     RWLOCK_WRLOCK(&my_object_list.rwlock);
+    object_batch_begin();
 
     i = 0;
     cJSON_ArrayForEach(object, object_list) {
@@ -814,11 +809,15 @@ static int my_object_list_init(void)
         i++;
     }
 
+    if (!object_batch_end()) {
+        printf("%s: publish objects failed\r\n", __func__);
+    }
     RWLOCK_UNLOCK(&my_object_list.rwlock);
     
     return OK;
 
 out3:
+    (void)object_batch_end();
     RWLOCK_UNLOCK(&my_object_list.rwlock);
 
 out2:
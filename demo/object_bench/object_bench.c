@@ -0,0 +1,840 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * object_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Startup benchmark of the object database. Generates an app config with
+ * --objects objects spread over AI/AO/AV/BI/BO/BV, then reports the time of
+ * parsing it, of object_init phase by phase, and of object name lookup.
+ * With --threads N it also measures ReadProperty throughput of 1, 2, 4 ... N
+ * concurrent reader threads while one writer keeps writing AV values.
+ * With --sweeps N it reads every property of every object (what an RPM
+ * PROP_ALL sweep of a supervisor does) N times. With --renames one thread keeps renaming AV 0 and the Device
+ * while another reads them, both have to make progress. With --image FILE the
+ * parsed config is saved as a binary image to FILE and object_init runs on the
+ * tree loaded back from it, which is what app_startup does with app.conf.img.
+ *
+ *   ./object_bench --objects 60000 --threads 8 --json
+ *   ./object_bench --objects 10000 --sweeps 20
+ *   ./object_bench --objects 600 --renames
+ *
+ * History
+ */
+
+#define _GNU_SOURCE                         /* pthread_timedjoin_np */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/app.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/service/rp.h"
+#include "bacnet/service/wp.h"
+#include "bacnet/service/rpm.h"
+#include "bacnet/object/object.h"
+#include "misc/cJSON.h"
+#include "misc/utils.h"
+#include "debug.h"
+
+#define LOOKUP_NAMES                (4096)
+#define LOOKUP_ROUNDS               (1000000)
+#define READ_BENCH_MS               (1000)
+#define READ_BATCH                  (256)
+#define MAX_THREADS                 (64)
+#define RENAME_JOIN_MS              (3000)
+
+static const char *bench_types[] = {
+    "AI",
+    "AO",
+    "AV",
+    "BI",
+    "BO",
+    "BV",
+};
+
+#define BENCH_IMAGE_MAGIC           (0x42424931)    /* "BBI1" */
+
+#define BENCH_TYPE_COUNT            (sizeof(bench_types) / sizeof(bench_types[0]))
+
+static struct {
+    uint32_t objects;
+    uint32_t threads;
+    uint32_t sweeps;
+    bool renames;
+    const char *image;
+    bool json;
+} opt = {
+    .objects = 60000,
+};
+
+typedef struct reader_s {
+    pthread_t thread;
+    uint32_t seed;
+    uint64_t reads;
+    uint64_t failed;
+} reader_t;
+
+static volatile bool bench_stop;
+
+typedef struct text_buf_s {
+    char *data;
+    size_t len;
+    size_t size;
+} text_buf_t;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static int text_printf(text_buf_t *buf, const char *fmt, ...)
+{
+    va_list ap;
+    char *data;
+    int len;
+
+    for (;;) {
+        va_start(ap, fmt);
+        len = vsnprintf(buf->data + buf->len, buf->size - buf->len, fmt, ap);
+        va_end(ap);
+        if (len < 0) {
+            return -EINVAL;
+        }
+        if (buf->len + len < buf->size) {
+            buf->len += len;
+            return OK;
+        }
+
+        data = (char *)realloc(buf->data, buf->size * 2);
+        if (data == NULL) {
+            return -ENOMEM;
+        }
+        buf->data = data;
+        buf->size *= 2;
+    }
+}
+
+/* app.conf text as written by hand: one Object_List entry per type */
+static char *make_app_cfg(uint32_t objects)
+{
+    text_buf_t buf;
+    uint32_t per_type, i, t;
+    int rv;
+
+    buf.size = 4096;
+    buf.len = 0;
+    buf.data = (char *)malloc(buf.size);
+    if (buf.data == NULL) {
+        return NULL;
+    }
+
+    per_type = objects / BENCH_TYPE_COUNT;
+    rv = text_printf(&buf, "{\n\t\"Device_Id\": 1,\n\t\"Device_Name\": \"object_bench\",\n"
+        "\t\"Object_List\": [");
+    for (t = 0; (t < BENCH_TYPE_COUNT) && (rv == OK); t++) {
+        rv = text_printf(&buf, "%s{\n\t\t\"Type\": \"%s\",\n\t\t\"Instance_List\": [",
+            t? ", ": "", bench_types[t]);
+        for (i = 0; (i < per_type) && (rv == OK); i++) {
+            rv = text_printf(&buf, "%s{\n\t\t\t\"Name\": \"%s_%u\",\n"
+                "\t\t\t\"Out_Of_Service\": false", i? ", ": "", bench_types[t], i);
+            if ((rv == OK) && (t < 3)) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Units\": 62");
+            } else if (rv == OK) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Active_Text\": \"on\","
+                    "\n\t\t\t\"Inactive_Text\": \"off\",\n\t\t\t\"Polarity\": 0");
+            }
+            if ((rv == OK) && (t == 2)) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Writable\": true");
+            }
+            if ((rv == OK) && ((t == 1) || (t == 2) || (t == 4))) {
+                rv = text_printf(&buf, ",\n\t\t\t\"Relinquish_Default\": 0");
+            }
+            if (rv == OK) {
+                rv = text_printf(&buf, "\n\t\t}");
+            }
+        }
+        if (rv == OK) {
+            rv = text_printf(&buf, "]\n\t}");
+        }
+    }
+    if (rv == OK) {
+        rv = text_printf(&buf, "]\n}\n");
+    }
+
+    if (rv < 0) {
+        free(buf.data);
+        return NULL;
+    }
+
+    return buf.data;
+}
+
+/* average ns of object_find_name over names spread across all types */
+static double bench_lookup(uint32_t objects, uint32_t *missed)
+{
+    static char names[LOOKUP_NAMES][OBJECT_NAME_MAX_LEN + 1];
+    BACNET_CHARACTER_STRING name[LOOKUP_NAMES];
+    BACNET_OBJECT_TYPE type;
+    uint32_t per_type, instance, i;
+    uint64_t begin;
+
+    per_type = objects / BENCH_TYPE_COUNT;
+    for (i = 0; i < LOOKUP_NAMES; i++) {
+        (void)snprintf(names[i], sizeof(names[i]), "%s_%u", bench_types[i % BENCH_TYPE_COUNT],
+            (i * 7919) % per_type);
+        (void)characterstring_init_ansi(&name[i], names[i], strlen(names[i]));
+    }
+
+    *missed = 0;
+    begin = now_us();
+    for (i = 0; i < LOOKUP_ROUNDS; i++) {
+        if (!object_find_name(&name[i % LOOKUP_NAMES], &type, &instance)) {
+            (*missed)++;
+        }
+    }
+
+    return (double)(now_us() - begin) * 1000 / LOOKUP_ROUNDS;
+}
+
+static int sweep_list(BACNET_OBJECT_TYPE type, uint32_t instance, const property_list_t *list,
+                uint8_t *buf, uint32_t *properties)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    uint16_t i;
+
+    for (i = 0; i < list->count; i++) {
+        memset(&rp_data, 0, sizeof(rp_data));
+        rp_data.object_type = type;
+        rp_data.object_instance = instance;
+        rp_data.property_id = list->pList[i];
+        rp_data.array_index = BACNET_ARRAY_ALL;
+        rp_data.application_data = buf;
+        rp_data.application_data_len = MAX_APDU;
+        if (object_read_property(&rp_data, NULL) < 0) {
+            return -EPERM;
+        }
+        (*properties)++;
+    }
+
+    return OK;
+}
+
+/* average ms of one PROP_ALL sweep over all objects */
+static double bench_sweep(uint32_t sweeps, uint32_t *properties, uint32_t *failed)
+{
+    special_property_list_t lists;
+    object_store_t *store;
+    object_instance_t *object;
+    uint8_t buf[MAX_APDU];
+    uint64_t begin;
+    uint32_t n;
+    bool found;
+
+    *failed = 0;
+    begin = now_us();
+    for (n = 0; n < sweeps; n++) {
+        *properties = 0;
+        for (found = object_find_index(0, &store, &object); found;
+                found = object_find_next(&store, &object)) {
+            /* Device properties such as the address bindings need the network layer */
+            if (object->type->type == OBJECT_DEVICE) {
+                continue;
+            }
+            if (!object_property_lists(object->type->type, object->instance, &lists)
+                    || (sweep_list(object->type->type, object->instance, &lists.Required, buf,
+                        properties) < 0)
+                    || (sweep_list(object->type->type, object->instance, &lists.Optional, buf,
+                        properties) < 0)
+                    || (sweep_list(object->type->type, object->instance, &lists.Proprietary, buf,
+                        properties) < 0)) {
+                (*failed)++;
+            }
+        }
+    }
+
+    return (double)(now_us() - begin) / 1000 / sweeps;
+}
+
+/* random PRESENT_VALUE reads of AI/AO/AV objects */
+static void *reader_thread(void *arg)
+{
+    reader_t *reader;
+    BACNET_READ_PROPERTY_DATA rp_data;
+    uint8_t buf[MAX_APDU];
+    uint32_t per_type, i;
+
+    reader = (reader_t *)arg;
+    per_type = opt.objects / BENCH_TYPE_COUNT;
+
+    while (!bench_stop) {
+        for (i = 0; i < READ_BATCH; i++) {
+            reader->seed = reader->seed * 1103515245 + 12345;
+            memset(&rp_data, 0, sizeof(rp_data));
+            rp_data.object_type = (reader->seed >> 8) % 3 == 0? OBJECT_ANALOG_INPUT:
+                (reader->seed >> 8) % 3 == 1? OBJECT_ANALOG_OUTPUT: OBJECT_ANALOG_VALUE;
+            rp_data.object_instance = (reader->seed >> 12) % per_type;
+            rp_data.property_id = PROP_PRESENT_VALUE;
+            rp_data.array_index = BACNET_ARRAY_ALL;
+            rp_data.application_data = buf;
+            rp_data.application_data_len = sizeof(buf);
+            if (object_read_property(&rp_data, NULL) <= 0) {
+                reader->failed++;
+            }
+        }
+        reader->reads += READ_BATCH;
+    }
+
+    return NULL;
+}
+
+static void *writer_thread(void *arg)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data;
+    uint8_t buf[16];
+    uint64_t *writes;
+    uint32_t per_type, i;
+
+    writes = (uint64_t *)arg;
+    per_type = opt.objects / BENCH_TYPE_COUNT;
+
+    for (i = 0; !bench_stop; i++) {
+        memset(&wp_data, 0, sizeof(wp_data));
+        wp_data.object_type = OBJECT_ANALOG_VALUE;
+        wp_data.object_instance = (i * 7919) % per_type;
+        wp_data.property_id = PROP_PRESENT_VALUE;
+        wp_data.array_index = BACNET_ARRAY_ALL;
+        wp_data.priority = BACNET_MAX_PRIORITY;
+        wp_data.application_data = buf;
+        wp_data.application_data_len = encode_application_real(buf, (float)(i % 1000));
+        if (object_write_property(&wp_data) >= 0) {
+            (*writes)++;
+        }
+    }
+
+    return NULL;
+}
+
+/* Present_Value of AV 0 and Object_Name of the Device, the one read without and the other with the object lock */
+static void *rename_reader_thread(void *arg)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    uint8_t buf[MAX_APDU];
+    uint64_t *reads;
+
+    reads = (uint64_t *)arg;
+
+    while (!bench_stop) {
+        memset(&rp_data, 0, sizeof(rp_data));
+        if (*reads & 1) {
+            rp_data.object_type = OBJECT_DEVICE;
+            rp_data.object_instance = 1;
+            rp_data.property_id = PROP_OBJECT_NAME;
+        } else {
+            rp_data.object_type = OBJECT_ANALOG_VALUE;
+            rp_data.object_instance = 0;
+            rp_data.property_id = PROP_PRESENT_VALUE;
+        }
+        rp_data.array_index = BACNET_ARRAY_ALL;
+        rp_data.application_data = buf;
+        rp_data.application_data_len = sizeof(buf);
+        if (object_read_property(&rp_data, NULL) <= 0) {
+            break;
+        }
+        (*reads)++;
+    }
+
+    return NULL;
+}
+
+static void *renamer_thread(void *arg)
+{
+    BACNET_CHARACTER_STRING name;
+    object_instance_t *objects[2];
+    uint64_t *renames;
+    char str[OBJECT_NAME_MAX_LEN + 1];
+    uint32_t i;
+
+    renames = (uint64_t *)arg;
+    objects[0] = object_find(OBJECT_ANALOG_VALUE, 0);
+    objects[1] = object_find(OBJECT_DEVICE, 1);
+    if ((objects[0] == NULL) || (objects[1] == NULL)) {
+        return NULL;
+    }
+
+    /* AV 0 away and back, then the Device; stops with both names back */
+    for (i = 0; !bench_stop || (i & 3); i++) {
+        (void)snprintf(str, sizeof(str), "%s%s", (i & 2)? "object_bench": "AV_0",
+            (i & 1)? "": "_renamed");
+        (void)characterstring_init_ansi(&name, str, strlen(str));
+        if (object_rename(objects[(i >> 1) & 1], &name) != MAX_BACNET_ERROR_CODE) {
+            break;
+        }
+        (*renames)++;
+    }
+
+    return NULL;
+}
+
+static int join_timeout(pthread_t thread, uint32_t ms)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    return pthread_timedjoin_np(thread, NULL, &ts);
+}
+
+/*
+ * renames/s and reads/s of one renamer and one reader of the renamed objects.
+ * -ETIMEDOUT when they are stuck on each other, the threads are then left behind
+ */
+static int bench_renames(cJSON *result)
+{
+    pthread_t reader, renamer;
+    struct timespec ts;
+    uint64_t begin, elapsed, reads, renames;
+
+    bench_stop = false;
+    reads = 0;
+    renames = 0;
+
+    begin = now_us();
+    if (pthread_create(&reader, NULL, rename_reader_thread, &reads) != 0) {
+        printf("create reader thread failed\r\n");
+        return -EPERM;
+    }
+    if (pthread_create(&renamer, NULL, renamer_thread, &renames) != 0) {
+        printf("create renamer thread failed\r\n");
+        bench_stop = true;
+        (void)pthread_join(reader, NULL);
+        return -EPERM;
+    }
+
+    ts.tv_sec = READ_BENCH_MS / 1000;
+    ts.tv_nsec = (READ_BENCH_MS % 1000) * 1000000L;
+    (void)nanosleep(&ts, NULL);
+    bench_stop = true;
+
+    if ((join_timeout(renamer, RENAME_JOIN_MS) != 0)
+            || (join_timeout(reader, RENAME_JOIN_MS) != 0)) {
+        printf("renamer and reader deadlocked, %llu renames %llu reads\r\n",
+            (unsigned long long)renames, (unsigned long long)reads);
+        return -ETIMEDOUT;
+    }
+    elapsed = now_us() - begin;
+
+    cJSON_AddNumberToObject(result, "reads_per_sec", reads * 1000000.0 / elapsed);
+    cJSON_AddNumberToObject(result, "renames_per_sec", renames * 1000000.0 / elapsed);
+
+    return (reads && renames && !(renames & 3))? OK: -EPERM;
+}
+
+/*
+ * save cfg to opt.image and load it back, the loaded tree must print the same
+ * as cfg and an image of another key must not load
+ * @return tree to be freed by free_json_image, NULL if fail
+ */
+static cJSON *bench_image(cJSON *cfg, uint64_t key, cJSON *result)
+{
+    cJSON *image, *stale;
+    uint64_t begin, save_us, load_us;
+    char *expect, *got;
+    int rv;
+
+    begin = now_us();
+    rv = save_json_image(opt.image, BENCH_IMAGE_MAGIC, cfg, key);
+    save_us = now_us() - begin;
+    if (rv < 0) {
+        printf("save image %s failed(%d)\r\n", opt.image, rv);
+        return NULL;
+    }
+
+    stale = load_json_image(opt.image, BENCH_IMAGE_MAGIC, key + 1);
+    if (stale != NULL) {
+        printf("image of another config loaded\r\n");
+        free_json_image(stale);
+        return NULL;
+    }
+
+    begin = now_us();
+    image = load_json_image(opt.image, BENCH_IMAGE_MAGIC, key);
+    load_us = now_us() - begin;
+    if (image == NULL) {
+        printf("load image %s failed\r\n", opt.image);
+        return NULL;
+    }
+
+    expect = cJSON_PrintUnformatted(cfg);
+    got = cJSON_PrintUnformatted(image);
+    rv = (expect && got && !strcmp(expect, got))? OK: -EPERM;
+    free(got);
+    free(expect);
+    if (rv < 0) {
+        printf("image differs from config\r\n");
+        free_json_image(image);
+        return NULL;
+    }
+
+    cJSON_AddNumberToObject(result, "save_ms", save_us / 1000.0);
+    cJSON_AddNumberToObject(result, "load_ms", load_us / 1000.0);
+
+    return image;
+}
+
+/* 1, 2, 4 ... and finally opt.threads itself */
+static uint32_t next_threads(uint32_t n)
+{
+    if ((n < opt.threads) && (n * 2 > opt.threads)) {
+        return opt.threads;
+    }
+
+    return n * 2;
+}
+
+/* reads/s of n concurrent readers */
+static int bench_readers(uint32_t n, cJSON *result)
+{
+    static reader_t readers[MAX_THREADS];
+    pthread_t writer;
+    struct timespec ts;
+    uint64_t begin, elapsed, reads, failed, writes;
+    uint32_t i;
+    int rv;
+
+    memset(readers, 0, sizeof(readers));
+    bench_stop = false;
+    writes = 0;
+    rv = OK;
+
+    begin = now_us();
+    for (i = 0; i < n; i++) {
+        readers[i].seed = i * 2654435761U + 1;
+        if (pthread_create(&readers[i].thread, NULL, reader_thread, &readers[i]) != 0) {
+            printf("create reader thread failed\r\n");
+            bench_stop = true;
+            n = i;
+            rv = -EPERM;
+            goto out;
+        }
+    }
+    if (pthread_create(&writer, NULL, writer_thread, &writes) != 0) {
+        printf("create writer thread failed\r\n");
+        bench_stop = true;
+        rv = -EPERM;
+        goto out;
+    }
+
+    ts.tv_sec = READ_BENCH_MS / 1000;
+    ts.tv_nsec = (READ_BENCH_MS % 1000) * 1000000L;
+    (void)nanosleep(&ts, NULL);
+    bench_stop = true;
+
+    (void)pthread_join(writer, NULL);
+
+out:
+    for (i = 0; i < n; i++) {
+        (void)pthread_join(readers[i].thread, NULL);
+    }
+    elapsed = now_us() - begin;
+    if (rv < 0) {
+        return rv;
+    }
+
+    reads = 0;
+    failed = 0;
+    for (i = 0; i < n; i++) {
+        reads += readers[i].reads;
+        failed += readers[i].failed;
+    }
+
+    cJSON_AddNumberToObject(result, "threads", n);
+    cJSON_AddNumberToObject(result, "reads_per_sec", reads * 1000000.0 / elapsed);
+    cJSON_AddNumberToObject(result, "reads_per_sec_per_thread", reads * 1000000.0 / elapsed / n);
+    cJSON_AddNumberToObject(result, "writes_per_sec", writes * 1000000.0 / elapsed);
+    cJSON_AddNumberToObject(result, "failed", failed);
+
+    return failed? -EPERM: OK;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --objects N         objects in the generated config (60000)\r\n"
+        "  --threads N         concurrent read bench with up to N readers (0, off)\r\n"
+        "  --sweeps N          PROP_ALL sweeps over all objects (0, off)\r\n"
+        "  --renames           rename AV 0 and the Device while reading them\r\n"
+        "  --image FILE        save config image to FILE and init from it\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"objects", required_argument, NULL, 'n'},
+        {"threads", required_argument, NULL, 't'},
+        {"sweeps", required_argument, NULL, 's'},
+        {"renames", no_argument, NULL, 'r'},
+        {"image", required_argument, NULL, 'i'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'n': opt.objects = strtoul(optarg, NULL, 0); break;
+        case 't': opt.threads = strtoul(optarg, NULL, 0); break;
+        case 's': opt.sweeps = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.renames = true; break;
+        case 'i': opt.image = optarg; break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.objects < BENCH_TYPE_COUNT) || (opt.objects > 4000000)
+            || (opt.threads > MAX_THREADS)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *cfg, *report, *status, *memory, *scaling, *sweep, *rename, *image, *item;
+    uint64_t begin, hash_us, parse_us, init_us, exit_us, key;
+    uint32_t count, missed, n, properties, failed;
+    double lookup_ns, sweep_ms;
+    char *text, *str;
+    size_t text_len;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    app_set_dbg_level(DEBUG_LEVEL_WARN | DEBUG_LEVEL_ERROR);
+
+    text = make_app_cfg(opt.objects);
+    if (text == NULL) {
+        printf("make app cfg failed\r\n");
+        return -ENOMEM;
+    }
+    text_len = strlen(text);
+
+    begin = now_us();
+    key = data_hash64(text, text_len);
+    hash_us = now_us() - begin;
+
+    begin = now_us();
+    cfg = cJSON_Parse(text);
+    parse_us = now_us() - begin;
+    free(text);
+    if (cfg == NULL) {
+        printf("parse app cfg failed\r\n");
+        return -EPERM;
+    }
+
+    image = NULL;
+    if (opt.image) {
+        image = cJSON_CreateObject();
+        item = image? bench_image(cfg, key, image): NULL;
+        cJSON_Delete(cfg);
+        if (item == NULL) {
+            cJSON_Delete(image);
+            return -EPERM;
+        }
+        cfg = item;
+    }
+
+    begin = now_us();
+    rv = object_init(cfg);
+    init_us = now_us() - begin;
+    if (image) {
+        free_json_image(cfg);
+    } else {
+        cJSON_Delete(cfg);
+    }
+    if (rv < 0) {
+        printf("object init failed(%d)\r\n", rv);
+        cJSON_Delete(image);
+        return rv;
+    }
+
+    count = object_list_count();
+    lookup_ns = bench_lookup(opt.objects, &missed);
+    status = object_get_init_status();
+    memory = object_get_memory_status();
+
+    sweep = NULL;
+    if (opt.sweeps) {
+        sweep_ms = bench_sweep(opt.sweeps, &properties, &failed);
+        missed += failed;
+
+        sweep = cJSON_CreateObject();
+        if (sweep) {
+            cJSON_AddNumberToObject(sweep, "sweeps", opt.sweeps);
+            cJSON_AddNumberToObject(sweep, "properties", properties);
+            cJSON_AddNumberToObject(sweep, "sweep_ms", sweep_ms);
+            cJSON_AddNumberToObject(sweep, "failed", missed);
+        }
+    }
+
+    scaling = NULL;
+    if (opt.threads) {
+        scaling = cJSON_CreateArray();
+        for (n = 1; scaling && (n <= opt.threads); n = next_threads(n)) {
+            item = cJSON_CreateObject();
+            if (item == NULL) {
+                break;
+            }
+            cJSON_AddItemToArray(scaling, item);
+            if (bench_readers(n, item) < 0) {
+                missed++;
+            }
+        }
+    }
+
+    rename = NULL;
+    if (opt.renames) {
+        rename = cJSON_CreateObject();
+        rv = rename? bench_renames(rename): -ENOMEM;
+        if (rv == -ETIMEDOUT) {
+            cJSON_Delete(rename);
+            cJSON_Delete(scaling);
+            cJSON_Delete(sweep);
+            cJSON_Delete(image);
+            cJSON_Delete(memory);
+            cJSON_Delete(status);
+            return rv;
+        }
+        if (rv < 0) {
+            missed++;
+        }
+    }
+
+    begin = now_us();
+    object_exit();
+    exit_us = now_us() - begin;
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "objects", count);
+    cJSON_AddNumberToObject(report, "cfg_bytes", text_len);
+    cJSON_AddNumberToObject(report, "hash_ms", hash_us / 1000.0);
+    cJSON_AddNumberToObject(report, "parse_ms", parse_us / 1000.0);
+    cJSON_AddNumberToObject(report, "init_ms", init_us / 1000.0);
+    cJSON_AddNumberToObject(report, "exit_ms", exit_us / 1000.0);
+    cJSON_AddNumberToObject(report, "lookup_ns", lookup_ns);
+    cJSON_AddNumberToObject(report, "lookup_missed", missed);
+    if (image) {
+        cJSON_AddItemToObject(report, "config_image", image);
+    }
+    if (status) {
+        cJSON_AddItemToObject(report, "init_phases", status);
+    }
+    if (memory) {
+        cJSON_AddItemToObject(report, "memory", memory);
+    }
+    if (sweep) {
+        cJSON_AddItemToObject(report, "prop_all_sweep", sweep);
+    }
+    if (scaling) {
+        cJSON_AddItemToObject(report, "read_scaling", scaling);
+    }
+    if (rename) {
+        cJSON_AddItemToObject(report, "rename_race", rename);
+    }
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("objects %u, config %u bytes\r\n", count, (uint32_t)text_len);
+        printf("hash   %10.1f ms\r\n", hash_us / 1000.0);
+        printf("parse  %10.1f ms\r\n", parse_us / 1000.0);
+        if (image) {
+            printf("image  %10.1f ms, saved in %.1f ms\r\n",
+                cJSON_GetObjectItem(image, "load_ms")->valuedouble,
+                cJSON_GetObjectItem(image, "save_ms")->valuedouble);
+        }
+        printf("init   %10.1f ms\r\n", init_us / 1000.0);
+        printf("exit   %10.1f ms\r\n", exit_us / 1000.0);
+        printf("lookup %10.1f ns (%u missed)\r\n", lookup_ns, missed);
+        if (memory && count) {
+            printf("memory %10.1f bytes/object\r\n",
+                cJSON_GetObjectItem(memory, "total_bytes")->valuedouble / count);
+        }
+        str = status? cJSON_Print(status): NULL;
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+        if (sweep) {
+            printf("sweep  %10.1f ms, %d properties\r\n",
+                cJSON_GetObjectItem(sweep, "sweep_ms")->valuedouble,
+                cJSON_GetObjectItem(sweep, "properties")->valueint);
+        }
+        for (item = scaling? scaling->child: NULL; item; item = item->next) {
+            printf("readers %2d %12.0f reads/s %12.0f per thread %10.0f writes/s\r\n",
+                cJSON_GetObjectItem(item, "threads")->valueint,
+                cJSON_GetObjectItem(item, "reads_per_sec")->valuedouble,
+                cJSON_GetObjectItem(item, "reads_per_sec_per_thread")->valuedouble,
+                cJSON_GetObjectItem(item, "writes_per_sec")->valuedouble);
+        }
+        if (rename && rename->child) {
+            printf("rename %10.0f renames/s %12.0f reads/s\r\n",
+                cJSON_GetObjectItem(rename, "renames_per_sec")->valuedouble,
+                cJSON_GetObjectItem(rename, "reads_per_sec")->valuedouble);
+        }
+    }
+
+    cJSON_Delete(report);
+
+    return missed? -EPERM: OK;
+}
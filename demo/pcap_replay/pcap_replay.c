@@ -0,0 +1,324 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * pcap_replay.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Replay captured site traffic into the stack through pcap ports, report
+ * per-stage processing time when every port is done.
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/apdu.h"
+#include "bacnet/pcapdl.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "misc/utils.h"
+
+#define REPLAY_MAX_PORTS            (16)
+
+typedef struct replay_port_s {
+    uint16_t net;
+    char *input;
+    char *output;
+} replay_port_t;
+
+static replay_port_t ports[REPLAY_MAX_PORTS];
+static uint32_t port_nums;
+
+static const char *app_file;
+static const char *format = "bip";
+static const char *address;
+static double speed = 1.0;
+static uint32_t loops = 1;
+static bool json_report;
+
+static volatile bool stopped;
+
+static void sig_handler(int sig)
+{
+    stopped = true;
+}
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+    char name[16];
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    for (i = 0; i < port_nums; i++) {
+        res = cJSON_CreateObject();
+        cJSON_AddStringToObject(res, "type", "PCAP");
+        cJSON_AddStringToObject(res, "ifname", ports[i].input);
+        snprintf(name, sizeof(name), "pcap%u", i);
+        cJSON_AddItemToObject(cfg, name, res);
+    }
+
+    return cfg;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *array, *port;
+    char name[16];
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "route_table", cJSON_CreateArray());
+
+    array = cJSON_CreateArray();
+    for (i = 0; i < port_nums; i++) {
+        port = cJSON_CreateObject();
+        snprintf(name, sizeof(name), "pcap%u", i);
+        cJSON_AddTrueToObject(port, "enable");
+        cJSON_AddNumberToObject(port, "net_num", ports[i].net);
+        cJSON_AddStringToObject(port, "dl_type", "PCAP");
+        cJSON_AddStringToObject(port, "resource_name", name);
+        cJSON_AddStringToObject(port, "format", format);
+        cJSON_AddNumberToObject(port, "speed", speed);
+        cJSON_AddNumberToObject(port, "loop", loops);
+        if (address) {
+            cJSON_AddStringToObject(port, "address", address);
+        }
+        if (ports[i].output) {
+            cJSON_AddStringToObject(port, "output", ports[i].output);
+        }
+        cJSON_AddItemToArray(array, port);
+    }
+    cJSON_AddItemToObject(cfg, "port", array);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg;
+
+    if (app_file) {
+        cfg = load_json_file(app_file);
+    } else {
+        cfg = load_json_file(BACNET_APP_CONFIG_FILE);
+        if (cfg == NULL) {
+            cfg = load_json_file("/etc/"BACNET_APP_CONFIG_FILE);
+        }
+    }
+
+    if (cfg == NULL) {
+        printf("load app config failed\r\n");
+        return NULL;
+    }
+
+    if (cfg->type != cJSON_Object) {
+        printf("invalid app config\r\n");
+        cJSON_Delete(cfg);
+        return NULL;
+    }
+
+    return cfg;
+}
+
+static void print_stage(const char *name, cJSON *stage)
+{
+    printf("  %-12s %10.0f %10.0f %10.0f %10.0f %10.0f %12.0f\r\n", name,
+        cJSON_GetObjectItem(stage, "count")->valuedouble,
+        cJSON_GetObjectItem(stage, "avg_ns")->valuedouble,
+        cJSON_GetObjectItem(stage, "p50_ns")->valuedouble,
+        cJSON_GetObjectItem(stage, "p99_ns")->valuedouble,
+        cJSON_GetObjectItem(stage, "p999_ns")->valuedouble,
+        cJSON_GetObjectItem(stage, "max_ns")->valuedouble);
+}
+
+static void print_report(cJSON *status)
+{
+    cJSON *result, *port, *stage;
+    double elapsed;
+    char *str;
+
+    if (json_report) {
+        str = cJSON_Print(status);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+        return;
+    }
+
+    result = cJSON_GetObjectItem(status, "result");
+    cJSON_ArrayForEach(port, result) {
+        elapsed = cJSON_GetObjectItem(port, "elapsed_ns")->valuedouble / 1e9;
+        printf("\r\nport %d: %s\r\n", cJSON_GetObjectItem(port, "port_id")->valueint,
+            cJSON_GetObjectItem(port, "input")->valuestring);
+        printf("  frames %d, loop %d/%d, injected %d, skipped %d, tx %d, elapsed %.3fs, "
+            "%.0f frames/s\r\n",
+            cJSON_GetObjectItem(port, "frames")->valueint,
+            cJSON_GetObjectItem(port, "loop_done")->valueint,
+            cJSON_GetObjectItem(port, "loop")->valueint,
+            cJSON_GetObjectItem(port, "injected")->valueint,
+            cJSON_GetObjectItem(port, "skipped")->valueint,
+            cJSON_GetObjectItem(port, "tx_ok")->valueint, elapsed,
+            elapsed > 0? cJSON_GetObjectItem(port, "injected")->valuedouble / elapsed: 0);
+        printf("  %-12s %10s %10s %10s %10s %10s %12s\r\n", "stage(ns)", "count", "avg", "p50",
+            "p99", "p99.9", "max");
+        cJSON_ArrayForEach(stage, cJSON_GetObjectItem(port, "stages")) {
+            print_stage(stage->string, stage);
+        }
+    }
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s --port NET:INPUT[:OUTPUT] [--port ...] [options]\r\n"
+        "  --port NET:INPUT[:OUTPUT]   replay INPUT pcap on network NET, write tx to OUTPUT\r\n"
+        "  --format bip|ethernet       frame format of output and own address (bip)\r\n"
+        "  --address ADDR              own ip[:port] or mac, captured frames from it are skipped\r\n"
+        "  --speed X                   replay speed, 0 for as fast as possible (1)\r\n"
+        "  --loop N                    replay times (1)\r\n"
+        "  --app FILE                  app config, default %s\r\n"
+        "  --json                      print report as json\r\n\r\n", prog, BACNET_APP_CONFIG_FILE);
+}
+
+static int parse_port(char *arg)
+{
+    replay_port_t *port;
+    char *input, *output, *end;
+    unsigned long net;
+
+    if (port_nums >= REPLAY_MAX_PORTS) {
+        printf("too many ports\r\n");
+        return -EINVAL;
+    }
+
+    input = strchr(arg, ':');
+    if (input == NULL) {
+        return -EINVAL;
+    }
+    *input++ = 0;
+
+    net = strtoul(arg, &end, 0);
+    if ((*end) || (net == 0) || (net >= BACNET_BROADCAST_NETWORK)) {
+        return -EINVAL;
+    }
+
+    output = strchr(input, ':');
+    if (output) {
+        *output++ = 0;
+    }
+
+    port = &ports[port_nums++];
+    port->net = net;
+    port->input = input;
+    port->output = output;
+
+    return OK;
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"port", required_argument, NULL, 'p'},
+        {"format", required_argument, NULL, 'f'},
+        {"address", required_argument, NULL, 'a'},
+        {"speed", required_argument, NULL, 's'},
+        {"loop", required_argument, NULL, 'l'},
+        {"app", required_argument, NULL, 'c'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'p':
+            if (parse_port(optarg) < 0) {
+                printf("invalid port: %s\r\n", optarg);
+                return -EINVAL;
+            }
+            break;
+
+        case 'f': format = optarg; break;
+        case 'a': address = optarg; break;
+        case 's': speed = strtod(optarg, NULL); break;
+        case 'l': loops = strtoul(optarg, NULL, 0); break;
+        case 'c': app_file = optarg; break;
+        case 'j': json_report = true; break;
+
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((port_nums == 0) || (speed < 0) || (loops == 0)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+/* ./pcap_replay --port 1:site.pcap:out.pcap --speed 0 --loop 10 */
+int main(int argc, char *argv[])
+{
+    cJSON *status;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    apdu_set_default_service_handler();
+
+    (void)signal(SIGINT, sig_handler);
+    (void)signal(SIGTERM, sig_handler);
+
+    rv = el_loop_start(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop start failed(%d)\r\n", rv);
+        goto out;
+    }
+
+    while (!stopped) {
+        el_sync(&el_default_loop);
+        stopped = pcapdl_replay_done();
+        el_unsync(&el_default_loop);
+        if (!stopped) {
+            usleep(100000);
+        }
+    }
+
+    el_sync(&el_default_loop);
+    status = pcapdl_get_status(NULL);
+    el_unsync(&el_default_loop);
+
+    if (status) {
+        print_report(status);
+        cJSON_Delete(status);
+    }
+
+out:
+    bacnet_exit();
+
+    return rv;
+}
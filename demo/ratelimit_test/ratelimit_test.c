@@ -0,0 +1,293 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * ratelimit_test.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Storm test of the inbound unconfirmed service rate limit. Each phase floods
+ * the limiter for --duration ms and checks the admitted count against the
+ * token bucket bound: one source in a loop, a sweep of --sources sources,
+ * and identical Who-Is collapsed to one I-Am per window.
+ *
+ *   ./ratelimit_test --duration 2000 --sources 1000
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/app.h"
+#include "bacnet/ratelimit.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "debug.h"
+
+#define TEST_GLOBAL_RATE            (200)
+#define TEST_GLOBAL_BURST           (400)
+#define TEST_SOURCE_RATE            (20)
+#define TEST_SOURCE_BURST           (40)
+#define TEST_WHOIS_WINDOW           (500)
+#define TEST_MAX_SOURCE             (256)
+
+/* CLOCK_MONOTONIC_COARSE ticks late by up to a few ms */
+#define TEST_CLOCK_SLACK            (10)
+
+static struct {
+    uint32_t duration;
+    uint32_t sources;
+    bool json;
+} opt = {
+    .duration = 2000,
+    .sources = 1000,
+};
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void make_source(bacnet_addr_t *src, uint32_t idx)
+{
+    src->net = 0;
+    src->len = 6;
+    src->adr[0] = 127;
+    src->adr[1] = 1;
+    src->adr[2] = (idx >> 8) & 0xFF;
+    src->adr[3] = idx & 0xFF;
+    src->adr[4] = 0xBA;
+    src->adr[5] = 0xC0;
+}
+
+/* flood for opt.duration ms, return admitted count */
+static uint32_t flood(uint32_t sources, uint64_t *checks, uint32_t *elapsed)
+{
+    bacnet_addr_t src;
+    uint32_t start, passed, idx;
+    uint64_t n;
+
+    passed = 0;
+    n = 0;
+    idx = 0;
+    start = el_current_millisecond();
+    do {
+        make_source(&src, idx);
+        if (rate_limit_unconfirmed(SERVICE_UNCONFIRMED_WHO_IS, &src)) {
+            passed++;
+        }
+        if (++idx == sources) {
+            idx = 0;
+        }
+        n++;
+    } while ((uint32_t)(el_current_millisecond() - start) < opt.duration);
+
+    *checks = n;
+    *elapsed = el_current_millisecond() - start;
+
+    return passed;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --duration MS       flood time of each phase (2000)\r\n"
+        "  --sources N         sources of the sweep phase (1000)\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"duration", required_argument, NULL, 'd'},
+        {"sources", required_argument, NULL, 's'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'd': opt.duration = strtoul(optarg, NULL, 0); break;
+        case 's': opt.sources = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.duration < 100) || (opt.sources < 2) || (opt.sources > 65536)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    bacnet_addr_t src;
+    cJSON *cfg, *report, *status;
+    uint32_t passed, elapsed, start, replies, high, cov_passed;
+    uint64_t checks, begin;
+    char *str;
+    bool ok;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    /* every drop is logged at verbos level */
+    app_set_dbg_level(DEBUG_LEVEL_WARN | DEBUG_LEVEL_ERROR);
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Global_Rate", TEST_GLOBAL_RATE);
+    cJSON_AddNumberToObject(cfg, "Global_Burst", TEST_GLOBAL_BURST);
+    cJSON_AddNumberToObject(cfg, "Source_Rate", TEST_SOURCE_RATE);
+    cJSON_AddNumberToObject(cfg, "Source_Burst", TEST_SOURCE_BURST);
+    cJSON_AddNumberToObject(cfg, "WhoIs_Window", TEST_WHOIS_WINDOW);
+    cJSON_AddNumberToObject(cfg, "Max_Source", TEST_MAX_SOURCE);
+    rv = rate_limit_init(cfg);
+    cJSON_Delete(cfg);
+    if (rv < 0) {
+        printf("rate limit init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    report = cJSON_CreateObject();
+    ok = true;
+
+    /* 1. one source in a loop: only its own bucket admits, its burst at least */
+    passed = flood(1, &checks, &elapsed);
+    high = TEST_SOURCE_BURST + TEST_SOURCE_RATE * (elapsed + TEST_CLOCK_SLACK) / 1000 + 1;
+    ok &= (passed >= TEST_SOURCE_BURST) && (passed <= high);
+    cJSON_AddNumberToObject(report, "single_source_admitted", passed);
+    cJSON_AddNumberToObject(report, "single_source_bucket", high);
+    cJSON_AddNumberToObject(report, "single_source_checks", checks);
+    if (!opt.json) {
+        printf("%-20s %u of %llu admitted in %u ms, source bucket allows %u\r\n",
+            "single source", passed, (unsigned long long)checks, elapsed, high);
+    }
+
+    /* 2. sweep of sources: the global bucket bounds the sum, and is not starved */
+    passed = flood(opt.sources, &checks, &elapsed);
+    high = TEST_GLOBAL_BURST + TEST_GLOBAL_RATE * (elapsed + TEST_CLOCK_SLACK) / 1000 + 1;
+    ok &= (passed >= TEST_GLOBAL_RATE * elapsed / 1000 / 2) && (passed <= high);
+    cJSON_AddNumberToObject(report, "source_sweep_admitted", passed);
+    cJSON_AddNumberToObject(report, "source_sweep_bucket", high);
+    cJSON_AddNumberToObject(report, "source_sweep_checks", checks);
+    if (!opt.json) {
+        printf("%-20s %u of %llu admitted in %u ms, global bucket allows %u\r\n",
+            "source sweep", passed, (unsigned long long)checks, elapsed, high);
+    }
+
+    /* 3. services out of the limited set always pass */
+    make_source(&src, 0);
+    cov_passed = 0;
+    for (replies = 0; replies < 1000; replies++) {
+        if (rate_limit_unconfirmed(SERVICE_UNCONFIRMED_COV_NOTIFICATION, &src)) {
+            cov_passed++;
+        }
+    }
+    ok &= (cov_passed == 1000);
+    cJSON_AddNumberToObject(report, "cov_notification_admitted", cov_passed);
+
+    /* I-Am is out of the default set, the address cache needs every one */
+    passed = 0;
+    for (replies = 0; replies < 1000; replies++) {
+        if (rate_limit_unconfirmed(SERVICE_UNCONFIRMED_I_AM, &src)) {
+            passed++;
+        }
+    }
+    ok &= (passed == 1000);
+    cJSON_AddNumberToObject(report, "i_am_admitted", passed);
+    if (!opt.json) {
+        printf("%-20s COV notification %u/1000, I-Am %u/1000\r\n", "not limited",
+            cov_passed, passed);
+    }
+
+    /* 4. identical Who-Is within a window answered once */
+    replies = 0;
+    checks = 0;
+    start = el_current_millisecond();
+    begin = now_ns();
+    do {
+        if (!rate_limit_whois_collapse(100)) {
+            replies++;
+        }
+        checks++;
+        elapsed = el_current_millisecond() - start;
+    } while (elapsed < opt.duration);
+    ok &= (replies >= elapsed / TEST_WHOIS_WINDOW) && (replies <= elapsed / TEST_WHOIS_WINDOW + 1);
+    cJSON_AddNumberToObject(report, "whois_replies", replies);
+    cJSON_AddNumberToObject(report, "whois_collapse_ns", (double)(now_ns() - begin) / checks);
+    if (!opt.json) {
+        printf("%-20s %u I-Am for %llu Who-Is in %u ms, %u ms window\r\n", "Who-Is collapse",
+            replies, (unsigned long long)checks, elapsed, TEST_WHOIS_WINDOW);
+    }
+
+    /* cost of one admission check on a hot source */
+    begin = now_ns();
+    for (replies = 0; replies < 1000000; replies++) {
+        (void)rate_limit_unconfirmed(SERVICE_UNCONFIRMED_WHO_IS, &src);
+    }
+    cJSON_AddNumberToObject(report, "check_ns", (double)(now_ns() - begin) / 1000000);
+
+    status = rate_limit_get_status();
+    if (status) {
+        cJSON_AddItemToObject(report, "status", status);
+    }
+
+    cJSON_AddStringToObject(report, "result", ok? "pass": "fail");
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+    } else {
+        str = cJSON_Print(status);
+    }
+    if (str) {
+        printf("%s\r\n", str);
+        free(str);
+    }
+    if (!opt.json) {
+        printf("%-20s %.1f ns\r\n", "admission check",
+            cJSON_GetObjectItem(report, "check_ns")->valuedouble);
+        printf("%-20s %s\r\n", "result", ok? "pass": "fail");
+    }
+
+    cJSON_Delete(report);
+    rate_limit_exit();
+
+    return ok? OK: -EPERM;
+}
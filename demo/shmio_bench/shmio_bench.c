@@ -0,0 +1,411 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * shmio_bench.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Benchmark of the shared-memory present value interface. A writer thread
+ * maps the region by name like a field I/O process would and updates every
+ * AI slot as fast as it can; the main thread runs shmio_poll() every
+ * --interval ms as the event loop does. At the end it checks that the last
+ * batch reached the objects and that AO commands are readable by I/O.
+ *
+ *   ./shmio_bench --points 4000 --seconds 3 --json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/app.h"
+#include "bacnet/shmio.h"
+#include "bacnet/object/object.h"
+#include "bacnet/object/ai.h"
+#include "bacnet/object/ao.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "debug.h"
+
+#define BENCH_OUTPUTS               (16)
+
+static struct {
+    uint32_t points;
+    uint32_t seconds;
+    uint32_t interval;
+    bool json;
+} opt = {
+    .points = 4000,
+    .seconds = 3,
+    .interval = 10,
+};
+
+static char shm_name[64];
+
+static volatile bool writer_stop = false;
+
+static uint64_t writer_batches;
+
+static float writer_last;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static cJSON *make_instances(const char *prefix, uint32_t count, bool output)
+{
+    cJSON *array, *item;
+    char name[64];
+    uint32_t i;
+
+    /* built back to front, cJSON_AddItemToArray walks the whole list */
+    array = cJSON_CreateArray();
+    for (i = count; i-- > 0;) {
+        (void)snprintf(name, sizeof(name), "%s_%u", prefix, i);
+        item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "Name", name);
+        cJSON_AddFalseToObject(item, "Out_Of_Service");
+        cJSON_AddNumberToObject(item, "Units", 62);
+        if (output) {
+            cJSON_AddNumberToObject(item, "Relinquish_Default", 0);
+        }
+        cJSON_InsertItemInArray(array, 0, item);
+    }
+
+    return array;
+}
+
+static cJSON *make_app_cfg(void)
+{
+    cJSON *cfg, *list, *type;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", 1);
+    cJSON_AddStringToObject(cfg, "Device_Name", "shmio_bench");
+
+    list = cJSON_CreateArray();
+    type = cJSON_CreateObject();
+    cJSON_AddStringToObject(type, "Type", "AI");
+    cJSON_AddItemToObject(type, "Instance_List", make_instances("AI", opt.points, false));
+    cJSON_AddItemToArray(list, type);
+
+    type = cJSON_CreateObject();
+    cJSON_AddStringToObject(type, "Type", "AO");
+    cJSON_AddItemToObject(type, "Instance_List", make_instances("AO", BENCH_OUTPUTS, true));
+    cJSON_AddItemToArray(list, type);
+    cJSON_AddItemToObject(cfg, "Object_List", list);
+
+    return cfg;
+}
+
+/* slots: AI 0..points-1, then AO 0..BENCH_OUTPUTS-1 */
+static cJSON *make_shmio_cfg(void)
+{
+    cJSON *cfg, *slots, *slot;
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddTrueToObject(cfg, "Enable");
+    cJSON_AddStringToObject(cfg, "Name", shm_name);
+    cJSON_AddNumberToObject(cfg, "Poll_Interval", opt.interval);
+
+    slots = cJSON_CreateArray();
+    for (i = opt.points + BENCH_OUTPUTS; i-- > 0;) {
+        slot = cJSON_CreateObject();
+        cJSON_AddStringToObject(slot, "Type", (i < opt.points)? "AI": "AO");
+        cJSON_AddNumberToObject(slot, "Instance", (i < opt.points)? i: i - opt.points);
+        cJSON_InsertItemInArray(slots, 0, slot);
+    }
+    cJSON_AddItemToObject(cfg, "Slot_List", slots);
+
+    return cfg;
+}
+
+/* maps the region on its own, as a separate I/O process would */
+static shmio_header_t *io_map(size_t *size)
+{
+    shmio_header_t *header;
+    struct stat st;
+    int fd;
+
+    fd = shm_open(shm_name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    header = (shmio_header_t *)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (header == MAP_FAILED) {
+        return NULL;
+    }
+
+    if ((header->magic != SHMIO_MAGIC) || (header->slot_size != sizeof(shmio_slot_t))) {
+        (void)munmap(header, st.st_size);
+        return NULL;
+    }
+    *size = st.st_size;
+
+    return header;
+}
+
+static void *writer_thread(void *arg)
+{
+    shmio_header_t *header = (shmio_header_t *)arg;
+    float value;
+    uint32_t i;
+
+    value = 0.0f;
+    while (!writer_stop) {
+        value += 1.0f;
+        for (i = 0; i < opt.points; i++) {
+            shmio_write_input(shmio_slot(header, i), value + i, RELIABILITY_NO_FAULT_DETECTED,
+                false);
+        }
+        shmio_commit(header);
+        writer_batches++;
+    }
+    writer_last = value;
+
+    return NULL;
+}
+
+static uint32_t check_inputs(void)
+{
+    object_instance_t *object;
+    object_ai_t *ai;
+    uint32_t i, stale;
+
+    stale = 0;
+    for (i = 0; i < opt.points; i++) {
+        object = object_find(OBJECT_ANALOG_INPUT, i);
+        ai = container_of(object, object_ai_t, base.base);
+        if (ai->present != writer_last + i) {
+            stale++;
+        }
+    }
+
+    return stale;
+}
+
+/* commands every AO at priority 8, then reads the commands back through the region */
+static uint32_t check_outputs(shmio_header_t *header)
+{
+    object_instance_t *object;
+    shmio_slot_t copy;
+    uint32_t i, wrong;
+
+    for (i = 0; i < BENCH_OUTPUTS; i++) {
+        object = object_find(OBJECT_ANALOG_OUTPUT, i);
+        (void)analog_output_present_value_set(container_of(object, object_ao_t, base.base.base),
+            100.0f + i, 8);
+    }
+    shmio_poll();
+
+    wrong = 0;
+    for (i = 0; i < BENCH_OUTPUTS; i++) {
+        if (!shmio_read_output(shmio_slot(header, opt.points + i), &copy)
+                || (copy.out_value != 100.0f + i) || (copy.out_priority != 8)
+                || (copy.out_priority_bits != (1 << 7))
+                || (copy.out_priority_array[7] != 100.0f + i)) {
+            wrong++;
+        }
+    }
+
+    return wrong;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --points N          AI slots updated by the writer (4000)\r\n"
+        "  --seconds N         run time (3)\r\n"
+        "  --interval N        poll interval in ms (10)\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"points", required_argument, NULL, 'n'},
+        {"seconds", required_argument, NULL, 's'},
+        {"interval", required_argument, NULL, 'i'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'n': opt.points = strtoul(optarg, NULL, 0); break;
+        case 's': opt.seconds = strtoul(optarg, NULL, 0); break;
+        case 'i': opt.interval = strtoul(optarg, NULL, 0); break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.points == 0) || (opt.points + BENCH_OUTPUTS > 65536) || (opt.seconds == 0)
+            || (opt.interval == 0) || (opt.interval > 1000)) {
+        usage(argv[0]);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    shmio_header_t *header;
+    pthread_t writer;
+    cJSON *cfg, *report, *status;
+    uint64_t begin, end, poll_us, polls;
+    uint32_t stale, wrong;
+    size_t size;
+    char *str;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    app_set_dbg_level(DEBUG_LEVEL_WARN | DEBUG_LEVEL_ERROR);
+    (void)snprintf(shm_name, sizeof(shm_name), "/shmio_bench.%d", (int)getpid());
+
+    /* poll timer is created but never runs, the main thread polls instead */
+    rv = el_loop_init(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    cfg = make_app_cfg();
+    rv = object_init(cfg);
+    cJSON_Delete(cfg);
+    if (rv < 0) {
+        printf("object init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    cfg = make_shmio_cfg();
+    rv = shmio_init(cfg);
+    cJSON_Delete(cfg);
+    if (rv < 0) {
+        printf("shmio init failed(%d)\r\n", rv);
+        goto out0;
+    }
+
+    header = io_map(&size);
+    if (header == NULL) {
+        printf("map %s failed\r\n", shm_name);
+        rv = -EPERM;
+        goto out1;
+    }
+
+    if (pthread_create(&writer, NULL, writer_thread, header) != 0) {
+        printf("create writer failed\r\n");
+        rv = -EPERM;
+        goto out2;
+    }
+
+    polls = 0;
+    poll_us = 0;
+    end = now_us() + opt.seconds * 1000000ULL;
+    while (now_us() < end) {
+        usleep(opt.interval * 1000);
+        begin = now_us();
+        shmio_poll();
+        poll_us += now_us() - begin;
+        polls++;
+    }
+
+    writer_stop = true;
+    (void)pthread_join(writer, NULL);
+    shmio_poll();
+
+    stale = check_inputs();
+    wrong = check_outputs(header);
+    status = shmio_get_status();
+
+    report = cJSON_CreateObject();
+    cJSON_AddNumberToObject(report, "points", opt.points);
+    cJSON_AddNumberToObject(report, "seconds", opt.seconds);
+    cJSON_AddNumberToObject(report, "writer_batches", writer_batches);
+    cJSON_AddNumberToObject(report, "writer_updates_per_sec",
+        (double)writer_batches * opt.points / opt.seconds);
+    cJSON_AddNumberToObject(report, "polls", polls);
+    cJSON_AddNumberToObject(report, "avg_poll_us", polls? (double)poll_us / polls: 0);
+    cJSON_AddNumberToObject(report, "stale_inputs", stale);
+    cJSON_AddNumberToObject(report, "wrong_outputs", wrong);
+    if (status) {
+        cJSON_AddItemToObject(report, "shared_io", status);
+    }
+
+    str = opt.json? cJSON_Print(report): NULL;
+    if (str) {
+        printf("%s\r\n", str);
+        free(str);
+    } else {
+        printf("points %u, writer %.0f updates/s\r\n", opt.points,
+            (double)writer_batches * opt.points / opt.seconds);
+        printf("polls %u, avg %.1f us per poll\r\n", (uint32_t)polls,
+            polls? (double)poll_us / polls: 0);
+        printf("stale inputs %u, wrong outputs %u\r\n", stale, wrong);
+    }
+    cJSON_Delete(report);
+
+    rv = (stale || wrong)? -EPERM: OK;
+
+out2:
+    (void)munmap(header, size);
+
+out1:
+    shmio_exit();
+    (void)shm_unlink(shm_name);
+
+out0:
+    object_exit();
+
+    return rv;
+}
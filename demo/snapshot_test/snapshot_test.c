@@ -0,0 +1,555 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * snapshot_test.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Check of the binary snapshots that carry the address binding cache and the
+ * dynamic routes across restarts:
+ * - save_snapshot_file/load_snapshot_file round trip with the saved age, and
+ *   rejection of a flipped byte, a truncated file and a wrong magic;
+ * - address bindings restored with their age, those past the TTL dropped;
+ * - routes restored without the route_table, and dropped on a port whose
+ *   network number changed. Each route phase runs in its own child process,
+ *   as a restart would.
+ *
+ *   ./snapshot_test --dir /tmp
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bacnet_buf.h"
+#include "bacnet/config.h"
+#include "bacnet/addressbind.h"
+#include "bacnet/network.h"
+#include "bacnet/app.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "misc/utils.h"
+#include "debug.h"
+
+#define TEST_MAGIC                  (0x54535431)    /* "TST1" */
+#define TEST_PAYLOAD_LEN            (1000)
+
+/* saved_time follows magic, len, checksum and reserved in the snapshot header */
+#define TEST_SAVED_TIME_OFFSET      (16)
+
+#define TEST_ADDRESS_TTL            (20)
+#define TEST_ADDRESS_GAP            (3)
+#define TEST_ADDRESS_NUMS           (50)
+#define TEST_MAX_APDU               (480)
+
+#define TEST_ROUTE_NUMS             (5)
+#define TEST_ROUTE_DNET             (70)
+#define TEST_NET_A                  (1)
+#define TEST_NET_B                  (2)
+#define TEST_NET_B_RENUMBERED       (9)
+
+typedef enum {
+    ROUTE_PHASE_CONFIG = 0,         /* routes from route_table, saved on exit */
+    ROUTE_PHASE_RESTORE,            /* no route_table, routes from the snapshot */
+    ROUTE_PHASE_RENUMBER,           /* port B renumbered, its routes dropped */
+} route_phase_t;
+
+static struct {
+    const char *dir;
+    bool json;
+} opt = {
+    .dir = "/tmp",
+};
+
+static route_phase_t route_phase;
+
+static char route_file[PATH_MAX];
+
+static cJSON *create_resource(const char *ifname)
+{
+    cJSON *res;
+
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "VIRTUAL");
+    cJSON_AddStringToObject(res, "ifname", ifname);
+
+    return res;
+}
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "snap-a", create_resource("snapbus-a"));
+    cJSON_AddItemToObject(cfg, "snap-b", create_resource("snapbus-b"));
+
+    return cfg;
+}
+
+static cJSON *create_port_cfg(uint16_t net, const char *resource)
+{
+    cJSON *port;
+
+    port = cJSON_CreateObject();
+    cJSON_AddTrueToObject(port, "enable");
+    cJSON_AddNumberToObject(port, "net_num", net);
+    cJSON_AddStringToObject(port, "dl_type", "VIRTUAL");
+    cJSON_AddStringToObject(port, "resource_name", resource);
+    cJSON_AddNumberToObject(port, "mac", 1);
+
+    return port;
+}
+
+/* route i goes out of port i & 1 via next hop mac i + 5 */
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *table, *entry, *cache, *ports;
+    char mac[8];
+    int i;
+
+    cfg = cJSON_CreateObject();
+
+    table = cJSON_CreateArray();
+    if (route_phase == ROUTE_PHASE_CONFIG) {
+        for (i = 0; i < TEST_ROUTE_NUMS; i++) {
+            entry = cJSON_CreateObject();
+            cJSON_AddNumberToObject(entry, "dnet", TEST_ROUTE_DNET + i);
+            cJSON_AddNumberToObject(entry, "out_port", i & 1);
+            sprintf(mac, "%04x", i + 5);
+            cJSON_AddStringToObject(entry, "next_hop", mac);
+            cJSON_AddItemToArray(table, entry);
+        }
+    }
+    cJSON_AddItemToObject(cfg, "route_table", table);
+
+    cache = cJSON_CreateObject();
+    cJSON_AddStringToObject(cache, "file", route_file);
+    cJSON_AddItemToObject(cfg, "route_cache", cache);
+
+    ports = cJSON_CreateArray();
+    cJSON_AddItemToArray(ports, create_port_cfg(TEST_NET_A, "snap-a"));
+    cJSON_AddItemToArray(ports, create_port_cfg((route_phase == ROUTE_PHASE_RENUMBER)?
+        TEST_NET_B_RENUMBERED: TEST_NET_B, "snap-b"));
+    cJSON_AddItemToObject(cfg, "port", ports);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return cJSON_CreateObject();
+}
+
+/* move the saved time of a snapshot back, as if the device was down that long */
+static int shift_saved_time(const char *filename, int64_t seconds)
+{
+    int64_t saved;
+    int fd;
+    int rv;
+
+    fd = open(filename, O_RDWR);
+    if (fd == -1) {
+        return -EPERM;
+    }
+
+    rv = -EPERM;
+    if (pread(fd, &saved, sizeof(saved), TEST_SAVED_TIME_OFFSET) == sizeof(saved)) {
+        saved -= seconds;
+        if (pwrite(fd, &saved, sizeof(saved), TEST_SAVED_TIME_OFFSET) == sizeof(saved)) {
+            rv = OK;
+        }
+    }
+    close(fd);
+
+    return rv;
+}
+
+static int flip_byte(const char *filename, off_t offset)
+{
+    uint8_t byte;
+    int fd;
+    int rv;
+
+    fd = open(filename, O_RDWR);
+    if (fd == -1) {
+        return -EPERM;
+    }
+
+    rv = -EPERM;
+    if (pread(fd, &byte, 1, offset) == 1) {
+        byte ^= 0x5A;
+        if (pwrite(fd, &byte, 1, offset) == 1) {
+            rv = OK;
+        }
+    }
+    close(fd);
+
+    return rv;
+}
+
+/* 1 if the snapshot is accepted, 0 if rejected */
+static uint32_t snapshot_loads(const char *filename, uint32_t magic)
+{
+    uint32_t len;
+    void *data;
+
+    data = load_snapshot_file(filename, magic, &len, NULL);
+    free(data);
+
+    return (data != NULL)? 1: 0;
+}
+
+/* a damaged snapshot must never be handed to its owner */
+static bool test_snapshot_file(cJSON *report)
+{
+    char filename[PATH_MAX];
+    uint8_t payload[TEST_PAYLOAD_LEN];
+    uint8_t *data;
+    uint32_t len, fresh_age, shifted_age, rejected;
+    bool same;
+    int rv;
+    int i;
+
+    snprintf(filename, sizeof(filename), "%s/snapshot_test.snap", opt.dir);
+
+    for (i = 0; i < TEST_PAYLOAD_LEN; i++) {
+        payload[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    rv = save_snapshot_file(filename, TEST_MAGIC, payload, sizeof(payload));
+    if (rv < 0) {
+        printf("save %s failed(%d)\r\n", filename, rv);
+        return false;
+    }
+
+    len = 0;
+    fresh_age = UINT32_MAX;
+    same = false;
+    data = (uint8_t *)load_snapshot_file(filename, TEST_MAGIC, &len, &fresh_age);
+    if (data) {
+        same = (len == sizeof(payload)) && !memcmp(data, payload, len);
+        free(data);
+    }
+
+    shifted_age = UINT32_MAX;
+    rv = shift_saved_time(filename, 100);
+    data = (uint8_t *)load_snapshot_file(filename, TEST_MAGIC, &len, &shifted_age);
+    free(data);
+
+    rejected = 1 - snapshot_loads(filename, TEST_MAGIC + 1);
+
+    /* the saved time is outside the checksum, a flipped payload byte is not */
+    rv |= flip_byte(filename, TEST_SAVED_TIME_OFFSET + sizeof(int64_t) + TEST_PAYLOAD_LEN / 2);
+    rejected += 1 - snapshot_loads(filename, TEST_MAGIC);
+
+    rv |= save_snapshot_file(filename, TEST_MAGIC, payload, sizeof(payload));
+    rv |= truncate(filename, TEST_SAVED_TIME_OFFSET + sizeof(int64_t) + TEST_PAYLOAD_LEN - 1);
+    rejected += 1 - snapshot_loads(filename, TEST_MAGIC);
+
+    rv |= truncate(filename, TEST_SAVED_TIME_OFFSET / 2);
+    rejected += 1 - snapshot_loads(filename, TEST_MAGIC);
+
+    (void)unlink(filename);
+    rejected += 1 - snapshot_loads(filename, TEST_MAGIC);
+
+    cJSON_AddBoolToObject(report, "file_round_trip", same);
+    cJSON_AddNumberToObject(report, "file_fresh_age_s", fresh_age);
+    cJSON_AddNumberToObject(report, "file_aged_100s_age_s", shifted_age);
+    cJSON_AddNumberToObject(report, "file_damaged_rejected", rejected);
+
+    if (!opt.json) {
+        printf("%-24s %s\r\n", "snapshot round trip", same? "yes": "no");
+        printf("%-24s %u s fresh, %u s after 100 s down\r\n", "snapshot age", fresh_age,
+            shifted_age);
+        printf("%-24s %u/5\r\n", "damaged files rejected", rejected);
+    }
+
+    return (rv == 0) && same && (fresh_age <= 1) && (shifted_age >= 100)
+        && (shifted_age <= 101) && (rejected == 5);
+}
+
+static cJSON *create_address_cfg(const char *filename)
+{
+    cJSON *cfg;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddStringToObject(cfg, "Cache_File", filename);
+    cJSON_AddNumberToObject(cfg, "Address_Cache_TTL", TEST_ADDRESS_TTL);
+
+    return cfg;
+}
+
+static void make_address(bacnet_addr_t *addr, uint32_t idx)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->net = 5;
+    addr->len = 1;
+    addr->adr[0] = (uint8_t)idx;
+}
+
+/* count devices of [first, first + nums) found with the address they were added with */
+static uint32_t address_hits(uint32_t first, uint32_t nums)
+{
+    bacnet_addr_t addr, expect;
+    uint32_t max_apdu, hits, i;
+
+    hits = 0;
+    for (i = first; i < first + nums; i++) {
+        make_address(&expect, i);
+        if (query_address_from_device(1000 + i, &max_apdu, &addr) && (max_apdu == TEST_MAX_APDU)
+                && (addr.len == expect.len) && !memcmp(addr.adr, expect.adr, addr.len)) {
+            hits++;
+        }
+    }
+
+    return hits;
+}
+
+/*
+ * Group old is added TEST_ADDRESS_GAP s before group new, and the snapshot is
+ * aged by TTL - GAP s of downtime: old reaches the TTL and is dropped, new is
+ * restored with at most GAP s left to live.
+ */
+static bool test_address_cache(cJSON *report)
+{
+    char filename[PATH_MAX];
+    bacnet_addr_t addr;
+    cJSON *cfg;
+    uint32_t restored, old_left, new_left, new_expired, corrupted;
+    uint32_t i;
+    int rv;
+
+    snprintf(filename, sizeof(filename), "%s/snapshot_test.address", opt.dir);
+    (void)unlink(filename);
+
+    cfg = create_address_cfg(filename);
+    rv = address_init(cfg);
+    if (rv < 0) {
+        printf("address init failed(%d)\r\n", rv);
+        cJSON_Delete(cfg);
+        return false;
+    }
+
+    for (i = 0; i < TEST_ADDRESS_NUMS * 2; i++) {
+        if (i == TEST_ADDRESS_NUMS) {
+            sleep(TEST_ADDRESS_GAP);
+        }
+        make_address(&addr, i);
+        (void)address_add(1000 + i, TEST_MAX_APDU, &addr, false);
+    }
+
+    rv = address_save_cache();
+    address_exit();
+
+    /* restart right away: every binding comes back */
+    rv |= address_init(cfg);
+    restored = address_hits(0, TEST_ADDRESS_NUMS * 2);
+    address_exit();
+
+    /* restart after TTL - GAP s of downtime */
+    rv |= shift_saved_time(filename, TEST_ADDRESS_TTL - TEST_ADDRESS_GAP);
+    rv |= address_init(cfg);
+    old_left = address_hits(0, TEST_ADDRESS_NUMS);
+    new_left = address_hits(TEST_ADDRESS_NUMS, TEST_ADDRESS_NUMS);
+
+    /* restored entries keep their age and expire GAP s later, not TTL s later */
+    sleep(TEST_ADDRESS_GAP + 1);
+    new_expired = TEST_ADDRESS_NUMS - address_hits(TEST_ADDRESS_NUMS, TEST_ADDRESS_NUMS);
+    address_exit();
+
+    /* a corrupted cache is ignored, the stack starts empty */
+    make_address(&addr, 0);
+    rv |= address_init(cfg);
+    (void)address_add(1000, TEST_MAX_APDU, &addr, false);
+    rv |= address_save_cache();
+    address_exit();
+    rv |= flip_byte(filename, TEST_SAVED_TIME_OFFSET + sizeof(int64_t));
+    rv |= address_init(cfg);
+    corrupted = address_hits(0, 1);
+    address_exit();
+
+    (void)unlink(filename);
+    cJSON_Delete(cfg);
+
+    cJSON_AddNumberToObject(report, "address_restored", restored);
+    cJSON_AddNumberToObject(report, "address_past_ttl_restored", old_left);
+    cJSON_AddNumberToObject(report, "address_within_ttl_restored", new_left);
+    cJSON_AddNumberToObject(report, "address_expired_on_age", new_expired);
+    cJSON_AddNumberToObject(report, "address_from_corrupted", corrupted);
+
+    if (!opt.json) {
+        printf("%-24s %u/%u\r\n", "bindings restored", restored, TEST_ADDRESS_NUMS * 2);
+        printf("%-24s %u past TTL, %u/%u within TTL\r\n", "restored after downtime",
+            old_left, new_left, TEST_ADDRESS_NUMS);
+        printf("%-24s %u/%u after %u s\r\n", "expired on saved age", new_expired,
+            TEST_ADDRESS_NUMS, TEST_ADDRESS_GAP + 1);
+        printf("%-24s %u\r\n", "from corrupted cache", corrupted);
+    }
+
+    return (rv == 0) && (restored == TEST_ADDRESS_NUMS * 2) && (old_left == 0)
+        && (new_left == TEST_ADDRESS_NUMS) && (new_expired == TEST_ADDRESS_NUMS)
+        && (corrupted == 0);
+}
+
+/* routes to the test dnets that a send can use; each phase is a restart, run in a child */
+static uint32_t route_phase_run(route_phase_t phase)
+{
+    DECLARE_BACNET_BUF(tx_apdu, MIN_APDU);
+    bacnet_addr_t dst;
+    uint32_t found;
+    pid_t pid;
+    int status;
+    int i;
+
+    /* or the child prints what the parent buffered again */
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0) {
+        printf("fork failed(%s)\r\n", strerror(errno));
+        return UINT32_MAX;
+    }
+
+    if (pid > 0) {
+        if ((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status)) {
+            return UINT32_MAX;
+        }
+        return WEXITSTATUS(status);
+    }
+
+    route_phase = phase;
+    if (bacnet_init() < 0) {
+        _exit(UINT8_MAX);
+    }
+
+    found = 0;
+    for (i = 0; i < TEST_ROUTE_NUMS; i++) {
+        (void)bacnet_buf_init(&tx_apdu.buf, MIN_APDU);
+        tx_apdu.buf.data[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST << 4;
+        tx_apdu.buf.data[1] = SERVICE_UNCONFIRMED_WHO_IS;
+        tx_apdu.buf.data_len = 2;
+
+        memset(&dst, 0, sizeof(dst));
+        dst.net = TEST_ROUTE_DNET + i;
+        if (network_send_pdu(&dst, &tx_apdu.buf, PRIORITY_NORMAL, false) >= 0) {
+            found++;
+        }
+    }
+
+    bacnet_exit();
+    fflush(stdout);
+
+    _exit(found);
+}
+
+static bool test_route_cache(cJSON *report)
+{
+    uint32_t configured, restored, renumbered;
+
+    snprintf(route_file, sizeof(route_file), "%s/snapshot_test.route", opt.dir);
+    (void)unlink(route_file);
+
+    configured = route_phase_run(ROUTE_PHASE_CONFIG);
+    restored = route_phase_run(ROUTE_PHASE_RESTORE);
+    renumbered = route_phase_run(ROUTE_PHASE_RENUMBER);
+
+    (void)unlink(route_file);
+
+    cJSON_AddNumberToObject(report, "route_configured", configured);
+    cJSON_AddNumberToObject(report, "route_restored", restored);
+    cJSON_AddNumberToObject(report, "route_after_renumber", renumbered);
+
+    if (!opt.json) {
+        printf("%-24s %u/%u\r\n", "routes configured", configured, TEST_ROUTE_NUMS);
+        printf("%-24s %u/%u\r\n", "routes restored", restored, TEST_ROUTE_NUMS);
+        printf("%-24s %u/%u\r\n", "routes after renumber", renumbered,
+            (TEST_ROUTE_NUMS + 1) / 2);
+    }
+
+    /* routes out of port B (odd i) go, those of port A stay */
+    return (configured == TEST_ROUTE_NUMS) && (restored == TEST_ROUTE_NUMS)
+        && (renumbered == (TEST_ROUTE_NUMS + 1) / 2);
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --dir DIR           directory of the snapshot files (/tmp)\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"dir", required_argument, NULL, 'd'},
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'd': opt.dir = optarg; break;
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *report;
+    char *str;
+    bool ok;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    /* restored bindings revalidate by Who-Is, which has no network here */
+    app_set_dbg_level(0);
+    network_set_dbg_level(0);
+
+    report = cJSON_CreateObject();
+
+    /* the route phases fork, before this process has any thread */
+    ok = test_route_cache(report);
+
+    ok &= (el_loop_init(&el_default_loop) == OK);
+    ok &= test_snapshot_file(report);
+    ok &= test_address_cache(report);
+    cJSON_AddStringToObject(report, "result", ok? "pass": "fail");
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("%-24s %s\r\n", "result", ok? "pass": "fail");
+    }
+
+    cJSON_Delete(report);
+
+    return ok? OK: -EPERM;
+}
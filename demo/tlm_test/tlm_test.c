@@ -0,0 +1,620 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * tlm_test.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Check of the ReadRange arithmetic of the Trend Log Multiple Log_Buffer.
+ * The log is filled past its Buffer_Size so that the ring wraps, then each
+ * request type (by position, by sequence number, by time) is read with a
+ * positive and a negative count, and the item count, the FIRST_ITEM,
+ * LAST_ITEM and MORE_ITEMS result flags and the firstSequenceNumber of the
+ * reply are checked. Stop_When_Full is checked last: the log disables itself
+ * with a free entry left for the log disabled record, and can't be enabled
+ * again until the buffer is purged.
+ *
+ *   ./tlm_test --json
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bacnet/bacnet.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/config.h"
+#include "bacnet/datetime.h"
+#include "bacnet/service/rr.h"
+#include "bacnet/object/object.h"
+#include "bacnet/object/trendlog_multiple.h"
+#include "bacnet/app.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+#include "debug.h"
+
+#define TEST_BUFFER_SIZE            (6)
+
+/* records of the first second, then of the second one, 9 in all wrap the ring of 6 */
+#define TEST_GROUP_A                (5)
+#define TEST_GROUP_B                (4)
+
+/* room kept by the object for the reply header, TLM_RR_OVERHEAD of trendlog_multiple.c */
+#define TEST_RR_OVERHEAD            (20)
+
+#define FLAG_FIRST                  (1 << RESULT_FLAG_FIRST_ITEM)
+#define FLAG_LAST                   (1 << RESULT_FLAG_LAST_ITEM)
+#define FLAG_MORE                   (1 << RESULT_FLAG_MORE_ITEMS)
+
+typedef struct {
+    uint32_t flags;                 /* FLAG_* */
+    uint32_t items;
+    uint32_t first_seq;             /* 0 when the reply carries none */
+    uint32_t data_len;              /* length of the log records */
+} rr_result_t;
+
+static struct {
+    bool json;
+} opt;
+
+static object_instance_t *tlm_object;
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    return NULL;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    return NULL;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    return NULL;
+}
+
+static cJSON *create_member(uint32_t instance, BACNET_PROPERTY_ID property)
+{
+    cJSON *member;
+
+    member = cJSON_CreateObject();
+    cJSON_AddNumberToObject(member, "Logged_ObjectType", OBJECT_ANALOG_INPUT);
+    cJSON_AddNumberToObject(member, "Logged_ObjectInstance", instance);
+    cJSON_AddNumberToObject(member, "Logged_PropertyID", property);
+
+    return member;
+}
+
+static cJSON *create_object_cfg(void)
+{
+    cJSON *cfg, *list, *type, *instances, *instance, *members;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", 1);
+    cJSON_AddStringToObject(cfg, "Device_Name", "tlm_test");
+    list = cJSON_CreateArray();
+    cJSON_AddItemToObject(cfg, "Object_List", list);
+
+    type = cJSON_CreateObject();
+    cJSON_AddStringToObject(type, "Type", "AI");
+    instances = cJSON_CreateArray();
+    instance = cJSON_CreateObject();
+    cJSON_AddStringToObject(instance, "Name", "ai0");
+    cJSON_AddNumberToObject(instance, "Units", UNITS_DEGREES_CELSIUS);
+    cJSON_AddFalseToObject(instance, "Out_Of_Service");
+    cJSON_AddItemToArray(instances, instance);
+    cJSON_AddItemToObject(type, "Instance_List", instances);
+    cJSON_AddItemToArray(list, type);
+
+    /* the polled interval is far away, records are only added by trend_log_multiple_acquire */
+    type = cJSON_CreateObject();
+    cJSON_AddStringToObject(type, "Type", "TLM");
+    instances = cJSON_CreateArray();
+    instance = cJSON_CreateObject();
+    cJSON_AddStringToObject(instance, "Name", "tlm0");
+    cJSON_AddNumberToObject(instance, "Log_Interval", 3600);
+    cJSON_AddNumberToObject(instance, "Buffer_Size", TEST_BUFFER_SIZE);
+    cJSON_AddFalseToObject(instance, "Align_Intervals");
+    members = cJSON_CreateArray();
+    cJSON_AddItemToArray(members, create_member(0, PROP_PRESENT_VALUE));
+    cJSON_AddItemToArray(members, create_member(0, PROP_STATUS_FLAGS));
+    cJSON_AddItemToObject(instance, "Member_List", members);
+    cJSON_AddItemToArray(instances, instance);
+    cJSON_AddItemToObject(type, "Instance_List", instances);
+    cJSON_AddItemToArray(list, type);
+
+    return cfg;
+}
+
+/* FIRST|LAST|MORE, - if none */
+static const char *flags_text(uint32_t flags, char *buf, size_t size)
+{
+    (void)snprintf(buf, size, "%s%s%s%s", (flags & FLAG_FIRST)? "FIRST|": "",
+        (flags & FLAG_LAST)? "LAST|": "", (flags & FLAG_MORE)? "MORE|": "", flags? "": "-|");
+    buf[strlen(buf) - 1] = '\0';
+
+    return buf;
+}
+
+/* length of the tagged values up to the closing tag that ends the enclosing level */
+static int data_length(const uint8_t *pdu, int max_len)
+{
+    uint32_t len_value;
+    uint8_t tag_number;
+    int depth, len, i;
+
+    depth = 0;
+    i = 0;
+    while (i < max_len) {
+        if (IS_OPENING_CLOSING_TAG(pdu[i])) {
+            if (IS_OPENING_TAG(pdu[i])) {
+                depth++;
+            } else if (depth-- == 0) {
+                return i;
+            }
+            i += IS_EXTENDED_TAG_NUMBER(pdu[i])? 2: 1;
+            continue;
+        }
+
+        len = decode_tag_number_and_value(&pdu[i], &tag_number, &len_value);
+        if (len < 0) {
+            return -EPERM;
+        }
+        if (IS_CONTEXT_SPECIFIC(pdu[i]) || (tag_number != BACNET_APPLICATION_TAG_BOOLEAN)) {
+            len += (int)len_value;
+        }
+        i += len;
+    }
+
+    return -EPERM;
+}
+
+static int read_range(RR_RANGE *range, uint32_t max_len, rr_result_t *result)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    BACNET_BIT_STRING flags;
+    uint8_t pdu[MAX_APDU];
+    int pdu_len, len, i;
+
+    memset(&rp_data, 0, sizeof(rp_data));
+    rp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    rp_data.object_instance = 0;
+    rp_data.property_id = PROP_LOG_BUFFER;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = pdu;
+    rp_data.application_data_len = max_len;
+
+    memset(result, 0, sizeof(*result));
+    pdu_len = object_read_property(&rp_data, range);
+    if (pdu_len < 0) {
+        return pdu_len;
+    }
+
+    len = decode_context_bitstring(pdu, 3, &flags);
+    if (len < 0) {
+        return -EPERM;
+    }
+    for (i = RESULT_FLAG_FIRST_ITEM; i <= RESULT_FLAG_MORE_ITEMS; i++) {
+        if (bitstring_get_bit(&flags, i)) {
+            result->flags |= 1 << i;
+        }
+    }
+
+    i = decode_context_unsigned(&pdu[len], 4, &result->items);
+    if ((i < 0) || (decode_opening_tag(&pdu[len + i], 5) < 0)) {
+        return -EPERM;
+    }
+    len += i + 1;
+
+    i = data_length(&pdu[len], pdu_len - len);
+    if ((i < 0) || (decode_closing_tag(&pdu[len + i], 5) < 0)) {
+        return -EPERM;
+    }
+    result->data_len = i;
+    len += i + 1;
+
+    if (len < pdu_len) {
+        if (decode_context_unsigned(&pdu[len], 6, &result->first_seq) < 0) {
+            return -EPERM;
+        }
+    }
+
+    return OK;
+}
+
+/*
+ * one ReadRange of the Log_Buffer, the reply must carry the expected item count,
+ * result flags and firstSequenceNumber (0 if the reply must not carry one)
+ */
+static bool read_range_case(cJSON *report, const char *name, RR_RANGE *range,
+            uint32_t max_len, uint32_t items, uint32_t flags, uint32_t first_seq)
+{
+    rr_result_t result;
+    cJSON *item;
+    char got[24], expect[24];
+    bool ok;
+    int rv;
+
+    rv = read_range(range, max_len, &result);
+    ok = (rv == OK) && (result.items == items) && (result.flags == flags)
+        && (result.first_seq == first_seq);
+
+    item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "items", result.items);
+    cJSON_AddStringToObject(item, "flags", flags_text(result.flags, got, sizeof(got)));
+    cJSON_AddNumberToObject(item, "first_seq", result.first_seq);
+    cJSON_AddBoolToObject(item, "pass", ok);
+    cJSON_AddItemToObject(report, name, item);
+
+    if (!opt.json) {
+        if (rv < 0) {
+            printf("%-20s read range failed(%d)\r\n", name, rv);
+        } else {
+            printf("%-20s %u items %-16s seq %u%s\r\n", name, result.items,
+                flags_text(result.flags, got, sizeof(got)), result.first_seq,
+                ok? "": " FAIL");
+        }
+        if (!ok) {
+            printf("%-20s %u items %-16s seq %u\r\n", "  expected", items,
+                flags_text(flags, expect, sizeof(expect)), first_seq);
+        }
+    }
+
+    return ok;
+}
+
+static void set_range(RR_RANGE *range, RR_TYPE type, uint32_t ref, int count)
+{
+    memset(range, 0, sizeof(*range));
+    range->RequestType = type;
+    range->Range.RefIndex = ref;
+    range->Count = count;
+}
+
+static void set_time_range(RR_RANGE *range, time_t ref, int count)
+{
+    struct tm local;
+
+    memset(range, 0, sizeof(*range));
+    range->RequestType = RR_BY_TIME;
+    (void)localtime_r(&ref, &local);
+    datetime_set_values(&range->Range.RefTime, local.tm_year + 1900, local.tm_mon + 1,
+        local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec, 0);
+    range->Count = count;
+}
+
+static uint32_t read_unsigned(BACNET_PROPERTY_ID property)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    uint8_t pdu[MAX_APDU];
+    uint32_t value;
+
+    memset(&rp_data, 0, sizeof(rp_data));
+    rp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    rp_data.property_id = property;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = pdu;
+    rp_data.application_data_len = sizeof(pdu);
+
+    value = UINT32_MAX;
+    if (object_read_property(&rp_data, NULL) > 0) {
+        (void)decode_application_unsigned(pdu, &value);
+    }
+
+    return value;
+}
+
+static uint32_t read_enable(void)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    uint8_t pdu[MAX_APDU];
+    bool value;
+
+    memset(&rp_data, 0, sizeof(rp_data));
+    rp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    rp_data.property_id = PROP_ENABLE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = pdu;
+    rp_data.application_data_len = sizeof(pdu);
+
+    if ((object_read_property(&rp_data, NULL) < 0)
+            || (decode_application_boolean(pdu, &value) < 0)) {
+        return UINT32_MAX;
+    }
+
+    return value? 1: 0;
+}
+
+/* @return: 1 if the write is accepted */
+static uint32_t write_property(BACNET_PROPERTY_ID property, uint8_t *data, int len)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data;
+
+    memset(&wp_data, 0, sizeof(wp_data));
+    wp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    wp_data.property_id = property;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_MAX_PRIORITY;
+    wp_data.application_data = data;
+    wp_data.application_data_len = len;
+
+    return (object_write_property(&wp_data) < 0)? 0: 1;
+}
+
+static uint32_t write_boolean(BACNET_PROPERTY_ID property, bool value)
+{
+    uint8_t data[4];
+
+    return write_property(property, data, encode_application_boolean(data, value));
+}
+
+static uint32_t write_unsigned(BACNET_PROPERTY_ID property, uint32_t value)
+{
+    uint8_t data[8];
+
+    return write_property(property, data, encode_application_unsigned(data, value));
+}
+
+static void acquire(uint32_t nums)
+{
+    while (nums--) {
+        (void)trend_log_multiple_acquire(tlm_object);
+    }
+}
+
+/* @return: the new second, records stamped with it are not mixed with the earlier ones */
+static time_t wait_next_second(void)
+{
+    time_t now;
+
+    now = time(NULL);
+    while (time(NULL) == now) {
+        usleep(10000);
+    }
+
+    return time(NULL);
+}
+
+/*
+ * Sequence numbers 1 - 5 are stamped at tA, 6 - 9 at tB, the ring of 6 keeps 4 - 9:
+ *   position  1  2  3  4  5  6
+ *   sequence  4  5  6  7  8  9
+ *   time      A  A  B  B  B  B
+ */
+static bool test_wrapped_log(cJSON *report)
+{
+    RR_RANGE range;
+    rr_result_t result;
+    uint32_t records, total, record_len, small;
+    time_t tA, tB;
+    bool ok;
+
+    tA = wait_next_second();
+    acquire(TEST_GROUP_A);
+    tB = wait_next_second();
+    acquire(TEST_GROUP_B);
+
+    records = read_unsigned(PROP_RECORD_COUNT);
+    total = read_unsigned(PROP_TOTAL_RECORD_COUNT);
+    cJSON_AddNumberToObject(report, "record_count", records);
+    cJSON_AddNumberToObject(report, "total_record_count", total);
+    if (!opt.json) {
+        printf("%-20s %u of %u written\r\n", "wrapped log holds", records, total);
+    }
+    ok = (records == TEST_BUFFER_SIZE) && (total == TEST_GROUP_A + TEST_GROUP_B);
+
+    set_range(&range, RR_READ_ALL, 0, 0);
+    ok &= read_range_case(report, "all", &range, MAX_APDU, 6, FLAG_FIRST | FLAG_LAST, 0);
+
+    /* by position, no firstSequenceNumber in the reply */
+    set_range(&range, RR_BY_POSITION, 1, 2);
+    ok &= read_range_case(report, "pos_head", &range, MAX_APDU, 2, FLAG_FIRST, 0);
+    set_range(&range, RR_BY_POSITION, 3, 10);
+    ok &= read_range_case(report, "pos_to_tail", &range, MAX_APDU, 4, FLAG_LAST, 0);
+    set_range(&range, RR_BY_POSITION, 6, -2);
+    ok &= read_range_case(report, "pos_tail_back", &range, MAX_APDU, 2, FLAG_LAST, 0);
+    set_range(&range, RR_BY_POSITION, 4, -10);
+    ok &= read_range_case(report, "pos_to_head", &range, MAX_APDU, 4, FLAG_FIRST, 0);
+    set_range(&range, RR_BY_POSITION, TEST_BUFFER_SIZE + 1, 1);
+    ok &= read_range_case(report, "pos_past_end", &range, MAX_APDU, 0, 0, 0);
+
+    /* by sequence number, the ones overwritten by the wrap are gone */
+    set_range(&range, RR_BY_SEQUENCE, 5, 2);
+    ok &= read_range_case(report, "seq_middle", &range, MAX_APDU, 2, 0, 5);
+    set_range(&range, RR_BY_SEQUENCE, 9, -10);
+    ok &= read_range_case(report, "seq_all_back", &range, MAX_APDU, 6, FLAG_FIRST | FLAG_LAST,
+        4);
+    set_range(&range, RR_BY_SEQUENCE, 4, -1);
+    ok &= read_range_case(report, "seq_oldest", &range, MAX_APDU, 1, FLAG_FIRST, 4);
+    set_range(&range, RR_BY_SEQUENCE, 3, 2);
+    ok &= read_range_case(report, "seq_overwritten", &range, MAX_APDU, 0, 0, 0);
+    set_range(&range, RR_BY_SEQUENCE, 10, -1);
+    ok &= read_range_case(report, "seq_not_yet", &range, MAX_APDU, 0, 0, 0);
+
+    /* by time, newer than the reference going forward, older going back */
+    set_time_range(&range, tA, 10);
+    ok &= read_range_case(report, "time_after_a", &range, MAX_APDU, 4, FLAG_LAST, 6);
+    set_time_range(&range, tB, -10);
+    ok &= read_range_case(report, "time_before_b", &range, MAX_APDU, 2, FLAG_FIRST, 4);
+    set_time_range(&range, tA - 3600, 3);
+    ok &= read_range_case(report, "time_from_past", &range, MAX_APDU, 3, FLAG_FIRST, 4);
+    set_time_range(&range, tB + 3600, -2);
+    ok &= read_range_case(report, "time_from_future", &range, MAX_APDU, 2, FLAG_LAST, 8);
+    set_time_range(&range, tB, 1);
+    ok &= read_range_case(report, "time_none_newer", &range, MAX_APDU, 0, 0, 0);
+
+    /* room for two and a half records, MORE_ITEMS and the records nearest the reference */
+    set_range(&range, RR_READ_ALL, 0, 0);
+    (void)read_range(&range, MAX_APDU, &result);
+    record_len = result.data_len / TEST_BUFFER_SIZE;
+    small = TEST_RR_OVERHEAD + 2 * record_len + record_len / 2;
+
+    set_range(&range, RR_BY_POSITION, 1, TEST_BUFFER_SIZE);
+    ok &= read_range_case(report, "more_forward", &range, small, 2, FLAG_FIRST | FLAG_MORE, 0);
+    set_range(&range, RR_BY_SEQUENCE, 9, -TEST_BUFFER_SIZE);
+    ok &= read_range_case(report, "more_back", &range, small, 2, FLAG_LAST | FLAG_MORE, 8);
+
+    /* Count 0 is a malformed request, not an empty reply */
+    set_range(&range, RR_BY_POSITION, 1, 0);
+    if (read_range(&range, MAX_APDU, &result) == OK) {
+        if (!opt.json) {
+            printf("%-20s accepted FAIL\r\n", "count_zero");
+        }
+        ok = false;
+    }
+
+    return ok;
+}
+
+/* continues from the wrapped log of test_wrapped_log, 9 records written, 6 held */
+static bool test_stop_when_full(cJSON *report)
+{
+    RR_RANGE range;
+    uint32_t set, set_enable, set_total, stopped_total, reenabled;
+    uint32_t purged, enabled, full_enable, full_records, full_total;
+    bool ok;
+
+    /* set on a full log, the log disabled record takes the place of the oldest */
+    set = write_boolean(PROP_STOP_WHEN_FULL, true);
+    set_enable = read_enable();
+    set_total = read_unsigned(PROP_TOTAL_RECORD_COUNT);
+    acquire(1);
+    stopped_total = read_unsigned(PROP_TOTAL_RECORD_COUNT);
+    reenabled = write_boolean(PROP_ENABLE, true);
+
+    cJSON_AddNumberToObject(report, "swf_set_enable", set_enable);
+    cJSON_AddNumberToObject(report, "swf_set_total", set_total);
+    cJSON_AddNumberToObject(report, "swf_stopped_total", stopped_total);
+    cJSON_AddBoolToObject(report, "swf_enable_accepted", reenabled);
+    if (!opt.json) {
+        printf("%-20s %s, Enable %u, %u written, %u after acquire\r\n", "stop when full set",
+            set? "accepted": "refused", set_enable, set_total, stopped_total);
+        printf("%-20s %s\r\n", "enable while full", reenabled? "accepted": "refused");
+    }
+    ok = set && (set_enable == 0) && (set_total == 10) && (stopped_total == 10) && !reenabled;
+
+    set_range(&range, RR_BY_SEQUENCE, 10, -1);
+    ok &= read_range_case(report, "swf_disabled_rec", &range, MAX_APDU, 1, FLAG_LAST, 10);
+
+    /* purged (11) and enabled again (12), 3 data records and the disabled record fill it */
+    purged = write_unsigned(PROP_RECORD_COUNT, 0);
+    enabled = write_boolean(PROP_ENABLE, true);
+    acquire(TEST_BUFFER_SIZE);
+    full_enable = read_enable();
+    full_records = read_unsigned(PROP_RECORD_COUNT);
+    full_total = read_unsigned(PROP_TOTAL_RECORD_COUNT);
+
+    cJSON_AddNumberToObject(report, "swf_full_enable", full_enable);
+    cJSON_AddNumberToObject(report, "swf_full_records", full_records);
+    cJSON_AddNumberToObject(report, "swf_full_total", full_total);
+    if (!opt.json) {
+        printf("%-20s purge %s, enable %s\r\n", "after purge", purged? "accepted": "refused",
+            enabled? "accepted": "refused");
+        printf("%-20s Enable %u, %u records, %u written\r\n", "filled again", full_enable,
+            full_records, full_total);
+    }
+    ok &= purged && enabled && (full_enable == 0) && (full_records == TEST_BUFFER_SIZE)
+        && (full_total == 16);
+
+    set_range(&range, RR_BY_SEQUENCE, 11, TEST_BUFFER_SIZE + 1);
+    ok &= read_range_case(report, "swf_full_log", &range, MAX_APDU, TEST_BUFFER_SIZE,
+        FLAG_FIRST | FLAG_LAST, 11);
+
+    return ok;
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --json              print report as json\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"json", no_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'j': opt.json = true; break;
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    return OK;
+}
+
+int main(int argc, char *argv[])
+{
+    cJSON *cfg, *report;
+    char *str;
+    bool ok;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    /* the Count 0 request is refused with an error print */
+    app_set_dbg_level(0);
+
+    /* the acquisition timers are due in an hour, records are added by hand */
+    if ((el_loop_init(&el_default_loop) < 0) || (el_loop_start(&el_default_loop) < 0)) {
+        printf("el_loop_init failed\r\n");
+        return -EPERM;
+    }
+
+    cfg = create_object_cfg();
+    rv = object_init(cfg);
+    cJSON_Delete(cfg);
+    if (rv < 0) {
+        printf("object_init failed(%d)\r\n", rv);
+        return -EPERM;
+    }
+
+    tlm_object = object_find(OBJECT_TREND_LOG_MULTIPLE, 0);
+    if (tlm_object == NULL) {
+        printf("Trend Log Multiple 0 not found\r\n");
+        object_exit();
+        return -EPERM;
+    }
+
+    report = cJSON_CreateObject();
+
+    ok = test_wrapped_log(report);
+    ok &= test_stop_when_full(report);
+    cJSON_AddStringToObject(report, "result", ok? "pass": "fail");
+
+    if (opt.json) {
+        str = cJSON_Print(report);
+        if (str) {
+            printf("%s\r\n", str);
+            free(str);
+        }
+    } else {
+        printf("%-20s %s\r\n", "result", ok? "pass": "fail");
+    }
+
+    cJSON_Delete(report);
+    object_exit();
+
+    return ok? OK: -EPERM;
+}
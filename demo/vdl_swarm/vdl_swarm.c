@@ -0,0 +1,1157 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * vdl_swarm.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Device swarm simulator and load benchmark over the in-process virtual
+ * datalink. The stack runs as a router between two virtual buses:
+ *
+ *   bus swarm-a (net 1): simulated clients, mac 1 ~ clients
+ *   bus swarm-b (net 2): simulated devices, mac 1 ~ devices
+ *
+ * Modes:
+ *   rpm    - clients send ReadPropertyMultiple to the stack device
+ *   router - clients send ReadProperty to devices through the stack
+ *   tsm    - the stack sends ReadProperty to devices through the TSM
+ *   whois  - clients send global Who-Is, everybody answers I-Am; with --dup
+ *            every Who-Is is sent again as if by a redundant path
+ *
+ * History
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacnet.h"
+#include "bacnet/apdu.h"
+#include "bacnet/tsm.h"
+#include "bacnet/config.h"
+#include "bacnet/network.h"
+#include "bacnet/virtualdl.h"
+#include "bacnet/service/rp.h"
+#include "bacnet/service/rpm.h"
+#include "bacnet/service/iam.h"
+#include "misc/cJSON.h"
+#include "misc/eventloop.h"
+
+#define SWARM_BUS_CLIENT            "swarm-a"
+#define SWARM_BUS_DEVICE            "swarm-b"
+#define SWARM_NET_CLIENT            (1)
+#define SWARM_NET_DEVICE            (2)
+#define SWARM_ROUTER_MAC            (0)
+#define SWARM_STACK_DEVICE_ID       (4000000)
+#define SWARM_DEVICE_ID_BASE        (100000)
+#define SWARM_VENDOR_ID             (260)
+
+#define SWARM_FRAME_SIZE            (VDL_MAX_NPDU)
+#define SWARM_RX_BUDGET             (32)
+#define SWARM_MAX_EVENTS            (64)
+
+/* log-linear latency histogram, 16 sub-buckets per power of 2 */
+#define HIST_SUB_BITS               (4)
+#define HIST_SUB_COUNT              (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS                ((64 - HIST_SUB_BITS + 1) * HIST_SUB_COUNT)
+
+typedef enum {
+    SWARM_MODE_RPM = 0,
+    SWARM_MODE_ROUTER,
+    SWARM_MODE_TSM,
+    SWARM_MODE_WHOIS,
+} swarm_mode_t;
+
+typedef struct latency_hist_s {
+    uint64_t count;
+    uint64_t max;
+    uint64_t buckets[HIST_BUCKETS];
+} latency_hist_t;
+
+typedef struct sim_node_s {
+    vdl_endpoint_t *ep;
+    uint16_t mac;
+    uint8_t next_invoke;
+    uint16_t in_flight;
+    bool pending;
+    uint64_t sent_ns[256];
+} sim_node_t;
+
+typedef struct sim_side_s {
+    const char *bus;
+    sim_node_t *nodes;
+    uint32_t node_nums;
+    int epfd;
+    uint32_t *pending;
+    uint32_t pending_nums;
+    pthread_t thread;
+} sim_side_t;
+
+typedef struct npci_s {
+    bool der;
+    bool network_msg;
+    bool has_snet;
+    uint16_t snet;
+    uint8_t slen;
+    uint8_t sadr[7];
+} npci_t;
+
+static struct {
+    swarm_mode_t mode;
+    uint32_t devices;
+    uint32_t clients;
+    uint32_t objects;
+    uint32_t dev_objects;
+    uint32_t props;
+    uint32_t window;
+    uint32_t seconds;
+    uint32_t latency_us;
+    uint32_t loss_ppm;
+    uint32_t ring_size;
+    uint32_t timeout_ms;
+    uint32_t rate;
+    uint32_t dup;
+    int dedup_window;
+    uint32_t seed;
+} opt = {
+    .mode = SWARM_MODE_RPM,
+    .devices = 100,
+    .clients = 10,
+    .objects = 100,
+    .dev_objects = 10,
+    .props = 10,
+    .window = 1,
+    .seconds = 5,
+    .latency_us = 0,
+    .loss_ppm = 0,
+    .ring_size = 64,
+    .timeout_ms = 1000,
+    .rate = 100,
+    .dup = 0,
+    .dedup_window = -1,
+    .seed = 1,
+};
+
+static volatile bool running;
+static volatile bool measuring;
+
+static sim_side_t client_side = {.bus = SWARM_BUS_CLIENT};
+static sim_side_t device_side = {.bus = SWARM_BUS_DEVICE};
+
+static latency_hist_t client_hist;
+static latency_hist_t tsm_hist;
+
+static struct {
+    uint64_t sent;
+    uint64_t ok;
+    uint64_t error;
+    uint64_t timeout;
+    uint64_t iam;
+    uint64_t dev_rx;
+    uint64_t dev_tx;
+} stat;
+
+static pthread_mutex_t tsm_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tsm_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t tsm_outstanding;
+static uint64_t *tsm_sent_ns;
+
+static uint32_t rand_state;
+
+static uint32_t swarm_rand(void)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned hist_index(uint64_t v)
+{
+    unsigned msb;
+
+    if (v < HIST_SUB_COUNT) {
+        return (unsigned)v;
+    }
+
+    msb = 63 - __builtin_clzll(v);
+
+    return (msb - HIST_SUB_BITS + 1) * HIST_SUB_COUNT
+        + ((v >> (msb - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1));
+}
+
+static uint64_t hist_value(unsigned idx)
+{
+    unsigned shift;
+
+    if (idx < HIST_SUB_COUNT) {
+        return idx;
+    }
+
+    shift = idx / HIST_SUB_COUNT - 1;
+
+    return ((uint64_t)(HIST_SUB_COUNT + idx % HIST_SUB_COUNT) << shift)
+        + ((1ULL << shift) >> 1);
+}
+
+static void hist_record(latency_hist_t *hist, uint64_t v)
+{
+    if (!measuring) {
+        return;
+    }
+
+    hist->buckets[hist_index(v)]++;
+    hist->count++;
+    if (v > hist->max) {
+        hist->max = v;
+    }
+}
+
+static uint64_t hist_percentile(latency_hist_t *hist, double pct)
+{
+    uint64_t target, sum;
+    unsigned i;
+
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    target = (uint64_t)(hist->count * pct / 100.0);
+    if (target == 0) {
+        target = 1;
+    }
+
+    sum = 0;
+    for (i = 0; i < HIST_BUCKETS; i++) {
+        sum += hist->buckets[i];
+        if (sum >= target) {
+            return hist_value(i) < hist->max? hist_value(i): hist->max;
+        }
+    }
+
+    return hist->max;
+}
+
+static int npdu_encode(uint8_t *buf, uint16_t dnet, const uint8_t *dadr, uint8_t dlen, bool der)
+{
+    int len;
+
+    buf[0] = BACNET_PROTOCOL_VERSION;
+    buf[1] = der? 0x04: 0x00;
+    if (dnet == 0) {
+        return 2;
+    }
+
+    buf[1] |= 0x20;
+    buf[2] = dnet >> 8;
+    buf[3] = dnet & 0xff;
+    buf[4] = dlen;
+    len = 5;
+    if (dlen) {
+        memcpy(&buf[len], dadr, dlen);
+        len += dlen;
+    }
+    buf[len++] = 0xff;
+
+    return len;
+}
+
+static int npdu_decode(const uint8_t *pdu, int pdu_len, npci_t *npci)
+{
+    uint8_t control;
+    int len;
+
+    if ((pdu_len < 2) || (pdu[0] != BACNET_PROTOCOL_VERSION)) {
+        return -EINVAL;
+    }
+
+    control = pdu[1];
+    memset(npci, 0, sizeof(*npci));
+    npci->network_msg = (control & 0x80) != 0;
+    npci->der = (control & 0x04) != 0;
+    len = 2;
+
+    if (control & 0x20) {
+        if (len + 3 > pdu_len) {
+            return -EINVAL;
+        }
+        len += 3 + pdu[len + 2];
+    }
+
+    if (control & 0x08) {
+        if (len + 3 > pdu_len) {
+            return -EINVAL;
+        }
+        npci->has_snet = true;
+        npci->snet = ((uint16_t)pdu[len] << 8) | pdu[len + 1];
+        npci->slen = pdu[len + 2];
+        if ((npci->slen > sizeof(npci->sadr)) || (len + 3 + npci->slen > pdu_len)) {
+            return -EINVAL;
+        }
+        memcpy(npci->sadr, &pdu[len + 3], npci->slen);
+        len += 3 + npci->slen;
+    }
+
+    if (control & 0x20) {
+        len++;
+    }
+
+    if (len > pdu_len) {
+        return -EINVAL;
+    }
+
+    return len;
+}
+
+static void mac_to_adr(uint16_t mac, uint8_t *adr)
+{
+    adr[0] = mac >> 8;
+    adr[1] = mac & 0xff;
+}
+
+static int encode_iam_frame(uint8_t *frame, uint32_t device_id)
+{
+    DECLARE_BACNET_BUF(apdu, MAX_APDU);
+    int len;
+
+    len = npdu_encode(frame, BACNET_BROADCAST_NETWORK, NULL, 0, false);
+    (void)bacnet_buf_init(&apdu.buf, MAX_APDU);
+    Build_I_Am_Service(&apdu.buf, device_id, MAX_APDU, SWARM_VENDOR_ID, SEGMENTATION_NONE);
+    memcpy(&frame[len], apdu.buf.data, apdu.buf.data_len);
+
+    return len + apdu.buf.data_len;
+}
+
+/* a simulated device answers ReadProperty of Present_Value and Who-Is */
+static void device_handle_frame(sim_node_t *node, uint16_t src, uint8_t *pdu, int pdu_len)
+{
+    uint8_t frame[SWARM_FRAME_SIZE];
+    BACNET_OBJECT_TYPE type;
+    uint32_t instance, property;
+    uint32_t device_id;
+    npci_t npci;
+    uint8_t *apdu;
+    int apdu_len, len, rv;
+    uint8_t invoke_id;
+
+    rv = npdu_decode(pdu, pdu_len, &npci);
+    if ((rv < 0) || npci.network_msg) {
+        return;
+    }
+    apdu = pdu + rv;
+    apdu_len = pdu_len - rv;
+    if (apdu_len < 2) {
+        return;
+    }
+
+    __atomic_add_fetch(&stat.dev_rx, 1, __ATOMIC_RELAXED);
+    device_id = SWARM_DEVICE_ID_BASE + node->mac;
+
+    if ((apdu[0] >> 4) == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) {
+        if (apdu[1] != SERVICE_UNCONFIRMED_WHO_IS) {
+            return;
+        }
+        len = encode_iam_frame(frame, device_id);
+        if (vdl_endpoint_send(node->ep, VDL_BROADCAST_MAC, frame, len) == 0) {
+            __atomic_add_fetch(&stat.dev_tx, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+
+    if (((apdu[0] >> 4) != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) || (apdu_len < 4)) {
+        return;
+    }
+    invoke_id = apdu[2];
+
+    if (npci.has_snet) {
+        len = npdu_encode(frame, npci.snet, npci.sadr, npci.slen, false);
+    } else {
+        len = npdu_encode(frame, 0, NULL, 0, false);
+    }
+
+    if (apdu[3] != SERVICE_CONFIRMED_READ_PROPERTY) {
+        frame[len++] = PDU_TYPE_REJECT << 4;
+        frame[len++] = invoke_id;
+        frame[len++] = REJECT_REASON_UNRECOGNIZED_SERVICE;
+        goto send;
+    }
+
+    rv = decode_context_object_id(&apdu[4], 0, &type, &instance);
+    if (rv < 0) {
+        return;
+    }
+    if (decode_context_enumerated(&apdu[4 + rv], 1, &property) < 0) {
+        return;
+    }
+
+    if ((type != OBJECT_ANALOG_VALUE) || (instance >= opt.dev_objects)
+            || (property != PROP_PRESENT_VALUE)) {
+        frame[len++] = PDU_TYPE_ERROR << 4;
+        frame[len++] = invoke_id;
+        frame[len++] = SERVICE_CONFIRMED_READ_PROPERTY;
+        len += encode_application_enumerated(&frame[len], ERROR_CLASS_OBJECT);
+        len += encode_application_enumerated(&frame[len], ERROR_CODE_UNKNOWN_OBJECT);
+        goto send;
+    }
+
+    frame[len++] = PDU_TYPE_COMPLEX_ACK << 4;
+    frame[len++] = invoke_id;
+    frame[len++] = SERVICE_CONFIRMED_READ_PROPERTY;
+    len += encode_context_object_id(&frame[len], 0, type, instance);
+    len += encode_context_enumerated(&frame[len], 1, property);
+    len += encode_opening_tag(&frame[len], 3);
+    len += encode_application_real(&frame[len], instance * 1.5f);
+    len += encode_closing_tag(&frame[len], 3);
+
+send:
+    if (vdl_endpoint_send(node->ep, src, frame, len) == 0) {
+        __atomic_add_fetch(&stat.dev_tx, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void client_handle_frame(sim_node_t *node, uint8_t *pdu, int pdu_len)
+{
+    npci_t npci;
+    uint8_t *apdu;
+    uint8_t type;
+    int rv;
+
+    rv = npdu_decode(pdu, pdu_len, &npci);
+    if ((rv < 0) || npci.network_msg || (pdu_len - rv < 2)) {
+        return;
+    }
+    apdu = pdu + rv;
+    type = apdu[0] >> 4;
+
+    if (type == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) {
+        if ((apdu[1] == SERVICE_UNCONFIRMED_I_AM) && measuring) {
+            stat.iam++;
+        }
+        return;
+    }
+
+    if ((type != PDU_TYPE_SIMPLE_ACK) && (type != PDU_TYPE_COMPLEX_ACK)
+            && (type != PDU_TYPE_ERROR) && (type != PDU_TYPE_REJECT)
+            && (type != PDU_TYPE_ABORT)) {
+        return;
+    }
+
+    if (node->sent_ns[apdu[1]] == 0) {
+        return;                 /* late reply of a timed out request */
+    }
+
+    hist_record(&client_hist, now_ns() - node->sent_ns[apdu[1]]);
+    node->sent_ns[apdu[1]] = 0;
+    node->in_flight--;
+
+    if (!measuring) {
+        return;
+    }
+
+    if ((type == PDU_TYPE_SIMPLE_ACK) || (type == PDU_TYPE_COMPLEX_ACK)) {
+        stat.ok++;
+    } else {
+        stat.error++;
+    }
+}
+
+static int client_encode_request(uint8_t *frame, uint8_t invoke_id)
+{
+    DECLARE_BACNET_BUF(apdu, MAX_APDU);
+    uint8_t dadr[2];
+    uint32_t first, i;
+    uint16_t mac;
+    int len;
+
+    (void)bacnet_buf_init(&apdu.buf, MAX_APDU);
+
+    if (opt.mode == SWARM_MODE_RPM) {
+        len = npdu_encode(frame, 0, NULL, 0, true);
+        first = swarm_rand() % opt.objects;
+        for (i = 0; i < opt.props; i++) {
+            (void)rpm_req_encode_object(&apdu.buf, OBJECT_ANALOG_VALUE, (first + i) % opt.objects);
+            (void)rpm_req_encode_property(&apdu.buf, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        }
+        if (!rpm_req_encode_end(&apdu.buf, invoke_id)) {
+            return -EPERM;
+        }
+    } else {
+        mac = 1 + swarm_rand() % opt.devices;
+        mac_to_adr(mac, dadr);
+        len = npdu_encode(frame, SWARM_NET_DEVICE, dadr, sizeof(dadr), true);
+        if (rp_encode_apdu(&apdu.buf, invoke_id, OBJECT_ANALOG_VALUE,
+                swarm_rand() % opt.dev_objects, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL) < 0) {
+            return -EPERM;
+        }
+    }
+
+    memcpy(&frame[len], apdu.buf.data, apdu.buf.data_len);
+
+    return len + apdu.buf.data_len;
+}
+
+static void client_fill_window(sim_node_t *node, uint64_t now)
+{
+    uint8_t frame[SWARM_FRAME_SIZE];
+    uint8_t invoke_id;
+    int len;
+
+    while (node->in_flight < opt.window) {
+        invoke_id = node->next_invoke;
+        while (node->sent_ns[invoke_id] != 0) {
+            invoke_id++;
+        }
+        node->next_invoke = invoke_id + 1;
+
+        len = client_encode_request(frame, invoke_id);
+        if (len < 0) {
+            return;
+        }
+
+        if (vdl_endpoint_send(node->ep, SWARM_ROUTER_MAC, frame, len) < 0) {
+            return;
+        }
+
+        node->sent_ns[invoke_id] = now? now: 1;
+        node->in_flight++;
+        if (measuring) {
+            stat.sent++;
+        }
+    }
+}
+
+static void client_check_timeout(sim_node_t *node, uint64_t now)
+{
+    uint64_t limit;
+    unsigned i;
+
+    if (node->in_flight == 0) {
+        return;
+    }
+
+    limit = (uint64_t)opt.timeout_ms * 1000000ULL;
+    for (i = 0; i < 256; i++) {
+        if (node->sent_ns[i] && (now - node->sent_ns[i] > limit)) {
+            node->sent_ns[i] = 0;
+            node->in_flight--;
+            if (measuring) {
+                stat.timeout++;
+            }
+        }
+    }
+}
+
+static void side_drain(sim_side_t *side, uint32_t idx)
+{
+    uint8_t pdu[SWARM_FRAME_SIZE];
+    sim_node_t *node;
+    uint16_t src;
+    int budget, len;
+
+    node = &side->nodes[idx];
+    for (budget = SWARM_RX_BUDGET; budget > 0; budget--) {
+        len = vdl_endpoint_recv(node->ep, &src, pdu, sizeof(pdu));
+        if (len <= 0) {
+            break;
+        }
+
+        if (side == &device_side) {
+            device_handle_frame(node, src, pdu, len);
+        } else {
+            client_handle_frame(node, pdu, len);
+        }
+    }
+
+    if (!node->pending && (vdl_endpoint_next_due(node->ep) >= 0)) {
+        node->pending = true;
+        side->pending[side->pending_nums++] = idx;
+    }
+}
+
+static void *side_thread(void *arg)
+{
+    struct epoll_event events[SWARM_MAX_EVENTS];
+    sim_side_t *side;
+    sim_node_t *node;
+    uint64_t now, next_check, next_whois, whois_gap;
+    uint32_t i, j, nums, idx, rr;
+    uint8_t frame[16];
+    int n, len;
+
+    side = (sim_side_t *)arg;
+    next_check = now_ns();
+    next_whois = next_check;
+    whois_gap = 1000000000ULL / (opt.rate? opt.rate: 1);
+    rr = 0;
+
+    while (running) {
+        n = epoll_wait(side->epfd, events, SWARM_MAX_EVENTS, side->pending_nums? 0: 1);
+        for (i = 0; i < (uint32_t)(n > 0? n: 0); i++) {
+            node = (sim_node_t *)events[i].data.ptr;
+            vdl_endpoint_ack(node->ep);
+            side_drain(side, node - side->nodes);
+        }
+
+        /* frames held back by the latency profile, or left over by the budget */
+        nums = side->pending_nums;
+        side->pending_nums = 0;
+        for (i = 0; i < nums; i++) {
+            idx = side->pending[i];
+            side->nodes[idx].pending = false;
+            side_drain(side, idx);
+        }
+
+        if (side != &client_side) {
+            continue;
+        }
+
+        now = now_ns();
+        if (opt.mode == SWARM_MODE_WHOIS) {
+            while (next_whois <= now) {
+                /* a distinct high limit per request, still covering every device */
+                len = npdu_encode(frame, BACNET_BROADCAST_NETWORK, NULL, 0, false);
+                frame[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST << 4;
+                frame[len++] = SERVICE_UNCONFIRMED_WHO_IS;
+                len += encode_context_unsigned(&frame[len], 0, 0);
+                len += encode_context_unsigned(&frame[len], 1, BACNET_MAX_INSTANCE - (rr & 0xFFFF));
+                node = &side->nodes[rr++ % side->node_nums];
+                for (j = 0; j <= opt.dup; j++) {
+                    if ((vdl_endpoint_send(node->ep, VDL_BROADCAST_MAC, frame, len) == 0)
+                            && measuring) {
+                        stat.sent++;
+                    }
+                }
+                next_whois += whois_gap;
+            }
+            continue;
+        }
+
+        for (i = 0; i < side->node_nums; i++) {
+            client_fill_window(&side->nodes[i], now);
+        }
+
+        if (now >= next_check) {
+            for (i = 0; i < side->node_nums; i++) {
+                client_check_timeout(&side->nodes[i], now);
+            }
+            next_check = now + 10000000ULL;
+        }
+    }
+
+    return NULL;
+}
+
+static int side_create(sim_side_t *side, uint32_t nums)
+{
+    struct epoll_event ev;
+    sim_node_t *node;
+    uint32_t i;
+
+    side->node_nums = nums;
+    side->nodes = (sim_node_t *)calloc(nums? nums: 1, sizeof(sim_node_t));
+    side->pending = (uint32_t *)calloc(nums? nums: 1, sizeof(uint32_t));
+    side->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if ((side->nodes == NULL) || (side->pending == NULL) || (side->epfd < 0)) {
+        printf("%s: out of resource\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < nums; i++) {
+        node = &side->nodes[i];
+        node->mac = i + 1;
+        node->ep = vdl_endpoint_create(side->bus, node->mac, opt.ring_size);
+        if (node->ep == NULL) {
+            printf("%s: create endpoint %s:%d failed\r\n", __func__, side->bus, node->mac);
+            return -EPERM;
+        }
+        vdl_endpoint_set_profile(node->ep, opt.latency_us, opt.loss_ppm);
+
+        ev.events = EPOLLIN;
+        ev.data.ptr = node;
+        if (epoll_ctl(side->epfd, EPOLL_CTL_ADD, vdl_endpoint_fd(node->ep), &ev) < 0) {
+            printf("%s: epoll_ctl failed cause %s\r\n", __func__, strerror(errno));
+            return -EPERM;
+        }
+    }
+
+    return OK;
+}
+
+static void side_destroy(sim_side_t *side)
+{
+    uint32_t i;
+
+    for (i = 0; i < side->node_nums; i++) {
+        vdl_endpoint_destroy(side->nodes[i].ep);
+    }
+
+    if (side->epfd >= 0) {
+        close(side->epfd);
+    }
+    free(side->nodes);
+    free(side->pending);
+}
+
+static uint64_t side_drops(sim_side_t *side)
+{
+    uint64_t drops;
+    uint32_t i;
+
+    drops = 0;
+    for (i = 0; i < side->node_nums; i++) {
+        drops += vdl_endpoint_drops(side->nodes[i].ep);
+    }
+
+    return drops;
+}
+
+static void tsm_ack_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu,
+                BACNET_PDU_TYPE apdu_type)
+{
+    uint64_t *sent;
+    uint16_t mac;
+
+    mac = ((uint16_t)invoker->addr.adr[0] << 8) | invoker->addr.adr[1];
+    sent = &tsm_sent_ns[(mac - 1) * 256 + invoker->invokeID];
+
+    if (apdu == NULL) {
+        if (measuring) {
+            stat.timeout++;
+        }
+    } else {
+        hist_record(&tsm_hist, now_ns() - *sent);
+        if (measuring) {
+            if ((apdu_type == PDU_TYPE_SIMPLE_ACK) || (apdu_type == PDU_TYPE_COMPLEX_ACK)) {
+                stat.ok++;
+            } else {
+                stat.error++;
+            }
+        }
+    }
+
+    tsm_free_invokeID(invoker);
+
+    pthread_mutex_lock(&tsm_mutex);
+    tsm_outstanding--;
+    pthread_cond_signal(&tsm_cond);
+    pthread_mutex_unlock(&tsm_mutex);
+}
+
+static void tsm_drive(uint64_t end)
+{
+    DECLARE_BACNET_BUF(tx_apdu, MIN_APDU);
+    bacnet_addr_t dst;
+    tsm_invoker_t *invoker;
+    uint16_t mac;
+    uint32_t rr;
+
+    dst.net = SWARM_NET_DEVICE;
+    dst.len = 2;
+    rr = 0;
+
+    while (now_ns() < end) {
+        pthread_mutex_lock(&tsm_mutex);
+        while (tsm_outstanding >= opt.window) {
+            pthread_cond_wait(&tsm_cond, &tsm_mutex);
+        }
+        tsm_outstanding++;
+        pthread_mutex_unlock(&tsm_mutex);
+
+        mac = 1 + rr++ % opt.devices;
+        mac_to_adr(mac, dst.adr);
+
+        /* hold the loop, or the ack may come before the invoker timer is armed */
+        el_sync(&el_default_loop);
+        invoker = tsm_alloc_invokeID(&dst, SERVICE_CONFIRMED_READ_PROPERTY, tsm_ack_handler, NULL);
+        if (invoker == NULL) {
+            el_unsync(&el_default_loop);
+            pthread_mutex_lock(&tsm_mutex);
+            tsm_outstanding--;
+            pthread_mutex_unlock(&tsm_mutex);
+            sched_yield();
+            continue;
+        }
+
+        (void)bacnet_buf_init(&tx_apdu.buf, MIN_APDU);
+        (void)rp_encode_apdu(&tx_apdu.buf, invoker->invokeID, OBJECT_ANALOG_VALUE,
+            swarm_rand() % opt.dev_objects, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        tsm_sent_ns[(mac - 1) * 256 + invoker->invokeID] = now_ns();
+        if (measuring) {
+            stat.sent++;
+        }
+
+        if (tsm_send_apdu(invoker, &tx_apdu.buf, PRIORITY_NORMAL, 0) < 0) {
+            tsm_free_invokeID(invoker);
+            pthread_mutex_lock(&tsm_mutex);
+            tsm_outstanding--;
+            pthread_mutex_unlock(&tsm_mutex);
+            if (measuring) {
+                stat.error++;
+            }
+        }
+        el_unsync(&el_default_loop);
+    }
+
+    /* wait in-flight requests */
+    pthread_mutex_lock(&tsm_mutex);
+    while (tsm_outstanding) {
+        pthread_cond_wait(&tsm_cond, &tsm_mutex);
+    }
+    pthread_mutex_unlock(&tsm_mutex);
+}
+
+cJSON *bacnet_get_resource_cfg(void)
+{
+    cJSON *cfg, *res;
+
+    cfg = cJSON_CreateObject();
+
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "VIRTUAL");
+    cJSON_AddStringToObject(res, "ifname", SWARM_BUS_CLIENT);
+    cJSON_AddItemToObject(cfg, "vbus-a", res);
+
+    res = cJSON_CreateObject();
+    cJSON_AddStringToObject(res, "type", "VIRTUAL");
+    cJSON_AddStringToObject(res, "ifname", SWARM_BUS_DEVICE);
+    cJSON_AddItemToObject(cfg, "vbus-b", res);
+
+    return cfg;
+}
+
+static cJSON *create_port_cfg(uint16_t net, const char *resource)
+{
+    cJSON *port;
+
+    port = cJSON_CreateObject();
+    cJSON_AddTrueToObject(port, "enable");
+    cJSON_AddNumberToObject(port, "net_num", net);
+    cJSON_AddStringToObject(port, "dl_type", "VIRTUAL");
+    cJSON_AddStringToObject(port, "resource_name", resource);
+    cJSON_AddNumberToObject(port, "mac", SWARM_ROUTER_MAC);
+    cJSON_AddNumberToObject(port, "ring_size", 4096);
+    cJSON_AddNumberToObject(port, "latency_us", opt.latency_us);
+    cJSON_AddNumberToObject(port, "loss_ppm", opt.loss_ppm);
+
+    return port;
+}
+
+cJSON *bacnet_get_network_cfg(void)
+{
+    cJSON *cfg, *ports, *dedup;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddItemToObject(cfg, "route_table", cJSON_CreateArray());
+
+    if (opt.dedup_window >= 0) {
+        dedup = cJSON_CreateObject();
+        cJSON_AddBoolToObject(dedup, "enable", opt.dedup_window > 0);
+        if (opt.dedup_window > 0) {
+            cJSON_AddNumberToObject(dedup, "window", opt.dedup_window);
+        }
+        cJSON_AddItemToObject(cfg, "broadcast_dedup", dedup);
+    }
+
+    ports = cJSON_CreateArray();
+    cJSON_AddItemToArray(ports, create_port_cfg(SWARM_NET_CLIENT, "vbus-a"));
+    cJSON_AddItemToArray(ports, create_port_cfg(SWARM_NET_DEVICE, "vbus-b"));
+    cJSON_AddItemToObject(cfg, "port", ports);
+
+    return cfg;
+}
+
+cJSON *bacnet_get_app_cfg(void)
+{
+    cJSON *cfg, *tsm, *objects, *av, *list, *instance;
+    char name[32];
+    uint32_t i;
+
+    cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "Device_Id", SWARM_STACK_DEVICE_ID);
+    cJSON_AddStringToObject(cfg, "Device_Name", "swarm router");
+
+    tsm = cJSON_CreateObject();
+    cJSON_AddNumberToObject(tsm, "Max_Peer", opt.devices + 100);
+    cJSON_AddNumberToObject(tsm, "Max_Invoker", opt.window + 100);
+    cJSON_AddNumberToObject(tsm, "APDU_Timeout", opt.timeout_ms);
+    cJSON_AddItemToObject(cfg, "TSM", tsm);
+
+    list = cJSON_CreateArray();
+    for (i = 0; i < opt.objects; i++) {
+        instance = cJSON_CreateObject();
+        snprintf(name, sizeof(name), "AV%u", i);
+        cJSON_AddStringToObject(instance, "Name", name);
+        cJSON_AddFalseToObject(instance, "Out_Of_Service");
+        cJSON_AddNumberToObject(instance, "Units", UNITS_NO_UNITS);
+        cJSON_AddItemToArray(list, instance);
+    }
+
+    av = cJSON_CreateObject();
+    cJSON_AddStringToObject(av, "Type", "AV");
+    cJSON_AddItemToObject(av, "Instance_List", list);
+
+    objects = cJSON_CreateArray();
+    cJSON_AddItemToArray(objects, av);
+    cJSON_AddItemToObject(cfg, "Object_List", objects);
+
+    return cfg;
+}
+
+static void print_port_mib(void)
+{
+    datalink_vdl_t *vdl;
+    cJSON *request, *mib;
+    char *str;
+
+    for (vdl = vdl_next_port(NULL); vdl; vdl = vdl_next_port(vdl)) {
+        request = cJSON_CreateObject();
+        cJSON_AddNumberToObject(request, "port_id", vdl->dl.port_id);
+        mib = network_get_port_mib(NULL, request);
+        cJSON_Delete(request);
+        if (mib == NULL) {
+            continue;
+        }
+        str = cJSON_PrintUnformatted(mib);
+        printf("port %u: %s\r\n", vdl->dl.port_id, str? str: "");
+        free(str);
+        cJSON_Delete(mib);
+    }
+}
+
+static void print_report(double seconds)
+{
+    static const char *mode_name[] = {"rpm", "router", "tsm", "whois"};
+    latency_hist_t *hist;
+
+    hist = (opt.mode == SWARM_MODE_TSM)? &tsm_hist: &client_hist;
+
+    printf("\r\nmode: %s, devices: %u, clients: %u, objects: %u, window: %u, seconds: %.2f\r\n",
+        mode_name[opt.mode], opt.devices, opt.clients, opt.objects, opt.window, seconds);
+    printf("latency_us: %u, loss_ppm: %u, ring_size: %u\r\n", opt.latency_us, opt.loss_ppm,
+        opt.ring_size);
+    printf("sent: %llu, ok: %llu, error: %llu, timeout: %llu\r\n",
+        (unsigned long long)stat.sent, (unsigned long long)stat.ok,
+        (unsigned long long)stat.error, (unsigned long long)stat.timeout);
+
+    if (opt.mode == SWARM_MODE_WHOIS) {
+        printf("who-is/s: %.1f, i-am received/s: %.1f\r\n", stat.sent / seconds,
+            stat.iam / seconds);
+    } else {
+        printf("throughput: %.1f req/s\r\n", (stat.ok + stat.error) / seconds);
+        printf("latency(us): p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\r\n",
+            hist_percentile(hist, 50) / 1000.0, hist_percentile(hist, 90) / 1000.0,
+            hist_percentile(hist, 99) / 1000.0, hist_percentile(hist, 99.9) / 1000.0,
+            hist->max / 1000.0);
+    }
+
+    printf("device rx: %llu, device tx: %llu\r\n", (unsigned long long)stat.dev_rx,
+        (unsigned long long)stat.dev_tx);
+    printf("ring drops: clients %llu, devices %llu\r\n",
+        (unsigned long long)side_drops(&client_side),
+        (unsigned long long)side_drops(&device_side));
+    print_port_mib();
+}
+
+static void usage(const char *prog)
+{
+    printf("\r\n[Usage]:\r\n"
+        "%s [options]\r\n"
+        "  --mode rpm|router|tsm|whois   load pattern (rpm)\r\n"
+        "  --devices N                   simulated devices on net 2 (100)\r\n"
+        "  --clients N                   simulated clients on net 1 (10)\r\n"
+        "  --objects N                   AV objects in the stack device (100)\r\n"
+        "  --dev-objects N               AV objects in each simulated device (10)\r\n"
+        "  --props N                     objects read by one RPM request (10)\r\n"
+        "  --window N                    outstanding requests per client, total for tsm (1)\r\n"
+        "  --seconds N                   measure duration (5)\r\n"
+        "  --latency US                  link latency in microsecond (0)\r\n"
+        "  --loss PPM                    frame loss per million (0)\r\n"
+        "  --ring N                      rx ring slots of simulated nodes (64)\r\n"
+        "  --timeout MS                  request timeout (1000)\r\n"
+        "  --rate N                      who-is per second in whois mode (100)\r\n"
+        "  --dup N                       extra copies of each who-is in whois mode (0)\r\n"
+        "  --dedup-window MS             broadcast dedup window of the router, 0 off\r\n"
+        "  --seed N                      random seed (1)\r\n\r\n", prog);
+}
+
+static int parse_args(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        {"mode", required_argument, NULL, 'm'},
+        {"devices", required_argument, NULL, 'd'},
+        {"clients", required_argument, NULL, 'c'},
+        {"objects", required_argument, NULL, 'o'},
+        {"dev-objects", required_argument, NULL, 'O'},
+        {"props", required_argument, NULL, 'p'},
+        {"window", required_argument, NULL, 'w'},
+        {"seconds", required_argument, NULL, 's'},
+        {"latency", required_argument, NULL, 'l'},
+        {"loss", required_argument, NULL, 'L'},
+        {"ring", required_argument, NULL, 'r'},
+        {"timeout", required_argument, NULL, 't'},
+        {"rate", required_argument, NULL, 'R'},
+        {"dup", required_argument, NULL, 'D'},
+        {"dedup-window", required_argument, NULL, 'W'},
+        {"seed", required_argument, NULL, 'S'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (c) {
+        case 'm':
+            if (strcmp(optarg, "rpm") == 0) {
+                opt.mode = SWARM_MODE_RPM;
+            } else if (strcmp(optarg, "router") == 0) {
+                opt.mode = SWARM_MODE_ROUTER;
+            } else if (strcmp(optarg, "tsm") == 0) {
+                opt.mode = SWARM_MODE_TSM;
+            } else if (strcmp(optarg, "whois") == 0) {
+                opt.mode = SWARM_MODE_WHOIS;
+            } else {
+                printf("invalid mode: %s\r\n", optarg);
+                return -EINVAL;
+            }
+            break;
+
+        case 'd': opt.devices = strtoul(optarg, NULL, 0); break;
+        case 'c': opt.clients = strtoul(optarg, NULL, 0); break;
+        case 'o': opt.objects = strtoul(optarg, NULL, 0); break;
+        case 'O': opt.dev_objects = strtoul(optarg, NULL, 0); break;
+        case 'p': opt.props = strtoul(optarg, NULL, 0); break;
+        case 'w': opt.window = strtoul(optarg, NULL, 0); break;
+        case 's': opt.seconds = strtoul(optarg, NULL, 0); break;
+        case 'l': opt.latency_us = strtoul(optarg, NULL, 0); break;
+        case 'L': opt.loss_ppm = strtoul(optarg, NULL, 0); break;
+        case 'r': opt.ring_size = strtoul(optarg, NULL, 0); break;
+        case 't': opt.timeout_ms = strtoul(optarg, NULL, 0); break;
+        case 'R': opt.rate = strtoul(optarg, NULL, 0); break;
+        case 'D': opt.dup = strtoul(optarg, NULL, 0); break;
+        case 'W': opt.dedup_window = atoi(optarg); break;
+        case 'S': opt.seed = strtoul(optarg, NULL, 0); break;
+
+        default:
+            usage(argv[0]);
+            return -EINVAL;
+        }
+    }
+
+    if ((opt.devices == 0) || (opt.devices > VDL_MAX_MAC) || (opt.clients == 0)
+            || (opt.clients > VDL_MAX_MAC) || (opt.objects == 0) || (opt.dev_objects == 0)
+            || (opt.props == 0) || (opt.window == 0) || (opt.window > 255)
+            || (opt.seconds == 0) || (opt.loss_ppm > 1000000) || (opt.dup > 16)
+            || (opt.dedup_window > 60000)) {
+        printf("invalid argument\r\n");
+        return -EINVAL;
+    }
+
+    rand_state = opt.seed? opt.seed: 1;
+
+    return OK;
+}
+
+/* ./vdl_swarm --mode rpm --clients 10 --objects 1000 --window 4 */
+int main(int argc, char *argv[])
+{
+    uint64_t start, end;
+    int rv;
+
+    if (parse_args(argc, argv) < 0) {
+        return -EINVAL;
+    }
+
+    tsm_sent_ns = (uint64_t *)calloc((size_t)opt.devices * 256, sizeof(uint64_t));
+    if (tsm_sent_ns == NULL) {
+        printf("not enough memory\r\n");
+        return -ENOMEM;
+    }
+
+    rv = bacnet_init();
+    if (rv < 0) {
+        printf("bacnet init failed(%d)\r\n", rv);
+        return rv;
+    }
+
+    apdu_set_default_service_handler();
+
+    rv = side_create(&client_side, opt.clients);
+    if (rv < 0) {
+        goto out0;
+    }
+
+    rv = side_create(&device_side, opt.devices);
+    if (rv < 0) {
+        goto out0;
+    }
+
+    rv = el_loop_start(&el_default_loop);
+    if (rv < 0) {
+        printf("el loop start failed(%d)\r\n", rv);
+        goto out0;
+    }
+
+    running = true;
+    if (pthread_create(&device_side.thread, NULL, side_thread, &device_side)
+            || ((opt.mode != SWARM_MODE_TSM)
+                && pthread_create(&client_side.thread, NULL, side_thread, &client_side))) {
+        printf("create simulator thread failed\r\n");
+        running = false;
+        rv = -EPERM;
+        goto out0;
+    }
+
+    /* warm up: routes and address bindings get learned */
+    usleep(200000);
+    measuring = true;
+    start = now_ns();
+    end = start + (uint64_t)opt.seconds * 1000000000ULL;
+
+    if (opt.mode == SWARM_MODE_TSM) {
+        tsm_drive(end);
+    } else {
+        while (now_ns() < end) {
+            usleep(10000);
+        }
+    }
+
+    measuring = false;
+    end = now_ns();
+    running = false;
+
+    (void)pthread_join(device_side.thread, NULL);
+    if (opt.mode != SWARM_MODE_TSM) {
+        (void)pthread_join(client_side.thread, NULL);
+    }
+
+    print_report((end - start) / 1e9);
+    rv = OK;
+
+out0:
+    bacnet_exit();
+    side_destroy(&client_side);
+    side_destroy(&device_side);
+    free(tsm_sent_ns);
+
+    return rv;
+}
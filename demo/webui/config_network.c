@@ -130,6 +130,7 @@ static const char *conf_network_init_port(cJSON *cfg, cJSON *port, const char *l
         cJSON_AddFalseToObject(proxy, "auto_discovery");
         cJSON_AddItemToObject(proxy, "discovery_nodes", cJSON_CreateArray());
         cJSON_AddNumberToObject(proxy, "scan_interval", 300);
+        cJSON_AddNumberToObject(proxy, "max_probes", 8);
         cJSON_AddItemToObject(proxy, "manual_binding", cJSON_CreateArray());
     } else if (strcmp(tmp->valuestring, "BIP") == 0) {
         if (strcmp(res_type, "ETH")) {
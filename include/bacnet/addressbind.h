@@ -72,6 +72,12 @@ extern int address_init(cJSON *cfg);
 
 extern void address_exit(void);
 
+/*
+ * address_save_cache - ̬󶨼䱣浽Cache_Fileδʱֱӷ
+ * @return: ɹ0򷵻ظ
+ */
+extern int address_save_cache(void);
+
 extern void whois_destroy(void);
 
 extern cJSON *get_address_binding(void);
@@ -18,6 +18,7 @@
 
 #include "misc/cJSON.h"
 #include "connect_mng.h"
+#include "misc/trace.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -31,21 +32,21 @@ extern bool app_dbg_verbos;
 #define APP_ERROR(fmt, args...)                     \
 do {                                                \
     if (app_dbg_err) {                              \
-        printf(fmt, ##args);                        \
+        TRACE_ERROR(fmt, ##args);                   \
     }                                               \
 } while (0)
 
 #define APP_WARN(fmt, args...)                      \
 do {                                                \
     if (app_dbg_warn) {                             \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define APP_VERBOS(fmt, args...)                    \
 do {                                                \
     if (app_dbg_verbos) {                           \
-        printf(fmt, ##args);                        \
+        TRACE_VERBOS(fmt, ##args);                  \
     }                                               \
 } while (0)
 
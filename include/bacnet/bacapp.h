@@ -99,7 +99,7 @@ extern int bacapp_decode_application_data(uint8_t *pdu, uint16_t max_pdu_len,
 
 extern void bacapp_fprint_value(FILE *stream, uint8_t *buf, uint32_t size);
 
-extern bool bacapp_parse_application_data(bacnet_buf_t *pdu, char *argv);
+extern bool bacapp_parse_application_data(bacnet_buf_t *pdu, const char *argv);
 
 extern bool bacapp_snprint_value(char *str, size_t str_len, uint8_t *buf, uint32_t size);
 
@@ -68,11 +68,32 @@ static inline uint8_t get_tag_number(const uint8_t *apdu)
         return apdu[0] >> 4;
 }
 
-int decode_tag_number_and_value(
+int __decode_tag_number_and_value(
     const uint8_t * apdu,
     uint8_t * tag_number,
     uint32_t * value);
 
+/* from clause 20.2.1.3.2 Constructed Data */
+/* returns the number of apdu bytes consumed */
+/* one octet tags (number 0~14, length 0~4) are decoded inline, the rest out of line */
+static inline int decode_tag_number_and_value(
+    const uint8_t * apdu,
+    uint8_t * tag_number,
+    uint32_t * value)
+{
+    uint8_t tag = apdu[0];
+
+    if (!IS_EXTENDED_TAG_NUMBER(tag) && ((tag & 0x07) < 5)) {
+        if (tag_number)
+            *tag_number = tag >> 4;
+        if (value)
+            *value = tag & 0x07;
+        return 1;
+    }
+
+    return __decode_tag_number_and_value(apdu, tag_number, value);
+}
+
 /* from clause 20.2.1.3.2 Constructed Data */
 /* returns the number of apdu bytes consumed */
     int encode_opening_tag(
@@ -439,6 +460,37 @@ int decode_tag_number_and_value(
         uint32_t remaining_bytes,
         uint8_t tag_number);
 
+/* homogeneous arrays of application tagged values, see bacdcode.c */
+    struct BACnet_Object_Id;
+
+    int encode_application_real_array(
+        uint8_t * apdu,
+        const float *values,
+        uint32_t count);
+    int encode_application_unsigned_array(
+        uint8_t * apdu,
+        const uint32_t *values,
+        uint32_t count);
+    int encode_application_object_id_array(
+        uint8_t * apdu,
+        const struct BACnet_Object_Id *values,
+        uint32_t count);
+    int decode_application_real_array(
+        const uint8_t * apdu,
+        uint32_t apdu_len,
+        float *values,
+        uint32_t *count);
+    int decode_application_unsigned_array(
+        const uint8_t * apdu,
+        uint32_t apdu_len,
+        uint32_t *values,
+        uint32_t *count);
+    int decode_application_object_id_array(
+        const uint8_t * apdu,
+        uint32_t apdu_len,
+        struct BACnet_Object_Id *values,
+        uint32_t *count);
+
 #ifdef __cplusplus
 
 }
@@ -18,6 +18,8 @@
 #include <pthread.h>
 #include <string.h>
 
+#include "misc/trace.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -134,15 +136,30 @@ static inline bool address_equal(const bacnet_addr_t *src, const bacnet_addr_t *
     return memcmp(src, dst, &src->adr[src->len] - (uint8_t *)src) == 0;
 }
 
-#define PRINT_BACNET_ADDRESS(addr)                                      \
+/* "XX.XX." text of mac, buf is at least 3 * MAX_MAC_LEN + 1 */
+static inline const char *bacnet_mac_sprintf(char *buf, const bacnet_addr_t *addr)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    int i;
+
+    for (i = 0; (i < addr->len) && (i < MAX_MAC_LEN); i++) {
+        buf[i * 3] = hex[addr->adr[i] >> 4];
+        buf[i * 3 + 1] = hex[addr->adr[i] & 0x0F];
+        buf[i * 3 + 2] = '.';
+    }
+    buf[i * 3] = 0;
+
+    return buf;
+}
+
+#define TRACE_BACNET_ADDRESS(level, addr)                               \
 do {                                                                    \
-    int mac_len;                                                        \
-    printf("Net: %d, Len: %d, Mac(0X): ", (addr)->net, (addr)->len);    \
-    for (mac_len = 0; mac_len < (addr)->len; mac_len++) {               \
-        printf("%02X.", (addr)->adr[mac_len]);                          \
-    }                                                                   \
-    printf("\r\n");                                                     \
-} while (0)                             
+    char __mac_str[3 * MAX_MAC_LEN + 1];                                \
+    TRACE_PRINTF(level, "Net: %d, Len: %d, Mac(0X): %s\r\n", (addr)->net, \
+        (addr)->len, bacnet_mac_sprintf(__mac_str, (addr)));           \
+} while (0)
+
+#define PRINT_BACNET_ADDRESS(addr)  TRACE_BACNET_ADDRESS(DEBUG_LEVEL_VERBOS, addr)
 
 #ifdef __cplusplus
 }
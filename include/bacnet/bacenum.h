@@ -1234,6 +1234,62 @@ typedef enum {
     LOGGING_TYPE_TRIGGERED = 2
 } BACNET_LOGGING_TYPE;
 
+typedef enum {
+    EVENT_CHANGE_OF_BITSTRING = 0,
+    EVENT_CHANGE_OF_STATE = 1,
+    EVENT_CHANGE_OF_VALUE = 2,
+    EVENT_COMMAND_FAILURE = 3,
+    EVENT_FLOATING_LIMIT = 4,
+    EVENT_OUT_OF_RANGE = 5,
+    /*  complex-event-type (6), -- see comment below */
+    /*  event-buffer-ready   (7), -- context tag 7 is deprecated */
+    EVENT_CHANGE_OF_LIFE_SAFETY = 8,
+    EVENT_EXTENDED = 9,
+    EVENT_BUFFER_READY = 10,
+    EVENT_UNSIGNED_RANGE = 11,
+    MAX_BACNET_EVENT_TYPE = 12
+} BACNET_EVENT_TYPE;
+
+typedef enum {
+    NOTIFY_ALARM = 0,
+    NOTIFY_EVENT = 1,
+    NOTIFY_ACK_NOTIFICATION = 2,
+    MAX_NOTIFY_TYPE = 3
+} BACNET_NOTIFY_TYPE;
+
+typedef enum {
+    EVENT_LOW_LIMIT_ENABLE = 0,
+    EVENT_HIGH_LIMIT_ENABLE = 1
+} BACNET_LIMIT_ENABLE;
+
+typedef enum {
+    TIME_STAMP_TIME = 0,
+    TIME_STAMP_SEQUENCE = 1,
+    TIME_STAMP_DATETIME = 2
+} BACNET_TIMESTAMP_TAG;
+
+typedef enum {
+    PROP_STATE_BOOLEAN_VALUE = 0,
+    PROP_STATE_BINARY_VALUE = 1,
+    PROP_STATE_EVENT_TYPE = 2,
+    PROP_STATE_POLARITY = 3,
+    PROP_STATE_PROGRAM_CHANGE = 4,
+    PROP_STATE_PROGRAM_STATE = 5,
+    PROP_STATE_REASON_FOR_HALT = 6,
+    PROP_STATE_RELIABILITY = 7,
+    PROP_STATE_EVENT_STATE = 8,
+    PROP_STATE_SYSTEM_STATUS = 9,
+    PROP_STATE_UNITS = 10,
+    PROP_STATE_UNSIGNED_VALUE = 11,
+    PROP_STATE_LIFE_SAFETY_MODE = 12,
+    PROP_STATE_LIFE_SAFETY_STATE = 13
+} BACNET_PROPERTY_STATE_TYPE;
+
+typedef enum {
+    RECIPIENT_TAG_DEVICE = 0,
+    RECIPIENT_TAG_ADDRESS = 1
+} BACNET_RECIPIENT_TAG;
+
 typedef enum {
     VT_CLASS_DEFAULT = 0,
     VT_CLASS_ANSI_X34 = 1,      /* real name is ANSI X3.64 */
@@ -14,12 +14,88 @@
 #define _BACINT_H_
 
 #include <stdint.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/*
+ * Big-endian access at any alignment. memcpy of a fixed size compiles to a
+ * single load or store, so these are one instruction plus a byte swap.
+ */
+static inline uint16_t bacnet_get_be16(const uint8_t *pdu)
+{
+    uint16_t value;
+
+    memcpy(&value, pdu, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap16(value);
+#endif
+
+    return value;
+}
+
+static inline uint32_t bacnet_get_be24(const uint8_t *pdu)
+{
+    return ((uint32_t)bacnet_get_be16(pdu) << 8) | pdu[2];
+}
+
+static inline uint32_t bacnet_get_be32(const uint8_t *pdu)
+{
+    uint32_t value;
+
+    memcpy(&value, pdu, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+
+    return value;
+}
+
+static inline uint64_t bacnet_get_be64(const uint8_t *pdu)
+{
+    uint64_t value;
+
+    memcpy(&value, pdu, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+
+    return value;
+}
+
+static inline void bacnet_put_be16(uint8_t *pdu, uint16_t value)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap16(value);
+#endif
+    memcpy(pdu, &value, sizeof(value));
+}
+
+static inline void bacnet_put_be24(uint8_t *pdu, uint32_t value)
+{
+    bacnet_put_be16(pdu, (uint16_t)(value >> 8));
+    pdu[2] = (uint8_t)value;
+}
+
+static inline void bacnet_put_be32(uint8_t *pdu, uint32_t value)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    memcpy(pdu, &value, sizeof(value));
+}
+
+static inline void bacnet_put_be64(uint8_t *pdu, uint64_t value)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    memcpy(pdu, &value, sizeof(value));
+}
+
 extern int encode_signed8(uint8_t *pdu, int8_t value);
 
 extern int encode_signed16(uint8_t *pdu, int16_t value);
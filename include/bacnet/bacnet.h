@@ -17,6 +17,8 @@ extern "C"
 {
 #endif
 
+#include <stdbool.h>
+
 #include "misc/cJSON.h"
 
 #define BACNET_APP_CONFIG_FILE              "app.conf"
@@ -25,6 +27,19 @@ extern "C"
 
 extern cJSON *bacnet_get_app_cfg(void);
 
+/**
+ * app config for app_startup: bacnet_get_app_cfg if it is overridden, else
+ * app.conf.img when it was saved from the same app.conf, else parse app.conf
+ * @return NULL if fail
+ */
+extern cJSON *bacnet_load_app_cfg(void);
+
+/**
+ * free config from bacnet_load_app_cfg
+ * @param used, app started with cfg parsed from app.conf, save it as app.conf.img
+ */
+extern void bacnet_release_app_cfg(cJSON *cfg, bool used);
+
 extern cJSON *bacnet_get_network_cfg(void);
 
 extern cJSON *bacnet_get_resource_cfg(void);
@@ -22,32 +22,60 @@ extern "C"
 
 extern const char *bactext_object_type_name(uint32_t index);
 
+extern int bactext_object_type_index(const char *name);
+
 extern const char *bactext_property_name(uint32_t index);
 
+extern int bactext_property_index(const char *name);
+
 extern const char *bactext_event_state_name(uint32_t index);
 
+extern int bactext_event_state_index(const char *name);
+
 extern const char *bactext_engineering_unit_name(uint32_t index);
 
+extern int bactext_engineering_unit_index(const char *name);
+
 extern const char *bactext_binary_polarity_name(uint32_t index);
 
+extern int bactext_binary_polarity_index(const char *name);
+
 extern const char *bactext_binary_present_value_name(uint32_t index);
 
+extern int bactext_binary_present_value_index(const char *name);
+
 extern const char *bactext_reliability_name(uint32_t index);
 
+extern int bactext_reliability_index(const char *name);
+
 extern const char *bactext_device_status_name(uint32_t index);
 
+extern int bactext_device_status_index(const char *name);
+
 extern const char *bactext_segmentation_name(uint32_t index);
 
+extern int bactext_segmentation_index(const char *name);
+
 extern const char *bactext_node_type_name(uint32_t index);
 
+extern int bactext_node_type_index(const char *name);
+
 extern const char *bactext_day_of_week_name(uint32_t index);
 
+extern int bactext_day_of_week_index(const char *name);
+
 extern const char *bactext_month_name(uint32_t index);
 
+extern int bactext_month_index(const char *name);
+
 extern const char *bactext_error_class_name(uint32_t index);
 
+extern int bactext_error_class_index(const char *name);
+
 extern const char *bactext_error_code_name(uint32_t index);
 
+extern int bactext_error_code_index(const char *name);
+
 extern int bactext_tolower(const char *src, char dst[], size_t dst_size);
 
 extern int bactext_get_object_type_from_name(const char *name);
@@ -42,6 +42,7 @@ typedef enum {
 
 typedef struct bbmd_data_s bbmd_data_t;
 typedef struct fd_client_s fd_client_t;
+typedef struct bip_rx_worker_s bip_rx_worker_t;
 
 typedef struct datalink_bip_s {
     datalink_base_t dl;
@@ -56,6 +57,8 @@ typedef struct datalink_bip_s {
     struct in_addr netmask;                 /* in network format */
     bbmd_data_t *bbmd;                      /* not null if bbmd enable */
     fd_client_t *fd_client;                 /* not null if fd client enable */
+    uint32_t rx_threads;                    /* sockets bound with SO_REUSEPORT, sock_uip included */
+    bip_rx_worker_t *rx_workers;            /* rx_threads - 1 workers besides el_default_loop */
 } datalink_bip_t;
 
 extern int bip_init(void);
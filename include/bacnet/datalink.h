@@ -31,7 +31,9 @@ typedef enum dl_type_e {
     DL_MSTP = 2,
     DL_ARCNET = 3,
     DL_LONTALK = 4,
-    DL_ETHERNET = 5
+    DL_ETHERNET = 5,
+    DL_VIRTUAL = 6,
+    DL_PCAP = 7
 } dl_type_t;
 
 typedef struct datalink_base_s {
@@ -30,6 +30,13 @@ typedef struct datalink_ether_s {
     int fd;
     uint8_t mac[6];
     el_watch_t *watch;
+    uint8_t *ring;                          /* TPACKET_V3 rx ring, NULL when recv() is used */
+    uint32_t ring_size;
+    uint32_t block_size;
+    uint32_t block_nr;
+    uint32_t block_idx;                     /* next block to be processed */
+    uint64_t rx_blocks;
+    uint64_t rx_drops;                      /* frames dropped by kernel */
 } datalink_ether_t;
 
 extern int ether_init(void);
@@ -25,6 +25,27 @@ typedef struct {
     const char *pString;        /* text pair - use NULL to end the list */
 } INDTEXT_DATA;
 
+/* indexes at or above this are left to the linear scan */
+#define INDTEXT_DENSE_MAX               (4096)
+
+typedef struct indtext_index_s indtext_index_t;
+
+/*
+ * Direct-indexed view of an INDTEXT_DATA list. The list stays the only source
+ * of the text; the dense array and the name hash are derived from it on first
+ * use and never freed. Declare one per list with INDTEXT_TABLE_INIT.
+ */
+typedef struct indtext_table_s {
+    INDTEXT_DATA *data_list;
+    uint32_t split_index;
+    const char *before_split_default_name;
+    const char *default_name;
+    indtext_index_t *index;     /* NULL until built */
+} indtext_table_t;
+
+#define INDTEXT_TABLE_INIT(list, split, before_split_default, default_string)   \
+    { (list), (split), (before_split_default), (default_string), NULL }
+
 extern const char *indtext_by_index_default(INDTEXT_DATA *data_list, uint32_t index, 
                     const char *default_string);
 
@@ -32,9 +53,18 @@ extern const char *indtext_by_index_split_default(INDTEXT_DATA *data_list, uint3
                     uint32_t split_index, const char *before_split_default_name,
                     const char *default_name);
 
+/* same result as indtext_by_index_split_default on the table's list */
+extern const char *indtext_table_name(indtext_table_t *table, uint32_t index);
+
+/*
+ * indtext_table_index - reverse lookup, name compared case-insensitively
+ *
+ * @return: the index, -EINVAL on bad arguments, -EPERM if the name is unknown
+ */
+extern int indtext_table_index(indtext_table_t *table, const char *name);
+
 #ifdef __cplusplus
 }
 #endif
 
 #endif  /* _INDTEXT_H_ */
-
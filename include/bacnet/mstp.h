@@ -38,6 +38,12 @@ typedef enum {
     MSTP_B_MAX,
 } MSTP_BAUDRATE;
 
+/* ˿USBΪƹ̼USBת485TTYΪشϵڵ״̬ */
+typedef enum {
+    MSTP_DRIVER_USB = 0,
+    MSTP_DRIVER_TTY,
+} MSTP_DRIVER;
+
 struct datalink_mstp_s;
 
 struct slave_proxy_port_s;
@@ -46,6 +52,7 @@ struct slave_proxy_port_s;
 typedef struct datalink_mstp_s {
     datalink_base_t dl;
     struct list_head mstp_list;
+    MSTP_DRIVER driver;
     uint8_t mac;
     uint8_t max_master;
     uint8_t max_info_frames;
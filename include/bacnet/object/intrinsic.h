@@ -0,0 +1,139 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * intrinsic.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Intrinsic reporting of AI/AV/BI/BV/MSI. The event algorithm runs when the
+ * present value, Reliability, Out_Of_Service or one of the event properties
+ * changes, with the object write lock held. Transitions are queued and the
+ * notifications are sent in one pass on the event loop.
+ *
+ * History
+ */
+
+#ifndef _INTRINSIC_H_
+#define _INTRINSIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "bacnet/bacenum.h"
+#include "bacnet/object/object.h"
+#include "bacnet/service/event.h"
+#include "misc/eventloop.h"
+#include "misc/list.h"
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum {
+    INTRINSIC_ANALOG = 0,                   /* OUT_OF_RANGE */
+    INTRINSIC_BINARY,                       /* CHANGE_OF_STATE on a BACnetBinaryPV */
+    INTRINSIC_MULTISTATE,                   /* CHANGE_OF_STATE on an Unsigned */
+} intrinsic_kind_t;
+
+typedef struct intrinsic_s {
+    struct list_head link;                  /* every intrinsic, for intrinsic_reporting_exit */
+    struct list_head node;                  /* event summary list, in object identifier order */
+    object_seor_t *object;
+    intrinsic_kind_t kind;
+    bool bSummary;                          /* on the summary list: not normal or not acked */
+    bool bValid;                            /* a present value has been reported */
+    BACNET_EVENT_STATE Pending;             /* state waiting for Time_Delay, Event_State if none */
+    unsigned uPendingDue;                   /* el_current_millisecond() when Pending is due */
+    uint32_t ulNotificationClass;
+    uint32_t ulTimeDelay;                   /* seconds */
+    uint8_t ucEventEnable;                  /* 1 << BACNET_EVENT_TRANSITION_BITS */
+    uint8_t ucAckedTransitions;
+    uint8_t ucLimitEnable;                  /* 1 << BACNET_LIMIT_ENABLE */
+    BACNET_NOTIFY_TYPE NotifyType;
+    float fHighLimit;
+    float fLowLimit;
+    float fDeadband;
+    uint32_t ulStates;                      /* Number_Of_States of a multistate object */
+    uint32_t ulAlarmValues;                 /* binary: 1 << pv, multistate: 1 << (pv - 1) */
+    time_t tEventTimeStamps[MAX_BACNET_EVENT_TRANSITION];
+    union {
+        float fValue;
+        uint32_t ulValue;
+    } Value;                                /* last reported present value */
+    el_timer_t *timer;                      /* Time_Delay, created on first use */
+} intrinsic_t;
+
+extern void __intrinsic_report_analog(intrinsic_t *intr, float value);
+
+extern void __intrinsic_report_discrete(intrinsic_t *intr, uint32_t value);
+
+extern void __intrinsic_report_refresh(intrinsic_t *intr);
+
+/*
+ * intrinsic_report_* - present value and status hooks, called with the object write
+ * lock held. Cheap for objects without intrinsic reporting and for unchanged values.
+ * Until the first pass on the loop after object init, they only record the value.
+ */
+static inline void intrinsic_report_analog(object_seor_t *object, float value)
+{
+    if (object->intrinsic) {
+        __intrinsic_report_analog(object->intrinsic, value);
+    }
+}
+
+static inline void intrinsic_report_discrete(object_seor_t *object, uint32_t value)
+{
+    if (object->intrinsic) {
+        __intrinsic_report_discrete(object->intrinsic, value);
+    }
+}
+
+/* Reliability or Out_Of_Service changed, evaluate again with the last present value */
+static inline void intrinsic_report_refresh(object_seor_t *object)
+{
+    if (object->intrinsic) {
+        __intrinsic_report_refresh(object->intrinsic);
+    }
+}
+
+/**
+ * intrinsic_reporting_init - set up intrinsic reporting from the Intrinsic_Reporting item
+ *
+ * @object: not yet added, its type is replaced by the event variant of that type
+ * @variant: the caller's event variant of object's current type, cloned on first use
+ * @instance: the Instance_List item
+ * @states: Number_Of_States of a multistate object, otherwise ignored
+ *
+ * @return: OK also when there is no Intrinsic_Reporting item, <0 on config error
+ */
+extern int intrinsic_reporting_init(object_seor_t *object, object_impl_t **variant, cJSON *instance,
+                uint32_t states);
+
+extern void intrinsic_reporting_destroy(object_seor_t *object);
+
+/* drop the reporting state of every object, the objects are about to be freed */
+extern void intrinsic_reporting_exit(void);
+
+/**
+ * intrinsic_encode_event_summaries - encode the listOfEventSummaries of GetEventInformation
+ *
+ * @type, @instance: lastReceivedObjectIdentifier, type MAX_BACNET_OBJECT_TYPE to start over
+ * @more: set when the summaries did not fit in max_len
+ *
+ * @return: the number of apdu bytes used
+ */
+extern int intrinsic_encode_event_summaries(uint8_t *pdu, int max_len, BACNET_OBJECT_TYPE type,
+                uint32_t instance, bool *more);
+
+/* @return: MAX_BACNET_ERROR_CODE on success */
+extern BACNET_ERROR_CODE intrinsic_acknowledge(BACNET_OBJECT_TYPE type, uint32_t instance,
+                BACNET_EVENT_STATE state, const BACNET_TIMESTAMP *stamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _INTRINSIC_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * nc.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * History
+ */
+
+#ifndef _NC_H_
+#define _NC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/datetime.h"
+#include "bacnet/object/object.h"
+#include "bacnet/service/event.h"
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* BACnetDestination */
+typedef struct nc_destination_s {
+    uint8_t ucValidDays;                    /* bit 0 is Monday */
+    BACNET_TIME FromTime;
+    BACNET_TIME ToTime;
+    BACNET_RECIPIENT_TAG RecipientTag;
+    uint32_t ulDeviceId;                    /* RECIPIENT_TAG_DEVICE */
+    bacnet_addr_t Address;                  /* RECIPIENT_TAG_ADDRESS, broadcast only */
+    uint32_t ulProcessId;
+    bool bConfirmed;
+    uint8_t ucTransitions;                  /* 1 << BACNET_EVENT_TRANSITION_BITS */
+} NC_DESTINATION;
+
+/* Notification_Class equals the instance number, nothing is writable */
+typedef struct object_nc_s {
+    object_instance_t base;
+    uint8_t ucPriority[MAX_BACNET_EVENT_TRANSITION];
+    uint8_t ucAckRequired;                  /* 1 << BACNET_EVENT_TRANSITION_BITS */
+    uint32_t ulRecipientCount;
+    NC_DESTINATION *Recipients;
+} object_nc_t;
+
+/**
+ * notification_class_get - Priority and Ack_Required of a transition
+ *
+ * @return: false if the class does not exist
+ */
+extern bool notification_class_get(uint32_t notification_class, BACNET_EVENT_TRANSITION_BITS transition,
+                uint8_t *priority, bool *ack_required);
+
+/**
+ * notification_class_send - send an event notification to the recipients of its class
+ *
+ * The recipients that take this transition now get it confirmed or unconfirmed, as
+ * configured. data->processIdentifier is overwritten per recipient.
+ *
+ * @return: number of recipients sent to, <0 if the class does not exist
+ */
+extern int notification_class_send(BACNET_EVENT_NOTIFICATION_DATA *data,
+                BACNET_EVENT_TRANSITION_BITS transition);
+
+extern object_impl_t *object_create_impl_nc(void);
+
+extern int notification_class_init(cJSON *object);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _NC_H_ */
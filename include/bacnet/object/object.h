@@ -36,10 +36,19 @@ extern bool client_device;
 
 typedef struct object_instance_s object_instance_t;
 
+/*
+ * OBJECT_COMPACT_INDEX(make OBJECT_COMPACT_INDEX=y)ʱ, ÿ͵Ķinstance
+ * , ٴrbtreeڵ; ʱҪƶ
+ */
 typedef struct object_store_s {
     BACNET_OBJECT_TYPE  object_type;
     struct rb_node      node;
+#ifdef OBJECT_COMPACT_INDEX
+    object_instance_t   **objects;      /* instance */
+    uint32_t            capacity;
+#else
     struct rb_root      instance_root; /* object_instance_t */
+#endif
     uint32_t            object_count;
 } object_store_t;
 
@@ -66,21 +75,74 @@ typedef struct object_impl_s {
     uint16_t            property_required_count;
     uint16_t            property_optional_count;
     uint16_t            property_proprietary_count;
+    bool                locked_read;            /* Ժ䳤ݣʱֶд */
 } object_impl_t;
 
 #define OBJECT_NAME_MAX_LEN     (32)
 
 struct object_instance_s {
+#ifndef OBJECT_COMPACT_INDEX
     struct rb_node      node_type;
-    struct hlist_node   node_name;
+#endif
     const object_impl_t *type;
     uint32_t            instance;
-    DECLARE_VBUF(object_name, OBJECT_NAME_MAX_LEN);
+    uint32_t            seq;                    /* дڼΪ */
+    uint32_t            write_nest;             /* ͬһ߳дĲ */
+    const vbuf_t        *object_name;           /* ڹ, ֻ, ʱ滻 */
 };
 
+/*
+ * Ĳģ:
+ * - ҺͱRCUڽУ߲; ɾд߻⣬;
+ *   object_detachʱûжøö󣬵߿ֱͷ.
+ *   ȶ뿪ʱκ, Ϊ߿ڶȡ;
+ *   object_detachʱҲҪжд
+ * - ֵд(object_write_lock)дڼseqΪ;
+ *   object_read_begin/object_read_retryȡseq仯ض;
+ *   дַ, һдʱҪȥĶ
+ */
+extern void object_write_lock(object_instance_t *object);
+
+extern void object_write_unlock(object_instance_t *object);
+
+static inline uint32_t object_read_begin(const object_instance_t *object)
+{
+    return __atomic_load_n(&object->seq, __ATOMIC_ACQUIRE);
+}
+
+/* @return: trueʾȡڼдҪض */
+static inline bool object_read_retry(const object_instance_t *object, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return (seq & 1) || (__atomic_load_n(&object->seq, __ATOMIC_RELAXED) != seq);
+}
+
+/*
+ * ڴ水ʹslabз, ͬͲͬСıһslab. ڴ;
+ * object_addĶobject_detachobject_free
+ */
+extern void *object_alloc(BACNET_OBJECT_TYPE type, size_t size);
+
+extern void object_free(object_instance_t *object);
+
+/* ΪcountͬͬСĶһԤڴ, ʼʱInstance_Listȵ */
+extern int object_reserve(BACNET_OBJECT_TYPE type, size_t size, uint32_t count);
+
+/* object_add֮ǰ, ֮object_rename */
+extern bool object_set_name(object_instance_t *object, const char *name);
+
 extern object_instance_t *object_find(BACNET_OBJECT_TYPE type, uint32_t instance);
 extern bool object_add(object_instance_t *object);
-extern void object_detach(object_instance_t *object);
+extern bool object_detach(object_instance_t *object);
+
+/*
+ * ڳӻʱ, begin/endֻ֮endʱؽһ, Ƕ.
+ * ڼobject_findҵ¶, ֲҺͶдҪend֮;
+ * object_detach. endfalseʾؽʧ, ´ηʱ
+ */
+extern void object_batch_begin(void);
+extern bool object_batch_end(void);
 
 extern const property_impl_t *object_impl_find_property(const object_impl_t *type,
         BACNET_PROPERTY_ID property);
@@ -104,6 +166,8 @@ typedef struct object_seor_s {
     /* used to notify present_value need to output
      * or to be updated from input, other as reliability */
     void (*notify) (struct object_seor_s *obj);
+    /* intrinsic reporting state, NULL if the object does not report */
+    struct intrinsic_s  *intrinsic;
 } object_seor_t;
 
 extern object_impl_t *object_create_impl_seor(bool has_event_state, bool has_out_of_service, bool reliability_optional);
@@ -157,8 +221,14 @@ extern int object_init(cJSON *app);
 
 extern void object_exit(void);
 
+/* object_init׶κʱ: {"total_us", "device_us", "objects", "name_buckets", "types": [...]} */
+extern cJSON *object_get_init_status(void);
+
 extern bool object_get_types_supported(BACNET_BIT_STRING *types);
 
+/* ڴռ, ͳʵֺ */
+extern cJSON *object_get_memory_status(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * trendlog_multiple.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * History
+ */
+
+#ifndef _TRENDLOG_MULTIPLE_H_
+#define _TRENDLOG_MULTIPLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "bacnet/datetime.h"
+#include "bacnet/bacdevobjpropref.h"
+#include "bacnet/object/object.h"
+#include "bacnet/object/trendlog.h"
+#include "misc/eventloop.h"
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* One member value of a Trend Log Multiple record, the TL_TYPE_* lives in a separate column */
+typedef union tlm_datum {
+    uint8_t ucBoolean;
+    float fReal;
+    uint32_t ulEnum;
+    uint32_t ulUValue;
+    int32_t lSValue;
+    struct {
+        uint8_t ucBits;             /* bits used, bit strings are truncated at 24 bits */
+        uint8_t ucStore[3];
+    } Bits;
+    TL_ERROR Error;
+} TLM_DATUM;
+
+typedef struct object_tlm_s {
+    object_seor_t base;
+    bool bEnable;                           /* Trend log is active when this is true */
+    BACNET_DATE_TIME StartTime;             /* BACnet format start time */
+    BACNET_DATE_TIME StopTime;              /* BACnet format stop time */
+    time_t tStartTime;                      /* Local time working copy of start time */
+    time_t tStopTime;                       /* Local time working copy of stop time */
+    uint8_t ucTimeFlags;                    /* Shorthand info on times */
+    uint32_t ulLogInterval;                 /* Time between entries in seconds */
+    bool bStopWhenFull;                     /* Log halts when full if true */
+    BACNET_LOGGING_TYPE LoggingType;        /* Polled/triggered */
+    bool bAlignIntervals;                   /* If true align to the clock */
+    uint32_t ulIntervalOffset;              /* Offset from start of period for taking reading in seconds */
+    bool bTrigger;                          /* Set to 1 to cause a reading to be taken */
+    time_t tNextSample;                     /* Due time of the next polled acquisition */
+    uint32_t ulMemberCount;
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Members;
+
+    /*
+     * Log_Buffer is kept column-wise in a ring of ulBufferSize rows: one timestamp per
+     * record shared by all members, then one type column and one value column per member.
+     * Row i of every column belongs to the same record.
+     */
+    uint32_t ulBufferSize;
+    uint32_t ulRecordCount;                 /* Count of items currently in the buffer */
+    uint32_t ulTotalRecordCount;            /* Count of all items that have ever been inserted into the buffer */
+    uint32_t iIndex;                        /* Current insertion point */
+    time_t *tTimeStamps;
+    uint8_t *ucStatus;                      /* 0 for data, TLM_STATUS_REC | log status bits otherwise */
+    uint8_t *ucTypes;                       /* ulMemberCount columns of TL_TYPE_* */
+    TLM_DATUM *Values;                      /* ulMemberCount columns */
+    el_timer_t *timer;
+} object_tlm_t;
+
+/**
+ * trend_log_multiple_acquire - sample all members once and append them as one record
+ *
+ * Does nothing while the log is not enabled. Must not be called with a member object
+ * locked.
+ */
+extern int trend_log_multiple_acquire(object_instance_t *object);
+
+extern object_impl_t *object_create_impl_tlm(void);
+
+extern int trend_log_multiple_init(cJSON *object);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRENDLOG_MULTIPLE_H_ */
@@ -0,0 +1,148 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * pcapdl.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Pcap replay datalink. Frames captured from a B/IP or BACnet Ethernet site
+ * are fed into the network layer at capture pace or accelerated, and what
+ * the stack sends could be written to another pcap file.
+ *
+ * History
+ */
+
+#ifndef _PCAPDL_H_
+#define _PCAPDL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "bacnet/bacdef.h"
+#include "misc/cJSON.h"
+#include "misc/list.h"
+#include "misc/eventloop.h"
+#include "bacnet/datalink.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define PCAPDL_MAX_NPDU             (1497)
+#define PCAPDL_MAC_LEN              (6)
+
+/* log-linear histogram, 16 sub-buckets per power of 2 */
+#define PCAPDL_HIST_SUB_BITS        (4)
+#define PCAPDL_HIST_BUCKETS         ((64 - PCAPDL_HIST_SUB_BITS + 1) << PCAPDL_HIST_SUB_BITS)
+
+typedef enum pcapdl_stage_e {
+    PCAPDL_STAGE_DECAP = 0,                 /* pcap record to npdu */
+    PCAPDL_STAGE_APDU,                      /* network_receive_pdu of local/broadcast apdu */
+    PCAPDL_STAGE_RELAY,                     /* network_receive_pdu of routed npdu */
+    PCAPDL_STAGE_NETWORK_MSG,               /* network_receive_pdu of network layer message */
+    PCAPDL_STAGE_TX,                        /* send_pdu, encapsulate and write output */
+    PCAPDL_STAGE_RESPONSE,                  /* rx injected to each tx caused by it */
+    MAX_PCAPDL_STAGE
+} pcapdl_stage_t;
+
+typedef struct pcapdl_stat_s {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t hist[PCAPDL_HIST_BUCKETS];
+} pcapdl_stat_t;
+
+typedef struct pcapdl_frame_s {
+    uint64_t ts_ns;                         /* capture timestamp */
+    uint32_t offset;                        /* frame offset in file */
+    uint32_t len;
+} pcapdl_frame_t;
+
+typedef enum pcapdl_format_e {
+    PCAPDL_FORMAT_BIP = 0,
+    PCAPDL_FORMAT_ETHERNET
+} pcapdl_format_t;
+
+typedef struct datalink_pcap_s {
+    datalink_base_t dl;
+    struct list_head pcap_list;
+    char *input;
+    char *output;
+    pcapdl_format_t format;
+    uint8_t addr[PCAPDL_MAC_LEN];           /* own ip+port or ethernet mac */
+    bool addr_set;
+    uint16_t udp_port;
+
+    uint8_t *map;
+    size_t map_len;
+    uint32_t linktype;
+    pcapdl_frame_t *frames;
+    uint32_t frame_nums;
+
+    double speed;                           /* 0 means as fast as possible */
+    uint32_t loops;
+    uint32_t start_delay_ms;
+    int timer_fd;
+    el_watch_t *timer_watch;
+    FILE *out;
+
+    uint32_t next;
+    uint32_t loop_done;
+    uint64_t base_ns;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    bool done;
+
+    bool in_rx;
+    uint64_t rx_start_ns;
+    uint64_t rx_tx_ns;
+    uint32_t injected;
+    uint32_t skipped;
+    pcapdl_stat_t stats[MAX_PCAPDL_STAGE];
+} datalink_pcap_t;
+
+extern int pcapdl_init(void);
+
+extern void pcapdl_exit(void);
+
+extern int pcapdl_startup(void);
+
+extern void pcapdl_stop(void);
+
+extern void pcapdl_clean(void);
+
+/**
+ * pcapdl_port_create - create a pcap replay port. cfg items: resource_name,
+ * format("bip"/"ethernet", optional), address(optional, own "ip[:port]" or
+ * mac, frames from it are skipped), udp_port(optional), output(optional),
+ * speed(optional, 0 for max), loop(optional), start_delay_ms(optional)
+ *
+ * @cfg: port config
+ * @res: resource config, resource type should be "PCAP" and ifname is the
+ *       input pcap file
+ *
+ * @return: port object if success, NULL if fail
+ *
+ */
+extern datalink_pcap_t *pcapdl_port_create(cJSON *cfg, cJSON *res);
+
+extern int pcapdl_port_delete(datalink_pcap_t *pcap_port);
+
+extern datalink_pcap_t *pcapdl_next_port(datalink_pcap_t *prev);
+
+/**
+ * pcapdl_replay_done - all pcap ports have injected every frame of the last loop
+ */
+extern bool pcapdl_replay_done(void);
+
+extern void pcapdl_set_dbg_level(uint32_t level);
+
+extern cJSON *pcapdl_get_status(cJSON *request);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _PCAPDL_H_ */
@@ -0,0 +1,53 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * ratelimit.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Rate limit of inbound unconfirmed services
+ *
+ * History
+ */
+
+#ifndef _RATELIMIT_H_
+#define _RATELIMIT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/bacdef.h"
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern int rate_limit_init(cJSON *cfg);
+
+extern void rate_limit_exit(void);
+
+/*
+ * rate_limit_unconfirmed - ԴַͰȫͰȷϷ
+ *
+ * @return: trueʾfalseʾ
+ */
+extern bool rate_limit_unconfirmed(uint8_t service_choice, bacnet_addr_t *src);
+
+/*
+ * rate_limit_whois_collapse - ͬһӦI-AmϲWho-Is
+ *
+ * @return: trueʾWho-IsѺϲӦ
+ */
+extern bool rate_limit_whois_collapse(uint16_t reply_net);
+
+extern cJSON *rate_limit_get_status(void);
+
+extern void rate_limit_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RATELIMIT_H_ */
@@ -0,0 +1,52 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * alarmack.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * AcknowledgeAlarm
+ *
+ * History
+ */
+
+#ifndef _ALARMACK_H_
+#define _ALARMACK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/apdu.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/service/event.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct BACnet_Alarm_Ack_Data {
+    uint32_t ackProcessIdentifier;
+    BACNET_OBJECT_TYPE eventObjectType;
+    uint32_t eventObjectInstance;
+    BACNET_EVENT_STATE eventStateAcked;
+    BACNET_TIMESTAMP eventTimeStamp;
+    BACNET_TIMESTAMP ackTimeStamp;
+    union {
+        struct {
+            BACNET_ERROR_CLASS error_class;
+            BACNET_ERROR_CODE error_code;
+        };
+        BACNET_REJECT_REASON reject_reason;
+        BACNET_ABORT_REASON abort_reason;
+    };
+} BACNET_ALARM_ACK_DATA;
+
+extern void handler_alarm_ack(BACNET_CONFIRMED_SERVICE_DATA *service_data,
+                bacnet_buf_t *reply_apdu, bacnet_addr_t *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _ALARMACK_H_ */
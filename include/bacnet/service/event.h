@@ -0,0 +1,96 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * event.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * ConfirmedEventNotification/UnconfirmedEventNotification
+ *
+ * History
+ */
+
+#ifndef _EVENT_H_
+#define _EVENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/datetime.h"
+#include "bacnet/bacnet_buf.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* BACnetTimeStamp */
+typedef struct BACnet_Timestamp {
+    BACNET_TIMESTAMP_TAG tag;
+    union {
+        BACNET_TIME time;
+        uint32_t sequenceNum;
+        BACNET_DATE_TIME dateTime;
+    } value;
+} BACNET_TIMESTAMP;
+
+typedef struct BACnet_Event_Notification_Data {
+    uint32_t processIdentifier;
+    BACNET_OBJECT_TYPE eventObjectType;
+    uint32_t eventObjectInstance;
+    time_t timeStamp;                           /* 0 for an unspecified time */
+    uint32_t notificationClass;
+    uint8_t priority;
+    BACNET_EVENT_TYPE eventType;
+    BACNET_NOTIFY_TYPE notifyType;
+    bool ackRequired;
+    BACNET_EVENT_STATE fromState;
+    BACNET_EVENT_STATE toState;
+    uint8_t statusFlags;                        /* 1 << BACNET_STATUS_FLAGS */
+    union {
+        struct {
+            BACNET_PROPERTY_STATE_TYPE tag;
+            uint32_t state;
+        } changeOfState;
+        struct {
+            float exceedingValue;
+            float deadband;
+            float exceededLimit;
+        } outOfRange;
+    } values;
+} BACNET_EVENT_NOTIFICATION_DATA;
+
+/**
+ * encode_timestamp - encode a local time as a date-time BACnetTimeStamp
+ *
+ * @when: 0 is encoded with every date and time field unspecified
+ *
+ * @return: the number of apdu bytes used
+ */
+extern int encode_timestamp(uint8_t *apdu, time_t when);
+
+extern int encode_context_timestamp(uint8_t *apdu, uint8_t tag_number, time_t when);
+
+/* @return: the number of apdu bytes consumed or <0 if error */
+extern int decode_context_timestamp(const uint8_t *apdu, uint8_t tag_number,
+            BACNET_TIMESTAMP *stamp);
+
+/* @return: true if stamp names the same second as when */
+extern bool timestamp_match(const BACNET_TIMESTAMP *stamp, time_t when);
+
+extern int event_notify_encode_service_request(uint8_t *pdu,
+            BACNET_EVENT_NOTIFICATION_DATA *data);
+
+extern int cevent_notify_encode_apdu(bacnet_buf_t *apdu, uint8_t invoke_id,
+            BACNET_EVENT_NOTIFICATION_DATA *data);
+
+extern int uevent_notify_encode_apdu(bacnet_buf_t *apdu, BACNET_EVENT_NOTIFICATION_DATA *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _EVENT_H_ */
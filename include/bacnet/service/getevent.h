@@ -0,0 +1,34 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * getevent.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * GetEventInformation
+ *
+ * History
+ */
+
+#ifndef _GETEVENT_H_
+#define _GETEVENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/apdu.h"
+#include "bacnet/bacenum.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern void handler_get_event_information(BACNET_CONFIRMED_SERVICE_DATA *service_data,
+                bacnet_buf_t *reply_apdu, bacnet_addr_t *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _GETEVENT_H_ */
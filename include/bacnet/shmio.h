@@ -0,0 +1,167 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * shmio.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Shared-memory present value interface for local I/O processes.
+ *
+ * Layout of the region (POSIX shm, name from app.conf Shared_IO.Name):
+ *   shmio_header_t, then slot_count shmio_slot_t, in Slot_List order.
+ *
+ * Every slot carries two seqlocked halves:
+ *   in_*  written by the I/O process, picked up by the stack in batches;
+ *   out_* written by the stack, present value/status/priority array.
+ * Each half has exactly one writer. The I/O side only needs this header.
+ *
+ * History
+ */
+
+#ifndef _SHMIO_H_
+#define _SHMIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SHMIO_MAGIC                     (0x42534D31)
+#define SHMIO_VERSION                   (1)
+
+#define SHMIO_PRIORITY_NUM              (16)
+
+/* in_flags */
+#define SHMIO_IN_VALUE                  (1 << 0)    /* in_valueЧ */
+#define SHMIO_IN_OVERRIDDEN             (1 << 1)    /* ֳֶ */
+
+/* out_flags, StatusFlagsλͬ */
+#define SHMIO_OUT_IN_ALARM              (1 << 0)
+#define SHMIO_OUT_FAULT                 (1 << 1)
+#define SHMIO_OUT_OVERRIDDEN            (1 << 2)
+#define SHMIO_OUT_OUT_OF_SERVICE        (1 << 3)
+
+typedef struct shmio_header_s {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t generation;                /* ЭջÿһI/OݴжϲλǷѱ */
+    uint32_t in_commit;                 /* I/OÿдһһЭջݴɨ */
+    uint32_t out_commit;                /* Эջÿһһ */
+    uint32_t reserved[9];
+} __attribute__((aligned(64))) shmio_header_t;
+
+typedef struct shmio_slot_s {
+    /* λݣЭջʼʱд */
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t instance;
+
+    /* I/O -> Эջ */
+    uint32_t in_seq;
+    uint32_t in_flags;
+    float in_value;                     /* BI/BO: 01 */
+    uint32_t in_reliability;
+
+    /* Эջ -> I/O */
+    uint32_t out_seq;
+    uint32_t out_flags;
+    float out_value;
+    uint32_t out_reliability;
+    uint8_t out_priority;               /* ЧPriority, 0ʾRelinquish_Default */
+    uint8_t reserved1;
+    uint16_t out_priority_bits;
+    uint32_t reserved2[5];
+    float out_priority_array[SHMIO_PRIORITY_NUM];
+} __attribute__((aligned(64))) shmio_slot_t;
+
+static inline shmio_slot_t *shmio_slot(shmio_header_t *header, uint32_t index)
+{
+    return (shmio_slot_t *)((uint8_t *)header + sizeof(shmio_header_t)) + index;
+}
+
+static inline void shmio_seq_write_begin(uint32_t *seq)
+{
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void shmio_seq_write_end(uint32_t *seq)
+{
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+/* ¶ʼʱseq, seqڱд򷵻false */
+static inline bool shmio_seq_read_begin(uint32_t *seq, uint32_t *start)
+{
+    *start = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+
+    return (*start & 1) == 0;
+}
+
+/* ȡڼseqδ䣬򿽱 */
+static inline bool shmio_seq_read_end(uint32_t *seq, uint32_t start)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(seq, __ATOMIC_RELAXED) == start;
+}
+
+/*
+ * shmio_write_input - I/OдһAI/BIֳֵ
+ *
+ * дٵshmio_commit֪ͨЭջȡ
+ */
+static inline void shmio_write_input(shmio_slot_t *slot, float value, uint32_t reliability,
+                    bool overridden)
+{
+    shmio_seq_write_begin(&slot->in_seq);
+    slot->in_value = value;
+    slot->in_reliability = reliability;
+    slot->in_flags = SHMIO_IN_VALUE | (overridden? SHMIO_IN_OVERRIDDEN: 0);
+    shmio_seq_write_end(&slot->in_seq);
+}
+
+static inline void shmio_commit(shmio_header_t *header)
+{
+    __atomic_add_fetch(&header->in_commit, 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * shmio_read_output - I/O̶һλЭջĵǰֵ
+ *
+ * @return: falseʾЭջдòλԺ
+ */
+static inline bool shmio_read_output(shmio_slot_t *slot, shmio_slot_t *copy)
+{
+    uint32_t start;
+
+    if (!shmio_seq_read_begin(&slot->out_seq, &start)) {
+        return false;
+    }
+
+    *copy = *slot;
+
+    return shmio_seq_read_end(&slot->out_seq, start);
+}
+
+extern int shmio_init(cJSON *cfg);
+
+extern void shmio_exit(void);
+
+/* ȡеI/O룬AO/BOֵЭջ߳е */
+extern void shmio_poll(void);
+
+extern cJSON *shmio_get_status(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SHMIO_H_ */
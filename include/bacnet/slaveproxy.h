@@ -54,6 +54,13 @@ extern int manual_binding_set(uint8_t *pdu, uint32_t pdu_len);
 extern void remote_proxied_whois(uint16_t src_net, uint16_t in_net,
         uint32_t lowlimit, uint32_t highlimit);
 
+/*
+ * slave_proxy_get_iam_status - I-AmŶӡϲͼ
+ */
+extern cJSON *slave_proxy_get_iam_status(void);
+
+extern void slave_proxy_reset_iam_status(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,6 +59,10 @@ extern int tsm_init(cJSON *cfg);
 
 extern void tsm_exit(void);
 
+extern cJSON *tsm_get_perf_status(void);
+
+extern void tsm_perf_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,155 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * virtualdl.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * In-process virtual datalink. Ports and simulated nodes attached to the same
+ * named bus exchange frames through lock-free rings, without any hardware.
+ *
+ * History
+ */
+
+#ifndef _VIRTUALDL_H_
+#define _VIRTUALDL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/bacdef.h"
+#include "misc/cJSON.h"
+#include "misc/list.h"
+#include "misc/eventloop.h"
+#include "bacnet/datalink.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define VDL_MAX_NPDU                (1497)
+#define VDL_MAC_LEN                 (2)
+#define VDL_BROADCAST_MAC           (0xFFFF)
+#define VDL_MAX_MAC                 (0xFFFE)
+#define VDL_BUS_NAME_MAX            (32)
+
+struct vdl_endpoint_s;
+
+typedef struct vdl_endpoint_s vdl_endpoint_t;
+
+typedef struct datalink_vdl_s {
+    datalink_base_t dl;
+    struct list_head vdl_list;
+    vdl_endpoint_t *ep;
+    int timer_fd;
+    el_watch_t *watch;
+    el_watch_t *timer_watch;
+} datalink_vdl_t;
+
+extern int vdl_init(void);
+
+extern void vdl_exit(void);
+
+extern int vdl_startup(void);
+
+extern void vdl_stop(void);
+
+extern void vdl_clean(void);
+
+/**
+ * vdl_port_create - create a virtual port, cfg items: resource_name, mac,
+ * ring_size(optional), latency_us(optional), loss_ppm(optional)
+ *
+ * @cfg: port config
+ * @res: resource config, resource type should be "VIRTUAL" and ifname is bus name
+ *
+ * @return: port object if success, NULL if fail
+ *
+ */
+extern datalink_vdl_t *vdl_port_create(cJSON *cfg, cJSON *res);
+
+extern int vdl_port_delete(datalink_vdl_t *vdl_port);
+
+extern datalink_vdl_t *vdl_next_port(datalink_vdl_t *prev);
+
+extern void vdl_set_dbg_level(uint32_t level);
+
+extern cJSON *vdl_get_status(cJSON *request);
+
+/**
+ * vdl_endpoint_create - attach a raw endpoint to bus, used by simulated nodes
+ *
+ * @bus: bus name, bus is created on first attach
+ * @mac: 0 ~ VDL_MAX_MAC, must be unique on the bus
+ * @ring_size: rx ring slots, rounded up to power of 2
+ *
+ * @return: endpoint if success, NULL if fail
+ *
+ */
+extern vdl_endpoint_t *vdl_endpoint_create(const char *bus, uint16_t mac, uint32_t ring_size);
+
+/**
+ * vdl_endpoint_destroy - detach and free endpoint. No one should send to the
+ * bus at the same time.
+ */
+extern void vdl_endpoint_destroy(vdl_endpoint_t *ep);
+
+/**
+ * vdl_endpoint_set_profile - set the link profile on the receive side of endpoint
+ *
+ * @latency_us: delay before a frame could be received
+ * @loss_ppm: frames dropped per million
+ *
+ */
+extern void vdl_endpoint_set_profile(vdl_endpoint_t *ep, uint32_t latency_us, uint32_t loss_ppm);
+
+/**
+ * vdl_endpoint_send - send a frame, never block
+ *
+ * @dst: destination mac, VDL_BROADCAST_MAC for all other endpoints on the bus
+ *
+ * @return: 0 if queued(or dropped by loss profile), negative if fail
+ *
+ */
+extern int vdl_endpoint_send(vdl_endpoint_t *ep, uint16_t dst, const uint8_t *data,
+            uint16_t len);
+
+/**
+ * vdl_endpoint_recv - receive a frame, never block, single consumer only
+ *
+ * @src: return source mac
+ *
+ * @return: frame length, 0 if no frame due, negative if fail
+ *
+ */
+extern int vdl_endpoint_recv(vdl_endpoint_t *ep, uint16_t *src, uint8_t *data, uint16_t size);
+
+/**
+ * vdl_endpoint_fd - eventfd readable when frames are queued. Consumer should
+ * call vdl_endpoint_ack before draining the ring.
+ */
+extern int vdl_endpoint_fd(vdl_endpoint_t *ep);
+
+extern void vdl_endpoint_ack(vdl_endpoint_t *ep);
+
+/**
+ * vdl_endpoint_next_due - microseconds until the head frame could be received
+ *
+ * @return: 0 if head is due now, -1 if ring is empty
+ *
+ */
+extern int64_t vdl_endpoint_next_due(vdl_endpoint_t *ep);
+
+extern uint16_t vdl_endpoint_mac(vdl_endpoint_t *ep);
+
+/**
+ * vdl_endpoint_drops - frames dropped on rx because ring full or loss profile
+ */
+extern uint32_t vdl_endpoint_drops(vdl_endpoint_t *ep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _VIRTUALDL_H_ */
@@ -39,6 +39,13 @@ typedef enum {
     DEBUG_SET_BIP_DBG_STATUS = 8,
     DEBUG_SET_ETHERNET_DBG_STATUS = 9,
     DEBUG_SHOW_NETWORK_ROUTE_TABLE = 10,
+    DEBUG_SHOW_PERF_STATS = 11,
+    DEBUG_RESET_PERF_STATS = 12,
+    DEBUG_SET_PERF_STATUS = 13,
+    DEBUG_DUMP_TRACE = 14,
+    DEBUG_SET_TRACE_STATUS = 15,
+    DEBUG_SET_TRACE_CONSOLE_LEVEL = 16,
+    DEBUG_SHOW_OBJECT_MEMORY = 17,
     MAX_DEBUG_SERVICE_CHOICE
 } DEBUG_SERVICE_CHOICE;
 
@@ -94,10 +94,43 @@ extern int el_watch_destroy(el_loop_t *el, el_watch_t *watch);
 
 extern int el_watch_fd(el_watch_t *watch);
 
+/*
+ * el_sync/el_unsync stop the loop thread until the caller is done. Prefer
+ * el_call, which runs the work as one more task of the loop.
+ */
 extern void el_sync(el_loop_t *el);
 
 extern void el_unsync(el_loop_t *el);
 
+typedef void (*el_post_handler)(void *data);
+
+/**
+ * el_post - queue a closure to run on the loop thread, callable from any thread
+ *
+ * @el: the event loop
+ * @handler: run once on the loop thread, in posting order
+ * @data: argument of handler
+ *
+ * @return: 0 on success, <0 on error
+ */
+extern int el_post(el_loop_t *el, el_post_handler handler, void *data);
+
+/**
+ * el_call - run a closure on the loop thread and wait for it to finish
+ *
+ * Runs inline on the loop thread, before the loop starts and inside el_sync.
+ * The caller must not hold a lock that loop handlers take.
+ *
+ * @return: 0 on success, <0 on error
+ */
+extern int el_call(el_loop_t *el, el_post_handler handler, void *data);
+
+/*
+ * el_watch_* and el_timer_* are safe from any thread. On the loop thread they
+ * run without locking, from other threads the changes to loop-owned state are
+ * handed to the loop through the mailbox and the call returns without waiting.
+ */
+
 extern el_timer_t* el_timer_create(el_loop_t *el, unsigned timeout_ms);
 
 extern int el_timer_mod(el_loop_t *el, el_timer_t *timer, unsigned timeout_ms);
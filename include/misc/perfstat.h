@@ -0,0 +1,110 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * perfstat.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Performance statistics. Counters and latency histograms are kept per
+ * thread, the writer never takes a lock or an atomic operation. Readers sum
+ * the thread shards on query.
+ *
+ * History
+ */
+
+#ifndef _PERFSTAT_H_
+#define _PERFSTAT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERF_MAX_HIST               (256)
+#define PERF_MAX_COUNTER            (256)
+#define PERF_NAME_MAX               (48)
+
+/* id 0 is not registered(or table full), samples go to "overflow" */
+#define PERF_INVALID_ID             (0)
+
+/* log-linear buckets, 8 sub-buckets per power of 2, 12.5% precision */
+#define PERF_HIST_SUB_BITS          (3)
+#define PERF_HIST_BUCKETS           ((64 - PERF_HIST_SUB_BITS + 1) << PERF_HIST_SUB_BITS)
+
+typedef struct perf_hist_s {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t buckets[PERF_HIST_BUCKETS];
+} perf_hist_t;
+
+extern bool perf_enabled;
+
+/**
+ * perf_now_ns - start timestamp of a sample, 0 when statistic is disabled
+ */
+static inline uint64_t perf_now_ns(void)
+{
+    struct timespec ts;
+
+    if (!perf_enabled) {
+        return 0;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * perf_hist_register - get histogram id by name, registered on first call
+ *
+ * @fmt: printf style name, e.g. "port%d.relay"
+ *
+ * @return: id, PERF_INVALID_ID if table full
+ *
+ */
+extern int perf_hist_register(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+extern int perf_counter_register(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * perf_hist_since - add a sample of (now - start) to histogram of this thread
+ *
+ * @start: from perf_now_ns, sample is ignored if 0
+ *
+ */
+extern void perf_hist_since(int id, uint64_t start);
+
+extern void perf_hist_record(int id, uint64_t ns);
+
+extern void perf_counter_add(int id, uint64_t value);
+
+/* helpers for histograms owned by caller */
+extern void perf_hist_add(perf_hist_t *hist, uint64_t ns);
+
+extern void perf_hist_merge(perf_hist_t *dst, const perf_hist_t *src);
+
+extern uint64_t perf_hist_percentile(const perf_hist_t *hist, uint32_t permille);
+
+extern cJSON *perf_hist_to_json(const perf_hist_t *hist);
+
+/**
+ * perf_reset - clear all statistic, each thread clears its own shard lazily
+ */
+extern void perf_reset(void);
+
+extern void perf_set_enable(bool enable);
+
+extern cJSON *perf_get_status(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PERFSTAT_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * rcu.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Userspace read-copy-update. A reader only stores the grace period counter
+ * into its own per-thread slot, so read-side sections never share a cache
+ * line between threads. Writers publish a new copy with rcu_assign_pointer()
+ * and call synchronize_rcu() before freeing the old one.
+ *
+ * History
+ */
+
+#ifndef _RCU_H_
+#define _RCU_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "misc/list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rcu_reader_s {
+    uint64_t ctr;                       /* grace period at entry, 0 when outside */
+    uint32_t nesting;
+    bool registered;
+    struct list_head list;
+} __attribute__((aligned(64))) rcu_reader_t;
+
+extern uint64_t rcu_gp_ctr;
+
+extern __thread rcu_reader_t rcu_reader;
+
+extern void rcu_reader_register(void);
+
+/**
+ * rcu_read_lock - enter a read-side section, may nest
+ */
+static inline void rcu_read_lock(void)
+{
+    if (__builtin_expect(!rcu_reader.registered, 0)) {
+        rcu_reader_register();
+    }
+
+    if (rcu_reader.nesting++ == 0) {
+        __atomic_store_n(&rcu_reader.ctr, __atomic_load_n(&rcu_gp_ctr, __ATOMIC_RELAXED),
+            __ATOMIC_RELAXED);
+        /* pairs with the fence in synchronize_rcu, orders the store before later loads */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+static inline void rcu_read_unlock(void)
+{
+    if (--rcu_reader.nesting == 0) {
+        __atomic_store_n(&rcu_reader.ctr, 0, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * rcu_read_ongoing - whether the calling thread is inside a read-side section
+ */
+static inline bool rcu_read_ongoing(void)
+{
+    return rcu_reader.nesting != 0;
+}
+
+/**
+ * synchronize_rcu - wait until every read-side section that started before
+ * the call has finished
+ *
+ * The calling thread's own section is not waited for, so anything it still
+ * dereferences must not be freed until it leaves that section.
+ */
+extern void synchronize_rcu(void);
+
+#define rcu_dereference(p)          __atomic_load_n(&(p), __ATOMIC_CONSUME)
+
+#define rcu_assign_pointer(p, v)    __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RCU_H_ */
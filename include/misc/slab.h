@@ -0,0 +1,69 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * slab.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Fixed-size object slab. Objects are carved out of large chunks instead of
+ * one malloc each, which saves the allocator header and keeps objects of a
+ * kind packed together. Freed objects are kept on a free list for reuse,
+ * chunk memory is only returned by slab_destroy(). Not thread safe, the
+ * caller serializes.
+ *
+ * History
+ */
+
+#ifndef _SLAB_H_
+#define _SLAB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "misc/list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLAB_GROW_MIN           (16)
+#define SLAB_GROW_MAX           (4096)
+
+typedef struct slab_s {
+    uint32_t size;                      /* object size, rounded to pointer alignment */
+    uint32_t grow;                      /* objects in the next chunk */
+    uint32_t total;                     /* objects in all chunks */
+    uint32_t used;
+    uint32_t chunks;
+    size_t bytes;                       /* chunk memory including headers */
+    void *free_list;
+    uint8_t *next;                      /* never used tail of the newest chunk */
+    uint8_t *limit;
+    struct list_head chunk_list;
+} slab_t;
+
+extern void slab_init(slab_t *slab, size_t size);
+
+/**
+ * slab_reserve - make sure the next count allocations need no further chunk
+ *
+ * The missing part is allocated as one chunk of exactly that size, so a
+ * caller that knows how many objects it will create wastes nothing.
+ */
+extern int slab_reserve(slab_t *slab, uint32_t count);
+
+/* @return: zeroed object or NULL */
+extern void *slab_alloc(slab_t *slab);
+
+extern void slab_free(slab_t *slab, void *obj);
+
+extern bool slab_owns(const slab_t *slab, const void *obj);
+
+extern void slab_destroy(slab_t *slab);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SLAB_H_ */
@@ -0,0 +1,82 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * trace.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Binary trace ring. Each thread records fixed-size entries of the call site
+ * and raw arguments into its own ring, text is formatted only when the ring
+ * is dumped. The module debug macros go through TRACE_ERROR/WARN/VERBOS.
+ *
+ * History
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "debug.h"
+#include "misc/cJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_MAX_ARGS              (12)
+
+/* call site, format string is the format ID */
+typedef struct trace_site_s {
+    const char *fmt;
+    uint8_t level;
+    uint8_t parsed;
+    uint8_t nargs;
+    uint8_t kinds[TRACE_MAX_ARGS];
+} trace_site_t;
+
+/* levels echoed to stdout synchronously, DEBUG_LEVEL_* bits */
+extern uint32_t trace_console_level;
+
+extern bool trace_enabled;
+
+extern void trace_printf(trace_site_t *site, ...);
+
+#define TRACE_PRINTF(lvl, fmt, args...)                                 \
+do {                                                                    \
+    static trace_site_t __trace_site = {fmt, lvl, 0, 0, {0}};           \
+    if (0) {                                                            \
+        printf(fmt, ##args);                                            \
+    }                                                                   \
+    trace_printf(&__trace_site, ##args);                                \
+} while (0)
+
+#define TRACE_ERROR(fmt, args...)   TRACE_PRINTF(DEBUG_LEVEL_ERROR, fmt, ##args)
+
+#define TRACE_WARN(fmt, args...)    TRACE_PRINTF(DEBUG_LEVEL_WARN, fmt, ##args)
+
+#define TRACE_VERBOS(fmt, args...)  TRACE_PRINTF(DEBUG_LEVEL_VERBOS, fmt, ##args)
+
+extern void trace_set_enable(bool enable);
+
+extern void trace_set_console_level(uint32_t level);
+
+/**
+ * trace_dump - format records of all rings in time order
+ *
+ * @since: only records later than this timestamp(ns), 0 for all
+ * @max_len: stop when text of records exceeds this length
+ *
+ * @return: {"records": ["time [tid] L message", ...], "next": "ns"},
+ *          pass next as since of the following dump to stream the rings
+ *
+ */
+extern cJSON *trace_dump(uint64_t since, uint32_t max_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACE_H_ */
@@ -30,6 +30,47 @@ extern cJSON *load_json_file(const char *filename);
  */
 extern int save_json_file(cJSON *json, const char *filename);
 
+/**
+ * save binary snapshot atomically: write filename.tmp then rename
+ * @param magic, type and version of snapshot
+ * @return >=0 if success, <0 if error
+ */
+extern int save_snapshot_file(const char *filename, uint32_t magic, const void *data,
+        uint32_t len);
+
+/**
+ * load binary snapshot and check its magic and checksum
+ * @param len, return data length
+ * @param age, return wall clock seconds since saved, 0 if clock went back
+ * @return data which should be freed lately, NULL if fail
+ */
+extern void *load_snapshot_file(const char *filename, uint32_t magic, uint32_t *len,
+        uint32_t *age);
+
+/**
+ * @return 64-bit hash of data, e.g. to tell whether a file changed
+ */
+extern uint64_t data_hash64(const void *data, size_t len);
+
+/**
+ * save json tree as a binary image which loads without parsing text
+ * @param key, stored in image, load_json_image returns NULL if key differs
+ * @return >=0 if success, <0 if error
+ */
+extern int save_json_image(const char *filename, uint32_t magic, cJSON *json, uint64_t key);
+
+/**
+ * load json tree saved by save_json_image. Items may be added to the tree,
+ * but none of its own items may be deleted, detached or modified
+ * @return tree which should be freed by free_json_image, NULL if fail or key differs
+ */
+extern cJSON *load_json_image(const char *filename, uint32_t magic, uint64_t key);
+
+/**
+ * free tree returned by load_json_image, and items added to it
+ */
+extern void free_json_image(cJSON *json);
+
 /**
  * decode hex string into bytes
  * @param out, out buffer
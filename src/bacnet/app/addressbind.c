@@ -31,6 +31,9 @@ static uint32_t Address_Cache_TTL = 300;
 static uint32_t Whois_Max_Retry;
 static uint32_t Max_Address_Cache = 512;
 static uint32_t Max_WhoIs_Cache = 512;
+static char *Cache_File = NULL;
+static uint32_t Save_Interval = DEFAULT_SAVE_INTERVAL;
+static el_timer_t *Save_Timer = NULL;
 
 static int __address_hash(const bacnet_addr_t *addr)
 {
@@ -310,6 +313,7 @@ int address_add(uint32_t device_id, uint32_t max_apdu, const bacnet_addr_t *addr
 
     /* update entry */
     entry_did->is_static = is_static;
+    entry_did->revalidate = false;
     entry_did->max_apdu = max_apdu;
 
     if (is_static) {
@@ -430,9 +434,11 @@ bool query_address_from_device(uint32_t device_id, uint32_t *max_apdu, bacnet_ad
                 __list_del_entry(&(entry->l_node));
                 list_add(&(entry->l_node), &(Cache_Manager.active_list));
 
-                if (cur_time - entry->update_time > (Address_Cache_TTL/2)) {
+                if ((entry->revalidate)
+                        || (cur_time - entry->update_time > (Address_Cache_TTL/2))) {
                     send_whois = true;
                     net = entry->address.net;
+                    entry->revalidate = false;
                 }
             }
         } else {
@@ -806,6 +812,132 @@ int read_address_binding(BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
     return len;
 }
 
+/* LRUӾɵ±涯̬󶨼, ָʱͬ˳뼴ɻԭLRU */
+int address_save_cache(void)
+{
+    Address_Cache_Entry_t *entry;
+    Address_Snapshot_t *snap;
+    struct list_head *pos;
+    unsigned cur_time, age;
+    uint32_t count;
+    int rv;
+
+    if (Cache_File == NULL) {
+        return OK;
+    }
+
+    pthread_mutex_lock(&(Cache_Manager.lock));
+
+    snap = (Address_Snapshot_t *)malloc(sizeof(Address_Snapshot_t)
+        * (Cache_Manager.active_count + 1));
+    if (snap == NULL) {
+        APP_ERROR("%s: malloc failed\r\n", __func__);
+        pthread_mutex_unlock(&(Cache_Manager.lock));
+        return -ENOMEM;
+    }
+
+    count = 0;
+    cur_time = el_current_second();
+    list_for_each_prev(pos, &(Cache_Manager.active_list)) {
+        entry = list_entry(pos, Address_Cache_Entry_t, l_node);
+        age = cur_time - entry->update_time;
+        if (age >= Address_Cache_TTL) {
+            continue;
+        }
+
+        snap[count].device_id = entry->device_id;
+        snap[count].age = age;
+        snap[count].max_apdu = entry->max_apdu;
+        snap[count].net = entry->address.net;
+        snap[count].len = entry->address.len;
+        memcpy(snap[count].adr, entry->address.adr, MAX_MAC_LEN);
+        count++;
+    }
+
+    pthread_mutex_unlock(&(Cache_Manager.lock));
+
+    rv = save_snapshot_file(Cache_File, ADDRESS_SNAPSHOT_MAGIC, snap,
+        count * sizeof(Address_Snapshot_t));
+    free(snap);
+    if (rv < 0) {
+        APP_ERROR("%s: save %s failed(%d)\r\n", __func__, Cache_File, rv);
+        return rv;
+    }
+
+    APP_VERBOS("%s: %u entries saved\r\n", __func__, count);
+
+    return OK;
+}
+
+/* ͣʱδTTLıŻָ, ״βѯʱWho-IsУ */
+static void address_load_cache(void)
+{
+    Address_Cache_Entry_t *entry;
+    Address_Snapshot_t *snap;
+    bacnet_addr_t addr;
+    uint32_t len, down, age, count, loaded, i;
+    unsigned cur_time;
+
+    snap = (Address_Snapshot_t *)load_snapshot_file(Cache_File, ADDRESS_SNAPSHOT_MAGIC, &len,
+        &down);
+    if (snap == NULL) {
+        return;
+    }
+
+    if (len % sizeof(Address_Snapshot_t)) {
+        APP_ERROR("%s: invalid snapshot len(%u)\r\n", __func__, len);
+        free(snap);
+        return;
+    }
+
+    count = len / sizeof(Address_Snapshot_t);
+    loaded = 0;
+    for (i = 0; i < count; i++) {
+        age = snap[i].age + down;
+        if ((age < snap[i].age) || (age >= Address_Cache_TTL)) {
+            continue;
+        }
+
+        if ((snap[i].len > MAX_MAC_LEN) || (snap[i].device_id >= BACNET_MAX_INSTANCE)) {
+            APP_ERROR("%s: invalid snapshot entry(%u)\r\n", __func__, i);
+            continue;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.net = snap[i].net;
+        addr.len = snap[i].len;
+        memcpy(addr.adr, snap[i].adr, snap[i].len);
+        if (address_add(snap[i].device_id, snap[i].max_apdu, &addr, false) < 0) {
+            continue;
+        }
+
+        cur_time = el_current_second();
+
+        pthread_mutex_lock(&(Cache_Manager.lock));
+
+        entry = _address_find(snap[i].device_id);
+        if (entry) {
+            entry->update_time = cur_time - age;
+            entry->revalidate = true;
+            loaded++;
+        }
+
+        pthread_mutex_unlock(&(Cache_Manager.lock));
+    }
+
+    free(snap);
+
+    APP_WARN("%s: %u of %u entries restored from %s, down %u s\r\n", __func__, loaded, count,
+        Cache_File, down);
+}
+
+static void address_save_timer(el_timer_t *timer)
+{
+    (void)address_save_cache();
+
+    (void)el_timer_mod(&el_default_loop, timer, Save_Interval * 1000);
+}
+
 int address_init(cJSON *cfg)
 {
     cJSON *tmp;
@@ -867,6 +999,33 @@ int address_init(cJSON *cfg)
     INIT_LIST_HEAD(&(Cache_Manager.static_list));
     INIT_LIST_HEAD(&(Cache_Manager.active_list));
 
+    tmp = cJSON_GetObjectItem(cfg, "Cache_File");
+    if ((tmp != NULL) && (tmp->type != cJSON_String)) {
+        APP_ERROR("%s: invalid Cache_File item\r\n", __func__);
+        return -EPERM;
+    }
+    if ((tmp != NULL) && (tmp->valuestring[0])) {
+        Cache_File = strdup(tmp->valuestring);
+        if (Cache_File == NULL) {
+            APP_ERROR("%s: strdup Cache_File failed\r\n", __func__);
+            return -ENOMEM;
+        }
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "Save_Interval");
+    if ((tmp != NULL) && (tmp->type != cJSON_Number)) {
+        APP_ERROR("%s: invalid Save_Interval item\r\n", __func__);
+        rv = -EPERM;
+        goto out0;
+    } else if (tmp != NULL) {
+        if (tmp->valueint < MIN_SAVE_INTERVAL) {
+            APP_WARN("%s: too small Save_Interval(%d), use %d\r\n", __func__,
+                    tmp->valueint, MIN_SAVE_INTERVAL);
+            Save_Interval = MIN_SAVE_INTERVAL;
+        } else
+            Save_Interval = (uint32_t)tmp->valueint;
+    }
+
     Whois_Manager.count = 0;
     hash_init(Whois_Manager.table);
     INIT_LIST_HEAD(&(Whois_Manager.list));
@@ -874,23 +1033,59 @@ int address_init(cJSON *cfg)
     rv = pthread_mutex_init(&(Cache_Manager.lock), NULL);
     if (rv) {
         APP_ERROR("%s: init Cache_Manager lock failed cause %s\r\n", __func__, strerror(rv));
-        return -EPERM;
+        rv = -EPERM;
+        goto out0;
     }
 
     rv = pthread_mutex_init(&(Whois_Manager.lock), NULL);
     if (rv) {
         APP_ERROR("%s: init Whois_Manager lock failed cause %s\r\n", __func__, strerror(rv));
-        (void)pthread_mutex_destroy(&(Cache_Manager.lock));
-        return -EPERM;
+        rv = -EPERM;
+        goto out1;
+    }
+
+    if (Cache_File) {
+        address_load_cache();
+
+        Save_Timer = el_timer_create(&el_default_loop, Save_Interval * 1000);
+        if (Save_Timer == NULL) {
+            APP_ERROR("%s: create save timer failed\r\n", __func__);
+            rv = -EPERM;
+            goto out2;
+        }
+        Save_Timer->handler = address_save_timer;
+        Save_Timer->data = NULL;
     }
 
     APP_VERBOS("%s: ok\r\n", __func__);
 
     return OK;
+
+out2:
+    whois_destroy();
+    address_destroy();
+    (void)pthread_mutex_destroy(&(Whois_Manager.lock));
+
+out1:
+    (void)pthread_mutex_destroy(&(Cache_Manager.lock));
+
+out0:
+    free(Cache_File);
+    Cache_File = NULL;
+
+    return rv;
 }
 
 void address_exit(void)
 {
+    if (Save_Timer) {
+        (void)el_timer_destroy(&el_default_loop, Save_Timer);
+        Save_Timer = NULL;
+    }
+
+    free(Cache_File);
+    Cache_File = NULL;
+
     whois_destroy();
     address_destroy();
 
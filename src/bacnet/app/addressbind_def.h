@@ -26,6 +26,10 @@
 
 #define MIN_CACHE_SIZE                      (64)
 
+#define ADDRESS_SNAPSHOT_MAGIC              (0x42414331)    /* "BAC1" */
+#define DEFAULT_SAVE_INTERVAL               (60)
+#define MIN_SAVE_INTERVAL                   (5)
+
 typedef struct Address_Manager_s {
     pthread_mutex_t lock;
     DECLARE_HASHTABLE(d2a_table, ADDRESS_CACHE_BITS);   /* device_id to address */
@@ -45,6 +49,7 @@ typedef struct Whois_Manager_s {
 
 typedef struct Address_Cache_Entry_s {
     bool is_static;
+    bool revalidate;                                /* ӿջָ, ״βѯʱWho-Is */
     uint32_t device_id : 22;
     uint16_t max_apdu;
     bacnet_addr_t address;
@@ -62,5 +67,15 @@ typedef struct Whois_Cache_Entry_s {
     struct hlist_node h_node;
 } Whois_Cache_Entry_t;
 
+/* ַеһ, ֻ涯̬ */
+typedef struct Address_Snapshot_s {
+    uint32_t device_id;
+    uint32_t age;                                   /* ʱϴθµ */
+    uint16_t max_apdu;
+    uint16_t net;
+    uint8_t len;
+    uint8_t adr[MAX_MAC_LEN];
+} __attribute__((packed)) Address_Snapshot_t;
+
 #endif /* _ADDRESSBIND_DEF_H_ */
 
@@ -25,6 +25,8 @@
 #include "bacnet/service/ihave.h"
 #include "bacnet/service/iam.h"
 #include "bacnet/service/timesync.h"
+#include "bacnet/service/getevent.h"
+#include "bacnet/service/alarmack.h"
 #include "bacnet/object/device.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/datetime.h"
@@ -37,6 +39,8 @@
 #include "bacnet/addressbind.h"
 #include "bacnet/network.h"
 #include "bacnet/slaveproxy.h"
+#include "bacnet/ratelimit.h"
+#include "misc/perfstat.h"
 
 extern bool is_app_exist;
 
@@ -98,6 +102,29 @@ static unconfirmed_service_handler Unconfirmed_Function[MAX_BACNET_UNCONFIRMED_S
 
 static uint8_t __supported_service_bits[(MAX_BACNET_SERVICE_SUPPORTED + 7) >> 3] = {0,};
 
+/* names of service latency histograms */
+static const char *confirmed_service_name[MAX_BACNET_CONFIRMED_SERVICE] = {
+    "acknowledgeAlarm", "confirmedCOVNotification", "confirmedEventNotification",
+    "getAlarmSummary", "getEnrollmentSummary", "subscribeCOV", "atomicReadFile",
+    "atomicWriteFile", "addListElement", "removeListElement", "createObject", "deleteObject",
+    "readProperty", "readPropertyConditional", "readPropertyMultiple", "writeProperty",
+    "writePropertyMultiple", "deviceCommunicationControl", "confirmedPrivateTransfer",
+    "confirmedTextMessage", "reinitializeDevice", "vtOpen", "vtClose", "vtData", "authenticate",
+    "requestKey", "readRange", "lifeSafetyOperation", "subscribeCOVProperty",
+    "getEventInformation"
+};
+
+static const char *unconfirmed_service_name[MAX_BACNET_UNCONFIRMED_SERVICE] = {
+    "iAm", "iHave", "unconfirmedCOVNotification", "unconfirmedEventNotification",
+    "unconfirmedPrivateTransfer", "unconfirmedTextMessage", "timeSynchronization", "whoHas",
+    "whoIs", "utcTimeSynchronization", "writeGroup"
+};
+
+/* histogram ids, registered on first use */
+static int confirmed_service_perf[MAX_BACNET_CONFIRMED_SERVICE];
+
+static int unconfirmed_service_perf[MAX_BACNET_UNCONFIRMED_SERVICE];
+
 void apdu_get_service_supported(BACNET_BIT_STRING *services)
 {
     bitstring_init(services, __supported_service_bits, MAX_BACNET_SERVICE_SUPPORTED);
@@ -164,6 +191,9 @@ void apdu_set_default_service_handler(void)
     apdu_set_confirmed_handler(SERVICE_CONFIRMED_READ_RANGE, handler_read_range);
     apdu_set_confirmed_handler(SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL, 
         handler_device_communication_control);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_GET_EVENT_INFORMATION,
+        handler_get_event_information);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM, handler_alarm_ack);
 
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, handler_i_am);
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_HAVE, handler_i_have);
@@ -369,6 +399,7 @@ void apdu_handler(bacnet_buf_t *apdu, bool der, bacnet_buf_t *reply_apdu, bacnet
     unconfirmed_service_handler unconfirmed_handler;
     uint8_t service_choice;
     BACNET_PDU_TYPE apdu_type;
+    uint64_t start;
     int rv;
     
     if ((apdu == NULL) || (apdu->data == NULL) || (apdu->data_len == 0) || (reply_apdu == NULL)) {
@@ -381,7 +412,7 @@ void apdu_handler(bacnet_buf_t *apdu, bool der, bacnet_buf_t *reply_apdu, bacnet
     }
 
     if (app_dbg_verbos) {
-        printf("\r\napdu_handler: receive apdu from SMAC: ");
+        APP_VERBOS("\r\napdu_handler: receive apdu from SMAC: ");
         PRINT_BACNET_ADDRESS(src);
     }
 
@@ -413,7 +444,15 @@ void apdu_handler(bacnet_buf_t *apdu, bool der, bacnet_buf_t *reply_apdu, bacnet
             if (service_data.max_resp < MAX_APDU) {
                 bacnet_buf_resize(reply_apdu, service_data.max_resp);
             }
+            start = perf_now_ns();
             confirmed_handler(&service_data, reply_apdu, src);
+            if (start) {
+                if (confirmed_service_perf[service_data.service_choice] == PERF_INVALID_ID) {
+                    confirmed_service_perf[service_data.service_choice] = perf_hist_register(
+                        "apdu.confirmed.%s", confirmed_service_name[service_data.service_choice]);
+                }
+                perf_hist_since(confirmed_service_perf[service_data.service_choice], start);
+            }
         } else {
             /* send a reject cause we don't support this choice */
             APP_WARN("%s: unsupported confirmed service choice(%d)\r\n", __func__,
@@ -435,9 +474,21 @@ void apdu_handler(bacnet_buf_t *apdu, bool der, bacnet_buf_t *reply_apdu, bacnet
             break;
         }
         
+        if (!rate_limit_unconfirmed(service_choice, src)) {
+            break;
+        }
+
         unconfirmed_handler = apdu_find_unconfirmed_handler(service_choice);
         if (unconfirmed_handler) {
+            start = perf_now_ns();
             unconfirmed_handler(&apdu->data[2], apdu->data_len - 2, src);
+            if (start) {
+                if (unconfirmed_service_perf[service_choice] == PERF_INVALID_ID) {
+                    unconfirmed_service_perf[service_choice] = perf_hist_register(
+                        "apdu.unconfirmed.%s", unconfirmed_service_name[service_choice]);
+                }
+                perf_hist_since(unconfirmed_service_perf[service_choice], start);
+            }
         } else {
             APP_WARN("%s: unsupported unconfirmed service choice(%d)\r\n", __func__, service_choice);
         }
@@ -17,6 +17,8 @@
 #include "bacnet/object/device.h"
 #include "bacnet/bacnet.h"
 #include "bacnet/tsm.h"
+#include "bacnet/ratelimit.h"
+#include "bacnet/shmio.h"
 #include "module_mng.h"
 #include "debug.h"
 
@@ -51,7 +53,7 @@ int app_startup(void)
     cJSON *app_cfg, *tmp;
     int rv;
 
-    app_cfg = bacnet_get_app_cfg();
+    app_cfg = bacnet_load_app_cfg();
     if (app_cfg == NULL) {
         APP_ERROR("%s: get app cfg failed\r\n", __func__);
         return -EPERM;
@@ -96,16 +98,51 @@ int app_startup(void)
         goto out1;
     }
 
+    tmp = cJSON_GetObjectItem(app_cfg, "Rate_Limit");
+    if ((tmp != NULL) && (tmp->type != cJSON_Object)) {
+        APP_ERROR("%s: get Rate_Limit item failed\r\n", __func__);
+        rv = -EPERM;
+        goto out2;
+    } else if (tmp == NULL) {
+        tmp = cJSON_CreateObject();
+        cJSON_AddItemToObject(app_cfg, "Rate_Limit", tmp);
+    }
+
+    rv = rate_limit_init(tmp);
+    if (rv < 0) {
+        APP_ERROR("%s: rate limit init failed(%d)\r\n", __func__, rv);
+        goto out2;
+    }
+
     rv = object_init(app_cfg);
     if (rv < 0) {
         APP_ERROR("%s: object init failed(%d)\r\n", __func__, rv);
-        goto out2;
+        goto out3;
+    }
+
+    tmp = cJSON_GetObjectItem(app_cfg, "Shared_IO");
+    if ((tmp != NULL) && (tmp->type != cJSON_Object)) {
+        APP_ERROR("%s: get Shared_IO item failed\r\n", __func__);
+        rv = -EPERM;
+        goto out4;
+    }
+
+    rv = shmio_init(tmp);
+    if (rv < 0) {
+        APP_ERROR("%s: shared io init failed(%d)\r\n", __func__, rv);
+        goto out4;
     }
 
     is_app_exist = true;
     app_set_dbg_level(0);
     goto out0;
 
+out4:
+    object_exit();
+
+out3:
+    rate_limit_exit();
+
 out2:
     address_exit();
 
@@ -113,7 +150,7 @@ out1:
     tsm_exit();
 
 out0:
-    cJSON_Delete(app_cfg);
+    bacnet_release_app_cfg(app_cfg, rv >= 0);
 
     return rv;
 }
@@ -121,6 +158,10 @@ out0:
 void app_stop(void)
 {
     is_app_exist = false;
+
+    shmio_exit();
+
+    (void)address_save_cache();
     
     return;
 }
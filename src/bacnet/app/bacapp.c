@@ -22,28 +22,6 @@
 #include "bacnet/object/device.h"
 #include "bacnet/bactext.h"
 
-static int hexstr2byte(char* hexstr, uint8_t *byte, size_t size)
-{
-    uint32_t value;
-    int len = strlen(hexstr);
-    if (len % 2 != 0)
-        return -EINVAL;
-
-    len >>= 1;
-    if (len > size)
-        return -EINVAL;
-
-    for (int i=0; i<len; ++i) {
-        if (sscanf(hexstr, "%2X", &value) != 1)
-            return -EINVAL;
-
-        byte[i] = value;
-        hexstr += 2;
-    }
-
-    return len;
-}
-
 int bacapp_encode_application_data(uint8_t *pdu, BACNET_APPLICATION_DATA_VALUE *value)
 {
     int len;
@@ -639,671 +617,697 @@ bool bacapp_snprint_value(char *str, size_t str_len, uint8_t *buf, uint32_t size
     return true;
 }
 
-static char* opening_tag_pat = "^[ \t]*([0-9]+)\\{(.*[^ \t])?[ \t]*$";
-static char* closing_tag_pat = "(\\}[0-9]*[ \t]*)+$";
-static char* context_unknown_pat = "^[ \t]*([0-9]+)\\?(([0-9a-fA-F][0-9a-fA-F])*)[ \t]*$";
-static char* context_appliation_pat = "^[ \t]*([0-9]+):(.*[^ \t])[ \t]*$";
-
-static char* null_pat = "^[ \t]*(null|NULL)[ \t]*$";
-static char* boolean_pat = "^[ \t]*((true|TRUE|True)|(false|FALSE|False))[ \t]*$";
-static char* object_id_pat = "^[ \t]*[oO]([0-9]+)\\.([0-9]+)[ \t]*$";
-static char* unsigned_pat = "^[ \t]*[uU]([0-9]+)[ \t]*$";
-static char* signed_pat = "^[ \t]*[sS](-?[0-9]+)[ \t]*$";
-static char* real_pat = "^[ \t]*[fF](-?[0-9]+(\\.[0-9]*)?)[ \t]*$";
-static char* double_pat = "^[ \t]*(lf|LF)(-?[0-9]+(\\.[0-9]*)?)[ \t]*$";
-static char* char_string_pat = "^[ \t]*[cC]([0-9]*)((:(.*[^ \t])?)|(x([0-9a-zA-Z][0-9a-zA-Z])*))[ \t]*$";
-static char* octet_string_pat = "^[ \t]*[xX](([0-9a-fA-F][0-9a-fA-F])*)[ \t]*$";
-static char* bit_string_pat = "^[ \t]*[bB]([01]*)[ \t]*$";
-static char* enumerated_pat = "^[ \t]*[eE]([0-9]+)[ \t]*$";
-static char* date_pat = "^[ \t]*[dD]([0-9]{2,4})?\\.([0-9]{1,2})?\\.([0-9]{1,2})?\\.([1-7])?[ \t]*$";
-static char* time_pat = "^[ \t]*[tT]([0-9]{1,2})?:([0-9]{1,2})?:([0-9]{1,2})?\\.([0-9]{1,2})?[ \t]*$";
-
-#include "regex.h"
+/*
+ * Value syntax of bacapp_parse_application_data, items separated by ',':
+ *   N{ ... }N       context opening/closing tag N (0~255), "}" closes the innermost
+ *   N?hex           context tag N with raw content
+ *   N:value         value encoded with context tag N
+ *   null true false
+ *   uN sN eN        unsigned, signed, enumerated
+ *   fR lfR          real, double: -?[0-9]+(.[0-9]*)?
+ *   oT.I            object identifier
+ *   b[01]*          bit string
+ *   x(hh)*          octet string
+ *   c[E]:text cx(hh)*  character string with optional encoding E
+ *   d[Y].[M].[D].[W]   date, empty field is unspecified
+ *   t[H]:[M]:[S].[h]   time, empty field is unspecified
+ * The letters may also be upper case, blanks around items are ignored.
+ */
 
-/* used to load the app data struct with the proper data converted from a command line argument */
-bool bacapp_parse_application_data(bacnet_buf_t *pdu, char *argv)
+#define PARSE_MAX_NESTING           (16)
+#define PARSE_SCALAR_MAX            (16)
+
+typedef struct parse_state_s {
+    bacnet_buf_t *pdu;
+    uint8_t tags[PARSE_MAX_NESTING];    /* opening tags not yet closed */
+    int level;
+} parse_state_t;
+
+static inline bool parse_is_blank(char c)
 {
-    regex_t opening_tag_re, closing_tag_re, context_unknown_re,
-            context_application_re, null_re, boolean_re,
-            object_id_re, unsigned_re, signed_re, real_re,
-            double_re, char_string_re, octet_string_re,
-            bit_string_re, enumerated_re, date_re, time_re;
-    regmatch_t matchptr[10];
-    char *save_ptr, *item_ptr;
-    bool status;
-    uint8_t push_stack[16], pop_stack[16];
-    int rv, push_level = 0, pop_level = 0;
-
-    if (regcomp(&opening_tag_re, opening_tag_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile opening tag pattern fail\r\n");
-        return false;
+    return (c == ' ') || (c == '\t');
+}
+
+static inline bool parse_is_digit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+static int parse_hex_value(char c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    } else if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    } else if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
     }
 
-    if (regcomp(&closing_tag_re, closing_tag_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile closing tag pattern fail\r\n");
-        return false;
+    return -1;
+}
+
+static void parse_trim(const char **s, const char **e)
+{
+    while ((*s < *e) && parse_is_blank(**s)) {
+        (*s)++;
+    }
+    while ((*e > *s) && parse_is_blank(*(*e - 1))) {
+        (*e)--;
+    }
+}
+
+/* return the number of digits consumed, -1 if the value exceeds uint32_t */
+static int parse_digits(const char **p, const char *e, uint32_t *value)
+{
+    uint64_t v;
+    int count;
+
+    v = 0;
+    count = 0;
+    while ((*p < e) && parse_is_digit(**p)) {
+        v = v * 10 + (**p - '0');
+        if (v > UINT32_MAX) {
+            return -1;
+        }
+        (*p)++;
+        count++;
     }
 
-    if (regcomp(&context_unknown_re, context_unknown_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile context unknown tag pattern fail\r\n");
-        return false;
+    *value = (uint32_t)v;
+
+    return count;
+}
+
+/* the whole [s, e) must be one unsigned number */
+static bool parse_uint(const char *s, const char *e, uint32_t *value)
+{
+    return (parse_digits(&s, e, value) > 0) && (s == e);
+}
+
+/* an optional field of min~max digits, *value stays 0xff when empty */
+static bool parse_field(const char **p, const char *e, int min, int max, uint32_t *value)
+{
+    int count;
+
+    *value = 0xff;
+    count = parse_digits(p, e, value);
+    if (count == 0) {
+        *value = 0xff;
+        return true;
     }
 
-    if (regcomp(&context_application_re, context_appliation_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile context application tag pattern fail\r\n");
+    return (count >= min) && (count <= max);
+}
+
+/* -?[0-9]+(.[0-9]*)? */
+static bool parse_is_decimal(const char *s, const char *e)
+{
+    if ((s < e) && (*s == '-')) {
+        s++;
+    }
+    if ((s == e) || !parse_is_digit(*s)) {
         return false;
     }
+    while ((s < e) && parse_is_digit(*s)) {
+        s++;
+    }
+    if ((s < e) && (*s == '.')) {
+        s++;
+        while ((s < e) && parse_is_digit(*s)) {
+            s++;
+        }
+    }
+
+    return s == e;
+}
+
+/* length of the hex pairs in [s, e), -1 if malformed */
+static int parse_hex_length(const char *s, const char *e)
+{
+    const char *p;
+
+    if ((e - s) & 1) {
+        return -1;
+    }
+    for (p = s; p < e; p++) {
+        if (parse_hex_value(*p) < 0) {
+            return -1;
+        }
+    }
+
+    return (e - s) >> 1;
+}
+
+static void parse_hex(const char *s, int len, uint8_t *out)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        out[i] = (uint8_t)((parse_hex_value(s[2 * i]) << 4) | parse_hex_value(s[2 * i + 1]));
+    }
+}
+
+/* bytes taken by the tag of a value with len content octets */
+static int parse_tag_size(bool context, uint32_t tag, uint32_t len)
+{
+    int size;
+
+    size = ((context) && (tag > 14))? 2: 1;
+    if (len > 65535) {
+        size += 5;
+    } else if (len > 253) {
+        size += 3;
+    } else if (len > 4) {
+        size += 1;
+    }
+
+    return size;
+}
+
+static inline uint8_t *parse_tail(parse_state_t *st)
+{
+    return st->pdu->data + st->pdu->data_len;
+}
 
-    if (regcomp(&null_re, null_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile null pattern fail\r\n");
+static bool parse_room(parse_state_t *st, int len)
+{
+    if (st->pdu->end - parse_tail(st) < len) {
+        APP_ERROR("%s: pdu overflow\r\n", __func__);
         return false;
     }
 
-    if (regcomp(&boolean_re, boolean_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile boolean pattern fail\r\n");
+    return true;
+}
+
+/* small values are encoded aside first so that the pdu is never overrun */
+static bool parse_put(parse_state_t *st, const uint8_t *data, int len)
+{
+    if (!parse_room(st, len)) {
         return false;
     }
 
-    if (regcomp(&object_id_re, object_id_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile object_id pattern fail\r\n");
+    memcpy(parse_tail(st), data, len);
+    st->pdu->data_len += len;
+
+    return true;
+}
+
+/* octet string and the context tag of unknown content, both hex pairs */
+static bool parse_octets(parse_state_t *st, bool context, uint32_t tag, const char *s,
+                const char *e)
+{
+    uint8_t buf[MAX_APDU];
+    int len;
+
+    len = parse_hex_length(s, e);
+    if ((len < 0) || (len > sizeof(buf))) {
+        return false;
+    }
+    if (!parse_room(st, parse_tag_size(context, tag, len) + len)) {
         return false;
     }
 
-    if (regcomp(&unsigned_re, unsigned_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile unsigned pattern fail\r\n");
+    parse_hex(s, len, buf);
+    if (context) {
+        len = encode_context_raw_octet_string(parse_tail(st), tag, buf, len);
+    } else {
+        len = encode_application_raw_octet_string(parse_tail(st), buf, len);
+    }
+    st->pdu->data_len += len;
+
+    return true;
+}
+
+/* c[E]:text or c[E]x(hh)*, text may contain anything but ',' */
+static bool parse_char_string(parse_state_t *st, bool context, uint32_t tag, const char *s,
+                const char *e)
+{
+    BACNET_CHARACTER_STRING char_string;
+    uint8_t buf[MAX_APDU];
+    uint32_t encoding;
+    int count, len;
+
+    encoding = CHARACTER_ANSI_X34;
+    count = parse_digits(&s, e, &encoding);
+    if (count < 0) {
+        return false;
+    } else if (count == 0) {
+        encoding = CHARACTER_ANSI_X34;
+    } else if (encoding >= MAX_CHARACTER_STRING_ENCODING) {
+        APP_ERROR("%s: unknown encoding(%u)\r\n", __func__, encoding);
         return false;
     }
 
-    if (regcomp(&signed_re, signed_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile signed pattern fail\r\n");
+    if ((s < e) && (*s == ':')) {
+        s++;
+        len = e - s;
+        if (len >= sizeof(buf)) {
+            return false;
+        }
+        char_string.value = (char *)s;
+    } else if ((s < e) && (*s == 'x')) {
+        s++;
+        len = parse_hex_length(s, e);
+        if ((len < 0) || (len > sizeof(buf))) {
+            return false;
+        }
+        parse_hex(s, len, buf);
+        char_string.value = (char *)buf;
+    } else {
         return false;
     }
+    char_string.encoding = encoding;
+    char_string.length = len;
 
-    if (regcomp(&real_re, real_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile real pattern fail\r\n");
+    if (!parse_room(st, parse_tag_size(context, tag, len + 1) + len + 1)) {
         return false;
     }
+    if (context) {
+        len = encode_context_character_string(parse_tail(st), tag, &char_string);
+    } else {
+        len = encode_application_character_string(parse_tail(st), &char_string);
+    }
+    st->pdu->data_len += len;
+
+    return true;
+}
 
-    if (regcomp(&double_re, double_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile double pattern fail\r\n");
+static bool parse_bit_string(parse_state_t *st, bool context, uint32_t tag, const char *s,
+                const char *e)
+{
+    BACNET_BIT_STRING bit_string;
+    uint8_t buf[MAX_APDU];
+    int bits, i;
+
+    bits = e - s;
+    if (bits > (sizeof(buf) << 3)) {
         return false;
     }
 
-    if (regcomp(&char_string_re, char_string_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile char_string pattern fail\r\n");
+    /* the unused bits of the last octet shall be zero */
+    bit_string.value = buf;
+    bitstring_resize(&bit_string, bits);
+    memset(buf, 0, bit_string.byte_len);
+    for (i = 0; i < bits; i++) {
+        if ((s[i] != '0') && (s[i] != '1')) {
+            return false;
+        }
+        bitstring_set_bit(&bit_string, i, s[i] == '1');
+    }
+
+    if (!parse_room(st, parse_tag_size(context, tag, bit_string.byte_len + 1)
+            + bit_string.byte_len + 1)) {
         return false;
     }
+    if (context) {
+        i = encode_context_bitstring(parse_tail(st), tag, &bit_string);
+    } else {
+        i = encode_application_bitstring(parse_tail(st), &bit_string);
+    }
+    st->pdu->data_len += i;
 
-    if (regcomp(&octet_string_re, octet_string_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile octet_string pattern fail\r\n");
+    return true;
+}
+
+static bool parse_date(const char *s, const char *e, BACNET_DATE *date)
+{
+    uint32_t year, month, day, wday;
+
+    if (!parse_field(&s, e, 2, 4, &year) || (s == e) || (*s++ != '.')
+            || !parse_field(&s, e, 1, 2, &month) || (s == e) || (*s++ != '.')
+            || !parse_field(&s, e, 1, 2, &day) || (s == e) || (*s++ != '.')
+            || !parse_field(&s, e, 1, 1, &wday) || (s != e)) {
         return false;
     }
 
-    if (regcomp(&bit_string_re, bit_string_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile bit_string pattern fail\r\n");
+    if (year != 0xff) {
+        if ((year < 1900) || (year > 1900 + 254)) {
+            APP_ERROR("%s: invalid year\r\n", __func__);
+            return false;
+        }
+        year -= 1900;
+    }
+    if ((month != 0xff) && ((month < 1) || (month > 12))) {
+        APP_ERROR("%s: invalid month\r\n", __func__);
+        return false;
+    }
+    if ((day != 0xff) && ((day < 1) || (day > 31))) {
+        APP_ERROR("%s: invalid day\r\n", __func__);
+        return false;
+    }
+    if ((wday != 0xff) && ((wday < 1) || (wday > 7))) {
+        APP_ERROR("%s: invalid weekday\r\n", __func__);
         return false;
     }
 
-    if (regcomp(&enumerated_re, enumerated_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile enumerated pattern fail\r\n");
+    date->year = year;
+    date->month = month;
+    date->day = day;
+    date->wday = wday;
+
+    return true;
+}
+
+static bool parse_time(const char *s, const char *e, BACNET_TIME *time)
+{
+    uint32_t hour, minute, second, hundredths;
+
+    if (!parse_field(&s, e, 1, 2, &hour) || (s == e) || (*s++ != ':')
+            || !parse_field(&s, e, 1, 2, &minute) || (s == e) || (*s++ != ':')
+            || !parse_field(&s, e, 1, 2, &second) || (s == e) || (*s++ != '.')
+            || !parse_field(&s, e, 1, 2, &hundredths) || (s != e)) {
         return false;
     }
 
-    if (regcomp(&date_re, date_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile date pattern fail\r\n");
+    if (((hour != 0xff) && (hour > 23)) || ((minute != 0xff) && (minute > 59))
+            || ((second != 0xff) && (second > 59))
+            || ((hundredths != 0xff) && (hundredths > 99))) {
+        APP_ERROR("%s: invalid time\r\n", __func__);
         return false;
     }
 
-    if (regcomp(&time_re, time_pat, REG_EXTENDED)) {
-        APP_ERROR("regex compile time pattern fail\r\n");
+    time->hour = hour;
+    time->min = minute;
+    time->sec = second;
+    time->hundredths = hundredths;
+
+    return true;
+}
+
+static bool parse_keyword(const char *s, const char *e, const char *lower, const char *upper,
+                const char *title)
+{
+    size_t len;
+
+    len = e - s;
+    if (len != strlen(lower)) {
         return false;
     }
 
-    item_ptr = strtok_r(argv, ",", &save_ptr);
-    do {
-        unsigned tag_number;
-nested:
-        status = false;
-        rv = regexec(&opening_tag_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            if (sscanf(&item_ptr[matchptr[1].rm_so], "%u", &tag_number) != 1) {
-                APP_ERROR("%s: opening tag get tag number failed\r\n", item_ptr);
-                break;
-            } else if (tag_number > 255) {
-                APP_ERROR("%s: opening tag number should be 0~255\r\n", item_ptr);
-                break;
-            } else if (push_level >= sizeof(push_stack)) {
-                APP_ERROR("%s: opening tag too much nested structure\r\n", item_ptr);
-                break;
-            }
-            APP_VERBOS("opening tag(%d)\r\n", tag_number);
-            push_stack[push_level++] = tag_number;
-            if (matchptr[2].rm_so < 0)
-                goto success;
-            item_ptr[matchptr[2].rm_eo] = 0;
-            item_ptr = &item_ptr[matchptr[2].rm_so];
-            goto nested;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec opening tag pattern fail\r\n");
-            break;
+    return !memcmp(s, lower, len) || !memcmp(s, upper, len) || (title && !memcmp(s, title, len));
+}
+
+/* one typed literal in [s, e), already trimmed */
+static bool parse_literal(parse_state_t *st, bool context, uint32_t tag, const char *s,
+                const char *e)
+{
+    uint8_t buf[PARSE_SCALAR_MAX];
+    BACNET_DATE date;
+    BACNET_TIME time;
+    uint32_t value, instance;
+    int32_t signed_value;
+    const char *p;
+    bool negative;
+    int len;
+
+    if (parse_keyword(s, e, "null", "NULL", NULL)) {
+        len = context? encode_context_null(buf, tag): encode_application_null(buf);
+        return parse_put(st, buf, len);
+    }
+    if (parse_keyword(s, e, "true", "TRUE", "True")
+            || parse_keyword(s, e, "false", "FALSE", "False")) {
+        len = context? encode_context_boolean(buf, tag, *s == 't' || *s == 'T')
+            : encode_application_boolean(buf, *s == 't' || *s == 'T');
+        return parse_put(st, buf, len);
+    }
+
+    switch (*s++) {
+    case 'o':
+    case 'O':
+        p = s;
+        if ((parse_digits(&p, e, &value) <= 0) || (p == e) || (*p != '.')
+                || !parse_uint(p + 1, e, &instance)) {
+            return false;
         }
+        if (value >= MAX_BACNET_OBJECT_TYPE) {
+            APP_ERROR("%s: invalid object type(%u)\r\n", __func__, value);
+            return false;
+        }
+        if (instance > BACNET_MAX_INSTANCE) {
+            APP_ERROR("%s: invalid object instance(%u)\r\n", __func__, instance);
+            return false;
+        }
+        len = context? encode_context_object_id(buf, tag, value, instance)
+            : encode_application_object_id(buf, value, instance);
+        return parse_put(st, buf, len);
 
-        rv = regexec(&closing_tag_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            char *tag_part = &item_ptr[matchptr[0].rm_so];
-next_closing:
-            if (!push_level) {
-                APP_ERROR("%s: closing tag overflow\r\n", item_ptr);
-                break;
-            } else if (tag_part[1] < '0' || tag_part[1] > '9') {
-                tag_number = push_stack[push_level - 1];
-            } else if (sscanf(tag_part + 1, "%u", &tag_number) != 1) {
-                APP_ERROR("%s: closing tag get tag number failed\r\n", tag_part);
-                status = false;
-                break;
-            } else if (tag_number > 255) {
-                APP_ERROR("%s: closing tag number should be 0~255\r\n", tag_part);
-                break;
-            } else if (tag_number != push_stack[push_level - 1]) {
-                APP_ERROR("%s: closing tag not match\r\n", tag_part);
-                break;
-            } else if (pop_level >= sizeof(pop_stack)) {
-                APP_ERROR("%s: closing tag pop overflow\r\n", tag_part);
-                break;
-            } else {
-                pop_stack[pop_level++] = tag_number;
-            }
-            --push_level;
-            tag_part = strchr(tag_part + 1, '}');
-            if (tag_part)
-                goto next_closing;
-
-            bool found = false;
-            for (int i=0; i<matchptr[0].rm_so; ++i) {
-                if (item_ptr[i] != ' ' && item_ptr[i] != '\t') {
-                    item_ptr[matchptr[0].rm_so] = 0;
-                    item_ptr += i;
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec closing tag pattern fail\r\n");
-            break;
+    case 'u':
+    case 'U':
+        if (!parse_uint(s, e, &value)) {
+            return false;
         }
+        len = context? encode_context_unsigned(buf, tag, value)
+            : encode_application_unsigned(buf, value);
+        return parse_put(st, buf, len);
 
-        rv = regexec(&context_unknown_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            if (sscanf(&item_ptr[matchptr[1].rm_so], "%u", &tag_number) != 1) {
-                APP_ERROR("%s: unknown get tag number failed\r\n", item_ptr);
-                break;
-            } else if (tag_number > 255) {
-                APP_ERROR("%s: unknown tag number should be 0~255\r\n", item_ptr);
-                break;
-            }
-            APP_VERBOS("context unknown tag: %d, value: %s\r\n", tag_number,
-                    &item_ptr[matchptr[2].rm_so]);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec context unknown pattern fail\r\n");
-            break;
+    case 'e':
+    case 'E':
+        if (!parse_uint(s, e, &value)) {
+            return false;
         }
+        len = context? encode_context_enumerated(buf, tag, value)
+            : encode_application_enumerated(buf, value);
+        return parse_put(st, buf, len);
+
+    case 's':
+    case 'S':
+        negative = (s < e) && (*s == '-');
+        if (!parse_uint(s + negative, e, &value)
+                || (value > (negative? 2147483648U: 2147483647U))) {
+            return false;
+        }
+        signed_value = negative? (int32_t)(0U - value): (int32_t)value;
+        len = context? encode_context_signed(buf, tag, signed_value)
+            : encode_application_signed(buf, signed_value);
+        return parse_put(st, buf, len);
+
+    case 'f':
+    case 'F':
+        /* the character after e is a blank, '}', ',' or the end, strtof stops there */
+        if (!parse_is_decimal(s, e)) {
+            return false;
+        }
+        len = context? encode_context_real(buf, tag, strtof(s, NULL))
+            : encode_application_real(buf, strtof(s, NULL));
+        return parse_put(st, buf, len);
 
-        int context_specify = false;
-        rv = regexec(&context_application_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            if (sscanf(&item_ptr[matchptr[1].rm_so], "%u", &tag_number) != 1) {
-                APP_ERROR("%s: application context tag number failed\r\n", item_ptr);
-                break;
-            } else if (tag_number > 255) {
-                APP_ERROR("%s: application context tag number should be 0~255\r\n", item_ptr);
-                break;
-            }
-            APP_VERBOS("context tag(%d): ", tag_number);
-            item_ptr = &item_ptr[matchptr[2].rm_so];
-            context_specify = true;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec context application pattern fail\r\n");
-            break;
+    case 'l':
+    case 'L':
+        if ((s == e) || (*s != ((s[-1] == 'l')? 'f': 'F')) || !parse_is_decimal(s + 1, e)) {
+            return false;
         }
+        len = context? encode_context_double(buf, tag, strtod(s + 1, NULL))
+            : encode_application_double(buf, strtod(s + 1, NULL));
+        return parse_put(st, buf, len);
 
-        rv = regexec(&null_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            int len;
-            if (context_specify)
-                len = encode_context_null(pdu->data + pdu->data_len, tag_number);
-            else
-                len = encode_application_null(pdu->data + pdu->data_len);
-            pdu->data_len += len;
+    case 'b':
+    case 'B':
+        return parse_bit_string(st, context, tag, s, e);
 
-            APP_VERBOS("null\r\n");
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec null pattern fail\r\n");
-            break;
-        }
+    case 'x':
+    case 'X':
+        return parse_octets(st, context, tag, s, e);
 
-        rv = regexec(&boolean_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            bool value = matchptr[2].rm_so >= 0;
-            int len;
-            if (context_specify)
-                len = encode_context_boolean(pdu->data + pdu->data_len,
-                        tag_number, value);
-            else
-                len = encode_application_boolean(pdu->data + pdu->data_len, value);
-            pdu->data_len += len;
+    case 'c':
+    case 'C':
+        return parse_char_string(st, context, tag, s, e);
 
-            APP_VERBOS("booean: %s\r\n", value ? "true" : "false");
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec boolean pattern fail\r\n");
-            break;
+    case 'd':
+    case 'D':
+        if (!parse_date(s, e, &date)) {
+            return false;
         }
+        len = context? encode_context_date(buf, tag, &date): encode_application_date(buf, &date);
+        return parse_put(st, buf, len);
 
-        rv = regexec(&object_id_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            unsigned otype, instance;
-            if (sscanf(item_ptr + matchptr[1].rm_so, "%u.%u", &otype, &instance) != 2) {
-                APP_ERROR("%s: object_id get type and instance fail\r\n", item_ptr);
-                break;
-            } else if (otype >= MAX_BACNET_OBJECT_TYPE) {
-                APP_ERROR("%s: object_id invalid type\r\n", item_ptr);
-                break;
-            } else if (instance > BACNET_MAX_INSTANCE) {
-                APP_ERROR("%s: object_id invalid instance\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_object_id(pdu->data + pdu->data_len,
-                        tag_number, otype, instance);
-            else
-                len = encode_application_object_id(pdu->data + pdu->data_len,
-                        otype, instance);
-            pdu->data_len += len;
-            APP_VERBOS("object_id type(%u) instance(%u)\r\n", otype, instance);
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec object_id pattern fail\r\n");
-            break;
+    case 't':
+    case 'T':
+        if (!parse_time(s, e, &time)) {
+            return false;
         }
+        len = context? encode_context_time(buf, tag, &time): encode_application_time(buf, &time);
+        return parse_put(st, buf, len);
 
-        rv = regexec(&unsigned_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            unsigned unsigned_value;
-            if (sscanf(item_ptr + matchptr[1].rm_so, "%u", &unsigned_value) != 1) {
-                APP_ERROR("%s: unsigned get value fail\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_unsigned(pdu->data + pdu->data_len,
-                        tag_number, unsigned_value);
-            else
-                len = encode_application_unsigned(pdu->data + pdu->data_len,
-                        unsigned_value);
-            pdu->data_len += len;
-            APP_VERBOS("unsigned(%u)\r\n", unsigned_value);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec unsigned pattern fail\r\n");
-            break;
-        }
+    default:
+        return false;
+    }
+}
 
-        rv = regexec(&signed_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            int32_t signed_value;
-            if (sscanf(item_ptr + matchptr[1].rm_so, "%d", &signed_value) != 1) {
-                APP_ERROR("%s: signed get value fail\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_signed(pdu->data + pdu->data_len,
-                        tag_number, signed_value);
-            else
-                len = encode_application_signed(pdu->data + pdu->data_len, signed_value);
-            pdu->data_len += len;
-            APP_VERBOS("signed(%d)\r\n", signed_value);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec unsigned pattern fail\r\n");
-            break;
-        }
+/* a value with optional N? or N: prefix */
+static bool parse_value(parse_state_t *st, const char *s, const char *e)
+{
+    const char *p;
+    uint32_t tag;
+    int count;
+
+    p = s;
+    count = parse_digits(&p, e, &tag);
+    if (count == 0) {
+        return parse_literal(st, false, 0, s, e);
+    }
 
-        rv = regexec(&real_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            float real;
-            if (sscanf(item_ptr + matchptr[1].rm_so, "%f", &real) != 1) {
-                APP_ERROR("%s: real get value fail\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_real(pdu->data + pdu->data_len, tag_number, real);
-            else
-                len = encode_application_real(pdu->data + pdu->data_len, real);
-            pdu->data_len += len;
-            APP_VERBOS("real(%f)\r\n", real);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec real pattern fail\r\n");
-            break;
-        }
+    if ((count < 0) || (tag > 255)) {
+        APP_ERROR("%s: context tag number should be 0~255\r\n", __func__);
+        return false;
+    }
 
-        rv = regexec(&double_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            double double_value;
-            if (sscanf(item_ptr + matchptr[2].rm_so, "%lf", &double_value) != 1) {
-                APP_ERROR("%s: double get value fail\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_double(pdu->data + pdu->data_len,
-                        tag_number, double_value);
-            else
-                len = encode_application_double(pdu->data + pdu->data_len,
-                        double_value);
-            pdu->data_len += len;
-            APP_VERBOS("double(%lf)\r\n", double_value);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec double pattern fail\r\n");
-            break;
-        }
+    if ((p < e) && (*p == '?')) {
+        return parse_octets(st, true, tag, p + 1, e);
+    }
 
-        rv = regexec(&char_string_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            unsigned encoding;
-            if (matchptr[1].rm_so == matchptr[1].rm_eo) {
-                encoding = CHARACTER_ANSI_X34;
-            } else if (sscanf(item_ptr + matchptr[1].rm_so, "%u", &encoding) != 1) {
-                APP_ERROR("%s: char_strig get encoding fail\r\n", item_ptr);
-                break;
-            } else if (encoding >= MAX_CHARACTER_STRING_ENCODING) {
-                APP_ERROR("%s: char_string unknown encoding(%u)\r\n", item_ptr, encoding);
-                break;
-            }
-            BACNET_CHARACTER_STRING char_string;
-            char_string.encoding = encoding;
-            if (matchptr[3].rm_so >= 0) {
-                char_string.value = item_ptr + matchptr[3].rm_so + 1;
-                char_string.length = matchptr[3].rm_eo - matchptr[3].rm_so - 1;
-            } else {
-                char_string.value = item_ptr + matchptr[5].rm_so + 1;
-                char_string.length = matchptr[5].rm_eo - matchptr[5].rm_so - 1;
-                char_string.value[char_string.length] = 0;
-                char_string.length = hexstr2byte(char_string.value, (uint8_t*)char_string.value,
-                        char_string.length >> 1);
-            }
-            if (pdu->data + pdu->data_len + char_string.length >= pdu->end) {
-                APP_ERROR("%s: char_string pdu overflow\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_character_string(pdu->data + pdu->data_len,
-                        tag_number, &char_string);
-            else
-                len = encode_application_character_string(pdu->data + pdu->data_len,
-                        &char_string);
-            pdu->data_len += len;
-            APP_VERBOS("char_string encoding(%u) length(%d)\r\n",
-                    encoding, char_string.length);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec char string pattern fail\r\n");
+    if ((p == e) || (*p != ':')) {
+        return false;
+    }
+    s = p + 1;
+    parse_trim(&s, &e);
+    if (s == e) {
+        return false;
+    }
+
+    return parse_literal(st, true, tag, s, e);
+}
+
+/* start of the trailing "}N" run of [s, e), e if there is none */
+static const char *parse_closing_start(const char *s, const char *e)
+{
+    const char *start, *p;
+
+    start = e;
+    p = e;
+    for (;;) {
+        while ((p > s) && parse_is_blank(p[-1])) {
+            p--;
+        }
+        while ((p > s) && parse_is_digit(p[-1])) {
+            p--;
+        }
+        if ((p == s) || (p[-1] != '}')) {
             break;
         }
+        start = --p;
+    }
 
-        rv = regexec(&octet_string_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            uint8_t *value;
-            int len;
-            value = (uint8_t*)item_ptr + matchptr[1].rm_so;
-            len = matchptr[1].rm_eo - matchptr[1].rm_so;
-            value[len] = 0;
-            len = hexstr2byte((char*)value, value, len>>1);
-            if (pdu->data + pdu->data_len + len >= pdu->end) {
-                APP_ERROR("%s octet_string pdu overflow\r\n", item_ptr);
-                break;
-            }
-            APP_VERBOS("octet_string length(%d)\r\n", len);
-            if (context_specify)
-                len = encode_context_raw_octet_string(pdu->data + pdu->data_len,
-                        tag_number, value, len);
-            else
-                len = encode_application_raw_octet_string(pdu->data + pdu->data_len,
-                        value, len);
-            pdu->data_len += len;
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec octet string pattern fail\r\n");
+    return start;
+}
+
+static bool parse_item(parse_state_t *st, const char *s, const char *e)
+{
+    uint8_t closing[PARSE_MAX_NESTING];
+    uint8_t buf[PARSE_SCALAR_MAX];
+    const char *p, *close;
+    uint32_t tag;
+    int count, i;
+
+    parse_trim(&s, &e);
+    if (s == e) {
+        APP_ERROR("%s: empty item\r\n", __func__);
+        return false;
+    }
+
+    /* opening tags, the rest of the item is parsed as a new one */
+    for (;;) {
+        p = s;
+        count = parse_digits(&p, e, &tag);
+        if ((count == 0) || (p == e) || (*p != '{')) {
             break;
         }
+        if ((count < 0) || (tag > 255)) {
+            APP_ERROR("%s: opening tag number should be 0~255\r\n", __func__);
+            return false;
+        }
+        if (st->level >= PARSE_MAX_NESTING) {
+            APP_ERROR("%s: opening tag too much nested structure\r\n", __func__);
+            return false;
+        }
+        if (!parse_put(st, buf, encode_opening_tag(buf, tag))) {
+            return false;
+        }
+        st->tags[st->level++] = tag;
 
-        rv = regexec(&bit_string_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            BACNET_BIT_STRING bit_string;
-            int bit_size = matchptr[1].rm_eo - matchptr[1].rm_so;
-            bit_string.value = (uint8_t*)item_ptr + matchptr[1].rm_so;
-            bitstring_resize(&bit_string, bit_size);
-            for(int i=0; i<bit_size; ++i) {
-                if (bit_string.value[i] == '1')
-                    bitstring_set_bit(&bit_string, i, true);
-                else
-                    bitstring_set_bit(&bit_string, i, false);
-            }
-            if (pdu->data + pdu->data_len + bit_string.byte_len >= pdu->end) {
-                APP_ERROR("%s bit_string pdu overflow\r\n", item_ptr);
-                break;
-            }
-            int len;
-            if (context_specify)
-                len = encode_context_bitstring(pdu->data + pdu->data_len, tag_number,
-                        &bit_string);
-            else
-                len = encode_application_bitstring(pdu->data + pdu->data_len, &bit_string);
-            pdu->data_len += len;
-            APP_VERBOS("bit_string length(%d)\r\n", bit_size);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec bit string pattern fail\r\n");
-            break;
+        s = p + 1;
+        parse_trim(&s, &e);
+        if (s == e) {
+            return true;
         }
+    }
 
-        rv = regexec(&enumerated_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            unsigned unsigned_value;
-            if (sscanf(item_ptr + matchptr[1].rm_so, "%u", &unsigned_value) != 1) {
-                APP_ERROR("%s: enumerated get value fail\r\n", item_ptr);
-                break;
+    /* closing tags are checked here and encoded after the value */
+    close = parse_closing_start(s, e);
+    count = 0;
+    for (p = close; p < e; count++) {
+        if (st->level == 0) {
+            APP_ERROR("%s: closing tag overflow\r\n", __func__);
+            return false;
+        }
+        p++;
+        if ((p < e) && parse_is_digit(*p)) {
+            if ((parse_digits(&p, e, &tag) < 0) || (tag != st->tags[st->level - 1])) {
+                APP_ERROR("%s: closing tag not match\r\n", __func__);
+                return false;
             }
-            int len;
-            if (context_specify)
-                len = encode_context_enumerated(pdu->data + pdu->data_len,
-                        tag_number, unsigned_value);
-            else
-                len = encode_application_enumerated(pdu->data + pdu->data_len,
-                        unsigned_value);
-            pdu->data_len += len;
-            APP_VERBOS("enumerated(%u)\r\n", unsigned_value);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec enumerated pattern fail\r\n");
-            break;
         }
-
-        rv = regexec(&date_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            BACNET_DATE date;
-            unsigned year, month, day, week;
-            if (matchptr[1].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[1].rm_so, "%u", &year) != 1) {
-                    APP_ERROR("%s: date get year fail\r\n", item_ptr);
-                    break;
-                } else if (year < 1900 || year > 1900 + 254) {
-                    APP_ERROR("%s: date invalid year\r\n", item_ptr);
-                    break;
-                }
-                year -= 1900;
-            } else
-                year = 0x0ff;
-
-            if (matchptr[2].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[2].rm_so, "%u", &month) != 1) {
-                    APP_ERROR("%s: date get month fail\r\n", item_ptr);
-                    break;
-                } else if (month < 1 || month > 12) {
-                    APP_ERROR("%s: date invalid month\r\n", item_ptr);
-                    break;
-                }
-            } else
-                month = 0x0ff;
-
-            if (matchptr[3].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[3].rm_so, "%u", &day) != 1) {
-                    APP_ERROR("%s: date get day fail\r\n", item_ptr);
-                    break;
-                } else if (day < 1 || day > 31) {
-                    APP_ERROR("%s: date invalid day\r\n", item_ptr);
-                    break;
-                }
-            } else
-                day = 0x0ff;
-
-            if (matchptr[4].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[4].rm_so, "%u", &week) != 1) {
-                    APP_ERROR("%s: date get weekday fail\r\n", item_ptr);
-                    break;
-                } else if (week < 1 || week > 7) {
-                    APP_ERROR("%s: date invalid weekday\r\n", item_ptr);
-                    break;
-                }
-            } else
-                week = 0x0ff;
-            date.year = year; date.month = month;
-            date.day = day; date.wday = week;
-            int len;
-            if (context_specify)
-                len = encode_context_date(pdu->data + pdu->data_len, tag_number, &date);
-            else
-                len = encode_application_date(pdu->data + pdu->data_len, &date);
-            pdu->data_len += len;
-            APP_VERBOS("date %u.%u.%u.%u\r\n", year, month, day, week);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec date pattern fail\r\n");
-            break;
+        closing[count] = st->tags[--st->level];
+        while ((p < e) && parse_is_blank(*p)) {
+            p++;
         }
+    }
 
-        rv = regexec(&time_re, item_ptr, sizeof(matchptr)/sizeof(matchptr[0]), matchptr, 0);
-        if (rv == 0) {
-            BACNET_TIME time;
-            unsigned hour, minute, second, hundredth;
-            if (matchptr[1].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[1].rm_so, "%u", &hour) != 1) {
-                    APP_ERROR("%s: time get hour fail\r\n", item_ptr);
-                    break;
-                } else if (hour > 23) {
-                    APP_ERROR("%s: time invalid hour\r\n", item_ptr);
-                    break;
-                }
-            } else
-                hour = 0x0ff;
-
-            if (matchptr[2].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[2].rm_so, "%u", &minute) != 1) {
-                    APP_ERROR("%s: time get minute fail\r\n", item_ptr);
-                    break;
-                } else if (minute > 59) {
-                    APP_ERROR("%s: time invalid minute\r\n", item_ptr);
-                    break;
-                }
-            } else
-                minute = 0x0ff;
-
-            if (matchptr[3].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[3].rm_so, "%u", &second) != 1) {
-                    APP_ERROR("%s: time get second fail\r\n", item_ptr);
-                    break;
-                } else if (second > 59) {
-                    APP_ERROR("%s: time invalid second\r\n", item_ptr);
-                    break;
-                }
-            } else
-                second = 0x0ff;
-
-            if (matchptr[4].rm_so >= 0) {
-                if (sscanf(item_ptr + matchptr[4].rm_so, "%u", &hundredth) != 1) {
-                    APP_ERROR("%s: time get hundredth second fail\r\n", item_ptr);
-                    break;
-                } else if (hundredth > 99) {
-                    APP_ERROR("%s: time invalid hundredth second\r\n", item_ptr);
-                    break;
-                }
-            } else
-                hundredth = 0x0ff;
-
-            time.hour = hour; time.min = minute;
-            time.sec = second; time.hundredths = hundredth;
-            int len;
-            if (context_specify)
-                len = encode_context_time(pdu->data + pdu->data_len, tag_number, &time);
-            else
-                len = encode_application_time(pdu->data + pdu->data_len, &time);
-            pdu->data_len += len;
-            APP_VERBOS("time %02u:%02u:%02u.%02u\r\n", hour, minute, second, hundredth);
-            goto success;
-        } else if (rv != REG_NOMATCH) {
-            APP_ERROR("regex exec time pattern fail\r\n");
-            break;
+    e = close;
+    parse_trim(&s, &e);
+    if ((s != e) && !parse_value(st, s, e)) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!parse_put(st, buf, encode_closing_tag(buf, closing[i]))) {
+            return false;
         }
+    }
 
-        APP_ERROR("%s: parse failed at\r\n", item_ptr);
-        status = false;
-        break;
-success:
-        if (pdu->data + pdu->data_len > pdu->end) {
-            APP_ERROR("pdu overflow\r\n");
-            break;
+    return true;
+}
+
+/* used to load the app data struct with the proper data converted from a command line argument */
+bool bacapp_parse_application_data(bacnet_buf_t *pdu, const char *argv)
+{
+    parse_state_t st;
+    const char *s, *e;
+    bool empty;
+
+    if ((pdu == NULL) || (argv == NULL)) {
+        APP_ERROR("%s: invalid argument\r\n", __func__);
+        return false;
+    }
+
+    st.pdu = pdu;
+    st.level = 0;
+
+    empty = true;
+    for (s = argv; *s; s = (*e)? e + 1: e) {
+        e = strchr(s, ',');
+        if (e == NULL) {
+            e = s + strlen(s);
         }
-        if (pop_level) {
-            for (int i=0; i<pop_level; ++i) {
-                APP_VERBOS("closing tag(%d)\r\n", pop_stack[i]);
-                int len = encode_closing_tag(pdu->data + pdu->data_len, pop_stack[i]);
-                pdu->data_len += len;
-            }
-            if (pdu->data + pdu->data_len > pdu->end) {
-                APP_ERROR("pdu overflow\r\n");
-                break;
-            }
-            pop_level = 0;
+        if (e == s) {
+            continue;
         }
-        status = true;
-    }while((item_ptr = strtok_r(NULL, ",", &save_ptr)));
-
-    regfree(&opening_tag_re);
-    regfree(&closing_tag_re);
-    regfree(&context_unknown_re);
-    regfree(&context_application_re);
-    regfree(&null_re);
-    regfree(&boolean_re);
-    regfree(&object_id_re);
-    regfree(&unsigned_re);
-    regfree(&signed_re);
-    regfree(&real_re);
-    regfree(&double_re);
-    regfree(&char_string_re);
-    regfree(&octet_string_re);
-    regfree(&bit_string_re);
-    regfree(&enumerated_re);
-    regfree(&date_re);
-    regfree(&time_re);
-
-    return status;
-}
 
+        empty = false;
+        if (!parse_item(&st, s, e)) {
+            APP_ERROR("%s: parse failed at %.*s\r\n", __func__, (int)(e - s), s);
+            return false;
+        }
+    }
+
+    if (empty) {
+        APP_ERROR("%s: empty value\r\n", __func__);
+        return false;
+    }
+
+    if (st.level) {
+        APP_ERROR("%s: opening tag %u not closed\r\n", __func__, st.tags[st.level - 1]);
+        return false;
+    }
+
+    return true;
+}
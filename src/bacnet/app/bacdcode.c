@@ -14,6 +14,7 @@
 
 #include "bacnet/bacdef.h"
 #include "bacnet/bacdcode.h"
+#include "bacnet/bacapp.h"
 #include "bacnet/bacenum.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/bacint.h"
@@ -311,7 +312,15 @@ static int decode_value_length(
     uint16_t value16;
     uint32_t value32;
     int len = 0;
-    
+
+    /* the usual case, length 0~4 in the tag octet itself */
+    if ((tag_byte & 0x07) < 5) {
+        if (value) {
+            *value = tag_byte & 0x07;
+        }
+        return 0;
+    }
+
     if (IS_EXTENDED_VALUE(tag_byte)) {
         len++;
         if (apdu[0] == 255) {               /* tagged as uint32_t */
@@ -340,12 +349,8 @@ static int decode_value_length(
                 *value = apdu[0];
             }
         }
-    } else if (IS_OPENING_CLOSING_TAG(tag_byte)) {
-        return -1;
     } else {
-        if (value) {
-            *value = tag_byte & 0x07;       /* small value */
-        }
+        return -1;                          /* opening or closing tag */
     }
 
     return len;
@@ -376,7 +381,7 @@ static int decode_tag_number(
 
 /* from clause 20.2.1.3.2 Constructed Data */
 /* returns the number of apdu bytes consumed */
-int decode_tag_number_and_value(
+int __decode_tag_number_and_value(
     const uint8_t * apdu,
     uint8_t * tag_number,
     uint32_t * value)
@@ -576,7 +581,7 @@ int decode_context_bitstring(
     int len;
 
     if ((len = decode_match_context_tag_and_value(apdu, tag_number, &len_value)) < 0
-            || !decode_bitstring(&apdu[len], len_value, bit_string))
+            || decode_bitstring(&apdu[len], len_value, bit_string) < 0)
         return -1;
 
     len += (int)len_value;
@@ -591,7 +596,7 @@ int decode_application_bitstring(
     int len;
 
     if ((len = decode_match_application_tag_and_value(apdu, BACNET_APPLICATION_TAG_BIT_STRING, &len_value)) < 0
-            || !decode_bitstring(&apdu[len], len_value, bit_string))
+            || decode_bitstring(&apdu[len], len_value, bit_string) < 0)
         return -1;
 
     len += (int)len_value;
@@ -642,9 +647,9 @@ int decode_object_id(
     BACNET_OBJECT_TYPE * object_type,
     uint32_t * instance)
 {
-    uint32_t value = 0;
+    uint32_t value;
 
-    decode_unsigned32(apdu, &value);
+    value = bacnet_get_be32(apdu);
     *object_type =
         (((value >> BACNET_INSTANCE_BITS) & BACNET_MAX_OBJECT));
     *instance = (value & BACNET_MAX_INSTANCE);
@@ -966,7 +971,7 @@ int decode_context_character_string(
     uint32_t len_value;
 
     if ((len = decode_match_context_tag_and_value(apdu, tag_number, &len_value)) < 0
-            || !decode_character_string(&apdu[len], len_value, char_string))
+            || decode_character_string(&apdu[len], len_value, char_string) < 0)
         return -1;
 
     len += (int)len_value;
@@ -981,7 +986,7 @@ int decode_application_character_string(
     uint32_t len_value;
 
     if ((len = decode_match_application_tag_and_value(apdu, BACNET_APPLICATION_TAG_CHARACTER_STRING, &len_value)) < 0
-            || !decode_character_string(&apdu[len], len_value, char_string))
+            || decode_character_string(&apdu[len], len_value, char_string) < 0)
         return -1;
 
     len += (int)len_value;
@@ -996,21 +1001,18 @@ int decode_unsigned(
     uint32_t len_value,
     uint32_t * value)
 {
-    uint16_t unsigned16_value = 0;
-
     switch (len_value) {
         case 1:
             *value = apdu[0];
             break;
         case 2:
-            decode_unsigned16(&apdu[0], &unsigned16_value);
-            *value = unsigned16_value;
+            *value = bacnet_get_be16(apdu);
             break;
         case 3:
-            decode_unsigned24(&apdu[0], value);
+            *value = bacnet_get_be24(apdu);
             break;
         case 4:
-            decode_unsigned32(&apdu[0], value);
+            *value = bacnet_get_be32(apdu);
             break;
         default:
             return -1;
@@ -1028,7 +1030,7 @@ int decode_context_unsigned(
     int len;
 
     if ((len = decode_match_context_tag_and_value(apdu, tag_number, &len_value)) < 0
-            || !decode_unsigned(&apdu[len], len_value, value))
+            || decode_unsigned(&apdu[len], len_value, value) < 0)
         return -1;
 
     len += (int)len_value;
@@ -1043,7 +1045,7 @@ int decode_application_unsigned(
     int len;
 
     if ((len = decode_match_application_tag_and_value(apdu, BACNET_APPLICATION_TAG_UNSIGNED_INT, &len_value)) < 0
-            || !decode_unsigned(&apdu[len], len_value, value))
+            || decode_unsigned(&apdu[len], len_value, value) < 0)
         return -1;
 
     len += (int)len_value;
@@ -1141,7 +1143,7 @@ int decode_application_enumerated(
     int len;
 
     if ((len = decode_match_application_tag_and_value(apdu, BACNET_APPLICATION_TAG_ENUMERATED, &len_value)) < 0
-            || !decode_unsigned(&apdu[len], len_value, value))
+            || decode_unsigned(&apdu[len], len_value, value) < 0)
         return -1;
 
     len += (int)len_value;
@@ -1187,7 +1189,7 @@ int decode_context_signed(
     int len;
 
     if ((len = decode_match_context_tag_and_value(apdu, tag_number, &len_value)) < 0
-            || !decode_signed(&apdu[len], len_value, value))
+            || decode_signed(&apdu[len], len_value, value) < 0)
         return -1;
 
     len += (int)len_value;
@@ -1202,7 +1204,7 @@ int decode_application_signed(
     int len;
 
     if ((len = decode_match_application_tag_and_value(apdu, BACNET_APPLICATION_TAG_SIGNED_INT, &len_value)) < 0
-            || !decode_signed(&apdu[len], len_value, value))
+            || decode_signed(&apdu[len], len_value, value) < 0)
         return -1;
 
     len += (int)len_value;
@@ -1674,3 +1676,157 @@ int decode_constructed_tag(
     return len;
 }
 
+/* Homogeneous arrays of application tagged values, such as Priority_Array,
+ * Object_List or the values of a Log_Buffer, encoded or decoded in one tight
+ * loop instead of one tag at a time. */
+
+/* returns the number of apdu bytes used, 5 per value */
+int encode_application_real_array(
+    uint8_t * apdu,
+    const float *values,
+    uint32_t count)
+{
+    uint32_t raw;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        apdu[0] = (BACNET_APPLICATION_TAG_REAL << 4) | 4;
+        memcpy(&raw, &values[i], sizeof(raw));
+        bacnet_put_be32(&apdu[1], raw);
+        apdu += 5;
+    }
+
+    return (int)count * 5;
+}
+
+/* returns the number of apdu bytes used */
+int encode_application_unsigned_array(
+    uint8_t * apdu,
+    const uint32_t *values,
+    uint32_t count)
+{
+    uint32_t value;
+    uint32_t i;
+    int len;
+
+    len = 0;
+    for (i = 0; i < count; i++) {
+        value = values[i];
+        if (value < 0x100) {
+            apdu[len] = (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | 1;
+            apdu[len + 1] = (uint8_t)value;
+            len += 2;
+        } else if (value < 0x10000) {
+            apdu[len] = (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | 2;
+            bacnet_put_be16(&apdu[len + 1], (uint16_t)value);
+            len += 3;
+        } else if (value < 0x1000000) {
+            apdu[len] = (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | 3;
+            bacnet_put_be24(&apdu[len + 1], value);
+            len += 4;
+        } else {
+            apdu[len] = (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | 4;
+            bacnet_put_be32(&apdu[len + 1], value);
+            len += 5;
+        }
+    }
+
+    return len;
+}
+
+/* returns the number of apdu bytes used, 5 per value */
+int encode_application_object_id_array(
+    uint8_t * apdu,
+    const struct BACnet_Object_Id *values,
+    uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        apdu[0] = (BACNET_APPLICATION_TAG_OBJECT_ID << 4) | 4;
+        bacnet_put_be32(&apdu[1], (((uint32_t)values[i].type & BACNET_MAX_OBJECT)
+            << BACNET_INSTANCE_BITS) | (values[i].instance & BACNET_MAX_INSTANCE));
+        apdu += 5;
+    }
+
+    return (int)count * 5;
+}
+
+/* decode up to *count values, stopping early at the first octet that is not
+ * a tag of the type (the closing tag of the list, for instance) or at apdu_len.
+ * returns the number of apdu bytes consumed and sets *count to the number of
+ * values decoded, or -1 if a value of the type is malformed or truncated */
+int decode_application_real_array(
+    const uint8_t * apdu,
+    uint32_t apdu_len,
+    float *values,
+    uint32_t *count)
+{
+    uint32_t raw;
+    uint32_t len, n;
+
+    len = 0;
+    for (n = 0; (n < *count) && (len < apdu_len); n++) {
+        if ((apdu[len] & 0xF8) != (BACNET_APPLICATION_TAG_REAL << 4))
+            break;
+        if ((apdu[len] & 0x07) != 4 || (len + 5 > apdu_len))
+            return -1;
+
+        raw = bacnet_get_be32(&apdu[len + 1]);
+        memcpy(&values[n], &raw, sizeof(raw));
+        len += 5;
+    }
+
+    *count = n;
+    return (int)len;
+}
+
+int decode_application_unsigned_array(
+    const uint8_t * apdu,
+    uint32_t apdu_len,
+    uint32_t *values,
+    uint32_t *count)
+{
+    uint32_t len, n, len_value;
+
+    len = 0;
+    for (n = 0; (n < *count) && (len < apdu_len); n++) {
+        if ((apdu[len] & 0xF8) != (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4))
+            break;
+        len_value = apdu[len] & 0x07;
+        if ((len_value == 0) || (len_value > 4) || (len + 1 + len_value > apdu_len))
+            return -1;
+
+        (void)decode_unsigned(&apdu[len + 1], len_value, &values[n]);
+        len += 1 + len_value;
+    }
+
+    *count = n;
+    return (int)len;
+}
+
+int decode_application_object_id_array(
+    const uint8_t * apdu,
+    uint32_t apdu_len,
+    struct BACnet_Object_Id *values,
+    uint32_t *count)
+{
+    uint32_t value;
+    uint32_t len, n;
+
+    len = 0;
+    for (n = 0; (n < *count) && (len < apdu_len); n++) {
+        if ((apdu[len] & 0xF8) != (BACNET_APPLICATION_TAG_OBJECT_ID << 4))
+            break;
+        if ((apdu[len] & 0x07) != 4 || (len + 5 > apdu_len))
+            return -1;
+
+        value = bacnet_get_be32(&apdu[len + 1]);
+        values[n].type = (BACNET_OBJECT_TYPE)((value >> BACNET_INSTANCE_BITS) & BACNET_MAX_OBJECT);
+        values[n].instance = value & BACNET_MAX_INSTANCE;
+        len += 5;
+    }
+
+    *count = n;
+    return (int)len;
+}
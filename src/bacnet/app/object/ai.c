@@ -15,6 +15,7 @@
 #include <errno.h>
 
 #include "bacnet/object/ai.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacdef.h"
@@ -54,6 +55,7 @@ static int ai_write_present_value(object_instance_t *object, BACNET_WRITE_PROPER
             != wp_data->application_data_len) {
         return BACNET_STATUS_ERROR;
     }
+    intrinsic_report_analog(&ai_obj->base, ai_obj->present);
     
     return 0;
 }
@@ -111,6 +113,7 @@ out:
 int __attribute__((weak)) analog_input_init(cJSON *object)
 {
     object_impl_t *ai_type = NULL;
+    object_impl_t *ai_event_type = NULL;
     object_instance_t *ai_instance;
     object_ai_t *ai;
     cJSON *array, *instance, *tmp;
@@ -129,6 +132,11 @@ int __attribute__((weak)) analog_input_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_ANALOG_INPUT, sizeof(object_ai_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -170,27 +178,35 @@ int __attribute__((weak)) analog_input_init(cJSON *object)
             }
         }
 
-        ai = (object_ai_t *)malloc(sizeof(object_ai_t));
+        ai = (object_ai_t *)object_alloc(OBJECT_ANALOG_INPUT, sizeof(object_ai_t));
         if (!ai) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(ai, 0, sizeof(*ai));
         ai->base.base.instance = i;
         ai->base.base.type = ai_type;
         ai->base.Out_Of_Service = out_of_service;
         ai->present = 0.0f;
         ai->units = units;
 
-        if (!vbuf_fr_str(&ai->base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (intrinsic_reporting_init(&ai->base, &ai_event_type, instance, 0) < 0) {
+            APP_ERROR("%s: invalid Instance_List[%d] Intrinsic_Reporting item\r\n", __func__, i);
+            object_free(&ai->base.base);
+            goto reclaim;
+        }
+        intrinsic_report_analog(&ai->base, ai->present);
+
+        if (!object_set_name(&ai->base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(ai);
+            intrinsic_reporting_destroy(&ai->base);
+            object_free(&ai->base.base);
             goto reclaim;
         }
 
         if (!object_add(&ai->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(ai);
+            intrinsic_reporting_destroy(&ai->base);
+            object_free(&ai->base.base);
             goto reclaim;
         }
         i++;
@@ -206,10 +222,15 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(ai_instance);
-            free(ai_instance);
+            intrinsic_reporting_destroy(container_of(ai_instance, object_seor_t, base));
+            object_free(ai_instance);
         }
     }
 
+    if (ai_event_type) {
+        object_impl_destroy(ai_event_type);
+    }
+
     if (ai_type) {
         object_impl_destroy(ai_type);
     }
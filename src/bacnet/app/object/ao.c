@@ -16,6 +16,7 @@
 #include <math.h>
 
 #include "bacnet/object/ao.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacdef.h"
@@ -47,6 +48,7 @@ bool analog_output_present_value_set(object_ao_t *ao, float value, uint8_t prior
             if (ao->base.base.notify)
                 ao->base.base.notify(&ao->base.base);
         }
+        intrinsic_report_analog(&ao->base.base, value);
     }
 
     return true;
@@ -88,6 +90,7 @@ end:
         if (ao->base.base.notify)
             ao->base.base.notify(&ao->base.base);
     }
+    intrinsic_report_analog(&ao->base.base, ao->base.present);
 
     return true;
 }
@@ -368,6 +371,11 @@ int __attribute__((weak)) analog_output_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_ANALOG_OUTPUT, sizeof(object_ao_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -416,12 +424,11 @@ int __attribute__((weak)) analog_output_init(cJSON *object)
             }
         }
 
-        ao = malloc(sizeof(object_ao_t));
+        ao = (object_ao_t *)object_alloc(OBJECT_ANALOG_OUTPUT, sizeof(object_ao_t));
         if (!ao) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(ao, 0, sizeof(*ao));
         ao->base.base.base.instance = i;
         ao->base.base.base.type = ao_type;
         ao->base.base.Out_Of_Service = out_of_service;
@@ -430,15 +437,15 @@ int __attribute__((weak)) analog_output_init(cJSON *object)
         ao->active_bit = BACNET_MAX_PRIORITY;
         ao->relinquish_default = relinquish_default;
 
-        if (!vbuf_fr_str(&ao->base.base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (!object_set_name(&ao->base.base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(ao);
+            object_free(&ao->base.base.base);
             goto reclaim;
         }
 
         if (!object_add(&ao->base.base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(ao);
+            object_free(&ao->base.base.base);
             goto reclaim;
         }
         i++;
@@ -454,7 +461,7 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(ao_instance);
-            free(ao_instance);
+            object_free(ao_instance);
         }
     }
 
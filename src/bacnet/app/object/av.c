@@ -16,6 +16,7 @@
 #include <math.h>
 
 #include "bacnet/object/av.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacenum.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdcode.h"
@@ -60,6 +61,7 @@ static int av_writable_write_present_value(object_instance_t *object,
         if (av->base.notify)
             av->base.notify(&av->base);
     }
+    intrinsic_report_analog(&av->base, value);
 
     return 0;
 }
@@ -110,6 +112,10 @@ int __attribute__((weak)) analog_value_init(cJSON *object)
     object_impl_t *av_type = NULL;
     object_impl_t *av_writable_type = NULL;
     object_impl_t *av_commandable_type = NULL;
+    object_impl_t *av_event_type = NULL;
+    object_impl_t *av_writable_event_type = NULL;
+    object_impl_t *av_commandable_event_type = NULL;
+    object_impl_t **event_type;
     object_av_writable_t *av_writable;
     object_av_commandable_t *av_commandable;
     object_av_t *av;
@@ -197,15 +203,15 @@ int __attribute__((weak)) analog_value_init(cJSON *object)
                     goto reclaim;
                 }
             }
-            av_writable = (object_av_writable_t *)malloc(sizeof(object_av_writable_t));
+            av_writable = (object_av_writable_t *)object_alloc(OBJECT_ANALOG_VALUE, sizeof(object_av_writable_t));
             if (!av_writable) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
             av = av_writable;
-            memset(av_writable, 0, sizeof(*av_writable));
             av->present = 0.0;
             av->base.base.type = av_writable_type;
+            event_type = &av_writable_event_type;
         } else if (commandable) {
             tmp = cJSON_GetObjectItem(instance, "Relinquish_Default");
             if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
@@ -222,17 +228,17 @@ int __attribute__((weak)) analog_value_init(cJSON *object)
                 }
             }
 
-            av_commandable = (object_av_commandable_t *)malloc(sizeof(object_av_commandable_t));
+            av_commandable = (object_av_commandable_t *)object_alloc(OBJECT_ANALOG_VALUE, sizeof(object_av_commandable_t));
             if (!av_commandable) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
             av = &av_commandable->base;
-            memset(av_commandable, 0, sizeof(*av_commandable));
             av_commandable->relinquish_default = relinquish_default;
             av_commandable->active_bit = BACNET_MAX_PRIORITY;
             av->present = relinquish_default;
             av->base.base.type = av_commandable_type;
+            event_type = &av_commandable_event_type;
         } else {
             if (!av_type) {
                 av_type = (object_impl_t *)object_create_impl_av();
@@ -241,29 +247,38 @@ int __attribute__((weak)) analog_value_init(cJSON *object)
                     goto reclaim;
                 }
             }
-            av = (object_av_t *)malloc(sizeof(object_av_t));
+            av = (object_av_t *)object_alloc(OBJECT_ANALOG_VALUE, sizeof(object_av_t));
             if (!av) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
-            memset(av, 0, sizeof(*av));
             av->present = 0.0;
             av->base.base.type = av_type;
+            event_type = &av_event_type;
         }
 
         av->base.base.instance = i;
         av->units = units;
         av->base.Out_Of_Service = out_of_service;
 
-        if (!vbuf_fr_str(&av->base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (intrinsic_reporting_init(&av->base, event_type, instance, 0) < 0) {
+            APP_ERROR("%s: invalid Instance_List[%d] Intrinsic_Reporting item\r\n", __func__, i);
+            object_free(&av->base.base);
+            goto reclaim;
+        }
+        intrinsic_report_analog(&av->base, av->present);
+
+        if (!object_set_name(&av->base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(av);
+            intrinsic_reporting_destroy(&av->base);
+            object_free(&av->base.base);
             goto reclaim;
         }
 
         if (!object_add(&av->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(av);
+            intrinsic_reporting_destroy(&av->base);
+            object_free(&av->base.base);
             goto reclaim;
         }
         i++;
@@ -279,10 +294,23 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(av_instance);
-            free(av_instance);
+            intrinsic_reporting_destroy(container_of(av_instance, object_seor_t, base));
+            object_free(av_instance);
         }
     }
 
+    if (av_event_type) {
+        object_impl_destroy(av_event_type);
+    }
+
+    if (av_writable_event_type) {
+        object_impl_destroy(av_writable_event_type);
+    }
+
+    if (av_commandable_event_type) {
+        object_impl_destroy(av_commandable_event_type);
+    }
+
     if (av_type) {
         object_impl_destroy(av_type);
     }
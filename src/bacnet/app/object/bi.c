@@ -15,6 +15,7 @@
 #include <errno.h>
 
 #include "bacnet/object/bi.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacdef.h"
@@ -61,6 +62,7 @@ static int bi_write_present_value(object_instance_t *object, BACNET_WRITE_PROPER
     }
 
     bi_obj->present = value;
+    intrinsic_report_discrete(&bi_obj->base, value);
     
     return 0;
 }
@@ -120,6 +122,7 @@ int __attribute__((weak)) binary_input_init(cJSON *object)
     cJSON *array, *instance, *tmp;
     int i;
     object_impl_t *bi_type = NULL;
+    object_impl_t *bi_event_type = NULL;
     object_bi_t *bi;
     object_instance_t *bi_instance;
     char *name;
@@ -136,6 +139,11 @@ int __attribute__((weak)) binary_input_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_BINARY_INPUT, sizeof(object_bi_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -177,27 +185,35 @@ int __attribute__((weak)) binary_input_init(cJSON *object)
             }
         }
 
-        bi = (object_bi_t *)malloc(sizeof(object_bi_t));
+        bi = (object_bi_t *)object_alloc(OBJECT_BINARY_INPUT, sizeof(object_bi_t));
         if (!bi) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(bi, 0, sizeof(*bi));
         bi->base.base.instance = i;
         bi->base.base.type = bi_type;
         bi->base.Out_Of_Service = out_of_service;
         bi->present = 0;
         bi->polarity = polarity;
 
-        if (!vbuf_fr_str(&bi->base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (intrinsic_reporting_init(&bi->base, &bi_event_type, instance, 0) < 0) {
+            APP_ERROR("%s: invalid Instance_List[%d] Intrinsic_Reporting item\r\n", __func__, i);
+            object_free(&bi->base.base);
+            goto reclaim;
+        }
+        intrinsic_report_discrete(&bi->base, bi->present);
+
+        if (!object_set_name(&bi->base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(bi);
+            intrinsic_reporting_destroy(&bi->base);
+            object_free(&bi->base.base);
             goto reclaim;
         }
 
         if (!object_add(&bi->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(bi);
+            intrinsic_reporting_destroy(&bi->base);
+            object_free(&bi->base.base);
             goto reclaim;
         }
         i++;
@@ -213,10 +229,15 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(bi_instance);
-            free(bi_instance);
+            intrinsic_reporting_destroy(container_of(bi_instance, object_seor_t, base));
+            object_free(bi_instance);
         }
     }
 
+    if (bi_event_type) {
+        object_impl_destroy(bi_event_type);
+    }
+
     if (bi_type) {
         object_impl_destroy(bi_type);
     }
@@ -15,6 +15,7 @@
 #include <errno.h>
 
 #include "bacnet/object/bo.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdef.h"
@@ -302,6 +303,7 @@ bool binary_output_present_value_set(object_bo_t *bo, BACNET_BINARY_PV value, ui
             if (bo->base.base.notify)
                 bo->base.base.notify(&bo->base.base);
         }
+        intrinsic_report_discrete(&bo->base.base, value);
     }
 
     return true;
@@ -345,6 +347,7 @@ end:
             bo->base.base.notify(&bo->base.base);
         }
     }
+    intrinsic_report_discrete(&bo->base.base, bo->base.present);
 
     return true;
 }
@@ -371,6 +374,11 @@ int __attribute__((weak)) binary_output_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_BINARY_OUTPUT, sizeof(object_bo_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -424,12 +432,11 @@ int __attribute__((weak)) binary_output_init(cJSON *object)
             }
         }
 
-        bo = (object_bo_t *)malloc(sizeof(object_bo_t));
+        bo = (object_bo_t *)object_alloc(OBJECT_BINARY_OUTPUT, sizeof(object_bo_t));
         if (!bo) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(bo, 0, sizeof(*bo));
         bo->base.base.base.instance = i;
         bo->base.base.base.type = bo_type;
         bo->base.base.Out_Of_Service = out_of_service;
@@ -438,15 +445,15 @@ int __attribute__((weak)) binary_output_init(cJSON *object)
         bo->active_bit = BACNET_MAX_PRIORITY;
         bo->relinquish_default = relinquish_default;
 
-        if (!vbuf_fr_str(&bo->base.base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (!object_set_name(&bo->base.base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(bo);
+            object_free(&bo->base.base.base);
             goto reclaim;
         }
 
         if (!object_add(&bo->base.base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(bo);
+            object_free(&bo->base.base.base);
             goto reclaim;
         }
         i++;
@@ -462,7 +469,7 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(bo_instance);
-            free(bo_instance);
+            object_free(bo_instance);
         }
     }
 
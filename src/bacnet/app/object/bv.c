@@ -15,6 +15,7 @@
 #include <errno.h>
 
 #include "bacnet/object/bv.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacdef.h"
@@ -62,6 +63,7 @@ static int bv_writable_write_present_value(object_instance_t *object,
         if (bv->base.notify)
             bv->base.notify(&bv->base);
     }
+    intrinsic_report_discrete(&bv->base, value);
 
     return 0;
 }
@@ -121,6 +123,10 @@ int __attribute__((weak)) binary_value_init(cJSON *object)
     object_impl_t *bv_type = NULL;
     object_impl_t *bv_writable_type = NULL;
     object_impl_t *bv_commandable_type = NULL;
+    object_impl_t *bv_event_type = NULL;
+    object_impl_t *bv_writable_event_type = NULL;
+    object_impl_t *bv_commandable_event_type = NULL;
+    object_impl_t **event_type;
     object_bv_t *bv;
     object_bv_writable_t *bv_writable;
     object_bv_commandable_t *bv_commandable;
@@ -201,15 +207,15 @@ int __attribute__((weak)) binary_value_init(cJSON *object)
                 }
             }
 
-            bv_writable = (object_bv_writable_t *)malloc(sizeof(object_bv_writable_t));
+            bv_writable = (object_bv_writable_t *)object_alloc(OBJECT_BINARY_VALUE, sizeof(object_bv_writable_t));
             if (!bv_writable) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
             bv = bv_writable;
-            memset(bv_writable, 0, sizeof(*bv_writable));
             bv->present = 0;
             bv->base.base.type = bv_writable_type;
+            event_type = &bv_writable_event_type;
         } else if (commandable) {
             tmp = cJSON_GetObjectItem(instance, "Relinquish_Default");
             if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
@@ -231,17 +237,17 @@ int __attribute__((weak)) binary_value_init(cJSON *object)
                 }
             }
 
-            bv_commandable = (object_bv_commandable_t *)malloc(sizeof(object_bv_commandable_t));
+            bv_commandable = (object_bv_commandable_t *)object_alloc(OBJECT_BINARY_VALUE, sizeof(object_bv_commandable_t));
             if (!bv_commandable) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
             bv = &bv_commandable->base;
-            memset(bv_commandable, 0, sizeof(*bv_commandable));
             bv_commandable->relinquish_default = relinquish_default;
             bv_commandable->active_bit = BACNET_MAX_PRIORITY;
             bv->present = relinquish_default;
             bv->base.base.type = bv_commandable_type;
+            event_type = &bv_commandable_event_type;
         } else {
             if (!bv_type) {
                 bv_type = (object_impl_t *)object_create_impl_bv();
@@ -251,29 +257,38 @@ int __attribute__((weak)) binary_value_init(cJSON *object)
                 }
             }
 
-            bv = (object_bv_t *)malloc(sizeof(object_bv_t));
+            bv = (object_bv_t *)object_alloc(OBJECT_BINARY_VALUE, sizeof(object_bv_t));
             if (!bv) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
-            memset(bv, 0, sizeof(*bv));
             bv->present = 0;
             bv->base.base.type = bv_type;
+            event_type = &bv_event_type;
         }
 
         bv->base.base.instance = i;
         bv->polarity = polarity;
         bv->base.Out_Of_Service = out_of_service;
 
-        if (!vbuf_fr_str(&bv->base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (intrinsic_reporting_init(&bv->base, event_type, instance, 0) < 0) {
+            APP_ERROR("%s: invalid Instance_List[%d] Intrinsic_Reporting item\r\n", __func__, i);
+            object_free(&bv->base.base);
+            goto reclaim;
+        }
+        intrinsic_report_discrete(&bv->base, bv->present);
+
+        if (!object_set_name(&bv->base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(bv);
+            intrinsic_reporting_destroy(&bv->base);
+            object_free(&bv->base.base);
             goto reclaim;
         }
 
         if (!object_add(&bv->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(bv);
+            intrinsic_reporting_destroy(&bv->base);
+            object_free(&bv->base.base);
             goto reclaim;
         }
         i++;
@@ -289,10 +304,23 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(bv_instance);
-            free(bv_instance);
+            intrinsic_reporting_destroy(container_of(bv_instance, object_seor_t, base));
+            object_free(bv_instance);
         }
     }
 
+    if (bv_event_type) {
+        object_impl_destroy(bv_event_type);
+    }
+
+    if (bv_writable_event_type) {
+        object_impl_destroy(bv_writable_event_type);
+    }
+
+    if (bv_commandable_event_type) {
+        object_impl_destroy(bv_commandable_event_type);
+    }
+
     if (bv_type) {
         object_impl_destroy(bv_type);
     }
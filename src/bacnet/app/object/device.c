@@ -52,7 +52,7 @@ object_instance_t *device_get_instance(void)
 
 void device_database_revision_increasee(void)
 {
-    Database_Revision++;
+    __atomic_add_fetch(&Database_Revision, 1, __ATOMIC_RELEASE);
 }
 
 /* return value - 0 = ok, -1 = bad value, -2 = not allowed */
@@ -434,19 +434,26 @@ static int device_read_object_list(object_instance_t *object, BACNET_READ_PROPER
     }
 
     if (rp_data->array_index == BACNET_ARRAY_ALL) {
-        int pdu_len, len;
+        BACNET_OBJECT_ID ids[64];
+        uint32_t count;
+        int pdu_len;
 
         pdu_len = 0;
         found = object_find_index(0, &store, &obj);
         while (found) {
-            len = encode_application_object_id(&pdu[pdu_len], store->object_type, obj->instance);
-            pdu_len += len;
-            if (pdu_len >= rp_data->application_data_len) {
+            count = 0;
+            while (found && (count < sizeof(ids) / sizeof(ids[0]))) {
+                ids[count].type = store->object_type;
+                ids[count].instance = obj->instance;
+                count++;
+                found = object_find_next(&store, &obj);
+            }
+
+            if (pdu_len + count * 5 >= rp_data->application_data_len) {
                 rp_data->abort_reason = ABORT_REASON_SEGMENTATION_NOT_SUPPORTED;
                 return BACNET_STATUS_ABORT;
             }
-            
-            found = object_find_next(&store, &obj);
+            pdu_len += encode_application_object_id_array(&pdu[pdu_len], ids, count);
         }
         
         return pdu_len;
@@ -604,6 +611,7 @@ static void device_impl_init(void)
         return;
     }
     device->type = OBJECT_DEVICE;
+    device->locked_read = true;
 
     p_impl = object_impl_extend(device, PROP_OBJECT_NAME, PROPERTY_TYPE_REQUIRED);
     if (!p_impl) {
@@ -1326,12 +1334,11 @@ int device_init(cJSON *object)
         return -EPERM;
     }
 
-    device = (object_instance_t *)malloc(sizeof(object_instance_t));
+    device = (object_instance_t *)object_alloc(OBJECT_DEVICE, sizeof(object_instance_t));
     if (!device) {
         APP_ERROR("%s: not enough memory\r\n", __func__);
         return -EPERM;
     }
-    memset(device, 0, sizeof(*device));
     device->type = device_impl;
 
     tmp = cJSON_GetObjectItem(object, "Device_Id");
@@ -1351,7 +1358,7 @@ int device_init(cJSON *object)
         APP_ERROR("%s: get Device_Name item failed\r\n", __func__);
         goto out;
     }
-    if (!vbuf_fr_str(&device->object_name.vbuf, tmp->valuestring, OBJECT_NAME_MAX_LEN)) {
+    if (!object_set_name(device, tmp->valuestring)) {
         APP_ERROR("%s: set name overflow\r\n", __func__);
         goto out;
     }
@@ -1367,7 +1374,7 @@ int device_init(cJSON *object)
     return OK;
 
 out:
-    free(device);
+    object_free(device);
     
     return -EPERM;
 }
@@ -0,0 +1,1397 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * intrinsic.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Intrinsic reporting
+ *
+ * History
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "bacnet/object/intrinsic.h"
+#include "bacnet/object/nc.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/app.h"
+
+#define ALL_TRANSITIONS         ((1 << MAX_BACNET_EVENT_TRANSITION) - 1)
+
+/* Longest encoding of one BACnetEventSummary */
+#define EVENT_SUMMARY_MAX_LEN   (96)
+
+typedef struct intrinsic_event_s {
+    struct list_head node;
+    BACNET_EVENT_TRANSITION_BITS transition;
+    BACNET_EVENT_NOTIFICATION_DATA data;
+} intrinsic_event_t;
+
+/*
+ * Guards the summary list, the event queue, Event_State against the summary readers and
+ * the fields read by GetEventInformation. Taken inside the object write lock, never the
+ * other way round.
+ */
+static pthread_mutex_t intrinsic_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static LIST_HEAD(intrinsic_summary);
+
+static LIST_HEAD(intrinsic_events);
+
+static bool intrinsic_drain_posted = false;
+
+static LIST_HEAD(intrinsic_all);
+
+/* objects configured before the first evaluation pass, linked by node */
+static LIST_HEAD(intrinsic_unstarted);
+
+static bool intrinsic_started = false;
+
+static bool intrinsic_start_posted = false;
+
+static inline uint64_t intrinsic_key(BACNET_OBJECT_TYPE type, uint32_t instance)
+{
+    return ((uint64_t)type << 32) | instance;
+}
+
+static inline uint64_t intrinsic_object_key(intrinsic_t *intr)
+{
+    return intrinsic_key(intr->object->base.type->type, intr->object->base.instance);
+}
+
+static BACNET_EVENT_TRANSITION_BITS intrinsic_transition_of(BACNET_EVENT_STATE state)
+{
+    switch (state) {
+    case EVENT_STATE_NORMAL:
+        return TRANSITION_TO_NORMAL;
+
+    case EVENT_STATE_FAULT:
+        return TRANSITION_TO_FAULT;
+
+    default:
+        return TRANSITION_TO_OFFNORMAL;
+    }
+}
+
+static uint32_t intrinsic_state_bit(intrinsic_t *intr, uint32_t value)
+{
+    if (intr->kind == INTRINSIC_MULTISTATE) {
+        return ((value == 0) || (value > 32))? 0: (1U << (value - 1));
+    }
+
+    return (value > 1)? 0: (1U << value);
+}
+
+/* intrinsic_lock held */
+static void intrinsic_summary_update(intrinsic_t *intr)
+{
+    intrinsic_t *pos;
+    uint64_t key;
+    bool active;
+
+    active = (intr->object->Event_State != EVENT_STATE_NORMAL)
+        || (intr->ucAckedTransitions != ALL_TRANSITIONS);
+    if (active == intr->bSummary) {
+        return;
+    }
+
+    intr->bSummary = active;
+    if (!active) {
+        list_del_init(&intr->node);
+        return;
+    }
+
+    /* a report may beat the start pass to the object */
+    list_del_init(&intr->node);
+
+    /* GetEventInformation pages by object identifier */
+    key = intrinsic_object_key(intr);
+    list_for_each_entry(pos, &intrinsic_summary, node) {
+        if (intrinsic_object_key(pos) > key) {
+            break;
+        }
+    }
+    list_add_tail(&intr->node, &pos->node);
+}
+
+static void intrinsic_drain(void *data)
+{
+    intrinsic_event_t *ev, *tmp;
+    LIST_HEAD(events);
+
+    pthread_mutex_lock(&intrinsic_lock);
+    list_splice_init(&intrinsic_events, &events);
+    intrinsic_drain_posted = false;
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    list_for_each_entry_safe(ev, tmp, &events, node) {
+        list_del(&ev->node);
+        (void)notification_class_send(&ev->data, ev->transition);
+        free(ev);
+    }
+}
+
+static void intrinsic_fill_event(intrinsic_t *intr, BACNET_EVENT_NOTIFICATION_DATA *data,
+                BACNET_EVENT_STATE from, BACNET_EVENT_STATE to)
+{
+    object_seor_t *seor;
+
+    seor = intr->object;
+
+    data->eventObjectType = seor->base.type->type;
+    data->eventObjectInstance = seor->base.instance;
+    data->notificationClass = intr->ulNotificationClass;
+    data->notifyType = intr->NotifyType;
+    data->fromState = from;
+    data->toState = to;
+
+    data->statusFlags = 0;
+    if (to != EVENT_STATE_NORMAL) {
+        data->statusFlags |= 1 << STATUS_FLAG_IN_ALARM;
+    }
+    if (seor->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        data->statusFlags |= 1 << STATUS_FLAG_FAULT;
+    }
+    if (seor->Overridden) {
+        data->statusFlags |= 1 << STATUS_FLAG_OVERRIDDEN;
+    }
+    if (seor->Out_Of_Service) {
+        data->statusFlags |= 1 << STATUS_FLAG_OUT_OF_SERVICE;
+    }
+
+    switch (intr->kind) {
+    case INTRINSIC_ANALOG:
+        data->eventType = EVENT_OUT_OF_RANGE;
+        data->values.outOfRange.exceedingValue = intr->Value.fValue;
+        data->values.outOfRange.deadband = intr->fDeadband;
+        if ((to == EVENT_STATE_LOW_LIMIT) || (from == EVENT_STATE_LOW_LIMIT)) {
+            data->values.outOfRange.exceededLimit = intr->fLowLimit;
+        } else {
+            data->values.outOfRange.exceededLimit = intr->fHighLimit;
+        }
+        break;
+
+    case INTRINSIC_BINARY:
+        data->eventType = EVENT_CHANGE_OF_STATE;
+        data->values.changeOfState.tag = PROP_STATE_BINARY_VALUE;
+        data->values.changeOfState.state = intr->Value.ulValue;
+        break;
+
+    default:
+        data->eventType = EVENT_CHANGE_OF_STATE;
+        data->values.changeOfState.tag = PROP_STATE_UNSIGNED_VALUE;
+        data->values.changeOfState.state = intr->Value.ulValue;
+        break;
+    }
+}
+
+/* object write lock held */
+static void intrinsic_transition(intrinsic_t *intr, BACNET_EVENT_STATE to)
+{
+    BACNET_EVENT_TRANSITION_BITS transition;
+    BACNET_EVENT_STATE from;
+    intrinsic_event_t *ev;
+    uint8_t priority;
+    bool ack_required;
+    bool post;
+
+    transition = intrinsic_transition_of(to);
+
+    priority = 0;
+    ack_required = false;
+    ev = NULL;
+    if (intr->ucEventEnable & (1 << transition)) {
+        if (!notification_class_get(intr->ulNotificationClass, transition, &priority,
+                &ack_required)) {
+            APP_WARN("%s: Notification_Class(%d) not found\r\n", __func__,
+                intr->ulNotificationClass);
+        } else {
+            ev = (intrinsic_event_t *)malloc(sizeof(intrinsic_event_t));
+            if (ev == NULL) {
+                APP_ERROR("%s: not enough memory\r\n", __func__);
+            }
+        }
+    }
+
+    post = false;
+
+    pthread_mutex_lock(&intrinsic_lock);
+
+    from = intr->object->Event_State;
+    intr->object->Event_State = to;
+    intr->Pending = to;
+    intr->tEventTimeStamps[transition] = time(NULL);
+
+    if (ev && ack_required) {
+        intr->ucAckedTransitions &= ~(1 << transition);
+    } else {
+        intr->ucAckedTransitions |= 1 << transition;
+    }
+    intrinsic_summary_update(intr);
+
+    if (ev) {
+        ev->transition = transition;
+        intrinsic_fill_event(intr, &ev->data, from, to);
+        ev->data.timeStamp = intr->tEventTimeStamps[transition];
+        ev->data.priority = priority;
+        ev->data.ackRequired = ack_required;
+        list_add_tail(&ev->node, &intrinsic_events);
+        if (!intrinsic_drain_posted) {
+            intrinsic_drain_posted = true;
+            post = true;
+        }
+    }
+
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    /* one drain handles every transition queued until it runs */
+    if (post && (el_post(&el_default_loop, intrinsic_drain, NULL) < 0)) {
+        APP_ERROR("%s: post event drain failed\r\n", __func__);
+        pthread_mutex_lock(&intrinsic_lock);
+        intrinsic_drain_posted = false;
+        pthread_mutex_unlock(&intrinsic_lock);
+    }
+}
+
+/* the state the event algorithm asks for, without Time_Delay */
+static BACNET_EVENT_STATE intrinsic_target(intrinsic_t *intr)
+{
+    object_seor_t *seor;
+    float value;
+
+    seor = intr->object;
+    if (seor->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        return EVENT_STATE_FAULT;
+    }
+
+    if (intr->kind != INTRINSIC_ANALOG) {
+        return (intr->ulAlarmValues & intrinsic_state_bit(intr, intr->Value.ulValue))?
+            EVENT_STATE_OFFNORMAL: EVENT_STATE_NORMAL;
+    }
+
+    value = intr->Value.fValue;
+    if ((intr->ucLimitEnable & (1 << EVENT_HIGH_LIMIT_ENABLE)) && (value > intr->fHighLimit)) {
+        return EVENT_STATE_HIGH_LIMIT;
+    }
+
+    if ((intr->ucLimitEnable & (1 << EVENT_LOW_LIMIT_ENABLE)) && (value < intr->fLowLimit)) {
+        return EVENT_STATE_LOW_LIMIT;
+    }
+
+    /* back to normal only past the deadband */
+    if ((seor->Event_State == EVENT_STATE_HIGH_LIMIT)
+            && (intr->ucLimitEnable & (1 << EVENT_HIGH_LIMIT_ENABLE))
+            && (value > intr->fHighLimit - intr->fDeadband)) {
+        return EVENT_STATE_HIGH_LIMIT;
+    }
+
+    if ((seor->Event_State == EVENT_STATE_LOW_LIMIT)
+            && (intr->ucLimitEnable & (1 << EVENT_LOW_LIMIT_ENABLE))
+            && (value < intr->fLowLimit + intr->fDeadband)) {
+        return EVENT_STATE_LOW_LIMIT;
+    }
+
+    return EVENT_STATE_NORMAL;
+}
+
+static void intrinsic_timer_handler(el_timer_t *timer);
+
+static void intrinsic_arm(intrinsic_t *intr, unsigned timeout_ms)
+{
+    if (intr->timer == NULL) {
+        intr->timer = el_timer_create(&el_default_loop, timeout_ms);
+        if (intr->timer == NULL) {
+            APP_ERROR("%s: create timer failed\r\n", __func__);
+            return;
+        }
+        intr->timer->handler = intrinsic_timer_handler;
+        intr->timer->data = intr;
+        return;
+    }
+
+    if (el_timer_mod(&el_default_loop, intr->timer, timeout_ms) < 0) {
+        APP_ERROR("%s: mod timer failed\r\n", __func__);
+    }
+}
+
+/* object write lock held */
+static void intrinsic_evaluate(intrinsic_t *intr)
+{
+    BACNET_EVENT_STATE current, target;
+
+    if (!intr->bValid) {
+        return;
+    }
+
+    current = intr->object->Event_State;
+    target = intrinsic_target(intr);
+
+    /* leaving fault goes through normal at once, the value is judged again from there */
+    if ((current == EVENT_STATE_FAULT) && (target != EVENT_STATE_FAULT)) {
+        intrinsic_transition(intr, EVENT_STATE_NORMAL);
+        current = EVENT_STATE_NORMAL;
+        target = intrinsic_target(intr);
+    }
+
+    if (target == current) {
+        intr->Pending = current;
+        return;
+    }
+
+    /* Time_Delay does not apply to fault */
+    if ((target == EVENT_STATE_FAULT) || (intr->ulTimeDelay == 0)) {
+        intrinsic_transition(intr, target);
+        return;
+    }
+
+    if (intr->Pending == target) {
+        return;
+    }
+
+    intr->Pending = target;
+    intr->uPendingDue = el_current_millisecond() + intr->ulTimeDelay * 1000;
+    intrinsic_arm(intr, intr->ulTimeDelay * 1000);
+}
+
+static void intrinsic_timer_handler(el_timer_t *timer)
+{
+    intrinsic_t *intr;
+    int remain;
+
+    intr = (intrinsic_t *)timer->data;
+
+    object_write_lock(&intr->object->base);
+
+    if (intr->Pending != intr->object->Event_State) {
+        /* a rearm from another thread may still be on its way */
+        remain = (int)(intr->uPendingDue - el_current_millisecond());
+        if (remain > 0) {
+            (void)el_timer_mod(&el_default_loop, timer, remain);
+        } else if (intrinsic_target(intr) == intr->Pending) {
+            intrinsic_transition(intr, intr->Pending);
+        } else {
+            intr->Pending = intr->object->Event_State;
+            intrinsic_evaluate(intr);
+        }
+    }
+
+    object_write_unlock(&intr->object->base);
+}
+
+/*
+ * Runs once on the loop after the objects are configured, so that every Notification Class
+ * exists before the first transition looks it up.
+ */
+static void intrinsic_start(void *data)
+{
+    intrinsic_t *intr;
+
+    __atomic_store_n(&intrinsic_started, true, __ATOMIC_RELEASE);
+
+    for (;;) {
+        pthread_mutex_lock(&intrinsic_lock);
+        if (list_empty(&intrinsic_unstarted)) {
+            pthread_mutex_unlock(&intrinsic_lock);
+            break;
+        }
+        intr = list_first_entry(&intrinsic_unstarted, intrinsic_t, node);
+        list_del_init(&intr->node);
+        pthread_mutex_unlock(&intrinsic_lock);
+
+        object_write_lock(&intr->object->base);
+        intrinsic_evaluate(intr);
+        object_write_unlock(&intr->object->base);
+    }
+}
+
+static inline bool intrinsic_running(void)
+{
+    return __atomic_load_n(&intrinsic_started, __ATOMIC_ACQUIRE);
+}
+
+void __intrinsic_report_analog(intrinsic_t *intr, float value)
+{
+    if (intr->bValid && (intr->Value.fValue == value)) {
+        return;
+    }
+
+    intr->Value.fValue = value;
+    intr->bValid = true;
+    if (intrinsic_running()) {
+        intrinsic_evaluate(intr);
+    }
+}
+
+void __intrinsic_report_discrete(intrinsic_t *intr, uint32_t value)
+{
+    if (intr->bValid && (intr->Value.ulValue == value)) {
+        return;
+    }
+
+    intr->Value.ulValue = value;
+    intr->bValid = true;
+    if (intrinsic_running()) {
+        intrinsic_evaluate(intr);
+    }
+}
+
+void __intrinsic_report_refresh(intrinsic_t *intr)
+{
+    if (intrinsic_running()) {
+        intrinsic_evaluate(intr);
+    }
+}
+
+static intrinsic_t *intrinsic_of(object_instance_t *object)
+{
+    return container_of(object, object_seor_t, base)->intrinsic;
+}
+
+static int intrinsic_read_time_delay(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_unsigned(rp_data->application_data, intrinsic_of(object)->ulTimeDelay);
+}
+
+static int intrinsic_write_time_delay(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (decode_application_unsigned(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+    intr->ulTimeDelay = value;
+
+    /* a pending transition starts timing again with the new delay */
+    if (intr->Pending != intr->object->Event_State) {
+        intr->Pending = intr->object->Event_State;
+        intrinsic_report_refresh(intr->object);
+    }
+
+    return 0;
+}
+
+static int intrinsic_read_notification_class(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_unsigned(rp_data->application_data,
+        intrinsic_of(object)->ulNotificationClass);
+}
+
+static int intrinsic_write_notification_class(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (decode_application_unsigned(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+
+    pthread_mutex_lock(&intrinsic_lock);
+    intr->ulNotificationClass = value;
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    return 0;
+}
+
+static int intrinsic_encode_bits(uint8_t *pdu, uint8_t bits, int count)
+{
+    BACNET_BIT_STRING bit_string;
+    uint8_t tmpbuf[1] = {0};
+    int i;
+
+    bitstring_init(&bit_string, tmpbuf, count);
+    for (i = 0; i < count; i++) {
+        bitstring_set_bit(&bit_string, i, (bits & (1 << i)) != 0);
+    }
+
+    return encode_application_bitstring(pdu, &bit_string);
+}
+
+static int intrinsic_decode_bits(BACNET_WRITE_PROPERTY_DATA *wp_data, int count, uint8_t *bits)
+{
+    BACNET_BIT_STRING bit_string;
+    int i;
+
+    if (decode_application_bitstring(wp_data->application_data, &bit_string)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (bitstring_size(&bit_string) < count) {
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    *bits = 0;
+    for (i = 0; i < count; i++) {
+        if (bitstring_get_bit(&bit_string, i)) {
+            *bits |= 1 << i;
+        }
+    }
+
+    return 0;
+}
+
+static int intrinsic_read_event_enable(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return intrinsic_encode_bits(rp_data->application_data, intrinsic_of(object)->ucEventEnable,
+        MAX_BACNET_EVENT_TRANSITION);
+}
+
+static int intrinsic_write_event_enable(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint8_t bits;
+    int rv;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    rv = intrinsic_decode_bits(wp_data, MAX_BACNET_EVENT_TRANSITION, &bits);
+    if (rv < 0) {
+        return rv;
+    }
+
+    intr = intrinsic_of(object);
+
+    pthread_mutex_lock(&intrinsic_lock);
+    intr->ucEventEnable = bits;
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    return 0;
+}
+
+static int intrinsic_read_acked_transitions(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return intrinsic_encode_bits(rp_data->application_data,
+        __atomic_load_n(&intrinsic_of(object)->ucAckedTransitions, __ATOMIC_RELAXED),
+        MAX_BACNET_EVENT_TRANSITION);
+}
+
+static int intrinsic_read_notify_type(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_enumerated(rp_data->application_data, intrinsic_of(object)->NotifyType);
+}
+
+static int intrinsic_write_notify_type(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (decode_application_enumerated(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (value > NOTIFY_EVENT) {
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+
+    pthread_mutex_lock(&intrinsic_lock);
+    intr->NotifyType = (BACNET_NOTIFY_TYPE)value;
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    return 0;
+}
+
+static int intrinsic_read_event_time_stamps(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    intrinsic_t *intr;
+    uint8_t *pdu;
+    int len;
+    int i;
+
+    if (range != NULL) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+    pdu = rp_data->application_data;
+
+    if (rp_data->array_index == 0) {
+        return encode_application_unsigned(pdu, MAX_BACNET_EVENT_TRANSITION);
+    }
+
+    if (rp_data->array_index == BACNET_ARRAY_ALL) {
+        len = 0;
+        for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+            len += encode_timestamp(&pdu[len], intr->tEventTimeStamps[i]);
+        }
+        return len;
+    }
+
+    if (rp_data->array_index > MAX_BACNET_EVENT_TRANSITION) {
+        rp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_timestamp(pdu, intr->tEventTimeStamps[rp_data->array_index - 1]);
+}
+
+static int intrinsic_read_real(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    intrinsic_t *intr;
+    float value;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+    switch (rp_data->property_id) {
+    case PROP_HIGH_LIMIT:
+        value = intr->fHighLimit;
+        break;
+
+    case PROP_LOW_LIMIT:
+        value = intr->fLowLimit;
+        break;
+
+    default:
+        value = intr->fDeadband;
+        break;
+    }
+
+    return encode_application_real(rp_data->application_data, value);
+}
+
+static int intrinsic_write_real(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    float value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (decode_application_real(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+    switch (wp_data->property_id) {
+    case PROP_HIGH_LIMIT:
+        intr->fHighLimit = value;
+        break;
+
+    case PROP_LOW_LIMIT:
+        intr->fLowLimit = value;
+        break;
+
+    default:
+        if (value < 0.0f) {
+            wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+            return BACNET_STATUS_ERROR;
+        }
+        intr->fDeadband = value;
+        break;
+    }
+
+    intrinsic_report_refresh(intr->object);
+
+    return 0;
+}
+
+static int intrinsic_read_limit_enable(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return intrinsic_encode_bits(rp_data->application_data, intrinsic_of(object)->ucLimitEnable, 2);
+}
+
+static int intrinsic_write_limit_enable(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint8_t bits;
+    int rv;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    rv = intrinsic_decode_bits(wp_data, 2, &bits);
+    if (rv < 0) {
+        return rv;
+    }
+
+    intr = intrinsic_of(object);
+    intr->ucLimitEnable = bits;
+    intrinsic_report_refresh(intr->object);
+
+    return 0;
+}
+
+static int intrinsic_read_alarm_value(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_enumerated(rp_data->application_data,
+        (intrinsic_of(object)->ulAlarmValues & (1 << BINARY_ACTIVE))? BINARY_ACTIVE: BINARY_INACTIVE);
+}
+
+static int intrinsic_write_alarm_value(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (decode_application_enumerated(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (value >= MAX_BINARY_PV) {
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+    intr->ulAlarmValues = 1 << value;
+    intrinsic_report_refresh(intr->object);
+
+    return 0;
+}
+
+static int intrinsic_read_alarm_values(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    intrinsic_t *intr;
+    uint8_t *pdu;
+    uint32_t i;
+    int len;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+    pdu = rp_data->application_data;
+
+    len = 0;
+    for (i = 0; i < 32; i++) {
+        if (intr->ulAlarmValues & (1U << i)) {
+            len += encode_application_unsigned(&pdu[len], i + 1);
+        }
+    }
+
+    return len;
+}
+
+static int intrinsic_write_alarm_values(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    intrinsic_t *intr;
+    uint32_t values, value;
+    int len, dec_len;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr = intrinsic_of(object);
+
+    values = 0;
+    len = 0;
+    while (len < wp_data->application_data_len) {
+        dec_len = decode_application_unsigned(&wp_data->application_data[len], &value);
+        if (dec_len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        len += dec_len;
+
+        if ((value == 0) || (value > intr->ulStates) || (value > 32)) {
+            wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+            return BACNET_STATUS_ERROR;
+        }
+        values |= 1U << (value - 1);
+    }
+
+    if (len != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    intr->ulAlarmValues = values;
+    intrinsic_report_refresh(intr->object);
+
+    return 0;
+}
+
+static bool intrinsic_extend(object_impl_t *type, BACNET_PROPERTY_ID property,
+                int (*read_property)(object_instance_t *, BACNET_READ_PROPERTY_DATA *, RR_RANGE *),
+                int (*write_property)(object_instance_t *, BACNET_WRITE_PROPERTY_DATA *))
+{
+    property_impl_t *p_impl;
+
+    p_impl = object_impl_extend(type, property, PROPERTY_TYPE_OPTIONAL);
+    if (!p_impl) {
+        APP_ERROR("%s: extend property(%d) failed\r\n", __func__, property);
+        return false;
+    }
+    p_impl->read_property = read_property;
+    p_impl->write_property = write_property;
+
+    return true;
+}
+
+static object_impl_t *intrinsic_impl_clone(const object_impl_t *type, intrinsic_kind_t kind)
+{
+    object_impl_t *variant;
+
+    variant = object_impl_clone(type);
+    if (!variant) {
+        APP_ERROR("%s: clone type impl failed\r\n", __func__);
+        return NULL;
+    }
+
+    if (!intrinsic_extend(variant, PROP_TIME_DELAY, intrinsic_read_time_delay,
+                intrinsic_write_time_delay)
+            || !intrinsic_extend(variant, PROP_NOTIFICATION_CLASS,
+                intrinsic_read_notification_class, intrinsic_write_notification_class)
+            || !intrinsic_extend(variant, PROP_EVENT_ENABLE, intrinsic_read_event_enable,
+                intrinsic_write_event_enable)
+            || !intrinsic_extend(variant, PROP_ACKED_TRANSITIONS,
+                intrinsic_read_acked_transitions, NULL)
+            || !intrinsic_extend(variant, PROP_NOTIFY_TYPE, intrinsic_read_notify_type,
+                intrinsic_write_notify_type)
+            || !intrinsic_extend(variant, PROP_EVENT_TIME_STAMPS,
+                intrinsic_read_event_time_stamps, NULL)) {
+        goto out;
+    }
+
+    switch (kind) {
+    case INTRINSIC_ANALOG:
+        if (!intrinsic_extend(variant, PROP_HIGH_LIMIT, intrinsic_read_real, intrinsic_write_real)
+                || !intrinsic_extend(variant, PROP_LOW_LIMIT, intrinsic_read_real,
+                    intrinsic_write_real)
+                || !intrinsic_extend(variant, PROP_DEADBAND, intrinsic_read_real,
+                    intrinsic_write_real)
+                || !intrinsic_extend(variant, PROP_LIMIT_ENABLE, intrinsic_read_limit_enable,
+                    intrinsic_write_limit_enable)) {
+            goto out;
+        }
+        break;
+
+    case INTRINSIC_BINARY:
+        if (!intrinsic_extend(variant, PROP_ALARM_VALUE, intrinsic_read_alarm_value,
+                intrinsic_write_alarm_value)) {
+            goto out;
+        }
+        break;
+
+    default:
+        if (!intrinsic_extend(variant, PROP_ALARM_VALUES, intrinsic_read_alarm_values,
+                intrinsic_write_alarm_values)) {
+            goto out;
+        }
+        break;
+    }
+
+    return variant;
+
+out:
+    object_impl_destroy(variant);
+
+    return NULL;
+}
+
+static int intrinsic_parse_bits(cJSON *array, int count, uint8_t *bits)
+{
+    cJSON *tmp;
+    int i;
+
+    if ((array->type != cJSON_Array) || (cJSON_GetArraySize(array) != count)) {
+        return -EINVAL;
+    }
+
+    *bits = 0;
+    i = 0;
+    cJSON_ArrayForEach(tmp, array) {
+        if ((tmp->type != cJSON_False) && (tmp->type != cJSON_True)) {
+            return -EINVAL;
+        }
+        if (tmp->type == cJSON_True) {
+            *bits |= 1 << i;
+        }
+        i++;
+    }
+
+    return OK;
+}
+
+static int intrinsic_parse_unsigned(cJSON *cfg, const char *name, uint32_t *value)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, name);
+    if (tmp == NULL) {
+        return OK;
+    }
+
+    if ((tmp->type != cJSON_Number) || (tmp->valuedouble < 0)
+            || (tmp->valuedouble > 4294967295.0)) {
+        APP_ERROR("%s: invalid %s item\r\n", __func__, name);
+        return -EINVAL;
+    }
+    *value = (uint32_t)tmp->valuedouble;
+
+    return OK;
+}
+
+static int intrinsic_parse_real(cJSON *cfg, const char *name, float *value, bool *present)
+{
+    cJSON *tmp;
+
+    *present = false;
+    tmp = cJSON_GetObjectItem(cfg, name);
+    if (tmp == NULL) {
+        return OK;
+    }
+
+    if (tmp->type != cJSON_Number) {
+        APP_ERROR("%s: invalid %s item\r\n", __func__, name);
+        return -EINVAL;
+    }
+    *value = (float)tmp->valuedouble;
+    *present = true;
+
+    return OK;
+}
+
+static int intrinsic_parse(intrinsic_t *intr, cJSON *cfg)
+{
+    cJSON *tmp, *item;
+    uint32_t value;
+    bool high, low, dummy;
+
+    if ((intrinsic_parse_unsigned(cfg, "Notification_Class", &intr->ulNotificationClass) < 0)
+            || (intrinsic_parse_unsigned(cfg, "Time_Delay", &intr->ulTimeDelay) < 0)) {
+        return -EINVAL;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "Event_Enable");
+    if (tmp && (intrinsic_parse_bits(tmp, MAX_BACNET_EVENT_TRANSITION, &intr->ucEventEnable) < 0)) {
+        APP_ERROR("%s: invalid Event_Enable item\r\n", __func__);
+        return -EINVAL;
+    }
+
+    value = NOTIFY_ALARM;
+    if (intrinsic_parse_unsigned(cfg, "Notify_Type", &value) < 0) {
+        return -EINVAL;
+    }
+    if (value > NOTIFY_EVENT) {
+        APP_ERROR("%s: invalid Notify_Type(%d)\r\n", __func__, value);
+        return -EINVAL;
+    }
+    intr->NotifyType = (BACNET_NOTIFY_TYPE)value;
+
+    switch (intr->kind) {
+    case INTRINSIC_ANALOG:
+        if ((intrinsic_parse_real(cfg, "High_Limit", &intr->fHighLimit, &high) < 0)
+                || (intrinsic_parse_real(cfg, "Low_Limit", &intr->fLowLimit, &low) < 0)
+                || (intrinsic_parse_real(cfg, "Deadband", &intr->fDeadband, &dummy) < 0)) {
+            return -EINVAL;
+        }
+        if (intr->fDeadband < 0.0f) {
+            APP_ERROR("%s: negative Deadband\r\n", __func__);
+            return -EINVAL;
+        }
+
+        /* by default a configured limit is enabled */
+        intr->ucLimitEnable = (high? (1 << EVENT_HIGH_LIMIT_ENABLE): 0)
+            | (low? (1 << EVENT_LOW_LIMIT_ENABLE): 0);
+        tmp = cJSON_GetObjectItem(cfg, "Limit_Enable");
+        if (tmp && (intrinsic_parse_bits(tmp, 2, &intr->ucLimitEnable) < 0)) {
+            APP_ERROR("%s: invalid Limit_Enable item\r\n", __func__);
+            return -EINVAL;
+        }
+        break;
+
+    case INTRINSIC_BINARY:
+        value = BINARY_ACTIVE;
+        if (intrinsic_parse_unsigned(cfg, "Alarm_Value", &value) < 0) {
+            return -EINVAL;
+        }
+        if (value >= MAX_BINARY_PV) {
+            APP_ERROR("%s: invalid Alarm_Value(%d)\r\n", __func__, value);
+            return -EINVAL;
+        }
+        intr->ulAlarmValues = 1 << value;
+        break;
+
+    default:
+        tmp = cJSON_GetObjectItem(cfg, "Alarm_Values");
+        if (tmp == NULL) {
+            break;
+        }
+        if (tmp->type != cJSON_Array) {
+            APP_ERROR("%s: invalid Alarm_Values item\r\n", __func__);
+            return -EINVAL;
+        }
+        cJSON_ArrayForEach(item, tmp) {
+            if ((item->type != cJSON_Number) || (item->valueint < 1)
+                    || ((uint32_t)item->valueint > intr->ulStates) || (item->valueint > 32)) {
+                APP_ERROR("%s: invalid Alarm_Values state\r\n", __func__);
+                return -EINVAL;
+            }
+            intr->ulAlarmValues |= 1U << (item->valueint - 1);
+        }
+        break;
+    }
+
+    return OK;
+}
+
+int intrinsic_reporting_init(object_seor_t *object, object_impl_t **variant, cJSON *instance,
+        uint32_t states)
+{
+    intrinsic_t *intr;
+    intrinsic_kind_t kind;
+    cJSON *cfg;
+    bool post;
+
+    if ((object == NULL) || (variant == NULL) || (instance == NULL)) {
+        APP_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    cfg = cJSON_GetObjectItem(instance, "Intrinsic_Reporting");
+    if (cfg == NULL) {
+        return OK;
+    }
+
+    if (cfg->type != cJSON_Object) {
+        APP_ERROR("%s: Intrinsic_Reporting item is not an object\r\n", __func__);
+        return -EINVAL;
+    }
+
+    switch (object->base.type->type) {
+    case OBJECT_ANALOG_INPUT:
+    case OBJECT_ANALOG_VALUE:
+        kind = INTRINSIC_ANALOG;
+        break;
+
+    case OBJECT_BINARY_INPUT:
+    case OBJECT_BINARY_VALUE:
+        kind = INTRINSIC_BINARY;
+        break;
+
+    case OBJECT_MULTI_STATE_INPUT:
+        kind = INTRINSIC_MULTISTATE;
+        break;
+
+    default:
+        APP_ERROR("%s: object type(%d) has no intrinsic reporting\r\n", __func__,
+            object->base.type->type);
+        return -EPERM;
+    }
+
+    intr = (intrinsic_t *)malloc(sizeof(intrinsic_t));
+    if (intr == NULL) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        return -ENOMEM;
+    }
+    memset(intr, 0, sizeof(intrinsic_t));
+    INIT_LIST_HEAD(&intr->link);
+    INIT_LIST_HEAD(&intr->node);
+    intr->object = object;
+    intr->kind = kind;
+    intr->Pending = object->Event_State;
+    intr->ucEventEnable = ALL_TRANSITIONS;
+    intr->ucAckedTransitions = ALL_TRANSITIONS;
+    intr->ulStates = states;
+
+    if (intrinsic_parse(intr, cfg) < 0) {
+        free(intr);
+        return -EINVAL;
+    }
+
+    if (*variant == NULL) {
+        *variant = intrinsic_impl_clone(object->base.type, kind);
+        if (*variant == NULL) {
+            free(intr);
+            return -ENOMEM;
+        }
+    }
+
+    object->base.type = *variant;
+    object->intrinsic = intr;
+
+    pthread_mutex_lock(&intrinsic_lock);
+    list_add_tail(&intr->link, &intrinsic_all);
+    list_add_tail(&intr->node, &intrinsic_unstarted);
+    post = !intrinsic_start_posted;
+    intrinsic_start_posted = true;
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    if (post && (el_post(&el_default_loop, intrinsic_start, NULL) < 0)) {
+        APP_ERROR("%s: post intrinsic start failed\r\n", __func__);
+    }
+
+    return OK;
+}
+
+void intrinsic_reporting_destroy(object_seor_t *object)
+{
+    intrinsic_t *intr;
+
+    if ((object == NULL) || (object->intrinsic == NULL)) {
+        return;
+    }
+
+    intr = object->intrinsic;
+    object->intrinsic = NULL;
+
+    /* on the unstarted or the summary list, or on none */
+    pthread_mutex_lock(&intrinsic_lock);
+    list_del(&intr->link);
+    list_del_init(&intr->node);
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    if (intr->timer) {
+        (void)el_timer_destroy(&el_default_loop, intr->timer);
+    }
+
+    free(intr);
+}
+
+void intrinsic_reporting_exit(void)
+{
+    intrinsic_t *intr, *tmp;
+    LIST_HEAD(all);
+
+    pthread_mutex_lock(&intrinsic_lock);
+    list_splice_init(&intrinsic_all, &all);
+    INIT_LIST_HEAD(&intrinsic_summary);
+    INIT_LIST_HEAD(&intrinsic_unstarted);
+    intrinsic_start_posted = false;
+    __atomic_store_n(&intrinsic_started, false, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    list_for_each_entry_safe(intr, tmp, &all, link) {
+        intr->object->intrinsic = NULL;
+        if (intr->timer) {
+            (void)el_timer_destroy(&el_default_loop, intr->timer);
+        }
+        free(intr);
+    }
+}
+
+/* intrinsic_lock held */
+static int intrinsic_encode_summary(uint8_t *pdu, intrinsic_t *intr)
+{
+    BACNET_BIT_STRING bit_string;
+    uint8_t tmpbuf[1] = {0};
+    uint8_t priority;
+    int len;
+    int i;
+
+    /* Tag 0: objectIdentifier */
+    len = encode_context_object_id(pdu, 0, intr->object->base.type->type,
+        intr->object->base.instance);
+
+    /* Tag 1: eventState */
+    len += encode_context_enumerated(&pdu[len], 1, intr->object->Event_State);
+
+    /* Tag 2: acknowledgedTransitions */
+    bitstring_init(&bit_string, tmpbuf, MAX_BACNET_EVENT_TRANSITION);
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        bitstring_set_bit(&bit_string, i, (intr->ucAckedTransitions & (1 << i)) != 0);
+    }
+    len += encode_context_bitstring(&pdu[len], 2, &bit_string);
+
+    /* Tag 3: eventTimeStamps */
+    len += encode_opening_tag(&pdu[len], 3);
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        len += encode_timestamp(&pdu[len], intr->tEventTimeStamps[i]);
+    }
+    len += encode_closing_tag(&pdu[len], 3);
+
+    /* Tag 4: notifyType */
+    len += encode_context_enumerated(&pdu[len], 4, intr->NotifyType);
+
+    /* Tag 5: eventEnable */
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        bitstring_set_bit(&bit_string, i, (intr->ucEventEnable & (1 << i)) != 0);
+    }
+    len += encode_context_bitstring(&pdu[len], 5, &bit_string);
+
+    /* Tag 6: eventPriorities */
+    len += encode_opening_tag(&pdu[len], 6);
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        priority = 255;
+        (void)notification_class_get(intr->ulNotificationClass, (BACNET_EVENT_TRANSITION_BITS)i,
+            &priority, NULL);
+        len += encode_application_unsigned(&pdu[len], priority);
+    }
+    len += encode_closing_tag(&pdu[len], 6);
+
+    return len;
+}
+
+int intrinsic_encode_event_summaries(uint8_t *pdu, int max_len, BACNET_OBJECT_TYPE type,
+        uint32_t instance, bool *more)
+{
+    uint8_t summary[EVENT_SUMMARY_MAX_LEN];
+    intrinsic_t *intr;
+    uint64_t last;
+    bool started;
+    int len, item_len;
+
+    *more = false;
+    started = (type == MAX_BACNET_OBJECT_TYPE);
+    last = started? 0: intrinsic_key(type, instance);
+
+    len = 0;
+
+    pthread_mutex_lock(&intrinsic_lock);
+
+    list_for_each_entry(intr, &intrinsic_summary, node) {
+        if (!started && (intrinsic_object_key(intr) <= last)) {
+            continue;
+        }
+
+        item_len = intrinsic_encode_summary(summary, intr);
+        if (len + item_len > max_len) {
+            *more = true;
+            break;
+        }
+        memcpy(&pdu[len], summary, item_len);
+        len += item_len;
+    }
+
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    return len;
+}
+
+BACNET_ERROR_CODE intrinsic_acknowledge(BACNET_OBJECT_TYPE type, uint32_t instance,
+        BACNET_EVENT_STATE state, const BACNET_TIMESTAMP *stamp)
+{
+    BACNET_EVENT_TRANSITION_BITS transition;
+    intrinsic_t *intr;
+    uint64_t key;
+    bool found;
+
+    transition = intrinsic_transition_of(state);
+    key = intrinsic_key(type, instance);
+    found = false;
+
+    pthread_mutex_lock(&intrinsic_lock);
+
+    list_for_each_entry(intr, &intrinsic_summary, node) {
+        if (intrinsic_object_key(intr) == key) {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        pthread_mutex_unlock(&intrinsic_lock);
+        if (((uint32_t)type >= MAX_BACNET_OBJECT_TYPE) || (instance >= BACNET_MAX_INSTANCE)
+                || (object_find(type, instance) == NULL)) {
+            return ERROR_CODE_UNKNOWN_OBJECT;
+        }
+        /* nothing left to acknowledge */
+        return MAX_BACNET_ERROR_CODE;
+    }
+
+    if (!timestamp_match(stamp, intr->tEventTimeStamps[transition])) {
+        pthread_mutex_unlock(&intrinsic_lock);
+        return ERROR_CODE_INVALID_TIME_STAMP;
+    }
+
+    __atomic_store_n(&intr->ucAckedTransitions, intr->ucAckedTransitions | (1 << transition),
+        __ATOMIC_RELAXED);
+    intrinsic_summary_update(intr);
+
+    pthread_mutex_unlock(&intrinsic_lock);
+
+    return MAX_BACNET_ERROR_CODE;
+}
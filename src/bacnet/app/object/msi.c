@@ -15,6 +15,7 @@
 #include <errno.h>
 
 #include "bacnet/object/msi.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacdef.h"
@@ -61,6 +62,7 @@ static int msi_write_present_value(object_instance_t *object, BACNET_WRITE_PROPE
     }
 
     msi->present = value;
+    intrinsic_report_discrete(&msi->base, value);
     
     return 0;
 }
@@ -119,6 +121,7 @@ int __attribute__((weak)) multistate_input_init(cJSON *object)
 {
     cJSON *array, *instance, *tmp;
     object_impl_t *msi_type = NULL;
+    object_impl_t *msi_event_type = NULL;
     object_msi_t *msi;
     object_instance_t *msi_instance;
     char *name;
@@ -136,6 +139,11 @@ int __attribute__((weak)) multistate_input_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_MULTI_STATE_INPUT, sizeof(object_msi_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -177,27 +185,35 @@ int __attribute__((weak)) multistate_input_init(cJSON *object)
             }
         }
 
-        msi = (object_msi_t *)malloc(sizeof(object_msi_t));
+        msi = (object_msi_t *)object_alloc(OBJECT_MULTI_STATE_INPUT, sizeof(object_msi_t));
         if (!msi) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(msi, 0, sizeof(*msi));
         msi->base.base.instance = i;
         msi->base.base.type = msi_type;
         msi->base.Out_Of_Service = out_of_service;
         msi->present = 1;
         msi->number_of_states = number_of_states;
 
-        if (!vbuf_fr_str(&msi->base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (intrinsic_reporting_init(&msi->base, &msi_event_type, instance, number_of_states) < 0) {
+            APP_ERROR("%s: invalid Instance_List[%d] Intrinsic_Reporting item\r\n", __func__, i);
+            object_free(&msi->base.base);
+            goto reclaim;
+        }
+        intrinsic_report_discrete(&msi->base, msi->present);
+
+        if (!object_set_name(&msi->base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(msi);
+            intrinsic_reporting_destroy(&msi->base);
+            object_free(&msi->base.base);
             goto reclaim;
         }
 
         if (!object_add(&msi->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(msi);
+            intrinsic_reporting_destroy(&msi->base);
+            object_free(&msi->base.base);
             goto reclaim;
         }
         i++;
@@ -213,10 +229,15 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(msi_instance);
-            free(msi_instance);
+            intrinsic_reporting_destroy(container_of(msi_instance, object_seor_t, base));
+            object_free(msi_instance);
         }
     }
 
+    if (msi_event_type) {
+        object_impl_destroy(msi_event_type);
+    }
+
     if (msi_type) {
         object_impl_destroy(msi_type);
     }
@@ -370,6 +370,11 @@ int __attribute__((weak)) multistate_output_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_MULTI_STATE_OUTPUT, sizeof(object_mso_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -423,12 +428,11 @@ int __attribute__((weak)) multistate_output_init(cJSON *object)
             }
         }
 
-        mso = (object_mso_t *)malloc(sizeof(object_mso_t));
+        mso = (object_mso_t *)object_alloc(OBJECT_MULTI_STATE_OUTPUT, sizeof(object_mso_t));
         if (!mso) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(mso, 0, sizeof(*mso));
         mso->base.base.base.instance = i;
         mso->base.base.base.type = mso_type;
         mso->base.base.Out_Of_Service = out_of_service;
@@ -437,15 +441,15 @@ int __attribute__((weak)) multistate_output_init(cJSON *object)
         mso->active_bit = BACNET_MAX_PRIORITY;
         mso->relinquish_default = relinquish_default;
 
-        if (!vbuf_fr_str(&mso->base.base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (!object_set_name(&mso->base.base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(mso);
+            object_free(&mso->base.base.base);
             goto reclaim;
         }
 
         if (!object_add(&mso->base.base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(mso);
+            object_free(&mso->base.base.base);
             goto reclaim;
         }
         i++;
@@ -461,7 +465,7 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(mso_instance);
-            free(mso_instance);
+            object_free(mso_instance);
         }
     }
 
@@ -203,13 +203,12 @@ int __attribute__((weak)) multistate_value_init(cJSON *object)
                 }
             }
 
-            msv_writable = (object_msv_writable_t *)malloc(sizeof(object_msv_writable_t));
+            msv_writable = (object_msv_writable_t *)object_alloc(OBJECT_MULTI_STATE_VALUE, sizeof(object_msv_writable_t));
             if (!msv_writable) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
             msv = msv_writable;
-            memset(msv_writable, 0, sizeof(*msv_writable));
             msv->present = 1;
             msv->base.base.type = msv_writable_type;
         } else if (commandable) {
@@ -233,13 +232,12 @@ int __attribute__((weak)) multistate_value_init(cJSON *object)
                 }
             }
 
-            msv_commandable = (object_msv_commandable_t *)malloc(sizeof(object_msv_commandable_t));
+            msv_commandable = (object_msv_commandable_t *)object_alloc(OBJECT_MULTI_STATE_VALUE, sizeof(object_msv_commandable_t));
             if (!msv_commandable) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
             msv = &msv_commandable->base;
-            memset(msv_commandable, 0, sizeof(*msv_commandable));
             msv_commandable->relinquish_default = relinquish_default;
             msv_commandable->active_bit = BACNET_MAX_PRIORITY;
             msv->present = relinquish_default;
@@ -253,12 +251,11 @@ int __attribute__((weak)) multistate_value_init(cJSON *object)
                 }
             }
 
-            msv = (object_msv_t *)malloc(sizeof(object_msv_t));
+            msv = (object_msv_t *)object_alloc(OBJECT_MULTI_STATE_VALUE, sizeof(object_msv_t));
             if (!msv) {
                 APP_ERROR("%s: not enough memory\r\n", __func__);
                 goto reclaim;
             }
-            memset(msv, 0, sizeof(*msv));
             msv->present = 1;
             msv->base.base.type = msv_type;
         }
@@ -267,15 +264,15 @@ int __attribute__((weak)) multistate_value_init(cJSON *object)
         msv->number_of_states = number_of_states;
         msv->base.Out_Of_Service = out_of_service;
 
-        if (!vbuf_fr_str(&msv->base.base.object_name.vbuf, name, OBJECT_NAME_MAX_LEN)) {
+        if (!object_set_name(&msv->base.base, name)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(msv);
+            object_free(&msv->base.base);
             goto reclaim;
         }
 
         if (!object_add(&msv->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
-            free(msv);
+            object_free(&msv->base.base);
             goto reclaim;
         }
         i++;
@@ -291,7 +288,7 @@ reclaim:
             APP_ERROR("%s: reclaim failed\r\n", __func__);
         } else {
             object_detach(msv_instance);
-            free(msv_instance);
+            object_free(msv_instance);
         }
     }
 
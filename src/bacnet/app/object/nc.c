@@ -0,0 +1,691 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * nc.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Notification Class Object
+ *
+ * History
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "bacnet/object/nc.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/apdu.h"
+#include "bacnet/tsm.h"
+#include "bacnet/addressbind.h"
+#include "bacnet/service/dcc.h"
+#include "bacnet/app.h"
+
+/* Size of the longest BACnetDestination encoding */
+#define NC_DESTINATION_MAX_LEN  (40)
+
+static int nc_read_notification_class(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_unsigned(rp_data->application_data, object->instance);
+}
+
+static int nc_read_priority(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_nc_t *nc;
+    uint8_t *pdu;
+    int len;
+    int i;
+
+    if (range != NULL) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+        return BACNET_STATUS_ERROR;
+    }
+
+    nc = container_of(object, object_nc_t, base);
+    pdu = rp_data->application_data;
+
+    if (rp_data->array_index == 0) {
+        return encode_application_unsigned(pdu, MAX_BACNET_EVENT_TRANSITION);
+    }
+
+    if (rp_data->array_index == BACNET_ARRAY_ALL) {
+        len = 0;
+        for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+            len += encode_application_unsigned(&pdu[len], nc->ucPriority[i]);
+        }
+        return len;
+    }
+
+    if (rp_data->array_index > MAX_BACNET_EVENT_TRANSITION) {
+        rp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_unsigned(pdu, nc->ucPriority[rp_data->array_index - 1]);
+}
+
+static int nc_read_ack_required(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    BACNET_BIT_STRING bit_string;
+    object_nc_t *nc;
+    uint8_t tmpbuf[1] = {0};
+    int i;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    nc = container_of(object, object_nc_t, base);
+
+    bitstring_init(&bit_string, tmpbuf, MAX_BACNET_EVENT_TRANSITION);
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        bitstring_set_bit(&bit_string, i, (nc->ucAckRequired & (1 << i)) != 0);
+    }
+
+    return encode_application_bitstring(rp_data->application_data, &bit_string);
+}
+
+static int nc_encode_destination(uint8_t *pdu, NC_DESTINATION *dest)
+{
+    BACNET_BIT_STRING bit_string;
+    uint8_t tmpbuf[1] = {0};
+    int len;
+    int i;
+
+    /* validDays */
+    bitstring_init(&bit_string, tmpbuf, 7);
+    for (i = 0; i < 7; i++) {
+        bitstring_set_bit(&bit_string, i, (dest->ucValidDays & (1 << i)) != 0);
+    }
+    len = encode_application_bitstring(pdu, &bit_string);
+
+    /* fromTime, toTime */
+    len += encode_application_time(&pdu[len], &dest->FromTime);
+    len += encode_application_time(&pdu[len], &dest->ToTime);
+
+    /* recipient */
+    if (dest->RecipientTag == RECIPIENT_TAG_DEVICE) {
+        len += encode_context_object_id(&pdu[len], RECIPIENT_TAG_DEVICE, OBJECT_DEVICE,
+            dest->ulDeviceId);
+    } else {
+        len += encode_opening_tag(&pdu[len], RECIPIENT_TAG_ADDRESS);
+        len += encode_application_unsigned(&pdu[len], dest->Address.net);
+        len += encode_application_raw_octet_string(&pdu[len], dest->Address.adr,
+            dest->Address.len);
+        len += encode_closing_tag(&pdu[len], RECIPIENT_TAG_ADDRESS);
+    }
+
+    /* processIdentifier */
+    len += encode_application_unsigned(&pdu[len], dest->ulProcessId);
+
+    /* issueConfirmedNotifications */
+    len += encode_application_boolean(&pdu[len], dest->bConfirmed);
+
+    /* transitions */
+    bitstring_init(&bit_string, tmpbuf, MAX_BACNET_EVENT_TRANSITION);
+    for (i = 0; i < MAX_BACNET_EVENT_TRANSITION; i++) {
+        bitstring_set_bit(&bit_string, i, (dest->ucTransitions & (1 << i)) != 0);
+    }
+    len += encode_application_bitstring(&pdu[len], &bit_string);
+
+    return len;
+}
+
+static int nc_read_recipient_list(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_nc_t *nc;
+    uint8_t *pdu;
+    uint32_t i;
+    int len;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    nc = container_of(object, object_nc_t, base);
+    pdu = rp_data->application_data;
+
+    len = 0;
+    for (i = 0; i < nc->ulRecipientCount; i++) {
+        if (len + NC_DESTINATION_MAX_LEN > rp_data->application_data_len) {
+            rp_data->abort_reason = ABORT_REASON_SEGMENTATION_NOT_SUPPORTED;
+            return BACNET_STATUS_ABORT;
+        }
+        len += nc_encode_destination(&pdu[len], &nc->Recipients[i]);
+    }
+
+    return len;
+}
+
+object_impl_t *object_create_impl_nc(void)
+{
+    object_impl_t *nc;
+    property_impl_t *p_impl;
+
+    nc = object_create_impl_base();
+    if (!nc) {
+        APP_ERROR("%s: create base impl failed\r\n", __func__);
+        return NULL;
+    }
+    nc->type = OBJECT_NOTIFICATION_CLASS;
+
+    p_impl = object_impl_extend(nc, PROP_NOTIFICATION_CLASS, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_NOTIFICATION_CLASS failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = nc_read_notification_class;
+
+    p_impl = object_impl_extend(nc, PROP_PRIORITY, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_PRIORITY failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = nc_read_priority;
+
+    p_impl = object_impl_extend(nc, PROP_ACK_REQUIRED, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_ACK_REQUIRED failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = nc_read_ack_required;
+
+    p_impl = object_impl_extend(nc, PROP_RECIPIENT_LIST, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_RECIPIENT_LIST failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = nc_read_recipient_list;
+
+    return nc;
+
+out:
+    object_impl_destroy(nc);
+
+    return NULL;
+}
+
+static object_nc_t *nc_find(uint32_t notification_class)
+{
+    object_instance_t *object;
+
+    if (notification_class >= BACNET_MAX_INSTANCE) {
+        return NULL;
+    }
+
+    object = object_find(OBJECT_NOTIFICATION_CLASS, notification_class);
+    if (object == NULL) {
+        return NULL;
+    }
+
+    return container_of(object, object_nc_t, base);
+}
+
+bool notification_class_get(uint32_t notification_class, BACNET_EVENT_TRANSITION_BITS transition,
+        uint8_t *priority, bool *ack_required)
+{
+    object_nc_t *nc;
+
+    nc = nc_find(notification_class);
+    if (nc == NULL) {
+        return false;
+    }
+
+    if (priority) {
+        *priority = nc->ucPriority[transition];
+    }
+
+    if (ack_required) {
+        *ack_required = (nc->ucAckRequired & (1 << transition)) != 0;
+    }
+
+    return true;
+}
+
+/* 00-63 life safety, 64-127 critical equipment, 128-191 urgent, 192-255 normal */
+static bacnet_prio_t nc_network_priority(uint8_t priority)
+{
+    if (priority < 64) {
+        return PRIORITY_LIFE_SAFETY;
+    } else if (priority < 128) {
+        return PRIORITY_CRITICAL_EQUIPMENT;
+    } else if (priority < 192) {
+        return PRIORITY_URGENT;
+    }
+
+    return PRIORITY_NORMAL;
+}
+
+static bool nc_destination_active(NC_DESTINATION *dest, struct tm *now)
+{
+    unsigned from, to, tod;
+    int wday;
+
+    /* tm_wday counts from Sunday, validDays from Monday */
+    wday = (now->tm_wday + 6) % 7;
+    if (!(dest->ucValidDays & (1 << wday))) {
+        return false;
+    }
+
+    from = dest->FromTime.hour * 3600 + dest->FromTime.min * 60 + dest->FromTime.sec;
+    to = dest->ToTime.hour * 3600 + dest->ToTime.min * 60 + dest->ToTime.sec;
+    tod = now->tm_hour * 3600 + now->tm_min * 60 + now->tm_sec;
+
+    return (tod >= from) && (tod <= to);
+}
+
+static void nc_event_ack_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu,
+                BACNET_PDU_TYPE apdu_type)
+{
+    if (invoker == NULL) {
+        APP_ERROR("%s: null invoker\r\n", __func__);
+        return;
+    }
+
+    if (apdu == NULL) {
+        APP_WARN("%s: no answer from net(%d)\r\n", __func__, invoker->addr.net);
+    } else if (apdu_type != PDU_TYPE_SIMPLE_ACK) {
+        APP_WARN("%s: refused by net(%d) with pdu type(%d)\r\n", __func__, invoker->addr.net,
+            apdu_type);
+    }
+
+    tsm_free_invokeID(invoker);
+}
+
+static int nc_send_confirmed(bacnet_addr_t *dst, BACNET_EVENT_NOTIFICATION_DATA *data,
+                bacnet_prio_t prio)
+{
+    DECLARE_BACNET_BUF(tx_apdu, MAX_APDU);
+    tsm_invoker_t *invoker;
+    int rv;
+
+    invoker = tsm_alloc_invokeID(dst, SERVICE_CONFIRMED_EVENT_NOTIFICATION, nc_event_ack_handler,
+        NULL);
+    if (invoker == NULL) {
+        APP_ERROR("%s: alloc invokeID failed\r\n", __func__);
+        return -EPERM;
+    }
+
+    (void)bacnet_buf_init(&tx_apdu.buf, MAX_APDU);
+    rv = cevent_notify_encode_apdu(&tx_apdu.buf, invoker->invokeID, data);
+    if (rv < 0) {
+        APP_ERROR("%s: encode apdu failed(%d)\r\n", __func__, rv);
+        tsm_free_invokeID(invoker);
+        return -EPERM;
+    }
+
+    rv = tsm_send_apdu(invoker, &tx_apdu.buf, prio, 0);
+    if (rv < 0) {
+        APP_ERROR("%s: tsm send failed(%d)\r\n", __func__, rv);
+        tsm_free_invokeID(invoker);
+    }
+
+    return rv;
+}
+
+int notification_class_send(BACNET_EVENT_NOTIFICATION_DATA *data,
+        BACNET_EVENT_TRANSITION_BITS transition)
+{
+    DECLARE_BACNET_BUF(tx_apdu, MAX_APDU);
+    object_nc_t *nc;
+    NC_DESTINATION *dest;
+    bacnet_addr_t dst;
+    bacnet_prio_t prio;
+    struct tm now;
+    time_t tNow;
+    uint32_t encoded_pid;
+    bool encoded;
+    uint32_t i;
+    int count;
+    int rv;
+
+    if (data == NULL) {
+        APP_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    nc = nc_find(data->notificationClass);
+    if (nc == NULL) {
+        APP_WARN("%s: Notification_Class(%d) not found\r\n", __func__, data->notificationClass);
+        return -EPERM;
+    }
+
+    if (!dcc_communication_enabled()) {
+        APP_VERBOS("%s: dcc communication disabled\r\n", __func__);
+        return 0;
+    }
+
+    tNow = time(NULL);
+    (void)localtime_r(&tNow, &now);
+    prio = nc_network_priority(data->priority);
+
+    /* the unconfirmed apdu is shared by recipients with the same process identifier */
+    encoded = false;
+    encoded_pid = 0;
+    count = 0;
+    for (i = 0; i < nc->ulRecipientCount; i++) {
+        dest = &nc->Recipients[i];
+        if (!(dest->ucTransitions & (1 << transition)) || !nc_destination_active(dest, &now)) {
+            continue;
+        }
+
+        if (dest->RecipientTag == RECIPIENT_TAG_DEVICE) {
+            if (!query_address_from_device(dest->ulDeviceId, NULL, &dst)) {
+                APP_WARN("%s: device(%d) not bound\r\n", __func__, dest->ulDeviceId);
+                continue;
+            }
+        } else {
+            dst = dest->Address;
+        }
+
+        data->processIdentifier = dest->ulProcessId;
+        if (dest->bConfirmed) {
+            rv = nc_send_confirmed(&dst, data, prio);
+        } else {
+            if (!encoded || (encoded_pid != dest->ulProcessId)) {
+                (void)bacnet_buf_init(&tx_apdu.buf, MAX_APDU);
+                rv = uevent_notify_encode_apdu(&tx_apdu.buf, data);
+                if (rv < 0) {
+                    APP_ERROR("%s: encode apdu failed(%d)\r\n", __func__, rv);
+                    return rv;
+                }
+                encoded = true;
+                encoded_pid = dest->ulProcessId;
+            }
+            rv = apdu_send(&dst, &tx_apdu.buf, prio, false);
+        }
+
+        if (rv >= 0) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static int nc_parse_time(cJSON *item, BACNET_TIME *btime)
+{
+    unsigned hour, min, sec;
+
+    if ((item == NULL) || (item->type != cJSON_String)) {
+        return -EINVAL;
+    }
+
+    if ((sscanf(item->valuestring, "%u:%u:%u", &hour, &min, &sec) != 3) || (hour > 23)
+            || (min > 59) || (sec > 59)) {
+        return -EINVAL;
+    }
+
+    datetime_set_time(btime, hour, min, sec, 0);
+
+    return OK;
+}
+
+static int nc_parse_bits(cJSON *array, int count, uint8_t *bits)
+{
+    cJSON *tmp;
+    int i;
+
+    if ((array == NULL) || (array->type != cJSON_Array) || (cJSON_GetArraySize(array) != count)) {
+        return -EINVAL;
+    }
+
+    *bits = 0;
+    i = 0;
+    cJSON_ArrayForEach(tmp, array) {
+        if ((tmp->type != cJSON_False) && (tmp->type != cJSON_True)) {
+            return -EINVAL;
+        }
+        if (tmp->type == cJSON_True) {
+            *bits |= 1 << i;
+        }
+        i++;
+    }
+
+    return OK;
+}
+
+static int nc_parse_destination(cJSON *item, NC_DESTINATION *dest)
+{
+    cJSON *tmp;
+
+    memset(dest, 0, sizeof(NC_DESTINATION));
+    dest->ucValidDays = 0x7F;
+    datetime_set_time(&dest->ToTime, 23, 59, 59, 99);
+    dest->ucTransitions = (1 << MAX_BACNET_EVENT_TRANSITION) - 1;
+
+    tmp = cJSON_GetObjectItem(item, "Device");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint < 0)
+                || (tmp->valueint >= BACNET_MAX_INSTANCE)) {
+            APP_ERROR("%s: invalid Device item\r\n", __func__);
+            return -EINVAL;
+        }
+        dest->RecipientTag = RECIPIENT_TAG_DEVICE;
+        dest->ulDeviceId = (uint32_t)tmp->valueint;
+    } else {
+        /* an address recipient is a broadcast on the given network, 0 for the local one */
+        tmp = cJSON_GetObjectItem(item, "Network");
+        if ((tmp == NULL) || (tmp->type != cJSON_Number) || (tmp->valueint < 0)
+                || (tmp->valueint > BACNET_BROADCAST_NETWORK)) {
+            APP_ERROR("%s: get Device or Network item failed\r\n", __func__);
+            return -EINVAL;
+        }
+        dest->RecipientTag = RECIPIENT_TAG_ADDRESS;
+        dest->Address.net = (uint16_t)tmp->valueint;
+        dest->Address.len = 0;
+    }
+
+    tmp = cJSON_GetObjectItem(item, "Process_Identifier");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valuedouble < 0)
+                || (tmp->valuedouble > 4294967295.0)) {
+            APP_ERROR("%s: invalid Process_Identifier item\r\n", __func__);
+            return -EINVAL;
+        }
+        dest->ulProcessId = (uint32_t)tmp->valuedouble;
+    }
+
+    tmp = cJSON_GetObjectItem(item, "Confirmed");
+    if (tmp) {
+        if ((tmp->type != cJSON_False) && (tmp->type != cJSON_True)) {
+            APP_ERROR("%s: Confirmed not boolean\r\n", __func__);
+            return -EINVAL;
+        }
+        dest->bConfirmed = (tmp->type == cJSON_True)? true: false;
+    }
+
+    if (dest->bConfirmed && (dest->RecipientTag != RECIPIENT_TAG_DEVICE)) {
+        APP_ERROR("%s: confirmed notifications need a Device recipient\r\n", __func__);
+        return -EINVAL;
+    }
+
+    tmp = cJSON_GetObjectItem(item, "Transitions");
+    if (tmp && (nc_parse_bits(tmp, MAX_BACNET_EVENT_TRANSITION, &dest->ucTransitions) < 0)) {
+        APP_ERROR("%s: invalid Transitions item\r\n", __func__);
+        return -EINVAL;
+    }
+
+    tmp = cJSON_GetObjectItem(item, "Valid_Days");
+    if (tmp && (nc_parse_bits(tmp, 7, &dest->ucValidDays) < 0)) {
+        APP_ERROR("%s: invalid Valid_Days item\r\n", __func__);
+        return -EINVAL;
+    }
+
+    tmp = cJSON_GetObjectItem(item, "From_Time");
+    if (tmp && (nc_parse_time(tmp, &dest->FromTime) < 0)) {
+        APP_ERROR("%s: invalid From_Time item\r\n", __func__);
+        return -EINVAL;
+    }
+
+    tmp = cJSON_GetObjectItem(item, "To_Time");
+    if (tmp && (nc_parse_time(tmp, &dest->ToTime) < 0)) {
+        APP_ERROR("%s: invalid To_Time item\r\n", __func__);
+        return -EINVAL;
+    }
+
+    return OK;
+}
+
+static void nc_destroy(object_nc_t *nc)
+{
+    free(nc->Recipients);
+    object_free(&nc->base);
+}
+
+int __attribute__((weak)) notification_class_init(cJSON *object)
+{
+    object_impl_t *nc_type = NULL;
+    object_instance_t *nc_instance;
+    object_nc_t *nc;
+    cJSON *array, *instance, *tmp, *item;
+    char *name;
+    uint32_t j;
+    int i, k;
+
+    if (object == NULL) {
+        goto end;
+    }
+
+    array = cJSON_GetObjectItem(object, "Instance_List");
+    if ((array == NULL) || (array->type != cJSON_Array)) {
+        APP_ERROR("%s: get Instance_List item failed\r\n", __func__);
+        goto out;
+    }
+
+    i = 0;
+    cJSON_ArrayForEach(instance, array) {
+        if (instance->type != cJSON_Object) {
+            APP_ERROR("%s: invalid Instance_List[%d] item type\r\n", __func__, i);
+            goto reclaim;
+        }
+
+        tmp = cJSON_GetObjectItem(instance, "Name");
+        if ((tmp == NULL) || (tmp->type != cJSON_String)) {
+            APP_ERROR("%s: get Instance_List[%d] Name item failed\r\n", __func__, i);
+            goto reclaim;
+        }
+        name = tmp->valuestring;
+
+        if (!nc_type) {
+            nc_type = object_create_impl_nc();
+            if (!nc_type) {
+                APP_ERROR("%s: create nc type impl failed\r\n", __func__);
+                goto reclaim;
+            }
+        }
+
+        nc = (object_nc_t *)object_alloc(OBJECT_NOTIFICATION_CLASS, sizeof(object_nc_t));
+        if (!nc) {
+            APP_ERROR("%s: not enough memory\r\n", __func__);
+            goto reclaim;
+        }
+        nc->base.instance = i;
+        nc->base.type = nc_type;
+
+        tmp = cJSON_GetObjectItem(instance, "Priority");
+        if ((tmp == NULL) || (tmp->type != cJSON_Array)
+                || (cJSON_GetArraySize(tmp) != MAX_BACNET_EVENT_TRANSITION)) {
+            APP_ERROR("%s: get Instance_List[%d] Priority item failed\r\n", __func__, i);
+            nc_destroy(nc);
+            goto reclaim;
+        }
+        k = 0;
+        cJSON_ArrayForEach(item, tmp) {
+            if ((item->type != cJSON_Number) || (item->valueint < 0) || (item->valueint > 255)) {
+                APP_ERROR("%s: invalid Instance_List[%d] Priority[%d]\r\n", __func__, i, k);
+                nc_destroy(nc);
+                goto reclaim;
+            }
+            nc->ucPriority[k++] = (uint8_t)item->valueint;
+        }
+
+        tmp = cJSON_GetObjectItem(instance, "Ack_Required");
+        if (tmp && (nc_parse_bits(tmp, MAX_BACNET_EVENT_TRANSITION, &nc->ucAckRequired) < 0)) {
+            APP_ERROR("%s: invalid Instance_List[%d] Ack_Required item\r\n", __func__, i);
+            nc_destroy(nc);
+            goto reclaim;
+        }
+
+        tmp = cJSON_GetObjectItem(instance, "Recipient_List");
+        if (tmp) {
+            if (tmp->type != cJSON_Array) {
+                APP_ERROR("%s: invalid Instance_List[%d] Recipient_List item\r\n", __func__, i);
+                nc_destroy(nc);
+                goto reclaim;
+            }
+            nc->ulRecipientCount = cJSON_GetArraySize(tmp);
+            if (nc->ulRecipientCount) {
+                nc->Recipients = (NC_DESTINATION *)malloc(sizeof(NC_DESTINATION)
+                    * nc->ulRecipientCount);
+                if (!nc->Recipients) {
+                    APP_ERROR("%s: not enough memory\r\n", __func__);
+                    nc_destroy(nc);
+                    goto reclaim;
+                }
+            }
+            j = 0;
+            cJSON_ArrayForEach(item, tmp) {
+                if ((item->type != cJSON_Object)
+                        || (nc_parse_destination(item, &nc->Recipients[j]) < 0)) {
+                    APP_ERROR("%s: invalid Instance_List[%d] Recipient_List[%d]\r\n", __func__, i,
+                        j);
+                    nc_destroy(nc);
+                    goto reclaim;
+                }
+                j++;
+            }
+        }
+
+        if (!object_set_name(&nc->base, name)) {
+            APP_ERROR("%s: set object name overflow\r\n", __func__);
+            nc_destroy(nc);
+            goto reclaim;
+        }
+
+        if (!object_add(&nc->base)) {
+            APP_ERROR("%s: object add failed\r\n", __func__);
+            nc_destroy(nc);
+            goto reclaim;
+        }
+        i++;
+    }
+
+end:
+    return OK;
+
+reclaim:
+    for (i = i - 1; i >= 0; i--) {
+        nc_instance = object_find(OBJECT_NOTIFICATION_CLASS, i);
+        if (!nc_instance) {
+            APP_ERROR("%s: reclaim failed\r\n", __func__);
+        } else {
+            object_detach(nc_instance);
+            nc_destroy(container_of(nc_instance, object_nc_t, base));
+        }
+    }
+
+    if (nc_type) {
+        object_impl_destroy(nc_type);
+    }
+
+out:
+
+    return -EPERM;
+}
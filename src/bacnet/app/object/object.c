@@ -12,6 +12,8 @@
 
 #include <stdlib.h>
 #include <errno.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "bacnet/object/object.h"
 #include "bacnet/object/device.h"
@@ -24,16 +26,81 @@
 #include "bacnet/object/msi.h"
 #include "bacnet/object/mso.h"
 #include "bacnet/object/msv.h"
+#include "bacnet/object/nc.h"
+#include "bacnet/object/intrinsic.h"
 #include "bacnet/object/trendlog.h"
+#include "bacnet/object/trendlog_multiple.h"
 #include "bacnet/bactext.h"
 #include "bacnet/config.h"
 #include "bacnet/app.h"
 #include "misc/hashtable.h"
+#include "misc/hash.h"
+#include "misc/rcu.h"
+#include "misc/slab.h"
 #include "bacnet/bacdcode.h"
 
-#define NAME_TABLE_BITS     (7)
+#define NAME_TABLE_MIN_BITS     (7)
+#define NAME_TABLE_MAX_BITS     (22)
 
-static DECLARE_HASHTABLE(name_table, NAME_TABLE_BITS);   /* name to instance */
+/* ְ8ֽڷּ, OBJECT_NAME_MAX_LEN */
+#define NAME_CLASS(len)         ((offsetof(object_name_t, vbuf.value) + (len) + 7) >> 3)
+#define NAME_CLASSES            (NAME_CLASS(OBJECT_NAME_MAX_LEN) + 1)
+
+/* ͬһͲͬСĶ, AVͨ/д/ */
+#define OBJECT_SLAB_VARIANTS    (4)
+
+#ifdef OBJECT_COMPACT_INDEX
+#define OBJECT_INDEX_COMPACT    (true)
+#else
+#define OBJECT_INDEX_COMPACT    (false)
+#endif
+
+#define OBJECT_LOCK_BITS        (6)
+#define OBJECT_LOCK_STRIPES     (1 << OBJECT_LOCK_BITS)
+
+/* ֹ۶Դ, дһֱռʱΪдȡ */
+#define OBJECT_READ_RETRY       (8)
+
+/* еһ, ֻ&vbuf; hashֱ, ؽʱ */
+typedef struct object_name_s {
+    uint32_t hash;
+    vbuf_t vbuf;
+} object_name_t;
+
+typedef struct object_slabs_s {
+    slab_t variants[OBJECT_SLAB_VARIANTS];
+    uint32_t count;
+} object_slabs_t;
+
+typedef struct object_type_index_s {
+    BACNET_OBJECT_TYPE type;
+    object_store_t *store;
+    uint32_t start;                         /* objectsеʼλ */
+    uint32_t count;
+} object_type_index_t;
+
+/*
+ * ֻ, Һͱ. дobject_db_lock޸
+ * rbtreename_table, ȻؽղRCU, ɿڿںͷ
+ */
+typedef struct object_index_s {
+    struct object_index_s *retired;         /* ͷŵľɿ */
+    uint32_t count;
+    uint32_t type_count;
+    uint32_t name_mask;
+    object_type_index_t *types;             /* type */
+    object_instance_t **objects;            /* (type, instance) */
+    object_instance_t **names;              /* Ѱַ */
+    uint32_t *name_keys;
+    size_t bytes;
+} object_index_t;
+
+/* name to instance, ̽ĿѰַ, Ψһͬʱڲ */
+static object_instance_t **name_table = NULL;
+
+static uint32_t name_table_bits;
+
+static uint32_t name_count;
 
 static uint8_t object_types_supported_bits[(MAX_ASHRAE_OBJECT_TYPE + 7) >> 3] = {0, };
 
@@ -41,6 +108,48 @@ static struct rb_root object_root = {.rb_node = NULL};
 
 static bool Object_Initialized = false;
 
+static object_index_t *object_index = NULL;
+
+/* ÿASHRAE͵Ķslab, רֱmalloc */
+static object_slabs_t *object_slabs[MAX_ASHRAE_OBJECT_TYPE];
+
+/* ж, NAME_CLASSּ */
+static slab_t name_slabs[NAME_CLASSES];
+
+/* ɾڽͷŵ, index_retiredһ_index_reclaimͷ */
+static object_name_t **name_retired = NULL;
+
+static uint32_t name_retired_count;
+
+static uint32_t name_retired_size;
+
+/* ѱ滻ľɿ, _index_reclaimȿںͷ */
+static object_index_t *index_retired = NULL;
+
+/* object_initڼ, ʱֻһ */
+static bool index_deferred = false;
+
+/* object_batch_begin/endǶײ, ڼӺ͸Ҳֻڽʱһ */
+static uint32_t index_batch = 0;
+
+/* rbtree(Ƴٷؽʧ), object_findΪ */
+static bool index_stale = false;
+
+/* лrbtreename_table޸ĺͿյķ */
+static pthread_mutex_t object_db_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_mutex_t object_locks[OBJECT_LOCK_STRIPES];
+
+static pthread_once_t object_locks_once = PTHREAD_ONCE_INIT;
+
+/* object_init׶κʱ(us) */
+static struct {
+    uint32_t device_us;
+    uint32_t total_us;
+    uint32_t type_us[MAX_ASHRAE_OBJECT_TYPE];
+    uint32_t type_entries[MAX_ASHRAE_OBJECT_TYPE];
+} init_stat;
+
 bool client_device = false;
 
 static BACNET_OBJECT_TYPE Object_Types_Supported[] = {
@@ -53,21 +162,33 @@ static BACNET_OBJECT_TYPE Object_Types_Supported[] = {
     OBJECT_DEVICE,
     OBJECT_MULTI_STATE_INPUT,
     OBJECT_MULTI_STATE_OUTPUT,
+    OBJECT_NOTIFICATION_CLASS,
     OBJECT_MULTI_STATE_VALUE,
-    OBJECT_TRENDLOG
+    OBJECT_TRENDLOG,
+    OBJECT_TREND_LOG_MULTIPLE
 };
 
-static int __string_hash(const char *str, uint32_t len)
+static uint64_t _init_now_us(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/* FNV-1a, ѭλۼӶ"AV_1234"ֻβֳֵͻ̫ */
+static uint32_t __string_hash(const char *str, uint32_t len)
 {
     const char *end;
-    int code;
+    uint32_t code;
     
-    code = 0;
+    code = 2166136261U;
     end = str + len;
-    do {
-        code = ROTATE_LEFT(code, 8);
-        code += (uint8_t)*str;
-    } while (++str < end);
+    while (str < end) {
+        code ^= (uint8_t)*str++;
+        code *= 16777619U;
+    }
 
     return code;
 }
@@ -92,8 +213,72 @@ static object_store_t *_find_store(BACNET_OBJECT_TYPE type)
     return NULL;
 }
 
+#ifdef OBJECT_COMPACT_INDEX
+/* һinstanceСڸֵλ */
+static uint32_t _store_lower_bound(object_store_t *store, uint32_t instance)
+{
+    uint32_t low, high, mid;
+
+    low = 0;
+    high = store->object_count;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (store->objects[mid]->instance < instance) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/* instance˳ʱֻ׷, 鰴 */
+static bool _store_insert(object_store_t *store, uint32_t pos, object_instance_t *object)
+{
+    object_instance_t **objects;
+    uint32_t capacity;
+
+    if (store->object_count == store->capacity) {
+        capacity = store->capacity? store->capacity * 2: 16;
+        objects = (object_instance_t **)realloc(store->objects,
+            sizeof(object_instance_t *) * capacity);
+        if (objects == NULL) {
+            APP_ERROR("%s: realloc %u objects failed\r\n", __func__, capacity);
+            return false;
+        }
+        store->objects = objects;
+        store->capacity = capacity;
+    }
+
+    memmove(&store->objects[pos + 1], &store->objects[pos],
+        sizeof(object_instance_t *) * (store->object_count - pos));
+    store->objects[pos] = object;
+    store->object_count++;
+
+    return true;
+}
+
+static void _store_remove(object_store_t *store, uint32_t pos)
+{
+    store->object_count--;
+    memmove(&store->objects[pos], &store->objects[pos + 1],
+        sizeof(object_instance_t *) * (store->object_count - pos));
+}
+#endif
+
 static object_instance_t *_find_instance(object_store_t *store, uint32_t instance)
 {
+#ifdef OBJECT_COMPACT_INDEX
+    uint32_t pos;
+
+    pos = _store_lower_bound(store, instance);
+    if ((pos < store->object_count) && (store->objects[pos]->instance == instance)) {
+        return store->objects[pos];
+    }
+
+    return NULL;
+#else
     struct rb_node *onode;
     object_instance_t *object;
 
@@ -110,15 +295,159 @@ static object_instance_t *_find_instance(object_store_t *store, uint32_t instanc
     }
     
     return NULL;
+#endif
+}
+
+static object_name_t *_name_of(const object_instance_t *object)
+{
+    return container_of(object->object_name, object_name_t, vbuf);
+}
+
+/* ֻдobject_db_lock·ͷ */
+static object_name_t *_name_alloc(const char *str, uint32_t len, uint32_t key)
+{
+    slab_t *slab;
+    object_name_t *name;
+
+    if (len > OBJECT_NAME_MAX_LEN) {
+        return NULL;
+    }
+
+    slab = &name_slabs[NAME_CLASS(len)];
+    if (slab->size == 0) {
+        slab_init(slab, NAME_CLASS(len) << 3);
+    }
+
+    name = (object_name_t *)slab_alloc(slab);
+    if (name == NULL) {
+        return NULL;
+    }
+
+    name->hash = key;
+    name->vbuf.length = len;
+    memcpy(name->vbuf.value, str, len);
+
+    return name;
 }
 
-static object_instance_t *_find_name(int key, const char *str, uint32_t len)
+static void _name_free(object_name_t *name)
+{
+    slab_free(&name_slabs[NAME_CLASS(name->vbuf.length)], name);
+}
+
+/* ߿ܻڶ, ҵname_retired_index_reclaimڿںͷ */
+static void _name_retire(object_name_t *name)
+{
+    object_name_t **retired;
+    uint32_t size;
+
+    if (name_retired_count == name_retired_size) {
+        size = name_retired_size? name_retired_size * 2: 16;
+        retired = (object_name_t **)realloc(name_retired, sizeof(object_name_t *) * size);
+        if (retired == NULL) {
+            APP_WARN("%s: realloc failed, name leaked\r\n", __func__);
+            return;
+        }
+        name_retired = retired;
+        name_retired_size = size;
+    }
+
+    name_retired[name_retired_count++] = name;
+}
+
+static void _name_link(object_instance_t **table, uint32_t bits, object_instance_t *object)
+{
+    uint32_t mask, pos;
+
+    mask = (1U << bits) - 1;
+    pos = _name_of(object)->hash & mask;
+    while (table[pos]) {
+        pos = (pos + 1) & mask;
+    }
+    table[pos] = object;
+}
+
+/* ̽Ļɾ, Ĺ */
+static void _name_unlink(object_instance_t *object)
+{
+    object_instance_t *obj;
+    uint32_t mask, pos, hole, home;
+
+    mask = (1U << name_table_bits) - 1;
+    pos = _name_of(object)->hash & mask;
+    while (name_table[pos] != object) {
+        if (name_table[pos] == NULL) {
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    hole = pos;
+    for (;;) {
+        pos = (pos + 1) & mask;
+        obj = name_table[pos];
+        if (obj == NULL) {
+            break;
+        }
+
+        /* ʼλò(hole, pos]֮ĲǰƵhole */
+        home = _name_of(obj)->hash & mask;
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            name_table[hole] = obj;
+            hole = pos;
+        }
+    }
+    name_table[hole] = NULL;
+}
+
+/*
+ * س1/2ʱ, ʱֲ˻ɨ.
+ * @return: falseʾ޷
+ */
+static bool _name_table_grow(void)
+{
+    object_instance_t **table;
+    uint32_t bits, i;
+
+    if ((name_count + 1) * 2 <= (1U << name_table_bits)) {
+        return true;
+    }
+
+    if (name_table_bits < NAME_TABLE_MAX_BITS) {
+        bits = name_table_bits + 1;
+        table = (object_instance_t **)calloc(1U << bits, sizeof(object_instance_t *));
+        if (table) {
+            for (i = 0; i < (1U << name_table_bits); i++) {
+                if (name_table[i]) {
+                    _name_link(table, bits, name_table[i]);
+                }
+            }
+            free(name_table);
+            name_table = table;
+            name_table_bits = bits;
+            return true;
+        }
+        APP_WARN("%s: malloc failed, keep %d bits\r\n", __func__, name_table_bits);
+    }
+
+    return (name_count + 1) * 4 <= (3U << name_table_bits);
+}
+
+static object_instance_t *_find_name(uint32_t key, const char *str, uint32_t len)
 {
     object_instance_t *object;
-    
-    hash_for_each_possible(name_table, object, node_name, key) {
-        if ((object->object_name.vbuf.length == len)
-                && (!memcmp(object->object_name.vbuf.value, str, len))) {
+    object_name_t *name;
+    uint32_t mask, pos;
+
+    if (name_table == NULL) {
+        return NULL;
+    }
+
+    mask = (1U << name_table_bits) - 1;
+    for (pos = key & mask; (object = name_table[pos]) != NULL; pos = (pos + 1) & mask) {
+        name = _name_of(object);
+        if ((name->hash == key) && (name->vbuf.length == len)
+                && (!memcmp(name->vbuf.value, str, len))) {
             return object;
         }
     }
@@ -126,32 +455,402 @@ static object_instance_t *_find_name(int key, const char *str, uint32_t len)
     return NULL;
 }
 
+static void _object_locks_init(void)
+{
+    pthread_mutexattr_t attr;
+    int i;
+
+    (void)pthread_mutexattr_init(&attr);
+    (void)pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    for (i = 0; i < OBJECT_LOCK_STRIPES; i++) {
+        (void)pthread_mutex_init(&object_locks[i], &attr);
+    }
+    (void)pthread_mutexattr_destroy(&attr);
+}
+
+static pthread_mutex_t *_object_lock(object_instance_t *object)
+{
+    return &object_locks[hash_ptr(object, OBJECT_LOCK_BITS)];
+}
+
+/* , ֻ㷭תseq */
+void object_write_lock(object_instance_t *object)
+{
+    (void)pthread_once(&object_locks_once, _object_locks_init);
+
+    pthread_mutex_lock(_object_lock(object));
+    if (object->write_nest++ == 0) {
+        __atomic_store_n(&object->seq, object->seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+}
+
+void object_write_unlock(object_instance_t *object)
+{
+    if (--object->write_nest == 0) {
+        __atomic_store_n(&object->seq, object->seq + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(_object_lock(object));
+}
+
+/* skip: ɾĶ, ¿; ΪNULLʱհrbtree */
+static object_index_t *_index_build(const object_instance_t *skip)
+{
+    struct rb_node *snode;
+#ifndef OBJECT_COMPACT_INDEX
+    struct rb_node *onode;
+#endif
+    object_store_t *store;
+    object_instance_t *object;
+    object_index_t *idx;
+    uint32_t count, type_count, size, n;
+    uint32_t key, pos, i;
+    size_t bytes;
+    uint8_t *mem;
+
+    count = 0;
+    type_count = 0;
+    for (snode = rb_first(&object_root); snode; snode = rb_next(snode)) {
+        store = rb_entry(snode, object_store_t, node);
+        n = store->object_count;
+        if (skip && (skip->type->type == store->object_type)) {
+            n--;
+        }
+        if (n) {
+            count += n;
+            type_count++;
+        }
+    }
+
+    size = 16;
+    while (size < count * 2) {
+        size <<= 1;
+    }
+
+    bytes = sizeof(object_index_t) + sizeof(object_type_index_t) * type_count
+        + sizeof(object_instance_t *) * (count + size) + sizeof(uint32_t) * size;
+    mem = (uint8_t *)malloc(bytes);
+    if (mem == NULL) {
+        APP_ERROR("%s: malloc failed\r\n", __func__);
+        return NULL;
+    }
+
+    idx = (object_index_t *)mem;
+    mem += sizeof(object_index_t);
+    idx->types = (object_type_index_t *)mem;
+    mem += sizeof(object_type_index_t) * type_count;
+    idx->objects = (object_instance_t **)mem;
+    mem += sizeof(object_instance_t *) * count;
+    idx->names = (object_instance_t **)mem;
+    mem += sizeof(object_instance_t *) * size;
+    idx->name_keys = (uint32_t *)mem;
+
+    idx->retired = NULL;
+    idx->count = 0;
+    idx->type_count = 0;
+    idx->name_mask = size - 1;
+    idx->bytes = bytes;
+    memset(idx->names, 0, sizeof(object_instance_t *) * size);
+
+    for (snode = rb_first(&object_root); snode; snode = rb_next(snode)) {
+        store = rb_entry(snode, object_store_t, node);
+        n = store->object_count;
+        if (skip && (skip->type->type == store->object_type)) {
+            n--;
+        }
+        if (n == 0) {
+            continue;
+        }
+        idx->types[idx->type_count].type = store->object_type;
+        idx->types[idx->type_count].store = store;
+        idx->types[idx->type_count].start = idx->count;
+        idx->types[idx->type_count].count = n;
+        idx->type_count++;
+
+        i = idx->count;
+#ifdef OBJECT_COMPACT_INDEX
+        if (n == store->object_count) {
+            memcpy(&idx->objects[i], store->objects, sizeof(object_instance_t *) * n);
+        } else {
+            for (pos = 0; pos < store->object_count; pos++) {
+                if (store->objects[pos] != skip) {
+                    idx->objects[i++] = store->objects[pos];
+                }
+            }
+        }
+#else
+        for (onode = rb_first(&store->instance_root); onode; onode = rb_next(onode)) {
+            object = rb_entry(onode, object_instance_t, node_type);
+            if (object != skip) {
+                idx->objects[i++] = object;
+            }
+        }
+#endif
+
+        for (i = idx->count; i < idx->count + n; i++) {
+            object = idx->objects[i];
+            key = _name_of(object)->hash;
+            pos = key & idx->name_mask;
+            while (idx->names[pos]) {
+                pos = (pos + 1) & idx->name_mask;
+            }
+            idx->names[pos] = object;
+            idx->name_keys[pos] = key;
+        }
+        idx->count += n;
+    }
+
+    return idx;
+}
+
+static void _index_free_retired(object_index_t *idx)
+{
+    object_index_t *next;
+
+    while (idx) {
+        next = idx->retired;
+        free(idx);
+        idx = next;
+    }
+}
+
+/*
+ * ¿, ߳object_db_lock. ɿչҵindex_retired,
+ * ɵ߽_index_reclaimͷ
+ */
+static void _index_commit(object_index_t *idx)
+{
+    object_index_t *old;
+
+    old = object_index;
+    rcu_assign_pointer(object_index, idx);
+    __atomic_store_n(&index_stale, false, __ATOMIC_RELEASE);
+    if (old) {
+        old->retired = index_retired;
+        index_retired = old;
+    }
+}
+
+/*
+ * ȿںͷ滻Ŀպ, ߲ܳobject_db_lock:
+ * ڶڿҪȡ(locked_readֹ۶ʧܡչڵobject_find),
+ * ȴ뿪ụ. ڶ(дʱ)ܵȴ, һ.
+ * wait: ûдͷŵҲһ, object_detachȷ϶뿪
+ */
+static void _index_reclaim(bool wait)
+{
+    object_index_t *idx;
+    object_name_t **names;
+    uint32_t count, i;
+
+    if (rcu_read_ongoing()) {
+        if (wait) {
+            synchronize_rcu();
+        }
+        return;
+    }
+
+    /* ֻȡߴǰ۵, ֮۵Ŀܻûȵ */
+    pthread_mutex_lock(&object_db_lock);
+    idx = index_retired;
+    index_retired = NULL;
+    names = name_retired;
+    count = name_retired_count;
+    name_retired = NULL;
+    name_retired_count = 0;
+    name_retired_size = 0;
+    pthread_mutex_unlock(&object_db_lock);
+
+    if (wait || idx || count) {
+        synchronize_rcu();
+    }
+
+    _index_free_retired(idx);
+    if (count) {
+        pthread_mutex_lock(&object_db_lock);
+        for (i = 0; i < count; i++) {
+            _name_free(names[i]);
+        }
+        pthread_mutex_unlock(&object_db_lock);
+    }
+    free(names);
+}
+
+/*
+ * rbtreeؽ, ߳object_db_lock. ʼ޸ڼ
+ * ֻǿչ. ؽʧʱ߼þɿ, falseɵ߻ع
+ */
+static bool _index_publish(void)
+{
+    object_index_t *idx;
+
+    if (index_deferred || index_batch) {
+        __atomic_store_n(&index_stale, true, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    idx = _index_build(NULL);
+    if (idx == NULL) {
+        APP_ERROR("%s: build object index failed, readers keep the old one\r\n", __func__);
+        __atomic_store_n(&index_stale, true, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    _index_commit(idx);
+
+    return true;
+}
+
+static object_type_index_t *_index_find_type(object_index_t *idx, BACNET_OBJECT_TYPE type)
+{
+    uint32_t low, high, mid;
+
+    low = 0;
+    high = idx->type_count;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (idx->types[mid].type < type) {
+            low = mid + 1;
+        } else if (idx->types[mid].type > type) {
+            high = mid;
+        } else {
+            return &idx->types[mid];
+        }
+    }
+
+    return NULL;
+}
+
+/* һ(type, instance)ڸֵλ */
+static uint32_t _index_upper_bound(object_index_t *idx, BACNET_OBJECT_TYPE type,
+                    uint32_t instance)
+{
+    object_instance_t *object;
+    uint32_t low, high, mid;
+
+    low = 0;
+    high = idx->count;
+    while (low < high) {
+        mid = (low + high) / 2;
+        object = idx->objects[mid];
+        if ((object->type->type < type)
+                || ((object->type->type == type) && (object->instance <= instance))) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static object_instance_t *_index_find(object_index_t *idx, BACNET_OBJECT_TYPE type,
+                            uint32_t instance)
+{
+    object_type_index_t *tidx;
+    object_instance_t *object;
+    uint32_t low, high, mid;
+
+    if (idx == NULL) {
+        return NULL;
+    }
+
+    tidx = _index_find_type(idx, type);
+    if (tidx == NULL) {
+        return NULL;
+    }
+
+    low = tidx->start;
+    high = tidx->start + tidx->count;
+    while (low < high) {
+        mid = (low + high) / 2;
+        object = idx->objects[mid];
+        if (object->instance < instance) {
+            low = mid + 1;
+        } else if (object->instance > instance) {
+            high = mid;
+        } else {
+            return object;
+        }
+    }
+
+    return NULL;
+}
+
+/* ֻڿںͷ, ֱӱȽ, Ҫseq */
+static bool _name_equal(object_instance_t *object, const char *str, uint32_t len)
+{
+    const vbuf_t *name;
+
+    name = __atomic_load_n(&object->object_name, __ATOMIC_ACQUIRE);
+
+    return (name->length == len) && !memcmp(name->value, str, len);
+}
+
+static object_instance_t *_index_find_name(object_index_t *idx, uint32_t key, const char *str,
+                            uint32_t len)
+{
+    object_instance_t *object;
+    uint32_t pos;
+
+    if (idx == NULL) {
+        return NULL;
+    }
+
+    pos = key & idx->name_mask;
+    while ((object = idx->names[pos]) != NULL) {
+        if ((idx->name_keys[pos] == key) && _name_equal(object, str, len)) {
+            return object;
+        }
+        pos = (pos + 1) & idx->name_mask;
+    }
+
+    return NULL;
+}
+
+/*
+ * صĶobject_detach֮ǰһֱЧ. û˳object_db_lockȿ,
+ * ڶҲȡ
+ */
 object_instance_t *object_find(BACNET_OBJECT_TYPE type, uint32_t instance)
 {
     object_store_t *store;
+    object_instance_t *object;
     
     if (((uint32_t)type >= MAX_BACNET_OBJECT_TYPE) || (instance >= BACNET_MAX_INSTANCE)) {
         APP_ERROR("%s: invalid argument, type(%d), instance(%d)\r\n", __func__, type, instance);
         return NULL;
     }
 
-    store = _find_store(type);
-    if (store) {
-        return _find_instance(store, instance);
+    /* object_init޸ڼؽʧܺ, ֱӲ */
+    if (__atomic_load_n(&index_stale, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&object_db_lock);
+        store = _find_store(type);
+        object = store? _find_instance(store, instance): NULL;
+        pthread_mutex_unlock(&object_db_lock);
+        return object;
     }
 
-    return NULL;
+    rcu_read_lock();
+    object = _index_find(rcu_dereference(object_index), type, instance);
+    rcu_read_unlock();
+
+    return object;
 }
 
-bool object_add(object_instance_t *object)
+static bool _object_add(object_instance_t *object)
 {
     struct rb_node **pps, *ps;
+#ifdef OBJECT_COMPACT_INDEX
+    uint32_t pos;
+#else
     struct rb_node **ppo, *po;
-    object_store_t *store;
     object_instance_t *obj;
+#endif
+    object_store_t *store;
+    object_instance_t *found;
     BACNET_OBJECT_TYPE type;
     uint32_t instance;
-    int key;
 
     if (!object) {
         APP_ERROR("%s: null argument\r\n", __func__);
@@ -167,6 +866,10 @@ bool object_add(object_instance_t *object)
         APP_ERROR("%s: invalid type without property supported\r\n", __func__);
         return false;
     }
+    if (!object->object_name) {
+        APP_ERROR("%s: object name not set\r\n", __func__);
+        return false;
+    }
 
     type = object->type->type;
     instance = object->instance;
@@ -179,19 +882,30 @@ bool object_add(object_instance_t *object)
         return false;
     }
 
-    if (hash_hashed(&object->node_name)) {
-        APP_ERROR("%s: duplicated add object?\r\n", __func__);
+    if (name_table == NULL) {
+        APP_ERROR("%s: object name hash table not initialized\r\n", __func__);
+        return false;
+    }
+
+    found = _find_name(_name_of(object)->hash, (const char *)object->object_name->value,
+        object->object_name->length);
+    if (found) {
+        if (found == object) {
+            APP_ERROR("%s: duplicated add object?\r\n", __func__);
+        } else {
+            APP_ERROR("%s: duplicated name\r\n", __func__);
+        }
         return false;
     }
 
-    key = __string_hash((char*)object->object_name.vbuf.value,
-            object->object_name.vbuf.length);
-    if (_find_name(key, (char*)object->object_name.vbuf.value,
-            object->object_name.vbuf.length)) {
-        APP_ERROR("%s: duplicated name\r\n", __func__);
+    if (!_name_table_grow()) {
+        APP_ERROR("%s: object name table full\r\n", __func__);
         return false;
     }
 
+    object->seq = 0;
+    object->write_nest = 0;
+
     pps = &object_root.rb_node;
     ps = NULL;
     while (*pps) {
@@ -202,6 +916,17 @@ bool object_add(object_instance_t *object)
         } else if (type > store->object_type) {
             pps = &ps->rb_right;
         } else {
+#ifdef OBJECT_COMPACT_INDEX
+            pos = _store_lower_bound(store, instance);
+            if ((pos < store->object_count) && (store->objects[pos]->instance == instance)) {
+                APP_ERROR("%s: duplicated instance(%d)\r\n", __func__, instance);
+                return false;
+            }
+
+            if (!_store_insert(store, pos, object)) {
+                return false;
+            }
+#else
             ppo = &store->instance_root.rb_node;
             po = NULL;
             while (*ppo) {
@@ -220,6 +945,7 @@ bool object_add(object_instance_t *object)
             store->object_count++;
             rb_link_node(&object->node_type, po, ppo);
             rb_insert_color(&object->node_type, &store->instance_root);
+#endif
             goto end;
         }
     }
@@ -230,44 +956,364 @@ bool object_add(object_instance_t *object)
         return false;
     }
     
+#ifdef OBJECT_COMPACT_INDEX
+    store->objects = NULL;
+    store->capacity = 0;
+    store->object_count = 0;
+    if (!_store_insert(store, 0, object)) {
+        free(store);
+        return false;
+    }
+#else
+    store->instance_root = RB_ROOT;
     rb_link_node(&object->node_type, NULL, &store->instance_root.rb_node);
     rb_insert_color(&object->node_type, &store->instance_root);
     store->object_count = 1;
+#endif
     store->object_type = type;
     rb_link_node(&store->node, ps, pps);
     rb_insert_color(&store->node, &object_root);
     
 end:
-    hash_add(name_table, &object->node_name, key);
+    _name_link(name_table, name_table_bits, object);
+    name_count++;
     
     return true;
 }
 
-void object_detach(object_instance_t *object)
+static bool _object_linked(object_instance_t *object)
 {
     object_store_t *store;
-    
+
+    store = _find_store(object->type->type);
+
+    return store && (_find_instance(store, object->instance) == object);
+}
+
+/* rbtreename_tableժ, ֵͷɵ߾ */
+static void _object_unlink(object_instance_t *object)
+{
+    object_store_t *store;
+#ifdef OBJECT_COMPACT_INDEX
+    uint32_t pos;
+#endif
+
+    store = _find_store(object->type->type);
+
+#ifdef OBJECT_COMPACT_INDEX
+    pos = _store_lower_bound(store, object->instance);
+    _store_remove(store, pos);
+    if (!store->object_count) {
+        rb_erase(&store->node, &object_root);
+        free(store->objects);
+        store->objects = NULL;
+        store->capacity = 0;
+    }
+#else
+    rb_erase(&object->node_type, &store->instance_root);
+    if (!--store->object_count) {
+        rb_erase(&store->node, &object_root);
+    }
+#endif
+    _name_unlink(object);
+    name_count--;
+}
+
+bool object_add(object_instance_t *object)
+{
+    bool rv;
+
+    pthread_mutex_lock(&object_db_lock);
+
+    rv = _object_add(object);
+    if (rv && !_index_publish()) {
+        /* δ, ûж߼ö, ֱӳ */
+        _object_unlink(object);
+        rv = false;
+    }
+
+    pthread_mutex_unlock(&object_db_lock);
+
+    _index_reclaim(false);
+
+    return rv;
+}
+
+/*
+ * trueʱû̵߳Ķøö, ߿object_freeͷ.
+ * ȽòöĿժ, ʱԭڿ, false.
+ * ޸ڼҲ(֮ͬǰƳٵ޸), ޷ȴ뿪
+ */
+bool object_detach(object_instance_t *object)
+{
+    object_index_t *idx;
+
     if (!object) {
         APP_ERROR("%s: null argument\r\n", __func__);
-        return;
+        return false;
+    }
+
+    pthread_mutex_lock(&object_db_lock);
+
+    if (!_object_linked(object)) {
+        pthread_mutex_unlock(&object_db_lock);
+        APP_ERROR("%s: object already detached?\r\n", __func__);
+        return false;
+    }
+
+    /* object_initڼ仹ûз, ؽ */
+    idx = NULL;
+    if (!index_deferred) {
+        idx = _index_build(object);
+        if (idx == NULL) {
+            pthread_mutex_unlock(&object_db_lock);
+            APP_ERROR("%s: build object index failed\r\n", __func__);
+            return false;
+        }
+    }
+
+    _object_unlink(object);
+    _name_retire(_name_of(object));
+    if (idx) {
+        _index_commit(idx);
+    }
+
+    pthread_mutex_unlock(&object_db_lock);
+
+    _index_reclaim(true);
+    /* ѽname_retired */
+    object->object_name = NULL;
+
+    return true;
+}
+
+void object_batch_begin(void)
+{
+    pthread_mutex_lock(&object_db_lock);
+    index_batch++;
+    pthread_mutex_unlock(&object_db_lock);
+}
+
+bool object_batch_end(void)
+{
+    bool rv;
+
+    rv = true;
+
+    pthread_mutex_lock(&object_db_lock);
+
+    if (index_batch == 0) {
+        pthread_mutex_unlock(&object_db_lock);
+        APP_ERROR("%s: not in batch\r\n", __func__);
+        return false;
+    }
+
+    if ((--index_batch == 0) && index_stale && !index_deferred) {
+        rv = _index_publish();
+    }
+
+    pthread_mutex_unlock(&object_db_lock);
+
+    _index_reclaim(false);
+
+    return rv;
+}
+
+static slab_t *_slab_find(BACNET_OBJECT_TYPE type, size_t size, bool create)
+{
+    object_slabs_t *slabs;
+    size_t rounded;
+    uint32_t i;
+
+    if ((uint32_t)type >= MAX_ASHRAE_OBJECT_TYPE) {
+        return NULL;
+    }
+
+    slabs = object_slabs[type];
+    if (slabs == NULL) {
+        if (!create) {
+            return NULL;
+        }
+        slabs = (object_slabs_t *)calloc(1, sizeof(object_slabs_t));
+        if (slabs == NULL) {
+            return NULL;
+        }
+        object_slabs[type] = slabs;
+    }
+
+    rounded = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    for (i = 0; i < slabs->count; i++) {
+        if (slabs->variants[i].size == rounded) {
+            return &slabs->variants[i];
+        }
+    }
+
+    if (!create || (slabs->count == OBJECT_SLAB_VARIANTS)) {
+        return NULL;
+    }
+
+    slab_init(&slabs->variants[slabs->count], size);
+
+    return &slabs->variants[slabs->count++];
+}
+
+/* ڵslab, ǴslabķNULL */
+static slab_t *_slab_owner(BACNET_OBJECT_TYPE type, object_instance_t *object)
+{
+    object_slabs_t *slabs;
+    uint32_t i;
+
+    slabs = object_slabs[type];
+    for (i = 0; slabs && (i < slabs->count); i++) {
+        if (slab_owns(&slabs->variants[i], object)) {
+            return &slabs->variants[i];
+        }
+    }
+
+    return NULL;
+}
+
+static slab_t *_object_slab(object_instance_t *object)
+{
+    slab_t *slab;
+    int type;
+
+    if (object->type) {
+        if ((uint32_t)object->type->type >= MAX_ASHRAE_OBJECT_TYPE) {
+            return NULL;
+        }
+        return _slab_owner(object->type->type, object);
+    }
+
+    /* ʼ;ʧܵĶܻûtype */
+    for (type = 0; type < MAX_ASHRAE_OBJECT_TYPE; type++) {
+        slab = _slab_owner((BACNET_OBJECT_TYPE)type, object);
+        if (slab) {
+            return slab;
+        }
+    }
+
+    return NULL;
+}
+
+void *object_alloc(BACNET_OBJECT_TYPE type, size_t size)
+{
+    slab_t *slab;
+    void *object;
+
+    if (size < sizeof(object_instance_t)) {
+        APP_ERROR("%s: invalid size(%u)\r\n", __func__, (uint32_t)size);
+        return NULL;
+    }
+
+    object = NULL;
+
+    pthread_mutex_lock(&object_db_lock);
+    slab = _slab_find(type, size, true);
+    if (slab) {
+        object = slab_alloc(slab);
+    }
+    pthread_mutex_unlock(&object_db_lock);
+
+    /* רͻ */
+    if (slab == NULL) {
+        object = calloc(1, size);
+    }
+
+    return object;
+}
+
+void object_free(object_instance_t *object)
+{
+    slab_t *slab;
+
+    if (object == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&object_db_lock);
+
+    /* detachĶѽname_retired, ֵǴδ */
+    if (object->object_name) {
+        if (_find_name(_name_of(object)->hash, (const char *)object->object_name->value,
+                object->object_name->length) == object) {
+            pthread_mutex_unlock(&object_db_lock);
+            APP_ERROR("%s: object still in database\r\n", __func__);
+            return;
+        }
+        _name_free(_name_of(object));
+        object->object_name = NULL;
+    }
+
+    slab = _object_slab(object);
+    if (slab) {
+        slab_free(slab, object);
+    }
+
+    pthread_mutex_unlock(&object_db_lock);
+
+    if (slab == NULL) {
+        free(object);
+    }
+}
+
+int object_reserve(BACNET_OBJECT_TYPE type, size_t size, uint32_t count)
+{
+    slab_t *slab;
+    int rv;
+
+    rv = OK;
+
+    pthread_mutex_lock(&object_db_lock);
+    slab = _slab_find(type, size, true);
+    if (slab) {
+        rv = slab_reserve(slab, count);
+    }
+    pthread_mutex_unlock(&object_db_lock);
+
+    if (rv < 0) {
+        APP_ERROR("%s: reserve %u objects of type(%d) failed(%d)\r\n", __func__, count, type, rv);
+    }
+
+    return rv;
+}
+
+bool object_set_name(object_instance_t *object, const char *name)
+{
+    object_name_t *entry;
+    uint32_t len;
+
+    if (!object || !name) {
+        APP_ERROR("%s: null argument\r\n", __func__);
+        return false;
     }
 
-    if (!hash_hashed(&object->node_name)) {
-        APP_ERROR("%s: object already detached?\r\n", __func__);
-        return;
+    len = strlen(name);
+    if (len > OBJECT_NAME_MAX_LEN) {
+        return false;
     }
 
-    store = _find_store(object->type->type);
-    if (!store) {
-        APP_ERROR("%s: store not found\r\n", __func__);
-        return;
+    pthread_mutex_lock(&object_db_lock);
+
+    if (object->object_name) {
+        if (_find_name(_name_of(object)->hash, (const char *)object->object_name->value,
+                object->object_name->length) == object) {
+            pthread_mutex_unlock(&object_db_lock);
+            APP_ERROR("%s: object already added, use object_rename\r\n", __func__);
+            return false;
+        }
+        _name_free(_name_of(object));
+        object->object_name = NULL;
     }
 
-    rb_erase(&object->node_type, &store->instance_root);
-    hash_del(&object->node_name);
-    if (!--store->object_count) {
-        rb_erase(&store->node, &object_root);
+    entry = _name_alloc(name, len, __string_hash(name, len));
+    if (entry) {
+        object->object_name = &entry->vbuf;
     }
+
+    pthread_mutex_unlock(&object_db_lock);
+
+    return entry != NULL;
 }
 
 const property_impl_t *object_impl_find_property(const object_impl_t *type,
@@ -331,6 +1377,7 @@ object_impl_t *object_impl_clone(const object_impl_t *type)
     memset(newtype, 0, sizeof(object_impl_t));
 
     newtype->type = type->type;
+    newtype->locked_read = type->locked_read;
     newtype->property_required_count = type->property_required_count;
     newtype->property_optional_count = type->property_optional_count;
     newtype->property_proprietary_count = type->property_proprietary_count;
@@ -604,18 +1651,21 @@ static int base_read_object_id(object_instance_t *object, BACNET_READ_PROPERTY_D
 static int base_read_object_name(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
             RR_RANGE *range)
 {
+    const vbuf_t *name;
+
     if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
         rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
         return BACNET_STATUS_ERROR;
     }
-    
-    if (object->object_name.vbuf.length >= rp_data->application_data_len) {
+
+    name = __atomic_load_n(&object->object_name, __ATOMIC_ACQUIRE);
+    if (name->length >= rp_data->application_data_len) {
         rp_data->abort_reason = ABORT_REASON_SEGMENTATION_NOT_SUPPORTED;
         return BACNET_STATUS_ABORT;
     }
     
     return encode_application_ansi_character_string(rp_data->application_data,
-            (char *)object->object_name.vbuf.value, object->object_name.vbuf.length);
+            (char *)name->value, name->length);
 }
 
 object_impl_t *object_create_impl_base(void)
@@ -749,6 +1799,7 @@ static int seor_write_out_of_service(object_instance_t *object, BACNET_WRITE_PRO
             seor_obj->notify(seor_obj);
         }
     }
+    intrinsic_report_refresh(seor_obj);
     
     return 0;
 }
@@ -796,6 +1847,7 @@ static int seor_write_reliability(object_instance_t *object, BACNET_WRITE_PROPER
     }
 
     seor_obj->Reliability = value;
+    intrinsic_report_refresh(seor_obj);
     
     return 0;
 }
@@ -902,54 +1954,54 @@ bool object_get_types_supported(BACNET_BIT_STRING *types)
 
 uint32_t object_list_count(void)
 {
-    struct rb_node *node;
-    object_store_t *store;
+    object_index_t *idx;
     uint32_t count;
 
-    count = 0;
-    for (node = rb_first(&object_root); node; node = rb_next(node)) {
-        store = rb_entry(node, object_store_t, node);
-        count += store->object_count;
-    }
+    rcu_read_lock();
+    idx = rcu_dereference(object_index);
+    count = idx? idx->count: 0;
+    rcu_read_unlock();
 
     return count;
 }
 
+/*
+ * ڵߵĶڵõһµĿ, read_property;
+ * ڶÿεøʹõʱĿ
+ */
 bool object_find_index(uint32_t index, object_store_t **store, object_instance_t **object)
 {
-    struct rb_node *snode, *onode;
-    object_store_t *ss;
-    
-    for (snode = rb_first(&object_root); snode; snode = rb_next(snode)) {
-        ss = rb_entry(snode, object_store_t, node);
-        if (ss->object_count <= index) {
-            index -= ss->object_count;
-            continue;
-        }
+    object_index_t *idx;
+    object_instance_t *obj;
+    bool found;
 
-        for (onode = rb_first(&ss->instance_root); onode; onode = rb_next(onode)) {
-            if (!index) {
-                if (store) {
-                    *store = ss;
-                }
-                if (object) {
-                    *object = rb_entry(onode, object_instance_t, node_type);
-                }
-                return true;
-            }
-            index--;
+    found = false;
+
+    rcu_read_lock();
+
+    idx = rcu_dereference(object_index);
+    if (idx && (index < idx->count)) {
+        obj = idx->objects[index];
+        if (store) {
+            *store = _index_find_type(idx, obj->type->type)->store;
         }
-        
-        APP_ERROR("%s: instance count not correct\r\n", __func__);
-        break;
+        if (object) {
+            *object = obj;
+        }
+        found = true;
     }
 
-    return false;
+    rcu_read_unlock();
+
+    return found;
 }
 
 bool object_find_next(object_store_t **store, object_instance_t **object)
 {
-    struct rb_node *snode, *onode;
+    object_index_t *idx;
+    object_instance_t *obj;
+    uint32_t pos;
+    bool found;
     
     if (store == NULL || *store == NULL) {
         APP_ERROR("%s: store or store pointing to is null\r\n", __func__);
@@ -961,80 +2013,109 @@ bool object_find_next(object_store_t **store, object_instance_t **object)
         return false;
     }
 
-    snode = &(*store)->node;
-    onode = rb_next(&(*object)->node_type);
-    while (!onode) {
-        snode = rb_next(snode);
-        if (!snode) {
-            return false;
+    found = false;
+
+    rcu_read_lock();
+
+    idx = rcu_dereference(object_index);
+    if (idx) {
+        pos = _index_upper_bound(idx, (*object)->type->type, (*object)->instance);
+        if (pos < idx->count) {
+            obj = idx->objects[pos];
+            *store = _index_find_type(idx, obj->type->type)->store;
+            *object = obj;
+            found = true;
         }
-        onode = rb_first(&rb_entry(snode, object_store_t, node)->instance_root);
     }
 
-    *store = rb_entry(snode, object_store_t, node);
-    *object = rb_entry(onode, object_instance_t, node_type);
+    rcu_read_unlock();
     
-    return true;
+    return found;
 }
 
 bool object_type_find_object_index(BACNET_OBJECT_TYPE type, uint32_t index,
         object_instance_t **object)
 {
-    object_store_t *store;
+    object_index_t *idx;
+    object_type_index_t *tidx;
+    bool found;
 
     if (((uint32_t)type >= MAX_BACNET_OBJECT_TYPE)) {
         APP_ERROR("%s: invalid object type(%d)\r\n", __func__, type);
         return NULL;
     }
 
-    store = _find_store(type);
-    if (!store) {
-        return false;
-    }
+    found = false;
 
-    for (struct rb_node *onode = rb_first(&store->instance_root);
-            onode; onode = rb_next(onode)) {
-        if (!index) {
-            if (object) {
-                *object = rb_entry(onode, object_instance_t, node_type);
-            }
-            return true;
+    rcu_read_lock();
+
+    idx = rcu_dereference(object_index);
+    tidx = idx? _index_find_type(idx, type): NULL;
+    if (tidx && (index < tidx->count)) {
+        if (object) {
+            *object = idx->objects[tidx->start + index];
         }
-        index--;
+        found = true;
     }
 
-    return false;
+    rcu_read_unlock();
+
+    return found;
 }
 
 bool object_type_find_object_next(object_instance_t **object)
 {
-    struct rb_node *onode;
+    object_index_t *idx;
+    object_instance_t *obj;
+    uint32_t pos;
+    bool found;
     
     if (object == NULL || *object == NULL) {
         APP_ERROR("%s: object or object pointing to is null\r\n", __func__);
         return false;
     }
 
-    onode = rb_next(&(*object)->node_type);
-    if (onode) {
-        *object = rb_entry(onode, object_instance_t, node_type);
-        return true;
+    found = false;
+
+    rcu_read_lock();
+
+    idx = rcu_dereference(object_index);
+    if (idx) {
+        pos = _index_upper_bound(idx, (*object)->type->type, (*object)->instance);
+        if (pos < idx->count) {
+            obj = idx->objects[pos];
+            if (obj->type->type == (*object)->type->type) {
+                *object = obj;
+                found = true;
+            }
+        }
     }
 
-    return false;
+    rcu_read_unlock();
+
+    return found;
 }
 
 bool object_get_name(BACNET_OBJECT_TYPE type, uint32_t instance, BACNET_CHARACTER_STRING *name)
 {
     object_instance_t *object;
+    const vbuf_t *object_name;
+    bool rv;
+
+    rcu_read_lock();
 
-    object = object_find(type, instance);
+    object = _index_find(rcu_dereference(object_index), type, instance);
     if (!object) {
+        rcu_read_unlock();
         return false;
     }
-    
-    return characterstring_init_ansi(name, (char *)object->object_name.vbuf.value,
-            object->object_name.vbuf.length);
+
+    object_name = __atomic_load_n(&object->object_name, __ATOMIC_ACQUIRE);
+    rv = characterstring_init_ansi(name, (char *)object_name->value, object_name->length);
+
+    rcu_read_unlock();
+
+    return rv;
 }
 
 /** 
@@ -1050,7 +2131,7 @@ bool object_find_name(BACNET_CHARACTER_STRING *object_name, BACNET_OBJECT_TYPE *
         uint32_t *object_instance)
 {
     object_instance_t *object;
-    int key;
+    uint32_t key;
     
     if (!object_name) {
         APP_ERROR("%s: null object_name\r\n", __func__);
@@ -1070,7 +2151,10 @@ bool object_find_name(BACNET_CHARACTER_STRING *object_name, BACNET_OBJECT_TYPE *
     }
 
     key = __string_hash(object_name->value, object_name->length);
-    object = _find_name(key, object_name->value, object_name->length);
+
+    rcu_read_lock();
+    object = _index_find_name(rcu_dereference(object_index), key, object_name->value,
+        object_name->length);
     if (object) {
         if (object_type) {
             *object_type = object->type->type;
@@ -1078,17 +2162,18 @@ bool object_find_name(BACNET_CHARACTER_STRING *object_name, BACNET_OBJECT_TYPE *
         if (object_instance) {
             *object_instance = object->instance;
         }
-        
-        return true;
     }
+    rcu_read_unlock();
 
-    return false;
+    return object != NULL;
 }
 
 BACNET_ERROR_CODE object_rename(object_instance_t *object, BACNET_CHARACTER_STRING *new_name)
 {
     object_instance_t *found;
-    int key;
+    object_name_t *name, *old;
+    uint32_t key;
+    bool nested;
 
     if (!object || !new_name) {
         APP_ERROR("%s: null argument\r\n", __func__);
@@ -1118,17 +2203,55 @@ BACNET_ERROR_CODE object_rename(object_instance_t *object, BACNET_CHARACTER_STRI
     }
 
     key = __string_hash(new_name->value, new_name->length);
+
+    /* write_propertyļ˳һ: ȶ, object_db_lock */
+    object_write_lock(object);
+    pthread_mutex_lock(&object_db_lock);
+
     found = _find_name(key, new_name->value, new_name->length);
+    if (found) {
+        pthread_mutex_unlock(&object_db_lock);
+        object_write_unlock(object);
+        return (found == object)? MAX_BACNET_ERROR_CODE: ERROR_CODE_DUPLICATE_NAME;
+    }
+
+    name = _name_alloc(new_name->value, new_name->length, key);
+    if (name == NULL) {
+        pthread_mutex_unlock(&object_db_lock);
+        object_write_unlock(object);
+        APP_ERROR("%s: alloc name failed\r\n", __func__);
+        return ERROR_CODE_OTHER;
+    }
 
-    if (found == object) {
-        return MAX_BACNET_ERROR_CODE;
-    } else if (found) {
-        return ERROR_CODE_DUPLICATE_NAME;
+    /* ѳиö(дObject_Nameʱ), ȿ */
+    nested = (object->write_nest > 1);
+
+    /* ֿܻж, 滻ȿͷ */
+    old = _name_of(object);
+    _name_unlink(object);
+    __atomic_store_n(&object->object_name, &name->vbuf, __ATOMIC_RELEASE);
+    _name_link(name_table, name_table_bits, object);
+    if (!_index_publish()) {
+        /* ֿѱ߿, ؾֺͬȿͷ */
+        _name_unlink(object);
+        __atomic_store_n(&object->object_name, &old->vbuf, __ATOMIC_RELEASE);
+        _name_link(name_table, name_table_bits, object);
+        _name_retire(name);
+        pthread_mutex_unlock(&object_db_lock);
+        object_write_unlock(object);
+        if (!nested) {
+            _index_reclaim(false);
+        }
+        return ERROR_CODE_OTHER;
     }
+    _name_retire(old);
 
-    hash_del(&object->node_name);
-    vbuf_fr_buf(&object->object_name.vbuf, (uint8_t*)new_name->value, new_name->length);
-    hash_add(name_table, &object->node_name, key);
+    pthread_mutex_unlock(&object_db_lock);
+    object_write_unlock(object);
+
+    if (!nested) {
+        _index_reclaim(false);
+    }
 
     device_database_revision_increasee();
     
@@ -1153,6 +2276,7 @@ bool object_property_lists(BACNET_OBJECT_TYPE object_type, uint32_t instance,
         return false;
     }
 
+    /* ͵Աڶڼ䲻 */
     object = object_find(object_type, instance);
     if (!object) {
         return false;
@@ -1361,12 +2485,49 @@ static int _read_property_list(const object_impl_t *type, BACNET_READ_PROPERTY_D
     return encode_application_enumerated(pdu, type->property_proprietary[idx]);
 }
 
+/*
+ * Ȱseqֹ۶, ڼдض; locked_readͻдһֱռʱ
+ * Ӷдȡ
+ */
+static int _read_object_property(object_instance_t *object, const property_impl_t *impl,
+                BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    uint32_t seq;
+    int len;
+    int i;
+
+    if (!object->type->locked_read) {
+        for (i = 0; i < OBJECT_READ_RETRY; i++) {
+            seq = object_read_begin(object);
+            if (seq & 1) {
+                continue;
+            }
+
+            rp_data->error_class = ERROR_CLASS_PROPERTY;
+            rp_data->error_code = ERROR_CODE_OTHER;
+            len = impl->read_property(object, rp_data, range);
+            if (!object_read_retry(object, seq)) {
+                return len;
+            }
+        }
+    }
+
+    object_write_lock(object);
+    rp_data->error_class = ERROR_CLASS_PROPERTY;
+    rp_data->error_code = ERROR_CODE_OTHER;
+    len = impl->read_property(object, rp_data, range);
+    object_write_unlock(object);
+
+    return len;
+}
+
 /* ȡֵ洢rp_data->application_dataָĻ棬رֵı볤 */
 int object_read_property(BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
 {
-    object_store_t *store;
+    object_index_t *idx;
     object_instance_t *object;
     const property_impl_t *impl;
+    int len;
     
     if (rp_data == NULL) {
         APP_ERROR("%s: null rp_data\r\n", __func__);
@@ -1378,24 +2539,29 @@ int object_read_property(BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
         return BACNET_STATUS_ERROR;
     }
 
-    store = _find_store(rp_data->object_type);
-    if (!store) {
+    len = BACNET_STATUS_ERROR;
+
+    rcu_read_lock();
+
+    idx = rcu_dereference(object_index);
+    if (!idx || !_index_find_type(idx, rp_data->object_type)) {
         APP_ERROR("%s: find object_type(%d) failed\r\n", __func__, rp_data->object_type);
         rp_data->error_class = ERROR_CLASS_OBJECT;
         rp_data->error_code = ERROR_CODE_UNSUPPORTED_OBJECT_TYPE;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
-    object = _find_instance(store, rp_data->object_instance);
+    object = _index_find(idx, rp_data->object_type, rp_data->object_instance);
     if (!object) {
         APP_ERROR("%s: find object_instance(%d) failed\r\n", __func__, rp_data->object_instance);
         rp_data->error_class = ERROR_CLASS_OBJECT;
         rp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
     if (rp_data->property_id == PROP_PROPERTY_LIST) {
-        return _read_property_list(object->type, rp_data, range);
+        len = _read_property_list(object->type, rp_data, range);
+        goto out;
     }
 
     impl = object_impl_find_property(object->type, rp_data->property_id);
@@ -1403,26 +2569,29 @@ int object_read_property(BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
         APP_ERROR("%s: find property(%d) failed\r\n", __func__, rp_data->property_id);
         rp_data->error_class = ERROR_CLASS_PROPERTY;
         rp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
     if (!impl->read_property) {
         APP_ERROR("%s: no read property function\r\n", __func__);
         rp_data->error_class = ERROR_CLASS_PROPERTY;
         rp_data->error_code = ERROR_CODE_READ_ACCESS_DENIED;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
-    rp_data->error_class = ERROR_CLASS_PROPERTY;
-    rp_data->error_code = ERROR_CODE_OTHER;
+    len = _read_object_property(object, impl, rp_data, range);
+
+out:
+    rcu_read_unlock();
     
-    return impl->read_property(object, rp_data, range);
+    return len;
 }
 
 int object_write_property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
-    object_store_t *store;
+    object_index_t *idx;
     object_instance_t *object;
     const property_impl_t *impl;
+    int rv;
     
     if (wp_data == NULL) {
         APP_ERROR("%s: null wp_data\r\n", __func__);
@@ -1433,51 +2602,67 @@ int object_write_property(BACNET_WRITE_PROPERTY_DATA *wp_data)
         APP_ERROR("%s: Object is not inited\r\n", __func__);
         return BACNET_STATUS_ERROR;
     }
+
+    rv = BACNET_STATUS_ERROR;
+
+    rcu_read_lock();
     
-    store = _find_store(wp_data->object_type);
-    if (!store) {
+    idx = rcu_dereference(object_index);
+    if (!idx || !_index_find_type(idx, wp_data->object_type)) {
         wp_data->error_class = ERROR_CLASS_OBJECT;
         wp_data->error_code = ERROR_CODE_UNSUPPORTED_OBJECT_TYPE;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
-    object = _find_instance(store, wp_data->object_instance);
+    object = _index_find(idx, wp_data->object_type, wp_data->object_instance);
     if (!object) {
         wp_data->error_class = ERROR_CLASS_OBJECT;
         wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
     if (wp_data->property_id == PROP_PROPERTY_LIST) {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
         wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
     impl = object_impl_find_property(object->type, wp_data->property_id);
     if (!impl) {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
         wp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
     if (!impl->write_property) {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
         wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
-        return BACNET_STATUS_ERROR;
+        goto out;
     }
 
     wp_data->error_class = ERROR_CLASS_PROPERTY;
     wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+
+    object_write_lock(object);
+    rv = impl->write_property(object, wp_data);
+    object_write_unlock(object);
+
+out:
+    rcu_read_unlock();
+
+    /* ڶֻ˾ɿպ;, ˶ͷ */
+    if ((rv >= 0) && (wp_data->property_id == PROP_OBJECT_NAME)) {
+        _index_reclaim(false);
+    }
     
-    return impl->write_property(object, wp_data);
+    return rv;
 }
 
 cJSON *object_get_object_list(void)
 {
-    struct rb_node *snode, *onode;
-    object_store_t *store;
+    object_index_t *idx;
     object_instance_t *object;
     cJSON *result, *array, *tmp;
+    uint32_t i;
     
     result = cJSON_CreateObject();
     if (result == NULL) {
@@ -1500,25 +2685,28 @@ cJSON *object_get_object_list(void)
         return result;
     }
     
-    for (snode = rb_first(&object_root); snode; snode = rb_next(snode)) {
-        store = rb_entry(snode, object_store_t, node);
-        for (onode = rb_first(&store->instance_root); onode; onode = rb_next(onode)) {
-            object = rb_entry(onode, object_instance_t, node_type);
-            tmp = cJSON_CreateObject();
-            if (tmp == NULL) {
-                APP_ERROR("%s: create object failed\r\n", __func__);
-                cJSON_Delete(array);
-                cJSON_AddNumberToObject(result, "error_code", -1);
-                cJSON_AddStringToObject(result, "reason", "create object failed");
-                return result;
-            }
+    rcu_read_lock();
 
-            cJSON_AddItemToArray(array, tmp);
-            cJSON_AddNumberToObject(tmp, "object_type", object->type->type);
-            cJSON_AddNumberToObject(tmp, "object_instance", object->instance);
+    idx = rcu_dereference(object_index);
+    for (i = 0; idx && (i < idx->count); i++) {
+        object = idx->objects[i];
+        tmp = cJSON_CreateObject();
+        if (tmp == NULL) {
+            rcu_read_unlock();
+            APP_ERROR("%s: create object failed\r\n", __func__);
+            cJSON_Delete(array);
+            cJSON_AddNumberToObject(result, "error_code", -1);
+            cJSON_AddStringToObject(result, "reason", "create object failed");
+            return result;
         }
+
+        cJSON_AddItemToArray(array, tmp);
+        cJSON_AddNumberToObject(tmp, "object_type", object->type->type);
+        cJSON_AddNumberToObject(tmp, "object_instance", object->instance);
     }
 
+    rcu_read_unlock();
+
     cJSON_AddItemToObject(result, "result", array);
     
     return result;    
@@ -1716,6 +2904,10 @@ static object_init_handler Object_Get_Handlers(BACNET_OBJECT_TYPE object_type)
         handler = multistate_output_init;
         break;
 
+    case OBJECT_NOTIFICATION_CLASS:
+        handler = notification_class_init;
+        break;
+
     case OBJECT_MULTI_STATE_VALUE:
         handler = multistate_value_init;
         break;
@@ -1724,6 +2916,10 @@ static object_init_handler Object_Get_Handlers(BACNET_OBJECT_TYPE object_type)
         handler = trend_log_init;
         break;
 
+    case OBJECT_TREND_LOG_MULTIPLE:
+        handler = trend_log_multiple_init;
+        break;
+
     default:
         APP_ERROR("%s: unknown Object Type(%d)\r\n", __func__, object_type);
         break;
@@ -1732,10 +2928,25 @@ static object_init_handler Object_Get_Handlers(BACNET_OBJECT_TYPE object_type)
     return handler;
 }
 
+static bool _index_resume(void)
+{
+    bool rv;
+
+    pthread_mutex_lock(&object_db_lock);
+    index_deferred = false;
+    rv = _index_publish();
+    pthread_mutex_unlock(&object_db_lock);
+
+    _index_reclaim(false);
+
+    return rv;
+}
+
 int object_init(cJSON *app)
 {
     cJSON *object_array, *object, *tmp;
     object_init_handler handler;
+    uint64_t start, phase;
     int object_type;
     int i;
     int rv;
@@ -1749,7 +2960,22 @@ int object_init(cJSON *app)
         return OK;
     }
 
-    hash_init(name_table);
+    memset(&init_stat, 0, sizeof(init_stat));
+    start = _init_now_us();
+
+    /* ʼڼӶ, ȫɺһԷ */
+    index_deferred = true;
+    index_stale = true;
+
+    name_table_bits = NAME_TABLE_MIN_BITS;
+    name_count = 0;
+    name_table = (object_instance_t **)calloc(1U << name_table_bits, sizeof(object_instance_t *));
+    if (name_table == NULL) {
+        APP_ERROR("%s: malloc name table failed\r\n", __func__);
+        index_deferred = false;
+        index_stale = false;
+        return -ENOMEM;
+    }
 
     rv = Object_Types_Supported_Init();
     if (rv < 0) {
@@ -1768,6 +2994,9 @@ int object_init(cJSON *app)
 
     if (client_device == true) {
         APP_WARN("%s: This Device is used to be Client Device\r\n", __func__);
+        if (!_index_resume()) {
+            goto out1;
+        }
         Object_Initialized = true;
         return OK;
     }
@@ -1779,11 +3008,13 @@ int object_init(cJSON *app)
         goto out1;
     }
 
+    phase = _init_now_us();
     rv = handler(app);
     if (rv < 0) {
         APP_ERROR("%s: Device Object Init failed(%d)\r\n", __func__, rv);
         goto out1;
     }
+    init_stat.device_us = _init_now_us() - phase;
 
     Object_Initialized = true;
     
@@ -1828,43 +3059,290 @@ int object_init(cJSON *app)
             goto out2;
         }
 
+        phase = _init_now_us();
         rv = handler(object);
         if (rv < 0) {
             APP_ERROR("%s: Object %s Init failed(%d)\r\n", __func__, tmp->valuestring, rv);
             goto out2;
         }
+        init_stat.type_us[object_type] += _init_now_us() - phase;
+        init_stat.type_entries[object_type]++;
         i++;
     }
 
-    APP_VERBOS("%s: OK\r\n", __func__);
+    if (!_index_resume()) {
+        APP_ERROR("%s: publish object index failed\r\n", __func__);
+        goto out2;
+    }
+
+    init_stat.total_us = _init_now_us() - start;
+
+    APP_VERBOS("%s: %u objects in %u us, device %u us, name table %u buckets\r\n", __func__,
+        name_count, init_stat.total_us, init_stat.device_us, 1U << name_table_bits);
+    for (object_type = 0; object_type < MAX_ASHRAE_OBJECT_TYPE; object_type++) {
+        if (init_stat.type_entries[object_type]) {
+            APP_VERBOS("%s: %s %u us\r\n", __func__, bactext_object_type_name(object_type),
+                init_stat.type_us[object_type]);
+        }
+    }
+    
     return OK;
 
 out2:
     object_exit();
     
 out1:
+    free(name_table);
+    name_table = NULL;
+    index_deferred = false;
+    index_stale = false;
 
     return -EPERM;
 }
 
+cJSON *object_get_init_status(void)
+{
+    cJSON *status, *types, *item;
+    object_index_t *idx;
+    object_type_index_t *tidx;
+    int type;
+
+    status = cJSON_CreateObject();
+    if (status == NULL) {
+        APP_ERROR("%s: create status object failed\r\n", __func__);
+        return NULL;
+    }
+
+    cJSON_AddNumberToObject(status, "total_us", init_stat.total_us);
+    cJSON_AddNumberToObject(status, "device_us", init_stat.device_us);
+    cJSON_AddNumberToObject(status, "objects", name_count);
+    cJSON_AddNumberToObject(status, "name_buckets", name_table? (1U << name_table_bits): 0);
+
+    types = cJSON_CreateArray();
+    if (types == NULL) {
+        APP_ERROR("%s: create types array failed\r\n", __func__);
+        cJSON_Delete(status);
+        return NULL;
+    }
+    cJSON_AddItemToObject(status, "types", types);
+
+    rcu_read_lock();
+    idx = rcu_dereference(object_index);
+
+    for (type = 0; type < MAX_ASHRAE_OBJECT_TYPE; type++) {
+        if (!init_stat.type_entries[type]) {
+            continue;
+        }
+
+        item = cJSON_CreateObject();
+        if (item == NULL) {
+            APP_ERROR("%s: create type item failed\r\n", __func__);
+            break;
+        }
+        tidx = idx? _index_find_type(idx, (BACNET_OBJECT_TYPE)type): NULL;
+        cJSON_AddStringToObject(item, "type", bactext_object_type_name(type));
+        cJSON_AddNumberToObject(item, "objects", tidx? tidx->count: 0);
+        cJSON_AddNumberToObject(item, "us", init_stat.type_us[type]);
+        cJSON_AddItemToArray(types, item);
+    }
+
+    rcu_read_unlock();
+
+    return status;
+}
+
+/*
+ * {"compact_index", "objects", "total_bytes", "name_arena_bytes", "name_table_bytes",
+ *  "snapshot_bytes", "types": [{"type", "objects", "variants", "slab_bytes", "slab_used",
+ *  "slab_free", "chunks", "name_bytes", "index_bytes"}, ...]}
+ */
+cJSON *object_get_memory_status(void)
+{
+    cJSON *status, *types, *item;
+    object_index_t *idx;
+    object_type_index_t *tidx;
+    object_slabs_t *slabs;
+    object_instance_t *object;
+    size_t slab_bytes, name_bytes, index_bytes, arena_bytes, total;
+    uint32_t slab_used, slab_total, chunks, i;
+    int type;
+
+    status = cJSON_CreateObject();
+    if (status == NULL) {
+        APP_ERROR("%s: create status object failed\r\n", __func__);
+        return NULL;
+    }
+
+    types = cJSON_CreateArray();
+    if (types == NULL) {
+        APP_ERROR("%s: create types array failed\r\n", __func__);
+        cJSON_Delete(status);
+        return NULL;
+    }
+
+    total = 0;
+
+    /* պslabֻobject_db_lock滻޸, ڼֱӷ */
+    pthread_mutex_lock(&object_db_lock);
+
+    idx = object_index;
+    for (type = 0; type < MAX_ASHRAE_OBJECT_TYPE; type++) {
+        slabs = object_slabs[type];
+        tidx = idx? _index_find_type(idx, (BACNET_OBJECT_TYPE)type): NULL;
+        if (!slabs && !tidx) {
+            continue;
+        }
+
+        item = cJSON_CreateObject();
+        if (item == NULL) {
+            APP_ERROR("%s: create type item failed\r\n", __func__);
+            break;
+        }
+
+        slab_bytes = 0;
+        slab_used = 0;
+        slab_total = 0;
+        chunks = 0;
+        for (i = 0; slabs && (i < slabs->count); i++) {
+            slab_bytes += slabs->variants[i].bytes;
+            slab_used += slabs->variants[i].used;
+            slab_total += slabs->variants[i].total;
+            chunks += slabs->variants[i].chunks;
+        }
+
+        name_bytes = 0;
+        index_bytes = 0;
+        if (tidx) {
+            for (i = 0; i < tidx->count; i++) {
+                object = idx->objects[tidx->start + i];
+                name_bytes += NAME_CLASS(object->object_name->length) << 3;
+            }
+            index_bytes = sizeof(object_store_t);
+#ifdef OBJECT_COMPACT_INDEX
+            index_bytes += sizeof(object_instance_t *) * tidx->store->capacity;
+#endif
+        }
+
+        cJSON_AddStringToObject(item, "type", bactext_object_type_name(type));
+        cJSON_AddNumberToObject(item, "objects", tidx? tidx->count: 0);
+        cJSON_AddNumberToObject(item, "variants", slabs? slabs->count: 0);
+        cJSON_AddNumberToObject(item, "slab_bytes", slab_bytes);
+        cJSON_AddNumberToObject(item, "slab_used", slab_used);
+        cJSON_AddNumberToObject(item, "slab_free", slab_total - slab_used);
+        cJSON_AddNumberToObject(item, "chunks", chunks);
+        cJSON_AddNumberToObject(item, "name_bytes", name_bytes);
+        cJSON_AddNumberToObject(item, "index_bytes", index_bytes);
+        cJSON_AddItemToArray(types, item);
+
+        total += slab_bytes + index_bytes;
+    }
+
+    arena_bytes = 0;
+    for (type = 0; type < NAME_CLASSES; type++) {
+        arena_bytes += name_slabs[type].bytes;
+    }
+
+    cJSON_AddBoolToObject(status, "compact_index", OBJECT_INDEX_COMPACT);
+    cJSON_AddNumberToObject(status, "objects", name_count);
+    cJSON_AddNumberToObject(status, "name_arena_bytes", arena_bytes);
+    cJSON_AddNumberToObject(status, "name_table_bytes",
+        name_table? (sizeof(object_instance_t *) << name_table_bits): 0);
+    cJSON_AddNumberToObject(status, "snapshot_bytes", idx? idx->bytes: 0);
+
+    total += arena_bytes + (name_table? (sizeof(object_instance_t *) << name_table_bits): 0)
+        + (idx? idx->bytes: 0);
+
+    pthread_mutex_unlock(&object_db_lock);
+
+    cJSON_AddNumberToObject(status, "total_bytes", total);
+    cJSON_AddItemToObject(status, "types", types);
+
+    return status;
+}
+
 void object_exit(void)
 {
     object_store_t *store, *store_tmp;
-    object_instance_t *object, *object_tmp;
+    object_instance_t *object;
+#ifdef OBJECT_COMPACT_INDEX
+    uint32_t i;
+#else
+    object_instance_t *object_tmp;
+#endif
+    object_index_t *idx;
+    int type, variant;
 
     if (Object_Initialized == false) {
         return;
     }
 
+    intrinsic_reporting_exit();
+
+    pthread_mutex_lock(&object_db_lock);
+    idx = object_index;
+    rcu_assign_pointer(object_index, NULL);
+    pthread_mutex_unlock(&object_db_lock);
+
+    synchronize_rcu();
+
+    if (idx) {
+        idx->retired = index_retired;
+    } else {
+        idx = index_retired;
+    }
+    _index_free_retired(idx);
+    index_retired = NULL;
+    index_deferred = false;
+    index_batch = 0;
+    index_stale = false;
+
+    /* slabеĶslabͷ, Լmalloc */
     rbtree_postorder_for_each_entry_safe(store, store_tmp, &object_root, node) {
+#ifdef OBJECT_COMPACT_INDEX
+        for (i = 0; i < store->object_count; i++) {
+            object = store->objects[i];
+            if (!_object_slab(object)) {
+                free(object);
+            }
+        }
+        free(store->objects);
+#else
         rbtree_postorder_for_each_entry_safe(object, object_tmp, &store->instance_root, node_type) {
-            free(object);
+            if (!_object_slab(object)) {
+                free(object);
+            }
         }
+#endif
         free(store);
     }
 
     object_root = RB_ROOT;
 
+    for (type = 0; type < MAX_ASHRAE_OBJECT_TYPE; type++) {
+        if (object_slabs[type] == NULL) {
+            continue;
+        }
+        for (variant = 0; variant < object_slabs[type]->count; variant++) {
+            slab_destroy(&object_slabs[type]->variants[variant]);
+        }
+        free(object_slabs[type]);
+        object_slabs[type] = NULL;
+    }
+
+    /* δùslabûгʼ */
+    for (type = 0; type < NAME_CLASSES; type++) {
+        if (name_slabs[type].size) {
+            slab_destroy(&name_slabs[type]);
+        }
+    }
+    free(name_retired);
+    name_retired = NULL;
+    name_retired_count = 0;
+    name_retired_size = 0;
+
+    free(name_table);
+    name_table = NULL;
+    name_count = 0;
+
     Object_Initialized = false;
 }
-
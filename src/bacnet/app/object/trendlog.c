@@ -138,8 +138,7 @@ static void Trend_Log_Insert_Status_Rec(object_tl_t *TL, BACNET_LOG_STATUS eStat
     }
 }
 
-/* Convert a BACnet time into a local time in seconds since the local epoch  */
-static time_t Trend_Log_BAC_Time_To_Local(BACNET_DATE_TIME *SourceTime)
+time_t Trend_Log_BAC_Time_To_Local(BACNET_DATE_TIME *SourceTime)
 {
     struct tm LocalTime;
     int iTemp;
@@ -163,6 +162,9 @@ static time_t Trend_Log_BAC_Time_To_Local(BACNET_DATE_TIME *SourceTime)
     LocalTime.tm_min = SourceTime->time.min;
     LocalTime.tm_sec = SourceTime->time.sec;
 
+    /* Let mktime work out daylight saving, the stack garbage could move the time an hour */
+    LocalTime.tm_isdst = -1;
+
     return mktime(&LocalTime);
 }
 
@@ -802,6 +804,7 @@ object_impl_t *object_create_impl_tl(void)
         return NULL;
     }
     tl->type = OBJECT_TRENDLOG;
+    tl->locked_read = true;
 
     p_impl = object_impl_extend(tl, PROP_ENABLE, PROPERTY_TYPE_REQUIRED);
     if (!p_impl) {
@@ -942,6 +945,11 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         goto out;
     }
 
+    if (object_reserve(OBJECT_TRENDLOG, sizeof(object_tl_t), cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
     i = 0;
     cJSON_ArrayForEach(instance, array) {
         if (instance->type != cJSON_Object) {
@@ -949,30 +957,29 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
             goto reclaim;
         }
 
-        tl = (object_tl_t *)malloc(sizeof(object_tl_t));
+        tl = (object_tl_t *)object_alloc(OBJECT_TRENDLOG, sizeof(object_tl_t));
         if (!tl) {
             APP_ERROR("%s: not enough memory\r\n", __func__);
             goto reclaim;
         }
-        memset(tl, 0, sizeof(*tl));
         tl->base.base.instance = i;
 
         tmp = cJSON_GetObjectItem(instance, "Name");
         if ((tmp == NULL) || (tmp->type != cJSON_String)) {
             APP_ERROR("%s: get Instance_List[%d] Name item failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
-        if (!vbuf_fr_str(&tl->base.base.object_name.vbuf, tmp->valuestring, OBJECT_NAME_MAX_LEN)) {
+        if (!object_set_name(&tl->base.base, tmp->valuestring)) {
             APP_ERROR("%s: set object name overflow\r\n", __func__);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         
         tmp = cJSON_GetObjectItem(instance, "Logged_DeviceID");
         if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
             APP_ERROR("%s: get Instance_List[%d] Logged_DeviceID item failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         tl->Source.deviceIndentifier.type = OBJECT_DEVICE;
@@ -981,7 +988,7 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         tmp = cJSON_GetObjectItem(instance, "Logged_ObjectType");
         if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
             APP_ERROR("%s: get Instance_List[%d] Logged_ObjectType item failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         tl->Source.objectIdentifier.type = tmp->valueint;
@@ -989,7 +996,7 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         tmp = cJSON_GetObjectItem(instance, "Logged_ObjectInstance");
         if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
             APP_ERROR("%s: get Instance_List[%d] Logged_ObjectInstance item failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         tl->Source.objectIdentifier.instance = (uint32_t)tmp->valueint;
@@ -997,7 +1004,7 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         tmp = cJSON_GetObjectItem(instance, "Logged_PropertyID");
         if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
             APP_ERROR("%s: get Instance_List[%d] Logged_PropertyID item failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         tl->Source.propertyIdentifier = tmp->valueint;
@@ -1005,7 +1012,7 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         tmp = cJSON_GetObjectItem(instance, "Logged_PropertyIndex");
         if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
             APP_ERROR("%s: get Instance_List[%d] Logged_PropertyIndex item failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         
@@ -1027,7 +1034,7 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         tl->Logs = (TL_DATA_REC *)malloc(sizeof(TL_DATA_REC) * TL_MAX_ENTRIES);
         if (tl->Logs == NULL) {
             APP_ERROR("%s: malloc Instance_List[%d] Logs failed\r\n", __func__, i);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         (void)memset(tl->Logs, 0, sizeof(TL_DATA_REC) * TL_MAX_ENTRIES);
@@ -1091,7 +1098,7 @@ int __attribute__((weak)) trend_log_init(cJSON *object)
         if (!object_add(&tl->base.base)) {
             APP_ERROR("%s: object add failed\r\n", __func__);
             free(tl->Logs);
-            free(tl);
+            object_free(&tl->base.base);
             goto reclaim;
         }
         hash_add(monitored_property_table, &tl->node, __property_hash(&(tl->Source)));
@@ -1111,7 +1118,7 @@ reclaim:
             tl = container_of(tl_instance, object_tl_t, base.base);
             hash_del(&tl->node);
             free(tl->Logs);
-            free(tl);
+            object_free(&tl->base.base);
         }
     }
 
@@ -1157,6 +1164,8 @@ int trend_log_record(object_instance_t *object, BACNET_DEVICE_OBJECT_PROPERTY_RE
         return -EPERM;
     }
 
+    object_write_lock(object);
+
     TempRec.tTimeStamp = time(NULL);
     tl->tLastDataTime = TempRec.tTimeStamp;
     TempRec.ucStatus = 0;
@@ -1234,6 +1243,8 @@ int trend_log_record(object_instance_t *object, BACNET_DEVICE_OBJECT_PROPERTY_RE
         tl->ulRecordCount++;
     }
 
+    object_write_unlock(object);
+
     return OK;
 }
 
@@ -11,6 +11,10 @@
 #ifndef _TRENDLOG_DEF_H_
 #define _TRENDLOG_DEF_H_
 
+#include <time.h>
+
+#include "bacnet/datetime.h"
+
 /*
  * Data types associated with a BACnet Log Record. We use these for managing the log buffer 
  * but they are also the tag numbers to use when encoding/decoding the log datum field.
@@ -34,5 +38,11 @@
 
 #define TRENDLOG_HASH_BITS  (8)
 
+#define TLM_MAX_MEMBERS     (32)        /* Log_DeviceObjectProperty entries per Trend Log Multiple */
+#define TLM_STATUS_REC      (0x80)      /* ucStatus of a log status record, low bits are the status */
+
+/* Convert a BACnet time into a local time in seconds since the local epoch */
+extern time_t Trend_Log_BAC_Time_To_Local(BACNET_DATE_TIME *SourceTime);
+
 #endif /* _TRENDLOG_DEF_H_ */
 
@@ -0,0 +1,1617 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * trendlog_multiple.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Trend Log Multiple Object
+ *
+ * History
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "bacnet/object/trendlog_multiple.h"
+#include "bacnet/object/device.h"
+#include "trendlog_def.h"
+#include "bacnet/app.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/service/rr.h"
+
+/* Worst case encoded size of one BACnetLogMultipleRecord */
+#define TLM_RECORD_MAX              (16 + TLM_MAX_MEMBERS * 10)
+
+/* Space kept in a ReadRange reply for result flags, item count and first sequence number */
+#define TLM_RR_OVERHEAD             (20)
+
+/* Longest single sleep of the acquisition timer, the due time is checked again on wake up */
+#define TLM_MAX_WAIT                (3600)
+
+#define TLM_DEFAULT_INTERVAL        (900)
+
+static inline uint32_t tlm_row(object_tlm_t *tlm, uint32_t k)
+{
+    /* k-th oldest record still in the buffer */
+    return (tlm->iIndex + tlm->ulBufferSize - tlm->ulRecordCount + k) % tlm->ulBufferSize;
+}
+
+/*
+ * Same rules as the Trend Log object, see 135-2008 sections 12.25.5 - 12.25.7
+ */
+static bool tlm_is_enabled(object_tlm_t *tlm)
+{
+    time_t tNow;
+
+    if (tlm->bEnable == false) {
+        return false;
+    }
+
+    if ((tlm->ucTimeFlags == 0) && (tlm->tStopTime < tlm->tStartTime)) {
+        return false;
+    }
+
+    if (tlm->ucTimeFlags == (TL_T_START_WILD | TL_T_STOP_WILD)) {
+        return true;
+    }
+
+    tNow = time(NULL);
+    if (((tlm->ucTimeFlags & TL_T_START_WILD) == 0) && (tNow < tlm->tStartTime)) {
+        return false;
+    }
+
+    if (((tlm->ucTimeFlags & TL_T_STOP_WILD) == 0) && (tNow > tlm->tStopTime)) {
+        return false;
+    }
+
+    return true;
+}
+
+/* Claims the next row of every column, overwriting the oldest record once the ring is full */
+static uint32_t tlm_append_row(object_tlm_t *tlm, uint8_t ucStatus)
+{
+    uint32_t row;
+
+    row = tlm->iIndex;
+    tlm->tTimeStamps[row] = time(NULL);
+    tlm->ucStatus[row] = ucStatus;
+
+    if (++tlm->iIndex >= tlm->ulBufferSize) {
+        tlm->iIndex = 0;
+    }
+
+    /* Total_Record_Count skips 0 when it wraps */
+    if (++tlm->ulTotalRecordCount == 0) {
+        tlm->ulTotalRecordCount = 1;
+    }
+
+    if (tlm->ulRecordCount < tlm->ulBufferSize) {
+        tlm->ulRecordCount++;
+    }
+
+    return row;
+}
+
+static void tlm_insert_status_rec(object_tlm_t *tlm, BACNET_LOG_STATUS eStatus, bool bState)
+{
+    uint8_t ucStatus;
+
+    switch (eStatus) {
+    case LOG_STATUS_LOG_DISABLED:
+    case LOG_STATUS_BUFFER_PURGED:
+        ucStatus = bState? (1 << eStatus): 0;
+        break;
+
+    case LOG_STATUS_LOG_INTERRUPTED:
+        ucStatus = 1 << LOG_STATUS_LOG_INTERRUPTED;
+        break;
+
+    default:
+        APP_ERROR("%s: invalid log status(%d)\r\n", __func__, eStatus);
+        return;
+    }
+
+    (void)tlm_append_row(tlm, TLM_STATUS_REC | ucStatus);
+}
+
+static void tlm_insert_data_rec(object_tlm_t *tlm, const uint8_t *types, const TLM_DATUM *values)
+{
+    uint32_t row, i;
+
+    row = tlm_append_row(tlm, 0);
+    for (i = 0; i < tlm->ulMemberCount; i++) {
+        tlm->ucTypes[i * tlm->ulBufferSize + row] = types[i];
+        tlm->Values[i * tlm->ulBufferSize + row] = values[i];
+    }
+
+    /* The last free entry is kept for the log disabled record */
+    if ((tlm->bStopWhenFull == true) && (tlm->ulRecordCount >= tlm->ulBufferSize - 1)) {
+        tlm->bEnable = false;
+        tlm_insert_status_rec(tlm, LOG_STATUS_LOG_DISABLED, true);
+    }
+}
+
+static void tlm_purge(object_tlm_t *tlm)
+{
+    tlm->ulRecordCount = 0;
+    tlm->iIndex = 0;
+    tlm_insert_status_rec(tlm, LOG_STATUS_BUFFER_PURGED, true);
+}
+
+/* @return: first polled sample time after tNow */
+static time_t tlm_next_sample(object_tlm_t *tlm, time_t tNow)
+{
+    struct tm LocalTime;
+    time_t tLocal;
+    uint32_t interval;
+
+    interval = tlm->ulLogInterval;
+    if (interval == 0) {
+        interval = TLM_DEFAULT_INTERVAL;
+    }
+
+    if (tlm->bAlignIntervals == false) {
+        return tNow + interval;
+    }
+
+    /* Samples fall on multiples of the interval of the local clock, moved by the offset */
+    (void)localtime_r(&tNow, &LocalTime);
+    tLocal = tNow + LocalTime.tm_gmtoff - (tlm->ulIntervalOffset % interval);
+
+    return tNow + interval - (time_t)(tLocal % interval);
+}
+
+/* Wakes the acquisition timer so that it looks at the log again on the loop thread */
+static void tlm_kick(object_tlm_t *tlm)
+{
+    if (tlm->timer == NULL) {
+        return;
+    }
+
+    if (el_timer_mod(&el_default_loop, tlm->timer, 0) < 0) {
+        APP_ERROR("%s: mod timer failed\r\n", __func__);
+    }
+}
+
+static void tlm_reschedule(object_tlm_t *tlm)
+{
+    if (tlm->LoggingType == LOGGING_TYPE_POLLED) {
+        tlm->tNextSample = tlm_next_sample(tlm, time(NULL));
+        tlm_kick(tlm);
+    }
+}
+
+static void tlm_sample_member(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member, uint8_t *buf,
+                uint8_t *type, TLM_DATUM *datum)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    BACNET_APPLICATION_DATA_VALUE value;
+    BACNET_BIT_STRING *bits;
+    uint8_t i;
+    int len;
+
+    rp_data.object_type = member->objectIdentifier.type;
+    rp_data.object_instance = member->objectIdentifier.instance;
+    rp_data.property_id = member->propertyIdentifier;
+    rp_data.array_index = member->arrayIndex;
+    rp_data.application_data = buf;
+    rp_data.application_data_len = MAX_APDU;
+    rp_data.error_class = ERROR_CLASS_PROPERTY;
+    rp_data.error_code = ERROR_CODE_OTHER;
+
+    len = object_read_property(&rp_data, NULL);
+    if (len < 0) {
+        *type = TL_TYPE_ERROR;
+        if (len == BACNET_STATUS_ERROR) {
+            datum->Error.usClass = rp_data.error_class;
+            datum->Error.usCode = rp_data.error_code;
+        } else {
+            datum->Error.usClass = ERROR_CLASS_PROPERTY;
+            datum->Error.usCode = ERROR_CODE_OTHER;
+        }
+        return;
+    }
+
+    /* Only single primitive values can be logged */
+    if (bacapp_decode_application_data(buf, (uint16_t)len, &value) != len) {
+        *type = TL_TYPE_ERROR;
+        datum->Error.usClass = ERROR_CLASS_PROPERTY;
+        datum->Error.usCode = ERROR_CODE_DATATYPE_NOT_SUPPORTED;
+        return;
+    }
+
+    switch (value.tag) {
+    case BACNET_APPLICATION_TAG_NULL:
+        *type = TL_TYPE_NULL;
+        break;
+
+    case BACNET_APPLICATION_TAG_BOOLEAN:
+        *type = TL_TYPE_BOOL;
+        datum->ucBoolean = (uint8_t)value.type.Boolean;
+        break;
+
+    case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+        *type = TL_TYPE_UNSIGN;
+        datum->ulUValue = value.type.Unsigned_Int;
+        break;
+
+    case BACNET_APPLICATION_TAG_SIGNED_INT:
+        *type = TL_TYPE_SIGN;
+        datum->lSValue = value.type.Signed_Int;
+        break;
+
+    case BACNET_APPLICATION_TAG_REAL:
+        *type = TL_TYPE_REAL;
+        datum->fReal = value.type.Real;
+        break;
+
+    case BACNET_APPLICATION_TAG_BIT_STRING:
+        *type = TL_TYPE_BITS;
+        /* We truncate any bitstrings at 24 bits to keep the value column 4 bytes wide */
+        bits = &value.type.Bit_String;
+        len = bitstring_size(bits);
+        if (len > 24) {
+            len = 24;
+        }
+        datum->Bits.ucBits = (uint8_t)len;
+        (void)memset(datum->Bits.ucStore, 0, sizeof(datum->Bits.ucStore));
+        for (i = 0; i < (len + 7) / 8; i++) {
+            datum->Bits.ucStore[i] = bits->value[i];
+        }
+        if (len & 7) {
+            datum->Bits.ucStore[len / 8] &= 0xFF << (8 - (len & 7));
+        }
+        break;
+
+    case BACNET_APPLICATION_TAG_ENUMERATED:
+        *type = TL_TYPE_ENUM;
+        datum->ulEnum = value.type.Enumerated;
+        break;
+
+    default:
+        *type = TL_TYPE_ERROR;
+        datum->Error.usClass = ERROR_CLASS_PROPERTY;
+        datum->Error.usCode = ERROR_CODE_DATATYPE_NOT_SUPPORTED;
+        break;
+    }
+}
+
+int trend_log_multiple_acquire(object_instance_t *object)
+{
+    object_tlm_t *tlm;
+    uint8_t types[TLM_MAX_MEMBERS];
+    TLM_DATUM values[TLM_MAX_MEMBERS];
+    uint8_t buf[MAX_APDU];
+    uint32_t i;
+    bool bSampled;
+
+    if ((object == NULL) || (object->type == NULL)
+            || (object->type->type != OBJECT_TREND_LOG_MULTIPLE)) {
+        APP_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    /* The members are read before the log is locked, so no member lock is ever
+     * taken while holding it. Members can not change after init.
+     */
+    bSampled = tlm_is_enabled(tlm);
+    if (bSampled) {
+        for (i = 0; i < tlm->ulMemberCount; i++) {
+            tlm_sample_member(&tlm->Members[i], buf, &types[i], &values[i]);
+        }
+    }
+
+    object_write_lock(object);
+
+    tlm->bTrigger = false;
+    if (bSampled && tlm_is_enabled(tlm)) {
+        tlm_insert_data_rec(tlm, types, values);
+    }
+
+    object_write_unlock(object);
+
+    return OK;
+}
+
+static void tlm_timer_handler(el_timer_t *timer)
+{
+    object_tlm_t *tlm;
+    time_t tNow;
+    bool bDue, bPolled;
+    unsigned wait;
+
+    tlm = (object_tlm_t *)timer->data;
+    tNow = time(NULL);
+    wait = 0;
+
+    object_write_lock(&tlm->base.base);
+
+    bDue = tlm->bTrigger;
+    bPolled = (tlm->LoggingType == LOGGING_TYPE_POLLED);
+    if (bPolled) {
+        /* The wall clock was set back by more than an interval */
+        if (tlm->tNextSample > tNow + (time_t)tlm->ulLogInterval) {
+            tlm->tNextSample = tlm_next_sample(tlm, tNow);
+        }
+
+        if (tNow >= tlm->tNextSample) {
+            bDue = true;
+            tlm->tNextSample = tlm_next_sample(tlm, tNow);
+        }
+
+        wait = (unsigned)(tlm->tNextSample - tNow);
+        if (wait > TLM_MAX_WAIT) {
+            wait = TLM_MAX_WAIT;
+        }
+    }
+
+    object_write_unlock(&tlm->base.base);
+
+    if (bDue) {
+        (void)trend_log_multiple_acquire(&tlm->base.base);
+    }
+
+    if (bPolled) {
+        (void)el_timer_mod(&el_default_loop, timer, wait * 1000);
+    }
+}
+
+static int tlm_read_enable(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_boolean(rp_data->application_data, tlm->bEnable);
+}
+
+static int tlm_write_enable(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    bool bEffectiveEnable;
+    bool value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_boolean(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (tlm->bEnable == value) {
+        return 0;
+    }
+
+    /* Can't enable a full log with stop when full set */
+    if ((value == true) && (tlm->ulRecordCount >= tlm->ulBufferSize - 1)
+            && (tlm->bStopWhenFull == true)) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_LOG_BUFFER_FULL;
+        return BACNET_STATUS_ERROR;
+    }
+
+    bEffectiveEnable = tlm_is_enabled(tlm);
+    tlm->bEnable = value;
+    if (value == false) {
+        if (bEffectiveEnable == true) {
+            tlm_insert_status_rec(tlm, LOG_STATUS_LOG_DISABLED, true);
+        }
+    } else {
+        if (tlm_is_enabled(tlm)) {
+            tlm_insert_status_rec(tlm, LOG_STATUS_LOG_DISABLED, false);
+        }
+    }
+
+    return 0;
+}
+
+static int tlm_read_stop_when_full(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_boolean(rp_data->application_data, tlm->bStopWhenFull);
+}
+
+static int tlm_write_stop_when_full(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    bool value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_boolean(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (tlm->bStopWhenFull != value) {
+        tlm->bStopWhenFull = value;
+        if ((value == true) && (tlm->ulRecordCount >= tlm->ulBufferSize - 1)
+                && (tlm->bEnable == true)) {
+            tlm->bEnable = false;
+            tlm_insert_status_rec(tlm, LOG_STATUS_LOG_DISABLED, true);
+        }
+    }
+
+    return 0;
+}
+
+static int tlm_read_buffer_size(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_unsigned(rp_data->application_data, tlm->ulBufferSize);
+}
+
+static int tlm_encode_record(object_tlm_t *tlm, uint32_t row, uint8_t *pdu)
+{
+    BACNET_DATE_TIME bdatetime;
+    BACNET_BIT_STRING bits;
+    struct tm LocalTime;
+    uint8_t store[3];
+    TLM_DATUM *datum;
+    uint32_t i;
+    int len;
+
+    (void)localtime_r(&tlm->tTimeStamps[row], &LocalTime);
+    datetime_set_values(&bdatetime, LocalTime.tm_year + 1900, LocalTime.tm_mon + 1,
+        LocalTime.tm_mday, LocalTime.tm_hour, LocalTime.tm_min, LocalTime.tm_sec, 0);
+
+    /* Context 0 timestamp */
+    len = encode_opening_tag(pdu, 0);
+    len += encode_application_date(&pdu[len], &bdatetime.date);
+    len += encode_application_time(&pdu[len], &bdatetime.time);
+    len += encode_closing_tag(&pdu[len], 0);
+
+    /* Context 1 log data, either the log status or one datum per member */
+    len += encode_opening_tag(&pdu[len], 1);
+    if (tlm->ucStatus[row] & TLM_STATUS_REC) {
+        store[0] = 0;
+        (void)bitstring_init(&bits, store, 3);
+        for (i = 0; i < 3; i++) {
+            bitstring_set_bit(&bits, i, (tlm->ucStatus[row] & (1 << i)) != 0);
+        }
+        len += encode_context_bitstring(&pdu[len], 0, &bits);
+    } else {
+        len += encode_opening_tag(&pdu[len], 1);
+        for (i = 0; i < tlm->ulMemberCount; i++) {
+            datum = &tlm->Values[i * tlm->ulBufferSize + row];
+            switch (tlm->ucTypes[i * tlm->ulBufferSize + row]) {
+            case TL_TYPE_BOOL:
+                len += encode_context_boolean(&pdu[len], 0, datum->ucBoolean != 0);
+                break;
+
+            case TL_TYPE_REAL:
+                len += encode_context_real(&pdu[len], 1, datum->fReal);
+                break;
+
+            case TL_TYPE_ENUM:
+                len += encode_context_enumerated(&pdu[len], 2, datum->ulEnum);
+                break;
+
+            case TL_TYPE_UNSIGN:
+                len += encode_context_unsigned(&pdu[len], 3, datum->ulUValue);
+                break;
+
+            case TL_TYPE_SIGN:
+                len += encode_context_signed(&pdu[len], 4, datum->lSValue);
+                break;
+
+            case TL_TYPE_BITS:
+                (void)memcpy(store, datum->Bits.ucStore, sizeof(store));
+                (void)bitstring_init(&bits, store, datum->Bits.ucBits);
+                len += encode_context_bitstring(&pdu[len], 5, &bits);
+                break;
+
+            case TL_TYPE_NULL:
+                len += encode_context_null(&pdu[len], 6);
+                break;
+
+            case TL_TYPE_ERROR:
+            default:
+                len += encode_opening_tag(&pdu[len], 7);
+                len += encode_application_enumerated(&pdu[len], datum->Error.usClass);
+                len += encode_application_enumerated(&pdu[len], datum->Error.usCode);
+                len += encode_closing_tag(&pdu[len], 7);
+                break;
+            }
+        }
+        len += encode_closing_tag(&pdu[len], 1);
+    }
+    len += encode_closing_tag(&pdu[len], 1);
+
+    return len;
+}
+
+/*
+ * Resolves a ReadRange request against the records currently held.
+ * @return: number of records selected, *first is the oldest one of them counted
+ *          from the oldest record in the buffer, <0 for an invalid request
+ */
+static int tlm_range_select(object_tlm_t *tlm, RR_RANGE *range, uint32_t *first)
+{
+    uint32_t count, pos, n;
+    time_t tRef;
+    int k;
+
+    count = tlm->ulRecordCount;
+    *first = 0;
+
+    if (range->RequestType == RR_READ_ALL) {
+        return count;
+    }
+
+    if (range->Count == 0) {
+        return -EINVAL;
+    }
+
+    switch (range->RequestType) {
+    case RR_BY_POSITION:
+        if ((range->Range.RefIndex == 0) || (range->Range.RefIndex > count)) {
+            return 0;
+        }
+        pos = range->Range.RefIndex - 1;
+        break;
+
+    case RR_BY_SEQUENCE:
+        /* The oldest record held has sequence number total - count + 1 */
+        pos = range->Range.RefSeqNum - (tlm->ulTotalRecordCount - count + 1);
+        if (pos >= count) {
+            return 0;
+        }
+        break;
+
+    case RR_BY_TIME:
+        tRef = Trend_Log_BAC_Time_To_Local(&range->Range.RefTime);
+        if (range->Count > 0) {
+            /* First record newer than the reference time */
+            for (k = 0; k < (int)count; k++) {
+                if (tlm->tTimeStamps[tlm_row(tlm, k)] > tRef) {
+                    break;
+                }
+            }
+            if (k >= (int)count) {
+                return 0;
+            }
+        } else {
+            /* Last record older than the reference time */
+            for (k = (int)count - 1; k >= 0; k--) {
+                if (tlm->tTimeStamps[tlm_row(tlm, k)] < tRef) {
+                    break;
+                }
+            }
+            if (k < 0) {
+                return 0;
+            }
+        }
+        pos = (uint32_t)k;
+        break;
+
+    default:
+        return -EINVAL;
+    }
+
+    if (range->Count > 0) {
+        n = count - pos;
+        if ((uint32_t)range->Count < n) {
+            n = range->Count;
+        }
+        *first = pos;
+    } else {
+        n = pos + 1;
+        if ((uint32_t)(-(int64_t)range->Count) < n) {
+            n = (uint32_t)(-(int64_t)range->Count);
+        }
+        *first = pos + 1 - n;
+    }
+
+    return n;
+}
+
+static int tlm_read_log_buffer(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+    BACNET_BIT_STRING ResultFlags;
+    uint8_t item_data[MAX_APDU];
+    uint8_t record[TLM_RECORD_MAX];
+    uint8_t *pdu;
+    uint32_t first, item_count, k;
+    int selected, limit;
+    int pdu_len, item_data_len, len;
+    bool bMore;
+    uint8_t value;
+
+    if (rp_data->array_index != BACNET_ARRAY_ALL) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (range == NULL) {
+        /* You can only read the buffer via the ReadRange service */
+        APP_ERROR("%s: PROP_LOG_BUFFER only can be read via the ReadRange service\r\n", __func__);
+        rp_data->error_code = ERROR_CODE_READ_ACCESS_DENIED;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    selected = tlm_range_select(tlm, range, &first);
+    if (selected < 0) {
+        APP_ERROR("%s: invalid RR_RequestType(%d) or Count(%d)\r\n", __func__, range->RequestType,
+            range->Count);
+        rp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    limit = (int)rp_data->application_data_len - TLM_RR_OVERHEAD;
+    if (limit > (int)sizeof(item_data)) {
+        limit = sizeof(item_data);
+    }
+
+    bMore = false;
+    item_data_len = 0;
+
+    if ((range->Count < 0) && (range->RequestType != RR_READ_ALL)) {
+        /* Keep the records nearest to the reference when they don't all fit */
+        k = first + selected;
+        while (k > first) {
+            len = tlm_encode_record(tlm, tlm_row(tlm, k - 1), record);
+            if (item_data_len + len > limit) {
+                bMore = true;
+                break;
+            }
+            item_data_len += len;
+            k--;
+        }
+        selected -= k - first;
+        first = k;
+        item_data_len = 0;
+    }
+
+    for (item_count = 0; item_count < (uint32_t)selected; item_count++) {
+        len = tlm_encode_record(tlm, tlm_row(tlm, first + item_count), record);
+        if (item_data_len + len > limit) {
+            bMore = true;
+            break;
+        }
+        (void)memcpy(&item_data[item_data_len], record, len);
+        item_data_len += len;
+    }
+
+    value = 0;
+    (void)bitstring_init(&ResultFlags, &value, 3);
+    if (item_count != 0) {
+        bitstring_set_bit(&ResultFlags, RESULT_FLAG_FIRST_ITEM, first == 0);
+        bitstring_set_bit(&ResultFlags, RESULT_FLAG_LAST_ITEM,
+            first + item_count == tlm->ulRecordCount);
+    }
+    bitstring_set_bit(&ResultFlags, RESULT_FLAG_MORE_ITEMS, bMore);
+
+    pdu = rp_data->application_data;
+
+    /* Context 3 BACnet Result Flags */
+    pdu_len = encode_context_bitstring(pdu, 3, &ResultFlags);
+
+    /* Context 4 Item Count */
+    pdu_len += encode_context_unsigned(&pdu[pdu_len], 4, item_count);
+
+    /* Context 5 Log records */
+    pdu_len += encode_opening_tag(&pdu[pdu_len], 5);
+    if (item_count != 0) {
+        if (pdu_len + item_data_len + TLM_RR_OVERHEAD / 2 >= rp_data->application_data_len) {
+            rp_data->abort_reason = ABORT_REASON_SEGMENTATION_NOT_SUPPORTED;
+            return BACNET_STATUS_ABORT;
+        }
+
+        (void)memcpy(&pdu[pdu_len], item_data, item_data_len);
+        pdu_len += item_data_len;
+    }
+    pdu_len += encode_closing_tag(&pdu[pdu_len], 5);
+
+    /* Context 6 First Sequence Number */
+    if ((item_count != 0) && ((range->RequestType == RR_BY_SEQUENCE)
+            || (range->RequestType == RR_BY_TIME))) {
+        pdu_len += encode_context_unsigned(&pdu[pdu_len], 6,
+            tlm->ulTotalRecordCount - tlm->ulRecordCount + 1 + first);
+    }
+
+    return pdu_len;
+}
+
+static int tlm_read_record_count(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_unsigned(rp_data->application_data, tlm->ulRecordCount);
+}
+
+static int tlm_write_record_count(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_unsigned(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    /* Only writing 0 is allowed, it purges the buffer */
+    if (value != 0) {
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm_purge(tlm);
+
+    return 0;
+}
+
+static int tlm_read_total_record_count(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_unsigned(rp_data->application_data, tlm->ulTotalRecordCount);
+}
+
+static int tlm_read_logging_type(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_enumerated(rp_data->application_data, tlm->LoggingType);
+}
+
+static int tlm_write_logging_type(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_enumerated(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (value == LOGGING_TYPE_POLLED) {
+        tlm->LoggingType = value;
+        if (tlm->ulLogInterval == 0) {
+            tlm->ulLogInterval = TLM_DEFAULT_INTERVAL;
+        }
+        tlm_reschedule(tlm);
+    } else if (value == LOGGING_TYPE_TRIGGERED) {
+        tlm->LoggingType = value;
+        tlm->ulLogInterval = 0;
+    } else if (value == LOGGING_TYPE_COV) {
+        APP_ERROR("%s: we don't currrently support LOGGING_TYPE_COV\r\n", __func__);
+        wp_data->error_code = ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+        return BACNET_STATUS_ERROR;
+    } else {
+        APP_ERROR("%s: invalid PROP_LOGGING_TYPE value(%d)\r\n", __func__, value);
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return 0;
+}
+
+static int tlm_read_start_time(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+    int len;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    len = encode_application_date(rp_data->application_data, &(tlm->StartTime.date));
+    len += encode_application_time(rp_data->application_data + len, &(tlm->StartTime.time));
+
+    return len;
+}
+
+static int tlm_write_time(object_tlm_t *tlm, BACNET_WRITE_PROPERTY_DATA *wp_data, bool bStart)
+{
+    BACNET_DATE_TIME bdatetime;
+    bool bEffectiveEnable;
+    int len;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    len = decode_application_date(wp_data->application_data, &bdatetime.date);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    len += decode_application_time(wp_data->application_data + len, &bdatetime.time);
+    if (len != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    /* First record the current enable state of the log */
+    bEffectiveEnable = tlm_is_enabled(tlm);
+
+    if (bStart) {
+        tlm->StartTime = bdatetime;
+        if (datetime_wildcard_present(&bdatetime)) {
+            tlm->ucTimeFlags |= TL_T_START_WILD;
+            tlm->tStartTime = 0;
+        } else {
+            tlm->ucTimeFlags &= ~TL_T_START_WILD;
+            tlm->tStartTime = Trend_Log_BAC_Time_To_Local(&bdatetime);
+        }
+    } else {
+        tlm->StopTime = bdatetime;
+        if (datetime_wildcard_present(&bdatetime)) {
+            tlm->ucTimeFlags |= TL_T_STOP_WILD;
+            tlm->tStopTime = 0xFFFFFFFF;
+        } else {
+            tlm->ucTimeFlags &= ~TL_T_STOP_WILD;
+            tlm->tStopTime = Trend_Log_BAC_Time_To_Local(&bdatetime);
+        }
+    }
+
+    /* Enable status has changed because of time update */
+    if (bEffectiveEnable != tlm_is_enabled(tlm)) {
+        tlm_insert_status_rec(tlm, LOG_STATUS_LOG_DISABLED, bEffectiveEnable);
+    }
+
+    return 0;
+}
+
+static int tlm_write_start_time(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    return tlm_write_time(container_of(object, object_tlm_t, base.base), wp_data, true);
+}
+
+static int tlm_read_stop_time(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+    int len;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    len = encode_application_date(rp_data->application_data, &(tlm->StopTime.date));
+    len += encode_application_time(rp_data->application_data + len, &(tlm->StopTime.time));
+
+    return len;
+}
+
+static int tlm_write_stop_time(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    return tlm_write_time(container_of(object, object_tlm_t, base.base), wp_data, false);
+}
+
+static int tlm_read_log_device_object_property(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+    uint8_t *pdu;
+    uint32_t i;
+    int len;
+
+    if (range != NULL) {
+        rp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+    pdu = rp_data->application_data;
+
+    if (rp_data->array_index == 0) {
+        return encode_application_unsigned(pdu, tlm->ulMemberCount);
+    }
+
+    if (rp_data->array_index != BACNET_ARRAY_ALL) {
+        if (rp_data->array_index > tlm->ulMemberCount) {
+            rp_data->error_class = ERROR_CLASS_PROPERTY;
+            rp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+            return BACNET_STATUS_ERROR;
+        }
+        return bacapp_encode_device_obj_property_ref(pdu,
+            &tlm->Members[rp_data->array_index - 1]);
+    }
+
+    len = 0;
+    for (i = 0; i < tlm->ulMemberCount; i++) {
+        if (len + 20 > rp_data->application_data_len) {
+            rp_data->abort_reason = ABORT_REASON_SEGMENTATION_NOT_SUPPORTED;
+            return BACNET_STATUS_ABORT;
+        }
+        len += bacapp_encode_device_obj_property_ref(&pdu[len], &tlm->Members[i]);
+    }
+
+    return len;
+}
+
+static int tlm_read_log_interval(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    /* We only log to 1 sec accuracy so must multiply by 100 before passing it on */
+    return encode_application_unsigned(rp_data->application_data, tlm->ulLogInterval * 100);
+}
+
+static int tlm_write_log_interval(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_unsigned(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (tlm->LoggingType == LOGGING_TYPE_TRIGGERED) {
+        APP_ERROR("%s: write PROP_LOG_INTERVAL denied if LOGGING_TYPE_TRIGGERED\r\n", __func__);
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return BACNET_STATUS_ERROR;
+    }
+
+    /* We only log to 1 sec accuracy, and 0 would mean COV which we don't support */
+    if (value < 100) {
+        APP_ERROR("%s: write PROP_LOG_INTERVAL failed cause we don't support COV\r\n", __func__);
+        wp_data->error_code = ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm->ulLogInterval = value / 100;
+    tlm_reschedule(tlm);
+
+    return 0;
+}
+
+static int tlm_read_align_intervals(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_boolean(rp_data->application_data, tlm->bAlignIntervals);
+}
+
+static int tlm_write_align_intervals(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    bool value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_boolean(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    if (tlm->bAlignIntervals != value) {
+        tlm->bAlignIntervals = value;
+        tlm_reschedule(tlm);
+    }
+
+    return 0;
+}
+
+static int tlm_read_interval_offset(object_instance_t *object,
+            BACNET_READ_PROPERTY_DATA *rp_data, RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_unsigned(rp_data->application_data, tlm->ulIntervalOffset * 100);
+}
+
+static int tlm_write_interval_offset(object_instance_t *object,
+            BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    uint32_t value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_unsigned(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm->ulIntervalOffset = value / 100;
+    tlm_reschedule(tlm);
+
+    return 0;
+}
+
+static int tlm_read_trigger(object_instance_t *object, BACNET_READ_PROPERTY_DATA *rp_data,
+            RR_RANGE *range)
+{
+    object_tlm_t *tlm;
+
+    if ((rp_data->array_index != BACNET_ARRAY_ALL) || (range != NULL)) {
+        rp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    return encode_application_boolean(rp_data->application_data, tlm->bTrigger);
+}
+
+static int tlm_write_trigger(object_instance_t *object, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    object_tlm_t *tlm;
+    bool value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    tlm = container_of(object, object_tlm_t, base.base);
+
+    if (decode_application_boolean(wp_data->application_data, &value)
+            != wp_data->application_data_len) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    /* Triggered readings would break the alignment of a clock aligned polled log */
+    if ((tlm->LoggingType == LOGGING_TYPE_POLLED) && (tlm->bAlignIntervals == true)) {
+        APP_ERROR("%s: write PROP_TRIGGER failed cause polling with aligning\r\n", __func__);
+        wp_data->error_code = ERROR_CODE_NOT_CONFIGURED_FOR_TRIGGERED_LOGGING;
+        return BACNET_STATUS_ERROR;
+    }
+
+    /* The acquisition runs on the loop thread, the members are not read under our lock */
+    tlm->bTrigger = value;
+    if (value) {
+        tlm_kick(tlm);
+    }
+
+    return 0;
+}
+
+object_impl_t *object_create_impl_tlm(void)
+{
+    object_impl_t *tlm;
+    property_impl_t *p_impl;
+
+    tlm = object_create_impl_seor(true, false, true);
+    if (!tlm) {
+        APP_ERROR("%s: create SEO impl failed\r\n", __func__);
+        return NULL;
+    }
+    tlm->type = OBJECT_TREND_LOG_MULTIPLE;
+    tlm->locked_read = true;
+
+    p_impl = object_impl_extend(tlm, PROP_ENABLE, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_ENABLE failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_enable;
+    p_impl->write_property = tlm_write_enable;
+
+    p_impl = object_impl_extend(tlm, PROP_LOG_DEVICE_OBJECT_PROPERTY, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_LOG_DEVICE_OBJECT_PROPERTY failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_log_device_object_property;
+
+    p_impl = object_impl_extend(tlm, PROP_LOGGING_TYPE, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_LOGGING_TYPE failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_logging_type;
+    p_impl->write_property = tlm_write_logging_type;
+
+    p_impl = object_impl_extend(tlm, PROP_LOG_INTERVAL, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_LOG_INTERVAL failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_log_interval;
+    p_impl->write_property = tlm_write_log_interval;
+
+    p_impl = object_impl_extend(tlm, PROP_STOP_WHEN_FULL, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_STOP_WHEN_FULL failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_stop_when_full;
+    p_impl->write_property = tlm_write_stop_when_full;
+
+    p_impl = object_impl_extend(tlm, PROP_BUFFER_SIZE, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_BUFFER_SIZE failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_buffer_size;
+
+    p_impl = object_impl_extend(tlm, PROP_LOG_BUFFER, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_LOG_BUFFER failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_log_buffer;
+
+    p_impl = object_impl_extend(tlm, PROP_RECORD_COUNT, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_RECORD_COUNT failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_record_count;
+    p_impl->write_property = tlm_write_record_count;
+
+    p_impl = object_impl_extend(tlm, PROP_TOTAL_RECORD_COUNT, PROPERTY_TYPE_REQUIRED);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_TOTAL_RECORD_COUNT failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_total_record_count;
+
+    p_impl = object_impl_extend(tlm, PROP_START_TIME, PROPERTY_TYPE_OPTIONAL);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_START_TIME failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_start_time;
+    p_impl->write_property = tlm_write_start_time;
+
+    p_impl = object_impl_extend(tlm, PROP_STOP_TIME, PROPERTY_TYPE_OPTIONAL);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_STOP_TIME failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_stop_time;
+    p_impl->write_property = tlm_write_stop_time;
+
+    p_impl = object_impl_extend(tlm, PROP_ALIGN_INTERVALS, PROPERTY_TYPE_OPTIONAL);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_ALIGN_INTERVALS failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_align_intervals;
+    p_impl->write_property = tlm_write_align_intervals;
+
+    p_impl = object_impl_extend(tlm, PROP_INTERVAL_OFFSET, PROPERTY_TYPE_OPTIONAL);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_INTERVAL_OFFSET failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_interval_offset;
+    p_impl->write_property = tlm_write_interval_offset;
+
+    p_impl = object_impl_extend(tlm, PROP_TRIGGER, PROPERTY_TYPE_OPTIONAL);
+    if (!p_impl) {
+        APP_ERROR("%s: extend PROP_TRIGGER failed\r\n", __func__);
+        goto out;
+    }
+    p_impl->read_property = tlm_read_trigger;
+    p_impl->write_property = tlm_write_trigger;
+
+    return tlm;
+
+out:
+    object_impl_destroy(tlm);
+
+    return NULL;
+}
+
+static void tlm_destroy(object_tlm_t *tlm)
+{
+    if (tlm->timer) {
+        (void)el_timer_destroy(&el_default_loop, tlm->timer);
+    }
+
+    free(tlm->Members);
+    free(tlm->tTimeStamps);
+    object_free(&tlm->base.base);
+}
+
+static void tlm_set_wildcard(BACNET_DATE_TIME *bdatetime)
+{
+    bdatetime->date.year = 1900 + 0xFF;
+    bdatetime->date.month = 0xFF;
+    bdatetime->date.day = 0xFF;
+    bdatetime->date.wday = 0xFF;
+    bdatetime->time.hour = 0xFF;
+    bdatetime->time.min = 0xFF;
+    bdatetime->time.sec = 0xFF;
+    bdatetime->time.hundredths = 0xFF;
+}
+
+static int tlm_config_members(object_tlm_t *tlm, cJSON *array, int i)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member;
+    cJSON *item, *tmp;
+    int count, j;
+
+    count = cJSON_GetArraySize(array);
+    if ((count <= 0) || (count > TLM_MAX_MEMBERS)) {
+        APP_ERROR("%s: Instance_List[%d] Member_List size(%d) out of range\r\n", __func__, i,
+            count);
+        return -EPERM;
+    }
+
+    tlm->Members = (BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *)calloc(count,
+        sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE));
+    if (tlm->Members == NULL) {
+        APP_ERROR("%s: malloc Instance_List[%d] Member_List failed\r\n", __func__, i);
+        return -ENOMEM;
+    }
+    tlm->ulMemberCount = count;
+
+    j = 0;
+    cJSON_ArrayForEach(item, array) {
+        member = &tlm->Members[j];
+        if (item->type != cJSON_Object) {
+            APP_ERROR("%s: invalid Instance_List[%d] Member_List[%d] item type\r\n", __func__, i, j);
+            return -EPERM;
+        }
+
+        /* Only properties of this device can be logged */
+        member->deviceIndentifier.type = OBJECT_DEVICE;
+        member->deviceIndentifier.instance = device_object_instance_number();
+        tmp = cJSON_GetObjectItem(item, "Logged_DeviceID");
+        if ((tmp != NULL) && ((tmp->type != cJSON_Number)
+                || ((uint32_t)tmp->valueint != member->deviceIndentifier.instance))) {
+            APP_ERROR("%s: invalid Instance_List[%d] Member_List[%d] Logged_DeviceID\r\n",
+                __func__, i, j);
+            return -EPERM;
+        }
+
+        tmp = cJSON_GetObjectItem(item, "Logged_ObjectType");
+        if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
+            APP_ERROR("%s: get Instance_List[%d] Member_List[%d] Logged_ObjectType item failed\r\n",
+                __func__, i, j);
+            return -EPERM;
+        }
+        member->objectIdentifier.type = tmp->valueint;
+
+        tmp = cJSON_GetObjectItem(item, "Logged_ObjectInstance");
+        if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
+            APP_ERROR("%s: get Instance_List[%d] Member_List[%d] Logged_ObjectInstance item "
+                "failed\r\n", __func__, i, j);
+            return -EPERM;
+        }
+        member->objectIdentifier.instance = (uint32_t)tmp->valueint;
+
+        tmp = cJSON_GetObjectItem(item, "Logged_PropertyID");
+        if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
+            APP_ERROR("%s: get Instance_List[%d] Member_List[%d] Logged_PropertyID item failed\r\n",
+                __func__, i, j);
+            return -EPERM;
+        }
+        member->propertyIdentifier = tmp->valueint;
+
+        member->arrayIndex = BACNET_ARRAY_ALL;
+        tmp = cJSON_GetObjectItem(item, "Logged_PropertyIndex");
+        if (tmp != NULL) {
+            if (tmp->type != cJSON_Number) {
+                APP_ERROR("%s: invalid Instance_List[%d] Member_List[%d] Logged_PropertyIndex\r\n",
+                    __func__, i, j);
+                return -EPERM;
+            }
+            if (tmp->valueint != -1) {
+                member->arrayIndex = tmp->valueint;
+            }
+        }
+        j++;
+    }
+
+    return OK;
+}
+
+static int tlm_config(object_tlm_t *tlm, cJSON *instance, int i)
+{
+    cJSON *tmp;
+    size_t columns;
+    uint8_t *block;
+    time_t tNow;
+
+    tmp = cJSON_GetObjectItem(instance, "Name");
+    if ((tmp == NULL) || (tmp->type != cJSON_String)) {
+        APP_ERROR("%s: get Instance_List[%d] Name item failed\r\n", __func__, i);
+        return -EPERM;
+    }
+    if (!object_set_name(&tlm->base.base, tmp->valuestring)) {
+        APP_ERROR("%s: set object name overflow\r\n", __func__);
+        return -EPERM;
+    }
+
+    tmp = cJSON_GetObjectItem(instance, "Member_List");
+    if ((tmp == NULL) || (tmp->type != cJSON_Array)) {
+        APP_ERROR("%s: get Instance_List[%d] Member_List item failed\r\n", __func__, i);
+        return -EPERM;
+    }
+    if (tlm_config_members(tlm, tmp, i) < 0) {
+        return -EPERM;
+    }
+
+    tlm->ulLogInterval = TLM_DEFAULT_INTERVAL;
+    tmp = cJSON_GetObjectItem(instance, "Log_Interval");
+    if (tmp != NULL) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint <= 0)) {
+            APP_ERROR("%s: invalid Instance_List[%d] Log_Interval\r\n", __func__, i);
+            return -EPERM;
+        }
+        tlm->ulLogInterval = (uint32_t)tmp->valueint;
+    }
+
+    tlm->ulBufferSize = TL_MAX_ENTRIES;
+    tmp = cJSON_GetObjectItem(instance, "Buffer_Size");
+    if (tmp != NULL) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint < 2)) {
+            APP_ERROR("%s: invalid Instance_List[%d] Buffer_Size\r\n", __func__, i);
+            return -EPERM;
+        }
+        tlm->ulBufferSize = (uint32_t)tmp->valueint;
+    }
+
+    tlm->bAlignIntervals = true;
+    tmp = cJSON_GetObjectItem(instance, "Align_Intervals");
+    if (tmp != NULL) {
+        if ((tmp->type != cJSON_True) && (tmp->type != cJSON_False)) {
+            APP_ERROR("%s: invalid Instance_List[%d] Align_Intervals\r\n", __func__, i);
+            return -EPERM;
+        }
+        tlm->bAlignIntervals = (tmp->type == cJSON_True);
+    }
+
+    tlm->ulIntervalOffset = 0;
+    tmp = cJSON_GetObjectItem(instance, "Interval_Offset");
+    if (tmp != NULL) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint < 0)) {
+            APP_ERROR("%s: invalid Instance_List[%d] Interval_Offset\r\n", __func__, i);
+            return -EPERM;
+        }
+        tlm->ulIntervalOffset = (uint32_t)tmp->valueint;
+    }
+
+    /* One block for all columns, the 8 byte timestamps first to keep them aligned */
+    columns = sizeof(time_t) + tlm->ulMemberCount * (sizeof(TLM_DATUM) + sizeof(uint8_t))
+        + sizeof(uint8_t);
+    block = (uint8_t *)calloc(tlm->ulBufferSize, columns);
+    if (block == NULL) {
+        APP_ERROR("%s: malloc Instance_List[%d] Log_Buffer failed\r\n", __func__, i);
+        return -ENOMEM;
+    }
+    tlm->tTimeStamps = (time_t *)block;
+    block += sizeof(time_t) * tlm->ulBufferSize;
+    tlm->Values = (TLM_DATUM *)block;
+    block += sizeof(TLM_DATUM) * tlm->ulMemberCount * tlm->ulBufferSize;
+    tlm->ucTypes = block;
+    block += tlm->ulMemberCount * tlm->ulBufferSize;
+    tlm->ucStatus = block;
+
+    tlm->bEnable = true;
+    tlm->bStopWhenFull = false;
+    tlm->bTrigger = false;
+    tlm->LoggingType = LOGGING_TYPE_POLLED;
+    tlm->ucTimeFlags = TL_T_START_WILD | TL_T_STOP_WILD;
+    tlm_set_wildcard(&tlm->StartTime);
+    tlm->tStartTime = 0;
+    tlm_set_wildcard(&tlm->StopTime);
+    tlm->tStopTime = 0xFFFFFFFF;
+    tlm->ulRecordCount = 0;
+    tlm->ulTotalRecordCount = 0;
+    tlm->iIndex = 0;
+
+    tNow = time(NULL);
+    tlm->tNextSample = tlm_next_sample(tlm, tNow);
+    tlm->timer = el_timer_create(&el_default_loop, (unsigned)(tlm->tNextSample - tNow) * 1000);
+    if (tlm->timer == NULL) {
+        APP_ERROR("%s: create Instance_List[%d] timer failed\r\n", __func__, i);
+        return -EPERM;
+    }
+    tlm->timer->handler = tlm_timer_handler;
+    tlm->timer->data = tlm;
+
+    return OK;
+}
+
+int __attribute__((weak)) trend_log_multiple_init(cJSON *object)
+{
+    object_tlm_t *tlm;
+    object_instance_t *tlm_instance;
+    object_impl_t *tlm_type = NULL;
+    cJSON *array, *instance;
+    int i;
+
+    if (object == NULL) {
+        goto end;
+    }
+
+    array = cJSON_GetObjectItem(object, "Instance_List");
+    if ((array == NULL) || (array->type != cJSON_Array)) {
+        APP_ERROR("%s: get Instance_List item failed\r\n", __func__);
+        goto out;
+    }
+
+    if (object_reserve(OBJECT_TREND_LOG_MULTIPLE, sizeof(object_tlm_t),
+            cJSON_GetArraySize(array)) < 0) {
+        APP_ERROR("%s: not enough memory\r\n", __func__);
+        goto out;
+    }
+
+    i = 0;
+    cJSON_ArrayForEach(instance, array) {
+        if (instance->type != cJSON_Object) {
+            APP_ERROR("%s: invalid Instance_List[%d] item type\r\n", __func__, i);
+            goto reclaim;
+        }
+
+        if (!tlm_type) {
+            tlm_type = object_create_impl_tlm();
+            if (!tlm_type) {
+                APP_ERROR("%s: create tlm type impl failed\r\n", __func__);
+                goto reclaim;
+            }
+        }
+
+        tlm = (object_tlm_t *)object_alloc(OBJECT_TREND_LOG_MULTIPLE, sizeof(object_tlm_t));
+        if (!tlm) {
+            APP_ERROR("%s: not enough memory\r\n", __func__);
+            goto reclaim;
+        }
+        tlm->base.base.instance = i;
+        tlm->base.base.type = tlm_type;
+
+        if (tlm_config(tlm, instance, i) < 0) {
+            tlm_destroy(tlm);
+            goto reclaim;
+        }
+
+        if (!object_add(&tlm->base.base)) {
+            APP_ERROR("%s: object add failed\r\n", __func__);
+            tlm_destroy(tlm);
+            goto reclaim;
+        }
+        i++;
+    }
+
+end:
+    return OK;
+
+reclaim:
+    for (i = i - 1; i >= 0; i--) {
+        tlm_instance = object_find(OBJECT_TREND_LOG_MULTIPLE, i);
+        if (!tlm_instance) {
+            APP_ERROR("%s: reclaim failed\r\n", __func__);
+        } else {
+            object_detach(tlm_instance);
+            tlm_destroy(container_of(tlm_instance, object_tlm_t, base.base));
+        }
+    }
+
+    if (tlm_type) {
+        object_impl_destroy(tlm_type);
+    }
+
+out:
+
+    return -EPERM;
+}
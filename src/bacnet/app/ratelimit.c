@@ -0,0 +1,413 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * ratelimit.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Rate limit of inbound unconfirmed services. A misbehaving peer which
+ * broadcasts Who-Is in a loop would otherwise make us flood every trunk
+ * with I-Am. Who-Is and Who-Has are limited by default.
+ *
+ * History
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "ratelimit_def.h"
+#include "bacnet/app.h"
+#include "misc/eventloop.h"
+#include "misc/hash.h"
+
+static rate_limit_t rate_limit = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .enable = false,
+    .sources = NULL,
+};
+
+static bool rate_limit_init_status = false;
+
+static bool bucket_take(token_bucket_t *bucket, uint32_t rate, uint32_t burst, uint32_t now)
+{
+    uint64_t tokens;
+
+    /* rate/룬ǡõrate(1/TOKEN_UNIT)/ */
+    tokens = bucket->tokens + (uint64_t)(uint32_t)(now - bucket->stamp) * rate;
+    if (tokens > (uint64_t)burst * TOKEN_UNIT) {
+        tokens = (uint64_t)burst * TOKEN_UNIT;
+    }
+    bucket->stamp = now;
+
+    if (tokens < TOKEN_UNIT) {
+        bucket->tokens = (uint32_t)tokens;
+        return false;
+    }
+
+    bucket->tokens = (uint32_t)(tokens - TOKEN_UNIT);
+
+    return true;
+}
+
+static void bucket_fill(token_bucket_t *bucket, uint32_t burst, uint32_t now)
+{
+    bucket->tokens = burst * TOKEN_UNIT;
+    bucket->stamp = now;
+}
+
+static uint32_t source_hash(const bacnet_addr_t *addr)
+{
+    uint32_t code;
+    int i;
+
+    code = addr->net;
+    for (i = 0; i < addr->len; i++) {
+        code = ROTATE_LEFT(code, 8) + addr->adr[i];
+    }
+
+    return hash_32(code, 32);
+}
+
+static bool source_equal(const bacnet_addr_t *a, const bacnet_addr_t *b)
+{
+    return (a->net == b->net) && (a->len == b->len) && !memcmp(a->adr, b->adr, a->len);
+}
+
+/* ̽ⴰҲ޿λʱ̭δƵԴ */
+static rate_source_t *source_find(const bacnet_addr_t *addr, uint32_t now)
+{
+    rate_source_t *entry, *victim;
+    uint32_t idx, age, max_age;
+    int i;
+
+    idx = source_hash(addr);
+    victim = NULL;
+    max_age = 0;
+    for (i = 0; i < SOURCE_PROBE_LIMIT; i++) {
+        entry = &rate_limit.sources[(idx + i) & rate_limit.source_mask];
+        if (!entry->used) {
+            victim = entry;
+            break;
+        }
+
+        if (source_equal(&entry->addr, addr)) {
+            return entry;
+        }
+
+        age = now - entry->bucket.stamp;
+        if ((victim == NULL) || (age > max_age)) {
+            victim = entry;
+            max_age = age;
+        }
+    }
+
+    if (victim->used) {
+        rate_limit.source_evicted++;
+    }
+
+    victim->used = 1;
+    victim->addr.net = addr->net;
+    victim->addr.len = addr->len;
+    memcpy(victim->addr.adr, addr->adr, addr->len);
+    bucket_fill(&victim->bucket, rate_limit.source_burst, now);
+
+    return victim;
+}
+
+bool rate_limit_unconfirmed(uint8_t service_choice, bacnet_addr_t *src)
+{
+    rate_source_t *source;
+    rate_limit_stat_t *stat;
+    uint32_t now;
+    bool pass;
+
+    if (!rate_limit.enable || (service_choice >= MAX_BACNET_UNCONFIRMED_SERVICE)
+            || !rate_limit.limited[service_choice]) {
+        return true;
+    }
+
+    now = el_current_millisecond();
+    stat = &rate_limit.stat[service_choice];
+
+    pthread_mutex_lock(&rate_limit.lock);
+
+    pass = true;
+    if (rate_limit.sources == NULL) {
+        goto out;
+    }
+
+    if (src) {
+        source = source_find(src, now);
+        if (!bucket_take(&source->bucket, rate_limit.source_rate, rate_limit.source_burst, now)) {
+            rate_limit.source_dropped++;
+            pass = false;
+        }
+    }
+
+    if (pass && !bucket_take(&rate_limit.global, rate_limit.global_rate, rate_limit.global_burst,
+            now)) {
+        rate_limit.global_dropped++;
+        pass = false;
+    }
+
+    if (pass) {
+        stat->passed++;
+    } else {
+        stat->dropped++;
+    }
+
+out:
+    pthread_mutex_unlock(&rate_limit.lock);
+
+    if (!pass) {
+        APP_VERBOS("%s: drop unconfirmed service(%d) from ", __func__, service_choice);
+        if (app_dbg_verbos && src) {
+            PRINT_BACNET_ADDRESS(src);
+        }
+    }
+
+    return pass;
+}
+
+bool rate_limit_whois_collapse(uint16_t reply_net)
+{
+    whois_reply_t *reply;
+    uint32_t now;
+    bool collapse;
+
+    if (!rate_limit.enable || (rate_limit.whois_window == 0)) {
+        return false;
+    }
+
+    now = el_current_millisecond();
+    reply = &rate_limit.whois[hash_32(reply_net, WHOIS_COLLAPSE_BITS)];
+
+    pthread_mutex_lock(&rate_limit.lock);
+
+    collapse = false;
+    if (reply->used && (reply->net == reply_net)
+            && ((uint32_t)(now - reply->stamp) < rate_limit.whois_window)) {
+        rate_limit.whois_collapsed++;
+        collapse = true;
+    } else {
+        reply->used = 1;
+        reply->net = reply_net;
+        reply->stamp = now;
+    }
+
+    pthread_mutex_unlock(&rate_limit.lock);
+
+    return collapse;
+}
+
+static int rate_limit_get_number(cJSON *cfg, const char *name, uint32_t min, uint32_t max,
+                uint32_t *value)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, name);
+    if (tmp == NULL) {
+        return OK;
+    }
+
+    if (tmp->type != cJSON_Number) {
+        APP_ERROR("%s: invalid %s item type\r\n", __func__, name);
+        return -EPERM;
+    }
+
+    if ((tmp->valueint < (int)min) || ((uint32_t)tmp->valueint > max)) {
+        APP_ERROR("%s: invalid %s(%d)\r\n", __func__, name, tmp->valueint);
+        return -EPERM;
+    }
+
+    *value = (uint32_t)tmp->valueint;
+
+    return OK;
+}
+
+int rate_limit_init(cJSON *cfg)
+{
+    cJSON *tmp, *item;
+    uint32_t max_source, now;
+    bool enable;
+    int rv;
+
+    if (rate_limit_init_status) {
+        APP_WARN("%s: rate limit is already inited\r\n", __func__);
+        return OK;
+    }
+
+    if (cfg == NULL) {
+        APP_ERROR("%s: null cfg\r\n", __func__);
+        return -EINVAL;
+    }
+
+    enable = true;
+    tmp = cJSON_GetObjectItem(cfg, "Enable");
+    if (tmp) {
+        if ((tmp->type != cJSON_True) && (tmp->type != cJSON_False)) {
+            APP_ERROR("%s: invalid Enable item type\r\n", __func__);
+            return -EPERM;
+        }
+        enable = (tmp->type == cJSON_True);
+    }
+
+    rate_limit.global_rate = DEFAULT_GLOBAL_RATE;
+    rate_limit.global_burst = DEFAULT_GLOBAL_BURST;
+    rate_limit.source_rate = DEFAULT_SOURCE_RATE;
+    rate_limit.source_burst = DEFAULT_SOURCE_BURST;
+    rate_limit.whois_window = DEFAULT_WHOIS_WINDOW;
+    max_source = DEFAULT_MAX_SOURCE;
+
+    rv = rate_limit_get_number(cfg, "Global_Rate", 1, 1000000, &rate_limit.global_rate);
+    rv |= rate_limit_get_number(cfg, "Global_Burst", 1, 1000000, &rate_limit.global_burst);
+    rv |= rate_limit_get_number(cfg, "Source_Rate", 1, 1000000, &rate_limit.source_rate);
+    rv |= rate_limit_get_number(cfg, "Source_Burst", 1, 1000000, &rate_limit.source_burst);
+    rv |= rate_limit_get_number(cfg, "WhoIs_Window", 0, 60000, &rate_limit.whois_window);
+    rv |= rate_limit_get_number(cfg, "Max_Source", MIN_MAX_SOURCE, MAX_MAX_SOURCE, &max_source);
+    if (rv < 0) {
+        return -EPERM;
+    }
+
+    memset(rate_limit.limited, 0, sizeof(rate_limit.limited));
+    tmp = cJSON_GetObjectItem(cfg, "Services");
+    if (tmp == NULL) {
+        /* I-Am answering our own Who-Is feeds the address cache, it is never limited by default */
+        rate_limit.limited[SERVICE_UNCONFIRMED_WHO_HAS] = true;
+        rate_limit.limited[SERVICE_UNCONFIRMED_WHO_IS] = true;
+    } else {
+        if (tmp->type != cJSON_Array) {
+            APP_ERROR("%s: invalid Services item type\r\n", __func__);
+            return -EPERM;
+        }
+
+        cJSON_ArrayForEach(item, tmp) {
+            if ((item->type != cJSON_Number) || (item->valueint < 0)
+                    || (item->valueint >= MAX_BACNET_UNCONFIRMED_SERVICE)) {
+                APP_ERROR("%s: invalid unconfirmed service in Services\r\n", __func__);
+                return -EPERM;
+            }
+            rate_limit.limited[item->valueint] = true;
+        }
+    }
+
+    /* ȡΪ2ݣȡģ */
+    rate_limit.source_mask = MIN_MAX_SOURCE - 1;
+    while (rate_limit.source_mask + 1 < max_source) {
+        rate_limit.source_mask = (rate_limit.source_mask << 1) | 1;
+    }
+
+    rate_limit.sources = (rate_source_t *)calloc(rate_limit.source_mask + 1,
+        sizeof(rate_source_t));
+    if (rate_limit.sources == NULL) {
+        APP_ERROR("%s: calloc source table failed\r\n", __func__);
+        return -EPERM;
+    }
+
+    now = el_current_millisecond();
+    bucket_fill(&rate_limit.global, rate_limit.global_burst, now);
+    memset(rate_limit.whois, 0, sizeof(rate_limit.whois));
+    memset(rate_limit.stat, 0, sizeof(rate_limit.stat));
+    rate_limit.global_dropped = 0;
+    rate_limit.source_dropped = 0;
+    rate_limit.source_evicted = 0;
+    rate_limit.whois_collapsed = 0;
+    rate_limit.enable = enable;
+
+    rate_limit_init_status = true;
+
+    return OK;
+}
+
+void rate_limit_exit(void)
+{
+    if (!rate_limit_init_status) {
+        return;
+    }
+
+    pthread_mutex_lock(&rate_limit.lock);
+
+    rate_limit.enable = false;
+    free(rate_limit.sources);
+    rate_limit.sources = NULL;
+
+    pthread_mutex_unlock(&rate_limit.lock);
+
+    rate_limit_init_status = false;
+}
+
+cJSON *rate_limit_get_status(void)
+{
+    cJSON *result, *services, *tmp;
+    int i;
+
+    result = cJSON_CreateObject();
+    if (result == NULL) {
+        APP_ERROR("%s: create result object failed\r\n", __func__);
+        return NULL;
+    }
+
+    cJSON_AddBoolToObject(result, "enable", rate_limit.enable);
+    if (!rate_limit_init_status) {
+        return result;
+    }
+
+    services = cJSON_CreateArray();
+    if (services == NULL) {
+        APP_ERROR("%s: create services array failed\r\n", __func__);
+        cJSON_Delete(result);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&rate_limit.lock);
+
+    cJSON_AddNumberToObject(result, "global_rate", rate_limit.global_rate);
+    cJSON_AddNumberToObject(result, "global_burst", rate_limit.global_burst);
+    cJSON_AddNumberToObject(result, "source_rate", rate_limit.source_rate);
+    cJSON_AddNumberToObject(result, "source_burst", rate_limit.source_burst);
+    cJSON_AddNumberToObject(result, "whois_window", rate_limit.whois_window);
+    cJSON_AddNumberToObject(result, "global_dropped", rate_limit.global_dropped);
+    cJSON_AddNumberToObject(result, "source_dropped", rate_limit.source_dropped);
+    cJSON_AddNumberToObject(result, "source_evicted", rate_limit.source_evicted);
+    cJSON_AddNumberToObject(result, "whois_collapsed", rate_limit.whois_collapsed);
+
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        if (!rate_limit.limited[i]) {
+            continue;
+        }
+
+        tmp = cJSON_CreateObject();
+        if (tmp == NULL) {
+            APP_ERROR("%s: create service object failed\r\n", __func__);
+            break;
+        }
+        cJSON_AddNumberToObject(tmp, "service", i);
+        cJSON_AddNumberToObject(tmp, "passed", rate_limit.stat[i].passed);
+        cJSON_AddNumberToObject(tmp, "dropped", rate_limit.stat[i].dropped);
+        cJSON_AddItemToArray(services, tmp);
+    }
+
+    pthread_mutex_unlock(&rate_limit.lock);
+
+    cJSON_AddItemToObject(result, "services", services);
+
+    return result;
+}
+
+void rate_limit_reset(void)
+{
+    if (!rate_limit_init_status) {
+        return;
+    }
+
+    pthread_mutex_lock(&rate_limit.lock);
+
+    memset(rate_limit.stat, 0, sizeof(rate_limit.stat));
+    rate_limit.global_dropped = 0;
+    rate_limit.source_dropped = 0;
+    rate_limit.source_evicted = 0;
+    rate_limit.whois_collapsed = 0;
+
+    pthread_mutex_unlock(&rate_limit.lock);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * ratelimit_def.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Rate limit of inbound unconfirmed services
+ *
+ * History
+ */
+
+#ifndef _RATELIMIT_DEF_H_
+#define _RATELIMIT_DEF_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "bacnet/ratelimit.h"
+#include "bacnet/bacenum.h"
+
+#define TOKEN_UNIT                          (1000)
+
+#define DEFAULT_GLOBAL_RATE                 (500)
+#define DEFAULT_GLOBAL_BURST                (1000)
+#define DEFAULT_SOURCE_RATE                 (20)
+#define DEFAULT_SOURCE_BURST                (50)
+#define DEFAULT_WHOIS_WINDOW                (1000)
+
+#define MIN_MAX_SOURCE                      (16)
+#define DEFAULT_MAX_SOURCE                  (256)
+#define MAX_MAX_SOURCE                      (65536)
+
+/* ԴַѰַ̽ⳤ */
+#define SOURCE_PROBE_LIMIT                  (8)
+
+#define WHOIS_COLLAPSE_BITS                 (5)
+#define WHOIS_COLLAPSE_SIZE                 (1 << WHOIS_COLLAPSE_BITS)
+
+typedef struct token_bucket_s {
+    uint32_t tokens;                        /* 1/TOKEN_UNITΪλ */
+    uint32_t stamp;                         /* ϴβƵʱ(ms) */
+} token_bucket_t;
+
+typedef struct rate_source_s {
+    bacnet_addr_t addr;
+    uint8_t used;
+    token_bucket_t bucket;
+} rate_source_t;
+
+typedef struct whois_reply_s {
+    uint16_t net;
+    uint8_t used;
+    uint32_t stamp;                         /* ϴӦI-Amʱ(ms) */
+} whois_reply_t;
+
+typedef struct rate_limit_stat_s {
+    uint32_t passed;
+    uint32_t dropped;
+} rate_limit_stat_t;
+
+typedef struct rate_limit_s {
+    pthread_mutex_t lock;
+    bool enable;
+    uint32_t global_rate;                   /* ÿ */
+    uint32_t global_burst;
+    uint32_t source_rate;
+    uint32_t source_burst;
+    uint32_t whois_window;                  /* ms, 0ʾϲ */
+    bool limited[MAX_BACNET_UNCONFIRMED_SERVICE];
+    token_bucket_t global;
+    uint32_t source_mask;
+    rate_source_t *sources;
+    whois_reply_t whois[WHOIS_COLLAPSE_SIZE];
+    rate_limit_stat_t stat[MAX_BACNET_UNCONFIRMED_SERVICE];
+    uint32_t global_dropped;
+    uint32_t source_dropped;
+    uint32_t source_evicted;
+    uint32_t whois_collapsed;
+} rate_limit_t;
+
+#endif /* _RATELIMIT_DEF_H_ */
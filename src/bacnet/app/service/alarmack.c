@@ -0,0 +1,154 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * alarmack.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * AcknowledgeAlarm
+ *
+ * History
+ */
+
+#include <string.h>
+
+#include "bacnet/service/error.h"
+#include "bacnet/service/abort.h"
+#include "bacnet/service/reject.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/service/alarmack.h"
+#include "bacnet/object/intrinsic.h"
+#include "bacnet/app.h"
+
+static int alarm_ack_decode_service_request(uint8_t *apdu, uint32_t apdu_len,
+            BACNET_ALARM_ACK_DATA *data)
+{
+    uint8_t tag_number;
+    uint32_t value;
+    int dec_len;
+    int len;
+
+    /* Tag 0: acknowledgingProcessIdentifier */
+    len = decode_context_unsigned(apdu, 0, &data->ackProcessIdentifier);
+    if (len < 0) {
+        goto invalid_tag;
+    }
+
+    /* Tag 1: eventObjectIdentifier */
+    dec_len = decode_context_object_id(&apdu[len], 1, &data->eventObjectType,
+        &data->eventObjectInstance);
+    if (dec_len < 0) {
+        goto invalid_tag;
+    }
+    len += dec_len;
+
+    /* Tag 2: eventStateAcknowledged */
+    dec_len = decode_context_enumerated(&apdu[len], 2, &value);
+    if (dec_len < 0) {
+        goto invalid_tag;
+    }
+    len += dec_len;
+    data->eventStateAcked = (BACNET_EVENT_STATE)value;
+
+    /* Tag 3: timeStamp */
+    dec_len = decode_context_timestamp(&apdu[len], 3, &data->eventTimeStamp);
+    if (dec_len < 0) {
+        goto invalid_tag;
+    }
+    len += dec_len;
+
+    /* Tag 4: acknowledgmentSource, only skipped */
+    if (!decode_has_context_tag(&apdu[len], 4)) {
+        goto invalid_tag;
+    }
+    dec_len = decode_tag_number_and_value(&apdu[len], &tag_number, &value);
+    if (dec_len < 0) {
+        goto invalid_tag;
+    }
+    len += dec_len + value;
+
+    /* Tag 5: timeOfAcknowledgment */
+    dec_len = decode_context_timestamp(&apdu[len], 5, &data->ackTimeStamp);
+    if (dec_len < 0) {
+        goto invalid_tag;
+    }
+    len += dec_len;
+
+    if (len != apdu_len) {
+        APP_ERROR("%s: invalid service request length(%d)\r\n", __func__, len);
+        data->reject_reason = REJECT_REASON_INVALID_TAG;
+        return BACNET_STATUS_REJECT;
+    }
+
+    return len;
+
+invalid_tag:
+    APP_ERROR("%s: decode failed at offset %d\r\n", __func__, len);
+    data->reject_reason = REJECT_REASON_INVALID_TAG;
+    return BACNET_STATUS_REJECT;
+}
+
+void handler_alarm_ack(BACNET_CONFIRMED_SERVICE_DATA *service_data, bacnet_buf_t *reply_apdu,
+        bacnet_addr_t *src)
+{
+    BACNET_ALARM_ACK_DATA data;
+    BACNET_ERROR_CODE error_code;
+    int len;
+
+    memset(&data, 0, sizeof(data));
+    len = alarm_ack_decode_service_request(service_data->service_request,
+        service_data->service_request_len, &data);
+    if (len < 0) {
+        APP_ERROR("%s: decode service request failed(%d)\r\n", __func__, len);
+        goto failed;
+    }
+
+    if (data.eventStateAcked > EVENT_STATE_LOW_LIMIT) {
+        data.error_class = ERROR_CLASS_SERVICES;
+        data.error_code = ERROR_CODE_INVALID_EVENT_STATE;
+        len = BACNET_STATUS_ERROR;
+        goto failed;
+    }
+
+    error_code = intrinsic_acknowledge(data.eventObjectType, data.eventObjectInstance,
+        data.eventStateAcked, &data.eventTimeStamp);
+    if (error_code != MAX_BACNET_ERROR_CODE) {
+        data.error_class = (error_code == ERROR_CODE_UNKNOWN_OBJECT)? ERROR_CLASS_OBJECT:
+            ERROR_CLASS_SERVICES;
+        data.error_code = error_code;
+        len = BACNET_STATUS_ERROR;
+        goto failed;
+    }
+
+    len = encode_simple_ack(reply_apdu->data, service_data->invoke_id,
+        SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM);
+
+    if (len < 0) {
+        goto failed;
+    }
+
+    reply_apdu->data_len = len;
+    return;
+
+failed:
+    reply_apdu->data_len = 0;
+
+    if (len == BACNET_STATUS_ERROR) {
+        len = bacerror_encode_apdu(reply_apdu, service_data->invoke_id,
+            SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM, data.error_class, data.error_code);
+    } else if (len == BACNET_STATUS_ABORT) {
+        len = abort_encode_apdu(reply_apdu, service_data->invoke_id, data.abort_reason, true);
+    } else if (len == BACNET_STATUS_REJECT) {
+        len = reject_encode_apdu(reply_apdu, service_data->invoke_id, data.reject_reason);
+    } else {
+        APP_ERROR("%s: unknown error(%d)\r\n", __func__, len);
+        len = BACNET_STATUS_ERROR;
+    }
+
+    if (len < 0) {
+        reply_apdu->data_len = 0;
+    }
+
+    return;
+}
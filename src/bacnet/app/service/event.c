@@ -0,0 +1,280 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * event.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * ConfirmedEventNotification/UnconfirmedEventNotification
+ *
+ * History
+ */
+
+#include <errno.h>
+
+#include "bacnet/service/event.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/apdu.h"
+#include "bacnet/app.h"
+#include "bacnet/object/device.h"
+
+static void timestamp_to_datetime(time_t when, BACNET_DATE_TIME *bdatetime)
+{
+    struct tm LocalTime;
+
+    if (when == 0) {
+        /* every field unspecified */
+        bdatetime->date.year = 1900 + 0xFF;
+        bdatetime->date.month = 0xFF;
+        bdatetime->date.day = 0xFF;
+        bdatetime->date.wday = 0xFF;
+        datetime_set_time(&bdatetime->time, 0xFF, 0xFF, 0xFF, 0xFF);
+        return;
+    }
+
+    (void)localtime_r(&when, &LocalTime);
+    datetime_set_values(bdatetime, LocalTime.tm_year + 1900, LocalTime.tm_mon + 1,
+        LocalTime.tm_mday, LocalTime.tm_hour, LocalTime.tm_min, LocalTime.tm_sec, 0);
+}
+
+int encode_timestamp(uint8_t *apdu, time_t when)
+{
+    BACNET_DATE_TIME bdatetime;
+    int len;
+
+    timestamp_to_datetime(when, &bdatetime);
+
+    len = encode_opening_tag(apdu, TIME_STAMP_DATETIME);
+    len += encode_application_date(&apdu[len], &bdatetime.date);
+    len += encode_application_time(&apdu[len], &bdatetime.time);
+    len += encode_closing_tag(&apdu[len], TIME_STAMP_DATETIME);
+
+    return len;
+}
+
+int encode_context_timestamp(uint8_t *apdu, uint8_t tag_number, time_t when)
+{
+    int len;
+
+    len = encode_opening_tag(apdu, tag_number);
+    len += encode_timestamp(&apdu[len], when);
+    len += encode_closing_tag(&apdu[len], tag_number);
+
+    return len;
+}
+
+int decode_context_timestamp(const uint8_t *apdu, uint8_t tag_number, BACNET_TIMESTAMP *stamp)
+{
+    int len, dec_len;
+
+    len = decode_opening_tag(apdu, tag_number);
+    if (len < 0) {
+        return -1;
+    }
+
+    if (decode_has_context_tag(&apdu[len], TIME_STAMP_TIME)) {
+        stamp->tag = TIME_STAMP_TIME;
+        dec_len = decode_context_bacnet_time(&apdu[len], TIME_STAMP_TIME, &stamp->value.time);
+    } else if (decode_has_context_tag(&apdu[len], TIME_STAMP_SEQUENCE)) {
+        stamp->tag = TIME_STAMP_SEQUENCE;
+        dec_len = decode_context_unsigned(&apdu[len], TIME_STAMP_SEQUENCE,
+            &stamp->value.sequenceNum);
+    } else {
+        stamp->tag = TIME_STAMP_DATETIME;
+        dec_len = decode_opening_tag(&apdu[len], TIME_STAMP_DATETIME);
+        if (dec_len < 0) {
+            return -1;
+        }
+        len += dec_len;
+
+        dec_len = decode_application_date(&apdu[len], &stamp->value.dateTime.date);
+        if (dec_len < 0) {
+            return -1;
+        }
+        len += dec_len;
+
+        dec_len = decode_application_time(&apdu[len], &stamp->value.dateTime.time);
+        if (dec_len < 0) {
+            return -1;
+        }
+        len += dec_len;
+
+        dec_len = decode_closing_tag(&apdu[len], TIME_STAMP_DATETIME);
+    }
+    if (dec_len < 0) {
+        return -1;
+    }
+    len += dec_len;
+
+    dec_len = decode_closing_tag(&apdu[len], tag_number);
+    if (dec_len < 0) {
+        return -1;
+    }
+
+    return len + dec_len;
+}
+
+bool timestamp_match(const BACNET_TIMESTAMP *stamp, time_t when)
+{
+    BACNET_DATE_TIME bdatetime;
+
+    timestamp_to_datetime(when, &bdatetime);
+
+    switch (stamp->tag) {
+    case TIME_STAMP_TIME:
+        return (stamp->value.time.hour == bdatetime.time.hour)
+            && (stamp->value.time.min == bdatetime.time.min)
+            && (stamp->value.time.sec == bdatetime.time.sec);
+
+    case TIME_STAMP_DATETIME:
+        return (stamp->value.dateTime.date.year == bdatetime.date.year)
+            && (stamp->value.dateTime.date.month == bdatetime.date.month)
+            && (stamp->value.dateTime.date.day == bdatetime.date.day)
+            && (stamp->value.dateTime.time.hour == bdatetime.time.hour)
+            && (stamp->value.dateTime.time.min == bdatetime.time.min)
+            && (stamp->value.dateTime.time.sec == bdatetime.time.sec);
+
+    default:
+        /* we never hand out sequence number stamps */
+        return false;
+    }
+}
+
+static int event_encode_status_flags(uint8_t *pdu, uint8_t tag_number, uint8_t flags)
+{
+    BACNET_BIT_STRING bit_string;
+    uint8_t tmpbuf[4] = {0};
+    int i;
+
+    bitstring_init(&bit_string, tmpbuf, 4);
+    for (i = STATUS_FLAG_IN_ALARM; i <= STATUS_FLAG_OUT_OF_SERVICE; i++) {
+        bitstring_set_bit(&bit_string, i, (flags & (1 << i)) != 0);
+    }
+
+    return encode_context_bitstring(pdu, tag_number, &bit_string);
+}
+
+int event_notify_encode_service_request(uint8_t *pdu, BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    int len;
+
+    if ((pdu == NULL) || (data == NULL)) {
+        APP_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    /* Tag 0: processIdentifier */
+    len = encode_context_unsigned(pdu, 0, data->processIdentifier);
+
+    /* Tag 1: initiatingDeviceIdentifier */
+    len += encode_context_object_id(&pdu[len], 1, OBJECT_DEVICE, device_object_instance_number());
+
+    /* Tag 2: eventObjectIdentifier */
+    len += encode_context_object_id(&pdu[len], 2, data->eventObjectType, data->eventObjectInstance);
+
+    /* Tag 3: timeStamp */
+    len += encode_context_timestamp(&pdu[len], 3, data->timeStamp);
+
+    /* Tag 4: notificationClass */
+    len += encode_context_unsigned(&pdu[len], 4, data->notificationClass);
+
+    /* Tag 5: priority */
+    len += encode_context_unsigned(&pdu[len], 5, data->priority);
+
+    /* Tag 6: eventType */
+    len += encode_context_enumerated(&pdu[len], 6, data->eventType);
+
+    /* Tag 7: messageText is optional and not sent */
+
+    /* Tag 8: notifyType */
+    len += encode_context_enumerated(&pdu[len], 8, data->notifyType);
+
+    if (data->notifyType == NOTIFY_ACK_NOTIFICATION) {
+        /* Tag 11: toState, the rest is absent in an ack notification */
+        len += encode_context_enumerated(&pdu[len], 11, data->toState);
+        return len;
+    }
+
+    /* Tag 9: AckRequired */
+    len += encode_context_boolean(&pdu[len], 9, data->ackRequired);
+
+    /* Tag 10: fromState */
+    len += encode_context_enumerated(&pdu[len], 10, data->fromState);
+
+    /* Tag 11: toState */
+    len += encode_context_enumerated(&pdu[len], 11, data->toState);
+
+    /* Tag 12: eventValues */
+    len += encode_opening_tag(&pdu[len], 12);
+    len += encode_opening_tag(&pdu[len], data->eventType);
+    switch (data->eventType) {
+    case EVENT_CHANGE_OF_STATE:
+        len += encode_opening_tag(&pdu[len], 0);
+        len += encode_context_unsigned(&pdu[len], data->values.changeOfState.tag,
+            data->values.changeOfState.state);
+        len += encode_closing_tag(&pdu[len], 0);
+        len += event_encode_status_flags(&pdu[len], 1, data->statusFlags);
+        break;
+
+    case EVENT_OUT_OF_RANGE:
+        len += encode_context_real(&pdu[len], 0, data->values.outOfRange.exceedingValue);
+        len += event_encode_status_flags(&pdu[len], 1, data->statusFlags);
+        len += encode_context_real(&pdu[len], 2, data->values.outOfRange.deadband);
+        len += encode_context_real(&pdu[len], 3, data->values.outOfRange.exceededLimit);
+        break;
+
+    default:
+        APP_ERROR("%s: unsupported event type(%d)\r\n", __func__, data->eventType);
+        return -EPERM;
+    }
+    len += encode_closing_tag(&pdu[len], data->eventType);
+    len += encode_closing_tag(&pdu[len], 12);
+
+    return len;
+}
+
+int cevent_notify_encode_apdu(bacnet_buf_t *apdu, uint8_t invoke_id,
+        BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    int head_len, service_len;
+
+    head_len = apdu_encode_confirmed_service_request(apdu, invoke_id,
+        SERVICE_CONFIRMED_EVENT_NOTIFICATION);
+    if (head_len < 0) {
+        APP_ERROR("%s: encode req header failed\r\n", __func__);
+        return head_len;
+    }
+
+    service_len = event_notify_encode_service_request(&apdu->data[apdu->data_len], data);
+    if (service_len < 0) {
+        APP_ERROR("%s: encode req service failed\r\n", __func__);
+        return service_len;
+    }
+    apdu->data_len += service_len;
+
+    return head_len + service_len;
+}
+
+int uevent_notify_encode_apdu(bacnet_buf_t *apdu, BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    uint8_t *pdu;
+    int len;
+
+    if (apdu == NULL) {
+        APP_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    pdu = apdu->data;
+    pdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST << 4;
+    pdu[1] = SERVICE_UNCONFIRMED_EVENT_NOTIFICATION;
+
+    len = event_notify_encode_service_request(&pdu[2], data);
+    if (len < 0) {
+        APP_ERROR("%s: encode req service failed\r\n", __func__);
+        return len;
+    }
+    apdu->data_len = len + 2;
+
+    return apdu->data_len;
+}
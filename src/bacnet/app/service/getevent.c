@@ -0,0 +1,71 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * getevent.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * GetEventInformation
+ *
+ * History
+ */
+
+#include "bacnet/service/error.h"
+#include "bacnet/service/abort.h"
+#include "bacnet/service/reject.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/service/getevent.h"
+#include "bacnet/object/intrinsic.h"
+#include "bacnet/app.h"
+
+void handler_get_event_information(BACNET_CONFIRMED_SERVICE_DATA *service_data,
+        bacnet_buf_t *reply_apdu, bacnet_addr_t *src)
+{
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    uint8_t *pdu;
+    bool more;
+    int max_len;
+    int len;
+
+    /* Tag 0: Optional lastReceivedObjectIdentifier */
+    object_type = MAX_BACNET_OBJECT_TYPE;
+    object_instance = 0;
+    if (service_data->service_request_len > 0) {
+        len = decode_context_object_id(service_data->service_request, 0, &object_type,
+            &object_instance);
+        if ((len < 0) || (len != service_data->service_request_len)) {
+            APP_ERROR("%s: decode service request failed(%d)\r\n", __func__, len);
+            len = reject_encode_apdu(reply_apdu, service_data->invoke_id,
+                REJECT_REASON_INVALID_TAG);
+            if (len < 0) {
+                reply_apdu->data_len = 0;
+            }
+            return;
+        }
+    }
+
+    pdu = reply_apdu->data;
+    pdu[0] = PDU_TYPE_COMPLEX_ACK << 4;
+    pdu[1] = service_data->invoke_id;
+    pdu[2] = SERVICE_CONFIRMED_GET_EVENT_INFORMATION;
+    len = 3;
+
+    /* Tag 0: listOfEventSummaries */
+    len += encode_opening_tag(&pdu[len], 0);
+
+    /* room for the closing tag and moreEvents */
+    max_len = reply_apdu->end - reply_apdu->data - len - 3;
+
+    len += intrinsic_encode_event_summaries(&pdu[len], max_len, object_type, object_instance,
+        &more);
+    len += encode_closing_tag(&pdu[len], 0);
+
+    /* Tag 1: moreEvents */
+    len += encode_context_boolean(&pdu[len], 1, more);
+
+    reply_apdu->data_len = len;
+
+    return;
+}
@@ -231,7 +231,6 @@ static int rr_decode_service_request(uint8_t *apdu, uint32_t apdu_len,
 
 int rr_ack_decode(uint8_t *apdu, uint16_t apdu_len, BACNET_READ_RANGE_DATA *rrdata)
 {
-    uint32_t len_value_type;
     int dec_len;
     int len;
 
@@ -279,32 +278,22 @@ int rr_ack_decode(uint8_t *apdu, uint16_t apdu_len, BACNET_READ_RANGE_DATA *rrda
     len += dec_len;
 
     /* Tag 5: Item data */
-    dec_len = decode_opening_tag(&apdu[len], 5);
+    if (len >= apdu_len) {
+        APP_ERROR("%s: missing Item Data\r\n", __func__);
+        return -EPERM;
+    }
+
+    /* Setup the start position and length of the data returned from the request,
+     * items may be constructed (log records are), so skip them as a whole */
+    dec_len = decode_constructed_tag(&apdu[len], apdu_len - len, 5);
     if (dec_len < 0) {
-        APP_ERROR("%s: decode Item Data opending tag failed(%d)\r\n", __func__, dec_len);
-        return dec_len;
+        APP_ERROR("%s: decode Item Data failed(%d)\r\n", __func__, dec_len);
+        return -EPERM;
     }
+    rrdata->rpdata.application_data = &apdu[len] + CONTEXT_TAG_LENGTH(5);
+    rrdata->rpdata.application_data_len = dec_len - CONTEXT_TAG_LENGTH(5) * 2;
     len += dec_len;
     
-    /* Setup the start position and length of the data returned from the request
-     * don't decode the application tag number or its data here */
-    rrdata->rpdata.application_data = &apdu[len];
-    dec_len = len;
-    while (len < apdu_len) {
-        if (decode_closing_tag(&apdu[len], 5) > 0) {
-            rrdata->rpdata.application_data_len = len - dec_len;
-            len++;          /* Step over single byte closing tag */
-            break;
-        } else {
-            /* Don't care about tag number, just skipping over anyway */
-            len += decode_tag_number_and_value(&apdu[len], NULL, &len_value_type);
-            len += len_value_type;      /* Skip over data value as well */
-            if (len >= apdu_len) {      /* APDU is exhausted so we have failed to find closing tag */
-                return -EPERM;
-            }
-        }
-    }
-    
     /* Tag 6: firstSequenceNumber */
     if (len < apdu_len) {
         dec_len = decode_context_unsigned(&apdu[len], 6, &rrdata->FirstSequence);
@@ -18,6 +18,7 @@
 #include "bacnet/network.h"
 #include "bacnet/app.h"
 #include "bacnet/slaveproxy.h"
+#include "bacnet/ratelimit.h"
 
 int whois_decode_service_request(uint8_t *pdu, uint16_t pdu_len, uint32_t *pLow_limit,
             uint32_t *pHigh_limit)
@@ -84,17 +85,26 @@ void handler_who_is(uint8_t *request, uint16_t request_len, bacnet_addr_t *src)
 
     if ((request == NULL) || (src == NULL)) {
         APP_ERROR("%s: invalid argument\r\n", __func__);
+        return;
     }
     
     len = whois_decode_service_request(request, request_len, &low_limit, &high_limit);    
     if (len < 0) {
         APP_ERROR("%s: decode service request failed(%d)\r\n", __func__, len);
+        return;
     }
 
-    if ((device_object_instance_number() >= low_limit)
-            && (device_object_instance_number() <= high_limit)) {
-        Send_I_Am_Remote(src->net);
+    if ((device_object_instance_number() < low_limit)
+            || (device_object_instance_number() > high_limit)) {
+        return;
     }
+
+    /* 㲥I-Amκϲ */
+    if (rate_limit_whois_collapse(src->net)) {
+        return;
+    }
+
+    Send_I_Am_Remote(src->net);
 }
 
 /* encode who_is service:  use -1 for limit if you want unlimited */
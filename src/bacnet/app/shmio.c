@@ -0,0 +1,582 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * shmio.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Shared-memory present value interface for local I/O processes. Field I/O
+ * updates AI/BI present values, reliability and override through a mmapped
+ * region keyed by slot index; the stack picks them up in batches on the event
+ * loop and publishes present values, status flags and AO/BO priority arrays
+ * back into the same slots.
+ *
+ * History
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "shmio_def.h"
+#include "bacnet/app.h"
+#include "bacnet/bactext.h"
+#include "bacnet/object/ai.h"
+#include "bacnet/object/ao.h"
+#include "bacnet/object/bi.h"
+#include "bacnet/object/bo.h"
+#include "bacnet/object/intrinsic.h"
+
+static shmio_t shmio;
+
+static bool shmio_init_status = false;
+
+static uint64_t shmio_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static object_seor_t *shmio_slot_seor(object_instance_t *object)
+{
+    return container_of(object, object_seor_t, base);
+}
+
+static void shmio_apply_input(shmio_slot_t *slot, object_instance_t *object, uint32_t flags,
+                float value, uint32_t reliability)
+{
+    object_seor_t *seor;
+    object_bi_t *bi;
+    BACNET_BINARY_PV pv;
+    bool fault_changed;
+
+    seor = shmio_slot_seor(object);
+
+    object_write_lock(object);
+
+    /* Out_Of_ServiceʱPresent_ValueReliabilityֳ */
+    if (seor->Out_Of_Service) {
+        goto out;
+    }
+
+    fault_changed = (seor->Reliability != reliability);
+    seor->Reliability = reliability;
+    seor->Overridden = (flags & SHMIO_IN_OVERRIDDEN)? 1: 0;
+
+    if (!(flags & SHMIO_IN_VALUE)) {
+        goto refresh;
+    }
+
+    switch (slot->type) {
+    case OBJECT_ANALOG_INPUT:
+        container_of(seor, object_ai_t, base)->present = value;
+        intrinsic_report_analog(seor, value);
+        break;
+
+    case OBJECT_BINARY_INPUT:
+        bi = container_of(seor, object_bi_t, base);
+        pv = (value != 0.0f)? BINARY_ACTIVE: BINARY_INACTIVE;
+        if (bi->polarity == POLARITY_REVERSE) {
+            pv = (pv == BINARY_ACTIVE)? BINARY_INACTIVE: BINARY_ACTIVE;
+        }
+        bi->present = pv;
+        intrinsic_report_discrete(seor, pv);
+        break;
+
+    default:
+        break;
+    }
+
+refresh:
+    if (fault_changed) {
+        intrinsic_report_refresh(seor);
+    }
+
+out:
+    object_write_unlock(object);
+}
+
+static void shmio_poll_inputs(void)
+{
+    shmio_slot_t *slot;
+    uint32_t start, flags, reliability;
+    float value;
+    uint32_t i;
+    int retry;
+
+    for (i = 0; i < shmio.slot_count; i++) {
+        slot = shmio_slot(shmio.header, i);
+        if (__atomic_load_n(&slot->in_seq, __ATOMIC_RELAXED) == shmio.in_seen[i]) {
+            continue;
+        }
+
+        for (retry = 0; retry < SHMIO_READ_RETRY; retry++) {
+            if (!shmio_seq_read_begin(&slot->in_seq, &start)) {
+                continue;
+            }
+            flags = slot->in_flags;
+            value = slot->in_value;
+            reliability = slot->in_reliability;
+            if (shmio_seq_read_end(&slot->in_seq, start)) {
+                break;
+            }
+        }
+
+        if (retry == SHMIO_READ_RETRY) {
+            shmio.stat.busy++;
+            continue;
+        }
+
+        shmio.in_seen[i] = start;
+        shmio_apply_input(slot, shmio.objects[i], flags, value, reliability);
+        shmio.stat.applied++;
+    }
+}
+
+static void shmio_fill_output(shmio_slot_t *out, shmio_slot_t *slot, object_instance_t *object)
+{
+    object_seor_t *seor;
+    object_ao_t *ao;
+    object_bo_t *bo;
+    int i;
+
+    memset(out, 0, sizeof(*out));
+
+    seor = shmio_slot_seor(object);
+    if (seor->Event_State != EVENT_STATE_NORMAL) {
+        out->out_flags |= SHMIO_OUT_IN_ALARM;
+    }
+    if (seor->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        out->out_flags |= SHMIO_OUT_FAULT;
+    }
+    if (seor->Overridden) {
+        out->out_flags |= SHMIO_OUT_OVERRIDDEN;
+    }
+    if (seor->Out_Of_Service) {
+        out->out_flags |= SHMIO_OUT_OUT_OF_SERVICE;
+    }
+    out->out_reliability = seor->Reliability;
+
+    switch (slot->type) {
+    case OBJECT_ANALOG_INPUT:
+        out->out_value = container_of(seor, object_ai_t, base)->present;
+        break;
+
+    case OBJECT_BINARY_INPUT:
+        out->out_value = container_of(seor, object_bi_t, base)->present;
+        break;
+
+    case OBJECT_ANALOG_OUTPUT:
+        ao = container_of(seor, object_ao_t, base.base);
+        out->out_value = ao->base.present;
+        out->out_priority = (ao->active_bit < BACNET_MAX_PRIORITY)? ao->active_bit + 1: 0;
+        out->out_priority_bits = ao->priority_bits;
+        for (i = 0; i < SHMIO_PRIORITY_NUM; i++) {
+            if (ao->priority_bits & (1 << i)) {
+                out->out_priority_array[i] = ao->priority_array[i];
+            }
+        }
+        break;
+
+    case OBJECT_BINARY_OUTPUT:
+        bo = container_of(seor, object_bo_t, base.base);
+        out->out_value = bo->base.present;
+        out->out_priority = (bo->active_bit < BACNET_MAX_PRIORITY)? bo->active_bit + 1: 0;
+        out->out_priority_bits = bo->priority_bits;
+        for (i = 0; i < SHMIO_PRIORITY_NUM; i++) {
+            if (bo->priority_bits & (1 << i)) {
+                out->out_priority_array[i] = bo->priority_array[i];
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* ֻЭջдout_*ֱϴηֵȽ */
+static bool shmio_publish_slot(uint32_t index)
+{
+    shmio_slot_t *slot, out;
+    object_instance_t *object;
+    const size_t offset = offsetof(shmio_slot_t, out_flags);
+    uint32_t seq;
+    int retry;
+
+    slot = shmio_slot(shmio.header, index);
+    object = shmio.objects[index];
+
+    /* BACnetдʱض, һֱæ */
+    for (retry = 0; retry < SHMIO_READ_RETRY; retry++) {
+        seq = object_read_begin(object);
+        shmio_fill_output(&out, slot, object);
+        if (!object_read_retry(object, seq)) {
+            break;
+        }
+    }
+    if (retry == SHMIO_READ_RETRY) {
+        object_write_lock(object);
+        shmio_fill_output(&out, slot, object);
+        object_write_unlock(object);
+    }
+    if (!memcmp((uint8_t *)slot + offset, (uint8_t *)&out + offset, sizeof(out) - offset)) {
+        return false;
+    }
+
+    shmio_seq_write_begin(&slot->out_seq);
+    memcpy((uint8_t *)slot + offset, (uint8_t *)&out + offset, sizeof(out) - offset);
+    shmio_seq_write_end(&slot->out_seq);
+
+    return true;
+}
+
+/*
+ * AO/BOֵÿֶAI/BIֵI/Oֻ״̬
+ * ÿתһΣʱÿȫȽ
+ */
+static void shmio_publish_outputs(void)
+{
+    uint32_t published;
+    uint32_t i;
+
+    published = 0;
+    for (i = 0; i < shmio.output_count; i++) {
+        if (shmio_publish_slot(shmio.outputs[i])) {
+            published++;
+        }
+    }
+
+    for (i = 0; (i < SHMIO_SWEEP_SLOTS) && (i < shmio.slot_count); i++) {
+        if (++shmio.sweep >= shmio.slot_count) {
+            shmio.sweep = 0;
+        }
+        if (shmio_publish_slot(shmio.sweep)) {
+            published++;
+        }
+    }
+
+    if (published) {
+        __atomic_add_fetch(&shmio.header->out_commit, 1, __ATOMIC_RELEASE);
+        shmio.stat.published += published;
+    }
+}
+
+void shmio_poll(void)
+{
+    uint64_t begin;
+    uint32_t commit, used;
+
+    if (!shmio_init_status) {
+        return;
+    }
+
+    begin = shmio_now_us();
+    shmio.stat.polls++;
+
+    commit = __atomic_load_n(&shmio.header->in_commit, __ATOMIC_ACQUIRE);
+    if (commit != shmio.in_commit) {
+        shmio.in_commit = commit;
+        shmio.stat.batches++;
+        shmio_poll_inputs();
+    }
+
+    shmio_publish_outputs();
+
+    used = (uint32_t)(shmio_now_us() - begin);
+    if (used > shmio.stat.max_poll_us) {
+        shmio.stat.max_poll_us = used;
+    }
+}
+
+static void shmio_poll_timer(el_timer_t *timer)
+{
+    shmio_poll();
+
+    (void)el_timer_mod(&el_default_loop, timer, shmio.poll_interval);
+}
+
+static int shmio_parse_slots(cJSON *array)
+{
+    cJSON *item, *tmp;
+    object_instance_t *object;
+    int type;
+    uint32_t i;
+
+    shmio.slot_count = cJSON_GetArraySize(array);
+    if ((shmio.slot_count == 0) || (shmio.slot_count > SHMIO_MAX_SLOT)) {
+        APP_ERROR("%s: Slot_List should have 1~%d items\r\n", __func__, SHMIO_MAX_SLOT);
+        return -EPERM;
+    }
+
+    shmio.objects = (object_instance_t **)calloc(shmio.slot_count, sizeof(object_instance_t *));
+    shmio.in_seen = (uint32_t *)calloc(shmio.slot_count, sizeof(uint32_t));
+    shmio.outputs = (uint32_t *)calloc(shmio.slot_count, sizeof(uint32_t));
+    if ((shmio.objects == NULL) || (shmio.in_seen == NULL) || (shmio.outputs == NULL)) {
+        APP_ERROR("%s: calloc failed\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    i = 0;
+    cJSON_ArrayForEach(item, array) {
+        if (item->type != cJSON_Object) {
+            APP_ERROR("%s: invalid Slot_List[%d] item type\r\n", __func__, i);
+            return -EPERM;
+        }
+
+        tmp = cJSON_GetObjectItem(item, "Type");
+        if ((tmp == NULL) || (tmp->type != cJSON_String)) {
+            APP_ERROR("%s: get Slot_List[%d] Type item failed\r\n", __func__, i);
+            return -EPERM;
+        }
+
+        type = bactext_get_object_type_from_name(tmp->valuestring);
+        if ((type != OBJECT_ANALOG_INPUT) && (type != OBJECT_ANALOG_OUTPUT)
+                && (type != OBJECT_BINARY_INPUT) && (type != OBJECT_BINARY_OUTPUT)) {
+            APP_ERROR("%s: Slot_List[%d] Type(%s) should be AI/AO/BI/BO\r\n", __func__, i,
+                tmp->valuestring);
+            return -EPERM;
+        }
+
+        tmp = cJSON_GetObjectItem(item, "Instance");
+        if ((tmp == NULL) || (tmp->type != cJSON_Number) || (tmp->valueint < 0)) {
+            APP_ERROR("%s: get Slot_List[%d] Instance item failed\r\n", __func__, i);
+            return -EPERM;
+        }
+
+        object = object_find((BACNET_OBJECT_TYPE)type, (uint32_t)tmp->valueint);
+        if (object == NULL) {
+            APP_ERROR("%s: Slot_List[%d] object(%s, %d) not found\r\n", __func__, i,
+                bactext_object_type_name(type), tmp->valueint);
+            return -EPERM;
+        }
+
+        if ((type == OBJECT_ANALOG_OUTPUT) || (type == OBJECT_BINARY_OUTPUT)) {
+            shmio.outputs[shmio.output_count++] = i;
+        }
+        shmio.objects[i++] = object;
+    }
+
+    return OK;
+}
+
+/*
+ * ѴҲͬԭظãδĲλI/Oд룬
+ * ЭջI/O̲ӳ
+ */
+static int shmio_map(void)
+{
+    shmio_header_t *header;
+    shmio_slot_t *slot;
+    uint32_t generation;
+    bool reuse;
+    uint32_t i;
+    int fd;
+
+    shmio.map_size = sizeof(shmio_header_t) + shmio.slot_count * sizeof(shmio_slot_t);
+
+    fd = shm_open(shmio.name, O_RDWR | O_CREAT, 0660);
+    if (fd < 0) {
+        APP_ERROR("%s: shm_open %s failed(%d)\r\n", __func__, shmio.name, errno);
+        return -EPERM;
+    }
+
+    if (ftruncate(fd, shmio.map_size) < 0) {
+        APP_ERROR("%s: ftruncate %s failed(%d)\r\n", __func__, shmio.name, errno);
+        close(fd);
+        return -EPERM;
+    }
+
+    header = (shmio_header_t *)mmap(NULL, shmio.map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0);
+    close(fd);
+    if (header == MAP_FAILED) {
+        APP_ERROR("%s: mmap %s failed(%d)\r\n", __func__, shmio.name, errno);
+        return -EPERM;
+    }
+
+    reuse = (header->magic == SHMIO_MAGIC) && (header->version == SHMIO_VERSION)
+        && (header->slot_size == sizeof(shmio_slot_t));
+    generation = reuse? header->generation + 1: 1;
+    
+    /* magic, I/O̿magicЧʱλ */
+    __atomic_store_n(&header->magic, 0, __ATOMIC_RELEASE);
+
+    for (i = 0; i < shmio.slot_count; i++) {
+        slot = shmio_slot(header, i);
+        if (!reuse || (i >= header->slot_count) || (slot->type != shmio.objects[i]->type->type)
+                || (slot->instance != shmio.objects[i]->instance)) {
+            memset(slot, 0, sizeof(*slot));
+            slot->type = shmio.objects[i]->type->type;
+            slot->instance = shmio.objects[i]->instance;
+        }
+        /* ǿƶȡһе */
+        shmio.in_seen[i] = slot->in_seq + 1;
+    }
+
+    header->version = SHMIO_VERSION;
+    header->slot_count = shmio.slot_count;
+    header->slot_size = sizeof(shmio_slot_t);
+    header->generation = generation;
+    __atomic_store_n(&header->magic, SHMIO_MAGIC, __ATOMIC_RELEASE);
+
+    shmio.header = header;
+    shmio.in_commit = header->in_commit - 1;
+
+    return OK;
+}
+
+int shmio_init(cJSON *cfg)
+{
+    cJSON *tmp;
+    const char *name;
+    int rv;
+
+    if (shmio_init_status) {
+        APP_WARN("%s: already inited\r\n", __func__);
+        return OK;
+    }
+
+    if (cfg == NULL) {
+        return OK;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "Enable");
+    if (tmp && (tmp->type != cJSON_True) && (tmp->type != cJSON_False)) {
+        APP_ERROR("%s: Enable should be boolean\r\n", __func__);
+        return -EPERM;
+    }
+    if ((tmp == NULL) || (tmp->type == cJSON_False)) {
+        return OK;
+    }
+
+    memset(&shmio, 0, sizeof(shmio));
+    shmio.poll_interval = SHMIO_DEFAULT_POLL_INTERVAL;
+
+    name = SHMIO_DEFAULT_NAME;
+    tmp = cJSON_GetObjectItem(cfg, "Name");
+    if (tmp) {
+        if ((tmp->type != cJSON_String) || (tmp->valuestring[0] != '/')
+                || (strchr(tmp->valuestring + 1, '/') != NULL)) {
+            APP_ERROR("%s: Name should be like \"/name\"\r\n", __func__);
+            return -EPERM;
+        }
+        name = tmp->valuestring;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "Poll_Interval");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint <= 0)
+                || (tmp->valueint > SHMIO_MAX_POLL_INTERVAL)) {
+            APP_ERROR("%s: Poll_Interval should be 1~%d ms\r\n", __func__,
+                SHMIO_MAX_POLL_INTERVAL);
+            return -EPERM;
+        }
+        shmio.poll_interval = (uint32_t)tmp->valueint;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "Slot_List");
+    if ((tmp == NULL) || (tmp->type != cJSON_Array)) {
+        APP_ERROR("%s: get Slot_List item failed\r\n", __func__);
+        return -EPERM;
+    }
+
+    rv = shmio_parse_slots(tmp);
+    if (rv < 0) {
+        goto out0;
+    }
+
+    shmio.name = strdup(name);
+    if (shmio.name == NULL) {
+        APP_ERROR("%s: strdup failed\r\n", __func__);
+        rv = -ENOMEM;
+        goto out0;
+    }
+
+    rv = shmio_map();
+    if (rv < 0) {
+        goto out0;
+    }
+
+    shmio.timer = el_timer_create(&el_default_loop, shmio.poll_interval);
+    if (shmio.timer == NULL) {
+        APP_ERROR("%s: create poll timer failed\r\n", __func__);
+        rv = -EPERM;
+        goto out1;
+    }
+    shmio.timer->handler = shmio_poll_timer;
+    shmio.timer->data = NULL;
+
+    shmio_init_status = true;
+    APP_VERBOS("%s: %s mapped with %d slots\r\n", __func__, shmio.name, shmio.slot_count);
+
+    return OK;
+
+out1:
+    (void)munmap(shmio.header, shmio.map_size);
+
+out0:
+    free(shmio.name);
+    free(shmio.objects);
+    free(shmio.in_seen);
+    free(shmio.outputs);
+    memset(&shmio, 0, sizeof(shmio));
+
+    return rv;
+}
+
+/* unlinkI/O̵ӳЭջЧ */
+void shmio_exit(void)
+{
+    if (!shmio_init_status) {
+        return;
+    }
+
+    shmio_init_status = false;
+
+    (void)el_timer_destroy(&el_default_loop, shmio.timer);
+    (void)munmap(shmio.header, shmio.map_size);
+    free(shmio.name);
+    free(shmio.objects);
+    free(shmio.in_seen);
+    free(shmio.outputs);
+    memset(&shmio, 0, sizeof(shmio));
+}
+
+cJSON *shmio_get_status(void)
+{
+    cJSON *result;
+
+    result = cJSON_CreateObject();
+    if (result == NULL) {
+        APP_ERROR("%s: create result object failed\r\n", __func__);
+        return NULL;
+    }
+
+    cJSON_AddBoolToObject(result, "enable", shmio_init_status);
+    if (!shmio_init_status) {
+        return result;
+    }
+
+    cJSON_AddStringToObject(result, "name", shmio.name);
+    cJSON_AddNumberToObject(result, "slots", shmio.slot_count);
+    cJSON_AddNumberToObject(result, "generation", shmio.header->generation);
+    cJSON_AddNumberToObject(result, "poll_interval", shmio.poll_interval);
+    cJSON_AddNumberToObject(result, "polls", shmio.stat.polls);
+    cJSON_AddNumberToObject(result, "batches", shmio.stat.batches);
+    cJSON_AddNumberToObject(result, "applied", shmio.stat.applied);
+    cJSON_AddNumberToObject(result, "busy", shmio.stat.busy);
+    cJSON_AddNumberToObject(result, "published", shmio.stat.published);
+    cJSON_AddNumberToObject(result, "max_poll_us", shmio.stat.max_poll_us);
+
+    return result;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * shmio_def.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Shared-memory present value interface for local I/O processes
+ *
+ * History
+ */
+
+#ifndef _SHMIO_DEF_H_
+#define _SHMIO_DEF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/shmio.h"
+#include "bacnet/object/object.h"
+#include "misc/eventloop.h"
+
+#define SHMIO_DEFAULT_NAME                  "/bacnet_io"
+
+#define SHMIO_DEFAULT_POLL_INTERVAL         (10)
+#define SHMIO_MAX_POLL_INTERVAL             (1000)
+
+#define SHMIO_MAX_SLOT                      (65536)
+
+/* AI/BIλÿתĸAO/BOλÿȫ */
+#define SHMIO_SWEEP_SLOTS                   (1024)
+
+/* ʱI/OдԴʧһ */
+#define SHMIO_READ_RETRY                    (4)
+
+typedef struct shmio_stat_s {
+    uint32_t polls;
+    uint32_t batches;                       /* in_commitб仯 */
+    uint32_t applied;                       /* дĲλ */
+    uint32_t busy;                          /* I/OдƳٵĲλ */
+    uint32_t published;                     /* I/OĲλ */
+    uint32_t max_poll_us;
+} shmio_stat_t;
+
+typedef struct shmio_s {
+    char *name;
+    uint32_t poll_interval;                 /* ms */
+    uint32_t slot_count;
+    uint32_t map_size;
+    shmio_header_t *header;
+    object_instance_t **objects;            /* λһһӦ */
+    uint32_t *in_seen;                      /* һζȡin_seq */
+    uint32_t *outputs;                      /* AO/BOλ± */
+    uint32_t output_count;
+    uint32_t sweep;                         /* AI/BIתλ */
+    uint32_t in_commit;
+    el_timer_t *timer;
+    shmio_stat_t stat;
+} shmio_t;
+
+#endif /* _SHMIO_DEF_H_ */
@@ -10,7 +10,9 @@
  * History
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include "tsm_def.h"
@@ -33,6 +35,10 @@ static uint32_t apdu_retries = 3;
 
 static bool tsm_init_status = false;
 
+static int tsm_transaction_perf;
+
+static int tsm_timeout_perf;
+
 static int __address_hash(const bacnet_addr_t *addr)
 {
     const uint8_t *start = (uint8_t *)addr;
@@ -78,6 +84,54 @@ static tsm_invoker_impl_t *__tsm_invoker_find(bacnet_addr_t *addr, uint8_t invok
     return NULL;
 }
 
+/* called with write lock held */
+static void __tsm_perf_record(bacnet_addr_t *addr, uint64_t ns)
+{
+    tsm_peer_perf_t *perf;
+    int code;
+
+    if (tsm_transaction_perf == PERF_INVALID_ID) {
+        tsm_transaction_perf = perf_hist_register("tsm.transaction");
+    }
+    perf_hist_record(tsm_transaction_perf, ns);
+
+    code = __address_hash(addr);
+    hash_for_each_possible(tsm_table.peer_perf_table, perf, node, code) {
+        if (address_equal(&perf->addr, addr)) {
+            perf_hist_add(&perf->hist, ns);
+            return;
+        }
+    }
+
+    if (tsm_table.peer_perf_count >= MAX_PEER_PERF) {
+        return;
+    }
+
+    perf = (tsm_peer_perf_t *)calloc(1, sizeof(tsm_peer_perf_t));
+    if (perf == NULL) {
+        APP_ERROR("%s: calloc failed\r\n", __func__);
+        return;
+    }
+    memcpy(&perf->addr, addr, sizeof(bacnet_addr_t));
+    hash_add(tsm_table.peer_perf_table, &perf->node, code);
+    tsm_table.peer_perf_count++;
+
+    perf_hist_add(&perf->hist, ns);
+}
+
+static void __tsm_perf_clean(void)
+{
+    tsm_peer_perf_t *perf;
+    struct hlist_node *tmp;
+    int bkt;
+
+    hash_for_each_safe(tsm_table.peer_perf_table, bkt, perf, tmp, node) {
+        hash_del(&perf->node);
+        free(perf);
+    }
+    tsm_table.peer_perf_count = 0;
+}
+
 static int tsm_get_free_invokeID(tsm_peer_t *info)
 {
     uint8_t cur_bit;
@@ -145,6 +199,13 @@ static void tsm_invoker_timer(el_timer_t *timer)
     invoker = (tsm_invoker_impl_t *)timer->data;
     el_timer_destroy(&el_default_loop, invoker->timer);
     invoker->timer = NULL;
+
+    if (perf_enabled) {
+        if (tsm_timeout_perf == PERF_INVALID_ID) {
+            tsm_timeout_perf = perf_counter_register("tsm.timeout");
+        }
+        perf_counter_add(tsm_timeout_perf, 1);
+    }
     
     __tsm_free_invokeID(invoker);
     
@@ -363,6 +424,10 @@ void tsm_invoker_callback(bacnet_addr_t *addr, bacnet_buf_t *apdu, BACNET_PDU_TY
             goto out;
         }
         invoker->not_acked_count--;
+
+        if (invoker->last_tx_ns && perf_enabled) {
+            __tsm_perf_record(addr, perf_now_ns() - invoker->last_tx_ns);
+        }
         
         if (invoker->canceled) {
             if (invoker->not_acked_count == 0) {
@@ -435,6 +500,7 @@ int tsm_send_apdu(tsm_invoker_t *invoker, bacnet_buf_t *apdu, bacnet_prio_t prio
         return -EPERM;
     }
 
+    impl_invoker->last_tx_ns = perf_now_ns();
     rv = apdu_send(&invoker->addr, apdu, prio, true);
     if (rv < 0) {
         APP_ERROR("%s: apdu send failed(%d)\r\n", __func__, rv);
@@ -591,6 +657,9 @@ int tsm_init(cJSON *cfg)
     tsm_table.invoker_count = 0;
     hash_init(tsm_table.invoker_table);
 
+    tsm_table.peer_perf_count = 0;
+    hash_init(tsm_table.peer_perf_table);
+
     tsm_init_status = true;
     
     return OK;
@@ -624,6 +693,8 @@ void tsm_exit(void)
     }
     tsm_table.peer_count = 0;
 
+    __tsm_perf_clean();
+
     RWLOCK_UNLOCK(&tsm_table.rwlock);
 
     (void)pthread_rwlock_destroy(&tsm_table.rwlock);
@@ -631,3 +702,55 @@ void tsm_exit(void)
     tsm_init_status = false;
 }
 
+cJSON *tsm_get_perf_status(void)
+{
+    tsm_peer_perf_t *perf;
+    cJSON *result, *tmp;
+    char mac[MAX_MAC_LEN * 3 + 1];
+    int bkt, i, len;
+
+    result = cJSON_CreateArray();
+    if (result == NULL) {
+        APP_ERROR("%s: create result array failed\r\n", __func__);
+        return NULL;
+    }
+
+    if (!tsm_init_status) {
+        return result;
+    }
+
+    RWLOCK_RDLOCK(&tsm_table.rwlock);
+
+    hash_for_each(tsm_table.peer_perf_table, bkt, perf, node) {
+        tmp = perf_hist_to_json(&perf->hist);
+        if (tmp == NULL) {
+            APP_ERROR("%s: create peer object failed\r\n", __func__);
+            break;
+        }
+
+        len = 0;
+        mac[0] = 0;
+        for (i = 0; i < perf->addr.len; i++) {
+            len += sprintf(&mac[len], (i == 0)? "%02X": ".%02X", perf->addr.adr[i]);
+        }
+        cJSON_AddNumberToObject(tmp, "net", perf->addr.net);
+        cJSON_AddStringToObject(tmp, "mac", mac);
+        cJSON_AddItemToArray(result, tmp);
+    }
+
+    RWLOCK_UNLOCK(&tsm_table.rwlock);
+
+    return result;
+}
+
+void tsm_perf_reset(void)
+{
+    if (!tsm_init_status) {
+        return;
+    }
+
+    RWLOCK_WRLOCK(&tsm_table.rwlock);
+    __tsm_perf_clean();
+    RWLOCK_UNLOCK(&tsm_table.rwlock);
+}
+
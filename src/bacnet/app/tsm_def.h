@@ -18,6 +18,7 @@
 #include "bacnet/tsm.h"
 #include "misc/hashtable.h"
 #include "misc/eventloop.h"
+#include "misc/perfstat.h"
 
 #define MIN_MAX_PEER                        (100)
 #define MIN_MAX_INVOKER                     (100)
@@ -28,12 +29,17 @@
 #define PEER_TSM_TABLE_HASH_BITS            (8)
 #define INVOKER_TABLE_HASH_BITS             (9)
 
+/* peers beyond this are only counted in the global histogram */
+#define MAX_PEER_PERF                       (256)
+
 typedef struct tsm_table_s {
     pthread_rwlock_t rwlock;
     int peer_count;
     int invoker_count;
+    int peer_perf_count;
     DECLARE_HASHTABLE(peer_table, PEER_TSM_TABLE_HASH_BITS);
     DECLARE_HASHTABLE(invoker_table, INVOKER_TABLE_HASH_BITS);
+    DECLARE_HASHTABLE(peer_perf_table, PEER_TSM_TABLE_HASH_BITS);
 } tsm_table_t;
 
 typedef struct tsm_peer_s {
@@ -50,9 +56,17 @@ typedef struct tsm_invoker_impl_s {
     bool canceled;
     tsm_peer_t *peer_tsm;
     uint32_t last_tx_timestamp;
+    uint64_t last_tx_ns;
     struct hlist_node node;
     el_timer_t *timer;
 } tsm_invoker_impl_t;
 
+/* request-to-ack latency of a peer, kept after its tsm_peer_t is freed */
+typedef struct tsm_peer_perf_s {
+    bacnet_addr_t addr;
+    struct hlist_node node;
+    perf_hist_t hist;
+} tsm_peer_perf_t;
+
 #endif  /* _TSM_DEF_H_ */
 
@@ -25,54 +25,42 @@ int encode_signed8(uint8_t *pdu, int8_t value)
 
 int encode_signed16(uint8_t *pdu, int16_t value)
 {
-    pdu[0] = (uint8_t)((value & 0xff00) >> 8);
-    pdu[1] = (uint8_t)(value & 0x00ff);
+    bacnet_put_be16(pdu, (uint16_t)value);
 
     return 2;
 }
 
 int encode_signed24(uint8_t *pdu, int32_t value)
 {
-    pdu[0] = (uint8_t)((value & 0xff0000) >> 16);
-    pdu[1] = (uint8_t)((value & 0x00ff00) >> 8);
-    pdu[2] = (uint8_t)(value & 0x0000ff);
+    bacnet_put_be24(pdu, (uint32_t)value);
 
     return 3;
 }
 
 int encode_signed32(uint8_t *pdu, int32_t value)
 {
-    pdu[0] = (uint8_t)((value & 0xff000000) >> 24);
-    pdu[1] = (uint8_t)((value & 0x00ff0000) >> 16);
-    pdu[2] = (uint8_t)((value & 0x0000ff00) >> 8);
-    pdu[3] = (uint8_t)(value & 0x000000ff);
+    bacnet_put_be32(pdu, (uint32_t)value);
 
     return 4;
 }
 
 int encode_unsigned16(uint8_t *pdu, uint16_t value)
 {
-    pdu[0] = (uint8_t)((value & 0xff00) >> 8);
-    pdu[1] = (uint8_t)(value & 0x00ff);
+    bacnet_put_be16(pdu, value);
 
     return 2;
 }
 
 int encode_unsigned24(uint8_t *pdu, uint32_t value)
 {
-    pdu[0] = (uint8_t)((value & 0xff0000) >> 16);
-    pdu[1] = (uint8_t)((value & 0x00ff00) >> 8);
-    pdu[2] = (uint8_t)(value & 0x0000ff);
+    bacnet_put_be24(pdu, value);
 
     return 3;
 }
 
 int encode_unsigned32(uint8_t *pdu, uint32_t value)
 {
-    pdu[0] = (uint8_t)((value & 0xff000000) >> 24);
-    pdu[1] = (uint8_t)((value & 0x00ff0000) >> 16);
-    pdu[2] = (uint8_t)((value & 0x0000ff00) >> 8);
-    pdu[3] = (uint8_t)(value & 0x000000ff);
+    bacnet_put_be32(pdu, value);
 
     return 4;
 }
@@ -80,13 +68,7 @@ int encode_unsigned32(uint8_t *pdu, uint32_t value)
 int decode_signed8(const uint8_t *pdu, int32_t *value)
 {
     if (value) {
-        if (pdu[0] & 0x80) {                /* negative - bit 7 is set */
-            *value = 0xFFFFFF00;
-        } else {
-            *value = 0;
-        }
-        
-        *value |= ((int32_t)(((int32_t)pdu[0]) & 0x000000ff));
+        *value = (int8_t)pdu[0];
     }
 
     return 1;
@@ -95,14 +77,7 @@ int decode_signed8(const uint8_t *pdu, int32_t *value)
 int decode_signed16(const uint8_t *pdu, int32_t *value)
 {
     if (value) {
-        if (pdu[0] & 0x80) {                /* negative - bit 7 is set */
-            *value = 0xFFFF0000;
-        } else {
-            *value = 0;
-        }
-        
-        *value |= ((int32_t)((((int32_t)pdu[0]) << 8) & 0x0000ff00));
-        *value |= ((int32_t)(((int32_t)pdu[1]) & 0x000000ff));
+        *value = (int16_t)bacnet_get_be16(pdu);
     }
 
     return 2;
@@ -111,15 +86,8 @@ int decode_signed16(const uint8_t *pdu, int32_t *value)
 int decode_signed24(const uint8_t *pdu, int32_t *value)
 {
     if (value) {
-        if (pdu[0] & 0x80) {                /* negative - bit 7 is set */
-            *value = 0xFF000000;
-        } else {
-            *value = 0;
-        }
-        
-        *value |= ((int32_t)((((int32_t)pdu[0]) << 16) & 0x00ff0000));
-        *value |= ((int32_t)((((int32_t)pdu[1]) << 8) & 0x0000ff00));
-        *value |= ((int32_t)(((int32_t)pdu[2]) & 0x000000ff));
+        /* sign extend from bit 23 */
+        *value = (int32_t)(bacnet_get_be24(pdu) << 8) >> 8;
     }
 
     return 3;
@@ -128,10 +96,7 @@ int decode_signed24(const uint8_t *pdu, int32_t *value)
 int decode_signed32(const uint8_t *pdu, int32_t *value)
 {
     if (value) {
-        *value = ((int32_t)((((int32_t)pdu[0]) << 24) & 0xff000000));
-        *value |= ((int32_t)((((int32_t)pdu[1]) << 16) & 0x00ff0000));
-        *value |= ((int32_t)((((int32_t)pdu[2]) << 8) & 0x0000ff00));
-        *value |= ((int32_t)(((int32_t)pdu[3]) & 0x000000ff));
+        *value = (int32_t)bacnet_get_be32(pdu);
     }
 
     return 4;
@@ -140,8 +105,7 @@ int decode_signed32(const uint8_t *pdu, int32_t *value)
 int decode_unsigned16(const uint8_t *pdu, uint16_t *value)
 {
     if (value) {
-        *value = (uint16_t)((((uint16_t)pdu[0]) << 8) & 0xff00);
-        *value |= ((uint16_t)(((uint16_t)pdu[1]) & 0x00ff));
+        *value = bacnet_get_be16(pdu);
     }
 
     return 2;
@@ -150,9 +114,7 @@ int decode_unsigned16(const uint8_t *pdu, uint16_t *value)
 int decode_unsigned24(const uint8_t *pdu, uint32_t *value)
 {
     if (value) {
-        *value = ((uint32_t)((((uint32_t)pdu[0]) << 16) & 0x00ff0000));
-        *value |= (uint32_t)((((uint32_t)pdu[1]) << 8) & 0x0000ff00);
-        *value |= ((uint32_t)(((uint32_t)pdu[2]) & 0x000000ff));
+        *value = bacnet_get_be24(pdu);
     }
 
     return 3;
@@ -161,10 +123,7 @@ int decode_unsigned24(const uint8_t *pdu, uint32_t *value)
 int decode_unsigned32(const uint8_t *pdu, uint32_t *value)
 {
     if (value) {
-        *value = ((uint32_t)((((uint32_t)pdu[0]) << 24) & 0xff000000));
-        *value |= ((uint32_t)((((uint32_t)pdu[1]) << 16) & 0x00ff0000));
-        *value |= ((uint32_t)((((uint32_t)pdu[2]) << 8) & 0x0000ff00));
-        *value |= ((uint32_t)(((uint32_t)pdu[3]) & 0x000000ff));
+        *value = bacnet_get_be32(pdu);
     }
 
     return 4;
@@ -25,7 +25,20 @@
 
 static bool bacnet_init_status = false;
 
-cJSON *__attribute__((weak)) bacnet_get_app_cfg(void)
+/* compiled app.conf, so app_startup need not parse the text again */
+#define APP_CFG_IMAGE_MAGIC                 (0x42414931)    /* "BAI1" */
+#define APP_CFG_IMAGE_SUFFIX                ".img"
+
+static char app_cfg_image_file[sizeof("/etc/"BACNET_APP_CONFIG_FILE APP_CFG_IMAGE_SUFFIX)];
+
+static uint64_t app_cfg_key;
+
+/* tree from text which the image is saved from if app_startup succeeds */
+static cJSON *app_cfg_parsed = NULL;
+
+static cJSON *app_cfg_image = NULL;
+
+static cJSON *bacnet_default_app_cfg(void)
 {
     cJSON *cfg;
 
@@ -47,6 +60,93 @@ cJSON *__attribute__((weak)) bacnet_get_app_cfg(void)
     return cfg;
 }
 
+cJSON *bacnet_get_app_cfg(void) __attribute__((weak, alias("bacnet_default_app_cfg")));
+
+cJSON *bacnet_load_app_cfg(void)
+{
+    const char *filename;
+    char *text;
+    cJSON *cfg;
+
+    /* demos and products providing their own config */
+    if (bacnet_get_app_cfg != bacnet_default_app_cfg) {
+        return bacnet_get_app_cfg();
+    }
+
+    filename = BACNET_APP_CONFIG_FILE;
+    text = read_file_to_text(filename);
+    if (text == NULL) {
+        filename = "/etc/"BACNET_APP_CONFIG_FILE;
+        text = read_file_to_text(filename);
+        if (text == NULL) {
+            APP_ERROR("%s: load %s failed\r\n", __func__, BACNET_APP_CONFIG_FILE);
+            return NULL;
+        }
+    }
+
+    app_cfg_key = data_hash64(text, strlen(text));
+    (void)snprintf(app_cfg_image_file, sizeof(app_cfg_image_file), "%s"APP_CFG_IMAGE_SUFFIX,
+        filename);
+
+    cfg = load_json_image(app_cfg_image_file, APP_CFG_IMAGE_MAGIC, app_cfg_key);
+    if (cfg != NULL) {
+        free(text);
+        if (cfg->type != cJSON_Object) {
+            APP_ERROR("%s: invalid cJSON type\r\n", __func__);
+            free_json_image(cfg);
+            return NULL;
+        }
+        APP_VERBOS("%s: load %s\r\n", __func__, app_cfg_image_file);
+        app_cfg_image = cfg;
+        return cfg;
+    }
+
+    /* no image yet, or app.conf changed since it was saved */
+    cfg = cJSON_Parse(text);
+    free(text);
+    if (cfg == NULL) {
+        APP_ERROR("%s: parse %s failed\r\n", __func__, filename);
+        return NULL;
+    }
+
+    if (cfg->type != cJSON_Object) {
+        APP_ERROR("%s: invalid cJSON type\r\n", __func__);
+        cJSON_Delete(cfg);
+        return NULL;
+    }
+
+    app_cfg_parsed = cfg;
+
+    return cfg;
+}
+
+void bacnet_release_app_cfg(cJSON *cfg, bool used)
+{
+    int rv;
+
+    if (cfg == NULL) {
+        return;
+    }
+
+    if (cfg == app_cfg_image) {
+        app_cfg_image = NULL;
+        free_json_image(cfg);
+        return;
+    }
+
+    if ((cfg == app_cfg_parsed) && used) {
+        rv = save_json_image(app_cfg_image_file, APP_CFG_IMAGE_MAGIC, cfg, app_cfg_key);
+        if (rv < 0) {
+            APP_WARN("%s: save %s failed(%d)\r\n", __func__, app_cfg_image_file, rv);
+        }
+    }
+
+    if (cfg == app_cfg_parsed) {
+        app_cfg_parsed = NULL;
+    }
+    cJSON_Delete(cfg);
+}
+
 cJSON *__attribute__((weak)) bacnet_get_network_cfg(void)
 {
     cJSON *cfg;
@@ -19,8 +19,8 @@
 #include "bacnet/indtext.h"
 #include "bacnet/bacenum.h"
 
-static const char *ASHRAE_Reserved_String = "Reserved for Use by ASHRAE";
-static const char *Vendor_Proprietary_String = "Vendor Proprietary Value";
+static const char ASHRAE_Reserved_String[] = "Reserved for Use by ASHRAE";
+static const char Vendor_Proprietary_String[] = "Vendor Proprietary Value";
 
 INDTEXT_DATA bacnet_object_type_names[] = {
     {OBJECT_ANALOG_INPUT, "Analog Input"}
@@ -1705,80 +1705,201 @@ INDTEXT_DATA bacnet_error_code_names[] = {
     {0, NULL}
 };
 
+/* direct-indexed views of the lists above, see indtext_table_name */
+static indtext_table_t bactext_object_type_table =
+    INDTEXT_TABLE_INIT(bacnet_object_type_names, 128, ASHRAE_Reserved_String,
+        Vendor_Proprietary_String);
+
+static indtext_table_t bactext_property_table =
+    INDTEXT_TABLE_INIT(bacnet_property_names, 512, ASHRAE_Reserved_String,
+        Vendor_Proprietary_String);
+
+static indtext_table_t bactext_event_state_table =
+    INDTEXT_TABLE_INIT(bacnet_event_state_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_engineering_unit_table =
+    INDTEXT_TABLE_INIT(bacnet_engineering_unit_names, 256, ASHRAE_Reserved_String,
+        Vendor_Proprietary_String);
+
+static indtext_table_t bactext_binary_polarity_table =
+    INDTEXT_TABLE_INIT(bacnet_binary_polarity_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_binary_present_value_table =
+    INDTEXT_TABLE_INIT(bacnet_binary_present_value_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_reliability_table =
+    INDTEXT_TABLE_INIT(bacnet_reliability_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_device_status_table =
+    INDTEXT_TABLE_INIT(bacnet_device_status_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_segmentation_table =
+    INDTEXT_TABLE_INIT(bacnet_segmentation_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_node_type_table =
+    INDTEXT_TABLE_INIT(bacnet_node_type_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_day_of_week_table =
+    INDTEXT_TABLE_INIT(bacnet_day_of_week_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_month_table =
+    INDTEXT_TABLE_INIT(bacnet_month_names, 0, ASHRAE_Reserved_String,
+        ASHRAE_Reserved_String);
+
+static indtext_table_t bactext_error_class_table =
+    INDTEXT_TABLE_INIT(bacnet_error_class_names, FIRST_PROPRIETARY_ERROR_CLASS, ASHRAE_Reserved_String,
+        Vendor_Proprietary_String);
+
+static indtext_table_t bactext_error_code_table =
+    INDTEXT_TABLE_INIT(bacnet_error_code_names, FIRST_PROPRIETARY_ERROR_CLASS, ASHRAE_Reserved_String,
+        Vendor_Proprietary_String);
+
 const char *bactext_object_type_name(uint32_t index)
 {
-    return indtext_by_index_split_default(bacnet_object_type_names, index, 128,
-        ASHRAE_Reserved_String, Vendor_Proprietary_String);
+    return indtext_table_name(&bactext_object_type_table, index);
+}
+
+int bactext_object_type_index(const char *name)
+{
+    return indtext_table_index(&bactext_object_type_table, name);
 }
 
 const char *bactext_property_name(uint32_t index)
 {
-    return indtext_by_index_split_default(bacnet_property_names, index, 512,
-        ASHRAE_Reserved_String, Vendor_Proprietary_String);
+    return indtext_table_name(&bactext_property_table, index);
+}
+
+int bactext_property_index(const char *name)
+{
+    return indtext_table_index(&bactext_property_table, name);
 }
 
 const char *bactext_event_state_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_event_state_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_event_state_table, index);
+}
+
+int bactext_event_state_index(const char *name)
+{
+    return indtext_table_index(&bactext_event_state_table, name);
 }
 
 const char *bactext_engineering_unit_name(uint32_t index)
 {
-    return indtext_by_index_split_default(bacnet_engineering_unit_names, index, 256, 
-            ASHRAE_Reserved_String, Vendor_Proprietary_String);
+    return indtext_table_name(&bactext_engineering_unit_table, index);
+}
+
+int bactext_engineering_unit_index(const char *name)
+{
+    return indtext_table_index(&bactext_engineering_unit_table, name);
 }
 
 const char *bactext_binary_polarity_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_binary_polarity_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_binary_polarity_table, index);
+}
+
+int bactext_binary_polarity_index(const char *name)
+{
+    return indtext_table_index(&bactext_binary_polarity_table, name);
 }
 
 const char *bactext_binary_present_value_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_binary_present_value_names, index, 
-            ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_binary_present_value_table, index);
+}
+
+int bactext_binary_present_value_index(const char *name)
+{
+    return indtext_table_index(&bactext_binary_present_value_table, name);
 }
 
 const char *bactext_reliability_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_reliability_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_reliability_table, index);
+}
+
+int bactext_reliability_index(const char *name)
+{
+    return indtext_table_index(&bactext_reliability_table, name);
 }
 
 const char *bactext_device_status_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_device_status_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_device_status_table, index);
+}
+
+int bactext_device_status_index(const char *name)
+{
+    return indtext_table_index(&bactext_device_status_table, name);
 }
 
 const char *bactext_segmentation_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_segmentation_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_segmentation_table, index);
+}
+
+int bactext_segmentation_index(const char *name)
+{
+    return indtext_table_index(&bactext_segmentation_table, name);
 }
 
 const char *bactext_node_type_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_node_type_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_node_type_table, index);
+}
+
+int bactext_node_type_index(const char *name)
+{
+    return indtext_table_index(&bactext_node_type_table, name);
 }
 
 const char *bactext_day_of_week_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_day_of_week_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_day_of_week_table, index);
+}
+
+int bactext_day_of_week_index(const char *name)
+{
+    return indtext_table_index(&bactext_day_of_week_table, name);
 }
 
 const char *bactext_month_name(uint32_t index)
 {
-    return indtext_by_index_default(bacnet_month_names, index, ASHRAE_Reserved_String);
+    return indtext_table_name(&bactext_month_table, index);
+}
+
+int bactext_month_index(const char *name)
+{
+    return indtext_table_index(&bactext_month_table, name);
 }
 
 const char *bactext_error_class_name(uint32_t index)
 {
-    return indtext_by_index_split_default(bacnet_error_class_names, index, 
-        FIRST_PROPRIETARY_ERROR_CLASS, ASHRAE_Reserved_String, Vendor_Proprietary_String);
+    return indtext_table_name(&bactext_error_class_table, index);
+}
+
+int bactext_error_class_index(const char *name)
+{
+    return indtext_table_index(&bactext_error_class_table, name);
 }
 
 const char *bactext_error_code_name(uint32_t index)
 {
-    return indtext_by_index_split_default(bacnet_error_code_names, index,
-        FIRST_PROPRIETARY_ERROR_CLASS, ASHRAE_Reserved_String, Vendor_Proprietary_String);
+    return indtext_table_name(&bactext_error_code_table, index);
+}
+
+int bactext_error_code_index(const char *name)
+{
+    return indtext_table_index(&bactext_error_code_table, name);
 }
 
 int bactext_tolower(const char *src, char dst[], size_t dst_size)
@@ -1834,10 +1955,14 @@ int bactext_get_object_type_from_name(const char *name)
         return OBJECT_MULTI_STATE_OUTPUT;
     } else if ((strcmp(str, "msv") == 0) || (strcmp(str, "multistate value") == 0)) {
         return OBJECT_MULTI_STATE_VALUE;
+    } else if ((strcmp(str, "nc") == 0) || (strcmp(str, "notification class") == 0)) {
+        return OBJECT_NOTIFICATION_CLASS;
     } else if ((strcmp(str, "tl") == 0) || (strcmp(str, "trendlog") == 0)) {
         return OBJECT_TRENDLOG;
+    } else if ((strcmp(str, "tlm") == 0) || (strcmp(str, "trendlog multiple") == 0)) {
+        return OBJECT_TREND_LOG_MULTIPLE;
     } else {
-        return -EPERM;
+        return bactext_object_type_index(name);
     }
 
     return 0;
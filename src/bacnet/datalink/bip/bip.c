@@ -10,6 +10,8 @@
  * History
  */
 
+#define _GNU_SOURCE                         /* recvmmsg */
+
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
@@ -19,8 +21,10 @@
 #include <sys/socket.h>
 #include <sys/prctl.h>
 #include <sys/ioctl.h>
+#include <sys/eventfd.h>
 #include <arpa/inet.h>
 #include <sys/timerfd.h>
+#include <poll.h>
 
 #include "bacnet/config.h"
 #include "bip_def.h"
@@ -206,186 +210,392 @@ static int bip_send_pdu(datalink_bip_t *bip, bacnet_addr_t *dst_mac, bacnet_buf_
 }
 
 /**
- * bip_event_handler - bip¼
+ * bip_check_mpdu - УյBVLC
  *
- * @handler: ָdatalink_bip_t.handlerҵdatalink_bip_t
- * @events: epoll¼
+ * @bip: ն˿
+ * @buf: ĻdataָBVLCͷ
+ * @rx_bytes: յֽ
+ * @sin: ԴַForwarded-NPDUʱΪԭʼԴַ
+ *
+ * ֻ˿ãհ߳е
+ *
+ * @return: ɹBVLC룬ʧܻ趪ظ
  *
  */
-static void bip_event_handler(el_watch_t *watch, int events)
+static int bip_check_mpdu(datalink_bip_t *bip, bacnet_buf_t *buf, int rx_bytes,
+            struct sockaddr_in *sin)
 {
-    datalink_bip_t *bip;
-    int fd;
     BACNET_BVLC_FUNCTION function;
-    bacnet_addr_t src_mac;
-    struct sockaddr_in sin;
-    struct in_addr my_addr;
-    socklen_t sin_len;
     uint8_t *mpdu;
     uint16_t mpdu_len;
-    uint16_t my_port;
-    uint16_t npdu_offset;
-    DECLARE_BACNET_BUF(rx_pdu, BIP_RX_BUFF_LEN);
-    int rx_bytes;
-    int rv;
-
-    if (!(events & EPOLLIN)) {
-        BIP_ERROR("%s: invalid events\r\n", __func__);
-        return;
-    }
-
-    bip = (datalink_bip_t *)watch->data;
-    if (!bip) {
-        BIP_ERROR("%s: null bip argument\r\n", __func__);
-        return;
-    }
-
-    fd = el_watch_fd(watch);
-    if (fd < 0) {
-        BIP_ERROR("%s: invalid watch fd(%d)\r\n", __func__, fd);
-        return;
-    }
-    
-    if ((bip->sock_uip != fd) && (bip->sock_bip != fd)) {
-        BIP_ERROR("%s: port_id(%d) sock_uip(%d) sock_bip(%d) wrong callback fd(%d)\r\n", __func__,
-            bip->dl.port_id, bip->sock_uip, bip->sock_bip, fd);
-        return;
-    }
-
-    bacnet_buf_init(&rx_pdu.buf, BIP_RX_BUFF_LEN);
-    mpdu = rx_pdu.buf.data;
-    sin_len = sizeof(sin);
-    rx_bytes = recvfrom(fd, mpdu, BIP_RX_BUFF_LEN, MSG_DONTWAIT | MSG_TRUNC,
-        (struct sockaddr *)&sin, &sin_len);
-    if (rx_bytes < 0) {
-        BIP_ERROR("%s: recvfrom failed cause %s\r\n", __func__, strerror(errno));
-        return;
-    }
 
     if (rx_bytes < BVLC_HDR_LEN || rx_bytes > BIP_RX_BUFF_LEN) {
         BIP_ERROR("%s: invalid mpdu_len(%d)\r\n", __func__, rx_bytes);
-        return;
+        return -EINVAL;
     }
 
+    mpdu = buf->data;
     if (mpdu[0] != BVLL_TYPE_BACNET_IP) {
         BIP_ERROR("%s: unknown BVLC Type(0x%2x)\r\n", __func__, mpdu[0]);
-        return;
+        return -EINVAL;
     }
 
     (void)decode_unsigned16(&mpdu[2], &mpdu_len);
     if (mpdu_len != rx_bytes) {
         BIP_ERROR("%s: the bvlc length(%d) is not equal to rx_bytes(%d)\r\n", __func__, mpdu_len,
             rx_bytes);
-        return;
+        return -EINVAL;
     }
-    rx_pdu.buf.data_len = mpdu_len;
+    buf->data_len = mpdu_len;
     
-    my_addr.s_addr = bip->sin.sin_addr.s_addr;
-    my_port = bip->sin.sin_port;
-    if ((sin.sin_addr.s_addr == my_addr.s_addr) && (sin.sin_port == my_port)) {
-        return;
+    if ((sin->sin_addr.s_addr == bip->sin.sin_addr.s_addr) && (sin->sin_port == bip->sin.sin_port)) {
+        return -EPERM;
     }
 
-    BIP_VERBOS("%s: from %s:%04X\r\n", __func__, inet_ntoa(sin.sin_addr), ntohs(sin.sin_port));
+    BIP_VERBOS("%s: from %s:%04X\r\n", __func__, inet_ntoa(sin->sin_addr), ntohs(sin->sin_port));
     
     function = mpdu[1];
+    switch (function) {
+    case BVLC_FORWARDED_NPDU:
+        if (mpdu_len < FORWARDED_NPDU_HDR_LEN) {
+            BIP_ERROR("%s: invalid mpdu_len(%d)\r\n", __func__, mpdu_len);
+            return -EINVAL;
+        }
+        memcpy(&(sin->sin_addr.s_addr), &mpdu[4], IP_ADDRESS_LEN);
+        memcpy(&(sin->sin_port), &mpdu[8], UDP_PORT_LEN);
+        break;
+        
+    case BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK:
+        if (!(bip->bbmd)) {
+            BIP_ERROR("%s: Unexpected Msg(%d) for Non-BBMD\r\n", __func__, function);
+            return -EPERM;
+        }
+        break;
+        
+    case BVLC_ORIGINAL_BROADCAST_NPDU:
+        if (bip->fd_client) {
+            BIP_ERROR("%s: Unexpected Msg(%d) for Foreign Device\r\n", __func__, function);
+            return -EPERM;
+        }
+        break;
+
+    default:
+        if (function >= MAX_BVLC_FUNCTION) {
+            BIP_ERROR("%s: Unknown BVLC Function(%d)\r\n", __func__, function);
+            return -EINVAL;
+        }
+        break;
+    }
+
+    return function;
+}
+
+/**
+ * bip_forward_mpdu - BBMDת㲥
+ *
+ * ֻfdt_lock/bdt_lockıڶհ߳вִ
+ *
+ */
+static void bip_forward_mpdu(datalink_bip_t *bip, int function, struct sockaddr_in *sin,
+            bacnet_buf_t *buf)
+{
+    if (!(bip->bbmd)) {
+        return;
+    }
+
+    switch (function) {
+    case BVLC_FORWARDED_NPDU:
+        (void)bvlc_receive_forwarded_npdu(bip, sin, buf);
+        break;
+        
+    case BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK:
+        (void)bvlc_receive_distribute_bcast_to_network(bip, sin, buf);
+        break;
+        
+    case BVLC_ORIGINAL_BROADCAST_NPDU:
+        (void)bvlc_receive_original_broadcast_npdu(bip, sin, buf);
+        break;
+        
+    default:
+        break;
+    }
+}
+
+/**
+ * bip_deliver_mpdu - BVLCƱģݽnpdu
+ *
+ * 㲻̰߳ȫģel_default_loopִ߳
+ *
+ */
+static void bip_deliver_mpdu(datalink_bip_t *bip, int function, struct sockaddr_in *sin,
+            bacnet_buf_t *buf)
+{
+    bacnet_addr_t src_mac;
+    uint16_t npdu_offset;
+    int rv;
+
     switch (function) {
     case BVLC_RESULT:
-        (void)bvlc_receive_bvlc_result(bip, &rx_pdu.buf);
+        (void)bvlc_receive_bvlc_result(bip, buf);
         return;
         
     case BVLC_WRITE_BROADCAST_DISTRIBUTION_TABLE:
-        (void)bvlc_receive_write_bdt(bip, &sin, &rx_pdu.buf);
+        (void)bvlc_receive_write_bdt(bip, sin, buf);
         return;
         
     case BVLC_READ_BROADCAST_DISTRIBUTION_TABLE:
-        (void)bvlc_receive_read_bdt(bip, &sin, &rx_pdu.buf);
+        (void)bvlc_receive_read_bdt(bip, sin, buf);
         return;
         
     case BVLC_READ_BROADCAST_DISTRIBUTION_TABLE_ACK:
-        (void)bvlc_receive_read_bdt_ack(bip, &rx_pdu.buf);
+        (void)bvlc_receive_read_bdt_ack(bip, buf);
         return;
         
     case BVLC_FORWARDED_NPDU:
-        memcpy(&(sin.sin_addr.s_addr), &mpdu[4], IP_ADDRESS_LEN);
-        memcpy(&(sin.sin_port), &mpdu[8], UDP_PORT_LEN);
-        
-        if (bip->bbmd) {
-            (void)bvlc_receive_forwarded_npdu(bip, &sin, &rx_pdu.buf);
-        }
         npdu_offset = FORWARDED_NPDU_HDR_LEN;
         break;
         
     case BVLC_REGISTER_FOREIGN_DEVICE:
-        (void)bvlc_receive_register_foreign_device(bip, &sin, &rx_pdu.buf);
+        (void)bvlc_receive_register_foreign_device(bip, sin, buf);
         return;
         
     case BVLC_READ_FOREIGN_DEVICE_TABLE:
-        (void)bvlc_receive_read_fdt(bip, &sin, &rx_pdu.buf);
+        (void)bvlc_receive_read_fdt(bip, sin, buf);
         return;
         
     case BVLC_READ_FOREIGN_DEVICE_TABLE_ACK:
-        (void)bvlc_receive_read_fdt_ack(bip, &rx_pdu.buf);
+        (void)bvlc_receive_read_fdt_ack(bip, buf);
         return;
         
     case BVLC_DELETE_FOREIGN_DEVICE_TABLE_ENTRY:
-        (void)bvlc_receive_delete_fdt_entry(bip, &sin, &rx_pdu.buf);
+        (void)bvlc_receive_delete_fdt_entry(bip, sin, buf);
         return;
     
     case BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK:
-        if (!(bip->bbmd)) {
-            BIP_ERROR("%s: Unexpected Msg(%d) for Non-BBMD\r\n", __func__, function);
-            return;
-        }
-        
-        (void)bvlc_receive_distribute_bcast_to_network(bip, &sin, &rx_pdu.buf);
-        npdu_offset = 4;
-        break;
-    
     case BVLC_ORIGINAL_UNICAST_NPDU:
-        npdu_offset = 4;
-        break;
-        
     case BVLC_ORIGINAL_BROADCAST_NPDU:
-        if (bip->fd_client) {
-            BIP_ERROR("%s: Unexpected Msg(%d) for Foreign Device\r\n", __func__, function);
-            return;
-        }
-        
-        if (bip->bbmd) {
-            (void)bvlc_receive_original_broadcast_npdu(bip, &sin, &rx_pdu.buf);
-        }
         npdu_offset = 4;
         break;
         
     default:
-        BIP_ERROR("%s: Unknown BVLC Function(%d)\r\n", __func__, function);
         return;
     }
 
     bip->dl.rx_all++;
 
-    rv = bip_internet_to_bacnet_address(&sin, &src_mac);
+    rv = bip_internet_to_bacnet_address(sin, &src_mac);
     if (rv < 0) {
         BIP_ERROR("%s: sin to bacnet address failed(%d)\r\n", __func__, rv);
         return;
     }
     
-    if (mpdu_len <= npdu_offset) {
-        BIP_ERROR("%s: invalid mpdu_len(%d)\r\n", __func__, mpdu_len);
+    if (buf->data_len <= npdu_offset) {
+        BIP_ERROR("%s: invalid mpdu_len(%d)\r\n", __func__, buf->data_len);
         return;
     }
 
-    rv = bacnet_buf_pull(&rx_pdu.buf, npdu_offset);
+    rv = bacnet_buf_pull(buf, npdu_offset);
     if (rv < 0) {
         BIP_ERROR("%s: buf pull failed(%d)\r\n", __func__, rv);
         return;
     }
 
     bip->dl.rx_ok++;
-    (void)network_receive_pdu(bip->dl.port_id, &rx_pdu.buf, &src_mac);
+    (void)network_receive_pdu(bip->dl.port_id, buf, &src_mac);
+}
 
-    return;
+/**
+ * bip_event_handler - bip¼
+ *
+ * @handler: ָdatalink_bip_t.handlerҵdatalink_bip_t
+ * @events: epoll¼
+ *
+ */
+static void bip_event_handler(el_watch_t *watch, int events)
+{
+    datalink_bip_t *bip;
+    int fd;
+    struct sockaddr_in sin;
+    socklen_t sin_len;
+    DECLARE_BACNET_BUF(rx_pdu, BIP_RX_BUFF_LEN);
+    int rx_bytes;
+    int function;
+
+    if (!(events & EPOLLIN)) {
+        BIP_ERROR("%s: invalid events\r\n", __func__);
+        return;
+    }
+
+    bip = (datalink_bip_t *)watch->data;
+    if (!bip) {
+        BIP_ERROR("%s: null bip argument\r\n", __func__);
+        return;
+    }
+
+    fd = el_watch_fd(watch);
+    if (fd < 0) {
+        BIP_ERROR("%s: invalid watch fd(%d)\r\n", __func__, fd);
+        return;
+    }
+    
+    if ((bip->sock_uip != fd) && (bip->sock_bip != fd)) {
+        BIP_ERROR("%s: port_id(%d) sock_uip(%d) sock_bip(%d) wrong callback fd(%d)\r\n", __func__,
+            bip->dl.port_id, bip->sock_uip, bip->sock_bip, fd);
+        return;
+    }
+
+    bacnet_buf_init(&rx_pdu.buf, BIP_RX_BUFF_LEN);
+    sin_len = sizeof(sin);
+    rx_bytes = recvfrom(fd, rx_pdu.buf.data, BIP_RX_BUFF_LEN, MSG_DONTWAIT | MSG_TRUNC,
+        (struct sockaddr *)&sin, &sin_len);
+    if (rx_bytes < 0) {
+        BIP_ERROR("%s: recvfrom failed cause %s\r\n", __func__, strerror(errno));
+        return;
+    }
+
+    function = bip_check_mpdu(bip, &rx_pdu.buf, rx_bytes, &sin);
+    if (function < 0) {
+        return;
+    }
+
+    bip_forward_mpdu(bip, function, &sin, &rx_pdu.buf);
+    bip_deliver_mpdu(bip, function, &sin, &rx_pdu.buf);
+}
+
+/**
+ * bip_rx_notify_handler - ݽհ߳̽ı
+ *
+ * el_default_loopִУʱringеȫ
+ *
+ */
+static void bip_rx_notify_handler(el_watch_t *watch, int events)
+{
+    bip_rx_worker_t *worker;
+    bip_rx_slot_t *slot;
+    uint64_t value;
+    uint32_t head;
+
+    if (!(events & EPOLLIN)) {
+        BIP_ERROR("%s: invalid events\r\n", __func__);
+        return;
+    }
+
+    worker = (bip_rx_worker_t *)watch->data;
+    if (read(worker->notify_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        BIP_ERROR("%s: read eventfd failed cause %s\r\n", __func__, strerror(errno));
+    }
+
+    head = __atomic_load_n(&worker->head, __ATOMIC_ACQUIRE);
+    while (worker->tail != head) {
+        slot = &worker->ring[worker->tail & (BIP_RX_RING_SIZE - 1)];
+        if (slot->function >= 0) {
+            bip_deliver_mpdu(worker->bip, slot->function, &slot->sin, &slot->rx.buf);
+        }
+        __atomic_store_n(&worker->tail, worker->tail + 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * bip_rx_worker_func - SO_REUSEPORT socketհ߳
+ *
+ * ں˰ԴַhashѡsocketͬһԴıͬһ߳а
+ * УBBMDתڱִ̲߳У֮ring򽻸el_default_loop
+ * ݽ㣻ringʱתٵݽrx_drops
+ *
+ */
+static void *bip_rx_worker_func(bip_rx_worker_t *worker)
+{
+    datalink_bip_t *bip;
+    bip_rx_slot_t *slots[BIP_RX_BATCH];
+    struct mmsghdr msgs[BIP_RX_BATCH];
+    struct iovec iovs[BIP_RX_BATCH];
+    struct pollfd fds[2];
+    uint32_t room, batch;
+    uint64_t value;
+    char name[16];
+    bool full;
+    int i, n;
+
+    bip = worker->bip;
+    (void)snprintf(name, sizeof(name), "bip%d_rx%d", bip->dl.port_id, worker->idx);
+    (void)prctl(PR_SET_NAME, name);
+
+    fds[0].fd = worker->sock;
+    fds[0].events = POLLIN;
+    fds[1].fd = worker->stop_fd;
+    fds[1].events = POLLIN;
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            BIP_ERROR("%s: poll failed cause %s\r\n", __func__, strerror(errno));
+            break;
+        }
+
+        if (fds[1].revents) {
+            break;
+        }
+
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        room = BIP_RX_RING_SIZE - (worker->head - __atomic_load_n(&worker->tail, __ATOMIC_ACQUIRE));
+        full = (room == 0);
+        batch = full? BIP_RX_BATCH: (room < BIP_RX_BATCH? room: BIP_RX_BATCH);
+
+        for (i = 0; i < batch; i++) {
+            slots[i] = full? &worker->scratch[i]
+                : &worker->ring[(worker->head + i) & (BIP_RX_RING_SIZE - 1)];
+            bacnet_buf_init(&slots[i]->rx.buf, BIP_RX_BUFF_LEN);
+            iovs[i].iov_base = slots[i]->rx.buf.data;
+            iovs[i].iov_len = BIP_RX_BUFF_LEN;
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &slots[i]->sin;
+            msgs[i].msg_hdr.msg_namelen = sizeof(slots[i]->sin);
+        }
+
+        n = recvmmsg(worker->sock, msgs, batch, MSG_DONTWAIT, NULL);
+        if (n <= 0) {
+            if ((n < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+                BIP_ERROR("%s: recvmmsg failed cause %s\r\n", __func__, strerror(errno));
+            }
+            continue;
+        }
+        worker->rx_pkts += n;
+        worker->rx_batches++;
+
+        for (i = 0; i < n; i++) {
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                BIP_ERROR("%s: truncated mpdu\r\n", __func__);
+                slots[i]->function = -EINVAL;
+                continue;
+            }
+
+            slots[i]->function = bip_check_mpdu(bip, &slots[i]->rx.buf, msgs[i].msg_len,
+                &slots[i]->sin);
+            if (slots[i]->function >= 0) {
+                bip_forward_mpdu(bip, slots[i]->function, &slots[i]->sin, &slots[i]->rx.buf);
+            }
+        }
+
+        if (full) {
+            worker->rx_drops += n;
+            continue;
+        }
+
+        __atomic_store_n(&worker->head, worker->head + n, __ATOMIC_RELEASE);
+        value = 1;
+        if (write(worker->notify_fd, &value, sizeof(value)) < 0) {
+            BIP_ERROR("%s: notify failed cause %s\r\n", __func__, strerror(errno));
+        }
+    }
+
+    return NULL;
 }
 
 /* FD豸ע */
@@ -632,6 +842,23 @@ static int bip_bbmd_config(datalink_bip_t *bip, cJSON *cfg)
         bip->bbmd->push.interval = 0;
     }
 
+    tmp = cJSON_GetObjectItem(cfg, "fdt_max_size");
+    if (tmp) {
+        if (tmp->type != cJSON_Number) {
+            BIP_ERROR("%s: fdt_max_size should be number\r\n", __func__);
+            goto err2;
+        }
+        if ((tmp->valueint <= 0) || (tmp->valueint > FDT_MAX_SIZE)) {
+            BIP_ERROR("%s: fdt_max_size should be in 1~%d\r\n", __func__, FDT_MAX_SIZE);
+            goto err2;
+        }
+        if (tmp->valueint > FDT_ACK_MAX_ENTRIES) {
+            BIP_WARN("%s: Read-FDT-Ack only carries first %d entries\r\n", __func__,
+                FDT_ACK_MAX_ENTRIES);
+        }
+        bip->bbmd->fdt_max = tmp->valueint;
+    }
+
     bip->bbmd->bdt = bbmd_table;
     bip->bbmd->bdt_size = bdt_size + 1;
     bip->bbmd->local_entry = bdt_size;
@@ -650,6 +877,178 @@ err1:
     return -EPERM;
 }
 
+static void bip_rx_workers_destroy(datalink_bip_t *bip)
+{
+    bip_rx_worker_t *worker;
+    uint32_t i;
+
+    if (bip->rx_workers == NULL) {
+        return;
+    }
+
+    for (i = 0; i < bip->rx_threads - 1; i++) {
+        worker = &bip->rx_workers[i];
+        if (worker->sock >= 0) {
+            close(worker->sock);
+        }
+        if (worker->stop_fd >= 0) {
+            close(worker->stop_fd);
+        }
+        if (worker->notify_fd >= 0) {
+            close(worker->notify_fd);
+        }
+        free(worker->ring);
+        free(worker->scratch);
+    }
+
+    free(bip->rx_workers);
+    bip->rx_workers = NULL;
+}
+
+/* open rx_threads - 1 more sockets in the SO_REUSEPORT group of sock_uip */
+static int bip_rx_workers_create(datalink_bip_t *bip)
+{
+    bip_rx_worker_t *worker;
+    int sockopt;
+    uint32_t i;
+
+    if (bip->rx_threads <= 1) {
+        return OK;
+    }
+
+    bip->rx_workers = (bip_rx_worker_t *)calloc(bip->rx_threads - 1, sizeof(bip_rx_worker_t));
+    if (bip->rx_workers == NULL) {
+        BIP_ERROR("%s: malloc rx workers failed\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < bip->rx_threads - 1; i++) {
+        bip->rx_workers[i].sock = -1;
+        bip->rx_workers[i].stop_fd = -1;
+        bip->rx_workers[i].notify_fd = -1;
+    }
+
+    for (i = 0; i < bip->rx_threads - 1; i++) {
+        worker = &bip->rx_workers[i];
+        worker->bip = bip;
+        worker->idx = i + 1;
+
+        worker->ring = (bip_rx_slot_t *)malloc(sizeof(bip_rx_slot_t) * BIP_RX_RING_SIZE);
+        worker->scratch = (bip_rx_slot_t *)malloc(sizeof(bip_rx_slot_t) * BIP_RX_BATCH);
+        if ((worker->ring == NULL) || (worker->scratch == NULL)) {
+            BIP_ERROR("%s: malloc rx ring failed\r\n", __func__);
+            goto err;
+        }
+
+        worker->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (worker->sock < 0) {
+            BIP_ERROR("%s: create rx socket failed cause %s\r\n", __func__, strerror(errno));
+            goto err;
+        }
+
+        sockopt = 1;
+        if ((setsockopt(worker->sock, SOL_SOCKET, SO_REUSEADDR, &sockopt, sizeof(sockopt)) < 0)
+                || (setsockopt(worker->sock, SOL_SOCKET, SO_REUSEPORT, &sockopt,
+                    sizeof(sockopt)) < 0)) {
+            BIP_ERROR("%s: rx setsockopt failed cause %s\r\n", __func__, strerror(errno));
+            goto err;
+        }
+
+        if (bind(worker->sock, (struct sockaddr *)&bip->sin, sizeof(struct sockaddr)) < 0) {
+            BIP_ERROR("%s: rx bind failed cause %s\r\n", __func__, strerror(errno));
+            goto err;
+        }
+
+        worker->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        worker->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if ((worker->stop_fd < 0) || (worker->notify_fd < 0)) {
+            BIP_ERROR("%s: create eventfd failed cause %s\r\n", __func__, strerror(errno));
+            goto err;
+        }
+    }
+
+    return OK;
+
+err:
+    bip_rx_workers_destroy(bip);
+
+    return -EPERM;
+}
+
+static void bip_rx_workers_stop(datalink_bip_t *bip)
+{
+    bip_rx_worker_t *worker;
+    uint64_t value;
+    uint32_t i;
+
+    if (bip->rx_workers == NULL) {
+        return;
+    }
+
+    for (i = 0; i < bip->rx_threads - 1; i++) {
+        worker = &bip->rx_workers[i];
+        if (worker->started) {
+            value = 1;
+            if (write(worker->stop_fd, &value, sizeof(value)) != sizeof(value)) {
+                BIP_ERROR("%s: wake rx worker(%d) failed cause %s\r\n", __func__, worker->idx,
+                    strerror(errno));
+            }
+            (void)pthread_join(worker->thread, NULL);
+            worker->started = false;
+
+            /* drain the eventfd so that the worker could be restarted */
+            (void)read(worker->stop_fd, &value, sizeof(value));
+        }
+
+        if (worker->watch) {
+            (void)el_watch_destroy(&el_default_loop, worker->watch);
+            worker->watch = NULL;
+        }
+    }
+}
+
+static int bip_rx_workers_start(datalink_bip_t *bip)
+{
+    bip_rx_worker_t *worker;
+    uint32_t i;
+    int rv;
+
+    if (bip->rx_workers == NULL) {
+        return OK;
+    }
+
+    for (i = 0; i < bip->rx_threads - 1; i++) {
+        worker = &bip->rx_workers[i];
+        worker->head = 0;
+        worker->tail = 0;
+        worker->rx_pkts = 0;
+        worker->rx_batches = 0;
+        worker->rx_drops = 0;
+
+        worker->watch = el_watch_create(&el_default_loop, worker->notify_fd, EPOLLIN);
+        if (worker->watch == NULL) {
+            BIP_ERROR("%s: create notify watch failed\r\n", __func__);
+            goto err;
+        }
+        worker->watch->handler = bip_rx_notify_handler;
+        worker->watch->data = worker;
+
+        rv = pthread_create(&worker->thread, NULL, (void*(*)(void*))bip_rx_worker_func, worker);
+        if (rv != 0) {
+            BIP_ERROR("%s: create rx thread failed cause %s\r\n", __func__, strerror(rv));
+            goto err;
+        }
+        worker->started = true;
+    }
+
+    return OK;
+
+err:
+    bip_rx_workers_stop(bip);
+
+    return -EPERM;
+}
+
 static cJSON *bip_get_mib(datalink_base_t *dl_port);
 
 /**
@@ -729,6 +1128,18 @@ datalink_bip_t *bip_port_create(cJSON *cfg, cJSON *res)
     port = htons(port);
     bip->sin.sin_port = port;
 
+    tmp = cJSON_GetObjectItem(cfg, "rx_threads");
+    if (!tmp) {
+        bip->rx_threads = 1;
+    } else if ((tmp->type != cJSON_Number) || (tmp->valueint < 1)
+            || (tmp->valueint > BIP_MAX_RX_THREADS)) {
+        BIP_ERROR("%s: invalid rx_threads item\r\n", __func__);
+        goto out1;
+    } else {
+        bip->rx_threads = tmp->valueint;
+        cJSON_DeleteItemFromObject(cfg, "rx_threads");
+    }
+
     /* setup sock_uip */
     sock_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock_fd < 0) {
@@ -745,6 +1156,17 @@ datalink_bip_t *bip_port_create(cJSON *cfg, cJSON *res)
         goto out2;
     }
 
+    /* receive sockets of rx workers join the group of sock_uip */
+    if (bip->rx_threads > 1) {
+        sockopt = 1;
+        rv = setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &sockopt, sizeof(sockopt));
+        if (rv < 0) {
+            BIP_ERROR("%s: uip setsockopt REUSEPORT failed cause %s\r\n", __func__,
+                strerror(errno));
+            goto out2;
+        }
+    }
+
     /* allow us to send a broadcast */
     sockopt = 1;
     rv = setsockopt(sock_fd, SOL_SOCKET, SO_BROADCAST, &sockopt, sizeof(sockopt));
@@ -776,6 +1198,12 @@ datalink_bip_t *bip_port_create(cJSON *cfg, cJSON *res)
         goto out2;
     }
 
+    rv = bip_rx_workers_create(bip);
+    if (rv < 0) {
+        BIP_ERROR("%s: create rx workers failed(%d)\r\n", __func__, rv);
+        goto out2;
+    }
+
     /* setup sock_bip */
     sock_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock_fd < 0) {
@@ -859,6 +1287,7 @@ out3:
     close(bip->sock_bip);
 
 out2:
+    bip_rx_workers_destroy(bip);
     close(bip->sock_uip);
 
 out1:
@@ -887,6 +1316,8 @@ int bip_port_delete(datalink_bip_t *bip_port)
         (void)el_watch_destroy(&el_default_loop, bip_port->watch_bip);
     }
 
+    bip_rx_workers_stop(bip_port);
+    bip_rx_workers_destroy(bip_port);
     close(bip_port->sock_bip);
     close(bip_port->sock_uip);
 
@@ -899,6 +1330,7 @@ int bip_port_delete(datalink_bip_t *bip_port)
 
     if (bip_port->bbmd) {
         bdt_push_stop(bip_port);
+        fdt_aging_stop(bip_port);
         bbmd_destroy(bip_port->bbmd);
     }
     
@@ -948,28 +1380,7 @@ int bip_startup(void)
 	    if ((bip->watch_uip == NULL) || (bip->watch_bip == NULL)
 	            || (bip->fd_client && bip->fd_client->timer == NULL)) {
 	        BIP_ERROR("%s: watch or timer create failed\r\n", __func__);
-
-	        list_for_each_entry(bip_todel, &all_bip_list, bip_list) {
-	            if (bip_todel->watch_uip) {
-	                (void)el_watch_destroy(&el_default_loop, bip_todel->watch_uip);
-	                bip_todel->watch_uip = NULL;
-	            }
-	            if (bip_todel->watch_bip) {
-	                (void)el_watch_destroy(&el_default_loop, bip_todel->watch_bip);
-	                bip_todel->watch_bip = NULL;
-	            }
-                if (bip_todel->fd_client && bip_todel->fd_client->timer) {
-                    (void)el_timer_destroy(&el_default_loop, bip_todel->fd_client->timer);
-                    bip_todel->fd_client->timer = NULL;
-                }
-                bdt_push_stop(bip_todel);
-
-	            if (bip_todel == bip) {
-	                break;
-	            }
-	        }
-
-	        goto out;
+	        goto err;
 	    }
 
 	    bip->watch_uip->handler = bip_event_handler;
@@ -981,6 +1392,12 @@ int bip_startup(void)
             bip->fd_client->timer->data = bip;
         }
         bdt_push_start(bip);
+        fdt_aging_start(bip);
+
+        if (bip_rx_workers_start(bip) < 0) {
+            BIP_ERROR("%s: start rx workers failed\r\n", __func__);
+            goto err;
+        }
     }
 
     BIP_VERBOS("%s: ok\r\n", __func__);
@@ -988,17 +1405,37 @@ int bip_startup(void)
     
     return OK;
 
-out:
+err:
+    list_for_each_entry(bip_todel, &all_bip_list, bip_list) {
+        if (bip_todel->watch_uip) {
+            (void)el_watch_destroy(&el_default_loop, bip_todel->watch_uip);
+            bip_todel->watch_uip = NULL;
+        }
+        if (bip_todel->watch_bip) {
+            (void)el_watch_destroy(&el_default_loop, bip_todel->watch_bip);
+            bip_todel->watch_bip = NULL;
+        }
+        if (bip_todel->fd_client && bip_todel->fd_client->timer) {
+            (void)el_timer_destroy(&el_default_loop, bip_todel->fd_client->timer);
+            bip_todel->fd_client->timer = NULL;
+        }
+        bdt_push_stop(bip_todel);
+        fdt_aging_stop(bip_todel);
+        bip_rx_workers_stop(bip_todel);
+
+        if (bip_todel == bip) {
+            break;
+        }
+    }
 
     return -EPERM;
 }
 
-void bip_stop(void)
+/* run on el_default_loop, no handler of the ports is running meanwhile */
+static void _bip_stop(void *arg)
 {
     datalink_bip_t *bip;
     int rv;
-
-    el_sync(&el_default_loop);
     
     list_for_each_entry(bip, &all_bip_list, bip_list) {
         if (bip->watch_uip) {
@@ -1026,9 +1463,20 @@ void bip_stop(void)
         }
 
         bdt_push_stop(bip);
+        fdt_aging_stop(bip);
+    }
+}
+
+void bip_stop(void)
+{
+    datalink_bip_t *bip;
+
+    /* workers deliver through el_default_loop, stop them first */
+    list_for_each_entry(bip, &all_bip_list, bip_list) {
+        bip_rx_workers_stop(bip);
     }
 
-    el_unsync(&el_default_loop);
+    (void)el_call(&el_default_loop, _bip_stop, NULL);
 }
 
 void bip_clean(void)
@@ -1038,6 +1486,7 @@ void bip_clean(void)
     while((each = list_first_entry_or_null(&all_bip_list, datalink_bip_t, bip_list))) {
 	    list_del(&each->bip_list);
 	    
+	    bip_rx_workers_destroy(each);
 	    close(each->sock_uip);
 	    close(each->sock_bip);
 
@@ -1345,9 +1794,9 @@ err:
 
 static cJSON *bip_port_get_fdt(datalink_bip_t *bip_port)
 {
-    fdt_entry_t *entry;
+    bbmd_data_t *bbmd;
     cJSON *FDT, *tmp;
-    int i;
+    uint32_t i;
 
     FDT = cJSON_CreateArray();
     if (FDT == NULL) {
@@ -1355,31 +1804,32 @@ static cJSON *bip_port_get_fdt(datalink_bip_t *bip_port)
         return NULL;
     }
 
-    RWLOCK_RDLOCK(&(bip_port->bbmd->fdt_lock));
+    bbmd = bip_port->bbmd;
+    RWLOCK_RDLOCK(&(bbmd->fdt_lock));
 
     unsigned now = el_current_millisecond();
 
-    hash_for_each(bip_port->bbmd->fdt, i, entry, hnode) {
+    for (i = 0; i < bbmd->fdt_size; i++) {
+        unsigned remaining = bbmd->fdt[i].expire - now;
+        if (remaining > 65535*1000)
+            continue;
+
         tmp = cJSON_CreateObject();
         if (tmp == NULL) {
             BIP_ERROR("%s: create fdt entry object failed\r\n", __func__);
-            RWLOCK_UNLOCK(&(bip_port->bbmd->fdt_lock));
+            RWLOCK_UNLOCK(&(bbmd->fdt_lock));
             cJSON_Delete(FDT);
             return NULL;
         }
 
-        unsigned remaining = el_timer_expire(entry->timer) - now;
-        if (remaining > 65535*1000)
-            continue;
-
         cJSON_AddItemToArray(FDT, tmp);
-        cJSON_AddStringToObject(tmp, "dst_addr", inet_ntoa(entry->dst_addr));
-        cJSON_AddNumberToObject(tmp, "dst_port", ntohs(entry->dst_port));
-        cJSON_AddNumberToObject(tmp, "time-to-live", entry->time_to_live);
+        cJSON_AddStringToObject(tmp, "dst_addr", inet_ntoa(bbmd->fdt_dst[i].sin_addr));
+        cJSON_AddNumberToObject(tmp, "dst_port", ntohs(bbmd->fdt_dst[i].sin_port));
+        cJSON_AddNumberToObject(tmp, "time-to-live", bbmd->fdt[i].time_to_live);
         cJSON_AddNumberToObject(tmp, "seconds_remaining", remaining/1000);
     }
 
-    RWLOCK_UNLOCK(&(bip_port->bbmd->fdt_lock));
+    RWLOCK_UNLOCK(&(bbmd->fdt_lock));
     return FDT;
 }
 
@@ -1519,8 +1969,9 @@ err:
 
 static cJSON *bip_get_mib(datalink_base_t *dl_port)
 {
-    cJSON *result, *tmp;
+    cJSON *result, *tmp, *worker;
     datalink_bip_t *bip;
+    uint32_t i;
 
     if (dl_port == NULL) {
         BIP_ERROR("%s: invalid argument\r\n", __func__);
@@ -1534,6 +1985,29 @@ static cJSON *bip_get_mib(datalink_base_t *dl_port)
     }
 
     bip = (datalink_bip_t *)dl_port;
+    cJSON_AddNumberToObject(result, "rx_threads", bip->rx_threads);
+    if (bip->rx_workers) {
+        tmp = cJSON_CreateArray();
+        if (tmp == NULL) {
+            BIP_ERROR("%s: create rx_workers array failed\r\n", __func__);
+            cJSON_Delete(result);
+            return NULL;
+        }
+        cJSON_AddItemToObject(result, "rx_workers", tmp);
+        for (i = 0; i < bip->rx_threads - 1; i++) {
+            worker = cJSON_CreateObject();
+            if (worker == NULL) {
+                BIP_ERROR("%s: create rx worker object failed\r\n", __func__);
+                cJSON_Delete(result);
+                return NULL;
+            }
+            cJSON_AddNumberToObject(worker, "rx_pkts", bip->rx_workers[i].rx_pkts);
+            cJSON_AddNumberToObject(worker, "rx_batches", bip->rx_workers[i].rx_batches);
+            cJSON_AddNumberToObject(worker, "rx_drops", bip->rx_workers[i].rx_drops);
+            cJSON_AddItemToArray(tmp, worker);
+        }
+    }
+    
     if (bip->bbmd == NULL) {
         return result;
     }
@@ -16,13 +16,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <pthread.h>
 #include <netinet/in.h>
 #include <net/if.h>
 
 #include "bacnet/bip.h"
 #include "misc/list.h"
 #include "bacnet/datalink.h"
-#include "misc/hashtable.h"
+#include "misc/hash.h"
+#include "misc/trace.h"
 
 extern bool bip_dbg_verbos;
 extern bool bip_dbg_warn;
@@ -31,21 +33,21 @@ extern bool bip_dbg_err;
 #define BIP_ERROR(fmt, args...)                     \
 do {                                                \
     if (bip_dbg_err) {                              \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define BIP_WARN(fmt, args...)                      \
 do {                                                \
     if (bip_dbg_warn) {                             \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define BIP_VERBOS(fmt, args...)                    \
 do {                                                \
     if (bip_dbg_verbos) {                           \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
@@ -69,9 +71,16 @@ typedef struct bvlc_hdr_s {
 #define BIP_RX_BUFF_LEN                             (BVLC_HDR_LEN + BIP_MAX_DATA_LEN)
 #define BBMD_TABLE_ENTRY_SIZE                       (BIP_ADDRESS_LEN + BCAST_MASK_LEN)
 #define FD_TABLE_ENTRY_SIZE                         (10)
-#define FDT_MAX_SIZE                                (BIP_MAX_DATA_LEN/FD_TABLE_ENTRY_SIZE)
+#define FDT_ACK_MAX_ENTRIES                         (BIP_MAX_DATA_LEN/FD_TABLE_ENTRY_SIZE)
+#define FDT_DEFAULT_MAX_SIZE                        (FDT_ACK_MAX_ENTRIES)
+#define FDT_MAX_SIZE                                (65536)
+#define FDT_MIN_CAPACITY                            (16)
+#define FDT_SWEEP_INTERVAL                          (1000)      /* ms */
+#define FDT_SEND_BATCH                              (64)
 #define BDT_MAX_SIZE                                (BIP_MAX_DATA_LEN/BBMD_TABLE_ENTRY_SIZE)
-#define FDT_HASH_BIT                                (5)
+#define BIP_MAX_RX_THREADS                          (16)
+#define BIP_RX_BATCH                                (32)
+#define BIP_RX_RING_SIZE                            (256)       /* power of 2 */
 
 typedef enum {
     BVLC_RESULT_SUCCESSFUL_COMPLETION = 0x0000,
@@ -112,10 +121,27 @@ typedef struct bdt_push_s {
     el_timer_t *timer;
 } bdt_push_t;
 
+typedef struct fdt_entry_s {
+    uint16_t time_to_live;                  /* seconds for valid entry lifetime */
+    unsigned expire;                        /* el_current_millisecond() to be purged */
+} fdt_entry_t;
+
+/*
+ * FDT is kept dense, fdt_dst[i] and fdt[i] describe the same foreign device for
+ * i < fdt_size, so a broadcast is fanned out along a contiguous destination list.
+ * fdt_index is an open addressing index of dense position + 1, 0 for empty.
+ * Only el_default_loop modifies the table, under fdt_lock.
+ */
 typedef struct bbmd_data_s {
     pthread_rwlock_t fdt_lock;
     uint32_t fdt_size;
-    DECLARE_HASHTABLE(fdt, FDT_HASH_BIT);
+    uint32_t fdt_max;                       /* configured upper limit of fdt_size */
+    uint32_t fdt_capacity;
+    struct sockaddr_in *fdt_dst;
+    fdt_entry_t *fdt;
+    uint32_t *fdt_index;
+    uint32_t fdt_index_bits;
+    el_timer_t *fdt_timer;                  /* one sweep ages all entries */
 
     int local_entry;
     pthread_rwlock_t bdt_lock;
@@ -124,14 +150,33 @@ typedef struct bbmd_data_s {
     bdt_push_t push;
 } bbmd_data_t;
 
-typedef struct fdt_entry_s {
-    struct in_addr dst_addr;                /* in network format */
-    uint16_t dst_port;                      /* not always 0xBAC0, in network format */
-    uint16_t time_to_live;                  /* seconds for valid entry lifetime */
-    el_timer_t *timer;
-    struct hlist_node hnode;
-    bbmd_data_t *bbmd;
-} fdt_entry_t;
+typedef struct bip_rx_slot_s {
+    struct sockaddr_in sin;
+    int function;
+    DECLARE_BACNET_BUF(rx, BIP_RX_BUFF_LEN);
+} bip_rx_slot_t;
+
+/*
+ * receive thread of an extra SO_REUSEPORT socket, received mpdus are handed
+ * to el_default_loop by a single producer single consumer ring
+ */
+typedef struct bip_rx_worker_s {
+    datalink_bip_t *bip;
+    int idx;
+    int sock;
+    int stop_fd;                            /* eventfd, wakes the thread to exit */
+    int notify_fd;                          /* eventfd, watched by el_default_loop */
+    el_watch_t *watch;
+    bool started;
+    pthread_t thread;
+    uint32_t head;                          /* written by worker thread only */
+    uint32_t tail;                          /* written by el_default_loop only */
+    bip_rx_slot_t *ring;
+    bip_rx_slot_t *scratch;                 /* used when the ring is full */
+    uint64_t rx_pkts;
+    uint64_t rx_batches;
+    uint64_t rx_drops;
+} bip_rx_worker_t;
 
 typedef struct fd_client_s {
     el_timer_t *timer;
@@ -193,5 +238,20 @@ extern void bdt_push_start(datalink_bip_t *bip);
 
 extern void bdt_push_stop(datalink_bip_t *bip);
 
+extern void fdt_aging_start(datalink_bip_t *bip);
+
+extern void fdt_aging_stop(datalink_bip_t *bip);
+
+/**
+ * bvlc_fdt_sweep - ɾѳʱFDT
+ *
+ * @bip: BBMD˿
+ * @now: ǰʱ䣬el_current_millisecond()
+ *
+ * @return: ɾı
+ *
+ */
+extern int bvlc_fdt_sweep(datalink_bip_t *bip, unsigned now);
+
 #endif  /* _BIP_DEF_H_ */
 
@@ -10,10 +10,13 @@
  * History
  */
 
+#define _GNU_SOURCE                         /* sendmmsg */
+
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/socket.h>
 
 #include "bacnet/bacdef.h"
 #include "bacnet/bip.h"
@@ -62,6 +65,29 @@ static int bvlc_send_mpdu(datalink_bip_t *bip, struct sockaddr_in *dst, uint8_t
     return rv;
 }
 
+/* ĿĵַͬһmpduĿĵַʧܲӰ */
+static void bvlc_send_mpdu_batch(datalink_bip_t *bip, struct mmsghdr *msgs, int cnt)
+{
+    int sent;
+    int rv;
+
+    sent = 0;
+    while (sent < cnt) {
+        rv = sendmmsg(bip->sock_uip, &msgs[sent], cnt - sent, MSG_DONTWAIT);
+        if (rv < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            BIP_ERROR("%s: sendmmsg to %s failed cause %s\r\n", __func__,
+                inet_ntoa(((struct sockaddr_in *)msgs[sent].msg_hdr.msg_name)->sin_addr),
+                strerror(errno));
+            /* skip the failed destination */
+            rv = 1;
+        }
+        sent += rv;
+    }
+}
+
 int bvlc_bdt_forward_npdu(datalink_bip_t *bip, struct sockaddr_in *src, bacnet_buf_t *npdu)
 {
     bdt_entry_t *bdt;
@@ -127,11 +153,13 @@ int bvlc_bdt_forward_npdu(datalink_bip_t *bip, struct sockaddr_in *src, bacnet_b
 
 int bvlc_fdt_forward_npdu(datalink_bip_t *bip, struct sockaddr_in *src, bacnet_buf_t *npdu)
 {
-    fdt_entry_t *entry;
-    struct sockaddr_in dst_bip;
+    struct mmsghdr msgs[FDT_SEND_BATCH];
+    struct iovec iov;
+    bbmd_data_t *bbmd;
     uint8_t *mpdu;
     uint16_t mpdu_len;
-    int i;
+    uint32_t i;
+    int cnt;
     int rv;
     
     if ((bip == NULL) || (src == NULL) || (npdu == NULL) || (npdu->data == NULL) 
@@ -159,28 +187,40 @@ int bvlc_fdt_forward_npdu(datalink_bip_t *bip, struct sockaddr_in *src, bacnet_b
     memcpy(&mpdu[4], &(src->sin_addr.s_addr), IP_ADDRESS_LEN);
     memcpy(&mpdu[8], &(src->sin_port), UDP_PORT_LEN);
 
-    RWLOCK_RDLOCK(&(bip->bbmd->fdt_lock));
+    iov.iov_base = mpdu;
+    iov.iov_len = mpdu_len;
+    memset(msgs, 0, sizeof(msgs));
+    for (cnt = 0; cnt < FDT_SEND_BATCH; cnt++) {
+        msgs[cnt].msg_hdr.msg_iov = &iov;
+        msgs[cnt].msg_hdr.msg_iovlen = 1;
+        msgs[cnt].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    bbmd = bip->bbmd;
+    cnt = 0;
 
-    hash_for_each(bip->bbmd->fdt, i, entry, hnode) {
-        dst_bip.sin_addr.s_addr = entry->dst_addr.s_addr;
-        dst_bip.sin_port = entry->dst_port;
+    RWLOCK_RDLOCK(&(bbmd->fdt_lock));
 
+    /* fdt_dst is already in sockaddr form, hand it to the kernel in batches */
+    for (i = 0; i < bbmd->fdt_size; i++) {
         /* don't send to src ip address and same port */
-        if ((dst_bip.sin_addr.s_addr == src->sin_addr.s_addr)
-                && (dst_bip.sin_port == src->sin_port)) {
+        if ((bbmd->fdt_dst[i].sin_addr.s_addr == src->sin_addr.s_addr)
+                && (bbmd->fdt_dst[i].sin_port == src->sin_port)) {
             continue;
         }
 
-        rv = bvlc_send_mpdu(bip, &dst_bip, mpdu, mpdu_len);
-        if (rv < 0) {
-            BIP_ERROR("%s: send failed(%d)\r\n", __func__, rv);
+        msgs[cnt++].msg_hdr.msg_name = &(bbmd->fdt_dst[i]);
+        if (cnt == FDT_SEND_BATCH) {
+            bvlc_send_mpdu_batch(bip, msgs, cnt);
+            cnt = 0;
         }
+    }
 
-        BIP_VERBOS("%s: %s:%04X\r\n", __func__, inet_ntoa(dst_bip.sin_addr),
-            ntohs(dst_bip.sin_port));
+    if (cnt) {
+        bvlc_send_mpdu_batch(bip, msgs, cnt);
     }
 
-    RWLOCK_UNLOCK(&(bip->bbmd->fdt_lock));
+    RWLOCK_UNLOCK(&(bbmd->fdt_lock));
 
     (void)bacnet_buf_pull(npdu, FORWARDED_NPDU_HDR_LEN);
 
@@ -353,10 +393,11 @@ int bvlc_send_read_fdt(datalink_bip_t *bip, struct sockaddr_in *dst_bbmd)
 
 static int bvlc_send_read_fdt_ack(datalink_bip_t *bip, struct sockaddr_in *dst)
 {
-    fdt_entry_t *entry;
+    bbmd_data_t *bbmd;
     uint16_t mpdu_len;
+    uint32_t entries;
     int offset;
-    int i;
+    uint32_t i;
     int rv;
     
     if ((dst == NULL) || (!bip)) {
@@ -369,9 +410,17 @@ static int bvlc_send_read_fdt_ack(datalink_bip_t *bip, struct sockaddr_in *dst)
         return -EPERM;
     }
 
-    RWLOCK_RDLOCK(&(bip->bbmd->fdt_lock));
+    bbmd = bip->bbmd;
+    RWLOCK_RDLOCK(&(bbmd->fdt_lock));
+
+    entries = bbmd->fdt_size;
+    if (entries > FDT_ACK_MAX_ENTRIES) {
+        BIP_WARN("%s: FDT(%d) truncated to %d entries\r\n", __func__, entries,
+            FDT_ACK_MAX_ENTRIES);
+        entries = FDT_ACK_MAX_ENTRIES;
+    }
     
-    mpdu_len = BVLC_HDR_LEN + (FD_TABLE_ENTRY_SIZE * bip->bbmd->fdt_size);
+    mpdu_len = BVLC_HDR_LEN + (FD_TABLE_ENTRY_SIZE * entries);
     uint8_t mpdu[mpdu_len];
     
     mpdu[0] = BVLL_TYPE_BACNET_IP;
@@ -380,20 +429,20 @@ static int bvlc_send_read_fdt_ack(datalink_bip_t *bip, struct sockaddr_in *dst)
     
     offset = BVLC_DATA_OFFSET;
     unsigned now = el_current_millisecond();
-    hash_for_each(bip->bbmd->fdt, i, entry, hnode) {
-        unsigned remaining = el_timer_expire(entry->timer) - now;
+    for (i = 0; i < entries; i++) {
+        unsigned remaining = bbmd->fdt[i].expire - now;
         if (remaining > 65535*1000)
             remaining = 0;
 
-        memcpy(&mpdu[offset], &(entry->dst_addr.s_addr), IP_ADDRESS_LEN);
+        memcpy(&mpdu[offset], &(bbmd->fdt_dst[i].sin_addr.s_addr), IP_ADDRESS_LEN);
         offset += IP_ADDRESS_LEN;
-        memcpy(&mpdu[offset], &(entry->dst_port), UDP_PORT_LEN);
+        memcpy(&mpdu[offset], &(bbmd->fdt_dst[i].sin_port), UDP_PORT_LEN);
         offset += UDP_PORT_LEN;
-        offset += encode_unsigned16(&mpdu[offset], entry->time_to_live);
+        offset += encode_unsigned16(&mpdu[offset], bbmd->fdt[i].time_to_live);
         offset += encode_unsigned16(&mpdu[offset], remaining/1000);
     }
 
-    RWLOCK_UNLOCK(&(bip->bbmd->fdt_lock));
+    RWLOCK_UNLOCK(&(bbmd->fdt_lock));
     
     rv = bvlc_send_mpdu(bip, dst, mpdu, mpdu_len);
     if (rv < 0) {
@@ -631,6 +680,7 @@ int bvlc_receive_read_bdt_ack(datalink_bip_t *bip, bacnet_buf_t *mpdu)
 int bvlc_receive_forwarded_npdu(datalink_bip_t *bip, struct sockaddr_in *src, bacnet_buf_t *mpdu)
 {
     struct sockaddr_in dst_bip;
+    bool two_hop;
     int rv;
 
     if ((bip == NULL) || (src == NULL) || (mpdu == NULL) || (mpdu->data == NULL) 
@@ -645,7 +695,11 @@ int bvlc_receive_forwarded_npdu(datalink_bip_t *bip, struct sockaddr_in *src, ba
     }
 
     /* route not support broadcast, send to BBMD's subnet using the B/IP broadcast address */
-    if (bip->bbmd->bdt[bip->bbmd->local_entry].bcast_mask.s_addr == -1) {
+    RWLOCK_RDLOCK(&(bip->bbmd->bdt_lock));
+    two_hop = (bip->bbmd->bdt[bip->bbmd->local_entry].bcast_mask.s_addr == -1);
+    RWLOCK_UNLOCK(&(bip->bbmd->bdt_lock));
+    
+    if (two_hop) {
         dst_bip.sin_addr.s_addr = bip->bcast_sin.sin_addr.s_addr;
         dst_bip.sin_port = bip->bcast_sin.sin_port;
 
@@ -671,34 +725,210 @@ int bvlc_receive_forwarded_npdu(datalink_bip_t *bip, struct sockaddr_in *src, ba
     return rv;   
 }
 
-/* BBMD豸ⲿ豸ϻ */
-static void fdt_aging(el_timer_t *timer)
+static inline uint32_t fdt_hash(bbmd_data_t *bbmd, struct in_addr addr, uint16_t port)
 {
-    fdt_entry_t *entry = (fdt_entry_t*)timer->data;
-    bbmd_data_t *bbmd = entry->bbmd;
+    return hash_32(ROTATE_LEFT(addr.s_addr, 16) + port, bbmd->fdt_index_bits);
+}
 
-    BIP_VERBOS("%s: foreign device %s:%04X timeout(%d seconds)\r\n", __func__,
-        inet_ntoa(entry->dst_addr),
-        ntohs(entry->dst_port),
-        entry->time_to_live);
+/* ⲿ豸fdtеλãڷ-1 */
+static int fdt_lookup(bbmd_data_t *bbmd, struct in_addr addr, uint16_t port)
+{
+    uint32_t mask;
+    uint32_t slot;
+    uint32_t idx;
 
-    RWLOCK_WRLOCK(&(bbmd->fdt_lock));
+    if (bbmd->fdt_index == NULL) {
+        return -1;
+    }
 
-    hash_del(&entry->hnode);
-    free(entry);
+    mask = (1U << bbmd->fdt_index_bits) - 1;
+    for (slot = fdt_hash(bbmd, addr, port); (idx = bbmd->fdt_index[slot]) != 0;
+            slot = (slot + 1) & mask) {
+        idx--;
+        if ((bbmd->fdt_dst[idx].sin_addr.s_addr == addr.s_addr)
+                && (bbmd->fdt_dst[idx].sin_port == port)) {
+            return idx;
+        }
+    }
 
-    if (bbmd->fdt_size)
-        bbmd->fdt_size--;
+    return -1;
+}
 
-    RWLOCK_UNLOCK(&(bbmd->fdt_lock));
+/* fdtеidxڵ */
+static uint32_t fdt_index_slot(bbmd_data_t *bbmd, uint32_t idx)
+{
+    uint32_t mask;
+    uint32_t slot;
+
+    mask = (1U << bbmd->fdt_index_bits) - 1;
+    slot = fdt_hash(bbmd, bbmd->fdt_dst[idx].sin_addr, bbmd->fdt_dst[idx].sin_port);
+    while (bbmd->fdt_index[slot] != idx + 1) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static void fdt_index_insert(bbmd_data_t *bbmd, uint32_t idx)
+{
+    uint32_t mask;
+    uint32_t slot;
+
+    mask = (1U << bbmd->fdt_index_bits) - 1;
+    slot = fdt_hash(bbmd, bbmd->fdt_dst[idx].sin_addr, bbmd->fdt_dst[idx].sin_port);
+    while (bbmd->fdt_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    bbmd->fdt_index[slot] = idx + 1;
+}
+
+/* ̽ɾղԱ̽ */
+static void fdt_index_remove(bbmd_data_t *bbmd, uint32_t slot)
+{
+    uint32_t mask;
+    uint32_t next;
+    uint32_t home;
+    uint32_t idx;
+
+    mask = (1U << bbmd->fdt_index_bits) - 1;
+    next = slot;
+    for (;;) {
+        next = (next + 1) & mask;
+        idx = bbmd->fdt_index[next];
+        if (idx == 0) {
+            break;
+        }
+        idx--;
+        home = fdt_hash(bbmd, bbmd->fdt_dst[idx].sin_addr, bbmd->fdt_dst[idx].sin_port);
+        /* move only when home is not cyclically within (slot, next] */
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            bbmd->fdt_index[slot] = bbmd->fdt_index[next];
+            slot = next;
+        }
+    }
+    bbmd->fdt_index[slot] = 0;
+}
+
+/* ݣΪϣ߳д */
+static int fdt_grow(bbmd_data_t *bbmd)
+{
+    struct sockaddr_in *dst;
+    fdt_entry_t *fdt;
+    uint32_t *index;
+    uint32_t capacity;
+    uint32_t bits;
+    uint32_t i;
+
+    capacity = bbmd->fdt_capacity? bbmd->fdt_capacity * 2: FDT_MIN_CAPACITY;
+    if (capacity > bbmd->fdt_max) {
+        capacity = bbmd->fdt_max;
+    }
+
+    bits = 1;
+    while ((1U << bits) < capacity * 2) {
+        bits++;
+    }
+
+    index = (uint32_t *)calloc(1U << bits, sizeof(uint32_t));
+    if (index == NULL) {
+        return -ENOMEM;
+    }
+
+    dst = (struct sockaddr_in *)realloc(bbmd->fdt_dst, sizeof(struct sockaddr_in) * capacity);
+    if (dst == NULL) {
+        free(index);
+        return -ENOMEM;
+    }
+    bbmd->fdt_dst = dst;
+
+    fdt = (fdt_entry_t *)realloc(bbmd->fdt, sizeof(fdt_entry_t) * capacity);
+    if (fdt == NULL) {
+        free(index);
+        return -ENOMEM;
+    }
+    bbmd->fdt = fdt;
+
+    free(bbmd->fdt_index);
+    bbmd->fdt_index = index;
+    bbmd->fdt_index_bits = bits;
+    bbmd->fdt_capacity = capacity;
+
+    for (i = 0; i < bbmd->fdt_size; i++) {
+        fdt_index_insert(bbmd, i);
+    }
+
+    return OK;
+}
+
+/* ɾfdtеidxĩλ߳д */
+static void fdt_remove(bbmd_data_t *bbmd, uint32_t idx)
+{
+    uint32_t last;
+
+    fdt_index_remove(bbmd, fdt_index_slot(bbmd, idx));
+
+    last = bbmd->fdt_size - 1;
+    if (idx != last) {
+        bbmd->fdt_index[fdt_index_slot(bbmd, last)] = idx + 1;
+        bbmd->fdt_dst[idx] = bbmd->fdt_dst[last];
+        bbmd->fdt[idx] = bbmd->fdt[last];
+    }
+    bbmd->fdt_size = last;
+}
+
+int bvlc_fdt_sweep(datalink_bip_t *bip, unsigned now)
+{
+    bbmd_data_t *bbmd;
+    uint32_t i;
+    int purged;
+
+    if ((bip == NULL) || (bip->bbmd == NULL)) {
+        BIP_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    bbmd = bip->bbmd;
+    purged = 0;
+
+    /* only el_default_loop modifies fdt, scan without lock */
+    for (i = 0; i < bbmd->fdt_size; i++) {
+        if ((int)(bbmd->fdt[i].expire - now) > 0) {
+            continue;
+        }
+
+        RWLOCK_WRLOCK(&(bbmd->fdt_lock));
+        /* swap-remove may move another expired entry into i, check again */
+        while ((i < bbmd->fdt_size) && ((int)(bbmd->fdt[i].expire - now) <= 0)) {
+            BIP_VERBOS("%s: foreign device %s:%04X timeout(%d seconds)\r\n", __func__,
+                inet_ntoa(bbmd->fdt_dst[i].sin_addr),
+                ntohs(bbmd->fdt_dst[i].sin_port),
+                bbmd->fdt[i].time_to_live);
+            fdt_remove(bbmd, i);
+            purged++;
+        }
+        RWLOCK_UNLOCK(&(bbmd->fdt_lock));
+    }
+
+    return purged;
+}
+
+/* BBMD豸ⲿ豸ʱϻ */
+static void fdt_aging(el_timer_t *timer)
+{
+    datalink_bip_t *bip = (datalink_bip_t *)timer->data;
+
+    (void)bvlc_fdt_sweep(bip, el_current_millisecond());
+
+    el_timer_mod(&el_default_loop, timer, FDT_SWEEP_INTERVAL);
 }
 
 int bvlc_receive_register_foreign_device(datalink_bip_t *bip, struct sockaddr_in *src, 
         bacnet_buf_t *mpdu)
 {
-    fdt_entry_t *entry;
+    bbmd_data_t *bbmd;
     BACNET_BVLC_RESULT result_code;
     uint16_t time_to_live;
+    uint32_t idx;
     bool status;
     int rv;
     
@@ -717,58 +947,50 @@ int bvlc_receive_register_foreign_device(datalink_bip_t *bip, struct sockaddr_in
 
     (void)decode_unsigned16(&(mpdu->data[BVLC_DATA_OFFSET]), &time_to_live);
 
+    bbmd = bip->bbmd;
     status = false;
 
-    RWLOCK_WRLOCK(&(bip->bbmd->fdt_lock));
-
-    unsigned key = (ROTATE_LEFT(src->sin_addr.s_addr, 16)) + src->sin_port;
-
-    hash_for_each_possible(bip->bbmd->fdt, entry, hnode, key) {
-        if (entry->dst_addr.s_addr == src->sin_addr.s_addr
-                && entry->dst_port == src->sin_port) {
-            entry->time_to_live = time_to_live;
-            el_timer_mod(&el_default_loop, entry->timer, time_to_live*1000);
-            status = true;
-            goto out;
-        }
+    rv = fdt_lookup(bbmd, src->sin_addr, src->sin_port);
+    if (rv >= 0) {
+        /* fdt_lock only guards against readers, a refresh is a plain store */
+        bbmd->fdt[rv].time_to_live = time_to_live;
+        bbmd->fdt[rv].expire = el_current_millisecond() + time_to_live*1000;
+        status = true;
+        goto reply;
     }
 
-    if (bip->bbmd->fdt_size >= FDT_MAX_SIZE) {
-        BIP_ERROR("%s: FTD is already full\r\n", __func__);
-        status = false;
-        goto out;
-    }
+    RWLOCK_WRLOCK(&(bbmd->fdt_lock));
 
-    entry = (fdt_entry_t*)malloc(sizeof(fdt_entry_t));
-    if (!entry) {
-        BIP_ERROR("%s: not enough memory\r\n", __func__);
+    if (bbmd->fdt_size >= bbmd->fdt_max) {
+        BIP_ERROR("%s: FTD is already full\r\n", __func__);
         status = false;
         goto out;
     }
-    memset(entry, 0, sizeof(fdt_entry_t));
 
-    entry->dst_addr = src->sin_addr;
-    entry->dst_port = src->sin_port;
-    entry->bbmd = bip->bbmd;
-    entry->time_to_live = time_to_live;
-    entry->timer = el_timer_create(&el_default_loop, time_to_live*1000);
-    if (!entry->timer) {
-        BIP_ERROR("%s: create timer failed\r\n", __func__);
-        free(entry);
-        status = false;
-        goto out;
+    if (bbmd->fdt_size >= bbmd->fdt_capacity) {
+        rv = fdt_grow(bbmd);
+        if (rv < 0) {
+            BIP_ERROR("%s: not enough memory\r\n", __func__);
+            status = false;
+            goto out;
+        }
     }
-    entry->timer->data = entry;
-    entry->timer->handler = fdt_aging;
 
-    hash_add(bip->bbmd->fdt, &entry->hnode, key);
-    bip->bbmd->fdt_size++;
+    idx = bbmd->fdt_size++;
+    memset(&(bbmd->fdt_dst[idx]), 0, sizeof(struct sockaddr_in));
+    bbmd->fdt_dst[idx].sin_family = AF_INET;
+    bbmd->fdt_dst[idx].sin_addr = src->sin_addr;
+    bbmd->fdt_dst[idx].sin_port = src->sin_port;
+    bbmd->fdt[idx].time_to_live = time_to_live;
+    bbmd->fdt[idx].expire = el_current_millisecond() + time_to_live*1000;
+    fdt_index_insert(bbmd, idx);
 
     status = true;
 
 out:
-    RWLOCK_UNLOCK(&(bip->bbmd->fdt_lock));
+    RWLOCK_UNLOCK(&(bbmd->fdt_lock));
 
+reply:
     if (status) {
         result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
     } else {
@@ -864,7 +1086,6 @@ int bvlc_receive_read_fdt_ack(datalink_bip_t *bip, bacnet_buf_t *mpdu)
 
 int bvlc_receive_delete_fdt_entry(datalink_bip_t *bip, struct sockaddr_in *src, bacnet_buf_t *mpdu)
 {
-    fdt_entry_t *entry;
     BACNET_BVLC_RESULT result_code;
     struct in_addr sin;
     uint16_t port;
@@ -889,25 +1110,14 @@ int bvlc_receive_delete_fdt_entry(datalink_bip_t *bip, struct sockaddr_in *src,
 
     status = false;
 
-    RWLOCK_WRLOCK(&(bip->bbmd->fdt_lock));
-
-    unsigned key = (ROTATE_LEFT(sin.s_addr, 16)) + port;
-
-    hash_for_each_possible(bip->bbmd->fdt, entry, hnode, key) {
-        if (entry->dst_addr.s_addr == sin.s_addr
-                && entry->dst_port == port) {
-            el_timer_destroy(&el_default_loop, entry->timer);
-            hash_del(&entry->hnode);
-            free(entry);
-            if (bip->bbmd->fdt_size)
-                bip->bbmd->fdt_size--;
-            status = true;
-            break;
-        }
+    rv = fdt_lookup(bip->bbmd, sin, port);
+    if (rv >= 0) {
+        RWLOCK_WRLOCK(&(bip->bbmd->fdt_lock));
+        fdt_remove(bip->bbmd, rv);
+        RWLOCK_UNLOCK(&(bip->bbmd->fdt_lock));
+        status = true;
     }
 
-    RWLOCK_UNLOCK(&(bip->bbmd->fdt_lock));
-
     if (status) {
         result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
     } else {
@@ -1083,6 +1293,7 @@ bbmd_data_t *bbmd_create(void)
         return NULL;
     }
     memset(bbmd, 0, sizeof(bbmd_data_t));
+    bbmd->fdt_max = FDT_DEFAULT_MAX_SIZE;
 
     rv = pthread_rwlock_init(&(bbmd->fdt_lock), NULL);
     if (rv) {
@@ -1101,23 +1312,18 @@ bbmd_data_t *bbmd_create(void)
     return bbmd;
 }
 
-void bbmd_destroy(bbmd_data_t *bbmd)
+/* run on el_default_loop, so neither timer handler is using bbmd */
+static void _bbmd_destroy(void *arg)
 {
-    struct hlist_node *tmp;
-    fdt_entry_t *entry;
-    int i;
+    bbmd_data_t *bbmd = (bbmd_data_t *)arg;
     
-    if (bbmd == NULL) {
-        BIP_ERROR("%s: null argument\r\n", __func__);
-        return;
+    if (bbmd->fdt_timer) {
+        el_timer_destroy(&el_default_loop, bbmd->fdt_timer);
     }
 
-    el_sync(&el_default_loop);
-    
-    hash_for_each_safe(bbmd->fdt, i, entry, tmp, hnode) {
-        el_timer_destroy(&el_default_loop, entry->timer);
-        free(entry);
-    }
+    free(bbmd->fdt_dst);
+    free(bbmd->fdt);
+    free(bbmd->fdt_index);
 
     if (bbmd->bdt) {
         free(bbmd->bdt);
@@ -1128,7 +1334,16 @@ void bbmd_destroy(bbmd_data_t *bbmd)
     }
 
     free(bbmd);
-    el_unsync(&el_default_loop);
+}
+
+void bbmd_destroy(bbmd_data_t *bbmd)
+{
+    if (bbmd == NULL) {
+        BIP_ERROR("%s: null argument\r\n", __func__);
+        return;
+    }
+
+    (void)el_call(&el_default_loop, _bbmd_destroy, bbmd);
 }
 
 /* ʱԶBBMD豸BDT */
@@ -1238,3 +1453,43 @@ void bdt_push_stop(datalink_bip_t *bip)
     RWLOCK_UNLOCK(&(bip->bbmd->bdt_lock));
 }
 
+void fdt_aging_start(datalink_bip_t *bip)
+{
+    if (bip == NULL) {
+        BIP_ERROR("%s: null argument\r\n", __func__);
+        return;
+    }
+
+    if (bip->bbmd == NULL) {
+        return;
+    }
+
+    if (bip->bbmd->fdt_timer == NULL) {
+        bip->bbmd->fdt_timer = el_timer_create(&el_default_loop, FDT_SWEEP_INTERVAL);
+        if (bip->bbmd->fdt_timer == NULL) {
+            BIP_ERROR("%s: create timer failed\r\n", __func__);
+            return;
+        }
+        bip->bbmd->fdt_timer->handler = fdt_aging;
+        bip->bbmd->fdt_timer->data = bip;
+    } else {
+        el_timer_mod(&el_default_loop, bip->bbmd->fdt_timer, FDT_SWEEP_INTERVAL);
+    }
+}
+
+void fdt_aging_stop(datalink_bip_t *bip)
+{
+    if (bip == NULL) {
+        BIP_ERROR("%s: null argument\r\n", __func__);
+        return;
+    }
+
+    if (bip->bbmd == NULL) {
+        return;
+    }
+
+    if (bip->bbmd->fdt_timer) {
+        el_timer_destroy(&el_default_loop, bip->bbmd->fdt_timer);
+        bip->bbmd->fdt_timer = NULL;
+    }
+}
@@ -20,6 +20,8 @@
 #include "bacnet/mstp.h"
 #include "bacnet/bip.h"
 #include "bacnet/etherdl.h"
+#include "bacnet/virtualdl.h"
+#include "bacnet/pcapdl.h"
 #include "debug.h"
 #include "bacnet/bacnet.h"
 #include "bacnet/bactext.h"
@@ -108,6 +110,20 @@ datalink_base_t *datalink_port_create(cJSON *cfg, cJSON *res)
         } else {
             dl->type = DL_ETHERNET;
         }
+    } else if (strcmp(dl_cfg->valuestring, "VIRTUAL") == 0) {
+        dl = (datalink_base_t *)vdl_port_create(cfg, res);
+        if (!dl) {
+            DL_ERROR("%s: create virtual failed\r\n", __func__);
+        } else {
+            dl->type = DL_VIRTUAL;
+        }
+    } else if (strcmp(dl_cfg->valuestring, "PCAP") == 0) {
+        dl = (datalink_base_t *)pcapdl_port_create(cfg, res);
+        if (!dl) {
+            DL_ERROR("%s: create pcap failed\r\n", __func__);
+        } else {
+            dl->type = DL_PCAP;
+        }
     } else {
         DL_ERROR("%s: unsupported dl_type:(%s)\r\n", __func__, dl_cfg->valuestring);
     }
@@ -139,6 +155,14 @@ int datalink_port_delete(datalink_base_t *dl_port)
     case DL_ETHERNET:
         rv = ether_port_delete((datalink_ether_t *)dl_port);
         break;
+
+    case DL_VIRTUAL:
+        rv = vdl_port_delete((datalink_vdl_t *)dl_port);
+        break;
+
+    case DL_PCAP:
+        rv = pcapdl_port_delete((datalink_pcap_t *)dl_port);
+        break;
     
     default:
         DL_ERROR("%s: unsupported dl_type(%d)\r\n", __func__, dl_port->type);
@@ -228,9 +252,27 @@ int datalink_init(void)
         goto err3;
     }
 
+    rv = vdl_init();
+    if (rv < 0) {
+        DL_ERROR("%s: virtual init failed(%d)\r\n", __func__, rv);
+        goto err4;
+    }
+
+    rv = pcapdl_init();
+    if (rv < 0) {
+        DL_ERROR("%s: pcap init failed(%d)\r\n", __func__, rv);
+        goto err5;
+    }
+
     DL_VERBOS("%s: OK\r\n", __func__);
     return OK;
 
+err5:
+    vdl_exit();
+
+err4:
+    ether_exit();
+
 err3:
     bip_exit();
 
@@ -262,11 +304,29 @@ int datalink_startup(void)
         DL_ERROR("%s: ether startup failed(%d)\r\n", __func__, rv);
         goto err2;
     }
+
+    rv = vdl_startup();
+    if (rv < 0) {
+        DL_ERROR("%s: virtual startup failed(%d)\r\n", __func__, rv);
+        goto err3;
+    }
+
+    rv = pcapdl_startup();
+    if (rv < 0) {
+        DL_ERROR("%s: pcap startup failed(%d)\r\n", __func__, rv);
+        goto err4;
+    }
     
     datalink_set_dbg_level(0);
 
     return OK;
 
+err4:
+    vdl_stop();
+
+err3:
+    ether_stop();
+
 err2:
     bip_stop();
 
@@ -279,6 +339,8 @@ err0:
 
 void datalink_stop(void)
 {
+    pcapdl_stop();
+    vdl_stop();
     ether_stop();
     bip_stop();
     mstp_stop();
@@ -286,6 +348,8 @@ void datalink_stop(void)
 
 void datalink_clean(void)
 {
+    pcapdl_clean();
+    vdl_clean();
     ether_clean();
     bip_clean();
     mstp_clean();
@@ -324,13 +388,19 @@ cJSON *datalink_get_status(connect_info_t *conn, cJSON *request)
         reply = mstp_get_status(request);
     } else if (strcmp(str, "ethernet") == 0) {
         reply = ether_get_status(request);
+    } else if (strcmp(str, "virtual") == 0) {
+        reply = vdl_get_status(request);
+    } else if (strcmp(str, "pcap") == 0) {
+        reply = pcapdl_get_status(request);
     } else {
         DL_ERROR("%s: invalid dl_type(%s)\r\n", __func__, tmp->valuestring);
         error_code = -1;
         reason = "invalid dl_type, dl_type should be:\r\n"
             "bip\r\n"
             "mstp\r\n"
-            "ethernet\r\n";
+            "ethernet\r\n"
+            "virtual\r\n"
+            "pcap\r\n";
         goto err;
     }
 
@@ -17,6 +17,8 @@
 #include <stdbool.h>
 #include <net/if.h>
 
+#include "misc/trace.h"
+
 extern bool dl_dbg_err;
 extern bool dl_dbg_warn;
 extern bool dl_dbg_verbos;
@@ -24,21 +26,21 @@ extern bool dl_dbg_verbos;
 #define DL_ERROR(fmt, args...)                      \
 do {                                                \
     if (dl_dbg_err) {                               \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define DL_WARN(fmt, args...)                       \
 do {                                                \
     if (dl_dbg_warn) {                              \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define DL_VERBOS(fmt, args...)                     \
 do {                                                \
     if (dl_dbg_verbos) {                            \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
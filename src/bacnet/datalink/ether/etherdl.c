@@ -11,8 +11,10 @@
 #include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
 #include <arpa/inet.h>
 #include <linux/if_ether.h>
+#include <linux/filter.h>
 
 #include "etherdl_def.h"
 #include "bacnet/etherdl.h"
@@ -27,6 +29,134 @@ bool ether_dbg_verbos = true;
 bool ether_dbg_warn = true;
 bool ether_dbg_err = true;
 
+/* check one 802.3 frame, pdu points to the destination mac, return npdu length or -1 */
+static int ether_rx_check(datalink_ether_t *ether, const uint8_t *pdu, uint32_t len,
+            bacnet_addr_t *src_mac)
+{
+    uint16_t pdu_len;
+
+    if (len < ETH_802_3_HEADER) {
+        ETH_ERROR("%s: not enough byte(%d) for header\r\n", __func__, len);
+        return -1;
+    }
+
+    (void)decode_unsigned16(&pdu[12], &pdu_len);
+    if (pdu_len > len - ETH_802_3_HEADER) {
+        ETH_ERROR("%s: not enough byte(%d) for eth packet length(%d)\r\n", __func__, len, pdu_len);
+        return -1;
+    }
+    
+    if (pdu_len < 3) {
+        ETH_VERBOS("%s: too short mpdu length(%d), maybe not bacnet\r\n", __func__, pdu_len);
+        return -1;
+    }
+
+    if (pdu[14] != 0x82 || pdu[15] != 0x82 || pdu[16] != 0x03) {    /* not bacnet */
+        return -1;
+    }
+
+    ether->dl.rx_all++;
+    
+    if ((memcmp(&pdu[0], ether->mac, 6) != 0) && (memcmp(&pdu[0], broadcast_mac, 6) != 0)) {    /* not for me */
+        return -1;
+    }
+    
+    if (memcmp(&pdu[6], ether->mac, 6) == 0) {  /* from me */
+        ETH_WARN("%s: send by myself\r\n", __func__);
+        return -1;
+    }
+
+    src_mac->net = 0;
+    src_mac->len = 6;
+    memcpy(src_mac->adr, &pdu[6], 6);
+
+    ether->dl.rx_ok++;
+    ETH_VERBOS("%s: received a pdu, length(%d)\r\n", __func__, pdu_len - 3);
+
+    return pdu_len - 3;
+}
+
+/* add frames dropped by kernel since last read, the counter is reset by reading */
+static void ether_update_drops(datalink_ether_t *ether)
+{
+    struct tpacket_stats_v3 stats;
+    socklen_t len;
+
+    len = sizeof(stats);
+    if (getsockopt(ether->fd, SOL_PACKET, PACKET_STATISTICS, &stats, &len) < 0) {
+        ETH_WARN("%s: get statistics failed cause %s\r\n", __func__, strerror(errno));
+        return;
+    }
+
+    (void)__atomic_add_fetch(&ether->rx_drops, stats.tp_drops, __ATOMIC_RELAXED);
+}
+
+/**
+ * ether_ring_handler - rx ring֡
+ *
+ * @watch: ¼
+ * @events: ¼
+ *
+ * ÿλѴѽû̬block
+ *
+ * @return: void
+ *
+ */
+static void ether_ring_handler(el_watch_t *watch, int events)
+{
+    datalink_ether_t *ether;
+    struct tpacket_block_desc *pbd;
+    struct tpacket3_hdr *ppd;
+    uint32_t budget, status, num, i;
+    bacnet_addr_t src_mac;
+    uint8_t *pdu;
+    int rv;
+    DECLARE_BACNET_BUF(rx, MAX_ETH_NPDU);
+
+    if (!(events & EPOLLIN)) {
+        ETH_ERROR("%s: invalid events\r\n", __func__);
+        return;
+    }
+
+    ether = (datalink_ether_t *)watch->data;
+    if (!ether) {
+        ETH_ERROR("%s: null ether argument\r\n", __func__);
+        return;
+    }
+
+    /* stay fair to other watches, the fd is still readable if more blocks are ready */
+    for (budget = ether->block_nr; budget > 0; budget--) {
+        pbd = (struct tpacket_block_desc *)(ether->ring + ether->block_idx * ether->block_size);
+        status = __atomic_load_n(&pbd->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+        if (!(status & TP_STATUS_USER)) {
+            break;
+        }
+
+        if (status & TP_STATUS_LOSING) {
+            ether_update_drops(ether);
+        }
+
+        num = pbd->hdr.bh1.num_pkts;
+        ppd = (struct tpacket3_hdr *)((uint8_t *)pbd + pbd->hdr.bh1.offset_to_first_pkt);
+        for (i = 0; i < num; i++) {
+            pdu = (uint8_t *)ppd + ppd->tp_mac;
+            rv = ether_rx_check(ether, pdu, ppd->tp_snaplen, &src_mac);
+            if (rv >= 0) {
+                /* copied out of the ring, network layer needs headroom of the buffer to relay */
+                bacnet_buf_init(&rx.buf, MAX_ETH_NPDU);
+                memcpy(rx.buf.data, &pdu[ETH_MPDU_ALL_HEADER], rv);
+                rx.buf.data_len = rv;
+                (void)network_receive_pdu(ether->dl.port_id, &rx.buf, &src_mac);
+            }
+            ppd = (struct tpacket3_hdr *)((uint8_t *)ppd + ppd->tp_next_offset);
+        }
+
+        __atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        ether->block_idx = (ether->block_idx + 1) % ether->block_nr;
+        ether->rx_blocks++;
+    }
+}
+
 /**
  * ether_event_handler - ether֡ӿ
  *
@@ -43,7 +173,6 @@ static void ether_event_handler(el_watch_t *watch, int events)
     int rv;
     bacnet_addr_t src_mac;
     uint8_t *pdu;
-    uint16_t pdu_len;
     DECLARE_BACNET_BUF(rx, MAX_ETH_802_3_LEN);
 
     if (!(events & EPOLLIN)) {
@@ -78,45 +207,13 @@ static void ether_event_handler(el_watch_t *watch, int events)
         return;
     }
 
-    if (rv < ETH_802_3_HEADER) {
-        ETH_ERROR("%s: not enough byte(%d) for header\r\n", __func__, rv);
-        return;
-    }
-
-    (void)decode_unsigned16(&pdu[12], &pdu_len);
-    if (pdu_len > rv - ETH_802_3_HEADER) {
-        ETH_ERROR("%s: not enough byte(%d) for eth packet length(%d)\r\n", __func__, rv, pdu_len);
-        return;
-    }
-    
-    if (pdu_len < 3) {
-        ETH_VERBOS("%s: too short mpdu length(%d), maybe not bacnet\r\n", __func__, pdu_len);
-        return;
-    }
-
-    if (pdu[14] != 0x82 || pdu[15] != 0x82 || pdu[16] != 0x03) {    /* not bacnet */
-        return;
-    }
-
-    ether->dl.rx_all++;
-    
-    if ((memcmp(&pdu[0], ether->mac, 6) != 0) && (memcmp(&pdu[0], broadcast_mac, 6) != 0)) {    /* not for me */
-        return;
-    }
-    
-    if (memcmp(&pdu[6], ether->mac, 6) == 0) {  /* from me */
-        ETH_WARN("%s: send by myself\r\n", __func__);
+    rv = ether_rx_check(ether, pdu, rv, &src_mac);
+    if (rv < 0) {
         return;
     }
 
-    src_mac.net = 0;
-    src_mac.len = 6;
-    memcpy(src_mac.adr, &pdu[6], 6);
     rx.buf.data += ETH_MPDU_ALL_HEADER;
-    rx.buf.data_len = pdu_len - 3;
-
-    ether->dl.rx_ok++;
-    ETH_VERBOS("%s: received a pdu, length(%d)\r\n", __func__, pdu_len - 3);
+    rx.buf.data_len = rv;
     (void)network_receive_pdu(ether->dl.port_id, &rx.buf, &src_mac);   
 }
 
@@ -208,6 +305,148 @@ static int ether_send_pdu(datalink_ether_t *ether, bacnet_addr_t *dst_mac, bacne
     return rv;
 }
 
+/**
+ * ether_attach_filter - ںй˷Ǳ˿ڵBACnet֡
+ *
+ * @ether: ˿ڶmacѻȡ
+ *
+ * ֻĿĵַΪ㲥802.3 LLC 82 82 03֡֡ٿû̬
+ *
+ * @return: ɹ0ʧܷظ
+ *
+ */
+static int ether_attach_filter(datalink_ether_t *ether)
+{
+    uint32_t mac_hi, mac_lo;
+    struct sock_fprog prog;
+
+    mac_hi = ((uint32_t)ether->mac[0] << 24) | ((uint32_t)ether->mac[1] << 16)
+        | ((uint32_t)ether->mac[2] << 8) | ether->mac[3];
+    mac_lo = ((uint32_t)ether->mac[4] << 8) | ether->mac[5];
+
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12),                     /* 802.3 length */
+        BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, MAX_ETH_PDU, 12, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 14),                     /* LLC */
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xffffff00),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_LLC_BACNET, 0, 9),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 0),                      /* unicast to me */
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, mac_hi, 0, 2),
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 4),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, mac_lo, 4, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 0),                      /* broadcast */
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0xffffffff, 0, 3),
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 4),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0xffff, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xffff),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+    if (setsockopt(ether->fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+        ETH_ERROR("%s: attach filter failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    return OK;
+}
+
+/**
+ * ether_setup_ring - TPACKET_V3ջ
+ *
+ * @ether: ˿ڶblock_size/block_nr
+ *
+ * ʧʱether->ringΪNULLʹrecv()֡
+ *
+ * @return: ɹ0ʧܷظ
+ *
+ */
+static int ether_setup_ring(datalink_ether_t *ether)
+{
+    struct tpacket_req3 req;
+    int version;
+    void *ring;
+
+    version = TPACKET_V3;
+    if (setsockopt(ether->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        ETH_WARN("%s: set TPACKET_V3 failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = ether->block_size;
+    req.tp_block_nr = ether->block_nr;
+    req.tp_frame_size = ETH_RING_FRAME_SIZE;
+    req.tp_frame_nr = (ether->block_size / ETH_RING_FRAME_SIZE) * ether->block_nr;
+    req.tp_retire_blk_tov = ETH_RING_BLOCK_TIMEOUT;
+    if (setsockopt(ether->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        ETH_WARN("%s: set rx ring failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    ring = mmap(NULL, ether->block_size * ether->block_nr, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_LOCKED, ether->fd, 0);
+    if (ring == MAP_FAILED) {
+        ETH_WARN("%s: mmap rx ring failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    ether->ring = (uint8_t *)ring;
+    ether->ring_size = ether->block_size * ether->block_nr;
+    ether->block_idx = 0;
+
+    return OK;
+}
+
+static int ether_cfg_get_number(cJSON *cfg, const char *name, uint32_t min, uint32_t max,
+            uint32_t *value)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, name);
+    if (tmp == NULL) {
+        return OK;
+    }
+
+    if ((tmp->type != cJSON_Number) || (tmp->valueint < (int)min)
+            || ((uint32_t)tmp->valueint > max)) {
+        ETH_ERROR("%s: invalid %s item\r\n", __func__, name);
+        return -EINVAL;
+    }
+
+    *value = (uint32_t)tmp->valueint;
+    cJSON_DeleteItemFromObject(cfg, name);
+
+    return OK;
+}
+
+static cJSON *ether_get_mib(datalink_base_t *dl_port)
+{
+    datalink_ether_t *ether;
+    cJSON *result;
+
+    result = datalink_get_mib(dl_port);
+    if (result == NULL) {
+        ETH_ERROR("%s: datalink_get_mib failed\r\n", __func__);
+        return NULL;
+    }
+
+    ether = (datalink_ether_t *)dl_port;
+    ether_update_drops(ether);
+
+    cJSON_AddBoolToObject(result, "rx_ring", ether->ring != NULL);
+    if (ether->ring) {
+        cJSON_AddNumberToObject(result, "rx_ring_blocks", ether->block_nr);
+        cJSON_AddNumberToObject(result, "rx_ring_block_size", ether->block_size);
+        cJSON_AddNumberToObject(result, "rx_blocks", ether->rx_blocks);
+    }
+    cJSON_AddNumberToObject(result, "rx_drops",
+        __atomic_load_n(&ether->rx_drops, __ATOMIC_RELAXED));
+
+    return result;
+}
+
 /**
  * ether_port_create - bipڵ·
  *
@@ -220,6 +459,7 @@ datalink_ether_t *ether_port_create(cJSON *cfg, cJSON *res)
 {
     datalink_ether_t *ether;
     struct sockaddr_ll addr_ll = {};
+    bool rx_ring;
     struct ifreq ifr = {};
     cJSON *tmp;
     const char *ifname, *res_type;
@@ -250,7 +490,7 @@ datalink_ether_t *ether_port_create(cJSON *cfg, cJSON *res)
     
     ether->dl.send_pdu = (int(*)(datalink_base_t *, bacnet_addr_t *, bacnet_buf_t *, bacnet_prio_t,
         bool))ether_send_pdu;
-    ether->dl.get_port_mib = datalink_get_mib;
+    ether->dl.get_port_mib = ether_get_mib;
     ether->dl.max_npdu_len = MAX_ETH_NPDU;
 
     tmp = cJSON_GetObjectItem(cfg, "resource_name");
@@ -277,6 +517,31 @@ datalink_ether_t *ether_port_create(cJSON *cfg, cJSON *res)
     }
 
     cJSON_DeleteItemFromObject(cfg, "resource_name");
+
+    rx_ring = true;
+    tmp = cJSON_GetObjectItem(cfg, "rx_ring");
+    if (tmp) {
+        if ((tmp->type != cJSON_True) && (tmp->type != cJSON_False)) {
+            ETH_ERROR("%s: invalid rx_ring item\r\n", __func__);
+            goto out1;
+        }
+        rx_ring = (tmp->type == cJSON_True);
+        cJSON_DeleteItemFromObject(cfg, "rx_ring");
+    }
+
+    ether->block_nr = ETH_RING_DEFAULT_BLOCKS;
+    ether->block_size = ETH_RING_DEFAULT_BLOCK_SIZE;
+    if ((ether_cfg_get_number(cfg, "rx_ring_blocks", 2, 4096, &ether->block_nr) < 0)
+            || (ether_cfg_get_number(cfg, "rx_ring_block_size", ETH_RING_FRAME_SIZE, 1 << 22,
+                &ether->block_size) < 0)) {
+        goto out1;
+    }
+
+    if (ether->block_size % getpagesize()) {
+        ETH_ERROR("%s: rx_ring_block_size(%d) is not multiple of page size\r\n", __func__,
+            ether->block_size);
+        goto out1;
+    }
     
     len = strlen(ifname);
     if (len > sizeof(ifr.ifr_name)) {
@@ -304,9 +569,17 @@ datalink_ether_t *ether_port_create(cJSON *cfg, cJSON *res)
     }
     memcpy(ether->mac, ifr.ifr_hwaddr.sa_data, IFHWADDRLEN);
 
+    if (ether_attach_filter(ether) < 0) {
+        goto out2;
+    }
+
+    if (rx_ring && (ether_setup_ring(ether) < 0)) {
+        ETH_WARN("%s: fall back to recv\r\n", __func__);
+    }
+
     if (bind(ether->fd, (struct sockaddr*)&addr_ll, sizeof(addr_ll)) != 0) {
         ETH_ERROR("%s: bind socket failed cause %s\r\n", __func__, strerror(errno));
-        goto out2;
+        goto out3;
     }
 
     list_add_tail(&(ether->ether_list), &all_ether_list);
@@ -321,6 +594,11 @@ datalink_ether_t *ether_port_create(cJSON *cfg, cJSON *res)
     
     return ether;
 
+out3:
+    if (ether->ring) {
+        (void)munmap(ether->ring, ether->ring_size);
+    }
+
 out2:
     close(ether->fd);
 
@@ -345,6 +623,10 @@ int ether_port_delete(datalink_ether_t *ether_port)
     if (ether_port->watch) {
         (void)el_watch_destroy(&el_default_loop, ether_port->watch);
     }
+
+    if (ether_port->ring) {
+        (void)munmap(ether_port->ring, ether_port->ring_size);
+    }
     
     close(ether_port->fd);
 
@@ -391,6 +673,8 @@ int ether_startup(void)
         ether->dl.tx_ok = 0;
         ether->dl.rx_all = 0;
         ether->dl.rx_ok = 0;
+        ether->rx_blocks = 0;
+        ether->rx_drops = 0;
         
         ether->watch = el_watch_create(&el_default_loop, ether->fd, EPOLLIN);
         if (ether->watch == NULL) {
@@ -404,7 +688,7 @@ int ether_startup(void)
             }
             return -EPERM;
         }
-        ether->watch->handler = ether_event_handler;
+        ether->watch->handler = ether->ring? ether_ring_handler: ether_event_handler;
         ether->watch->data = ether;
     }
 
@@ -437,6 +721,10 @@ void ether_clean(void)
     while((each = list_first_entry_or_null(&all_ether_list, datalink_ether_t, ether_list))) {
         list_del(&each->ether_list);
 
+        if (each->ring) {
+            (void)munmap(each->ring, each->ring_size);
+        }
+
         close(each->fd);
 
         free(each);
@@ -462,8 +750,33 @@ void ether_set_dbg_level(uint32_t level)
 
 cJSON *ether_get_status(cJSON *request)
 {
-    /* TODO */
+    datalink_ether_t *ether;
+    cJSON *reply, *result, *port;
 
-    return NULL;
+    reply = cJSON_CreateObject();
+    if (reply == NULL) {
+        ETH_ERROR("%s: create reply object failed\r\n", __func__);
+        return NULL;
+    }
+
+    result = cJSON_CreateArray();
+    if (result == NULL) {
+        ETH_ERROR("%s: create result array failed\r\n", __func__);
+        cJSON_Delete(reply);
+        return NULL;
+    }
+    cJSON_AddItemToObject(reply, "result", result);
+
+    list_for_each_entry(ether, &all_ether_list, ether_list) {
+        port = ether_get_mib(&ether->dl);
+        if (port == NULL) {
+            cJSON_Delete(reply);
+            return NULL;
+        }
+        cJSON_AddNumberToObject(port, "port_id", ether->dl.port_id);
+        cJSON_AddItemToArray(result, port);
+    }
+
+    return reply;
 }
 
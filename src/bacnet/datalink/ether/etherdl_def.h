@@ -16,6 +16,8 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+#include "misc/trace.h"
+
 extern bool ether_dbg_verbos;
 extern bool ether_dbg_warn;
 extern bool ether_dbg_err;
@@ -23,21 +25,21 @@ extern bool ether_dbg_err;
 #define ETH_ERROR(fmt, args...)                     \
 do {                                                \
     if (ether_dbg_err) {                            \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define ETH_WARN(fmt, args...)                      \
 do {                                                \
     if (ether_dbg_warn) {                           \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define ETH_VERBOS(fmt, args...)                    \
 do {                                                \
     if (ether_dbg_verbos) {                         \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
@@ -49,5 +51,13 @@ do {                                                \
 #define MAX_ETH_NPDU                (MAX_ETH_PDU - ETH_MPDU_HEADER)
 #define ETH_MPDU_ALL_HEADER         (ETH_802_3_HEADER + ETH_MPDU_HEADER)
 
+#define ETH_LLC_BACNET              (0x82820300)        /* DSAP, SSAP, control */
+
+/* rx ring: 64 blocks of 64KB, a block is retired to user after 4ms at most */
+#define ETH_RING_DEFAULT_BLOCKS     (64)
+#define ETH_RING_DEFAULT_BLOCK_SIZE (1 << 16)
+#define ETH_RING_FRAME_SIZE         (2048)
+#define ETH_RING_BLOCK_TIMEOUT      (4)
+
 #endif /* _ETHERDL_DEF_H_ */
 
@@ -29,172 +29,6 @@
 
 static struct list_head all_mstp_list;
 
-static const uint16_t crc_ccitt_table[256] = {
-    0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
-    0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
-    0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
-    0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
-    0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
-    0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
-    0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
-    0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
-    0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
-    0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
-    0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
-    0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
-    0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
-    0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
-    0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
-    0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
-    0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
-    0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
-    0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
-    0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
-    0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
-    0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
-    0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
-    0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
-    0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
-    0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
-    0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
-    0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
-    0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
-    0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
-    0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
-    0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78
-};
-
-static inline uint16_t crc_ccitt_byte(uint16_t crc, const uint8_t data)
-{
-  return (crc >> 8) ^ crc_ccitt_table[(uint8_t)crc ^ data];
-}
-
-static uint16_t crc_ccitt(uint16_t crc, uint8_t const *buffer, size_t len)
-{
-  while (len--)
-    crc = crc_ccitt_byte(crc, *buffer++);
-  return crc;
-}
-
-static const uint32_t crc32k_table[256] = {
-0x00000000, 0x9695C4CA, 0xFB4839C9, 0x6DDDFD03, 0x20F3C3CF, 0xB6660705, 0xDBBBFA06, 0x4D2E3ECC,
-0x41E7879E, 0xD7724354, 0xBAAFBE57, 0x2C3A7A9D, 0x61144451, 0xF781809B, 0x9A5C7D98, 0x0CC9B952,
-0x83CF0F3C, 0x155ACBF6, 0x788736F5, 0xEE12F23F, 0xA33CCCF3, 0x35A90839, 0x5874F53A, 0xCEE131F0,
-0xC22888A2, 0x54BD4C68, 0x3960B16B, 0xAFF575A1, 0xE2DB4B6D, 0x744E8FA7, 0x199372A4, 0x8F06B66E,
-0xD1FDAE25, 0x47686AEF, 0x2AB597EC, 0xBC205326, 0xF10E6DEA, 0x679BA920, 0x0A465423, 0x9CD390E9,
-0x901A29BB, 0x068FED71, 0x6B521072, 0xFDC7D4B8, 0xB0E9EA74, 0x267C2EBE, 0x4BA1D3BD, 0xDD341777,
-0x5232A119, 0xC4A765D3, 0xA97A98D0, 0x3FEF5C1A, 0x72C162D6, 0xE454A61C, 0x89895B1F, 0x1F1C9FD5,
-0x13D52687, 0x8540E24D, 0xE89D1F4E, 0x7E08DB84, 0x3326E548, 0xA5B32182, 0xC86EDC81, 0x5EFB184B,
-0x7598EC17, 0xE30D28DD, 0x8ED0D5DE, 0x18451114, 0x556B2FD8, 0xC3FEEB12, 0xAE231611, 0x38B6D2DB,
-0x347F6B89, 0xA2EAAF43, 0xCF375240, 0x59A2968A, 0x148CA846, 0x82196C8C, 0xEFC4918F, 0x79515545,
-0xF657E32B, 0x60C227E1, 0x0D1FDAE2, 0x9B8A1E28, 0xD6A420E4, 0x4031E42E, 0x2DEC192D, 0xBB79DDE7,
-0xB7B064B5, 0x2125A07F, 0x4CF85D7C, 0xDA6D99B6, 0x9743A77A, 0x01D663B0, 0x6C0B9EB3, 0xFA9E5A79,
-0xA4654232, 0x32F086F8, 0x5F2D7BFB, 0xC9B8BF31, 0x849681FD, 0x12034537, 0x7FDEB834, 0xE94B7CFE,
-0xE582C5AC, 0x73170166, 0x1ECAFC65, 0x885F38AF, 0xC5710663, 0x53E4C2A9, 0x3E393FAA, 0xA8ACFB60,
-0x27AA4D0E, 0xB13F89C4, 0xDCE274C7, 0x4A77B00D, 0x07598EC1, 0x91CC4A0B, 0xFC11B708, 0x6A8473C2,
-0x664DCA90, 0xF0D80E5A, 0x9D05F359, 0x0B903793, 0x46BE095F, 0xD02BCD95, 0xBDF63096, 0x2B63F45C,
-0xEB31D82E, 0x7DA41CE4, 0x1079E1E7, 0x86EC252D, 0xCBC21BE1, 0x5D57DF2B, 0x308A2228, 0xA61FE6E2,
-0xAAD65FB0, 0x3C439B7A, 0x519E6679, 0xC70BA2B3, 0x8A259C7F, 0x1CB058B5, 0x716DA5B6, 0xE7F8617C,
-0x68FED712, 0xFE6B13D8, 0x93B6EEDB, 0x05232A11, 0x480D14DD, 0xDE98D017, 0xB3452D14, 0x25D0E9DE,
-0x2919508C, 0xBF8C9446, 0xD2516945, 0x44C4AD8F, 0x09EA9343, 0x9F7F5789, 0xF2A2AA8A, 0x64376E40,
-0x3ACC760B, 0xAC59B2C1, 0xC1844FC2, 0x57118B08, 0x1A3FB5C4, 0x8CAA710E, 0xE1778C0D, 0x77E248C7,
-0x7B2BF195, 0xEDBE355F, 0x8063C85C, 0x16F60C96, 0x5BD8325A, 0xCD4DF690, 0xA0900B93, 0x3605CF59,
-0xB9037937, 0x2F96BDFD, 0x424B40FE, 0xD4DE8434, 0x99F0BAF8, 0x0F657E32, 0x62B88331, 0xF42D47FB,
-0xF8E4FEA9, 0x6E713A63, 0x03ACC760, 0x953903AA, 0xD8173D66, 0x4E82F9AC, 0x235F04AF, 0xB5CAC065,
-0x9EA93439, 0x083CF0F3, 0x65E10DF0, 0xF374C93A, 0xBE5AF7F6, 0x28CF333C, 0x4512CE3F, 0xD3870AF5,
-0xDF4EB3A7, 0x49DB776D, 0x24068A6E, 0xB2934EA4, 0xFFBD7068, 0x6928B4A2, 0x04F549A1, 0x92608D6B,
-0x1D663B05, 0x8BF3FFCF, 0xE62E02CC, 0x70BBC606, 0x3D95F8CA, 0xAB003C00, 0xC6DDC103, 0x504805C9,
-0x5C81BC9B, 0xCA147851, 0xA7C98552, 0x315C4198, 0x7C727F54, 0xEAE7BB9E, 0x873A469D, 0x11AF8257,
-0x4F549A1C, 0xD9C15ED6, 0xB41CA3D5, 0x2289671F, 0x6FA759D3, 0xF9329D19, 0x94EF601A, 0x027AA4D0,
-0x0EB31D82, 0x9826D948, 0xF5FB244B, 0x636EE081, 0x2E40DE4D, 0xB8D51A87, 0xD508E784, 0x439D234E,
-0xCC9B9520, 0x5A0E51EA, 0x37D3ACE9, 0xA1466823, 0xEC6856EF, 0x7AFD9225, 0x17206F26, 0x81B5ABEC,
-0x8D7C12BE, 0x1BE9D674, 0x76342B77, 0xE0A1EFBD, 0xAD8FD171, 0x3B1A15BB, 0x56C7E8B8, 0xC0522C72
-};
-
-static inline uint32_t crc32k_byte(uint32_t crc, const uint8_t data)
-{
-    return crc32k_table[(uint8_t)crc ^ data] ^ (crc >> 8);
-}
-
-static uint32_t crc32k(uint32_t crc, const uint8_t *buffer, size_t len)
-{
-    while (len--)
-      crc = crc32k_byte(crc, *buffer++);
-    return crc;
-}
-
-static int cobs_encode(uint8_t *to, const uint8_t *fr, size_t length)
-{
-	size_t code_index = 0;
-	size_t read_index = 0;
-	size_t write_index = 1;
-	uint8_t code = 1;
-	uint8_t data, last_code = 0;
-
-	while (read_index < length) {
-		data = fr[read_index++];
-
-		if (data != 0) {
-			to[write_index++] = data ^ 0x55;
-			code++;
-			if (code != 255)
-				continue;
-		}
-
-		last_code = code;
-		to[code_index] = code ^ 0x55;
-		code_index = write_index++;
-		code = 1;
-	}
-
-	if ((last_code == 255) && (code == 1)) {
-		write_index--;
-	} else {
-		to[code_index] = code ^ 0x55;
-    }
-    
-	return write_index;
-}
-
-static int frame_encode(uint8_t *to, const uint8_t *fr, size_t length)
-{
-	size_t cobs_data_len;
-	uint32_t crc32k_value, little_endian_value;
-
-	cobs_data_len = cobs_encode(to, fr, length);
-	crc32k_value = ~crc32k(0xffffffff, to, cobs_data_len);
-	little_endian_value = htole32(crc32k_value);
-	
-	return cobs_data_len + cobs_encode(to + cobs_data_len, (uint8_t*)&little_endian_value, 4);
-}
-	
-static int cobs_decode(uint8_t *to, const uint8_t *fr, size_t length)
-{
-	size_t read_index = 0;
-	size_t write_index = 0;
-	uint8_t code, last_code;
-
-	while (read_index < length) {
-		code = fr[read_index] ^ 0x55;
-		last_code = code;
-
-		if (read_index + code > length) {
-			return -1;
-		}
-		read_index++;
-
-		while (--code > 0) {
-			to[write_index++] = fr[read_index++] ^ 0x55;
-		}
-
-		if ((last_code != 255) && (read_index < length)) {
-			to[write_index++] = 0;
-		}
-	}
-
-	return write_index;
-}
-
 static inline uint16_t get_packet_usage(uint16_t packet_len)
 {
 	return (packet_len + OUT_PREFIX_SPACE + 1) & ~1;
@@ -247,8 +81,11 @@ static int __inner_send(usb_mstp_t *mstp, uint8_t *buf, int len)
 
 static void keep_send_packet(usb_mstp_t *mstp)
 {
+    usb_tx_ring_t *ring;
+    uint32_t stamp;
     uint8_t *buf;
     uint16_t len;
+    int prio;
     
     if (mstp->test.data != NULL && !mstp->test.sent) {
         if (__inner_send(mstp, mstp->test.data, mstp->test.len)) {
@@ -259,37 +96,48 @@ static void keep_send_packet(usb_mstp_t *mstp)
         }
     }
 
-	while (mstp->head != mstp->tail) {
-		len = (mstp->out_buf[mstp->tail] << 8) + mstp->out_buf[mstp->tail + 1];
-		buf =  mstp->out_buf + mstp->tail + 2;
+    /* packets handed to the device are sent in order, so pick here */
+	while ((prio = mstp_prio_pick(mstp->prio, mstp->starve_limit)) >= 0) {
+	    ring = &mstp->ring[prio];
+		len = (ring->buf[ring->tail] << 8) + ring->buf[ring->tail + 1];
+		memcpy(&stamp, ring->buf + ring->tail + 2, sizeof(stamp));
+		buf =  ring->buf + ring->tail + OUT_QUEUE_HEADER;
 
         if (!__inner_send(mstp, buf, len)) {
             break;
         }
-        
+
+        mstp->prio[prio].queued--;
+        mstp_prio_sent(mstp->prio, prio, el_current_millisecond() - stamp);
         mstp->packet_queued--;
-        mstp->tail += len + 2;
-        if (mstp->tail == mstp->not_used) {
-            mstp->tail = 0;
-            mstp->not_used = mstp->base.tx_buf_size;
+        ring->tail += len + OUT_QUEUE_HEADER;
+        if (ring->tail == ring->not_used) {
+            ring->tail = 0;
+            ring->not_used = mstp->base.tx_buf_size;
         }
 	}
 }
 
 static void reset_packet_mac(usb_mstp_t *mstp)
 {
+    usb_tx_ring_t *ring;
     uint8_t *buf;
     uint16_t len;
-    unsigned tail = mstp->tail;
-
-    while (mstp->head != tail) {
-        len = (mstp->out_buf[tail] << 8) + mstp->out_buf[tail + 1];
-        buf =  mstp->out_buf + tail + 2;
-        buf[2] = mstp->base.mac;
-
-        tail += len + 2;
-        if (tail == mstp->not_used) {
-            tail = 0;
+    unsigned tail;
+    int i;
+
+    for (i = 0; i < MSTP_TX_PRIO_NUM; i++) {
+        ring = &mstp->ring[i];
+        tail = ring->tail;
+        while (ring->head != tail) {
+            len = (ring->buf[tail] << 8) + ring->buf[tail + 1];
+            buf =  ring->buf + tail + OUT_QUEUE_HEADER;
+            buf[2] = mstp->base.mac;
+
+            tail += len + OUT_QUEUE_HEADER;
+            if (tail == ring->not_used) {
+                tail = 0;
+            }
         }
     }
 }
@@ -518,8 +366,11 @@ out:
 }
 
 static int _mstp_send_pdu_(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src_mac,
-            bacnet_buf_t *npdu)
+            bacnet_buf_t *npdu, bacnet_prio_t prio)
 {
+    usb_tx_ring_t *ring;
+    uint32_t stamp;
+    uint8_t *buf;
     uint16_t packet_len;
     uint16_t pdu_len;
     uint8_t dst;
@@ -555,28 +406,36 @@ static int _mstp_send_pdu_(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src
         packet_len = pdu_len + (pdu_len + 253)/254 + 5 + OUT_PACKET_HEADER;
     }
 
+    if ((unsigned)prio >= MSTP_TX_PRIO_NUM) {
+        prio = PRIORITY_NORMAL;
+    }
+    ring = &mstp->ring[prio];
+
     pthread_mutex_lock(&mstp->mutex);
 
-    if (get_buffer_left(mstp->base.tx_buf_size, mstp->head, mstp->tail) < packet_len + 2) {
+    if (get_buffer_left(mstp->base.tx_buf_size, ring->head, ring->tail)
+            < packet_len + OUT_QUEUE_HEADER) {
+        mstp->prio[prio].dropped++;
         pthread_mutex_unlock(&mstp->mutex);
         MSTP_ERROR("%s: write %d bytes overflow\r\n", __func__, pdu_len);
         return -EPERM;
     }
 
-    bool empty = mstp->head == mstp->tail;
+    /* bypass the queues only when nothing is waiting in any of them */
+    bool empty = mstp->packet_queued == 0;
 
-    if (mstp->base.tx_buf_size - mstp->head - 1 < packet_len + 2) {
-        if (mstp->head == mstp->tail) {
-            mstp->tail = 0;
-            mstp->not_used = mstp->base.tx_buf_size;
+    if (mstp->base.tx_buf_size - ring->head - 1 < packet_len + OUT_QUEUE_HEADER) {
+        if (ring->head == ring->tail) {
+            ring->tail = 0;
+            ring->not_used = mstp->base.tx_buf_size;
         } else {
-            mstp->not_used = mstp->head;
+            ring->not_used = ring->head;
         }
-        mstp->head = 0;
+        ring->head = 0;
     }
 
     if (pdu_len <= MSTP_MAX_NE_DATA_LEN) {
-        uint8_t *buf = npdu->data - OUT_PACKET_HEADER;
+        buf = npdu->data - OUT_PACKET_HEADER;
         uint16_t crc = ~crc_ccitt(0xffff, npdu->data, pdu_len);
         buf[0] = MSTP_REQ_BACNET;
         buf[1] = dst;
@@ -584,25 +443,31 @@ static int _mstp_send_pdu_(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src
         buf[packet_len - 2] = crc;
         buf[packet_len - 1] = crc >> 8;
         if (empty && __inner_send(mstp, buf, packet_len)) {
+            mstp_prio_sent(mstp->prio, prio, 0);
             pthread_mutex_unlock(&mstp->mutex);
             return OK;
         }
-        memcpy(mstp->out_buf + mstp->head + 2, buf, packet_len);
+        memcpy(ring->buf + ring->head + OUT_QUEUE_HEADER, buf, packet_len);
     } else {
-        mstp->out_buf[mstp->head + 2] = MSTP_REQ_BACNET;
-        mstp->out_buf[mstp->head + 3] = dst;
-        mstp->out_buf[mstp->head + 4] = src_mac;
-        packet_len = frame_encode(mstp->out_buf + mstp->head + 5, npdu->data, pdu_len)
+        buf = ring->buf + ring->head + OUT_QUEUE_HEADER;
+        buf[0] = MSTP_REQ_BACNET;
+        buf[1] = dst;
+        buf[2] = src_mac;
+        packet_len = frame_encode(buf + OUT_PACKET_HEADER, npdu->data, pdu_len)
             + OUT_PACKET_HEADER;
-        if (empty && __inner_send(mstp, mstp->out_buf + mstp->head + 2, packet_len)) {
+        if (empty && __inner_send(mstp, buf, packet_len)) {
+            mstp_prio_sent(mstp->prio, prio, 0);
             pthread_mutex_unlock(&mstp->mutex);
             return OK;
         }
     }
 
-    mstp->out_buf[mstp->head] = packet_len >> 8;
-    mstp->out_buf[mstp->head + 1] = packet_len;
-    mstp->head += packet_len + 2;
+    stamp = el_current_millisecond();
+    ring->buf[ring->head] = packet_len >> 8;
+    ring->buf[ring->head + 1] = packet_len;
+    memcpy(ring->buf + ring->head + 2, &stamp, sizeof(stamp));
+    ring->head += packet_len + OUT_QUEUE_HEADER;
+    mstp->prio[prio].queued++;
     mstp->packet_queued++;
 
     pthread_mutex_unlock(&mstp->mutex);
@@ -611,7 +476,7 @@ static int _mstp_send_pdu_(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src
 }
 
 static int mstp_send_pdu(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, bacnet_buf_t *npdu,
-            __attribute__ ((unused))bacnet_prio_t prio, bool der)
+            bacnet_prio_t prio, bool der)
 {
     int rv;
 
@@ -627,7 +492,8 @@ static int mstp_send_pdu(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, bacnet_buf_t
         return -EPERM;
     }
 
-    rv = _mstp_send_pdu_(mstp, dst_mac, der ? mstp->base.mac : MSTP_BROADCAST_ADDRESS, npdu);
+    rv = _mstp_send_pdu_(mstp, dst_mac, der ? mstp->base.mac : MSTP_BROADCAST_ADDRESS, npdu,
+        prio);
     if (rv < 0) {
         MSTP_ERROR("%s: send failed\n", __func__);
         return rv;
@@ -652,7 +518,7 @@ static int mstp_send_pdu(usb_mstp_t *mstp, bacnet_addr_t *dst_mac, bacnet_buf_t
  * @return ɹ0ʧܷظ
  */
 int mstp_fake_pdu(datalink_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src_mac, bacnet_buf_t *npdu,
-        __attribute__ ((unused))bacnet_prio_t prio)
+        bacnet_prio_t prio)
 {
     int rv;
 
@@ -663,7 +529,8 @@ int mstp_fake_pdu(datalink_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src_mac
 
     mstp->dl.tx_all++;
 
-    if (((usb_mstp_t *)mstp)->auto_busy && ((usb_mstp_t*)mstp)->auto_mac) {
+    if ((mstp->driver == MSTP_DRIVER_USB) && ((usb_mstp_t *)mstp)->auto_busy
+            && ((usb_mstp_t*)mstp)->auto_mac) {
         MSTP_WARN("%s: auto mac config not finished, discard.\r\n", __func__);
         return -EPERM;
     }
@@ -674,7 +541,11 @@ int mstp_fake_pdu(datalink_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src_mac
         return -EINVAL;
     }
 
-    rv = _mstp_send_pdu_((usb_mstp_t *)mstp, dst_mac, src_mac, npdu);
+    if (mstp->driver == MSTP_DRIVER_TTY) {
+        rv = tty_mstp_fake_pdu(mstp, dst_mac, src_mac, npdu, prio);
+    } else {
+        rv = _mstp_send_pdu_((usb_mstp_t *)mstp, dst_mac, src_mac, npdu, prio);
+    }
     if (rv < 0) {
         MSTP_ERROR("%s: send failed\n", __func__);
         return rv;
@@ -708,6 +579,8 @@ static cJSON *mstp_get_mib(datalink_base_t *dl_port)
 
     cJSON_AddNumberToObject(result, "tx_queue",
         mstp->packet_queued + (uint8_t)(mstp->now_sn - mstp->sent_sn));
+    cJSON_AddNumberToObject(result, "tx_starve_limit", mstp->starve_limit);
+    cJSON_AddItemToObject(result, "tx_prio", mstp_prio_get_mib(mstp->prio));
 
     if (mstp->auto_baud || mstp->auto_polarity || mstp->auto_mac) {
         cJSON_AddTrueToObject(result, "auto");
@@ -752,19 +625,31 @@ int mstp_init(void)
     return OK;
 }
 
-int mstp_startup(void)
+/* run on el_default_loop, no port handler is running meanwhile */
+static void _mstp_startup(void *arg)
 {
+    int *result = (int *)arg;
     usb_mstp_t *mstp;
     int rv;
 
-    el_sync(&el_default_loop);
+    *result = -EPERM;
 
     if (slave_proxy_startup() < 0) {
         MSTP_ERROR("%s: slave proxy startup failed\r\n", __func__);
-        goto out;
+        return;
     }
 
     list_for_each_entry(mstp, &all_mstp_list, base.mstp_list) {
+        if (mstp->base.driver == MSTP_DRIVER_TTY) {
+            rv = tty_mstp_startup(&mstp->base);
+            if (rv < 0) {
+                MSTP_ERROR("%s: tty port startup failed\r\n", __func__);
+                mstp_stop();
+                return;
+            }
+            continue;
+        }
+
         mstp->base.dl.tx_all = 0;
         mstp->base.dl.tx_ok = 0;
         mstp->base.dl.rx_all = 0;
@@ -774,7 +659,7 @@ int mstp_startup(void)
         if (rv < 0) {
             MSTP_ERROR("%s: enable device failed\r\n", __func__);
             mstp_stop();
-            goto out;
+            return;
         }
 
         // send first null packet
@@ -782,13 +667,16 @@ int mstp_startup(void)
         if (rv < 0) {
             MSTP_ERROR("%s: send first null packet failed\r\n", __func__);
             mstp_stop();
-            goto out;
+            return;
         }
 
-        mstp->head = 0;
-        mstp->tail = 0;
+        for (int i = 0; i < MSTP_TX_PRIO_NUM; ++i) {
+            mstp->ring[i].head = 0;
+            mstp->ring[i].tail = 0;
+            mstp->ring[i].not_used = mstp->base.tx_buf_size;
+        }
+        memset(mstp->prio, 0, sizeof(mstp->prio));
         mstp->packet_queued = 0;
-        mstp->not_used = mstp->base.tx_buf_size;
         mstp->recv_sn = 0;
         mstp->now_sn = 0;
         mstp->sent_sn = 0;
@@ -816,31 +704,41 @@ int mstp_startup(void)
             if (rv != 0) {
                 MSTP_ERROR("%s: usb serial queue read failed", __func__);
                 mstp_stop();
-                goto out;
+                return;
             }
         }
     }
 
-    el_unsync(&el_default_loop);
+    *result = OK;
+}
+
+int mstp_startup(void)
+{
+    int rv;
+
+    rv = -EPERM;
+    (void)el_call(&el_default_loop, _mstp_startup, &rv);
+    if (rv < 0) {
+        return rv;
+    }
+
     MSTP_VERBOS("%s: ok\r\n", __func__);
     mstp_set_dbg_level(0);
 
     return OK;
-
-out:
-    el_unsync(&el_default_loop);
-    
-    return -EPERM;
 }
 
-void mstp_stop(void)
+static void _mstp_stop(void *arg)
 {
     usb_mstp_t *mstp;
     int rv;
 
-    el_sync(&el_default_loop);
-
     list_for_each_entry(mstp, &all_mstp_list, base.mstp_list) {
+        if (mstp->base.driver == MSTP_DRIVER_TTY) {
+            tty_mstp_stop(&mstp->base);
+            continue;
+        }
+
         usb_serial_cancel_async(mstp->serial);
 
         // disable interface
@@ -851,8 +749,11 @@ void mstp_stop(void)
     }
 
     slave_proxy_stop();
-    
-    el_unsync(&el_default_loop);
+}
+
+void mstp_stop(void)
+{
+    (void)el_call(&el_default_loop, _mstp_stop, NULL);
 }
 
 void mstp_clean(void)
@@ -862,6 +763,10 @@ void mstp_clean(void)
     while((each = list_first_entry_or_null(&all_mstp_list, usb_mstp_t, base.mstp_list))) {
         list_del(&each->base.mstp_list);
         free(each->base.proxy);
+        if (each->base.driver == MSTP_DRIVER_TTY) {
+            tty_mstp_port_destroy(&each->base);
+            continue;
+        }
         free(each->in_buf);
         free(each->out_buf);
         pthread_mutex_destroy(&each->mutex);
@@ -876,6 +781,32 @@ void mstp_exit(void)
     mstp_clean();
 }
 
+/* شϵĶ˿ڣcfgɱͷ */
+static datalink_mstp_t *mstp_tty_port_create(cJSON *cfg, const char *ifname)
+{
+    datalink_mstp_t *mstp;
+    cJSON *child;
+
+    mstp = tty_mstp_port_create(cfg, ifname);
+    if (mstp == NULL) {
+        MSTP_ERROR("%s: create tty port on %s failed\r\n", __func__, ifname);
+        cJSON_Delete(cfg);
+        return NULL;
+    }
+
+    list_add_tail(&mstp->mstp_list, &all_mstp_list);
+
+    child = cfg->child;
+    while (child) {
+        MSTP_WARN("%s: unknown cfg item: %s\r\n", __func__, child->string);
+        child = child->next;
+    }
+
+    cJSON_Delete(cfg);
+
+    return mstp;
+}
+
 datalink_mstp_t *mstp_port_create(cJSON *cfg, cJSON *res)
 {
     usb_mstp_t *mstp;
@@ -895,50 +826,56 @@ datalink_mstp_t *mstp_port_create(cJSON *cfg, cJSON *res)
         return NULL;
     }
 
-    mstp = (usb_mstp_t *)malloc(sizeof(usb_mstp_t));
-    if (!mstp) {
-        MSTP_ERROR("%s: malloc datalink_mstp_t failed\r\n", __func__);
-        goto out0;
-    }
-    memset(mstp, 0, sizeof(usb_mstp_t));
-
-    mstp->base.dl.send_pdu = (int(*)(datalink_base_t *, bacnet_addr_t *, bacnet_buf_t *,
-        bacnet_prio_t, bool))mstp_send_pdu;
-    mstp->base.dl.get_port_mib = mstp_get_mib;
-    mstp->base.dl.max_npdu_len = MSTP_MAX_DATA_LEN;
-
-    rv = pthread_mutex_init(&mstp->mutex, NULL);
-    if (rv) {
-        MSTP_ERROR("%s: init mstp_mutex failed cause %s\r\n", __func__, strerror(rv));
-        goto out1;
-    }
-
     tmp = cJSON_GetObjectItem(cfg, "resource_name");
     if ((!tmp) || (tmp->type != cJSON_String)) {
         MSTP_ERROR("%s: get resource_name item failed\r\n", __func__);
-        goto out2;
+        goto out0;
     }
 
     res_type = datalink_get_type_by_resource_name(res, tmp->valuestring);
     if (res_type == NULL) {
         MSTP_ERROR("%s: get resource type failed by name: %s\r\n", __func__, tmp->valuestring);
-        goto out2;
+        goto out0;
     }
 
-    if (strcmp(res_type, "USB")) {
-        MSTP_ERROR("%s: resource type is not USB: %s\r\n", __func__, res_type);
-        goto out2;
+    if (strcmp(res_type, "USB") && strcmp(res_type, "TTY")) {
+        MSTP_ERROR("%s: resource type is not USB or TTY: %s\r\n", __func__, res_type);
+        goto out0;
     }
 
     ifname = datalink_get_ifname_by_resource_name(res, tmp->valuestring);
     if (ifname == NULL) {
         MSTP_ERROR("%s: get ifname by resource name:%s failed\r\n", __func__, tmp->valuestring);
-        goto out2;
+        goto out0;
+    }
+
+    if (!strcmp(res_type, "TTY")) {
+        cJSON_DeleteItemFromObject(cfg, "resource_name");
+        return mstp_tty_port_create(cfg, ifname);
     }
     
     if (sscanf(ifname, "%hhu:%hhu", &enumerated_idx, &interface_idx) != 2) {
         MSTP_ERROR("%s: invalid ifname: %s\r\n", __func__, ifname);
-        goto out2;
+        goto out0;
+    }
+
+    mstp = (usb_mstp_t *)malloc(sizeof(usb_mstp_t));
+    if (!mstp) {
+        MSTP_ERROR("%s: malloc datalink_mstp_t failed\r\n", __func__);
+        goto out0;
+    }
+    memset(mstp, 0, sizeof(usb_mstp_t));
+
+    mstp->base.driver = MSTP_DRIVER_USB;
+    mstp->base.dl.send_pdu = (int(*)(datalink_base_t *, bacnet_addr_t *, bacnet_buf_t *,
+        bacnet_prio_t, bool))mstp_send_pdu;
+    mstp->base.dl.get_port_mib = mstp_get_mib;
+    mstp->base.dl.max_npdu_len = MSTP_MAX_DATA_LEN;
+
+    rv = pthread_mutex_init(&mstp->mutex, NULL);
+    if (rv) {
+        MSTP_ERROR("%s: init mstp_mutex failed cause %s\r\n", __func__, strerror(rv));
+        goto out1;
     }
 
     cJSON_DeleteItemFromObject(cfg, "resource_name");
@@ -959,6 +896,7 @@ datalink_mstp_t *mstp_port_create(cJSON *cfg, cJSON *res)
     mstp->base.usage_timeout = 20;
     mstp->base.tx_buf_size = MIN_BUFFER_SIZE;
     mstp->base.rx_buf_size = MIN_BUFFER_SIZE;
+    mstp->starve_limit = MSTP_DEFAULT_STARVE_LIMIT;
     mstp->reply_fast_timeout = 4;
     mstp->usage_fast_timeout = 1;
     mstp->polarity = 0;
@@ -1063,6 +1001,22 @@ datalink_mstp_t *mstp_port_create(cJSON *cfg, cJSON *res)
         cJSON_DeleteItemFromObject(cfg, "tx_buf_size");
     }
 
+    tmp = cJSON_GetObjectItem(cfg, "tx_starve_limit");
+    if (tmp) {
+        if (tmp->type != cJSON_Number) {
+            MSTP_ERROR("%s: tx_starve_limit item should be number\r\n", __func__);
+            goto out3;
+        }
+
+        if ((tmp->valueint < 0) || (tmp->valueint > MSTP_MAX_STARVE_LIMIT)) {
+            MSTP_ERROR("%s: tx_starve_limit item should be in 0~%d\r\n", __func__,
+                MSTP_MAX_STARVE_LIMIT);
+            goto out3;
+        }
+        mstp->starve_limit = tmp->valueint;
+        cJSON_DeleteItemFromObject(cfg, "tx_starve_limit");
+    }
+
     tmp = cJSON_GetObjectItem(cfg, "rx_buf_size");
     if (tmp) {
         if (tmp->type != cJSON_Number) {
@@ -1114,11 +1068,15 @@ datalink_mstp_t *mstp_port_create(cJSON *cfg, cJSON *res)
     }
 
     mstp->in_xfr_size = mstp->base.rx_buf_size / 2048;
-    mstp->out_buf = malloc(mstp->base.tx_buf_size);
+    mstp->out_buf = malloc(mstp->base.tx_buf_size * MSTP_TX_PRIO_NUM);
     mstp->in_buf = malloc(bacnet_buf_calsize(MSTP_MAX_DATA_LEN) * mstp->in_xfr_size);
     if ((mstp->in_buf == NULL) || (mstp->out_buf == NULL)) {
         goto out4;
     }
+
+    for (int i = 0; i < MSTP_TX_PRIO_NUM; ++i) {
+        mstp->ring[i].buf = mstp->out_buf + mstp->base.tx_buf_size * i;
+    }
     
     tmp = cJSON_GetObjectItem(cfg, "inv_polarity");
     if (tmp) {
@@ -1261,11 +1219,16 @@ int mstp_port_delete(datalink_mstp_t *base)
         return -EINVAL;
     }
 
-    mstp = (usb_mstp_t *)base;
-
     list_del(&base->mstp_list);
 
     slave_proxy_port_delete(base);
+
+    if (base->driver == MSTP_DRIVER_TTY) {
+        tty_mstp_port_destroy(base);
+        return OK;
+    }
+
+    mstp = (usb_mstp_t *)base;
     free(mstp->in_buf);
     free(mstp->out_buf);
 
@@ -1312,6 +1275,10 @@ int mstp_get_test_result(datalink_mstp_t *base, uint8_t *remote)
         return -EINVAL;
     }
 
+    if (base->driver == MSTP_DRIVER_TTY) {
+        return tty_mstp_get_test_result(base, remote);
+    }
+
     mstp = (usb_mstp_t*)base;
 
     pthread_mutex_lock(&mstp->mutex);
@@ -1357,6 +1324,10 @@ int mstp_test_remote(datalink_mstp_t *base, uint8_t remote, uint8_t *data,
         return -EINVAL;
     }
 
+    if (base->driver == MSTP_DRIVER_TTY) {
+        return tty_mstp_test_remote(base, remote, data, len, callback, context);
+    }
+
     mstp = (usb_mstp_t*)base;
 
     pthread_mutex_lock(&mstp->mutex);
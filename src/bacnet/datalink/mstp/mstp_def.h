@@ -19,6 +19,7 @@
 #include "bacnet/mstp.h"
 #include "misc/usbuartproxy.h"
 #include "bacnet/bacnet_buf.h"
+#include "misc/trace.h"
 
 extern bool mstp_dbg_verbos;
 extern bool mstp_dbg_warn;
@@ -27,21 +28,21 @@ extern bool mstp_dbg_err;
 #define MSTP_ERROR(fmt, args...)                    \
 do {                                                \
     if (mstp_dbg_err) {                             \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define MSTP_WARN(fmt, args...)                     \
 do {                                                \
     if (mstp_dbg_warn) {                            \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define MSTP_VERBOS(fmt, args...)                   \
 do {                                                \
     if (mstp_dbg_verbos) {                          \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
@@ -61,15 +62,68 @@ do {                                                \
 #define  MIN_BUFFER_SIZE                (4096)
 #define  MAX_BUFFER_SIZE                (262144)
 
+/* one transmit queue per bacnet_prio_t, tx_buf_size is the size of each */
+#define  MSTP_TX_PRIO_NUM               (PRIORITY_LIFE_SAFETY + 1)
+#define  MSTP_DEFAULT_STARVE_LIMIT      (8)
+#define  MSTP_MAX_STARVE_LIMIT          (1000)
+
+/* packet length and enqueue time(ms) before each queued packet */
+#define  OUT_QUEUE_HEADER               (6)
+
+typedef struct mstp_prio_stat_s {
+    uint32_t queued;
+    uint32_t skipped;                   /* times passed over by higher priorities while not empty */
+    uint32_t sent;
+    uint32_t dropped;
+    uint64_t wait_total_ms;
+    uint32_t wait_max_ms;
+} mstp_prio_stat_t;
+
+/**
+ * mstp_prio_pick - ѡһӵȼ
+ *
+ * ϸȼӣǿյĵȼбԽstarve_limitκȳһΣ
+ * starve_limitΪ0ʱΪϸȼ
+ *
+ * @return: ȼжΪʱ-1
+ *
+ */
+extern int mstp_prio_pick(const mstp_prio_stat_t *prio, uint32_t starve_limit);
+
+/* ¼pickзһģqueuedɵά */
+extern void mstp_prio_sent(mstp_prio_stat_t *prio, int pick, uint32_t wait_ms);
+
+extern cJSON *mstp_prio_get_mib(const mstp_prio_stat_t *prio);
+
+typedef struct usb_tx_ring_s {
+    uint8_t *buf;
+    unsigned head;
+    unsigned tail;
+    unsigned not_used;
+} usb_tx_ring_t;
+
+extern uint16_t crc_ccitt(uint16_t crc, uint8_t const *buffer, size_t len);
+
+extern uint32_t crc32k(uint32_t crc, const uint8_t *buffer, size_t len);
+
+extern uint8_t crc_header(uint8_t crc, const uint8_t *buffer, size_t len);
+
+extern int cobs_encode(uint8_t *to, const uint8_t *fr, size_t length);
+
+extern int cobs_decode(uint8_t *to, const uint8_t *fr, size_t length);
+
+/* cobs encoded data followed by cobs encoded crc32k */
+extern int frame_encode(uint8_t *to, const uint8_t *fr, size_t length);
+
 typedef struct usb_mstp_s {
     datalink_mstp_t base;
     usb_serial_t *serial;
     pthread_mutex_t mutex;
     uint8_t *out_buf;
     DECLARE_BACNET_BUF(*in_buf, MSTP_MAX_DATA_LEN);
-    unsigned head;
-    unsigned tail;
-    unsigned not_used;
+    usb_tx_ring_t ring[MSTP_TX_PRIO_NUM];
+    mstp_prio_stat_t prio[MSTP_TX_PRIO_NUM];
+    uint32_t starve_limit;
     unsigned in_xfr_size;
     uint16_t out_size[256];
     uint16_t left_space;
@@ -108,4 +162,173 @@ typedef struct usb_mstp_s {
     } test;
 } usb_mstp_t;
 
+/* frame types of Clause 9 */
+#define  MSTP_FRAME_TOKEN                           (0)
+#define  MSTP_FRAME_POLL_FOR_MASTER                 (1)
+#define  MSTP_FRAME_REPLY_TO_POLL_FOR_MASTER        (2)
+#define  MSTP_FRAME_TEST_REQUEST                    (3)
+#define  MSTP_FRAME_TEST_RESPONSE                   (4)
+#define  MSTP_FRAME_DATA_EXPECTING_REPLY            (5)
+#define  MSTP_FRAME_DATA_NOT_EXPECTING_REPLY        (6)
+#define  MSTP_FRAME_REPLY_POSTPONED                 (7)
+#define  MSTP_FRAME_EXT_DATA_EXPECTING_REPLY        (32)
+#define  MSTP_FRAME_EXT_DATA_NOT_EXPECTING_REPLY    (33)
+
+#define  MSTP_PREAMBLE1                 (0x55)
+#define  MSTP_PREAMBLE2                 (0xFF)
+#define  MSTP_HEADER_SIZE               (8)
+#define  MSTP_HEADER_CRC_RESIDUE        (0x55)
+#define  MSTP_DATA_CRC_RESIDUE          (0xF0B8)
+#define  MSTP_ENCODED_CRC32K_SIZE       (5)
+
+/* cobs encoded data and crc32k are the largest */
+#define  MSTP_MAX_ENCODED_DATA_LEN      (MSTP_MAX_DATA_LEN + (MSTP_MAX_DATA_LEN + 253)/254 \
+                                            + MSTP_ENCODED_CRC32K_SIZE)
+#define  MSTP_MAX_FRAME_SIZE            (MSTP_HEADER_SIZE + MSTP_MAX_ENCODED_DATA_LEN)
+
+/* master node parameters of Clause 9.5.3, times in milliseconds */
+#define  MSTP_N_POLL                    (50)
+#define  MSTP_N_RETRY_TOKEN             (1)
+#define  MSTP_N_MIN_OCTETS              (4)
+#define  MSTP_T_FRAME_ABORT             (100)
+#define  MSTP_T_NO_TOKEN                (500)
+#define  MSTP_T_SLOT                    (10)
+#define  MSTP_T_REPLY_DELAY             (250)
+#define  MSTP_T_TURNAROUND_BITS         (40)
+
+#define  TTY_RX_SLOT_SIZE               (2048)
+#define  TTY_MIN_RX_SLOTS               (2)
+#define  TTY_DEFAULT_RT_PRIORITY        (50)
+
+typedef enum {
+    MSTP_MASTER_INITIALIZE = 0,
+    MSTP_MASTER_IDLE,
+    MSTP_MASTER_USE_TOKEN,
+    MSTP_MASTER_WAIT_FOR_REPLY,
+    MSTP_MASTER_DONE_WITH_TOKEN,
+    MSTP_MASTER_PASS_TOKEN,
+    MSTP_MASTER_NO_TOKEN,
+    MSTP_MASTER_POLL_FOR_MASTER,
+    MSTP_MASTER_ANSWER_DATA_REQUEST,
+} MSTP_MASTER_STATE;
+
+typedef enum {
+    MSTP_RX_IDLE = 0,
+    MSTP_RX_PREAMBLE,
+    MSTP_RX_HEADER,
+    MSTP_RX_DATA,
+    MSTP_RX_SKIP_DATA,
+} MSTP_RX_STATE;
+
+/* encoded frame waiting for the token */
+typedef struct tty_frame_s {
+    struct list_head node;
+    uint32_t stamp;                         /* enqueue time(ms) */
+    uint8_t type;
+    uint8_t dst;
+    uint16_t len;
+    uint8_t data[0];
+} tty_frame_t;
+
+typedef struct tty_rx_slot_s {
+    uint8_t src;
+    bool bcast;
+    DECLARE_BACNET_BUF(rx, MSTP_MAX_DATA_LEN);
+} tty_rx_slot_t;
+
+/*
+ * MS/TP master node over a local tty. The state machines run in a dedicated
+ * real-time thread, received npdus are handed to el_default_loop by a single
+ * producer single consumer ring.
+ */
+typedef struct tty_mstp_s {
+    datalink_mstp_t base;
+    char *ifname;
+    int fd;
+    int wake_fd;                            /* eventfd, frame queued or stop */
+    int notify_fd;                          /* eventfd, watched by el_default_loop */
+    el_watch_t *watch;
+    pthread_t thread;
+    bool started;
+    bool stopping;
+    int rt_priority;                        /* SCHED_FIFO priority, 0 for normal thread */
+    uint32_t bit_ns;                        /* nanoseconds per bit */
+
+    pthread_mutex_t mutex;                  /* protects tx_queue, prio and test */
+    struct list_head tx_queue[MSTP_TX_PRIO_NUM];
+    uint32_t tx_queued_size[MSTP_TX_PRIO_NUM];
+    mstp_prio_stat_t prio[MSTP_TX_PRIO_NUM];
+    uint32_t starve_limit;
+    uint32_t packet_queued;
+
+    tty_rx_slot_t *ring;
+    uint32_t ring_size;
+    uint32_t head;                          /* written by tty thread only */
+    uint32_t tail;                          /* written by el_default_loop only */
+
+    /* receive frame state machine */
+    MSTP_RX_STATE rx_state;
+    uint8_t header[6];
+    uint16_t rx_index;
+    uint16_t rx_data_len;
+    uint8_t frame_type;
+    uint8_t frame_dst;
+    uint8_t frame_src;
+    bool valid_frame;
+    bool invalid_frame;
+    uint32_t event_count;
+    uint64_t silence_start;                 /* microseconds of the last octet on the wire */
+    uint8_t in_buf[MSTP_MAX_ENCODED_DATA_LEN + 2];
+
+    /* master node state machine */
+    MSTP_MASTER_STATE state;
+    uint64_t state_start;
+    uint8_t next_station;
+    uint8_t poll_station;
+    uint8_t token_count;
+    uint8_t frame_count;
+    uint8_t retry_count;
+    uint8_t reply_to;
+    bool sole_master;
+
+    uint32_t tokenCount;
+    uint32_t txFrameCount;
+    uint32_t rxFrameCount;
+    uint32_t noTokenCount;
+    uint32_t noReplyCount;
+    uint32_t noPassCount;
+    uint32_t errCount;
+    uint32_t postponedCount;
+    uint32_t rxDropCount;
+
+    struct {
+        uint8_t *data;
+        uint16_t len;
+        uint8_t remote;
+        bool sent;
+        bool result;
+        void (*callback) (void*, mstp_test_result_t);
+        void *context;
+    } test;
+} tty_mstp_t;
+
+extern int tty_mstp_frame_encode(uint8_t *to, uint8_t type, uint8_t dst, uint8_t src,
+            const uint8_t *data, uint16_t len);
+
+extern datalink_mstp_t *tty_mstp_port_create(cJSON *cfg, const char *ifname);
+
+extern void tty_mstp_port_destroy(datalink_mstp_t *base);
+
+extern int tty_mstp_startup(datalink_mstp_t *base);
+
+extern void tty_mstp_stop(datalink_mstp_t *base);
+
+extern int tty_mstp_fake_pdu(datalink_mstp_t *base, bacnet_addr_t *dst_mac, uint8_t src_mac,
+            bacnet_buf_t *npdu, bacnet_prio_t prio);
+
+extern int tty_mstp_get_test_result(datalink_mstp_t *base, uint8_t *remote);
+
+extern int tty_mstp_test_remote(datalink_mstp_t *base, uint8_t remote, uint8_t *data,
+            size_t len, void(*callback)(void*, mstp_test_result_t), void *context);
+
 #endif /* _USBMSTP_DEF_H_ */
@@ -0,0 +1,1546 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * mstptty.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * MS/TP master node over a local tty. Receive frame and master node state
+ * machines of Clause 9 run in a dedicated real-time thread, so that cheap
+ * RS-485 adapters could be used without the token passing firmware.
+ *
+ * History
+ */
+
+#define _GNU_SOURCE                         /* ppoll */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <endian.h>
+#include <termios.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/prctl.h>
+#include <sys/eventfd.h>
+
+#include "mstp_def.h"
+#include "bacnet/network.h"
+#include "slaveproxy_def.h"
+#include "misc/threadpool.h"
+
+#ifndef BOTHER
+#define BOTHER                          (0010000)
+#endif
+
+/* linux termios2 for baudrates not in termios, such as 76800 */
+struct termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+
+static uint64_t tty_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static int tty_set_baudrate(int fd, int baudrate)
+{
+    struct termios2 tio2;
+    struct termios tio;
+    speed_t speed;
+
+    switch (baudrate) {
+    case 9600:
+        speed = B9600;
+        break;
+    case 19200:
+        speed = B19200;
+        break;
+    case 38400:
+        speed = B38400;
+        break;
+    case 57600:
+        speed = B57600;
+        break;
+    case 115200:
+        speed = B115200;
+        break;
+    default:
+        speed = 0;
+        break;
+    }
+
+    if (tcgetattr(fd, &tio) < 0) {
+        MSTP_ERROR("%s: tcgetattr failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    cfmakeraw(&tio);
+    tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    tio.c_cflag |= CS8 | CLOCAL | CREAD;
+    tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (speed) {
+        (void)cfsetispeed(&tio, speed);
+        (void)cfsetospeed(&tio, speed);
+    }
+
+    if (tcsetattr(fd, TCSANOW, &tio) < 0) {
+        MSTP_ERROR("%s: tcsetattr failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    if (speed) {
+        return OK;
+    }
+
+    if (ioctl(fd, TCGETS2, &tio2) < 0) {
+        MSTP_ERROR("%s: TCGETS2 failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    tio2.c_cflag &= ~CBAUD;
+    tio2.c_cflag |= BOTHER;
+    tio2.c_ispeed = baudrate;
+    tio2.c_ospeed = baudrate;
+    if (ioctl(fd, TCSETS2, &tio2) < 0) {
+        MSTP_ERROR("%s: set baudrate %d failed cause %s\r\n", __func__, baudrate,
+            strerror(errno));
+        return -EPERM;
+    }
+
+    return OK;
+}
+
+/**
+ * tty_mstp_frame_encode - һMS/TP֡
+ *
+ * @to: MSTP_MAX_FRAME_SIZE
+ * @type: ֡ͣݳMSTP_MAX_NE_DATA_LENʱԶΪCOBSչ֡
+ *
+ * @return: ֡
+ *
+ */
+int tty_mstp_frame_encode(uint8_t *to, uint8_t type, uint8_t dst, uint8_t src,
+        const uint8_t *data, uint16_t len)
+{
+    uint16_t length_field;
+    uint16_t crc;
+    int size;
+
+    size = MSTP_HEADER_SIZE;
+    length_field = len;
+    if (len > MSTP_MAX_NE_DATA_LEN) {
+        if (type == MSTP_FRAME_DATA_EXPECTING_REPLY) {
+            type = MSTP_FRAME_EXT_DATA_EXPECTING_REPLY;
+        } else {
+            type = MSTP_FRAME_EXT_DATA_NOT_EXPECTING_REPLY;
+        }
+        /* length of the encoded data and encoded crc32k, minus two */
+        size += frame_encode(&to[MSTP_HEADER_SIZE], data, len);
+        length_field = size - MSTP_HEADER_SIZE - 2;
+    } else if (len) {
+        memcpy(&to[MSTP_HEADER_SIZE], data, len);
+        crc = ~crc_ccitt(0xffff, data, len);
+        to[MSTP_HEADER_SIZE + len] = crc;
+        to[MSTP_HEADER_SIZE + len + 1] = crc >> 8;
+        size += len + 2;
+    }
+
+    to[0] = MSTP_PREAMBLE1;
+    to[1] = MSTP_PREAMBLE2;
+    to[2] = type;
+    to[3] = dst;
+    to[4] = src;
+    to[5] = length_field >> 8;
+    to[6] = length_field;
+    to[7] = ~crc_header(0xff, &to[2], 5);
+
+    return size;
+}
+
+/* дһ֮֡ǰ֤TturnaroundľĬд¿ʼSilenceTimer */
+static void tty_write_frame(tty_mstp_t *mstp, const uint8_t *frame, int len)
+{
+    struct pollfd pfd;
+    struct timespec ts;
+    uint64_t turnaround;
+    uint64_t silence;
+    int rv;
+
+    turnaround = (uint64_t)mstp->bit_ns * MSTP_T_TURNAROUND_BITS / 1000;
+    silence = tty_now_us() - mstp->silence_start;
+    if (silence < turnaround) {
+        ts.tv_sec = 0;
+        ts.tv_nsec = (turnaround - silence) * 1000;
+        (void)nanosleep(&ts, NULL);
+    }
+
+    while (len > 0) {
+        rv = write(mstp->fd, frame, len);
+        if (rv < 0) {
+            if (errno == EAGAIN) {
+                pfd.fd = mstp->fd;
+                pfd.events = POLLOUT;
+                (void)poll(&pfd, 1, MSTP_T_FRAME_ABORT);
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            MSTP_ERROR("%s: write failed cause %s\r\n", __func__, strerror(errno));
+            break;
+        }
+        frame += rv;
+        len -= rv;
+    }
+
+    (void)tcdrain(mstp->fd);
+    mstp->txFrameCount++;
+    mstp->silence_start = tty_now_us();
+}
+
+static void tty_send_frame(tty_mstp_t *mstp, uint8_t type, uint8_t dst, const uint8_t *data,
+            uint16_t len)
+{
+    uint8_t frame[MSTP_HEADER_SIZE + MSTP_MAX_NE_DATA_LEN + 2];
+
+    if (len > MSTP_MAX_NE_DATA_LEN) {
+        MSTP_ERROR("%s: too large control frame(%d)\r\n", __func__, len);
+        return;
+    }
+
+    tty_write_frame(mstp, frame, tty_mstp_frame_encode(frame, type, dst, mstp->base.mac, data,
+        len));
+}
+
+/* յnpdu뻷ζУel_default_loopݽ */
+static void tty_deliver(tty_mstp_t *mstp, const uint8_t *data, uint16_t len)
+{
+    tty_rx_slot_t *slot;
+    uint64_t value;
+
+    if (len == 0 || len > MSTP_MAX_DATA_LEN) {
+        mstp->errCount++;
+        return;
+    }
+
+    if (mstp->head - __atomic_load_n(&mstp->tail, __ATOMIC_ACQUIRE) >= mstp->ring_size) {
+        mstp->rxDropCount++;
+        return;
+    }
+
+    slot = &mstp->ring[mstp->head % mstp->ring_size];
+    bacnet_buf_init(&slot->rx.buf, MSTP_MAX_DATA_LEN);
+    memcpy(slot->rx.buf.data, data, len);
+    slot->rx.buf.data_len = len;
+    slot->src = mstp->frame_src;
+    slot->bcast = (mstp->frame_dst == MSTP_BROADCAST_ADDRESS);
+    __atomic_store_n(&mstp->head, mstp->head + 1, __ATOMIC_RELEASE);
+
+    value = 1;
+    if (write(mstp->notify_fd, &value, sizeof(value)) < 0) {
+        MSTP_ERROR("%s: notify failed cause %s\r\n", __func__, strerror(errno));
+    }
+}
+
+static void tty_notify_handler(el_watch_t *watch, int events)
+{
+    tty_mstp_t *mstp;
+    tty_rx_slot_t *slot;
+    bacnet_addr_t src_addr;
+    uint64_t value;
+    uint32_t head;
+
+    if (!(events & EPOLLIN)) {
+        MSTP_ERROR("%s: invalid events\r\n", __func__);
+        return;
+    }
+
+    mstp = (tty_mstp_t *)watch->data;
+    if (read(mstp->notify_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        MSTP_ERROR("%s: read eventfd failed cause %s\r\n", __func__, strerror(errno));
+    }
+
+    head = __atomic_load_n(&mstp->head, __ATOMIC_ACQUIRE);
+    while (mstp->tail != head) {
+        slot = &mstp->ring[mstp->tail % mstp->ring_size];
+
+        mstp->base.dl.rx_all++;
+        src_addr.net = 0;
+        src_addr.len = 1;
+        src_addr.adr[0] = slot->src;
+
+        MSTP_VERBOS("%s: received pdu len(%d) from(%d)\r\n", __func__, slot->rx.buf.data_len,
+            slot->src);
+
+        mstp->base.dl.rx_ok++;
+        if (!(slot->bcast && mstp->base.proxy->proxy_enable
+                && network_receive_mstp_proxy_pdu(mstp->base.dl.port_id, &slot->rx.buf) < 0)) {
+            network_receive_pdu(mstp->base.dl.port_id, &slot->rx.buf, &src_addr);
+        }
+
+        __atomic_store_n(&mstp->tail, mstp->tail + 1, __ATOMIC_RELEASE);
+    }
+}
+
+/* Уݲ֣ɹؽݳ */
+static int tty_check_data(tty_mstp_t *mstp)
+{
+    uint32_t crc32k_value;
+    uint8_t crc_buf[MSTP_ENCODED_CRC32K_SIZE];
+    int encoded_len;
+    int len;
+
+    len = mstp->rx_data_len + 2;
+    if (mstp->frame_type < MSTP_FRAME_EXT_DATA_EXPECTING_REPLY) {
+        if (crc_ccitt(0xffff, mstp->in_buf, len) != MSTP_DATA_CRC_RESIDUE) {
+            return -EINVAL;
+        }
+        return mstp->rx_data_len;
+    }
+
+    encoded_len = len - MSTP_ENCODED_CRC32K_SIZE;
+    if (encoded_len <= 0) {
+        return -EINVAL;
+    }
+
+    if (cobs_decode(crc_buf, &mstp->in_buf[encoded_len], MSTP_ENCODED_CRC32K_SIZE) != 4) {
+        return -EINVAL;
+    }
+    memcpy(&crc32k_value, crc_buf, 4);
+    if (le32toh(crc32k_value) != ~crc32k(0xffffffff, mstp->in_buf, encoded_len)) {
+        return -EINVAL;
+    }
+
+    /* decoded data is never longer than encoded data, decode in place */
+    return cobs_decode(mstp->in_buf, mstp->in_buf, encoded_len);
+}
+
+/* Receive Frame״̬ÿoctetһ */
+static void tty_receive_octet(tty_mstp_t *mstp, uint8_t octet)
+{
+    int len;
+
+    mstp->event_count++;
+
+    switch (mstp->rx_state) {
+    case MSTP_RX_IDLE:
+        if (octet == MSTP_PREAMBLE1) {
+            mstp->rx_state = MSTP_RX_PREAMBLE;
+        }
+        break;
+
+    case MSTP_RX_PREAMBLE:
+        if (octet == MSTP_PREAMBLE2) {
+            mstp->rx_index = 0;
+            mstp->rx_state = MSTP_RX_HEADER;
+        } else if (octet != MSTP_PREAMBLE1) {
+            mstp->rx_state = MSTP_RX_IDLE;
+        }
+        break;
+
+    case MSTP_RX_HEADER:
+        mstp->header[mstp->rx_index++] = octet;
+        if (mstp->rx_index < sizeof(mstp->header)) {
+            break;
+        }
+
+        mstp->rx_state = MSTP_RX_IDLE;
+        if (crc_header(0xff, mstp->header, sizeof(mstp->header)) != MSTP_HEADER_CRC_RESIDUE) {
+            mstp->errCount++;
+            mstp->invalid_frame = true;
+            break;
+        }
+
+        mstp->frame_type = mstp->header[0];
+        mstp->frame_dst = mstp->header[1];
+        mstp->frame_src = mstp->header[2];
+        mstp->rx_data_len = (mstp->header[3] << 8) + mstp->header[4];
+        mstp->rx_index = 0;
+
+        if ((mstp->frame_dst != mstp->base.mac)
+                && (mstp->frame_dst != MSTP_BROADCAST_ADDRESS)) {
+            /* not for us */
+            if (mstp->rx_data_len) {
+                mstp->rx_state = MSTP_RX_SKIP_DATA;
+            }
+        } else if (mstp->rx_data_len == 0) {
+            mstp->rxFrameCount++;
+            mstp->valid_frame = true;
+        } else if (mstp->rx_data_len + 2 > sizeof(mstp->in_buf)) {
+            /* frame too long */
+            mstp->errCount++;
+            mstp->invalid_frame = true;
+            mstp->rx_state = MSTP_RX_SKIP_DATA;
+        } else {
+            mstp->rx_state = MSTP_RX_DATA;
+        }
+        break;
+
+    case MSTP_RX_DATA:
+        mstp->in_buf[mstp->rx_index++] = octet;
+        if (mstp->rx_index < mstp->rx_data_len + 2) {
+            break;
+        }
+
+        mstp->rx_state = MSTP_RX_IDLE;
+        len = tty_check_data(mstp);
+        if (len < 0) {
+            mstp->errCount++;
+            mstp->invalid_frame = true;
+            break;
+        }
+        mstp->rx_data_len = len;
+        mstp->rxFrameCount++;
+        mstp->valid_frame = true;
+        break;
+
+    case MSTP_RX_SKIP_DATA:
+        if (++mstp->rx_index >= mstp->rx_data_len + 2) {
+            mstp->rx_state = MSTP_RX_IDLE;
+        }
+        break;
+
+    default:
+        mstp->rx_state = MSTP_RX_IDLE;
+        break;
+    }
+}
+
+static void tty_test_done(tty_mstp_t *mstp, bool success)
+{
+    mstp_test_result_t result;
+
+    pthread_mutex_lock(&mstp->mutex);
+
+    if (mstp->test.data == NULL || !mstp->test.sent) {
+        pthread_mutex_unlock(&mstp->mutex);
+        return;
+    }
+
+    mstp->test.result = success;
+    if (mstp->test.callback) {
+        result.remote_mac = mstp->test.remote;
+        result.success = success;
+        if (tp_queue_work(&tp_default_pool, (tp_work_func)mstp->test.callback,
+                mstp->test.context, result._u) < 0) {
+            MSTP_ERROR("%s: queue test response callback fail\r\n", __func__);
+        }
+    }
+    free(mstp->test.data);
+    mstp->test.data = NULL;
+    mstp->test.callback = NULL;
+    mstp->test.context = NULL;
+
+    pthread_mutex_unlock(&mstp->mutex);
+}
+
+static void tty_check_test_response(tty_mstp_t *mstp)
+{
+    bool success;
+
+    pthread_mutex_lock(&mstp->mutex);
+    success = (mstp->test.data != NULL) && (mstp->frame_src == mstp->test.remote)
+        && (mstp->rx_data_len == mstp->test.len)
+        && (memcmp(mstp->in_buf, mstp->test.data, mstp->test.len) == 0);
+    pthread_mutex_unlock(&mstp->mutex);
+
+    MSTP_VERBOS("%s: test remote mac(%d) %s\r\n", __func__, mstp->frame_src,
+        success? "success": "not match");
+
+    tty_test_done(mstp, success);
+}
+
+/* ظʱӸߵȼҷreply_toӦ֡mstp_prio_pickѡ */
+static tty_frame_t *tty_dequeue(tty_mstp_t *mstp, bool reply_only)
+{
+    tty_frame_t *frame;
+    int prio;
+
+    pthread_mutex_lock(&mstp->mutex);
+
+    if (!reply_only) {
+        prio = mstp_prio_pick(mstp->prio, mstp->starve_limit);
+        if (prio >= 0) {
+            frame = list_first_entry(&mstp->tx_queue[prio], tty_frame_t, node);
+            goto found;
+        }
+    } else {
+        for (prio = MSTP_TX_PRIO_NUM - 1; prio >= 0; prio--) {
+            list_for_each_entry(frame, &mstp->tx_queue[prio], node) {
+                if ((frame->dst == mstp->reply_to)
+                        && ((frame->type == MSTP_FRAME_DATA_NOT_EXPECTING_REPLY)
+                            || (frame->type == MSTP_FRAME_EXT_DATA_NOT_EXPECTING_REPLY))) {
+                    goto found;
+                }
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&mstp->mutex);
+    return NULL;
+
+found:
+    list_del(&frame->node);
+    mstp->tx_queued_size[prio] -= frame->len;
+    mstp->prio[prio].queued--;
+    mstp_prio_sent(mstp->prio, prio, el_current_millisecond() - frame->stamp);
+    mstp->packet_queued--;
+    pthread_mutex_unlock(&mstp->mutex);
+
+    return frame;
+}
+
+/* ʱȷ֡ٷе֡ǷҪȴӦ-1Ϊ֡ɷ */
+static int tty_send_next(tty_mstp_t *mstp)
+{
+    uint8_t data[MSTP_MAX_NE_DATA_LEN];
+    tty_frame_t *frame;
+    uint8_t remote;
+    uint16_t len;
+    int expecting;
+
+    pthread_mutex_lock(&mstp->mutex);
+    if (mstp->test.data != NULL && !mstp->test.sent) {
+        mstp->test.sent = true;
+        remote = mstp->test.remote;
+        len = mstp->test.len;
+        memcpy(data, mstp->test.data, len);
+        pthread_mutex_unlock(&mstp->mutex);
+
+        tty_send_frame(mstp, MSTP_FRAME_TEST_REQUEST, remote, data, len);
+        return 1;
+    }
+    pthread_mutex_unlock(&mstp->mutex);
+
+    frame = tty_dequeue(mstp, false);
+    if (frame == NULL) {
+        return -1;
+    }
+
+    tty_write_frame(mstp, frame->data, frame->len);
+    expecting = (frame->type == MSTP_FRAME_DATA_EXPECTING_REPLY)
+        || (frame->type == MSTP_FRAME_EXT_DATA_EXPECTING_REPLY);
+    free(frame);
+
+    return expecting;
+}
+
+/* IDLE״̬´յЧ֡ */
+static void tty_idle_frame(tty_mstp_t *mstp, uint64_t now)
+{
+    bool for_us;
+
+    for_us = (mstp->frame_dst == mstp->base.mac);
+
+    switch (mstp->frame_type) {
+    case MSTP_FRAME_TOKEN:
+        if (for_us) {
+            mstp->tokenCount++;
+            mstp->frame_count = 0;
+            mstp->sole_master = false;
+            mstp->state = MSTP_MASTER_USE_TOKEN;
+        }
+        break;
+
+    case MSTP_FRAME_POLL_FOR_MASTER:
+        if (for_us) {
+            tty_send_frame(mstp, MSTP_FRAME_REPLY_TO_POLL_FOR_MASTER, mstp->frame_src, NULL, 0);
+        }
+        break;
+
+    case MSTP_FRAME_TEST_REQUEST:
+        if (for_us) {
+            tty_send_frame(mstp, MSTP_FRAME_TEST_RESPONSE, mstp->frame_src, mstp->in_buf,
+                mstp->rx_data_len);
+        }
+        break;
+
+    case MSTP_FRAME_DATA_EXPECTING_REPLY:
+    case MSTP_FRAME_EXT_DATA_EXPECTING_REPLY:
+        if (!for_us) {
+            break;
+        }
+        tty_deliver(mstp, mstp->in_buf, mstp->rx_data_len);
+        mstp->reply_to = mstp->frame_src;
+        mstp->state_start = now;
+        mstp->state = MSTP_MASTER_ANSWER_DATA_REQUEST;
+        break;
+
+    case MSTP_FRAME_DATA_NOT_EXPECTING_REPLY:
+    case MSTP_FRAME_EXT_DATA_NOT_EXPECTING_REPLY:
+        tty_deliver(mstp, mstp->in_buf, mstp->rx_data_len);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * tty_master_fsm - Master Node״̬
+ *
+ * @return: trueʾ״̬ǨƣҪһ
+ *
+ */
+static bool tty_master_fsm(tty_mstp_t *mstp, uint64_t now)
+{
+    MSTP_MASTER_STATE old_state;
+    uint64_t silence;
+    uint8_t this_station;
+    uint8_t nmax;
+    int rv;
+
+    silence = (now - mstp->silence_start) / 1000;
+    this_station = mstp->base.mac;
+    nmax = mstp->base.max_master + 1;
+    old_state = mstp->state;
+
+    switch (mstp->state) {
+    case MSTP_MASTER_INITIALIZE:
+        mstp->next_station = this_station;
+        mstp->poll_station = this_station;
+        mstp->token_count = MSTP_N_POLL;
+        mstp->sole_master = false;
+        mstp->valid_frame = false;
+        mstp->invalid_frame = false;
+        mstp->state = MSTP_MASTER_IDLE;
+        break;
+
+    case MSTP_MASTER_IDLE:
+        if (mstp->valid_frame) {
+            mstp->valid_frame = false;
+            tty_idle_frame(mstp, now);
+        } else if (mstp->invalid_frame) {
+            mstp->invalid_frame = false;
+        } else if (silence >= MSTP_T_NO_TOKEN) {
+            /* LostToken */
+            mstp->noTokenCount++;
+            mstp->event_count = 0;
+            mstp->state = MSTP_MASTER_NO_TOKEN;
+        }
+        break;
+
+    case MSTP_MASTER_USE_TOKEN:
+        rv = tty_send_next(mstp);
+        if (rv < 0) {
+            /* NothingToSend */
+            mstp->frame_count = mstp->base.max_info_frames;
+            mstp->state = MSTP_MASTER_DONE_WITH_TOKEN;
+        } else {
+            mstp->frame_count++;
+            mstp->state = rv? MSTP_MASTER_WAIT_FOR_REPLY: MSTP_MASTER_DONE_WITH_TOKEN;
+        }
+        break;
+
+    case MSTP_MASTER_WAIT_FOR_REPLY:
+        if (silence >= mstp->base.reply_timeout) {
+            /* ReplyTimeout */
+            mstp->noReplyCount++;
+            mstp->frame_count = mstp->base.max_info_frames;
+            tty_test_done(mstp, false);
+            mstp->state = MSTP_MASTER_DONE_WITH_TOKEN;
+        } else if (mstp->invalid_frame) {
+            mstp->invalid_frame = false;
+            tty_test_done(mstp, false);
+            mstp->state = MSTP_MASTER_DONE_WITH_TOKEN;
+        } else if (mstp->valid_frame) {
+            mstp->valid_frame = false;
+            mstp->state = MSTP_MASTER_DONE_WITH_TOKEN;
+            if (mstp->frame_dst != this_station) {
+                mstp->state = MSTP_MASTER_IDLE;
+            } else if (mstp->frame_type == MSTP_FRAME_TEST_RESPONSE) {
+                tty_check_test_response(mstp);
+            } else if ((mstp->frame_type == MSTP_FRAME_DATA_NOT_EXPECTING_REPLY)
+                    || (mstp->frame_type == MSTP_FRAME_EXT_DATA_NOT_EXPECTING_REPLY)) {
+                tty_deliver(mstp, mstp->in_buf, mstp->rx_data_len);
+            } else if (mstp->frame_type == MSTP_FRAME_REPLY_POSTPONED) {
+                /* ReceivedPostpone */
+            } else {
+                /* ReceivedUnexpectedFrame */
+                mstp->state = MSTP_MASTER_IDLE;
+            }
+            tty_test_done(mstp, false);
+        }
+        break;
+
+    case MSTP_MASTER_DONE_WITH_TOKEN:
+        if (mstp->frame_count < mstp->base.max_info_frames) {
+            /* SendAnotherFrame */
+            mstp->state = MSTP_MASTER_USE_TOKEN;
+        } else if (!mstp->sole_master && (mstp->next_station == this_station)) {
+            /* NextStationUnknown */
+            mstp->poll_station = (this_station + 1) % nmax;
+            tty_send_frame(mstp, MSTP_FRAME_POLL_FOR_MASTER, mstp->poll_station, NULL, 0);
+            mstp->retry_count = 0;
+            mstp->state = MSTP_MASTER_POLL_FOR_MASTER;
+        } else if (mstp->token_count < MSTP_N_POLL - 1) {
+            mstp->token_count++;
+            if (mstp->sole_master && (mstp->next_station != (this_station + 1) % nmax)) {
+                /* SoleMaster */
+                mstp->frame_count = 0;
+                mstp->state = MSTP_MASTER_USE_TOKEN;
+            } else {
+                /* SendToken */
+                tty_send_frame(mstp, MSTP_FRAME_TOKEN, mstp->next_station, NULL, 0);
+                mstp->retry_count = 0;
+                mstp->event_count = 0;
+                mstp->state = MSTP_MASTER_PASS_TOKEN;
+            }
+        } else if ((mstp->poll_station + 1) % nmax != mstp->next_station) {
+            /* SendMaintenancePFM */
+            mstp->poll_station = (mstp->poll_station + 1) % nmax;
+            tty_send_frame(mstp, MSTP_FRAME_POLL_FOR_MASTER, mstp->poll_station, NULL, 0);
+            mstp->retry_count = 0;
+            mstp->state = MSTP_MASTER_POLL_FOR_MASTER;
+        } else if (!mstp->sole_master) {
+            /* ResetMaintenancePFM */
+            mstp->poll_station = this_station;
+            tty_send_frame(mstp, MSTP_FRAME_TOKEN, mstp->next_station, NULL, 0);
+            mstp->retry_count = 0;
+            mstp->token_count = 1;
+            mstp->event_count = 0;
+            mstp->state = MSTP_MASTER_PASS_TOKEN;
+        } else {
+            /* SoleMasterRestartMaintenancePFM */
+            mstp->poll_station = (mstp->next_station + 1) % nmax;
+            tty_send_frame(mstp, MSTP_FRAME_POLL_FOR_MASTER, mstp->poll_station, NULL, 0);
+            mstp->next_station = this_station;
+            mstp->retry_count = 0;
+            mstp->token_count = 1;
+            mstp->event_count = 0;
+            mstp->state = MSTP_MASTER_POLL_FOR_MASTER;
+        }
+        break;
+
+    case MSTP_MASTER_PASS_TOKEN:
+        if (silence < mstp->base.usage_timeout) {
+            if (mstp->event_count > MSTP_N_MIN_OCTETS) {
+                /* SawTokenUser */
+                mstp->state = MSTP_MASTER_IDLE;
+            }
+        } else if (mstp->retry_count < MSTP_N_RETRY_TOKEN) {
+            /* RetrySendToken */
+            mstp->retry_count++;
+            tty_send_frame(mstp, MSTP_FRAME_TOKEN, mstp->next_station, NULL, 0);
+            mstp->event_count = 0;
+        } else {
+            /* FindNewSuccessor */
+            mstp->noPassCount++;
+            mstp->poll_station = (mstp->next_station + 1) % nmax;
+            tty_send_frame(mstp, MSTP_FRAME_POLL_FOR_MASTER, mstp->poll_station, NULL, 0);
+            mstp->next_station = this_station;
+            mstp->retry_count = 0;
+            mstp->token_count = 0;
+            mstp->event_count = 0;
+            mstp->state = MSTP_MASTER_POLL_FOR_MASTER;
+        }
+        break;
+
+    case MSTP_MASTER_NO_TOKEN:
+        if (silence < MSTP_T_NO_TOKEN + MSTP_T_SLOT * this_station) {
+            if (mstp->event_count > MSTP_N_MIN_OCTETS) {
+                /* SawFrame */
+                mstp->state = MSTP_MASTER_IDLE;
+            }
+        } else {
+            /* GenerateToken */
+            mstp->poll_station = (this_station + 1) % nmax;
+            tty_send_frame(mstp, MSTP_FRAME_POLL_FOR_MASTER, mstp->poll_station, NULL, 0);
+            mstp->next_station = this_station;
+            mstp->token_count = 0;
+            mstp->retry_count = 0;
+            mstp->event_count = 0;
+            mstp->state = MSTP_MASTER_POLL_FOR_MASTER;
+        }
+        break;
+
+    case MSTP_MASTER_POLL_FOR_MASTER:
+        if (mstp->valid_frame) {
+            mstp->valid_frame = false;
+            if ((mstp->frame_dst == this_station)
+                    && (mstp->frame_type == MSTP_FRAME_REPLY_TO_POLL_FOR_MASTER)) {
+                /* ReceivedReplyToPFM */
+                mstp->sole_master = false;
+                mstp->next_station = mstp->frame_src;
+                mstp->event_count = 0;
+                tty_send_frame(mstp, MSTP_FRAME_TOKEN, mstp->next_station, NULL, 0);
+                mstp->poll_station = this_station;
+                mstp->token_count = 0;
+                mstp->retry_count = 0;
+                mstp->state = MSTP_MASTER_PASS_TOKEN;
+            } else {
+                /* ReceivedUnexpectedFrame */
+                mstp->state = MSTP_MASTER_IDLE;
+            }
+        } else if ((silence >= mstp->base.usage_timeout) || mstp->invalid_frame) {
+            mstp->invalid_frame = false;
+            if (mstp->sole_master) {
+                /* SoleMaster */
+                mstp->frame_count = 0;
+                mstp->state = MSTP_MASTER_USE_TOKEN;
+            } else if (mstp->next_station != this_station) {
+                /* DoneWithPFM */
+                mstp->event_count = 0;
+                tty_send_frame(mstp, MSTP_FRAME_TOKEN, mstp->next_station, NULL, 0);
+                mstp->retry_count = 0;
+                mstp->state = MSTP_MASTER_PASS_TOKEN;
+            } else if ((mstp->poll_station + 1) % nmax != this_station) {
+                /* SendNextPFM */
+                mstp->poll_station = (mstp->poll_station + 1) % nmax;
+                tty_send_frame(mstp, MSTP_FRAME_POLL_FOR_MASTER, mstp->poll_station, NULL, 0);
+                mstp->retry_count = 0;
+            } else {
+                /* DeclareSoleMaster */
+                mstp->sole_master = true;
+                mstp->frame_count = 0;
+                mstp->state = MSTP_MASTER_USE_TOKEN;
+            }
+        }
+        break;
+
+    case MSTP_MASTER_ANSWER_DATA_REQUEST:
+        {
+            tty_frame_t *frame = tty_dequeue(mstp, true);
+            if (frame) {
+                /* Reply */
+                tty_write_frame(mstp, frame->data, frame->len);
+                free(frame);
+                mstp->state = MSTP_MASTER_IDLE;
+            } else if ((now - mstp->state_start) / 1000 >= MSTP_T_REPLY_DELAY) {
+                /* DeferredReply */
+                mstp->postponedCount++;
+                tty_send_frame(mstp, MSTP_FRAME_REPLY_POSTPONED, mstp->reply_to, NULL, 0);
+                mstp->state = MSTP_MASTER_IDLE;
+            }
+        }
+        break;
+
+    default:
+        mstp->state = MSTP_MASTER_INITIALIZE;
+        break;
+    }
+
+    if (mstp->state != old_state) {
+        mstp->state_start = (mstp->state == MSTP_MASTER_ANSWER_DATA_REQUEST)? mstp->state_start:
+            tty_now_us();
+        return true;
+    }
+
+    return false;
+}
+
+/* һγʱ΢ */
+static int64_t tty_next_timeout(tty_mstp_t *mstp, uint64_t now)
+{
+    int64_t silence;
+    int64_t timeout;
+
+    silence = now - mstp->silence_start;
+
+    switch (mstp->state) {
+    case MSTP_MASTER_IDLE:
+        timeout = MSTP_T_NO_TOKEN * 1000LL - silence;
+        break;
+
+    case MSTP_MASTER_WAIT_FOR_REPLY:
+        timeout = mstp->base.reply_timeout * 1000LL - silence;
+        break;
+
+    case MSTP_MASTER_PASS_TOKEN:
+    case MSTP_MASTER_POLL_FOR_MASTER:
+        timeout = mstp->base.usage_timeout * 1000LL - silence;
+        break;
+
+    case MSTP_MASTER_NO_TOKEN:
+        timeout = (MSTP_T_NO_TOKEN + MSTP_T_SLOT * mstp->base.mac) * 1000LL - silence;
+        break;
+
+    case MSTP_MASTER_ANSWER_DATA_REQUEST:
+        timeout = MSTP_T_REPLY_DELAY * 1000LL - (int64_t)(now - mstp->state_start);
+        break;
+
+    default:
+        timeout = 0;
+        break;
+    }
+
+    if ((mstp->rx_state != MSTP_RX_IDLE) && (MSTP_T_FRAME_ABORT * 1000LL - silence < timeout)) {
+        timeout = MSTP_T_FRAME_ABORT * 1000LL - silence;
+    }
+
+    return timeout > 0? timeout: 0;
+}
+
+static void tty_run_fsm(tty_mstp_t *mstp)
+{
+    while (tty_master_fsm(mstp, tty_now_us())) {
+        ;
+    }
+}
+
+static void *tty_thread_func(tty_mstp_t *mstp)
+{
+    struct pollfd fds[2];
+    struct timespec ts;
+    uint8_t buf[256];
+    uint64_t value;
+    uint64_t now;
+    int64_t timeout;
+    char name[16];
+    int i, n;
+
+    (void)snprintf(name, sizeof(name), "mstp%d_tty", mstp->base.dl.port_id);
+    (void)prctl(PR_SET_NAME, name);
+
+    fds[0].fd = mstp->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = mstp->wake_fd;
+    fds[1].events = POLLIN;
+
+    mstp->silence_start = tty_now_us();
+    tty_run_fsm(mstp);
+
+    while (!__atomic_load_n(&mstp->stopping, __ATOMIC_ACQUIRE)) {
+        timeout = tty_next_timeout(mstp, tty_now_us());
+        ts.tv_sec = timeout / 1000000;
+        ts.tv_nsec = (timeout % 1000000) * 1000;
+        if (ppoll(fds, 2, &ts, NULL) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            MSTP_ERROR("%s: ppoll failed cause %s\r\n", __func__, strerror(errno));
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            (void)read(mstp->wake_fd, &value, sizeof(value));
+        }
+
+        if (fds[0].revents & POLLIN) {
+            n = read(mstp->fd, buf, sizeof(buf));
+            if (n > 0) {
+                mstp->silence_start = tty_now_us();
+                for (i = 0; i < n; i++) {
+                    tty_receive_octet(mstp, buf[i]);
+                    if (mstp->valid_frame || mstp->invalid_frame) {
+                        tty_run_fsm(mstp);
+                    }
+                }
+            } else if ((n < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+                MSTP_ERROR("%s: read failed cause %s\r\n", __func__, strerror(errno));
+            }
+        } else if (fds[0].revents & (POLLERR | POLLHUP)) {
+            /* peer of a pty is closed, do not spin */
+            (void)poll(NULL, 0, MSTP_T_SLOT);
+        }
+
+        now = tty_now_us();
+        if ((mstp->rx_state != MSTP_RX_IDLE)
+                && (now - mstp->silence_start >= MSTP_T_FRAME_ABORT * 1000ULL)) {
+            /* frame abort */
+            if (mstp->rx_state == MSTP_RX_DATA) {
+                mstp->invalid_frame = true;
+            }
+            mstp->errCount++;
+            mstp->rx_state = MSTP_RX_IDLE;
+        }
+
+        tty_run_fsm(mstp);
+    }
+
+    return NULL;
+}
+
+static int tty_send_pdu(tty_mstp_t *mstp, bacnet_addr_t *dst_mac, uint8_t src_mac,
+            bacnet_buf_t *npdu, bacnet_prio_t prio)
+{
+    tty_frame_t *frame;
+    uint64_t value;
+    uint8_t type;
+    uint8_t dst;
+
+    if ((npdu == NULL) || (npdu->data == NULL) || (npdu->data_len == 0)
+            || (npdu->data_len > MSTP_MAX_DATA_LEN)) {
+        MSTP_ERROR("%s: invalid npdu\r\n", __func__);
+        return -EINVAL;
+    }
+
+    if ((dst_mac == NULL) || (dst_mac->len == 0)) {
+        dst = (uint8_t)MSTP_BROADCAST_ADDRESS;
+    } else if (dst_mac->len == 1) {
+        if (dst_mac->adr[0] == MSTP_BROADCAST_ADDRESS) {
+            MSTP_ERROR("%s: unicast to broadcast mac\r\n", __func__);
+            return -EINVAL;
+        }
+        dst = dst_mac->adr[0];
+    } else {
+        MSTP_ERROR("%s: invalid dst_mac len(%d)\r\n", __func__, dst_mac->len);
+        return -EINVAL;
+    }
+
+    if (dst == mstp->base.mac) {
+        return npdu->data_len;
+    }
+
+    /* data_expecting_reply of npdu control, never for broadcast */
+    type = MSTP_FRAME_DATA_NOT_EXPECTING_REPLY;
+    if ((dst != MSTP_BROADCAST_ADDRESS) && (npdu->data_len >= 2) && (npdu->data[1] & 0x04)) {
+        type = MSTP_FRAME_DATA_EXPECTING_REPLY;
+    }
+
+    frame = (tty_frame_t *)malloc(sizeof(tty_frame_t) + MSTP_MAX_FRAME_SIZE);
+    if (frame == NULL) {
+        MSTP_ERROR("%s: not enough memory\r\n", __func__);
+        return -ENOMEM;
+    }
+    frame->len = tty_mstp_frame_encode(frame->data, type, dst, src_mac, npdu->data,
+        npdu->data_len);
+    frame->type = frame->data[2];
+    frame->dst = dst;
+    frame->stamp = el_current_millisecond();
+
+    if ((unsigned)prio >= MSTP_TX_PRIO_NUM) {
+        prio = PRIORITY_NORMAL;
+    }
+
+    pthread_mutex_lock(&mstp->mutex);
+
+    if (mstp->tx_queued_size[prio] + frame->len > mstp->base.tx_buf_size) {
+        mstp->prio[prio].dropped++;
+        pthread_mutex_unlock(&mstp->mutex);
+        MSTP_ERROR("%s: write %d bytes overflow\r\n", __func__, npdu->data_len);
+        free(frame);
+        return -EPERM;
+    }
+
+    list_add_tail(&frame->node, &mstp->tx_queue[prio]);
+    mstp->tx_queued_size[prio] += frame->len;
+    mstp->prio[prio].queued++;
+    mstp->packet_queued++;
+
+    pthread_mutex_unlock(&mstp->mutex);
+
+    /* a reply may be waited in ANSWER_DATA_REQUEST */
+    value = 1;
+    if (write(mstp->wake_fd, &value, sizeof(value)) < 0) {
+        MSTP_ERROR("%s: wake tty thread failed cause %s\r\n", __func__, strerror(errno));
+    }
+
+    return OK;
+}
+
+static int tty_mstp_send_pdu(tty_mstp_t *mstp, bacnet_addr_t *dst_mac, bacnet_buf_t *npdu,
+            bacnet_prio_t prio, bool der)
+{
+    int rv;
+
+    if (!mstp) {
+        MSTP_ERROR("%s: null mstp\r\n", __func__);
+        return -EINVAL;
+    }
+
+    mstp->base.dl.tx_all++;
+
+    rv = tty_send_pdu(mstp, dst_mac, der? mstp->base.mac: MSTP_BROADCAST_ADDRESS, npdu, prio);
+    if (rv < 0) {
+        MSTP_ERROR("%s: send failed\r\n", __func__);
+        return rv;
+    }
+
+    if (mstp->base.proxy->proxy_enable && (dst_mac == NULL || dst_mac->len == 0)) {
+        network_receive_mstp_proxy_pdu(mstp->base.dl.port_id, npdu);
+    }
+
+    mstp->base.dl.tx_ok++;
+
+    return OK;
+}
+
+int tty_mstp_fake_pdu(datalink_mstp_t *base, bacnet_addr_t *dst_mac, uint8_t src_mac,
+        bacnet_buf_t *npdu, bacnet_prio_t prio)
+{
+    return tty_send_pdu((tty_mstp_t *)base, dst_mac, src_mac, npdu, prio);
+}
+
+static const char *tty_state_name(MSTP_MASTER_STATE state)
+{
+    static const char *names[] = {
+        "INITIALIZE", "IDLE", "USE_TOKEN", "WAIT_FOR_REPLY", "DONE_WITH_TOKEN", "PASS_TOKEN",
+        "NO_TOKEN", "POLL_FOR_MASTER", "ANSWER_DATA_REQUEST",
+    };
+
+    if (state > MSTP_MASTER_ANSWER_DATA_REQUEST) {
+        return "UNKNOWN";
+    }
+
+    return names[state];
+}
+
+static cJSON *tty_mstp_get_mib(datalink_base_t *dl_port)
+{
+    tty_mstp_t *mstp;
+    cJSON *result;
+
+    if (dl_port == NULL) {
+        MSTP_ERROR("%s: invalid argument\r\n", __func__);
+        return NULL;
+    }
+
+    result = datalink_get_mib(dl_port);
+    if (result == NULL) {
+        MSTP_ERROR("%s: datalink_get_mib failed\r\n", __func__);
+        return NULL;
+    }
+
+    mstp = (tty_mstp_t *)dl_port;
+
+    cJSON_AddStringToObject(result, "driver", "TTY");
+    cJSON_AddStringToObject(result, "ifname", mstp->ifname);
+
+    pthread_mutex_lock(&mstp->mutex);
+    cJSON_AddNumberToObject(result, "tx_queue", mstp->packet_queued);
+    cJSON_AddNumberToObject(result, "tx_starve_limit", mstp->starve_limit);
+    cJSON_AddItemToObject(result, "tx_prio", mstp_prio_get_mib(mstp->prio));
+    pthread_mutex_unlock(&mstp->mutex);
+
+    /* counters of the tty thread, read without lock */
+    cJSON_AddStringToObject(result, "state", tty_state_name(mstp->state));
+    cJSON_AddNumberToObject(result, "this_station", mstp->base.mac);
+    cJSON_AddNumberToObject(result, "next_station", mstp->next_station);
+    if (mstp->sole_master) {
+        cJSON_AddTrueToObject(result, "sole_master");
+    } else {
+        cJSON_AddFalseToObject(result, "sole_master");
+    }
+    cJSON_AddNumberToObject(result, "tokenCount", mstp->tokenCount);
+    cJSON_AddNumberToObject(result, "txFrameCount", mstp->txFrameCount);
+    cJSON_AddNumberToObject(result, "rxFrameCount", mstp->rxFrameCount);
+    cJSON_AddNumberToObject(result, "noTokenCount", mstp->noTokenCount);
+    cJSON_AddNumberToObject(result, "noReplyCount", mstp->noReplyCount);
+    cJSON_AddNumberToObject(result, "noPassCount", mstp->noPassCount);
+    cJSON_AddNumberToObject(result, "errorCount", mstp->errCount);
+    cJSON_AddNumberToObject(result, "replyPostponedCount", mstp->postponedCount);
+    cJSON_AddNumberToObject(result, "rxDropCount", mstp->rxDropCount);
+
+    cJSON_AddItemToObject(result, "proxy", slave_proxy_get_mib(mstp->base.proxy));
+
+    return result;
+}
+
+int tty_mstp_startup(datalink_mstp_t *base)
+{
+    tty_mstp_t *mstp;
+    pthread_attr_t attr;
+    struct sched_param param;
+    int rv;
+
+    mstp = (tty_mstp_t *)base;
+
+    mstp->base.dl.tx_all = 0;
+    mstp->base.dl.tx_ok = 0;
+    mstp->base.dl.rx_all = 0;
+    mstp->base.dl.rx_ok = 0;
+
+    mstp->head = 0;
+    mstp->tail = 0;
+    mstp->rx_state = MSTP_RX_IDLE;
+    mstp->state = MSTP_MASTER_INITIALIZE;
+    mstp->stopping = false;
+    mstp->tokenCount = 0;
+    mstp->txFrameCount = 0;
+    mstp->rxFrameCount = 0;
+    mstp->noTokenCount = 0;
+    mstp->noReplyCount = 0;
+    mstp->noPassCount = 0;
+    mstp->errCount = 0;
+    mstp->postponedCount = 0;
+    mstp->rxDropCount = 0;
+
+    (void)tcflush(mstp->fd, TCIOFLUSH);
+
+    mstp->watch = el_watch_create(&el_default_loop, mstp->notify_fd, EPOLLIN);
+    if (mstp->watch == NULL) {
+        MSTP_ERROR("%s: create notify watch failed\r\n", __func__);
+        return -EPERM;
+    }
+    mstp->watch->handler = tty_notify_handler;
+    mstp->watch->data = mstp;
+
+    rv = -1;
+    if (mstp->rt_priority > 0) {
+        pthread_attr_init(&attr);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        param.sched_priority = mstp->rt_priority;
+        pthread_attr_setschedparam(&attr, &param);
+        rv = pthread_create(&mstp->thread, &attr, (void*(*)(void*))tty_thread_func, mstp);
+        pthread_attr_destroy(&attr);
+        if (rv != 0) {
+            MSTP_WARN("%s: create SCHED_FIFO thread failed cause %s, use normal thread\r\n",
+                __func__, strerror(rv));
+        }
+    }
+
+    if (rv != 0) {
+        rv = pthread_create(&mstp->thread, NULL, (void*(*)(void*))tty_thread_func, mstp);
+        if (rv != 0) {
+            MSTP_ERROR("%s: create tty thread failed cause %s\r\n", __func__, strerror(rv));
+            (void)el_watch_destroy(&el_default_loop, mstp->watch);
+            mstp->watch = NULL;
+            return -EPERM;
+        }
+    }
+    mstp->started = true;
+
+    return OK;
+}
+
+void tty_mstp_stop(datalink_mstp_t *base)
+{
+    tty_mstp_t *mstp;
+    uint64_t value;
+
+    mstp = (tty_mstp_t *)base;
+
+    if (mstp->started) {
+        __atomic_store_n(&mstp->stopping, true, __ATOMIC_RELEASE);
+        value = 1;
+        if (write(mstp->wake_fd, &value, sizeof(value)) != sizeof(value)) {
+            MSTP_ERROR("%s: wake tty thread failed cause %s\r\n", __func__, strerror(errno));
+        }
+        (void)pthread_join(mstp->thread, NULL);
+        mstp->started = false;
+        (void)read(mstp->wake_fd, &value, sizeof(value));
+    }
+
+    if (mstp->watch) {
+        (void)el_watch_destroy(&el_default_loop, mstp->watch);
+        mstp->watch = NULL;
+    }
+}
+
+void tty_mstp_port_destroy(datalink_mstp_t *base)
+{
+    tty_mstp_t *mstp;
+    tty_frame_t *frame, *tmp;
+    int i;
+
+    mstp = (tty_mstp_t *)base;
+
+    for (i = 0; i < MSTP_TX_PRIO_NUM; i++) {
+        list_for_each_entry_safe(frame, tmp, &mstp->tx_queue[i], node) {
+            list_del(&frame->node);
+            free(frame);
+        }
+    }
+
+    if (mstp->test.data) {
+        free(mstp->test.data);
+    }
+
+    if (mstp->fd >= 0) {
+        close(mstp->fd);
+    }
+    if (mstp->wake_fd >= 0) {
+        close(mstp->wake_fd);
+    }
+    if (mstp->notify_fd >= 0) {
+        close(mstp->notify_fd);
+    }
+
+    free(mstp->ring);
+    free(mstp->ifname);
+    pthread_mutex_destroy(&mstp->mutex);
+    free(mstp);
+}
+
+/* ȡֵ鷶Χȡcfgɾ */
+static int tty_cfg_get_number(cJSON *cfg, const char *name, int min, int max, int *value)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, name);
+    if (tmp == NULL) {
+        return 0;
+    }
+
+    if (tmp->type != cJSON_Number) {
+        MSTP_ERROR("%s: %s item should be number\r\n", __func__, name);
+        return -EINVAL;
+    }
+
+    if ((tmp->valueint < min) || (tmp->valueint > max)) {
+        MSTP_ERROR("%s: %s item should be in %d~%d\r\n", __func__, name, min, max);
+        return -EINVAL;
+    }
+
+    *value = tmp->valueint;
+    cJSON_DeleteItemFromObject(cfg, name);
+
+    return 1;
+}
+
+/**
+ * tty_mstp_port_create - شϵmstp˿
+ *
+ * @cfg: ˿ãѴᱻɾ
+ * @ifname: 豸/dev/ttyUSB0
+ *
+ * @return: ɹض˿ڶʧܷNULL
+ *
+ */
+datalink_mstp_t *tty_mstp_port_create(cJSON *cfg, const char *ifname)
+{
+    tty_mstp_t *mstp;
+    int baudrate;
+    int value;
+    int rv, i;
+
+    mstp = (tty_mstp_t *)malloc(sizeof(tty_mstp_t));
+    if (!mstp) {
+        MSTP_ERROR("%s: malloc tty_mstp_t failed\r\n", __func__);
+        return NULL;
+    }
+    memset(mstp, 0, sizeof(tty_mstp_t));
+    mstp->fd = -1;
+    mstp->wake_fd = -1;
+    mstp->notify_fd = -1;
+    for (i = 0; i < MSTP_TX_PRIO_NUM; i++) {
+        INIT_LIST_HEAD(&mstp->tx_queue[i]);
+    }
+
+    mstp->base.driver = MSTP_DRIVER_TTY;
+    mstp->base.dl.send_pdu = (int(*)(datalink_base_t *, bacnet_addr_t *, bacnet_buf_t *,
+        bacnet_prio_t, bool))tty_mstp_send_pdu;
+    mstp->base.dl.get_port_mib = tty_mstp_get_mib;
+    mstp->base.dl.max_npdu_len = MSTP_MAX_DATA_LEN;
+
+    rv = pthread_mutex_init(&mstp->mutex, NULL);
+    if (rv) {
+        MSTP_ERROR("%s: init mutex failed cause %s\r\n", __func__, strerror(rv));
+        free(mstp);
+        return NULL;
+    }
+
+    mstp->ifname = strdup(ifname);
+    if (mstp->ifname == NULL) {
+        MSTP_ERROR("%s: strdup ifname failed\r\n", __func__);
+        goto err;
+    }
+
+    mstp->base.max_info_frames = 1;
+    mstp->base.max_master = MSTP_MAX_MASTER;
+    mstp->base.reply_timeout = 255;
+    mstp->base.usage_timeout = 20;
+    mstp->base.tx_buf_size = MIN_BUFFER_SIZE;
+    mstp->base.rx_buf_size = MIN_BUFFER_SIZE;
+    mstp->rt_priority = TTY_DEFAULT_RT_PRIORITY;
+    mstp->starve_limit = MSTP_DEFAULT_STARVE_LIMIT;
+
+    baudrate = -1;
+    if ((tty_cfg_get_number(cfg, "baudrate", 0, INT32_MAX, &baudrate) <= 0)
+            || (mstp_baudrate2enum(baudrate) == MSTP_B_MAX)) {
+        MSTP_ERROR("%s: invalid baudrate(%d)\r\n", __func__, baudrate);
+        goto err;
+    }
+    mstp->base.baud = mstp_baudrate2enum(baudrate);
+    mstp->bit_ns = 1000000000U / baudrate;
+
+    /* software master node only, slave stations are not supported */
+    if (tty_cfg_get_number(cfg, "this_station", 0, MSTP_MAX_MASTER, &value) <= 0) {
+        MSTP_ERROR("%s: get this_station item failed\r\n", __func__);
+        goto err;
+    }
+    mstp->base.mac = value;
+
+    rv = tty_cfg_get_number(cfg, "max_master", mstp->base.mac, MSTP_MAX_MASTER, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->base.max_master = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "max_info_frames", 1, 255, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->base.max_info_frames = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "reply_timeout", 20, 300, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->base.reply_timeout = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "usage_timeout", 1, 100, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->base.usage_timeout = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "tx_buf_size", MIN_BUFFER_SIZE, MAX_BUFFER_SIZE, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->base.tx_buf_size = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "rx_buf_size", MIN_BUFFER_SIZE, MAX_BUFFER_SIZE, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->base.rx_buf_size = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "rt_priority", 0, 99, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->rt_priority = value;
+    }
+
+    rv = tty_cfg_get_number(cfg, "tx_starve_limit", 0, MSTP_MAX_STARVE_LIMIT, &value);
+    if (rv < 0) {
+        goto err;
+    } else if (rv > 0) {
+        mstp->starve_limit = value;
+    }
+
+    mstp->ring_size = mstp->base.rx_buf_size / TTY_RX_SLOT_SIZE;
+    if (mstp->ring_size < TTY_MIN_RX_SLOTS) {
+        mstp->ring_size = TTY_MIN_RX_SLOTS;
+    }
+    mstp->ring = (tty_rx_slot_t *)malloc(sizeof(tty_rx_slot_t) * mstp->ring_size);
+    if (mstp->ring == NULL) {
+        MSTP_ERROR("%s: malloc rx ring failed\r\n", __func__);
+        goto err;
+    }
+
+    mstp->fd = open(ifname, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (mstp->fd < 0) {
+        MSTP_ERROR("%s: open %s failed cause %s\r\n", __func__, ifname, strerror(errno));
+        goto err;
+    }
+
+    if (tty_set_baudrate(mstp->fd, baudrate) < 0) {
+        MSTP_ERROR("%s: setup %s failed\r\n", __func__, ifname);
+        goto err;
+    }
+
+    mstp->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mstp->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((mstp->wake_fd < 0) || (mstp->notify_fd < 0)) {
+        MSTP_ERROR("%s: create eventfd failed cause %s\r\n", __func__, strerror(errno));
+        goto err;
+    }
+
+    mstp->base.proxy = slave_proxy_port_create(&mstp->base, cfg);
+    if (mstp->base.proxy == NULL) {
+        MSTP_ERROR("%s: create slave proxy port failed\r\n", __func__);
+        goto err;
+    }
+
+    MSTP_VERBOS("%s: %s mac(%d) baudrate(%d) ok\r\n", __func__, ifname, mstp->base.mac,
+        baudrate);
+
+    return &mstp->base;
+
+err:
+    tty_mstp_port_destroy(&mstp->base);
+
+    return NULL;
+}
+
+int tty_mstp_get_test_result(datalink_mstp_t *base, uint8_t *remote)
+{
+    tty_mstp_t *mstp;
+    int rv;
+
+    mstp = (tty_mstp_t *)base;
+
+    pthread_mutex_lock(&mstp->mutex);
+
+    if (mstp->test.remote == MSTP_BROADCAST_ADDRESS || mstp->test.remote == mstp->base.mac) {
+        pthread_mutex_unlock(&mstp->mutex);
+        return -EPERM;
+    }
+
+    if (mstp->test.data != NULL) {
+        pthread_mutex_unlock(&mstp->mutex);
+        return -EBUSY;
+    }
+
+    rv = mstp->test.result;
+    if (remote) {
+        *remote = mstp->test.remote;
+    }
+
+    pthread_mutex_unlock(&mstp->mutex);
+
+    return rv;
+}
+
+int tty_mstp_test_remote(datalink_mstp_t *base, uint8_t remote, uint8_t *data, size_t len,
+        void(*callback)(void*, mstp_test_result_t), void *context)
+{
+    tty_mstp_t *mstp;
+    uint64_t value;
+
+    mstp = (tty_mstp_t *)base;
+
+    pthread_mutex_lock(&mstp->mutex);
+
+    if (mstp->test.data != NULL) {
+        pthread_mutex_unlock(&mstp->mutex);
+        return -EBUSY;
+    }
+
+    if (remote == mstp->base.mac) {
+        MSTP_ERROR("%s: can not test self\r\n", __func__);
+        pthread_mutex_unlock(&mstp->mutex);
+        return -EPERM;
+    }
+
+    mstp->test.data = (uint8_t *)malloc(len);
+    if (mstp->test.data == NULL) {
+        MSTP_ERROR("%s: not enough memory\r\n", __func__);
+        pthread_mutex_unlock(&mstp->mutex);
+        return -ENOMEM;
+    }
+
+    memcpy(mstp->test.data, data, len);
+    mstp->test.len = len;
+    mstp->test.remote = remote;
+    mstp->test.sent = false;
+    mstp->test.result = false;
+    mstp->test.callback = callback;
+    mstp->test.context = context;
+
+    pthread_mutex_unlock(&mstp->mutex);
+
+    value = 1;
+    (void)write(mstp->wake_fd, &value, sizeof(value));
+
+    return OK;
+}
@@ -44,6 +44,14 @@ static slave_proxy_manager_t proxy_manager = {
         .iam_timer = NULL,
 };
 
+/* վɾǰã۳queueдI-Am */
+static void _unqueue_slave(mstp_slave_t *slave)
+{
+    proxy_manager.iam_pending -= (slave->queue_head - slave->queue_tail) & IAM_QUEUE_MASK;
+    slave->queue_tail = slave->queue_head;
+    __list_del_entry(&slave->que_node);
+}
+
 /* return true is there are task on queue */
 static bool send_one_iam(void)
 {
@@ -81,6 +89,8 @@ static bool send_one_iam(void)
     __list_del_entry(&(slave->que_node));
 
     slave->queue_tail = (slave->queue_tail + 1) & IAM_QUEUE_MASK;
+    proxy_manager.iam_pending--;
+    proxy_manager.iam_sent++;
     if (slave->queue_head != slave->queue_tail) {
         list_add(&(slave->que_node), &proxy_manager.que_head);
         has_next = true;
@@ -108,20 +118,86 @@ static bool send_one_iam(void)
     return has_next;
 }
 
+static void _drop_slave(node_scan_t *node)
+{
+    rb_erase(&node->slave->rb_node, &proxy_manager.rb_head);
+    _unqueue_slave(node->slave);
+    free(node->slave);
+    node->slave = NULL;
+}
+
+static void _probe_done(slave_proxy_port_t *port, node_scan_t *node)
+{
+    if (node->status != SCAN_NOT_START) {
+        node->status = SCAN_NOT_START;
+        port->probing--;
+    }
+}
+
+static unsigned _ewma(unsigned avg, unsigned sample)
+{
+    return avg ? (avg * 7 + sample) / 8 : sample;
+}
+
+/* token rotation if the driver counts tokens, else the probe round trip stands in for it */
+static unsigned _port_rotation(slave_proxy_port_t *port)
+{
+    return port->rotation_ms ? port->rotation_ms : port->rtt_ms;
+}
+
+static void _sample_rotation(slave_proxy_port_t *port, unsigned now_ms)
+{
+    tty_mstp_t *tty;
+    uint32_t tokens;
+
+    if (port->mstp->driver != MSTP_DRIVER_TTY) {
+        return;
+    }
+
+    tty = (tty_mstp_t *)port->mstp;
+    tokens = __atomic_load_n(&tty->tokenCount, __ATOMIC_RELAXED);
+    if (tokens == port->token_count) {
+        return;
+    }
+
+    /* counters reset from the mib restart the measurement */
+    if (port->token_ms && tokens > port->token_count) {
+        port->rotation_ms = _ewma(port->rotation_ms,
+            (now_ms - port->token_ms) / (tokens - port->token_count));
+    }
+
+    port->token_count = tokens;
+    port->token_ms = now_ms;
+}
+
+/* a slave answers inside the token hold of the polling master, a few rotations is plenty */
+static uint32_t _probe_timeout(slave_proxy_port_t *port)
+{
+    unsigned timeout;
+
+    timeout = _port_rotation(port) * PROBE_TIMEOUT_ROTATIONS;
+    if (timeout == 0) {
+        return 0;   /* tsm default */
+    }
+
+    if (timeout < MIN_PROBE_TIMEOUT_MS) {
+        timeout = MIN_PROBE_TIMEOUT_MS;
+    }
+
+    return timeout < tsm_get_apdu_timeout() ? timeout : tsm_get_apdu_timeout();
+}
+
 static void _scan_fail(slave_proxy_port_t *port, uint8_t mac)
 {
     node_scan_t *node = &port->nodes[mac];
 
-    node->status = SCAN_NOT_START;
+    _probe_done(port, node);
+    node->state = NODE_UNKNOWN;
 
     if (node->slave) {
         SP_WARN("%s: device(%d) on net(%d) mac(%d)\r\n", __func__, node->device_id,
             port->net, mac);
-
-        rb_erase(&node->slave->rb_node, &proxy_manager.rb_head);
-        __list_del_entry(&node->slave->que_node);
-        free(node->slave);
-        node->slave = NULL;
+        _drop_slave(node);
     }
 
     if (!node->manual && node->next != mac) {
@@ -173,7 +249,8 @@ static int send_rp_scan(uint16_t port_idx, uint8_t mac, BACNET_PROPERTY_ID prope
         return -EPERM;
     }
 
-    rv = tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, 0);
+    node->sent_ms = el_current_millisecond();
+    rv = tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port));
     if (rv < 0) {
         tsm_free_invokeID(invoker);
         _scan_fail(port, mac);
@@ -181,13 +258,14 @@ static int send_rp_scan(uint16_t port_idx, uint8_t mac, BACNET_PROPERTY_ID prope
         return -EPERM;
     }
 
-    port->request_num++;
+    port->probes_sent++;
     return OK;
 }
 
 static void _encode_rpm(bacnet_buf_t *pdu, uint32_t device_id, uint8_t invokeID)
 {
     rpm_req_encode_object(pdu, OBJECT_DEVICE, device_id);
+    rpm_req_encode_property(pdu, PROP_PROTOCOL_SERVICES_SUPPORTED, BACNET_ARRAY_ALL);
     rpm_req_encode_property(pdu, PROP_SEGMENTATION_SUPPORTED, BACNET_ARRAY_ALL);
     rpm_req_encode_property(pdu, PROP_VENDOR_IDENTIFIER, BACNET_ARRAY_ALL);
     rpm_req_encode_property(pdu, PROP_MAX_APDU_LENGTH_ACCEPTED, BACNET_ARRAY_ALL);
@@ -199,6 +277,7 @@ static int send_rpm_scan(uint16_t port_idx, uint8_t mac)
     bacnet_addr_t dst;
     tsm_invoker_t *invoker;
     DECLARE_BACNET_BUF(tx_pdu, MIN_APDU);
+    uint32_t device_id;
     int rv;
 
     (void)bacnet_buf_init(&tx_pdu.buf, MIN_APDU);
@@ -206,6 +285,9 @@ static int send_rpm_scan(uint16_t port_idx, uint8_t mac)
     slave_proxy_port_t *port = proxy_manager.ports[port_idx];
     node_scan_t *node = &port->nodes[mac];
 
+    node->timeout = 0;
+    device_id = node->manual ? node->device_id : BACNET_MAX_INSTANCE;
+
     slave_scan_context_t context = { {port_idx, mac} };
 
     dst.net = port->net;
@@ -220,9 +302,10 @@ static int send_rpm_scan(uint16_t port_idx, uint8_t mac)
         return -EPERM;
     }
 
-    _encode_rpm(&tx_pdu.buf, node->device_id, invoker->invokeID);
+    _encode_rpm(&tx_pdu.buf, device_id, invoker->invokeID);
 
-    rv = tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, 0);
+    node->sent_ms = el_current_millisecond();
+    rv = tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port));
     if (rv < 0) {
         SP_ERROR("%s: tsm send failed(%d)\r\n", __func__, rv);
         _scan_fail(port, mac);
@@ -230,69 +313,164 @@ static int send_rpm_scan(uint16_t port_idx, uint8_t mac)
         return -EPERM;
     }
 
-    port->request_num++;
-    return rv;
+    port->probes_sent++;
+    return OK;
+}
+
+/*
+ * probe with one rpm of everything the binding needs, nodes that refused rpm
+ * before go straight to the rp chain
+ */
+static void _probe_start(uint16_t port_idx, uint8_t mac)
+{
+    slave_proxy_port_t *port = proxy_manager.ports[port_idx];
+    node_scan_t *node = &port->nodes[mac];
+
+    if (node->status == SCAN_NOT_START) {
+        port->probing++;
+    }
+
+    if (node->rpm == PROBE_RPM_NO) {
+        node->status = SCAN_WHOIS_SUPPORT;
+        (void)send_rp_scan(port_idx, mac, PROP_PROTOCOL_SERVICES_SUPPORTED);
+    } else {
+        node->status = SCAN_PROBE;
+        (void)send_rpm_scan(port_idx, mac);
+    }
+}
+
+/* one tick per token rotation, each tick admits what fits in one token hold */
+static unsigned _scan_tick(slave_proxy_port_t *port)
+{
+    unsigned tick;
+
+    tick = _port_rotation(port);
+    if (tick == 0) {
+        return DEFAULT_SCAN_TICK_MS;
+    }
+
+    if (tick < MIN_SCAN_TICK_MS) {
+        return MIN_SCAN_TICK_MS;
+    }
+
+    return tick < IDLE_SCAN_TICK_MS ? tick : IDLE_SCAN_TICK_MS;
 }
 
 static void timer_handler(el_timer_t *timer)
 {
     bool has_next;
-    int iam_sent = 0;
-    unsigned now;
-
-    do {
-        has_next = send_one_iam();
-        iam_sent++;
-    } while (has_next && iam_sent < IAM_EACH_SECOND);
+    int iam_sent;
+    unsigned now, now_ms, period, tick, admit;
 
     now = el_current_second();
+    now_ms = el_current_millisecond();
+
+    if ((unsigned)(now_ms - proxy_manager.iam_ms) >= 1000) {
+        proxy_manager.iam_ms = now_ms;
+        iam_sent = 0;
+        do {
+            has_next = send_one_iam();
+            iam_sent++;
+        } while (has_next && iam_sent < IAM_EACH_SECOND);
+    }
+
+    period = IDLE_SCAN_TICK_MS;
 
     pthread_mutex_lock(&proxy_manager.lock);
 
     for (int i = 0; i < proxy_manager.port_number; ++i) {
         slave_proxy_port_t *port = proxy_manager.ports[i];
-        if (port->request_num && --port->request_num)
-            continue;
-
         if (!port->proxy_enable) continue;
 
+        _sample_rotation(port, now_ms);
+
         usb_mstp_t *mstp = (usb_mstp_t*)port->mstp;
-        uint8_t mac;
-
-try_next_mac:
-        mac = port->next_scan_mac;
-        if (mac == 255) {
-            if ((uint32_t)(now - port->start_timestamp) < port->scan_interval)
-                continue; /* not our time */
-            if (mstp->auto_busy)
-                continue; /* wait not busy */
-
-            port->start_timestamp = now;
-            mac = 0;
-            port->next_scan_mac = 1;
-        } else
-            port->next_scan_mac++;
-
-        if (mac == mstp->base.mac)
-            goto try_next_mac;
-
-        node_scan_t *node = &port->nodes[mac];
-        if (!(port->auto_discovery && node->auto_scan) && !node->manual)
-            goto try_next_mac;
-
-        if (node->status != SCAN_NOT_START) {
-            /* scanУtimeoutɺ */
-            node->timeout = 1;
-            continue;
+        admit = port->mstp->max_info_frames;
+
+        while (admit && (port->probing < port->max_probes)) {
+            uint8_t mac = port->next_scan_mac;
+            if (mac == 255) {
+                if ((uint32_t)(now - port->start_timestamp) < port->scan_interval)
+                    break; /* not our time */
+                if ((port->mstp->driver == MSTP_DRIVER_USB) && mstp->auto_busy)
+                    break; /* wait not busy */
+
+                port->start_timestamp = now;
+                mac = 0;
+                port->next_scan_mac = 1;
+            } else
+                port->next_scan_mac++;
+
+            if (mac == port->mstp->mac)
+                continue;
+
+            node_scan_t *node = &port->nodes[mac];
+            if (!(port->auto_discovery && node->auto_scan) && !node->manual)
+                continue;
+
+            if (node->status != SCAN_NOT_START) {
+                /* still probing from the last cycle, restart once it completes */
+                node->timeout = 1;
+                continue;
+            }
+
+            _probe_start(i, mac);
+            admit--;
         }
 
-        node->status = SCAN_WHOIS_SUPPORT;
-        send_rp_scan(i, mac, PROP_PROTOCOL_SERVICES_SUPPORTED);
+        if (port->probing || (port->next_scan_mac != 255)) {
+            tick = _scan_tick(port);
+            if (tick < period) period = tick;
+        }
     }
 
     pthread_mutex_unlock(&proxy_manager.lock);
 
-    el_timer_mod(&el_default_loop, timer, 1000);
+    el_timer_mod(&el_default_loop, timer, period);
+}
+
+static bool decode_property(BACNET_READ_PROPERTY_DATA *rp_data, struct slave_data_s *slave_data)
+{
+    switch(rp_data->property_id) {
+    case PROP_PROTOCOL_SERVICES_SUPPORTED:
+        if (decode_application_bitstring(rp_data->application_data, &slave_data->service_support)
+                != rp_data->application_data_len) {
+            SP_WARN("%s: decode service support failed\r\n", __func__);
+            return false;
+        }
+        break;
+    case PROP_SEGMENTATION_SUPPORTED:
+        if (decode_application_enumerated(rp_data->application_data, &slave_data->seg_support)
+                != rp_data->application_data_len 
+                || slave_data->seg_support >= MAX_BACNET_SEGMENTATION) {
+            SP_WARN("%s: decode segmentation support failed\r\n", __func__);
+            return false;
+        }
+        break;
+    case PROP_VENDOR_IDENTIFIER:
+        if (decode_application_unsigned(rp_data->application_data, &slave_data->vendor_id)
+                != rp_data->application_data_len || (slave_data->vendor_id > 0x0ffff)) {
+            SP_WARN("%s: decode vendor id failed\r\n", __func__);
+            return false;
+        }
+        break;
+    case PROP_MAX_APDU_LENGTH_ACCEPTED:
+        if (decode_application_unsigned(rp_data->application_data, &slave_data->max_apdu)
+                != rp_data->application_data_len) {
+            SP_WARN("%s: decode max apdu length accepted failed\r\n", __func__);
+            return false;
+        }
+
+        if (slave_data->max_apdu > 0x0ffff) {
+            slave_data->max_apdu = 0x0ffff;
+        }
+        break;
+    default:
+        SP_WARN("%s: invalid property(%d)\r\n", __func__, rp_data->property_id);
+        return false;
+    }
+
+    return true;
 }
 
 static bool decode_data(uint8_t service_choice, uint8_t *service_data,
@@ -320,50 +498,18 @@ static bool decode_data(uint8_t service_choice, uint8_t *service_data,
         slave_data->property_id = rp_data.property_id;
         slave_data->device_id = rp_data.object_instance;
 
-        switch(slave_data->property_id) {
-        case PROP_PROTOCOL_SERVICES_SUPPORTED:
-            if (decode_application_bitstring(rp_data.application_data, &slave_data->service_support)
-                    != rp_data.application_data_len) {
-                SP_WARN("%s: decode service support failed\r\n", __func__);
-                return false;
-            }
-            break;
-        case PROP_SEGMENTATION_SUPPORTED:
-            if (decode_application_enumerated(rp_data.application_data, &slave_data->seg_support)
-                    != rp_data.application_data_len 
-                    || slave_data->seg_support >= MAX_BACNET_SEGMENTATION) {
-                SP_WARN("%s: decode segmentation support failed\r\n", __func__);
-                return false;
-            }
-            break;
-        case PROP_VENDOR_IDENTIFIER:
-            if (decode_application_unsigned(rp_data.application_data, &slave_data->vendor_id)
-                    != rp_data.application_data_len || (slave_data->vendor_id > 0x0ffff)) {
-                SP_WARN("%s: decode vendor id failed\r\n", __func__);
-                return false;
-            }
-            break;
-        case PROP_MAX_APDU_LENGTH_ACCEPTED:
-            if (decode_application_unsigned(rp_data.application_data, &slave_data->max_apdu)
-                    != rp_data.application_data_len) {
-                SP_WARN("%s: decode max apdu length accepted failed\r\n", __func__);
-                return false;
-            }
-
-            if (slave_data->max_apdu > 0x0ffff) {
-                slave_data->max_apdu = 0x0ffff;
-            }
-            break;
-        default:
-            SP_WARN("%s: rp ack invalid property(%d)\r\n", __func__, slave_data->property_id);
+        if (!decode_property(&rp_data, slave_data)) {
             return false;
         }
 
         slave_data->is_rpm = false;
     } else {
         BACNET_RPM_ACK_DECODER decoder;
+        unsigned found;
+        int rv;
+
         rpm_ack_decode_init(&decoder, service_data, service_data_len);
-        int rv = rpm_ack_decode_object(&decoder, &rp_data);
+        rv = rpm_ack_decode_object(&decoder, &rp_data);
         if (rv <= 0) {
             SP_WARN("%s: rpm ack decode object failed(%d)\r\n", __func__, rv);
             return false;
@@ -375,94 +521,93 @@ static bool decode_data(uint8_t service_choice, uint8_t *service_data,
         }
         slave_data->device_id = rp_data.object_instance;
 
-        /* decode segmentation support */
-        rv = rpm_ack_decode_property(&decoder, &rp_data);
-        if (rv <= 0) {
-            SP_WARN("%s: rpm ack decode segmentation support property failed(%d)\r\n", __func__, rv);
-            return false;
-        }
-
-        if (rp_data.property_id != PROP_SEGMENTATION_SUPPORTED || rp_data.array_index != BACNET_ARRAY_ALL) {
-            SP_WARN("%s: rpm ack invalid property, should be segmentation support\r\n", __func__);
-            return false;
-        }
+        /* services, segmentation, vendor id and max apdu, in any order */
+        found = 0;
+        while ((rv = rpm_ack_decode_property(&decoder, &rp_data)) > 0) {
+            if (rp_data.array_index != BACNET_ARRAY_ALL) {
+                SP_WARN("%s: rpm ack invalid array_indx(%d)\r\n", __func__, rp_data.array_index);
+                return false;
+            }
 
-        if (rp_data.application_data == NULL) {
-            SP_WARN("%s: rpm segmentation support report error\r\n", __func__);
-            return false;
-        }
+            if (rp_data.application_data == NULL) {
+                SP_WARN("%s: rpm property(%d) report error\r\n", __func__, rp_data.property_id);
+                return false;
+            }
 
-        if (decode_application_enumerated(rp_data.application_data, &slave_data->seg_support)
-                != rp_data.application_data_len
-                || slave_data->seg_support >= MAX_BACNET_SEGMENTATION) {
-            SP_WARN("%s: decode segmentation support failed\r\n", __func__);
-            return false;
+            if (!decode_property(&rp_data, slave_data)) {
+                return false;
+            }
+            found++;
         }
 
-        /* decode vendor id */
-        rv = rpm_ack_decode_property(&decoder, &rp_data);
-        if (rv <= 0) {
-            SP_WARN("%s: rpm ack decode vendor id property failed(%d)\r\n", __func__, rv);
+        if (rv < 0) {
+            SP_WARN("%s: rpm ack decode property failed(%d)\r\n", __func__, rv);
             return false;
         }
 
-        if (rp_data.property_id != PROP_VENDOR_IDENTIFIER || rp_data.array_index != BACNET_ARRAY_ALL) {
-            SP_WARN("%s: rpm ack invalid property, should be vendor id\r\n", __func__);
+        if (found != 4) {
+            SP_WARN("%s: rpm ack have %d properties, should be 4\r\n", __func__, found);
             return false;
         }
 
-        if (rp_data.application_data == NULL) {
-            SP_WARN("%s: rpm decode vendor id report error\r\n", __func__);
+        if (rpm_ack_decode_object(&decoder, &rp_data) != 0) {
+            SP_WARN("%s: rpm ack have other object?\r\n", __func__);
             return false;
         }
 
-        if (decode_application_unsigned(rp_data.application_data, &slave_data->vendor_id)
-                != rp_data.application_data_len) {
-            SP_WARN("%s: rpm ack decode vendor id failed\r\n", __func__);
-            return false;
-        }
-        if (slave_data->vendor_id > 0xffff) {
-            SP_WARN("%s: rpm ack invalid vendor id(%d)\r\n", __func__, slave_data->vendor_id);
-            return false;
-        }
+        slave_data->property_id = PROP_ALL;
+        slave_data->is_rpm = true;
+    }
 
-        /* decode max apdu */
-        rv = rpm_ack_decode_property(&decoder, &rp_data);
-        if (rv <= 0) {
-            SP_WARN("%s: rpm ack decode property failed(%d)\r\n", __func__, rv);
-            return false;
-        }
+    return true;
+}
 
-        if (rp_data.property_id != PROP_MAX_APDU_LENGTH_ACCEPTED || rp_data.array_index != BACNET_ARRAY_ALL) {
-            SP_WARN("%s: rpm ack invalid property, should be max apdu\r\n", __func__);
-            return false;
-        }
+/* return false if the node proves not to be a slave we should bind */
+static bool _on_services_supported(slave_proxy_port_t *port, uint8_t mac,
+        struct slave_data_s *slave_data)
+{
+    node_scan_t *node = &port->nodes[mac];
 
-        if (rp_data.application_data == NULL) {
-            SP_WARN("%s: rpm max apdu report error\r\n", __func__);
-            return false;
-        }
+    if (SERVICE_SUPPORTED_WHO_IS < bitstring_size(&slave_data->service_support)
+            && bitstring_get_bit(&slave_data->service_support, SERVICE_SUPPORTED_WHO_IS)) {
+        /* not a slave */
+        node->state = NODE_MASTER;
+        if (node->slave) {
+            SP_WARN("%s: binding device(%d) on net(%d) mac(%d) support whois\r\n", __func__, node->device_id,
+                port->net, mac);
+            _drop_slave(node);
+        }
+        if (!node->manual && node->next != mac) {
+            /* be slave before and not manual, remove from link */
+            uint8_t next = port->nodes[mac].next;
+            uint8_t prev = port->nodes[mac].prev;
 
-        if (decode_application_unsigned(rp_data.application_data, &slave_data->max_apdu)
-                != rp_data.application_data_len) {
-            SP_WARN("%s: rpm ack decode max apdu failed\r\n", __func__);
-            return false;
+            port->nodes[prev].next = next;
+            port->nodes[next].prev = prev;
+            port->nodes[mac].next = mac;
+            port->nodes[mac].prev = mac;
         }
-        if (slave_data->max_apdu > 0xffff)
-            slave_data->max_apdu = 0xffff;
+        return false;
+    }
 
-        rv = rpm_ack_decode_property(&decoder, &rp_data);
-        if (rv != 0) {
-            SP_WARN("%s: rpm ack have other property(%d)?\r\n", __func__, rv);
-            return false;
-        }
+    if (node->slave && slave_data->device_id != node->device_id) {
+        SP_WARN("%s: binding device(%d) on net(%d) mac(%d) report different device_id\r\n", __func__,
+                node->device_id, port->net, mac);
+        _drop_slave(node);
+    }
 
-        if (rpm_ack_decode_object(&decoder, &rp_data) != 0) {
-            SP_WARN("%s: rpm ack have other object?\r\n", __func__);
-            return false;
-        }
+    if (node->manual && slave_data->device_id != node->device_id) {
+        SP_ERROR("%s: manual binding device(%d) on net(%d) mac(%d) but report device(%d)\r\n", __func__,
+                node->device_id, port->net, mac, slave_data->device_id);
+        return false;
+    }
 
-        slave_data->is_rpm = true;
+    node->device_id = slave_data->device_id;
+    if (node->next == mac) { /* link tail as active binding */
+        node->next = 255;
+        node->prev = port->nodes[255].prev;
+        port->nodes[node->prev].next = mac;
+        port->nodes[255].prev = mac;
     }
 
     return true;
@@ -472,73 +617,55 @@ static void on_data(uint16_t port_idx, uint8_t mac, struct slave_data_s *slave_d
 {
     slave_proxy_port_t *port;
     node_scan_t *node;
-    bool whois_support, send_rp;
+    bool send_rp;
 
     port = proxy_manager.ports[port_idx];
     node = &port->nodes[mac];
 
     send_rp = false;
-    node = &port->nodes[mac];
     switch(node->status) {
-    case SCAN_WHOIS_SUPPORT:              /* send rp of service support */
-        if (slave_data->property_id != PROP_PROTOCOL_SERVICES_SUPPORTED) {
+    case SCAN_PROBE:                    /* send rpm of all properties */
+        if (!slave_data->is_rpm) {
             SP_ERROR("%s: net(%d) mac(%d) status(%d) response(%d)\r\n", __func__,
                 port->net, mac, node->status, slave_data->property_id);
             _scan_fail(port, mac);
             break;
         }
 
-        if (SERVICE_SUPPORTED_WHO_IS < bitstring_size(&slave_data->service_support)
-                && bitstring_get_bit(&slave_data->service_support, SERVICE_SUPPORTED_WHO_IS)) {
-            whois_support = true;
-        } else {
-            whois_support = false;
+        node->rpm = PROBE_RPM_OK;
+        if (!_on_services_supported(port, mac, slave_data)) {
+            goto success;
         }
 
-        if (whois_support) { /* not a slave */
-            if (node->slave) {
-                SP_WARN("%s: binding device(%d) on net(%d) mac(%d) support whois\r\n", __func__, node->device_id,
-                    port->net, mac);
-
-                rb_erase(&node->slave->rb_node, &proxy_manager.rb_head);
-                __list_del_entry(&node->slave->que_node);
-                free(node->slave);
-                node->slave = NULL;
-            }
-            if (!node->manual && node->next != mac) {
-                /* be slave before and not manual, remove from link */
-                uint8_t next = port->nodes[mac].next;
-                uint8_t prev = port->nodes[mac].prev;
-
-                port->nodes[prev].next = next;
-                port->nodes[next].prev = prev;
-                port->nodes[mac].next = mac;
-                port->nodes[mac].prev = mac;
-            }
-            goto success;
+        if (node->slave && (slave_data->seg_support != node->seg_support
+                || slave_data->vendor_id != node->vendor_id)) {
+            SP_WARN("%s: binding device(%d) on net(%d) mac(%d) report different segment support or vendor id\r\n",
+                    __func__, node->device_id, port->net, mac);
+            _drop_slave(node);
+        } else if (node->slave) {
+            port->probes_verified++;
         }
 
-        if (node->slave && slave_data->device_id != node->device_id) {
-            SP_WARN("%s: binding device(%d) on net(%d) mac(%d) report different device_id\r\n", __func__,
-                    node->device_id, port->net, mac);
-            rb_erase(&node->slave->rb_node, &proxy_manager.rb_head);
-            __list_del_entry(&node->slave->que_node);
-            free(node->slave);
-            node->slave = NULL;
+        node->seg_support = slave_data->seg_support;
+        node->vendor_id = slave_data->vendor_id;
+        goto new_slave_arrived;
+
+    case SCAN_WHOIS_SUPPORT:              /* send rp of service support */
+        if (slave_data->property_id != PROP_PROTOCOL_SERVICES_SUPPORTED) {
+            SP_ERROR("%s: net(%d) mac(%d) status(%d) response(%d)\r\n", __func__,
+                port->net, mac, node->status, slave_data->property_id);
+            _scan_fail(port, mac);
+            break;
         }
 
-        if (node->manual && slave_data->device_id != node->device_id) {
-            SP_ERROR("%s: manual binding device(%d) on net(%d) mac(%d) but report device(%d)\r\n", __func__,
-                    node->device_id, port->net, mac, slave_data->device_id);
+        if (!_on_services_supported(port, mac, slave_data)) {
             goto success;
         }
 
-        node->device_id = slave_data->device_id;
-        if (node->next == mac) { /* link tail as active binding */
-            node->next = 255;
-            node->prev = port->nodes[255].prev;
-            port->nodes[node->prev].next = mac;
-            port->nodes[255].prev = mac;
+        if (node->slave) {
+            /* binding still answers with the same device, skip the rest of the chain */
+            port->probes_verified++;
+            goto success;
         }
 
         node->status = SCAN_SEG_SUPPORT;
@@ -547,7 +674,7 @@ static void on_data(uint16_t port_idx, uint8_t mac, struct slave_data_s *slave_d
         break;
     
     case SCAN_SEG_SUPPORT:              /* send rp of segmentation suppot */
-        if (slave_data->property_id != PROP_SEGMENTATION_SUPPORTED && !slave_data->is_rpm) {
+        if (slave_data->property_id != PROP_SEGMENTATION_SUPPORTED) {
             SP_ERROR("%s: net(%d) mac(%d) status(%d) response(%d)\r\n", __func__,
                 port->net, mac, node->status, slave_data->property_id);
             _scan_fail(port, mac);
@@ -561,23 +688,7 @@ static void on_data(uint16_t port_idx, uint8_t mac, struct slave_data_s *slave_d
             break;
         }
 
-        if (node->slave && slave_data->seg_support != node->seg_support) {
-            /* segmentation support changed */
-            SP_WARN("%s: binding device(%d) on net(%d) mac(%d) report different segment support\r\n", __func__,
-                    node->device_id, port->net, mac);
-            rb_erase(&node->slave->rb_node, &proxy_manager.rb_head);
-            __list_del_entry(&node->slave->que_node);
-            free(node->slave);
-            node->slave = NULL;
-        }
-
         node->seg_support = slave_data->seg_support;
-
-        if (slave_data->is_rpm) {
-            node->vendor_id = slave_data->vendor_id;
-            goto new_slave_arrived;
-        }
-
         node->status = SCAN_VENDOR_ID;
         slave_data->property_id = PROP_VENDOR_IDENTIFIER;
         send_rp = true;
@@ -598,16 +709,6 @@ static void on_data(uint16_t port_idx, uint8_t mac, struct slave_data_s *slave_d
             break;
         }
 
-        if (node->slave && slave_data->vendor_id != node->vendor_id) {
-            /* vendor id changed */
-            SP_WARN("%s: binding device(%d) on net(%d) mac(%d) report vendor id\r\n", __func__,
-                    node->device_id, port->net, mac);
-            rb_erase(&node->slave->rb_node, &proxy_manager.rb_head);
-            __list_del_entry(&node->slave->que_node);
-            free(node->slave);
-            node->slave = NULL;
-        }
-
         node->vendor_id = slave_data->vendor_id;
         node->status = SCAN_MAX_APDU;
         slave_data->property_id = PROP_MAX_APDU_LENGTH_ACCEPTED;
@@ -629,14 +730,15 @@ static void on_data(uint16_t port_idx, uint8_t mac, struct slave_data_s *slave_d
             break;
         }
 
+new_slave_arrived:
         if (node->slave && slave_data->max_apdu != node->max_apdu) {
             /* max apdu changed */
             SP_WARN("%s: binding device(%d) on net(%d) mac(%d) report different max apdu\r\n", __func__,
                     node->device_id, port->net, mac);
         }
 
-new_slave_arrived:
         node->max_apdu = slave_data->max_apdu;
+        node->state = NODE_SLAVE;
         if (!node->slave) {
             struct rb_node **new = &(proxy_manager.rb_head.rb_node), *parent = NULL;
 
@@ -679,7 +781,7 @@ new_slave_arrived:
         }
 
 success:
-        node->status = SCAN_NOT_START;
+        _probe_done(port, node);
         break;
     case SCAN_NOT_START:
         SP_ERROR("%s: SCAN_NOT_START should go here\r\n", __func__);
@@ -687,24 +789,16 @@ success:
         break;
     }
 
-    if (!send_rp) {
-        return;
-    }
-
-    if (slave_data->property_id != PROP_SEGMENTATION_SUPPORTED
-            || bitstring_size(&slave_data->service_support) <= SERVICE_SUPPORTED_READ_PROP_MULTIPLE
-            || !bitstring_get_bit(&slave_data->service_support, SERVICE_SUPPORTED_READ_PROP_MULTIPLE)) {
-        /* send rp */
+    if (send_rp) {
         send_rp_scan(port_idx, mac, slave_data->property_id);
-    } else {
-        send_rpm_scan(port_idx, mac);
     }
 }
 
 static void _scan_timeout(tsm_invoker_t *invoker)
 {
     DECLARE_BACNET_BUF(tx_pdu, MIN_APDU);
-    uint32_t device_id;
+    uint32_t device_id, retries;
+    bool first;
 
     slave_scan_context_t context;
     context._u = (unsigned)invoker->data;
@@ -714,38 +808,42 @@ static void _scan_timeout(tsm_invoker_t *invoker)
 
     device_id = node->manual ? node->device_id : BACNET_MAX_INSTANCE;
 
+    /* nodes absent in the last cycle get a single try */
+    first = (node->status == SCAN_PROBE) || (node->status == SCAN_WHOIS_SUPPORT);
+    retries = (first && (node->state == NODE_ABSENT)) ? 0 : tsm_get_apdu_retries();
+
     /*  */
-    if (invoker->sent_count <= tsm_get_apdu_retries()) {
+    if (invoker->sent_count <= retries) {
         (void)bacnet_buf_init(&tx_pdu.buf, MIN_APDU);
 
         switch (node->status) {
+        case SCAN_PROBE:
+            _encode_rpm(&tx_pdu.buf, device_id, invoker->invokeID);
+            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port)) >= 0)
+                goto re_send_ok;
+            break;
         case SCAN_WHOIS_SUPPORT:
             rp_encode_apdu(&tx_pdu.buf, invoker->invokeID, OBJECT_DEVICE, device_id,
                     PROP_PROTOCOL_SERVICES_SUPPORTED, BACNET_ARRAY_ALL);
-            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, 0) >= 0)
+            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port)) >= 0)
                 goto re_send_ok;
             break;
         case SCAN_SEG_SUPPORT:
-            if (invoker->choice == SERVICE_CONFIRMED_READ_PROPERTY) {
-                rp_encode_apdu(&tx_pdu.buf, invoker->invokeID, OBJECT_DEVICE, device_id,
-                        PROP_SEGMENTATION_SUPPORTED, BACNET_ARRAY_ALL);
-            } else {
-                _encode_rpm(&tx_pdu.buf, node->device_id, invoker->invokeID);
-            }
-
-            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, 0) >= 0)
+            rp_encode_apdu(&tx_pdu.buf, invoker->invokeID, OBJECT_DEVICE, device_id,
+                    PROP_SEGMENTATION_SUPPORTED, BACNET_ARRAY_ALL);
+            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port)) >= 0)
                 goto re_send_ok;
             break;
         case SCAN_VENDOR_ID:
             rp_encode_apdu(&tx_pdu.buf, invoker->invokeID, OBJECT_DEVICE, device_id,
                     PROP_VENDOR_IDENTIFIER, BACNET_ARRAY_ALL);
-            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, 0) >= 0)
+            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port)) >= 0)
                 goto re_send_ok;
             break;
         case SCAN_MAX_APDU:
             rp_encode_apdu(&tx_pdu.buf, invoker->invokeID, OBJECT_DEVICE, device_id,
                     PROP_MAX_APDU_LENGTH_ACCEPTED, BACNET_ARRAY_ALL);
-            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, 0) >= 0)
+            if (tsm_send_apdu(invoker, &tx_pdu.buf, PRIORITY_NORMAL, _probe_timeout(port)) >= 0)
                 goto re_send_ok;
             break;
         default:
@@ -756,16 +854,18 @@ static void _scan_timeout(tsm_invoker_t *invoker)
 
     tsm_free_invokeID(invoker);
     _scan_fail(port, context.mac);
+    if (first) {
+        node->state = NODE_ABSENT;
+    }
 
     if (node->timeout) {
         node->timeout = 0;
-        node->status = SCAN_WHOIS_SUPPORT;
-        send_rp_scan(context.port_idx, context.mac, PROP_PROTOCOL_SERVICES_SUPPORTED);
+        _probe_start(context.port_idx, context.mac);
     }
     return;
 
 re_send_ok:
-    port->request_num++;
+    port->probes_sent++;
 }
 
 static void rp_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu, BACNET_PDU_TYPE apdu_type)
@@ -794,7 +894,7 @@ static void rp_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu, BACNET_PDU_TY
 
     if (!port->proxy_enable) {
         node->cancel = 0;
-        node->status = SCAN_NOT_START;
+        _probe_done(port, node);
         tsm_free_invokeID(invoker);
         pthread_mutex_unlock(&proxy_manager.lock);
         return;
@@ -802,14 +902,13 @@ static void rp_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu, BACNET_PDU_TY
 
      if (node->cancel) {
         node->cancel = 0;
-        node->status = SCAN_NOT_START;
+        _probe_done(port, node);
         tsm_free_invokeID(invoker);
 
         if (node->timeout
                 && (node->manual || (port->auto_discovery && node->auto_scan))) {
             node->timeout = 0;
-            node->status = SCAN_WHOIS_SUPPORT;
-            send_rp_scan(context.port_idx, context.mac, PROP_PROTOCOL_SERVICES_SUPPORTED);
+            _probe_start(context.port_idx, context.mac);
         }
 
         pthread_mutex_unlock(&proxy_manager.lock);
@@ -821,12 +920,28 @@ static void rp_handler(tsm_invoker_t *invoker, bacnet_buf_t *apdu, BACNET_PDU_TY
         pthread_mutex_unlock(&proxy_manager.lock);
         return;
     }
+
+    if (invoker->sent_count == 1) {
+        port->rtt_ms = _ewma(port->rtt_ms, el_current_millisecond() - node->sent_ms);
+    }
     
     tsm_free_invokeID(invoker);
 
     switch (apdu_type) {
     case PDU_TYPE_ERROR:
         bacerror_handler(apdu, &invoker->addr);
+        /* fall through */
+    case PDU_TYPE_REJECT:
+    case PDU_TYPE_ABORT:
+        if (node->status == SCAN_PROBE) {
+            SP_VERBOS("%s: net(%d) mac(%d) refused rpm, fall back to rp\r\n", __func__,
+                port->net, context.mac);
+            node->rpm = PROBE_RPM_NO;
+            port->rpm_fallbacks++;
+            node->status = SCAN_WHOIS_SUPPORT;
+            (void)send_rp_scan(context.port_idx, context.mac, PROP_PROTOCOL_SERVICES_SUPPORTED);
+            goto out;
+        }
         goto fail;
     
     case PDU_TYPE_COMPLEX_ACK:
@@ -871,10 +986,9 @@ fail:
     _scan_fail(port, context.mac);
 
 out:
-    if (node->timeout) {
+    if (node->timeout && (node->status == SCAN_NOT_START)) {
         node->timeout = 0;
-        node->status = SCAN_NOT_START;
-        send_rp_scan(context.port_idx, context.mac, PROP_PROTOCOL_SERVICES_SUPPORTED);
+        _probe_start(context.port_idx, context.mac);
     }
 
     pthread_mutex_unlock(&proxy_manager.lock);
@@ -907,6 +1021,7 @@ slave_proxy_port_t *slave_proxy_port_create(datalink_mstp_t *mstp, cJSON *cfg)
 
     port->mstp = mstp;
     port->scan_interval = DEFAULT_SCAN_INTERVAL;
+    port->max_probes = DEFAULT_MAX_PROBES;
 
     for (i = 0; i < sizeof(port->nodes)/sizeof(port->nodes[0]); ++i) {
         _init_node(&port->nodes[i], i);
@@ -1037,6 +1152,20 @@ slave_proxy_port_t *slave_proxy_port_create(datalink_mstp_t *mstp, cJSON *cfg)
             port->scan_interval = tmp->valueint;
         }
     }
+
+    tmp = cJSON_GetObjectItem(pcfg, "max_probes");
+    if (tmp) {
+        if (tmp->type != cJSON_Number) {
+            SP_ERROR("%s: max_probes should be integer\r\n", __func__);
+            goto out0;
+        }
+
+        if ((tmp->valueint < 1) || (tmp->valueint > MAX_PROBES)) {
+            SP_ERROR("%s: max_probes(%d) should be 1~%d\r\n", __func__, tmp->valueint, MAX_PROBES);
+            goto out0;
+        }
+        port->max_probes = tmp->valueint;
+    }
     
     cJSON_DeleteItemFromObject(cfg, "proxy");
     return port;
@@ -1062,7 +1191,7 @@ static void _proxy_port_disable(slave_proxy_port_t *port)
         mstp_slave_t *slave = port->nodes[mac].slave;
         if (slave) {
             rb_erase(&slave->rb_node, &proxy_manager.rb_head);
-            __list_del_entry(&slave->que_node);
+            _unqueue_slave(slave);
             free(slave);
             port->nodes[mac].slave = NULL;
         }
@@ -1120,18 +1249,13 @@ int slave_proxy_startup(void)
         mstp->proxy->start_timestamp = el_current_second() - mstp->proxy->scan_interval;
     }
 
-    el_sync(&el_default_loop);
-
     proxy_manager.iam_timer = el_timer_create(&el_default_loop, 1000);
     if (proxy_manager.iam_timer == NULL) {
-        el_unsync(&el_default_loop);
         SP_ERROR("%s: create background timer fail\r\n", __func__);
         goto out1;
     }
     proxy_manager.iam_timer->handler = timer_handler;
 
-    el_unsync(&el_default_loop);
-
     pthread_mutex_unlock(&proxy_manager.lock);
     return OK;
 
@@ -1173,6 +1297,7 @@ void slave_proxy_stop(void)
 
     proxy_manager.rb_head = RB_ROOT;
     INIT_LIST_HEAD(&proxy_manager.que_head);
+    proxy_manager.iam_pending = 0;
 
     pthread_mutex_unlock(&proxy_manager.lock);
 }
@@ -1403,7 +1528,7 @@ int slave_binding_set(uint8_t *pdu, uint32_t pdu_len)
             mstp_slave_t *slave = port->nodes[mac].slave;
             if (slave != NULL) {
                 rb_erase(&slave->rb_node, &proxy_manager.rb_head);
-                __list_del_entry(&slave->que_node);
+                _unqueue_slave(slave);
                 free(slave);
                 port->nodes[mac].slave = NULL;
             }
@@ -1430,7 +1555,7 @@ int slave_binding_set(uint8_t *pdu, uint32_t pdu_len)
             mstp_slave_t *slave = port->nodes[mac].slave;
             if (slave != NULL) {
                 rb_erase(&slave->rb_node, &proxy_manager.rb_head);
-                __list_del_entry(&slave->que_node);
+                _unqueue_slave(slave);
                 free(slave);
                 port->nodes[mac].slave = NULL;
             }
@@ -1526,7 +1651,7 @@ int manual_binding_set(uint8_t *pdu, uint32_t pdu_len)
             mstp_slave_t *slave = port->nodes[mac].slave;
             if (slave != NULL) {
                 rb_erase(&slave->rb_node, &proxy_manager.rb_head);
-                __list_del_entry(&slave->que_node);
+                _unqueue_slave(slave);
                 free(slave);
                 port->nodes[mac].slave = NULL;
             }
@@ -1570,8 +1695,28 @@ static mstp_slave_t* _find_device_id_inside(uint32_t lowlimit, uint32_t highlimi
 
 static void _queue_slave(mstp_slave_t *slave, uint16_t net)
 {
-    if (slave->queue_tail == ((slave->queue_head + 1) & IAM_QUEUE_MASK))
+    uint8_t i;
+
+    /* ͬһI-Amδϲwhois */
+    for (i = slave->queue_tail; i != slave->queue_head; i = (i + 1) & IAM_QUEUE_MASK) {
+        if (slave->queue[i] == net) {
+            proxy_manager.iam_collapsed++;
+            return;
+        }
+    }
+
+    if (proxy_manager.iam_pending >= IAM_MAX_PENDING) {
+        proxy_manager.iam_dropped++;
+        return;
+    }
+
+    if (slave->queue_tail == ((slave->queue_head + 1) & IAM_QUEUE_MASK)) {
         slave->queue_tail = (slave->queue_tail + 1) & IAM_QUEUE_MASK;
+        proxy_manager.iam_dropped++;
+    } else {
+        proxy_manager.iam_pending++;
+    }
+    proxy_manager.iam_queued++;
 
     slave->queue[slave->queue_head] = net;
     slave->queue_head = (slave->queue_head + 1) & IAM_QUEUE_MASK;
@@ -1644,6 +1789,42 @@ void remote_proxied_whois(uint16_t src_net, uint16_t in_net,
     return;
 }
 
+cJSON *slave_proxy_get_iam_status(void)
+{
+    cJSON *result;
+
+    result = cJSON_CreateObject();
+    if (result == NULL) {
+        SP_ERROR("%s: create result object failed\r\n", __func__);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&proxy_manager.lock);
+
+    cJSON_AddNumberToObject(result, "pending", proxy_manager.iam_pending);
+    cJSON_AddNumberToObject(result, "max_pending", IAM_MAX_PENDING);
+    cJSON_AddNumberToObject(result, "queued", proxy_manager.iam_queued);
+    cJSON_AddNumberToObject(result, "collapsed", proxy_manager.iam_collapsed);
+    cJSON_AddNumberToObject(result, "dropped", proxy_manager.iam_dropped);
+    cJSON_AddNumberToObject(result, "sent", proxy_manager.iam_sent);
+
+    pthread_mutex_unlock(&proxy_manager.lock);
+
+    return result;
+}
+
+void slave_proxy_reset_iam_status(void)
+{
+    pthread_mutex_lock(&proxy_manager.lock);
+
+    proxy_manager.iam_queued = 0;
+    proxy_manager.iam_collapsed = 0;
+    proxy_manager.iam_dropped = 0;
+    proxy_manager.iam_sent = 0;
+
+    pthread_mutex_unlock(&proxy_manager.lock);
+}
+
 cJSON* slave_proxy_get_mib (slave_proxy_port_t *port)
 {
     if (port == NULL) {
@@ -1659,6 +1840,37 @@ cJSON* slave_proxy_get_mib (slave_proxy_port_t *port)
         goto out;
     }
 
+    cJSON *discovery = cJSON_CreateObject();
+    unsigned absent = 0, master = 0, slave = 0;
+
+    for (unsigned mac = 0; mac < 255; ++mac) {
+        switch (port->nodes[mac].state) {
+        case NODE_ABSENT:
+            absent++;
+            break;
+        case NODE_MASTER:
+            master++;
+            break;
+        case NODE_SLAVE:
+            slave++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    cJSON_AddNumberToObject(discovery, "max_probes", port->max_probes);
+    cJSON_AddNumberToObject(discovery, "probing", port->probing);
+    cJSON_AddNumberToObject(discovery, "rtt_ms", port->rtt_ms);
+    cJSON_AddNumberToObject(discovery, "rotation_ms", port->rotation_ms);
+    cJSON_AddNumberToObject(discovery, "probes_sent", port->probes_sent);
+    cJSON_AddNumberToObject(discovery, "probes_verified", port->probes_verified);
+    cJSON_AddNumberToObject(discovery, "rpm_fallbacks", port->rpm_fallbacks);
+    cJSON_AddNumberToObject(discovery, "absent_nodes", absent);
+    cJSON_AddNumberToObject(discovery, "master_nodes", master);
+    cJSON_AddNumberToObject(discovery, "slave_nodes", slave);
+    cJSON_AddItemToObject(mib, "discovery", discovery);
+
     cJSON *map = cJSON_CreateArray();
 
     for (uint8_t mac = port->nodes[255].next; mac != 255; mac = port->nodes[mac].next) {
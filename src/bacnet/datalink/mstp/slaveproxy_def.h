@@ -17,6 +17,7 @@
 #include "bacnet/slaveproxy.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/tsm.h"
+#include "misc/trace.h"
 
 extern int sp_dbg_verbos;
 extern int sp_dbg_warn;
@@ -25,35 +26,35 @@ extern int sp_dbg_err;
 #define SP_ERROR(fmt, args...)                      \
 do {                                                \
     if (sp_dbg_err) {                               \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define SP_WARN(fmt, args...)                       \
 do {                                                \
     if (sp_dbg_warn) {                              \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define SP_VERBOS(fmt, args...)                     \
 do {                                                \
     if (sp_dbg_verbos) {                            \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
 #define ERROR_ADDR(addr)                            \
 do {                                                \
     if (sp_dbg_err) {                               \
-        PRINT_BACNET_ADDRESS(addr);                 \
+        TRACE_BACNET_ADDRESS(DEBUG_LEVEL_ERROR, addr); \
     }                                               \
 } while (0)
 
 #define WARN_ADDR(addr)                             \
 do {                                                \
     if (sp_dbg_warn) {                              \
-        PRINT_BACNET_ADDRESS(addr);                 \
+        TRACE_BACNET_ADDRESS(DEBUG_LEVEL_WARN, addr); \
     }                                               \
 } while (0)
 
@@ -70,9 +71,25 @@ do {                                                \
 #define IAM_QUEUE_MASK      (IAM_QUEUE_SIZE - 1)
 #define IAM_EACH_SECOND     (1)
 
+/* дվI-Amޣµ */
+#define IAM_MAX_PENDING     (1024)
+
 #define MIN_SCAN_INTERVAL       (120)
 #define DEFAULT_SCAN_INTERVAL   (300)
 
+/* concurrent probes in flight on one port, "max_probes" in the proxy cfg */
+#define DEFAULT_MAX_PROBES      (8)
+#define MAX_PROBES              (32)
+
+/* the scan tick follows the observed token rotation */
+#define MIN_SCAN_TICK_MS        (20)
+#define DEFAULT_SCAN_TICK_MS    (100)
+#define IDLE_SCAN_TICK_MS       (1000)
+
+/* probe timeout in token rotations, bounded by the tsm apdu timeout */
+#define PROBE_TIMEOUT_ROTATIONS (4)
+#define MIN_PROBE_TIMEOUT_MS    (1000)
+
 
 typedef struct mstp_slave_s {
     struct list_head que_node;      /* lists that have whois requests */
@@ -96,8 +113,22 @@ typedef struct node_scan_s {
     uint8_t cancel : 1;
     BACNET_SEGMENTATION seg_support : 4;
 
+    enum {
+        PROBE_RPM_UNKNOWN = 0,
+        PROBE_RPM_OK,               /* answered the rpm probe */
+        PROBE_RPM_NO,               /* rejected rpm, probe with the rp chain */
+    } rpm : 2;
+
+    enum {
+        NODE_UNKNOWN = 0,
+        NODE_ABSENT,                /* last probe timed out, re-probed without retries */
+        NODE_MASTER,                /* supports who-is, not a slave */
+        NODE_SLAVE,
+    } state : 2;
+
     enum {
         SCAN_NOT_START = 0,
+        SCAN_PROBE,                 /* send rpm of all properties below */
         SCAN_WHOIS_SUPPORT,         /* send rp of service support */
         SCAN_SEG_SUPPORT,           /* send rp of segmentation support */
         SCAN_VENDOR_ID,             /* send rp of vendor id */
@@ -107,6 +138,7 @@ typedef struct node_scan_s {
     uint32_t device_id;
     uint16_t max_apdu;
     uint16_t vendor_id;
+    unsigned sent_ms;               /* first transmit of the current request */
 } node_scan_t;
 
 typedef struct slave_proxy_port_s {
@@ -116,8 +148,16 @@ typedef struct slave_proxy_port_s {
     uint8_t auto_discovery;
     uint16_t net;
     uint16_t scan_interval;
-    unsigned request_num;
+    uint8_t max_probes;
+    uint8_t probing;                /* nodes with status != SCAN_NOT_START */
     unsigned start_timestamp;
+    unsigned rtt_ms;                /* smoothed probe round trip, 0 before the first sample */
+    unsigned rotation_ms;           /* smoothed token rotation, 0 if the driver does not count */
+    unsigned token_ms;
+    uint32_t token_count;
+    uint32_t probes_sent;
+    uint32_t probes_verified;       /* rescans that found the binding unchanged */
+    uint32_t rpm_fallbacks;
     node_scan_t nodes[256];         /* nodes[255] only work as a list head */
 } slave_proxy_port_t;
 
@@ -136,7 +176,13 @@ typedef struct slave_proxy_manager_s {
     struct list_head que_head;      /* list for queue not null slave */
     struct rb_root rb_head;         /* device_id  */
     el_timer_t *iam_timer;
+    unsigned iam_ms;                /* last I-Am batch */
     int invoke_id;
+    uint32_t iam_pending;           /* дվqueueеI-Am */
+    uint32_t iam_queued;
+    uint32_t iam_collapsed;         /* ͬһqueueжϲ */
+    uint32_t iam_dropped;           /* queue޶ */
+    uint32_t iam_sent;
 } slave_proxy_manager_t;
 
 typedef union slave_scan_context_s {
@@ -0,0 +1,1193 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * pcapdl.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Pcap replay datalink
+ *
+ * History
+ */
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/timerfd.h>
+#include <arpa/inet.h>
+
+#include "pcapdl_def.h"
+#include "bacnet/network.h"
+#include "debug.h"
+
+static struct list_head all_pcap_list;
+
+static const char *pcapdl_stage_name[MAX_PCAPDL_STAGE] = {
+    "decap",
+    "apdu",
+    "relay",
+    "network_msg",
+    "tx",
+    "response",
+};
+
+bool pcapdl_dbg_verbos = true;
+bool pcapdl_dbg_warn = true;
+bool pcapdl_dbg_err = true;
+
+static uint64_t pcapdl_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned pcapdl_hist_index(uint64_t v)
+{
+    unsigned msb;
+
+    if (v < (1U << PCAPDL_HIST_SUB_BITS)) {
+        return (unsigned)v;
+    }
+
+    msb = 63 - __builtin_clzll(v);
+
+    return ((msb - PCAPDL_HIST_SUB_BITS + 1) << PCAPDL_HIST_SUB_BITS)
+        + ((v >> (msb - PCAPDL_HIST_SUB_BITS)) & ((1U << PCAPDL_HIST_SUB_BITS) - 1));
+}
+
+static uint64_t pcapdl_hist_value(unsigned idx)
+{
+    unsigned shift;
+
+    if (idx < (1U << PCAPDL_HIST_SUB_BITS)) {
+        return idx;
+    }
+
+    shift = (idx >> PCAPDL_HIST_SUB_BITS) - 1;
+
+    return (uint64_t)((1U << PCAPDL_HIST_SUB_BITS)
+        + (idx & ((1U << PCAPDL_HIST_SUB_BITS) - 1))) << shift;
+}
+
+static void pcapdl_stat_add(pcapdl_stat_t *stat, uint64_t ns)
+{
+    stat->count++;
+    stat->total_ns += ns;
+    if (ns > stat->max_ns) {
+        stat->max_ns = ns;
+    }
+    stat->hist[pcapdl_hist_index(ns)]++;
+}
+
+static uint64_t pcapdl_stat_percentile(pcapdl_stat_t *stat, uint32_t permille)
+{
+    uint64_t target, sum, value;
+    unsigned i;
+
+    if (stat->count == 0) {
+        return 0;
+    }
+
+    target = (stat->count * permille + 999) / 1000;
+    sum = 0;
+    for (i = 0; i < PCAPDL_HIST_BUCKETS; i++) {
+        sum += stat->hist[i];
+        if (sum >= target) {
+            value = pcapdl_hist_value(i);
+            return (value < stat->max_ns)? value: stat->max_ns;
+        }
+    }
+
+    return stat->max_ns;
+}
+
+static inline uint16_t get_be16(const uint8_t *p)
+{
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static inline void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xff;
+}
+
+static int pcapdl_decap_ip(datalink_pcap_t *pcap, const uint8_t *ip, uint32_t len,
+            const uint8_t **npdu, uint32_t *npdu_len, uint8_t *src)
+{
+    const uint8_t *udp, *bvlc;
+    uint32_t ihl, ip_len, udp_len, bvlc_len;
+
+    if ((len < IPV4_HDR_LEN) || ((ip[0] >> 4) != 4)) {
+        return -EINVAL;
+    }
+
+    ihl = (ip[0] & 0x0f) * 4;
+    ip_len = get_be16(&ip[2]);
+    if ((ihl < IPV4_HDR_LEN) || (ip_len < ihl) || (ip_len > len)) {
+        return -EINVAL;
+    }
+
+    /* udp only, fragments are not reassembled */
+    if ((ip[9] != 17) || (get_be16(&ip[6]) & 0x3fff)) {
+        return -EPERM;
+    }
+
+    udp = ip + ihl;
+    if (ip_len - ihl < UDP_HDR_LEN) {
+        return -EINVAL;
+    }
+
+    if (get_be16(&udp[2]) != pcap->udp_port) {
+        return -EPERM;
+    }
+
+    udp_len = get_be16(&udp[4]);
+    if ((udp_len < UDP_HDR_LEN + BVLC_HDR_LEN) || (udp_len > ip_len - ihl)) {
+        return -EINVAL;
+    }
+
+    bvlc = udp + UDP_HDR_LEN;
+    bvlc_len = get_be16(&bvlc[2]);
+    if ((bvlc[0] != BVLC_TYPE_BIP) || (bvlc_len < BVLC_HDR_LEN)
+            || (bvlc_len > udp_len - UDP_HDR_LEN)) {
+        return -EINVAL;
+    }
+
+    switch (bvlc[1]) {
+    case BVLC_ORIGINAL_UNICAST_NPDU:
+    case BVLC_ORIGINAL_BROADCAST_NPDU:
+        memcpy(src, &ip[12], 4);
+        memcpy(&src[4], &udp[0], 2);
+        *npdu = bvlc + BVLC_HDR_LEN;
+        *npdu_len = bvlc_len - BVLC_HDR_LEN;
+        break;
+
+    case BVLC_FORWARDED_NPDU:
+        if (bvlc_len < BVLC_HDR_LEN + PCAPDL_MAC_LEN) {
+            return -EINVAL;
+        }
+        memcpy(src, &bvlc[BVLC_HDR_LEN], PCAPDL_MAC_LEN);
+        *npdu = bvlc + BVLC_HDR_LEN + PCAPDL_MAC_LEN;
+        *npdu_len = bvlc_len - BVLC_HDR_LEN - PCAPDL_MAC_LEN;
+        break;
+
+    default:
+        /* bbmd and foreign device management is not replayed */
+        return -EPERM;
+    }
+
+    return OK;
+}
+
+/**
+ * pcapdl_decap - get npdu and source mac from a captured frame
+ *
+ * @return: 0 if success, -EPERM if frame is not for replay, -EINVAL if malformed
+ *
+ */
+static int pcapdl_decap(datalink_pcap_t *pcap, const uint8_t *frame, uint32_t len,
+            const uint8_t **npdu, uint32_t *npdu_len, uint8_t *src)
+{
+    uint32_t off, type;
+    int rv;
+
+    switch (pcap->linktype) {
+    case LINKTYPE_ETHERNET:
+        if (len < ETH_HDR_LEN) {
+            return -EINVAL;
+        }
+        off = ETH_HDR_LEN;
+        type = get_be16(&frame[12]);
+        if (type == ETH_TYPE_VLAN) {
+            if (len < ETH_HDR_LEN + 4) {
+                return -EINVAL;
+            }
+            type = get_be16(&frame[16]);
+            off += 4;
+        }
+
+        if (type == ETH_TYPE_IPV4) {
+            rv = pcapdl_decap_ip(pcap, frame + off, len - off, npdu, npdu_len, src);
+            break;
+        }
+
+        /* 802.3 length field, BACnet uses LLC 0x82 0x82 0x03 */
+        if ((type > 1500) || (type < LLC_HDR_LEN) || (len < off + type)) {
+            return -EPERM;
+        }
+        if ((frame[off] != 0x82) || (frame[off + 1] != 0x82) || (frame[off + 2] != 0x03)) {
+            return -EPERM;
+        }
+        memcpy(src, &frame[6], PCAPDL_MAC_LEN);
+        *npdu = frame + off + LLC_HDR_LEN;
+        *npdu_len = type - LLC_HDR_LEN;
+        rv = OK;
+        break;
+
+    case LINKTYPE_LINUX_SLL:
+        if ((len < SLL_HDR_LEN) || (get_be16(&frame[14]) != ETH_TYPE_IPV4)) {
+            return -EPERM;
+        }
+        rv = pcapdl_decap_ip(pcap, frame + SLL_HDR_LEN, len - SLL_HDR_LEN, npdu, npdu_len, src);
+        break;
+
+    case LINKTYPE_RAW:
+    case LINKTYPE_IPV4:
+        rv = pcapdl_decap_ip(pcap, frame, len, npdu, npdu_len, src);
+        break;
+
+    default:
+        return -EPERM;
+    }
+
+    if (rv < 0) {
+        return rv;
+    }
+
+    if ((*npdu_len == 0) || (*npdu_len > PCAPDL_MAX_NPDU)) {
+        return -EINVAL;
+    }
+
+    /* responses of the captured device itself, the stack makes its own */
+    if (pcap->addr_set && (memcmp(src, pcap->addr, PCAPDL_MAC_LEN) == 0)) {
+        return -EPERM;
+    }
+
+    return OK;
+}
+
+static pcapdl_stage_t pcapdl_classify(datalink_pcap_t *pcap, const uint8_t *npdu, uint32_t len)
+{
+    uint16_t dnet;
+
+    if ((len < 2) || (npdu[1] & 0x80)) {
+        return PCAPDL_STAGE_NETWORK_MSG;
+    }
+
+    if (!(npdu[1] & 0x20) || (len < 4)) {
+        return PCAPDL_STAGE_APDU;
+    }
+
+    dnet = get_be16(&npdu[2]);
+    if (dnet == BACNET_BROADCAST_NETWORK) {
+        return PCAPDL_STAGE_APDU;
+    }
+
+    return PCAPDL_STAGE_RELAY;
+}
+
+static void pcapdl_inject(datalink_pcap_t *pcap, pcapdl_frame_t *frame)
+{
+    DECLARE_BACNET_BUF(rx, PCAPDL_MAX_NPDU);
+    bacnet_addr_t src_mac;
+    const uint8_t *npdu;
+    uint32_t npdu_len;
+    pcapdl_stage_t stage;
+    uint64_t t0, t1, t2;
+    int rv;
+
+    t0 = pcapdl_now_ns();
+    rv = pcapdl_decap(pcap, pcap->map + frame->offset, frame->len, &npdu, &npdu_len,
+        src_mac.adr);
+    t1 = pcapdl_now_ns();
+    pcapdl_stat_add(&pcap->stats[PCAPDL_STAGE_DECAP], t1 - t0);
+
+    if (rv < 0) {
+        if (rv != -EPERM) {
+            PCAPDL_WARN("%s: malformed frame at offset(%u)\r\n", __func__, frame->offset);
+        }
+        pcap->skipped++;
+        return;
+    }
+
+    pcap->dl.rx_all++;
+    (void)bacnet_buf_init(&rx.buf, PCAPDL_MAX_NPDU);
+    memcpy(rx.buf.data, npdu, npdu_len);
+    rx.buf.data_len = npdu_len;
+    src_mac.net = 0;
+    src_mac.len = PCAPDL_MAC_LEN;
+    stage = pcapdl_classify(pcap, npdu, npdu_len);
+
+    pcap->in_rx = true;
+    pcap->rx_start_ns = t1;
+    pcap->rx_tx_ns = 0;
+    pcap->dl.rx_ok++;
+    pcap->injected++;
+    (void)network_receive_pdu(pcap->dl.port_id, &rx.buf, &src_mac);
+    t2 = pcapdl_now_ns();
+    pcap->in_rx = false;
+
+    /* tx caused by this frame is accounted in its own stage */
+    pcapdl_stat_add(&pcap->stats[stage], t2 - t1 - pcap->rx_tx_ns);
+}
+
+static void pcapdl_arm_timer(datalink_pcap_t *pcap, uint64_t delay_ns)
+{
+    struct itimerspec its = {};
+
+    if (delay_ns == 0) {
+        delay_ns = 1;
+    }
+    its.it_value.tv_sec = delay_ns / 1000000000ULL;
+    its.it_value.tv_nsec = delay_ns % 1000000000ULL;
+
+    if (timerfd_settime(pcap->timer_fd, 0, &its, NULL) < 0) {
+        PCAPDL_ERROR("%s: timerfd_settime failed cause %s\r\n", __func__, strerror(errno));
+    }
+}
+
+static uint64_t pcapdl_due_ns(datalink_pcap_t *pcap, pcapdl_frame_t *frame)
+{
+    uint64_t offset;
+
+    if (pcap->speed <= 0) {
+        return 0;
+    }
+
+    offset = frame->ts_ns - pcap->frames[0].ts_ns;
+    if (pcap->speed != 1.0) {
+        offset = (uint64_t)(offset / pcap->speed);
+    }
+
+    return pcap->base_ns + offset;
+}
+
+static void pcapdl_timer_handler(el_watch_t *watch, int events)
+{
+    datalink_pcap_t *pcap;
+    pcapdl_frame_t *frame;
+    uint64_t expired, now, due;
+    int budget;
+
+    pcap = (datalink_pcap_t *)watch->data;
+    if (!pcap) {
+        PCAPDL_ERROR("%s: null pcap argument\r\n", __func__);
+        return;
+    }
+
+    (void)read(pcap->timer_fd, &expired, sizeof(expired));
+    if (pcap->done) {
+        return;
+    }
+
+    now = pcapdl_now_ns();
+    if (pcap->start_ns == 0) {
+        pcap->start_ns = now;
+        pcap->base_ns = now;
+    }
+
+    for (budget = PCAPDL_RX_BUDGET; budget > 0; budget--) {
+        if (pcap->next >= pcap->frame_nums) {
+            pcap->loop_done++;
+            if (pcap->loop_done >= pcap->loops) {
+                pcap->done = true;
+                pcap->end_ns = pcapdl_now_ns();
+                PCAPDL_VERBOS("%s: %s replay done\r\n", __func__, pcap->input);
+                return;
+            }
+            pcap->next = 0;
+            pcap->base_ns = pcapdl_now_ns();
+        }
+
+        frame = &pcap->frames[pcap->next];
+        due = pcapdl_due_ns(pcap, frame);
+        if (due > now) {
+            now = pcapdl_now_ns();
+            if (due > now) {
+                pcapdl_arm_timer(pcap, due - now);
+                return;
+            }
+        }
+
+        pcapdl_inject(pcap, frame);
+        pcap->next++;
+    }
+
+    /* let other watches run */
+    pcapdl_arm_timer(pcap, 0);
+}
+
+static void pcapdl_write_record(datalink_pcap_t *pcap, const uint8_t *frame, uint32_t len)
+{
+    pcap_rec_hdr_t rec;
+    struct timeval tv;
+
+    (void)gettimeofday(&tv, NULL);
+    rec.ts_sec = tv.tv_sec;
+    rec.ts_frac = tv.tv_usec;
+    rec.incl_len = len;
+    rec.orig_len = len;
+
+    if ((fwrite(&rec, sizeof(rec), 1, pcap->out) != 1)
+            || (fwrite(frame, len, 1, pcap->out) != 1)) {
+        PCAPDL_ERROR("%s: write %s failed\r\n", __func__, pcap->output);
+    }
+}
+
+static uint32_t pcapdl_encap_bip(datalink_pcap_t *pcap, uint8_t *frame, bacnet_addr_t *dst_mac,
+                    bacnet_buf_t *npdu)
+{
+    uint8_t *ip, *udp, *bvlc;
+    uint32_t sum, i;
+    bool broadcast;
+
+    broadcast = (dst_mac == NULL) || (dst_mac->len == 0);
+
+    memset(frame, broadcast? 0xff: 0x00, 6);
+    memset(&frame[6], 0x00, 6);
+    put_be16(&frame[12], ETH_TYPE_IPV4);
+
+    ip = &frame[ETH_HDR_LEN];
+    udp = ip + IPV4_HDR_LEN;
+    bvlc = udp + UDP_HDR_LEN;
+
+    ip[0] = 0x45;
+    ip[1] = 0;
+    put_be16(&ip[2], IPV4_HDR_LEN + UDP_HDR_LEN + BVLC_HDR_LEN + npdu->data_len);
+    put_be16(&ip[4], 0);
+    put_be16(&ip[6], 0x4000);
+    ip[8] = 64;
+    ip[9] = 17;
+    put_be16(&ip[10], 0);
+    memcpy(&ip[12], pcap->addr, 4);
+    if (broadcast) {
+        memset(&ip[16], 0xff, 4);
+    } else {
+        memcpy(&ip[16], dst_mac->adr, 4);
+    }
+
+    sum = 0;
+    for (i = 0; i < IPV4_HDR_LEN; i += 2) {
+        sum += get_be16(&ip[i]);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    put_be16(&ip[10], ~sum & 0xffff);
+
+    memcpy(&udp[0], &pcap->addr[4], 2);
+    if (broadcast) {
+        put_be16(&udp[2], pcap->udp_port);
+    } else {
+        memcpy(&udp[2], &dst_mac->adr[4], 2);
+    }
+    put_be16(&udp[4], UDP_HDR_LEN + BVLC_HDR_LEN + npdu->data_len);
+    put_be16(&udp[6], 0);
+
+    bvlc[0] = BVLC_TYPE_BIP;
+    bvlc[1] = broadcast? BVLC_ORIGINAL_BROADCAST_NPDU: BVLC_ORIGINAL_UNICAST_NPDU;
+    put_be16(&bvlc[2], BVLC_HDR_LEN + npdu->data_len);
+    memcpy(&bvlc[BVLC_HDR_LEN], npdu->data, npdu->data_len);
+
+    return ETH_HDR_LEN + IPV4_HDR_LEN + UDP_HDR_LEN + BVLC_HDR_LEN + npdu->data_len;
+}
+
+static uint32_t pcapdl_encap_ether(datalink_pcap_t *pcap, uint8_t *frame, bacnet_addr_t *dst_mac,
+                    bacnet_buf_t *npdu)
+{
+    uint32_t len;
+
+    if ((dst_mac == NULL) || (dst_mac->len == 0)) {
+        memset(frame, 0xff, 6);
+    } else {
+        memcpy(frame, dst_mac->adr, 6);
+    }
+    memcpy(&frame[6], pcap->addr, 6);
+    put_be16(&frame[12], LLC_HDR_LEN + npdu->data_len);
+    frame[14] = 0x82;
+    frame[15] = 0x82;
+    frame[16] = 0x03;
+    memcpy(&frame[17], npdu->data, npdu->data_len);
+
+    len = ETH_HDR_LEN + LLC_HDR_LEN + npdu->data_len;
+    if (len < ETH_MIN_FRAME) {
+        memset(&frame[len], 0, ETH_MIN_FRAME - len);
+        len = ETH_MIN_FRAME;
+    }
+
+    return len;
+}
+
+/**
+ * pcapdl_send_pdu - pcap port send, the frame goes to output file if any
+ *
+ * @pcap: port
+ * @dst_mac: destination, NULL or len 0 means local broadcast
+ * @npdu: npdu to send
+ * @prio: ignored
+ * @der: ignored
+ *
+ * @return: 0 if success, negative if fail
+ *
+ */
+static int pcapdl_send_pdu(datalink_pcap_t *pcap, bacnet_addr_t *dst_mac, bacnet_buf_t *npdu,
+            __attribute__ ((unused))bacnet_prio_t prio, __attribute__ ((unused))bool der)
+{
+    uint8_t frame[ETH_HDR_LEN + IPV4_HDR_LEN + UDP_HDR_LEN + BVLC_HDR_LEN + PCAPDL_MAX_NPDU];
+    uint64_t t0, t1;
+    uint32_t len;
+
+    if (!pcap) {
+        PCAPDL_ERROR("%s: null port\r\n", __func__);
+        return -EINVAL;
+    }
+
+    t0 = pcapdl_now_ns();
+    pcap->dl.tx_all++;
+
+    if ((npdu == NULL) || (npdu->data == NULL) || (npdu->data_len == 0)
+            || (npdu->data_len > PCAPDL_MAX_NPDU)) {
+        PCAPDL_ERROR("%s: invalid npdu\r\n", __func__);
+        return -EINVAL;
+    }
+
+    if ((dst_mac != NULL) && (dst_mac->len != 0) && (dst_mac->len != PCAPDL_MAC_LEN)) {
+        PCAPDL_ERROR("%s: invalid dst mac len(%d)\r\n", __func__, dst_mac->len);
+        return -EINVAL;
+    }
+
+    if (pcap->out) {
+        if (pcap->format == PCAPDL_FORMAT_BIP) {
+            len = pcapdl_encap_bip(pcap, frame, dst_mac, npdu);
+        } else {
+            len = pcapdl_encap_ether(pcap, frame, dst_mac, npdu);
+        }
+        pcapdl_write_record(pcap, frame, len);
+    }
+
+    pcap->dl.tx_ok++;
+
+    t1 = pcapdl_now_ns();
+    pcapdl_stat_add(&pcap->stats[PCAPDL_STAGE_TX], t1 - t0);
+    if (pcap->in_rx) {
+        pcap->rx_tx_ns += t1 - t0;
+        pcapdl_stat_add(&pcap->stats[PCAPDL_STAGE_RESPONSE], t1 - pcap->rx_start_ns);
+    }
+
+    return OK;
+}
+
+static cJSON *pcapdl_get_stage_mib(datalink_pcap_t *pcap)
+{
+    pcapdl_stat_t *stat;
+    cJSON *stages, *tmp;
+    int i;
+
+    stages = cJSON_CreateObject();
+    if (stages == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < MAX_PCAPDL_STAGE; i++) {
+        stat = &pcap->stats[i];
+        tmp = cJSON_CreateObject();
+        if (tmp == NULL) {
+            cJSON_Delete(stages);
+            return NULL;
+        }
+        cJSON_AddNumberToObject(tmp, "count", stat->count);
+        cJSON_AddNumberToObject(tmp, "avg_ns", stat->count? stat->total_ns / stat->count: 0);
+        cJSON_AddNumberToObject(tmp, "p50_ns", pcapdl_stat_percentile(stat, 500));
+        cJSON_AddNumberToObject(tmp, "p99_ns", pcapdl_stat_percentile(stat, 990));
+        cJSON_AddNumberToObject(tmp, "p999_ns", pcapdl_stat_percentile(stat, 999));
+        cJSON_AddNumberToObject(tmp, "max_ns", stat->max_ns);
+        cJSON_AddItemToObject(stages, pcapdl_stage_name[i], tmp);
+    }
+
+    return stages;
+}
+
+static cJSON *pcapdl_get_mib(datalink_base_t *dl_port)
+{
+    datalink_pcap_t *pcap;
+    cJSON *result, *stages;
+    uint64_t end;
+
+    result = datalink_get_mib(dl_port);
+    if (result == NULL) {
+        PCAPDL_ERROR("%s: datalink_get_mib failed\r\n", __func__);
+        return NULL;
+    }
+
+    pcap = (datalink_pcap_t *)dl_port;
+    cJSON_AddStringToObject(result, "input", pcap->input);
+    if (pcap->output) {
+        cJSON_AddStringToObject(result, "output", pcap->output);
+    }
+    cJSON_AddStringToObject(result, "format",
+        (pcap->format == PCAPDL_FORMAT_BIP)? "bip": "ethernet");
+    cJSON_AddNumberToObject(result, "speed", pcap->speed);
+    cJSON_AddNumberToObject(result, "frames", pcap->frame_nums);
+    cJSON_AddNumberToObject(result, "loop", pcap->loops);
+    cJSON_AddNumberToObject(result, "loop_done", pcap->loop_done);
+    cJSON_AddNumberToObject(result, "injected", pcap->injected);
+    cJSON_AddNumberToObject(result, "skipped", pcap->skipped);
+    cJSON_AddBoolToObject(result, "done", pcap->done);
+
+    end = pcap->done? pcap->end_ns: pcapdl_now_ns();
+    cJSON_AddNumberToObject(result, "elapsed_ns", pcap->start_ns? end - pcap->start_ns: 0);
+
+    stages = pcapdl_get_stage_mib(pcap);
+    if (stages == NULL) {
+        PCAPDL_ERROR("%s: create stage mib failed\r\n", __func__);
+        cJSON_Delete(result);
+        return NULL;
+    }
+    cJSON_AddItemToObject(result, "stages", stages);
+
+    return result;
+}
+
+static int pcapdl_load(datalink_pcap_t *pcap, const char *file)
+{
+    pcap_file_hdr_t *hdr;
+    pcap_rec_hdr_t *rec;
+    pcapdl_frame_t *frames;
+    struct stat st;
+    uint32_t frame_max, incl_len, ts_sec, ts_frac;
+    size_t off;
+    bool swapped, nsec;
+    int fd;
+
+    fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PCAPDL_ERROR("%s: open %s failed cause %s\r\n", __func__, file, strerror(errno));
+        return -EPERM;
+    }
+
+    if ((fstat(fd, &st) < 0) || (st.st_size < (off_t)sizeof(pcap_file_hdr_t))
+            || (st.st_size > 0xffffffffLL)) {
+        PCAPDL_ERROR("%s: invalid file size of %s\r\n", __func__, file);
+        close(fd);
+        return -EINVAL;
+    }
+
+    pcap->map = (uint8_t *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pcap->map == MAP_FAILED) {
+        PCAPDL_ERROR("%s: mmap %s failed cause %s\r\n", __func__, file, strerror(errno));
+        pcap->map = NULL;
+        return -EPERM;
+    }
+    pcap->map_len = st.st_size;
+
+    hdr = (pcap_file_hdr_t *)pcap->map;
+    if ((hdr->magic == PCAP_MAGIC_USEC) || (hdr->magic == PCAP_MAGIC_NSEC)) {
+        swapped = false;
+    } else if ((hdr->magic == __builtin_bswap32(PCAP_MAGIC_USEC))
+            || (hdr->magic == __builtin_bswap32(PCAP_MAGIC_NSEC))) {
+        swapped = true;
+    } else {
+        PCAPDL_ERROR("%s: %s is not a pcap file(pcapng is not supported)\r\n", __func__, file);
+        return -EINVAL;
+    }
+
+#define PCAP_U32(v) (swapped? __builtin_bswap32(v): (v))
+
+    nsec = (PCAP_U32(hdr->magic) == PCAP_MAGIC_NSEC);
+    pcap->linktype = PCAP_U32(hdr->linktype);
+    if ((pcap->linktype != LINKTYPE_ETHERNET) && (pcap->linktype != LINKTYPE_RAW)
+            && (pcap->linktype != LINKTYPE_LINUX_SLL) && (pcap->linktype != LINKTYPE_IPV4)) {
+        PCAPDL_ERROR("%s: unsupported linktype(%u)\r\n", __func__, pcap->linktype);
+        return -EINVAL;
+    }
+
+    frame_max = 0;
+    off = sizeof(pcap_file_hdr_t);
+    while (off + sizeof(pcap_rec_hdr_t) <= pcap->map_len) {
+        rec = (pcap_rec_hdr_t *)(pcap->map + off);
+        incl_len = PCAP_U32(rec->incl_len);
+        ts_sec = PCAP_U32(rec->ts_sec);
+        ts_frac = PCAP_U32(rec->ts_frac);
+        off += sizeof(pcap_rec_hdr_t);
+        if (incl_len > pcap->map_len - off) {
+            PCAPDL_WARN("%s: truncated record at offset(%zu)\r\n", __func__, off);
+            break;
+        }
+
+        if (pcap->frame_nums == frame_max) {
+            frame_max = frame_max? frame_max * 2: 1024;
+            frames = (pcapdl_frame_t *)realloc(pcap->frames, frame_max * sizeof(pcapdl_frame_t));
+            if (frames == NULL) {
+                PCAPDL_ERROR("%s: realloc frames failed\r\n", __func__);
+                return -ENOMEM;
+            }
+            pcap->frames = frames;
+        }
+
+        frames = &pcap->frames[pcap->frame_nums++];
+        frames->ts_ns = (uint64_t)ts_sec * 1000000000ULL + (nsec? ts_frac: ts_frac * 1000ULL);
+        frames->offset = off;
+        frames->len = incl_len;
+        off += incl_len;
+    }
+
+#undef PCAP_U32
+
+    if (pcap->frame_nums == 0) {
+        PCAPDL_ERROR("%s: no frame in %s\r\n", __func__, file);
+        return -EINVAL;
+    }
+
+    /* capture clock may step backwards, keep replay order monotonic */
+    for (frame_max = 1; frame_max < pcap->frame_nums; frame_max++) {
+        if (pcap->frames[frame_max].ts_ns < pcap->frames[frame_max - 1].ts_ns) {
+            pcap->frames[frame_max].ts_ns = pcap->frames[frame_max - 1].ts_ns;
+        }
+    }
+
+    return OK;
+}
+
+static int pcapdl_open_output(datalink_pcap_t *pcap)
+{
+    pcap_file_hdr_t hdr;
+
+    pcap->out = fopen(pcap->output, "wb");
+    if (pcap->out == NULL) {
+        PCAPDL_ERROR("%s: open %s failed cause %s\r\n", __func__, pcap->output, strerror(errno));
+        return -EPERM;
+    }
+
+    hdr.magic = PCAP_MAGIC_USEC;
+    hdr.version_major = 2;
+    hdr.version_minor = 4;
+    hdr.thiszone = 0;
+    hdr.sigfigs = 0;
+    hdr.snaplen = 65535;
+    hdr.linktype = LINKTYPE_ETHERNET;
+    if (fwrite(&hdr, sizeof(hdr), 1, pcap->out) != 1) {
+        PCAPDL_ERROR("%s: write %s failed\r\n", __func__, pcap->output);
+        fclose(pcap->out);
+        pcap->out = NULL;
+        return -EPERM;
+    }
+
+    return OK;
+}
+
+static int pcapdl_parse_address(datalink_pcap_t *pcap, const char *str)
+{
+    unsigned int mac[PCAPDL_MAC_LEN];
+    char ip[INET_ADDRSTRLEN];
+    const char *colon;
+    unsigned long port;
+    char *end;
+    int i;
+
+    if (pcap->format == PCAPDL_FORMAT_ETHERNET) {
+        if (sscanf(str, "%x:%x:%x:%x:%x:%x", &mac[0], &mac[1], &mac[2], &mac[3], &mac[4],
+                &mac[5]) != PCAPDL_MAC_LEN) {
+            return -EINVAL;
+        }
+        for (i = 0; i < PCAPDL_MAC_LEN; i++) {
+            if (mac[i] > 0xff) {
+                return -EINVAL;
+            }
+            pcap->addr[i] = mac[i];
+        }
+        return OK;
+    }
+
+    port = pcap->udp_port;
+    colon = strchr(str, ':');
+    if (colon) {
+        if ((colon - str) >= (int)sizeof(ip)) {
+            return -EINVAL;
+        }
+        memcpy(ip, str, colon - str);
+        ip[colon - str] = 0;
+        port = strtoul(colon + 1, &end, 0);
+        if ((*end) || (port == 0) || (port > 0xffff)) {
+            return -EINVAL;
+        }
+    } else {
+        if (strlen(str) >= sizeof(ip)) {
+            return -EINVAL;
+        }
+        strcpy(ip, str);
+    }
+
+    if (inet_pton(AF_INET, ip, pcap->addr) != 1) {
+        return -EINVAL;
+    }
+    put_be16(&pcap->addr[4], (uint16_t)port);
+
+    return OK;
+}
+
+static void pcapdl_port_free(datalink_pcap_t *pcap)
+{
+    if (pcap->out) {
+        fclose(pcap->out);
+    }
+
+    if (pcap->map) {
+        (void)munmap(pcap->map, pcap->map_len);
+    }
+
+    if (pcap->timer_fd >= 0) {
+        close(pcap->timer_fd);
+    }
+
+    free(pcap->frames);
+    free(pcap->input);
+    free(pcap->output);
+    free(pcap);
+}
+
+/**
+ * pcapdl_port_create - create pcap replay port
+ *
+ * @cfg: port config
+ * @res: resource config
+ *
+ * @return: port object if success, NULL if fail
+ *
+ */
+datalink_pcap_t *pcapdl_port_create(cJSON *cfg, cJSON *res)
+{
+    datalink_pcap_t *pcap;
+    cJSON *tmp;
+    const char *ifname, *res_type;
+
+    if (cfg == NULL || res == NULL) {
+        PCAPDL_ERROR("%s: null argument\r\n", __func__);
+        return NULL;
+    }
+
+    cfg = cJSON_Duplicate(cfg, true);
+    if (cfg == NULL) {
+        PCAPDL_ERROR("%s: cjson duplicate failed\r\n", __func__);
+        return NULL;
+    }
+
+    pcap = (datalink_pcap_t *)malloc(sizeof(datalink_pcap_t));
+    if (!pcap) {
+        PCAPDL_ERROR("%s: malloc datalink_pcap_t failed\r\n", __func__);
+        goto out0;
+    }
+    memset(pcap, 0, sizeof(datalink_pcap_t));
+    pcap->timer_fd = -1;
+
+    pcap->dl.send_pdu = (int(*)(datalink_base_t *, bacnet_addr_t *, bacnet_buf_t *, bacnet_prio_t,
+        bool))pcapdl_send_pdu;
+    pcap->dl.get_port_mib = pcapdl_get_mib;
+    pcap->dl.max_npdu_len = PCAPDL_MAX_NPDU;
+    pcap->format = PCAPDL_FORMAT_BIP;
+    pcap->udp_port = PCAPDL_DEFAULT_UDP_PORT;
+    pcap->speed = 1.0;
+    pcap->loops = 1;
+    pcap->start_delay_ms = PCAPDL_DEFAULT_START_DELAY;
+
+    tmp = cJSON_GetObjectItem(cfg, "resource_name");
+    if ((!tmp) || (tmp->type != cJSON_String)) {
+        PCAPDL_ERROR("%s: get resource_name item failed\r\n", __func__);
+        goto out1;
+    }
+
+    res_type = datalink_get_type_by_resource_name(res, tmp->valuestring);
+    if (res_type == NULL) {
+        PCAPDL_ERROR("%s: get resource type failed by name: %s\r\n", __func__, tmp->valuestring);
+        goto out1;
+    }
+
+    if (strcmp(res_type, "PCAP")) {
+        PCAPDL_ERROR("%s: resource type is not PCAP: %s\r\n", __func__, res_type);
+        goto out1;
+    }
+
+    ifname = datalink_get_ifname_by_resource_name(res, tmp->valuestring);
+    if (ifname == NULL) {
+        PCAPDL_ERROR("%s: get ifname by resource name:%s failed\r\n", __func__, tmp->valuestring);
+        goto out1;
+    }
+    cJSON_DeleteItemFromObject(cfg, "resource_name");
+
+    pcap->input = strdup(ifname);
+    if (pcap->input == NULL) {
+        PCAPDL_ERROR("%s: strdup input failed\r\n", __func__);
+        goto out1;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "format");
+    if (tmp) {
+        if ((tmp->type == cJSON_String) && (strcmp(tmp->valuestring, "bip") == 0)) {
+            pcap->format = PCAPDL_FORMAT_BIP;
+        } else if ((tmp->type == cJSON_String) && (strcmp(tmp->valuestring, "ethernet") == 0)) {
+            pcap->format = PCAPDL_FORMAT_ETHERNET;
+        } else {
+            PCAPDL_ERROR("%s: invalid format item\r\n", __func__);
+            goto out1;
+        }
+        cJSON_DeleteItemFromObject(cfg, "format");
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "udp_port");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint <= 0) || (tmp->valueint > 0xffff)) {
+            PCAPDL_ERROR("%s: invalid udp_port item\r\n", __func__);
+            goto out1;
+        }
+        pcap->udp_port = tmp->valueint;
+        cJSON_DeleteItemFromObject(cfg, "udp_port");
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "address");
+    if (tmp) {
+        if ((tmp->type != cJSON_String) || (pcapdl_parse_address(pcap, tmp->valuestring) < 0)) {
+            PCAPDL_ERROR("%s: invalid address item\r\n", __func__);
+            goto out1;
+        }
+        pcap->addr_set = true;
+        cJSON_DeleteItemFromObject(cfg, "address");
+    } else if (pcap->format == PCAPDL_FORMAT_BIP) {
+        put_be16(&pcap->addr[4], pcap->udp_port);
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "speed");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valuedouble < 0)) {
+            PCAPDL_ERROR("%s: invalid speed item\r\n", __func__);
+            goto out1;
+        }
+        pcap->speed = tmp->valuedouble;
+        cJSON_DeleteItemFromObject(cfg, "speed");
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "loop");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint <= 0)) {
+            PCAPDL_ERROR("%s: invalid loop item\r\n", __func__);
+            goto out1;
+        }
+        pcap->loops = tmp->valueint;
+        cJSON_DeleteItemFromObject(cfg, "loop");
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "start_delay_ms");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint < 0)) {
+            PCAPDL_ERROR("%s: invalid start_delay_ms item\r\n", __func__);
+            goto out1;
+        }
+        pcap->start_delay_ms = tmp->valueint;
+        cJSON_DeleteItemFromObject(cfg, "start_delay_ms");
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "output");
+    if (tmp) {
+        if (tmp->type != cJSON_String) {
+            PCAPDL_ERROR("%s: invalid output item\r\n", __func__);
+            goto out1;
+        }
+        pcap->output = strdup(tmp->valuestring);
+        if ((pcap->output == NULL) || (pcapdl_open_output(pcap) < 0)) {
+            PCAPDL_ERROR("%s: open output failed\r\n", __func__);
+            goto out1;
+        }
+        cJSON_DeleteItemFromObject(cfg, "output");
+    }
+
+    if (pcapdl_load(pcap, pcap->input) < 0) {
+        PCAPDL_ERROR("%s: load %s failed\r\n", __func__, pcap->input);
+        goto out1;
+    }
+
+    pcap->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (pcap->timer_fd < 0) {
+        PCAPDL_ERROR("%s: create timerfd failed cause %s\r\n", __func__, strerror(errno));
+        goto out1;
+    }
+
+    list_add_tail(&(pcap->pcap_list), &all_pcap_list);
+
+    cJSON *child = cfg->child;
+    while (child) {
+        PCAPDL_WARN("%s: unknown cfg item: %s\r\n", __func__, child->string);
+        child = child->next;
+    }
+
+    cJSON_Delete(cfg);
+
+    return pcap;
+
+out1:
+    pcapdl_port_free(pcap);
+
+out0:
+    cJSON_Delete(cfg);
+
+    return NULL;
+}
+
+static void pcapdl_port_unwatch(datalink_pcap_t *pcap)
+{
+    if (pcap->timer_watch != NULL) {
+        (void)el_watch_destroy(&el_default_loop, pcap->timer_watch);
+        pcap->timer_watch = NULL;
+    }
+}
+
+int pcapdl_port_delete(datalink_pcap_t *pcap_port)
+{
+    if (pcap_port == NULL) {
+        PCAPDL_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    list_del(&pcap_port->pcap_list);
+
+    pcapdl_port_unwatch(pcap_port);
+    pcapdl_port_free(pcap_port);
+
+    return OK;
+}
+
+datalink_pcap_t *pcapdl_next_port(datalink_pcap_t *prev)
+{
+    if (!prev) {
+        if (list_empty(&all_pcap_list)) {
+            return NULL;
+        }
+        return list_first_entry(&all_pcap_list, datalink_pcap_t, pcap_list);
+    }
+
+    if (prev->pcap_list.next != &all_pcap_list) {
+        return list_next_entry(prev, pcap_list);
+    } else {
+        return NULL;
+    }
+}
+
+bool pcapdl_replay_done(void)
+{
+    datalink_pcap_t *pcap;
+
+    list_for_each_entry(pcap, &all_pcap_list, pcap_list) {
+        if (!pcap->done) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int pcapdl_init(void)
+{
+    INIT_LIST_HEAD(&all_pcap_list);
+    return OK;
+}
+
+int pcapdl_startup(void)
+{
+    datalink_pcap_t *pcap, *pcap_todel;
+
+    list_for_each_entry(pcap, &all_pcap_list, pcap_list) {
+        pcap->dl.tx_all = 0;
+        pcap->dl.tx_ok = 0;
+        pcap->dl.rx_all = 0;
+        pcap->dl.rx_ok = 0;
+
+        pcap->timer_watch = el_watch_create(&el_default_loop, pcap->timer_fd, EPOLLIN);
+        if (pcap->timer_watch == NULL) {
+            PCAPDL_ERROR("%s: event watch create failed\r\n", __func__);
+            list_for_each_entry(pcap_todel, &all_pcap_list, pcap_list) {
+                if (pcap_todel == pcap) {
+                    break;
+                }
+                pcapdl_port_unwatch(pcap_todel);
+            }
+            return -EPERM;
+        }
+        pcap->timer_watch->handler = pcapdl_timer_handler;
+        pcap->timer_watch->data = pcap;
+
+        /* replay starts after the stack has announced itself */
+        pcapdl_arm_timer(pcap, (uint64_t)pcap->start_delay_ms * 1000000ULL);
+    }
+
+    PCAPDL_VERBOS("%s: ok\r\n", __func__);
+    pcapdl_set_dbg_level(0);
+
+    return OK;
+}
+
+void pcapdl_stop(void)
+{
+    datalink_pcap_t *pcap;
+
+    list_for_each_entry(pcap, &all_pcap_list, pcap_list) {
+        pcapdl_port_unwatch(pcap);
+        if (pcap->out) {
+            fflush(pcap->out);
+        }
+    }
+}
+
+void pcapdl_clean(void)
+{
+    datalink_pcap_t *each;
+
+    while ((each = list_first_entry_or_null(&all_pcap_list, datalink_pcap_t, pcap_list))) {
+        list_del(&each->pcap_list);
+        pcapdl_port_free(each);
+    }
+
+    INIT_LIST_HEAD(&all_pcap_list);
+}
+
+void pcapdl_exit(void)
+{
+    pcapdl_stop();
+    pcapdl_clean();
+}
+
+void pcapdl_set_dbg_level(uint32_t level)
+{
+    pcapdl_dbg_verbos = level & DEBUG_LEVEL_VERBOS;
+    pcapdl_dbg_warn = level & DEBUG_LEVEL_WARN;
+    pcapdl_dbg_err = level & DEBUG_LEVEL_ERROR;
+}
+
+cJSON *pcapdl_get_status(cJSON *request)
+{
+    datalink_pcap_t *pcap;
+    cJSON *reply, *result, *port;
+
+    reply = cJSON_CreateObject();
+    if (reply == NULL) {
+        PCAPDL_ERROR("%s: create reply object failed\r\n", __func__);
+        return NULL;
+    }
+
+    result = cJSON_CreateArray();
+    if (result == NULL) {
+        PCAPDL_ERROR("%s: create result array failed\r\n", __func__);
+        cJSON_Delete(reply);
+        return NULL;
+    }
+    cJSON_AddItemToObject(reply, "result", result);
+
+    list_for_each_entry(pcap, &all_pcap_list, pcap_list) {
+        port = pcapdl_get_mib(&pcap->dl);
+        if (port == NULL) {
+            cJSON_Delete(reply);
+            return NULL;
+        }
+        cJSON_AddNumberToObject(port, "port_id", pcap->dl.port_id);
+        cJSON_AddItemToArray(result, port);
+    }
+
+    return reply;
+}
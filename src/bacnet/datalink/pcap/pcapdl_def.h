@@ -0,0 +1,93 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * pcapdl_def.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Pcap replay datalink internal header
+ *
+ * History
+ */
+
+#ifndef _PCAPDL_DEF_H_
+#define _PCAPDL_DEF_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "bacnet/pcapdl.h"
+#include "misc/trace.h"
+
+extern bool pcapdl_dbg_verbos;
+extern bool pcapdl_dbg_warn;
+extern bool pcapdl_dbg_err;
+
+#define PCAPDL_ERROR(fmt, args...)                  \
+do {                                                \
+    if (pcapdl_dbg_err) {                           \
+       TRACE_ERROR(fmt, ##args);                    \
+    }                                               \
+} while (0)
+
+#define PCAPDL_WARN(fmt, args...)                   \
+do {                                                \
+    if (pcapdl_dbg_warn) {                          \
+        TRACE_WARN(fmt, ##args);                    \
+    }                                               \
+} while (0)
+
+#define PCAPDL_VERBOS(fmt, args...)                 \
+do {                                                \
+    if (pcapdl_dbg_verbos) {                        \
+       TRACE_VERBOS(fmt, ##args);                   \
+    }                                               \
+} while (0)
+
+#define PCAP_MAGIC_USEC             (0xa1b2c3d4)
+#define PCAP_MAGIC_NSEC             (0xa1b23c4d)
+
+#define LINKTYPE_ETHERNET           (1)
+#define LINKTYPE_RAW                (101)
+#define LINKTYPE_LINUX_SLL          (113)
+#define LINKTYPE_IPV4               (228)
+
+#define PCAPDL_DEFAULT_UDP_PORT     (0xBAC0)
+#define PCAPDL_DEFAULT_START_DELAY  (100)
+
+/* frames injected in one timer callback before yielding */
+#define PCAPDL_RX_BUDGET            (256)
+
+#define ETH_TYPE_IPV4               (0x0800)
+#define ETH_TYPE_VLAN               (0x8100)
+#define ETH_HDR_LEN                 (14)
+#define SLL_HDR_LEN                 (16)
+#define IPV4_HDR_LEN                (20)
+#define UDP_HDR_LEN                 (8)
+#define BVLC_HDR_LEN                (4)
+#define LLC_HDR_LEN                 (3)
+#define ETH_MIN_FRAME               (60)
+
+#define BVLC_TYPE_BIP               (0x81)
+#define BVLC_FORWARDED_NPDU         (0x04)
+#define BVLC_ORIGINAL_UNICAST_NPDU  (0x0a)
+#define BVLC_ORIGINAL_BROADCAST_NPDU (0x0b)
+
+typedef struct pcap_file_hdr_s {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+} __attribute__((packed)) pcap_file_hdr_t;
+
+typedef struct pcap_rec_hdr_s {
+    uint32_t ts_sec;
+    uint32_t ts_frac;
+    uint32_t incl_len;
+    uint32_t orig_len;
+} __attribute__((packed)) pcap_rec_hdr_t;
+
+#endif /* _PCAPDL_DEF_H_ */
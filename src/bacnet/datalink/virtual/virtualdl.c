@@ -0,0 +1,888 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * virtualdl.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * In-process virtual datalink
+ *
+ * History
+ */
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "virtualdl_def.h"
+#include "bacnet/network.h"
+#include "debug.h"
+
+static struct list_head all_vdl_list;
+
+static LIST_HEAD(all_bus_list);
+static pthread_mutex_t bus_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread uint32_t vdl_rand_seed;
+
+bool vdl_dbg_verbos = true;
+bool vdl_dbg_warn = true;
+bool vdl_dbg_err = true;
+
+static uint64_t vdl_now_us(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t vdl_rand(void)
+{
+    uint32_t x;
+
+    x = vdl_rand_seed;
+    if (x == 0) {
+        x = (uint32_t)(uintptr_t)&vdl_rand_seed ^ (uint32_t)vdl_now_us();
+        if (x == 0) {
+            x = 0x9e3779b9;
+        }
+    }
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    vdl_rand_seed = x;
+
+    return x;
+}
+
+static vdl_bus_t *vdl_bus_get(const char *name)
+{
+    vdl_bus_t *bus;
+
+    list_for_each_entry(bus, &all_bus_list, bus_list) {
+        if (strcmp(bus->name, name) == 0) {
+            return bus;
+        }
+    }
+
+    bus = (vdl_bus_t *)malloc(sizeof(vdl_bus_t));
+    if (bus == NULL) {
+        VDL_ERROR("%s: malloc bus failed\r\n", __func__);
+        return NULL;
+    }
+    memset(bus, 0, sizeof(vdl_bus_t));
+
+    bus->members = (vdl_endpoint_t **)calloc(VDL_MAX_MAC + 1, sizeof(vdl_endpoint_t *));
+    bus->nodes = (vdl_endpoint_t **)calloc(VDL_MAX_MAC + 1, sizeof(vdl_endpoint_t *));
+    if ((bus->members == NULL) || (bus->nodes == NULL)) {
+        VDL_ERROR("%s: malloc bus table failed\r\n", __func__);
+        free(bus->members);
+        free(bus->nodes);
+        free(bus);
+        return NULL;
+    }
+
+    strncpy(bus->name, name, VDL_BUS_NAME_MAX - 1);
+    list_add_tail(&bus->bus_list, &all_bus_list);
+
+    return bus;
+}
+
+static void vdl_bus_put(vdl_bus_t *bus)
+{
+    if (bus->member_nums) {
+        return;
+    }
+
+    list_del(&bus->bus_list);
+    free(bus->members);
+    free(bus->nodes);
+    free(bus);
+}
+
+vdl_endpoint_t *vdl_endpoint_create(const char *bus_name, uint16_t mac, uint32_t ring_size)
+{
+    vdl_endpoint_t *ep;
+    vdl_bus_t *bus;
+    uint32_t size, i;
+
+    if ((bus_name == NULL) || (bus_name[0] == 0) || (strlen(bus_name) >= VDL_BUS_NAME_MAX)) {
+        VDL_ERROR("%s: invalid bus name\r\n", __func__);
+        return NULL;
+    }
+
+    if (mac > VDL_MAX_MAC) {
+        VDL_ERROR("%s: invalid mac(%d)\r\n", __func__, mac);
+        return NULL;
+    }
+
+    if ((ring_size < VDL_MIN_RING_SIZE) || (ring_size > VDL_MAX_RING_SIZE)) {
+        VDL_ERROR("%s: invalid ring size(%d)\r\n", __func__, ring_size);
+        return NULL;
+    }
+
+    for (size = VDL_MIN_RING_SIZE; size < ring_size; size <<= 1) {
+        ;
+    }
+
+    if (posix_memalign((void **)&ep, VDL_CACHELINE, sizeof(vdl_endpoint_t)) != 0) {
+        VDL_ERROR("%s: malloc endpoint failed\r\n", __func__);
+        return NULL;
+    }
+    memset(ep, 0, sizeof(vdl_endpoint_t));
+
+    ep->cells = (vdl_cell_t *)malloc(sizeof(vdl_cell_t) * size);
+    if (ep->cells == NULL) {
+        VDL_ERROR("%s: malloc ring(%d) failed\r\n", __func__, size);
+        goto out0;
+    }
+
+    for (i = 0; i < size; i++) {
+        ep->cells[i].seq = i;
+    }
+    ep->mask = size - 1;
+    ep->mac = mac;
+
+    ep->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ep->efd < 0) {
+        VDL_ERROR("%s: create eventfd failed cause %s\r\n", __func__, strerror(errno));
+        goto out1;
+    }
+
+    pthread_mutex_lock(&bus_mutex);
+
+    bus = vdl_bus_get(bus_name);
+    if (bus == NULL) {
+        pthread_mutex_unlock(&bus_mutex);
+        goto out2;
+    }
+
+    if (bus->nodes[mac] != NULL) {
+        VDL_ERROR("%s: mac(%d) already present on bus(%s)\r\n", __func__, mac, bus_name);
+        vdl_bus_put(bus);
+        pthread_mutex_unlock(&bus_mutex);
+        goto out2;
+    }
+
+    ep->bus = bus;
+    ep->member_idx = bus->member_nums;
+    bus->members[ep->member_idx] = ep;
+    __atomic_store_n(&bus->nodes[mac], ep, __ATOMIC_RELEASE);
+    __atomic_store_n(&bus->member_nums, bus->member_nums + 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&bus_mutex);
+
+    return ep;
+
+out2:
+    close(ep->efd);
+
+out1:
+    free(ep->cells);
+
+out0:
+    free(ep);
+
+    return NULL;
+}
+
+void vdl_endpoint_destroy(vdl_endpoint_t *ep)
+{
+    vdl_bus_t *bus;
+    vdl_endpoint_t *last;
+
+    if (ep == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&bus_mutex);
+
+    bus = ep->bus;
+    bus->nodes[ep->mac] = NULL;
+    last = bus->members[bus->member_nums - 1];
+    bus->members[ep->member_idx] = last;
+    last->member_idx = ep->member_idx;
+    bus->member_nums--;
+    vdl_bus_put(bus);
+
+    pthread_mutex_unlock(&bus_mutex);
+
+    close(ep->efd);
+    free(ep->cells);
+    free(ep);
+}
+
+void vdl_endpoint_set_profile(vdl_endpoint_t *ep, uint32_t latency_us, uint32_t loss_ppm)
+{
+    if (ep == NULL) {
+        return;
+    }
+
+    ep->latency_us = latency_us;
+    ep->loss_ppm = loss_ppm;
+}
+
+static void vdl_endpoint_kick(vdl_endpoint_t *ep)
+{
+    uint64_t one = 1;
+
+    if (__atomic_exchange_n(&ep->signaled, 1, __ATOMIC_SEQ_CST) == 0) {
+        if (write(ep->efd, &one, sizeof(one)) != sizeof(one)) {
+            VDL_ERROR("%s: write eventfd failed cause %s\r\n", __func__, strerror(errno));
+        }
+    }
+}
+
+static int vdl_ring_push(vdl_endpoint_t *ep, uint16_t src, const uint8_t *data, uint16_t len,
+            uint64_t now)
+{
+    vdl_cell_t *cell;
+    uint32_t pos, seq;
+    int32_t diff;
+
+    if (ep->loss_ppm && (vdl_rand() % 1000000 < ep->loss_ppm)) {
+        __atomic_add_fetch(&ep->drops, 1, __ATOMIC_RELAXED);
+        return OK;
+    }
+
+    pos = __atomic_load_n(&ep->enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = &ep->cells[pos & ep->mask];
+        seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ep->enqueue_pos, &pos, pos + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_add_fetch(&ep->drops, 1, __ATOMIC_RELAXED);
+            return -EPERM;
+        } else {
+            pos = __atomic_load_n(&ep->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->src = src;
+    cell->len = len;
+    cell->due = now + ep->latency_us;
+    memcpy(cell->data, data, len);
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+    vdl_endpoint_kick(ep);
+
+    return OK;
+}
+
+int vdl_endpoint_send(vdl_endpoint_t *ep, uint16_t dst, const uint8_t *data, uint16_t len)
+{
+    vdl_bus_t *bus;
+    vdl_endpoint_t *peer;
+    uint32_t nums, i;
+    uint64_t now;
+
+    if ((ep == NULL) || (data == NULL) || (len == 0) || (len > VDL_MAX_NPDU)) {
+        VDL_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    bus = ep->bus;
+    now = vdl_now_us();
+
+    if (dst != VDL_BROADCAST_MAC) {
+        peer = __atomic_load_n(&bus->nodes[dst], __ATOMIC_ACQUIRE);
+        if ((peer == NULL) || (peer == ep)) {
+            /* like a wire, frame to absent station just disappears */
+            VDL_VERBOS("%s: no station(%d) on bus(%s)\r\n", __func__, dst, bus->name);
+            return OK;
+        }
+
+        return vdl_ring_push(peer, ep->mac, data, len, now);
+    }
+
+    nums = __atomic_load_n(&bus->member_nums, __ATOMIC_ACQUIRE);
+    for (i = 0; i < nums; i++) {
+        peer = bus->members[i];
+        if (peer != ep) {
+            (void)vdl_ring_push(peer, ep->mac, data, len, now);
+        }
+    }
+
+    return OK;
+}
+
+int vdl_endpoint_recv(vdl_endpoint_t *ep, uint16_t *src, uint8_t *data, uint16_t size)
+{
+    vdl_cell_t *cell;
+    uint32_t pos, seq;
+    int len;
+
+    if ((ep == NULL) || (data == NULL)) {
+        VDL_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    pos = ep->dequeue_pos;
+    cell = &ep->cells[pos & ep->mask];
+    seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+    if ((int32_t)(seq - (pos + 1)) < 0) {
+        return 0;
+    }
+
+    if ((ep->latency_us) && (cell->due > vdl_now_us())) {
+        return 0;
+    }
+
+    len = cell->len;
+    if (len > size) {
+        VDL_ERROR("%s: frame(%d) larger than buffer(%d)\r\n", __func__, len, size);
+        len = -EPERM;
+    } else {
+        memcpy(data, cell->data, len);
+        if (src) {
+            *src = cell->src;
+        }
+    }
+
+    __atomic_store_n(&cell->seq, pos + ep->mask + 1, __ATOMIC_RELEASE);
+    ep->dequeue_pos = pos + 1;
+
+    return len;
+}
+
+int64_t vdl_endpoint_next_due(vdl_endpoint_t *ep)
+{
+    vdl_cell_t *cell;
+    uint32_t pos, seq;
+    uint64_t now;
+
+    if (ep == NULL) {
+        return -1;
+    }
+
+    pos = ep->dequeue_pos;
+    cell = &ep->cells[pos & ep->mask];
+    seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+    if ((int32_t)(seq - (pos + 1)) < 0) {
+        return -1;
+    }
+
+    if (ep->latency_us == 0) {
+        return 0;
+    }
+
+    now = vdl_now_us();
+
+    return (cell->due > now)? (int64_t)(cell->due - now): 0;
+}
+
+int vdl_endpoint_fd(vdl_endpoint_t *ep)
+{
+    if (ep == NULL) {
+        return -EINVAL;
+    }
+
+    return ep->efd;
+}
+
+void vdl_endpoint_ack(vdl_endpoint_t *ep)
+{
+    uint64_t value;
+
+    if (ep == NULL) {
+        return;
+    }
+
+    (void)read(ep->efd, &value, sizeof(value));
+    __atomic_store_n(&ep->signaled, 0, __ATOMIC_SEQ_CST);
+}
+
+uint16_t vdl_endpoint_mac(vdl_endpoint_t *ep)
+{
+    return ep->mac;
+}
+
+uint32_t vdl_endpoint_drops(vdl_endpoint_t *ep)
+{
+    return __atomic_load_n(&ep->drops, __ATOMIC_RELAXED);
+}
+
+static void vdl_port_arm_timer(datalink_vdl_t *vdl, int64_t due_us)
+{
+    struct itimerspec its = {};
+
+    its.it_value.tv_sec = due_us / 1000000;
+    its.it_value.tv_nsec = (due_us % 1000000) * 1000;
+    if ((its.it_value.tv_sec == 0) && (its.it_value.tv_nsec == 0)) {
+        its.it_value.tv_nsec = 1000;
+    }
+
+    if (timerfd_settime(vdl->timer_fd, 0, &its, NULL) < 0) {
+        VDL_ERROR("%s: timerfd_settime failed cause %s\r\n", __func__, strerror(errno));
+    }
+}
+
+static void vdl_port_drain(datalink_vdl_t *vdl)
+{
+    DECLARE_BACNET_BUF(rx, VDL_MAX_NPDU);
+    bacnet_addr_t src_mac;
+    uint16_t src;
+    int64_t due;
+    int budget;
+    int rv;
+
+    for (budget = VDL_RX_BUDGET; budget > 0; budget--) {
+        (void)bacnet_buf_init(&rx.buf, VDL_MAX_NPDU);
+        rv = vdl_endpoint_recv(vdl->ep, &src, rx.buf.data, VDL_MAX_NPDU);
+        if (rv == 0) {
+            break;
+        }
+
+        vdl->dl.rx_all++;
+        if (rv < 0) {
+            continue;
+        }
+
+        src_mac.net = 0;
+        src_mac.len = VDL_MAC_LEN;
+        src_mac.adr[0] = src >> 8;
+        src_mac.adr[1] = src & 0xff;
+        rx.buf.data_len = rv;
+
+        vdl->dl.rx_ok++;
+        VDL_VERBOS("%s: received a pdu from(%d), length(%d)\r\n", __func__, src, rv);
+        (void)network_receive_pdu(vdl->dl.port_id, &rx.buf, &src_mac);
+    }
+
+    if (budget == 0) {
+        /* let other watches run, come back on next loop */
+        vdl_endpoint_kick(vdl->ep);
+        return;
+    }
+
+    due = vdl_endpoint_next_due(vdl->ep);
+    if (due > 0) {
+        vdl_port_arm_timer(vdl, due);
+    }
+}
+
+static void vdl_event_handler(el_watch_t *watch, int events)
+{
+    datalink_vdl_t *vdl;
+
+    if (!(events & EPOLLIN)) {
+        VDL_ERROR("%s: invalid events\r\n", __func__);
+        return;
+    }
+
+    vdl = (datalink_vdl_t *)watch->data;
+    if (!vdl) {
+        VDL_ERROR("%s: null vdl argument\r\n", __func__);
+        return;
+    }
+
+    vdl_endpoint_ack(vdl->ep);
+    vdl_port_drain(vdl);
+}
+
+static void vdl_timer_handler(el_watch_t *watch, int events)
+{
+    datalink_vdl_t *vdl;
+    uint64_t expired;
+
+    vdl = (datalink_vdl_t *)watch->data;
+    if (!vdl) {
+        VDL_ERROR("%s: null vdl argument\r\n", __func__);
+        return;
+    }
+
+    (void)read(vdl->timer_fd, &expired, sizeof(expired));
+    vdl_port_drain(vdl);
+}
+
+/**
+ * vdl_send_pdu - virtual port send
+ *
+ * @vdl: port
+ * @dst_mac: destination, NULL or len 0 means local broadcast
+ * @npdu: npdu to send
+ * @prio: ignored
+ * @der: ignored
+ *
+ * @return: 0 if success, negative if fail
+ *
+ */
+static int vdl_send_pdu(datalink_vdl_t *vdl, bacnet_addr_t *dst_mac, bacnet_buf_t *npdu,
+            __attribute__ ((unused))bacnet_prio_t prio, __attribute__ ((unused))bool der)
+{
+    uint16_t dst;
+    int rv;
+
+    if (!vdl) {
+        VDL_ERROR("%s: null port\r\n", __func__);
+        return -EINVAL;
+    }
+
+    vdl->dl.tx_all++;
+
+    if ((npdu == NULL) || (npdu->data == NULL) || (npdu->data_len == 0)
+            || (npdu->data_len > VDL_MAX_NPDU)) {
+        VDL_ERROR("%s: invalid npdu\r\n", __func__);
+        return -EINVAL;
+    }
+
+    if ((dst_mac == NULL) || (dst_mac->len == 0)) {
+        dst = VDL_BROADCAST_MAC;
+    } else if (dst_mac->len == VDL_MAC_LEN) {
+        dst = ((uint16_t)dst_mac->adr[0] << 8) | dst_mac->adr[1];
+        if (dst == VDL_BROADCAST_MAC) {
+            VDL_ERROR("%s: unicast to broadcast address\r\n", __func__);
+            return -EINVAL;
+        }
+    } else {
+        VDL_ERROR("%s: invalid dst mac len(%d)\r\n", __func__, dst_mac->len);
+        return -EINVAL;
+    }
+
+    rv = vdl_endpoint_send(vdl->ep, dst, npdu->data, npdu->data_len);
+    if (rv < 0) {
+        VDL_WARN("%s: send to(%d) failed(%d)\r\n", __func__, dst, rv);
+        return rv;
+    }
+
+    vdl->dl.tx_ok++;
+
+    return OK;
+}
+
+static cJSON *vdl_get_mib(datalink_base_t *dl_port)
+{
+    datalink_vdl_t *vdl;
+    cJSON *result;
+
+    result = datalink_get_mib(dl_port);
+    if (result == NULL) {
+        VDL_ERROR("%s: datalink_get_mib failed\r\n", __func__);
+        return NULL;
+    }
+
+    vdl = (datalink_vdl_t *)dl_port;
+    cJSON_AddStringToObject(result, "bus", vdl->ep->bus->name);
+    cJSON_AddNumberToObject(result, "mac", vdl->ep->mac);
+    cJSON_AddNumberToObject(result, "latency_us", vdl->ep->latency_us);
+    cJSON_AddNumberToObject(result, "loss_ppm", vdl->ep->loss_ppm);
+    cJSON_AddNumberToObject(result, "rx_drops", vdl_endpoint_drops(vdl->ep));
+    cJSON_AddNumberToObject(result, "rx_queue",
+        __atomic_load_n(&vdl->ep->enqueue_pos, __ATOMIC_RELAXED) - vdl->ep->dequeue_pos);
+
+    return result;
+}
+
+static int vdl_cfg_get_number(cJSON *cfg, const char *name, uint32_t min, uint32_t max,
+            uint32_t *value)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, name);
+    if (tmp == NULL) {
+        return OK;
+    }
+
+    if ((tmp->type != cJSON_Number) || (tmp->valueint < (int)min)
+            || ((uint32_t)tmp->valueint > max)) {
+        VDL_ERROR("%s: invalid %s item\r\n", __func__, name);
+        return -EINVAL;
+    }
+
+    *value = (uint32_t)tmp->valueint;
+    cJSON_DeleteItemFromObject(cfg, name);
+
+    return OK;
+}
+
+/**
+ * vdl_port_create - create virtual port
+ *
+ * @cfg: port config
+ * @res: resource config
+ *
+ * @return: port object if success, NULL if fail
+ *
+ */
+datalink_vdl_t *vdl_port_create(cJSON *cfg, cJSON *res)
+{
+    datalink_vdl_t *vdl;
+    cJSON *tmp;
+    const char *ifname, *res_type;
+    uint32_t mac, ring_size, latency_us, loss_ppm;
+
+    if (cfg == NULL || res == NULL) {
+        VDL_ERROR("%s: null argument\r\n", __func__);
+        return NULL;
+    }
+
+    cfg = cJSON_Duplicate(cfg, true);
+    if (cfg == NULL) {
+        VDL_ERROR("%s: cjson duplicate failed\r\n", __func__);
+        return NULL;
+    }
+
+    vdl = (datalink_vdl_t *)malloc(sizeof(datalink_vdl_t));
+    if (!vdl) {
+        VDL_ERROR("%s: malloc datalink_vdl_t failed\r\n", __func__);
+        goto out0;
+    }
+    memset(vdl, 0, sizeof(datalink_vdl_t));
+
+    vdl->dl.send_pdu = (int(*)(datalink_base_t *, bacnet_addr_t *, bacnet_buf_t *, bacnet_prio_t,
+        bool))vdl_send_pdu;
+    vdl->dl.get_port_mib = vdl_get_mib;
+    vdl->dl.max_npdu_len = VDL_MAX_NPDU;
+
+    tmp = cJSON_GetObjectItem(cfg, "resource_name");
+    if ((!tmp) || (tmp->type != cJSON_String)) {
+        VDL_ERROR("%s: get resource_name item failed\r\n", __func__);
+        goto out1;
+    }
+
+    res_type = datalink_get_type_by_resource_name(res, tmp->valuestring);
+    if (res_type == NULL) {
+        VDL_ERROR("%s: get resource type failed by name: %s\r\n", __func__, tmp->valuestring);
+        goto out1;
+    }
+
+    if (strcmp(res_type, "VIRTUAL")) {
+        VDL_ERROR("%s: resource type is not VIRTUAL: %s\r\n", __func__, res_type);
+        goto out1;
+    }
+
+    ifname = datalink_get_ifname_by_resource_name(res, tmp->valuestring);
+    if (ifname == NULL) {
+        VDL_ERROR("%s: get ifname by resource name:%s failed\r\n", __func__, tmp->valuestring);
+        goto out1;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "mac");
+    if ((tmp == NULL) || (tmp->type != cJSON_Number) || (tmp->valueint < 0)
+            || (tmp->valueint > VDL_MAX_MAC)) {
+        VDL_ERROR("%s: get mac item failed\r\n", __func__);
+        goto out1;
+    }
+    mac = tmp->valueint;
+
+    ring_size = VDL_DEFAULT_RING_SIZE;
+    latency_us = 0;
+    loss_ppm = 0;
+    if ((vdl_cfg_get_number(cfg, "ring_size", VDL_MIN_RING_SIZE, VDL_MAX_RING_SIZE, &ring_size) < 0)
+            || (vdl_cfg_get_number(cfg, "latency_us", 0, 10000000, &latency_us) < 0)
+            || (vdl_cfg_get_number(cfg, "loss_ppm", 0, 1000000, &loss_ppm) < 0)) {
+        goto out1;
+    }
+
+    vdl->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (vdl->timer_fd < 0) {
+        VDL_ERROR("%s: create timerfd failed cause %s\r\n", __func__, strerror(errno));
+        goto out1;
+    }
+
+    vdl->ep = vdl_endpoint_create(ifname, (uint16_t)mac, ring_size);
+    if (vdl->ep == NULL) {
+        VDL_ERROR("%s: attach mac(%d) to bus(%s) failed\r\n", __func__, mac, ifname);
+        goto out2;
+    }
+    vdl_endpoint_set_profile(vdl->ep, latency_us, loss_ppm);
+
+    cJSON_DeleteItemFromObject(cfg, "resource_name");
+    cJSON_DeleteItemFromObject(cfg, "mac");
+
+    list_add_tail(&(vdl->vdl_list), &all_vdl_list);
+
+    cJSON *child = cfg->child;
+    while (child) {
+        VDL_WARN("%s: unknown cfg item: %s\r\n", __func__, child->string);
+        child = child->next;
+    }
+
+    cJSON_Delete(cfg);
+
+    return vdl;
+
+out2:
+    close(vdl->timer_fd);
+
+out1:
+    free(vdl);
+
+out0:
+    cJSON_Delete(cfg);
+
+    return NULL;
+}
+
+static void vdl_port_unwatch(datalink_vdl_t *vdl)
+{
+    if (vdl->watch != NULL) {
+        (void)el_watch_destroy(&el_default_loop, vdl->watch);
+        vdl->watch = NULL;
+    }
+
+    if (vdl->timer_watch != NULL) {
+        (void)el_watch_destroy(&el_default_loop, vdl->timer_watch);
+        vdl->timer_watch = NULL;
+    }
+}
+
+int vdl_port_delete(datalink_vdl_t *vdl_port)
+{
+    if (vdl_port == NULL) {
+        VDL_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    list_del(&vdl_port->vdl_list);
+
+    vdl_port_unwatch(vdl_port);
+    vdl_endpoint_destroy(vdl_port->ep);
+    close(vdl_port->timer_fd);
+
+    free(vdl_port);
+
+    return OK;
+}
+
+datalink_vdl_t *vdl_next_port(datalink_vdl_t *prev)
+{
+    if (!prev) {
+        if (list_empty(&all_vdl_list)) {
+            return NULL;
+        }
+        return list_first_entry(&all_vdl_list, datalink_vdl_t, vdl_list);
+    }
+
+    if (prev->vdl_list.next != &all_vdl_list) {
+        return list_next_entry(prev, vdl_list);
+    } else {
+        return NULL;
+    }
+}
+
+int vdl_init(void)
+{
+    INIT_LIST_HEAD(&all_vdl_list);
+    return OK;
+}
+
+int vdl_startup(void)
+{
+    datalink_vdl_t *vdl, *vdl_todel;
+
+    list_for_each_entry(vdl, &all_vdl_list, vdl_list) {
+        vdl->dl.tx_all = 0;
+        vdl->dl.tx_ok = 0;
+        vdl->dl.rx_all = 0;
+        vdl->dl.rx_ok = 0;
+
+        vdl->watch = el_watch_create(&el_default_loop, vdl_endpoint_fd(vdl->ep), EPOLLIN);
+        vdl->timer_watch = el_watch_create(&el_default_loop, vdl->timer_fd, EPOLLIN);
+        if ((vdl->watch == NULL) || (vdl->timer_watch == NULL)) {
+            VDL_ERROR("%s: event watch create failed\r\n", __func__);
+            vdl_port_unwatch(vdl);
+            list_for_each_entry(vdl_todel, &all_vdl_list, vdl_list) {
+                if (vdl_todel == vdl) {
+                    break;
+                }
+                vdl_port_unwatch(vdl_todel);
+            }
+            return -EPERM;
+        }
+        vdl->watch->handler = vdl_event_handler;
+        vdl->watch->data = vdl;
+        vdl->timer_watch->handler = vdl_timer_handler;
+        vdl->timer_watch->data = vdl;
+
+        /* frames may be queued before startup */
+        vdl_endpoint_kick(vdl->ep);
+    }
+
+    VDL_VERBOS("%s: ok\r\n", __func__);
+    vdl_set_dbg_level(0);
+
+    return OK;
+}
+
+void vdl_stop(void)
+{
+    datalink_vdl_t *vdl;
+
+    list_for_each_entry(vdl, &all_vdl_list, vdl_list) {
+        vdl_port_unwatch(vdl);
+    }
+}
+
+void vdl_clean(void)
+{
+    datalink_vdl_t *each;
+
+    while ((each = list_first_entry_or_null(&all_vdl_list, datalink_vdl_t, vdl_list))) {
+        list_del(&each->vdl_list);
+
+        vdl_endpoint_destroy(each->ep);
+        close(each->timer_fd);
+
+        free(each);
+    }
+
+    INIT_LIST_HEAD(&all_vdl_list);
+}
+
+void vdl_exit(void)
+{
+    vdl_stop();
+    vdl_clean();
+}
+
+void vdl_set_dbg_level(uint32_t level)
+{
+    vdl_dbg_verbos = level & DEBUG_LEVEL_VERBOS;
+    vdl_dbg_warn = level & DEBUG_LEVEL_WARN;
+    vdl_dbg_err = level & DEBUG_LEVEL_ERROR;
+}
+
+cJSON *vdl_get_status(cJSON *request)
+{
+    datalink_vdl_t *vdl;
+    cJSON *reply, *result, *port;
+
+    reply = cJSON_CreateObject();
+    if (reply == NULL) {
+        VDL_ERROR("%s: create reply object failed\r\n", __func__);
+        return NULL;
+    }
+
+    result = cJSON_CreateArray();
+    if (result == NULL) {
+        VDL_ERROR("%s: create result array failed\r\n", __func__);
+        cJSON_Delete(reply);
+        return NULL;
+    }
+    cJSON_AddItemToObject(reply, "result", result);
+
+    list_for_each_entry(vdl, &all_vdl_list, vdl_list) {
+        port = vdl_get_mib(&vdl->dl);
+        if (port == NULL) {
+            cJSON_Delete(reply);
+            return NULL;
+        }
+        cJSON_AddNumberToObject(port, "port_id", vdl->dl.port_id);
+        cJSON_AddItemToArray(result, port);
+    }
+
+    return reply;
+}
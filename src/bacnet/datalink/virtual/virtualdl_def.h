@@ -0,0 +1,93 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * virtualdl_def.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Virtual datalink internal header
+ *
+ * History
+ */
+
+#ifndef _VIRTUALDL_DEF_H_
+#define _VIRTUALDL_DEF_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "bacnet/virtualdl.h"
+#include "misc/trace.h"
+
+extern bool vdl_dbg_verbos;
+extern bool vdl_dbg_warn;
+extern bool vdl_dbg_err;
+
+#define VDL_ERROR(fmt, args...)                     \
+do {                                                \
+    if (vdl_dbg_err) {                              \
+       TRACE_ERROR(fmt, ##args);                    \
+    }                                               \
+} while (0)
+
+#define VDL_WARN(fmt, args...)                      \
+do {                                                \
+    if (vdl_dbg_warn) {                             \
+        TRACE_WARN(fmt, ##args);                    \
+    }                                               \
+} while (0)
+
+#define VDL_VERBOS(fmt, args...)                    \
+do {                                                \
+    if (vdl_dbg_verbos) {                           \
+       TRACE_VERBOS(fmt, ##args);                   \
+    }                                               \
+} while (0)
+
+#define VDL_DEFAULT_RING_SIZE       (256)
+#define VDL_MIN_RING_SIZE           (4)
+#define VDL_MAX_RING_SIZE           (65536)
+
+/* frames handled in one event loop callback before yielding */
+#define VDL_RX_BUDGET               (64)
+
+#define VDL_CACHELINE               (64)
+
+typedef struct vdl_cell_s {
+    uint32_t seq;
+    uint16_t src;
+    uint16_t len;
+    uint64_t due;                           /* monotonic us */
+    uint8_t data[VDL_MAX_NPDU];
+} vdl_cell_t;
+
+typedef struct vdl_bus_s {
+    struct list_head bus_list;
+    char name[VDL_BUS_NAME_MAX];
+    uint32_t member_nums;
+    vdl_endpoint_t **members;               /* dense list for broadcast fan-out */
+    vdl_endpoint_t **nodes;                 /* indexed by mac */
+} vdl_bus_t;
+
+/*
+ * Every endpoint owns a bounded MPSC ring. Any thread may push to it, only
+ * the owner pops. Slot sequence numbers publish the payload, so neither side
+ * takes a lock on the data path.
+ */
+struct vdl_endpoint_s {
+    vdl_bus_t *bus;
+    uint16_t mac;
+    uint32_t member_idx;
+    int efd;
+    uint32_t latency_us;
+    uint32_t loss_ppm;
+    uint32_t drops;
+    uint32_t signaled;
+    uint32_t mask;
+    vdl_cell_t *cells;
+    uint32_t enqueue_pos __attribute__((aligned(VDL_CACHELINE)));
+    uint32_t dequeue_pos __attribute__((aligned(VDL_CACHELINE)));
+};
+
+#endif /* _VIRTUALDL_DEF_H_ */
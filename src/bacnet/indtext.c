@@ -10,9 +10,21 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <errno.h>
 
 #include "bacnet/indtext.h"
 
+struct indtext_index_s {
+    uint32_t size;                      /* dense range, highest index + 1 */
+    uint32_t hash_mask;
+    const char **by_index;
+    INDTEXT_DATA **by_name;             /* open addressing, NULL is empty */
+};
+
 const char *indtext_by_index_default(INDTEXT_DATA *data_list, uint32_t index, 
                 const char *default_string)
 {
@@ -42,3 +54,140 @@ const char *indtext_by_index_split_default(INDTEXT_DATA *data_list, uint32_t ind
     }
 }
 
+/* FNV-1a over the lower-cased name */
+static uint32_t indtext_name_hash(const char *name)
+{
+    uint32_t hash;
+
+    hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)tolower((uint8_t)*name++);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static indtext_index_t *indtext_index_build(indtext_table_t *table)
+{
+    indtext_index_t *index, *old;
+    INDTEXT_DATA *data;
+    uint32_t count, size, hash_size, slot;
+
+    count = 0;
+    size = 0;
+    for (data = table->data_list; data->pString; data++) {
+        count++;
+        if ((data->index < INDTEXT_DENSE_MAX) && (data->index >= size)) {
+            size = data->index + 1;
+        }
+    }
+
+    hash_size = 1;
+    while (hash_size < count * 2) {
+        hash_size <<= 1;
+    }
+
+    index = (indtext_index_t *)malloc(sizeof(indtext_index_t)
+        + size * sizeof(const char *) + hash_size * sizeof(INDTEXT_DATA *));
+    if (index == NULL) {
+        return NULL;
+    }
+
+    index->size = size;
+    index->hash_mask = hash_size - 1;
+    index->by_index = (const char **)(index + 1);
+    index->by_name = (INDTEXT_DATA **)(index->by_index + size);
+
+    for (slot = 0; slot < size; slot++) {
+        index->by_index[slot] = (slot < table->split_index)? table->before_split_default_name:
+            table->default_name;
+    }
+    memset(index->by_name, 0, hash_size * sizeof(INDTEXT_DATA *));
+
+    /* walk backwards so the first entry of a duplicated index or name wins */
+    for (data = table->data_list + count; data-- != table->data_list; ) {
+        if (data->index < size) {
+            index->by_index[data->index] = data->pString;
+        }
+    }
+
+    for (data = table->data_list; data->pString; data++) {
+        slot = indtext_name_hash(data->pString) & index->hash_mask;
+        while (index->by_name[slot]) {
+            if (strcasecmp(index->by_name[slot]->pString, data->pString) == 0) {
+                break;
+            }
+            slot = (slot + 1) & index->hash_mask;
+        }
+        if (index->by_name[slot] == NULL) {
+            index->by_name[slot] = data;
+        }
+    }
+
+    /* two threads may race to build, the loser frees its copy */
+    old = NULL;
+    if (!__atomic_compare_exchange_n(&table->index, &old, index, false, __ATOMIC_ACQ_REL,
+            __ATOMIC_ACQUIRE)) {
+        free(index);
+        index = old;
+    }
+
+    return index;
+}
+
+static inline indtext_index_t *indtext_index_get(indtext_table_t *table)
+{
+    indtext_index_t *index;
+
+    index = __atomic_load_n(&table->index, __ATOMIC_ACQUIRE);
+    if (__builtin_expect(index == NULL, 0)) {
+        index = indtext_index_build(table);
+    }
+
+    return index;
+}
+
+const char *indtext_table_name(indtext_table_t *table, uint32_t index)
+{
+    indtext_index_t *dense;
+
+    dense = indtext_index_get(table);
+    if ((dense == NULL) || (index >= dense->size)) {
+        return indtext_by_index_split_default(table->data_list, index, table->split_index,
+            table->before_split_default_name, table->default_name);
+    }
+
+    return dense->by_index[index];
+}
+
+int indtext_table_index(indtext_table_t *table, const char *name)
+{
+    indtext_index_t *dense;
+    INDTEXT_DATA *data;
+    uint32_t slot;
+
+    if ((table == NULL) || (name == NULL)) {
+        return -EINVAL;
+    }
+
+    dense = indtext_index_get(table);
+    if (dense == NULL) {
+        for (data = table->data_list; data->pString; data++) {
+            if (strcasecmp(data->pString, name) == 0) {
+                return data->index;
+            }
+        }
+        return -EPERM;
+    }
+
+    slot = indtext_name_hash(name) & dense->hash_mask;
+    while ((data = dense->by_name[slot]) != NULL) {
+        if (strcasecmp(data->pString, name) == 0) {
+            return data->index;
+        }
+        slot = (slot + 1) & dense->hash_mask;
+    }
+
+    return -EPERM;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * dupcache.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Duplicate suppression of global broadcast. Redundant paths and several
+ * BBMDs deliver the same global broadcast more than once; every copy would
+ * otherwise be rebroadcast out of every port. Only the relay is suppressed,
+ * every copy still reaches the local application, since a repeated Who-Is
+ * may as well be a retry that deserves an answer.
+ *
+ * History
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "dupcache.h"
+#include "network_def.h"
+#include "misc/eventloop.h"
+
+static pthread_mutex_t dup_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static dup_entry_t *dup_table = NULL;
+
+static uint32_t dup_mask;
+
+static uint32_t dup_window = DUP_CACHE_DEFAULT_WINDOW;
+
+/* FNV-1a */
+static uint64_t dup_hash(const bacnet_addr_t *src, const uint8_t *data, uint32_t len)
+{
+    uint64_t hash;
+    uint32_t i;
+
+    hash = 0xcbf29ce484222325ULL;
+    hash = (hash ^ (src->net & 0xFF)) * 0x100000001b3ULL;
+    hash = (hash ^ (src->net >> 8)) * 0x100000001b3ULL;
+    for (i = 0; i < src->len; i++) {
+        hash = (hash ^ src->adr[i]) * 0x100000001b3ULL;
+    }
+
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+static bool dup_addr_equal(const bacnet_addr_t *a, const bacnet_addr_t *b)
+{
+    return (a->net == b->net) && (a->len == b->len) && !memcmp(a->adr, b->adr, a->len);
+}
+
+bool dup_cache_check(bacnet_port_t *in_port, bacnet_addr_t *src_mac, bacnet_buf_t *npdu,
+        npci_info_t *npci_info)
+{
+    dup_entry_t *entry, *victim;
+    bacnet_addr_t *src;
+    uint64_t hash;
+    uint32_t now, age, max_age;
+    uint16_t len;
+    bool victim_free;
+    int i;
+
+    if (dup_table == NULL) {
+        return false;
+    }
+
+    /* Ѿ·ıSNET/SADRΪԴmacΪԴ */
+    src = (npci_info->src.net != 0)? &npci_info->src: src_mac;
+    len = npdu->data_len - npci_info->nud_offset;
+    hash = dup_hash(src, &npdu->data[npci_info->nud_offset], len);
+    now = el_current_millisecond();
+
+    pthread_mutex_lock(&dup_lock);
+
+    if (dup_table == NULL) {
+        pthread_mutex_unlock(&dup_lock);
+        return false;
+    }
+
+    victim = NULL;
+    victim_free = false;
+    max_age = 0;
+    for (i = 0; i < DUP_CACHE_PROBE_LIMIT; i++) {
+        entry = &dup_table[((uint32_t)hash + i) & dup_mask];
+        age = now - entry->stamp;
+        if (!entry->used || (age >= dup_window)) {
+            if (!victim_free) {
+                victim = entry;
+                victim_free = true;
+            }
+            continue;
+        }
+
+        if ((entry->hash == hash) && (entry->len == len) && dup_addr_equal(&entry->src, src)) {
+            in_port->bcast_suppressed++;
+            pthread_mutex_unlock(&dup_lock);
+            NETWORK_VERBOS("%s: drop duplicated global broadcast on port(%d)\r\n", __func__,
+                in_port->id);
+            return true;
+        }
+
+        if (!victim_free && ((victim == NULL) || (age > max_age))) {
+            victim = entry;
+            max_age = age;
+        }
+    }
+
+    victim->used = true;
+    victim->hash = hash;
+    victim->len = len;
+    victim->stamp = now;
+    victim->src.net = src->net;
+    victim->src.len = src->len;
+    memcpy(victim->src.adr, src->adr, src->len);
+
+    pthread_mutex_unlock(&dup_lock);
+
+    return false;
+}
+
+int dup_cache_init(cJSON *cfg, bool relay)
+{
+    cJSON *tmp;
+    uint32_t size;
+    bool enable;
+
+    if (dup_table != NULL) {
+        NETWORK_WARN("%s: already inited\r\n", __func__);
+        return OK;
+    }
+
+    enable = true;
+    size = DUP_CACHE_DEFAULT_SIZE;
+    dup_window = DUP_CACHE_DEFAULT_WINDOW;
+
+    if (cfg == NULL) {
+        goto out;
+    }
+
+    if (cfg->type != cJSON_Object) {
+        NETWORK_ERROR("%s: broadcast_dedup should be object\r\n", __func__);
+        return -EPERM;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "enable");
+    if (tmp) {
+        if ((tmp->type != cJSON_True) && (tmp->type != cJSON_False)) {
+            NETWORK_ERROR("%s: enable should be boolean\r\n", __func__);
+            return -EPERM;
+        }
+        enable = (tmp->type == cJSON_True);
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "window");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint <= 0)
+                || (tmp->valueint > DUP_CACHE_MAX_WINDOW)) {
+            NETWORK_ERROR("%s: window should be 1~%d ms\r\n", __func__, DUP_CACHE_MAX_WINDOW);
+            return -EPERM;
+        }
+        dup_window = (uint32_t)tmp->valueint;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "size");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint < DUP_CACHE_MIN_SIZE)
+                || (tmp->valueint > DUP_CACHE_MAX_SIZE)) {
+            NETWORK_ERROR("%s: size should be %d~%d\r\n", __func__, DUP_CACHE_MIN_SIZE,
+                DUP_CACHE_MAX_SIZE);
+            return -EPERM;
+        }
+        size = (uint32_t)tmp->valueint;
+    }
+
+out:
+    if (!enable || !relay) {
+        return OK;
+    }
+
+    /* ȡΪ2 */
+    dup_mask = DUP_CACHE_MIN_SIZE - 1;
+    while (dup_mask + 1 < size) {
+        dup_mask = (dup_mask << 1) | 1;
+    }
+
+    dup_table = (dup_entry_t *)calloc(dup_mask + 1, sizeof(dup_entry_t));
+    if (dup_table == NULL) {
+        NETWORK_ERROR("%s: calloc failed\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    return OK;
+}
+
+void dup_cache_exit(void)
+{
+    pthread_mutex_lock(&dup_lock);
+
+    free(dup_table);
+    dup_table = NULL;
+
+    pthread_mutex_unlock(&dup_lock);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * dupcache.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * ȫֹ㲥ȥػ
+ *
+ * History
+ */
+
+#ifndef _DUPCACHE_H_
+#define _DUPCACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "route.h"
+#include "npdu.h"
+#include "misc/cJSON.h"
+
+#define DUP_CACHE_DEFAULT_WINDOW                (500)
+#define DUP_CACHE_MAX_WINDOW                    (60000)
+
+#define DUP_CACHE_DEFAULT_SIZE                  (1024)
+#define DUP_CACHE_MIN_SIZE                      (64)
+#define DUP_CACHE_MAX_SIZE                      (65536)
+
+/* Ѱַ̽ⳤ */
+#define DUP_CACHE_PROBE_LIMIT                   (8)
+
+/* ָ: Դַ + ݶ(NPCI仯)Ĺϣ */
+typedef struct dup_entry_s {
+    uint64_t hash;
+    uint32_t stamp;                         /* һյʱ(ms) */
+    uint16_t len;                           /* ݶγ */
+    bool used;
+    bacnet_addr_t src;
+} dup_entry_t;
+
+/**
+ * dup_cache_init - the cache is only allocated for a router, a single port never relays
+ *
+ * @cfg: broadcast_dedup cfg, NULL for defaults
+ * @relay: true if more than one port is configured
+ */
+extern int dup_cache_init(cJSON *cfg, bool relay);
+
+extern void dup_cache_exit(void);
+
+/**
+ * dup_cache_check - ȫֹ㲥ʱ䴰Ƿյ
+ *
+ * @return: trueʾظģӦ
+ */
+extern bool dup_cache_check(bacnet_port_t *in_port, bacnet_addr_t *src_mac, bacnet_buf_t *npdu,
+            npci_info_t *npci_info);
+
+#endif /* _DUPCACHE_H_ */
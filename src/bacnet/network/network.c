@@ -23,6 +23,7 @@
 #include "npdu.h"
 #include "route.h"
 #include "protocol.h"
+#include "dupcache.h"
 #include "network_def.h"
 #include "misc/eventloop.h"
 #include "bacnet/mstp.h"
@@ -30,9 +31,14 @@
 #include "module_mng.h"
 #include "bacnet/bacnet.h"
 #include "debug.h"
+#include "misc/perfstat.h"
 
 static bool network_init_status = false;
 
+static network_port_perf_t network_port_perf[NETWORK_PERF_MAX_PORT];
+
+static int network_relay_perf;
+
 bool network_dbg_err = true;
 bool network_dbg_warn = true;
 bool network_dbg_verbos = true;
@@ -40,6 +46,27 @@ bool network_dbg_verbos = true;
 extern int route_port_nums;
 extern bool is_bacnet_router;
 
+static network_port_perf_t *network_get_port_perf(uint32_t port_id)
+{
+    static network_port_perf_t overflow;
+    network_port_perf_t *perf;
+
+    if (port_id >= NETWORK_PERF_MAX_PORT) {
+        return &overflow;
+    }
+
+    perf = &network_port_perf[port_id];
+    if (perf->rx == PERF_INVALID_ID) {
+        perf->rx_network_msg = perf_counter_register("port%u.rx_network_msg", port_id);
+        perf->rx_apdu = perf_counter_register("port%u.rx_apdu", port_id);
+        perf->relay = perf_counter_register("port%u.relay", port_id);
+        perf->relay_fail = perf_counter_register("port%u.relay_fail", port_id);
+        perf->rx = perf_counter_register("port%u.rx", port_id);
+    }
+
+    return perf;
+}
+
 static int _buf_push_pci(bacnet_buf_t *pdu, npci_info_t *pci)
 {
     int rv;
@@ -125,8 +152,8 @@ static int network_apdu_handler(bacnet_port_t *in_port, bacnet_addr_t *src_mac,
  * @return: ɹ0ʧܷظ
  *
  */
-int network_relay_handler(bacnet_port_t *in_port, bacnet_addr_t *src_addr, bacnet_buf_t *npdu, 
-        npci_info_t *npci_info)
+static int __network_relay_handler(bacnet_port_t *in_port, bacnet_addr_t *src_addr,
+            bacnet_buf_t *npdu, npci_info_t *npci_info)
 {
     route_entry_t entry;
     bacnet_port_t *out_port;
@@ -149,6 +176,13 @@ int network_relay_handler(bacnet_port_t *in_port, bacnet_addr_t *src_addr, bacne
         return -EPERM;
     }
 
+    /* the same global broadcast from redundant paths or several BBMDs is relayed only once,
+       local processing of every copy is left to the application */
+    if ((npci_info->dst.net == BACNET_BROADCAST_NETWORK)
+            && dup_cache_check(in_port, src_addr, npdu, npci_info)) {
+        return OK;
+    }
+
     /* hop count-- */
     hop_count = npdu->data[npci_info->hop_count_offset];
     (hop_count)--;
@@ -232,6 +266,36 @@ int network_relay_handler(bacnet_port_t *in_port, bacnet_addr_t *src_addr, bacne
     return rv;
 }
 
+/**
+ * network_relay_handler - relay with latency and per-port statistic
+ *
+ * @return: 0 on success, negative on failure
+ *
+ */
+int network_relay_handler(bacnet_port_t *in_port, bacnet_addr_t *src_addr, bacnet_buf_t *npdu, 
+        npci_info_t *npci_info)
+{
+    network_port_perf_t *perf;
+    uint64_t start;
+    int rv;
+
+    start = perf_now_ns();
+    rv = __network_relay_handler(in_port, src_addr, npdu, npci_info);
+    if (start == 0) {
+        return rv;
+    }
+
+    if (network_relay_perf == PERF_INVALID_ID) {
+        network_relay_perf = perf_hist_register("network.relay");
+    }
+    perf_hist_since(network_relay_perf, start);
+
+    perf = network_get_port_perf(in_port->id);
+    perf_counter_add((rv < 0)? perf->relay_fail: perf->relay, 1);
+
+    return rv;
+}
+
 /* Э鱨Ĵ */
 static void network_control_handler(bacnet_port_t *in_port, bacnet_addr_t *src_addr, 
                 bacnet_buf_t *npdu, npci_info_t *npci_info)
@@ -303,6 +367,7 @@ not_supported:
 int network_receive_pdu(uint32_t port_id, bacnet_buf_t *npdu, bacnet_addr_t *src_mac)
 {
     bacnet_port_t *in_port;
+    network_port_perf_t *perf;
     npci_info_t npci_info;
     int rv;
 
@@ -325,12 +390,18 @@ int network_receive_pdu(uint32_t port_id, bacnet_buf_t *npdu, bacnet_addr_t *src
     }
     src_mac->net = in_port->net;
 
+    if (perf_enabled) {
+        perf = network_get_port_perf(port_id);
+        perf_counter_add(perf->rx, 1);
+        perf_counter_add((npci_info.control & BIT7)? perf->rx_network_msg: perf->rx_apdu, 1);
+    }
+
     if (network_dbg_verbos) {
-        printf("%s: port(%d) receive npdu(%d) ", __func__, port_id, npdu->data_len);
+        NETWORK_VERBOS("%s: port(%d) receive npdu(%d) ", __func__, port_id, npdu->data_len);
         if (npci_info.dst.net != 0) {
-            printf("To net(%d) ", npci_info.dst.net);
+            NETWORK_VERBOS("To net(%d) ", npci_info.dst.net);
         }
-        printf("from Source: ");
+        NETWORK_VERBOS("from Source: ");
         PRINT_BACNET_ADDRESS(src_mac);
     }
 
@@ -430,6 +501,10 @@ int network_send_pdu(bacnet_addr_t *dst, bacnet_buf_t *buf, bacnet_prio_t prio,
             return -EPERM;
         }
 
+        if (need_whois) {
+            bcast_Who_Is_Router_To_Network(NULL, dst->net);
+        }
+
         if (entry.busy) {
             NETWORK_ERROR("%s: dnet(%d) is busy\r\n", __func__, dst->net);
             return -EPERM;
@@ -806,22 +881,34 @@ int network_startup(void)
         goto out2;
     }
 
+    rv = dup_cache_init(cJSON_GetObjectItem(network_cfg, "broadcast_dedup"), is_bacnet_router);
+    if (rv < 0) {
+        NETWORK_ERROR("%s: broadcast dedup init failed(%d)\r\n", __func__, rv);
+        goto out3;
+    }
+
+    rv = route_cache_init(cJSON_GetObjectItem(network_cfg, "route_cache"));
+    if (rv < 0) {
+        NETWORK_ERROR("%s: route cache init failed(%d)\r\n", __func__, rv);
+        goto out4;
+    }
+
     rv = route_table_config(network_cfg);
     if (rv < 0) {
         NETWORK_ERROR("%s: route config failed(%d)\r\n", __func__, rv);
-        goto out3;
+        goto out5;
     }
 
     rv = datalink_startup();
     if (rv < 0) {
         NETWORK_ERROR("%s: datalink startup failed(%d)\r\n", __func__, rv);
-        goto out3;
+        goto out5;
     }
 
     rv = route_startup();
     if (rv < 0) {
         NETWORK_ERROR("%s: route startup failed(%d)\r\n", __func__, rv);
-        goto out4;
+        goto out6;
     }
 
     network_init_status = true;
@@ -829,9 +916,15 @@ int network_startup(void)
 
     return OK;
 
-out4:
+out6:
     datalink_stop();
 
+out5:
+    route_cache_exit();
+
+out4:
+    dup_cache_exit();
+
 out3:
     route_port_destroy();
 
@@ -847,6 +940,8 @@ out0:
 
 void network_stop(void)
 {
+    (void)route_cache_save();
+
     datalink_stop();
     
     network_init_status = false;
@@ -862,9 +957,13 @@ void network_stop(void)
  */
 void network_exit(void)
 {
+    route_cache_exit();
+
     datalink_exit();
     
     network_stop();
+
+    dup_cache_exit();
 }
 
 cJSON *network_get_status(connect_info_t *conn, cJSON *request)
@@ -14,6 +14,7 @@
 #define _NETWORK_DEF_H_
 
 #include "route.h"
+#include "misc/trace.h"
 
 extern bool network_dbg_err;
 extern bool network_dbg_warn;
@@ -21,24 +22,36 @@ extern bool network_dbg_verbos;
 
 #define INTERVAL_Who_Is_Router_To_Network       (10)
 
+/* ports beyond this share the overflow counters */
+#define NETWORK_PERF_MAX_PORT                   (64)
+
+/* per-port perf counter ids, registered on first packet */
+typedef struct network_port_perf_s {
+    int rx;
+    int rx_network_msg;
+    int rx_apdu;
+    int relay;
+    int relay_fail;
+} network_port_perf_t;
+
 #define NETWORK_ERROR(fmt, args...)             \
 do {                                            \
     if (network_dbg_err) {                      \
-       printf(fmt, ##args);                     \
+       TRACE_ERROR(fmt, ##args);                \
     }                                           \
 } while (0)
 
 #define NETWORK_WARN(fmt, args...)              \
 do {                                            \
     if (network_dbg_warn) {                     \
-        printf(fmt, ##args);                    \
+        TRACE_WARN(fmt, ##args);                \
     }                                           \
 } while (0)
 
 #define NETWORK_VERBOS(fmt, args...)            \
 do {                                            \
     if (network_dbg_verbos) {                   \
-       printf(fmt, ##args);                     \
+       TRACE_VERBOS(fmt, ##args);               \
     }                                           \
 } while (0)
 
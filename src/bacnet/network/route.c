@@ -39,6 +39,23 @@ typedef struct whois_try_s {
     struct list_head route_node;
 } whois_try_t;
 
+/* ·ɱеһֻ涯̬· */
+typedef struct route_snapshot_s {
+    uint16_t dnet;
+    uint16_t port_id;
+    uint16_t port_net;                      /* ֱţ˿ñ */
+    uint32_t age;                           /* ʱtimestamp */
+    uint8_t mac_len;
+    uint8_t mac[MAX_MAC_LEN];
+} __attribute__((packed)) route_snapshot_t;
+
+static struct {
+    char *file;
+    uint32_t save_interval;
+    uint32_t max_age;
+    el_timer_t *timer;
+} route_cache;
+
 /* ·ɱ */
 static struct {
     pthread_rwlock_t rwlock;
@@ -156,6 +173,7 @@ static int __route_update_entry(route_entry_impl_t *entry, bool busy, bacnet_por
     entry->info.mac_len = next_mac->len;
     memcpy(entry->info.mac, next_mac->adr, next_mac->len);
     entry->timestamp = el_current_second();
+    entry->revalidate = false;
 
     list_add_tail(&(entry->route_node), &(route_table.entry_head));
     list_add_tail(&(entry->reachable_node), &(port_reachable_lists[out_port->id]));
@@ -170,6 +188,7 @@ static void __route_touch_entry(route_entry_impl_t *entry, bool update_ts)
     if (update_ts) {
         entry->timestamp = el_current_second();
     }
+    entry->revalidate = false;
 }
 
 static whois_try_t *__route_find_whois(uint16_t dnet)
@@ -304,6 +323,12 @@ bool route_try_find_entry(uint16_t dnet, route_entry_t *entry, bool *need_whois)
             tmp->info.busy = false;
         }
 
+        /* ӿջָ·ճʹãͬʱһWho_Is_RouterУ */
+        if (need_whois) {
+            *need_whois = tmp->revalidate;
+            tmp->revalidate = false;
+        }
+
         if (entry) {
             memcpy(entry, &tmp->info, sizeof(route_entry_t));
         }
@@ -1121,6 +1146,205 @@ out:
     return rv;
 }
 
+/* ˳Ӿɵ±棬ָʱββɻԭ̭˳ */
+int route_cache_save(void)
+{
+    route_entry_impl_t *entry;
+    route_snapshot_t *snap;
+    uint32_t now, count;
+    int rv;
+
+    if (route_cache.file == NULL) {
+        return OK;
+    }
+
+    RWLOCK_RDLOCK(&route_table.rwlock);
+
+    snap = (route_snapshot_t *)malloc(sizeof(route_snapshot_t) * (route_table.entry_num + 1));
+    if (snap == NULL) {
+        NETWORK_ERROR("%s: malloc failed\r\n", __func__);
+        RWLOCK_UNLOCK(&route_table.rwlock);
+        return -ENOMEM;
+    }
+
+    count = 0;
+    now = el_current_second();
+    list_for_each_entry(entry, &(route_table.entry_head), route_node) {
+        if (entry->info.direct_net) {
+            continue;
+        }
+
+        snap[count].dnet = entry->info.dnet;
+        snap[count].port_id = entry->info.port->id;
+        snap[count].port_net = entry->info.port->net;
+        snap[count].age = now - entry->timestamp;
+        snap[count].mac_len = entry->info.mac_len;
+        memcpy(snap[count].mac, entry->info.mac, MAX_MAC_LEN);
+        count++;
+    }
+
+    RWLOCK_UNLOCK(&route_table.rwlock);
+
+    rv = save_snapshot_file(route_cache.file, ROUTE_CACHE_MAGIC, snap,
+        count * sizeof(route_snapshot_t));
+    free(snap);
+    if (rv < 0) {
+        NETWORK_ERROR("%s: save %s failed(%d)\r\n", __func__, route_cache.file, rv);
+        return rv;
+    }
+
+    NETWORK_VERBOS("%s: %u entries saved\r\n", __func__, count);
+
+    return OK;
+}
+
+static void route_cache_load(void)
+{
+    route_entry_impl_t *entry;
+    route_snapshot_t *snap;
+    bacnet_addr_t next_mac;
+    uint32_t len, down, age, count, loaded, i;
+
+    snap = (route_snapshot_t *)load_snapshot_file(route_cache.file, ROUTE_CACHE_MAGIC, &len,
+        &down);
+    if (snap == NULL) {
+        return;
+    }
+
+    if (len % sizeof(route_snapshot_t)) {
+        NETWORK_ERROR("%s: invalid snapshot len(%u)\r\n", __func__, len);
+        free(snap);
+        return;
+    }
+
+    count = len / sizeof(route_snapshot_t);
+    loaded = 0;
+
+    RWLOCK_WRLOCK(&route_table.rwlock);
+
+    for (i = 0; i < count; i++) {
+        age = snap[i].age + down;
+        if ((age < snap[i].age) || (age >= route_cache.max_age)) {
+            continue;
+        }
+
+        /* ˿ڻֱѱıWho_Is_Routerѧϰ */
+        if ((snap[i].port_id >= route_port_nums) || (!route_ports[snap[i].port_id].valid)
+                || (route_ports[snap[i].port_id].net != snap[i].port_net)
+                || (snap[i].mac_len == 0) || (snap[i].mac_len > MAX_MAC_LEN)
+                || (snap[i].dnet == 0) || (snap[i].dnet == BACNET_BROADCAST_NETWORK)
+                || route_port_list_find_by_net(snap[i].dnet)
+                || __route_find_entry(snap[i].dnet)) {
+            continue;
+        }
+
+        memset(&next_mac, 0, sizeof(next_mac));
+        next_mac.len = snap[i].mac_len;
+        memcpy(next_mac.adr, snap[i].mac, snap[i].mac_len);
+        entry = __route_add_entry(snap[i].dnet, false, &route_ports[snap[i].port_id], &next_mac);
+        if (entry == NULL) {
+            continue;
+        }
+
+        entry->timestamp = el_current_second() - age;
+        entry->revalidate = true;
+        loaded++;
+    }
+
+    RWLOCK_UNLOCK(&route_table.rwlock);
+
+    free(snap);
+
+    NETWORK_WARN("%s: %u of %u routes restored from %s, down %u s\r\n", __func__, loaded, count,
+        route_cache.file, down);
+}
+
+static void route_cache_timer(el_timer_t *timer)
+{
+    (void)route_cache_save();
+
+    (void)el_timer_mod(&el_default_loop, timer, route_cache.save_interval * 1000);
+}
+
+int route_cache_init(cJSON *cfg)
+{
+    cJSON *tmp;
+
+    route_cache.file = NULL;
+    route_cache.save_interval = ROUTE_CACHE_SAVE_INTERVAL;
+    route_cache.max_age = ROUTE_CACHE_MAX_AGE;
+    route_cache.timer = NULL;
+
+    if (cfg == NULL) {
+        return OK;
+    }
+
+    if (cfg->type != cJSON_Object) {
+        NETWORK_ERROR("%s: route_cache should be object\r\n", __func__);
+        return -EPERM;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "save_interval");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint < ROUTE_CACHE_MIN_SAVE_INTERVAL)) {
+            NETWORK_ERROR("%s: save_interval should be >= %d\r\n", __func__,
+                ROUTE_CACHE_MIN_SAVE_INTERVAL);
+            return -EPERM;
+        }
+        route_cache.save_interval = (uint32_t)tmp->valueint;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "max_age");
+    if (tmp) {
+        if ((tmp->type != cJSON_Number) || (tmp->valueint <= 0)) {
+            NETWORK_ERROR("%s: max_age should be positive\r\n", __func__);
+            return -EPERM;
+        }
+        route_cache.max_age = (uint32_t)tmp->valueint;
+    }
+
+    tmp = cJSON_GetObjectItem(cfg, "file");
+    if (tmp == NULL) {
+        return OK;
+    }
+
+    if ((tmp->type != cJSON_String) || (tmp->valuestring[0] == 0)) {
+        NETWORK_ERROR("%s: file should be path string\r\n", __func__);
+        return -EPERM;
+    }
+
+    route_cache.file = strdup(tmp->valuestring);
+    if (route_cache.file == NULL) {
+        NETWORK_ERROR("%s: strdup failed\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    route_cache_load();
+
+    route_cache.timer = el_timer_create(&el_default_loop, route_cache.save_interval * 1000);
+    if (route_cache.timer == NULL) {
+        NETWORK_ERROR("%s: create timer failed\r\n", __func__);
+        free(route_cache.file);
+        route_cache.file = NULL;
+        return -EPERM;
+    }
+    route_cache.timer->handler = route_cache_timer;
+    route_cache.timer->data = NULL;
+
+    return OK;
+}
+
+void route_cache_exit(void)
+{
+    if (route_cache.timer) {
+        (void)el_timer_destroy(&el_default_loop, route_cache.timer);
+        route_cache.timer = NULL;
+    }
+
+    free(route_cache.file);
+    route_cache.file = NULL;
+}
+
 /**
  * route_startup - ·
  *
@@ -1266,6 +1490,7 @@ cJSON *route_get_port_mib(cJSON *request)
             goto err;
         }
         cJSON_AddItemToObject(result, "route", tmp);
+        cJSON_AddNumberToObject(result, "bcast_suppressed", port->bcast_suppressed);
     }
     
     return result;
@@ -32,6 +32,11 @@
 /* timeoutԶȡbusy */
 #define ROUTE_BUSY_TIMEOUT                      (30)
 
+#define ROUTE_CACHE_MAGIC                       (0x42524331)    /* "BRC1" */
+#define ROUTE_CACHE_SAVE_INTERVAL               (60)
+#define ROUTE_CACHE_MIN_SAVE_INTERVAL           (5)
+#define ROUTE_CACHE_MAX_AGE                     (86400)
+
 /* ֿɴ״̬ */
 typedef enum network_reachable_status_e {
     NETWORK_REACHABLE = 0,                  /* ɴ */
@@ -46,6 +51,7 @@ typedef struct bacnet_port_s {
     bool valid;                             /* trueʾö˿Чfalseʾ˿Ч */
     uint16_t net;                           /* ֱ */
     datalink_base_t *dl;                    /* · */
+    uint32_t bcast_suppressed;              /* ȥضȫֹ㲥 */
 } bacnet_port_t;
 
 /* information of routing entry */
@@ -61,6 +67,7 @@ typedef struct route_entry_s {
 typedef struct route_entry_impl_s {
     route_entry_t info;
     uint32_t timestamp;                     /* ¼һηWho_Is_Routerյbusyʱ */
+    bool revalidate;                        /* ӿջָ״αطʱWho_Is_Router */
     struct hlist_node hash_node;            /* ϣ */
     struct list_head reachable_node;        /* ˿ڿɴ */
     struct list_head route_node;            /* ȫ·ɱʱ */
@@ -113,6 +120,19 @@ extern void route_table_destroy(void);
 
 extern int route_table_config(cJSON *cfg);
 
+/**
+ * route_cache_init - ӿջָ̬·ɣڱ
+ *
+ * @cfg: network.confеroute_cacheΪNULLʱ
+ *
+ * @return: ɹ0򷵻ظ
+ */
+extern int route_cache_init(cJSON *cfg);
+
+extern void route_cache_exit(void);
+
+extern int route_cache_save(void);
+
 extern cJSON *route_get_port_mib(cJSON *request);
 
 #endif  /* _ROUTE_H_ */
@@ -391,11 +391,83 @@ static void socket_accept_handler(el_watch_t *watch, int events)
     return;
 }
 
+typedef struct connect_arm_s {
+    connect_info_impl_t *conn_impl;
+    int events;
+    el_watch_handler handler;
+    int rv;
+} connect_arm_t;
+
+/* run on el_default_loop: point the watcher at the next step and rearm the timer */
+static void _connect_mng_arm(void *arg)
+{
+    connect_arm_t *arm;
+    connect_info_impl_t *conn_impl;
+    int rv;
+
+    arm = (connect_arm_t *)arg;
+    conn_impl = arm->conn_impl;
+
+    if (conn_impl->watcher) {
+        rv = el_watch_mod(&el_default_loop, conn_impl->watcher, arm->events);
+        if (rv < 0) {
+            CONNECT_MNG_ERROR("%s: el watch mod failed(%d)\r\n", __func__, rv);
+            connect_mng_drop(&conn_impl->base);
+            arm->rv = rv;
+            return;
+        }
+    } else {
+        conn_impl->watcher = el_watch_create(&el_default_loop, conn_impl->fd, arm->events);
+        if (conn_impl->watcher == NULL) {
+            CONNECT_MNG_ERROR("%s: create event watch failed\r\n", __func__);
+            connect_mng_drop(&conn_impl->base);
+            arm->rv = -EPERM;
+            return;
+        }
+        conn_impl->watcher->data = (void *)conn_impl;
+    }
+    conn_impl->watcher->handler = arm->handler;
+
+    if (conn_impl->timer) {
+        rv = el_timer_mod(&el_default_loop, conn_impl->timer, MAX_READ_WRITE_TIMEOUT);
+        if (rv < 0) {
+            CONNECT_MNG_ERROR("%s: el timer mod failed(%d)\r\n", __func__, rv);
+            connect_mng_drop(&conn_impl->base);
+            arm->rv = rv;
+            return;
+        }
+    } else {
+        conn_impl->timer = el_timer_create(&el_default_loop, MAX_READ_WRITE_TIMEOUT);
+        if (conn_impl->timer == NULL) {
+            CONNECT_MNG_ERROR("%s: create timer failed\r\n", __func__);
+            connect_mng_drop(&conn_impl->base);
+            arm->rv = -EPERM;
+            return;
+        }
+        conn_impl->timer->handler = socket_timer_handler;
+        conn_impl->timer->data = (void *)conn_impl;
+    }
+
+    arm->rv = OK;
+}
+
+static int connect_mng_arm(connect_info_impl_t *conn_impl, int events, el_watch_handler handler)
+{
+    connect_arm_t arm;
+
+    arm.conn_impl = conn_impl;
+    arm.events = events;
+    arm.handler = handler;
+    arm.rv = -EPERM;
+    (void)el_call(&el_default_loop, _connect_mng_arm, &arm);
+
+    return arm.rv;
+}
+
 int connect_mng_echo(connect_info_t *conn)
 {
     connect_info_impl_t *conn_impl;
     int nwrite;
-    int rv = OK;
     
     if (conn == NULL) {
         CONNECT_MNG_ERROR("%s: null argument\r\n", __func__);
@@ -469,91 +541,19 @@ int connect_mng_echo(connect_info_t *conn)
 
     socket_connfd_status_reset(conn_impl);
 
-    el_sync(&el_default_loop);
-
-    if (conn_impl->watcher) {
-        rv = el_watch_mod(&el_default_loop, conn_impl->watcher, EPOLLIN);
-        if (rv < 0) {
-            CONNECT_MNG_ERROR("%s: el watch mod failed(%d)\r\n", __func__, rv);
-            connect_mng_drop(conn);
-            el_unsync(&el_default_loop);
-            return rv;
-        }
-    } else {
-        conn_impl->watcher = el_watch_create(&el_default_loop, conn_impl->fd, EPOLLIN);
-        if (conn_impl->watcher == NULL) {
-            CONNECT_MNG_ERROR("%s: create event watch failed\r\n", __func__);
-            connect_mng_drop(conn);
-            el_unsync(&el_default_loop);
-            return -EPERM;
-        }
-        conn_impl->watcher->data = (void *)conn_impl;
-    }
-    conn_impl->watcher->handler = socket_read_handler;
-    goto set_timer;
+    return connect_mng_arm(conn_impl, EPOLLIN, socket_read_handler);
 
 again:
-    el_sync(&el_default_loop);
-
-    if (conn_impl->watcher) {
-        rv = el_watch_mod(&el_default_loop, conn_impl->watcher, EPOLLOUT);
-        if (rv < 0) {
-            CONNECT_MNG_ERROR("%s: el watch mod failed(%d)\r\n", __func__, rv);
-            connect_mng_drop(conn);
-            el_unsync(&el_default_loop);
-            return rv;
-        }
-    } else {
-        conn_impl->watcher = el_watch_create(&el_default_loop, conn_impl->fd, EPOLLOUT);
-        if (conn_impl->watcher == NULL) {
-            CONNECT_MNG_ERROR("%s: create event watch failed\r\n", __func__);
-            connect_mng_drop(conn);
-            el_unsync(&el_default_loop);
-            return -EPERM;
-        }
-
-        conn_impl->watcher->data = (void *)conn_impl;
-    }
-    conn_impl->watcher->handler = socket_write_handler;
-
-set_timer:
-    if (conn_impl->timer) {
-        rv = el_timer_mod(&el_default_loop, conn_impl->timer, MAX_READ_WRITE_TIMEOUT);
-        if (rv < 0) {
-            CONNECT_MNG_ERROR("%s: el timer mod failed(%d)\r\n", __func__, rv);
-            connect_mng_drop(conn);
-            el_unsync(&el_default_loop);
-            return rv;
-        }
-    } else {
-        conn_impl->timer = el_timer_create(&el_default_loop, MAX_READ_WRITE_TIMEOUT);
-        if (conn_impl->timer == NULL) {
-            CONNECT_MNG_ERROR("%s: create timer failed\r\n", __func__);
-            connect_mng_drop(conn);
-            el_unsync(&el_default_loop);
-            return -EPERM;
-        }
-        conn_impl->timer->handler = socket_timer_handler;
-        conn_impl->timer->data = (void *)conn_impl;
-    }
-
-    el_unsync(&el_default_loop);
-    
-    return rv;
+    return connect_mng_arm(conn_impl, EPOLLOUT, socket_write_handler);
 }
 
-int connect_mng_drop(connect_info_t *conn)
+static void _connect_mng_drop(void *arg)
 {
+    connect_info_t *conn;
     connect_info_impl_t *conn_impl;
     int rv;
-    
-    if (!conn) {
-        CONNECT_MNG_ERROR("%s: null argument\r\n", __func__);
-        return -EINVAL;
-    }
-
-    el_sync(&el_default_loop);
 
+    conn = (connect_info_t *)arg;
     conn_impl = container_of(conn, connect_info_impl_t, base);
 
     if (conn_impl->watcher) {
@@ -590,9 +590,17 @@ int connect_mng_drop(connect_info_t *conn)
         sockfd_list.count = 0;
         INIT_LIST_HEAD(&sockfd_list.head);
     }
+}
+
+int connect_mng_drop(connect_info_t *conn)
+{
+    if (!conn) {
+        CONNECT_MNG_ERROR("%s: null argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    (void)el_call(&el_default_loop, _connect_mng_drop, conn);
 
-    el_unsync(&el_default_loop);
-    
     return OK;
 }
 
@@ -635,6 +643,15 @@ int connect_mng_unregister(BACNET_SERVICE_TYPE type)
     return OK;
 }
 
+/* run on el_default_loop, so no accept is seen before the handler is set */
+static void _connect_mng_listen(void *arg)
+{
+    listen_watcher = el_watch_create(&el_default_loop, *(int *)arg, EPOLLIN);
+    if (listen_watcher != NULL) {
+        listen_watcher->handler = socket_accept_handler;
+    }
+}
+
 int connect_mng_init(void)
 {
     struct sockaddr_un serv_addr;
@@ -679,19 +696,14 @@ int connect_mng_init(void)
         goto out1;
     }
     
-    el_sync(&el_default_loop);
-
-    listen_watcher = el_watch_create(&el_default_loop, listen_fd, EPOLLIN);
+    (void)el_call(&el_default_loop, _connect_mng_listen, &listen_fd);
     if (listen_watcher == NULL) {
         CONNECT_MNG_ERROR("%s: event watch create listen_fd(%d) failed\r\n", __func__, listen_fd);
-        el_unsync(&el_default_loop);
         rv = -EPERM;
         goto out1;
     }
-    listen_watcher->handler = socket_accept_handler;
 
     connect_mng_status = true;
-    el_unsync(&el_default_loop);
     connect_mng_set_dbg_level(0);
 
     return OK;
@@ -1234,10 +1246,49 @@ static void client_timeout_handler(el_timer_t *timer)
     }
 }
 
+typedef struct client_arm_s {
+    connect_client_async_impl_t *impl;
+    int fd;
+    int rv;
+} client_arm_t;
+
+/* run on the client's loop, so no event is seen before the handlers are set */
+static void _connect_client_async_arm(void *arg)
+{
+    client_arm_t *arm;
+    connect_client_async_impl_t *impl;
+    el_loop_t *el;
+
+    arm = (client_arm_t *)arg;
+    impl = arm->impl;
+    el = impl->el;
+
+    impl->watch = el_watch_create(el, arm->fd, EPOLLOUT);
+    if (impl->watch == NULL) {
+        CONNECT_MNG_ERROR("%s: create watch failed\r\n", __func__);
+        return;
+    }
+    impl->watch->handler = client_fd_handler;
+    impl->watch->data = (void*)impl;
+
+    impl->timer = el_timer_create(el, impl->base.timeout_ms);
+    if (impl->timer == NULL) {
+        CONNECT_MNG_ERROR("%s: create timer failed\r\n", __func__);
+        el_watch_destroy(el, impl->watch);
+        impl->watch = NULL;
+        return;
+    }
+    impl->timer->handler = client_timeout_handler;
+    impl->timer->data = (void*)impl;
+
+    arm->rv = OK;
+}
+
 connect_client_async_t *connect_client_async_create(struct el_loop_s *el, unsigned timeout_ms)
 {
     connect_client_async_impl_t *impl;
     struct sockaddr_un serv_addr;
+    client_arm_t arm;
     int client_fd, rv;
 
     if (el == NULL) {
@@ -1274,50 +1325,29 @@ connect_client_async_t *connect_client_async_create(struct el_loop_s *el, unsign
     impl->el = el;
     impl->base.timeout_ms = timeout_ms;
 
-    el_sync(el);
-    impl->watch = el_watch_create(el, client_fd, EPOLLOUT);
-    if (impl->watch == NULL) {
-        CONNECT_MNG_ERROR("%s: create watch failed\r\n", __func__);
-        el_unsync(el);
-        free(impl);
-        close(client_fd);
-        return NULL;
-    }
-    impl->watch->handler = client_fd_handler;
-    impl->watch->data = (void*)impl;
-
-    impl->timer = el_timer_create(el, timeout_ms);
-    if (impl->timer == NULL) {
-        CONNECT_MNG_ERROR("%s: create timer failed\r\n", __func__);
-        el_watch_destroy(el, impl->watch);
-        el_unsync(el);
+    arm.impl = impl;
+    arm.fd = client_fd;
+    arm.rv = -EPERM;
+    (void)el_call(el, _connect_client_async_arm, &arm);
+    if (arm.rv < 0) {
         free(impl);
         close(client_fd);
         return NULL;
     }
-    impl->timer->handler = client_timeout_handler;
-    impl->timer->data = (void*)impl;
-    el_unsync(el);
     
     return &impl->base;
 }
 
-int connect_client_async_delete(connect_client_async_t *connect)
+/* run on the client's loop, the handlers can not be running meanwhile */
+static void _connect_client_async_delete(void *arg)
 {
     connect_client_async_impl_t *impl;
     el_loop_t *el;
     int client_fd = -1;
-    
-    if (connect == NULL) {
-        CONNECT_MNG_ERROR("%s: null argument\r\n", __func__);
-        return -EINVAL;
-    }
-    
-    impl = container_of(connect, connect_client_async_impl_t, base);
+
+    impl = (connect_client_async_impl_t *)arg;
     el = impl->el;
 
-    el_sync(el);
-    
     if (impl->watch) {
         client_fd = el_watch_fd(impl->watch);
         el_watch_destroy(el, impl->watch);
@@ -1341,8 +1371,19 @@ int connect_client_async_delete(connect_client_async_t *connect)
     if (client_fd >= 0) {
         close(client_fd);
     }
+}
+
+int connect_client_async_delete(connect_client_async_t *connect)
+{
+    connect_client_async_impl_t *impl;
     
-    el_unsync(el);
+    if (connect == NULL) {
+        CONNECT_MNG_ERROR("%s: null argument\r\n", __func__);
+        return -EINVAL;
+    }
+    
+    impl = container_of(connect, connect_client_async_impl_t, base);
+    (void)el_call(impl->el, _connect_client_async_delete, impl);
 
     return OK;
 }
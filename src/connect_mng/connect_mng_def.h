@@ -20,6 +20,7 @@
 #include "misc/eventloop.h"
 #include "misc/list.h"
 #include "connect_mng.h"
+#include "misc/trace.h"
 
 extern bool connet_mng_dbg_err;
 extern bool connet_mng_dbg_warn;
@@ -28,21 +29,21 @@ extern bool connet_mng_dbg_verbos;
 #define CONNECT_MNG_ERROR(fmt, args...)             \
 do {                                                \
     if (connet_mng_dbg_err) {                       \
-        printf(fmt, ##args);                        \
+        TRACE_ERROR(fmt, ##args);                   \
     }                                               \
 } while (0)
  
 #define CONNECT_MNG_WARN(fmt, args...)              \
 do {                                                \
     if (connet_mng_dbg_warn) {                      \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
  
 #define CONNECT_MNG_VERBOS(fmt, args...)            \
 do {                                                \
     if (connet_mng_dbg_verbos) {                    \
-        printf(fmt, ##args);                        \
+        TRACE_VERBOS(fmt, ##args);                  \
     }                                               \
 } while (0)
 
@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 
 #include "debug.h"
@@ -24,7 +25,14 @@
 #include "bacnet/mstp.h"
 #include "bacnet/bip.h"
 #include "bacnet/etherdl.h"
+#include "bacnet/tsm.h"
+#include "bacnet/ratelimit.h"
+#include "bacnet/slaveproxy.h"
+#include "bacnet/shmio.h"
+#include "bacnet/object/object.h"
 #include "misc/cJSON.h"
+#include "misc/perfstat.h"
+#include "misc/trace.h"
 
 static bool debug_service_status = false;
 
@@ -210,6 +218,201 @@ static bool debug_show_network_route_table(void)
     return false;
 }
 
+/* reply {"perf": {...}, "rate_limit": {...}, "proxy_iam": {...}, "object_init": {...},
+ *  "shared_io": {...}, "tsm_peers": [...]} */
+static bool debug_show_perf_stats(connect_info_t *conn)
+{
+    cJSON *reply, *perf, *limit, *iam, *init, *shm, *peers;
+    char *str;
+
+    reply = cJSON_CreateObject();
+    if (reply == NULL) {
+        DEBUG_ERROR("%s: create reply object failed\r\n", __func__);
+        return false;
+    }
+
+    perf = perf_get_status();
+    if (perf) {
+        cJSON_AddItemToObject(reply, "perf", perf);
+    }
+
+    limit = rate_limit_get_status();
+    if (limit) {
+        cJSON_AddItemToObject(reply, "rate_limit", limit);
+    }
+
+    iam = slave_proxy_get_iam_status();
+    if (iam) {
+        cJSON_AddItemToObject(reply, "proxy_iam", iam);
+    }
+
+    init = object_get_init_status();
+    if (init) {
+        cJSON_AddItemToObject(reply, "object_init", init);
+    }
+
+    shm = shmio_get_status();
+    if (shm) {
+        cJSON_AddItemToObject(reply, "shared_io", shm);
+    }
+
+    peers = tsm_get_perf_status();
+    if (peers) {
+        cJSON_AddItemToObject(reply, "tsm_peers", peers);
+    }
+
+    str = cJSON_PrintUnformatted(reply);
+    if (str && (strlen(str) + 1 > MAX_DEBUG_REPLY_LEN)) {
+        free(str);
+        cJSON_DeleteItemFromObject(reply, "tsm_peers");
+        cJSON_AddTrueToObject(reply, "tsm_peers_truncated");
+        str = cJSON_PrintUnformatted(reply);
+    }
+    cJSON_Delete(reply);
+
+    if (str == NULL) {
+        DEBUG_ERROR("%s: print reply failed\r\n", __func__);
+        return false;
+    }
+
+    if (strlen(str) + 1 > MAX_DEBUG_REPLY_LEN) {
+        DEBUG_ERROR("%s: reply len(%u) overflow\r\n", __func__, (uint32_t)strlen(str));
+        free(str);
+        return false;
+    }
+
+    conn->data = (uint8_t *)str;
+    conn->data_len = strlen(str) + 1;
+
+    return true;
+}
+
+/* reply object_get_memory_status() */
+static bool debug_show_object_memory(connect_info_t *conn)
+{
+    cJSON *reply;
+    char *str;
+
+    reply = object_get_memory_status();
+    if (reply == NULL) {
+        DEBUG_ERROR("%s: get object memory status failed\r\n", __func__);
+        return false;
+    }
+
+    str = cJSON_PrintUnformatted(reply);
+    cJSON_Delete(reply);
+    if (str == NULL) {
+        DEBUG_ERROR("%s: print reply failed\r\n", __func__);
+        return false;
+    }
+
+    if (strlen(str) + 1 > MAX_DEBUG_REPLY_LEN) {
+        DEBUG_ERROR("%s: reply len(%u) overflow\r\n", __func__, (uint32_t)strlen(str));
+        free(str);
+        return false;
+    }
+
+    conn->data = (uint8_t *)str;
+    conn->data_len = strlen(str) + 1;
+
+    return true;
+}
+
+static bool debug_reset_perf_stats(void)
+{
+    perf_reset();
+    tsm_perf_reset();
+    rate_limit_reset();
+    slave_proxy_reset_iam_status();
+
+    return false;
+}
+
+static bool debug_set_perf_status(cJSON *cfg)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, "enable");
+    if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
+        DEBUG_ERROR("%s: get enable item failed\r\n", __func__);
+        return false;
+    }
+
+    perf_set_enable(tmp->valueint != 0);
+
+    return false;
+}
+
+/* reply records later than "since", pass back "next" of the reply to stream */
+static bool debug_dump_trace(connect_info_t *conn, cJSON *cfg)
+{
+    cJSON *reply, *tmp;
+    uint64_t since;
+    char *str;
+
+    since = 0;
+    tmp = cJSON_GetObjectItem(cfg, "since");
+    if (tmp != NULL) {
+        if (tmp->type != cJSON_String) {
+            DEBUG_ERROR("%s: invalid since item\r\n", __func__);
+            return false;
+        }
+        since = strtoull(tmp->valuestring, NULL, 10);
+    }
+
+    /* leave room for json escapes */
+    reply = trace_dump(since, MAX_DEBUG_REPLY_LEN / 2);
+    if (reply == NULL) {
+        DEBUG_ERROR("%s: trace dump failed\r\n", __func__);
+        return false;
+    }
+
+    str = cJSON_PrintUnformatted(reply);
+    cJSON_Delete(reply);
+    if (str == NULL) {
+        DEBUG_ERROR("%s: print reply failed\r\n", __func__);
+        return false;
+    }
+
+    if (strlen(str) + 1 > MAX_DEBUG_REPLY_LEN) {
+        DEBUG_ERROR("%s: reply len(%u) overflow\r\n", __func__, (uint32_t)strlen(str));
+        free(str);
+        return false;
+    }
+
+    conn->data = (uint8_t *)str;
+    conn->data_len = strlen(str) + 1;
+
+    return true;
+}
+
+static bool debug_set_trace_status(cJSON *cfg)
+{
+    cJSON *tmp;
+
+    tmp = cJSON_GetObjectItem(cfg, "enable");
+    if ((tmp == NULL) || (tmp->type != cJSON_Number)) {
+        DEBUG_ERROR("%s: get enable item failed\r\n", __func__);
+        return false;
+    }
+
+    trace_set_enable(tmp->valueint != 0);
+
+    return false;
+}
+
+static bool debug_set_trace_console_level(cJSON *cfg)
+{
+    uint32_t level;
+
+    level = 0;
+    if (debug_get_dbg_level(cfg, &level)) {
+        trace_set_console_level(level);
+    }
+
+    return false;
+}
+
 static bool debug_connect_service_handler(connect_info_t *conn)
 {
     cJSON *cfg, *request;
@@ -239,6 +442,7 @@ static bool debug_connect_service_handler(connect_info_t *conn)
     }
     free(conn->data);
     conn->data = NULL;
+    conn->data_len = 0;
     
     if (cfg->type != cJSON_Object) {
         DEBUG_ERROR("%s: invalid cfg type(%d)\r\n", __func__, cfg->type);
@@ -301,13 +505,40 @@ static bool debug_connect_service_handler(connect_info_t *conn)
         debug_show_network_route_table();
         break;
 
+    case DEBUG_SHOW_PERF_STATS:
+        debug_show_perf_stats(conn);
+        break;
+
+    case DEBUG_RESET_PERF_STATS:
+        debug_reset_perf_stats();
+        break;
+
+    case DEBUG_SET_PERF_STATUS:
+        debug_set_perf_status(cfg);
+        break;
+
+    case DEBUG_DUMP_TRACE:
+        debug_dump_trace(conn, cfg);
+        break;
+
+    case DEBUG_SET_TRACE_STATUS:
+        debug_set_trace_status(cfg);
+        break;
+
+    case DEBUG_SET_TRACE_CONSOLE_LEVEL:
+        debug_set_trace_console_level(cfg);
+        break;
+
+    case DEBUG_SHOW_OBJECT_MEMORY:
+        debug_show_object_memory(conn);
+        break;
+
     default:
         DEBUG_ERROR("%s: unknown request(%lf)\r\n", __func__, request->valuedouble);
         goto out;
     }
 
     cJSON_Delete(cfg);
-    conn->data_len = 0;
     (void)connect_mng_echo(conn);
     return true;
 
@@ -13,6 +13,8 @@
 #ifndef _DEBUG_DEF_H_
 #define _DEBUG_DEF_H_
 
+#include "misc/trace.h"
+
 extern bool debug_dbg_err;
 extern bool debug_dbg_warn;
 extern bool debug_dbg_verbos;
@@ -20,24 +22,27 @@ extern bool debug_dbg_verbos;
 #define DEBUG_ERROR(fmt, args...)                   \
 do {                                                \
     if (debug_dbg_err) {                            \
-        printf(fmt, ##args);                        \
+        TRACE_ERROR(fmt, ##args);                   \
     }                                               \
 } while (0)
  
 #define DEBUG_WARN(fmt, args...)                    \
 do {                                                \
     if (debug_dbg_warn) {                           \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
  
 #define DEBUG_VERBOS(fmt, args...)                  \
 do {                                                \
     if (debug_dbg_verbos) {                         \
-        printf(fmt, ##args);                        \
+        TRACE_VERBOS(fmt, ##args);                  \
     }                                               \
 } while (0)
 
+/* same as MAX_CONNECT_MNG_DATA_LEN */
+#define MAX_DEBUG_REPLY_LEN                         (64000)
+
 #ifndef OK
 #define OK                                          (0)
 #endif
@@ -20,6 +20,7 @@
 
 #include "eventloop_def.h"
 #include "debug.h"
+#include "misc/perfstat.h"
 
 el_loop_t el_default_loop = {};
 
@@ -27,6 +28,141 @@ bool el_dbg_verbos = false;
 bool el_dbg_warn = false;
 bool el_dbg_err = true;
 
+/* loop stopped by this thread through el_sync */
+static __thread el_loop_t *el_synced = NULL;
+static __thread int el_sync_depth = 0;
+
+typedef enum {
+    EL_CTX_LOOP = 0,        /* on the loop thread, owns the loop state */
+    EL_CTX_LOCKED,          /* loop not running or stopped by el_sync, take sync_lock */
+    EL_CTX_FOREIGN,         /* other thread, go through the mailbox */
+} EL_CONTEXT;
+
+static EL_CONTEXT el_context(el_loop_t *el)
+{
+    if (!__atomic_load_n(&el->started, __ATOMIC_ACQUIRE) || (el_synced == el)) {
+        return EL_CTX_LOCKED;
+    }
+
+    if (pthread_equal(pthread_self(), el->epoll_thread)) {
+        return EL_CTX_LOOP;
+    }
+
+    return EL_CTX_FOREIGN;
+}
+
+static void el_post_push(el_loop_t *el, el_post_node_t *node)
+{
+    el_post_node_t *head;
+    uint64_t one = 1;
+    ssize_t rv;
+
+    head = __atomic_load_n(&el->post_head, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&el->post_head, &head, node, true, __ATOMIC_RELEASE,
+        __ATOMIC_RELAXED));
+
+    /* only the first closure of a batch wakes the loop */
+    if (head == NULL) {
+        do {
+            rv = write(el->post_fd, &one, sizeof(one));
+        } while ((rv < 0) && (errno == EINTR));
+
+        if (rv < 0) {
+            EL_ERROR("%s: wake loop failed cause %s\r\n", __func__, strerror(errno));
+        }
+    }
+}
+
+static void el_post_drain(el_watch_t *watch, int events)
+{
+    el_loop_t *el;
+    el_post_node_t *node, *prev, *next;
+    uint64_t count;
+
+    el = (el_loop_t *)watch->data;
+
+    /* reset the eventfd before taking the list, a later push wakes us again */
+    (void)read(el->post_fd, &count, sizeof(count));
+
+    node = __atomic_exchange_n(&el->post_head, NULL, __ATOMIC_ACQUIRE);
+    
+    prev = NULL;
+    while (node) {
+        next = node->next;
+        node->next = prev;
+        prev = node;
+        node = next;
+    }
+
+    for (node = prev; node != NULL; node = next) {
+        next = node->next;
+        node->handler(node->data);
+        if (node->done) {
+            sem_post(node->done);
+        } else {
+            free(node);
+        }
+    }
+}
+
+int el_post(el_loop_t *el, el_post_handler handler, void *data)
+{
+    el_post_node_t *node;
+
+    if ((el == NULL) || (handler == NULL)) {
+        EL_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    node = (el_post_node_t *)malloc(sizeof(el_post_node_t));
+    if (node == NULL) {
+        EL_ERROR("%s: malloc failed\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    node->handler = handler;
+    node->data = data;
+    node->done = NULL;
+    el_post_push(el, node);
+
+    return 0;
+}
+
+int el_call(el_loop_t *el, el_post_handler handler, void *data)
+{
+    el_post_node_t node;
+    sem_t done;
+
+    if ((el == NULL) || (handler == NULL)) {
+        EL_ERROR("%s: invalid argument\r\n", __func__);
+        return -EINVAL;
+    }
+
+    if (el_context(el) != EL_CTX_FOREIGN) {
+        handler(data);
+        return 0;
+    }
+
+    if (sem_init(&done, 0, 0) < 0) {
+        EL_ERROR("%s: init semaphore failed cause %s\r\n", __func__, strerror(errno));
+        return -EPERM;
+    }
+
+    node.handler = handler;
+    node.data = data;
+    node.done = &done;
+    el_post_push(el, &node);
+
+    while ((sem_wait(&done) < 0) && (errno == EINTR)) {
+        ;
+    }
+    sem_destroy(&done);
+
+    return 0;
+}
+
 static el_watch_impl_t *alloc_watch(el_loop_t *el)
 {
     el_watch_impl_t *watch;
@@ -61,10 +197,71 @@ static void dealloc_watch(el_loop_t *el, el_watch_impl_t *watch)
     }
 }
 
+static EL_CONTEXT el_enter(el_loop_t *el)
+{
+    EL_CONTEXT ctx;
+
+    ctx = el_context(el);
+    if (ctx == EL_CTX_LOCKED) {
+        pthread_mutex_lock(&el->sync_lock);
+    }
+
+    return ctx;
+}
+
+static void el_leave(el_loop_t *el, EL_CONTEXT ctx)
+{
+    if (ctx == EL_CTX_LOCKED) {
+        pthread_mutex_unlock(&el->sync_lock);
+    }
+}
+
+/* a timer or watch change handed to the loop by another thread */
+typedef struct el_op_s {
+    el_post_node_t node;            /* first, the loop frees the op through it */
+    el_loop_t *el;
+    void *obj;
+    unsigned timeout;
+    bool destroy;
+} el_op_t;
+
+static int el_op_post(el_loop_t *el, el_post_handler handler, void *obj, unsigned timeout,
+            bool destroy)
+{
+    el_op_t *op;
+
+    op = (el_op_t *)malloc(sizeof(el_op_t));
+    if (op == NULL) {
+        EL_ERROR("%s: malloc failed\r\n", __func__);
+        return -ENOMEM;
+    }
+
+    op->node.handler = handler;
+    op->node.data = op;
+    op->node.done = NULL;
+    op->el = el;
+    op->obj = obj;
+    op->timeout = timeout;
+    op->destroy = destroy;
+    el_post_push(el, &op->node);
+
+    return 0;
+}
+
+static void el_watch_recycle_op(void *data)
+{
+    el_op_t *op = (el_op_t *)data;
+    el_watch_impl_t *watch = (el_watch_impl_t *)op->obj;
+
+    list_add_tail(&watch->list, &op->el->recy_watch_head);
+    op->el->recy_watch_count++;
+}
+
 el_watch_t *el_watch_create(el_loop_t *el, int fd, int events)
 {
     struct epoll_event ev;
     el_watch_impl_t *watch;
+    EL_CONTEXT ctx;
     int rv;
 
     if (el == NULL) {
@@ -77,11 +274,21 @@ el_watch_t *el_watch_create(el_loop_t *el, int fd, int events)
         return NULL;
     }
 
-    pthread_mutex_lock(&el->sync_lock);
+    ctx = el_enter(el);
+
+    /* the free list belongs to the loop thread */
+    if (ctx == EL_CTX_FOREIGN) {
+        watch = (el_watch_impl_t *)malloc(sizeof(el_watch_impl_t));
+        if (watch != NULL) {
+            watch->base.handler = NULL;
+            watch->base.data = 0;
+        }
+    } else {
+        watch = alloc_watch(el);
+    }
     
-    watch = alloc_watch(el);
     if (watch == NULL) {
-        pthread_mutex_unlock(&el->sync_lock);
+        el_leave(el, ctx);
         EL_ERROR("%s: alloc watch failed\r\n", __func__);
         return NULL;
     }
@@ -92,12 +299,16 @@ el_watch_t *el_watch_create(el_loop_t *el, int fd, int events)
     rv = epoll_ctl(el->epoll_fd, EPOLL_CTL_ADD, fd, &ev);
     if (rv < 0) {
         EL_ERROR("%s: epoll_ctl add failed cause %s\r\n", __func__, strerror(errno));
-        dealloc_watch(el, watch);
-        pthread_mutex_unlock(&el->sync_lock);
+        if (ctx == EL_CTX_FOREIGN) {
+            free(watch);
+        } else {
+            dealloc_watch(el, watch);
+        }
+        el_leave(el, ctx);
         return NULL;
     }
 
-    pthread_mutex_unlock(&el->sync_lock);
+    el_leave(el, ctx);
     
     return &watch->base;
 }
@@ -122,17 +333,14 @@ int el_watch_mod(el_loop_t *el, el_watch_t *base, int events)
         EL_ERROR("%s: invalid watch fd(%d)\r\n", __func__, watch->fd);
         return -EINVAL;
     }
-    
-    pthread_mutex_lock(&el->sync_lock);
 
+    /* only touches the kernel epoll set, safe from any thread */
     ev.events = events;
     ev.data.ptr = base;
     rv = epoll_ctl(el->epoll_fd, EPOLL_CTL_MOD, watch->fd, &ev);
     if (rv < 0) {
         EL_ERROR("%s: epoll_ctl mod failed cause %s\r\n", __func__, strerror(errno));
     }
-
-    pthread_mutex_unlock(&el->sync_lock);
     
     return rv;
 }
@@ -140,6 +348,7 @@ int el_watch_mod(el_loop_t *el, el_watch_t *base, int events)
 int el_watch_destroy(el_loop_t *el, el_watch_t *base)
 {
     el_watch_impl_t *watch = (el_watch_impl_t *)base;
+    EL_CONTEXT ctx;
     int rv;
 
     if (el == NULL) {
@@ -157,18 +366,23 @@ int el_watch_destroy(el_loop_t *el, el_watch_t *base)
         return -EINVAL;
     }
     
-    pthread_mutex_lock(&el->sync_lock);
+    ctx = el_enter(el);
 
     rv = epoll_ctl(el->epoll_fd, EPOLL_CTL_DEL, watch->fd, NULL);
     if (rv < 0) {
         EL_ERROR("%s: epoll_ctl del failed cause %s\r\n", __func__, strerror(errno));
-    }  else {
-        watch->fd = -1;
-        list_add_tail(&watch->list, &el->recy_watch_head);
-        el->recy_watch_count++;
+    } else {
+        /* the loop skips it from now on, and recycles it between two epoll_wait */
+        __atomic_store_n(&watch->fd, -1, __ATOMIC_RELEASE);
+        if (ctx == EL_CTX_FOREIGN) {
+            rv = el_op_post(el, el_watch_recycle_op, watch, 0, false);
+        } else {
+            list_add_tail(&watch->list, &el->recy_watch_head);
+            el->recy_watch_count++;
+        }
     }
 
-    pthread_mutex_unlock(&el->sync_lock);
+    el_leave(el, ctx);
     
     return rv;
 }
@@ -206,6 +420,10 @@ void el_sync(el_loop_t *el)
     
     --el->busy;
     pthread_mutex_unlock(&el->sync_lock);
+
+    if (el_sync_depth++ == 0) {
+        el_synced = el;
+    }
 }
 
 void el_unsync(el_loop_t *el)
@@ -220,6 +438,10 @@ void el_unsync(el_loop_t *el)
         return;
     }
     
+    if (--el_sync_depth == 0) {
+        el_synced = NULL;
+    }
+
     pthread_mutex_lock(&el->sync_lock);
     if (++el->busy == 0) {
         pthread_cond_signal(&el->sync_cond);
@@ -285,6 +507,8 @@ static el_timer_impl_t *alloc_timer(el_loop_t *el)
             INIT_LIST_HEAD(&timer->list);
             timer->base.handler = NULL;
             timer->base.data = 0;
+            timer->pending = 0;
+            timer->dead = false;
         }
     } else {
         timer = list_first_entry(&el->free_timer_head, el_timer_impl_t, free_list);
@@ -292,6 +516,8 @@ static el_timer_impl_t *alloc_timer(el_loop_t *el)
         INIT_LIST_HEAD(&timer->list);
         timer->base.handler = NULL;
         timer->base.data = 0;
+        timer->pending = 0;
+        timer->dead = false;
         el->free_timer_count--;
     }
     
@@ -334,27 +560,85 @@ static void _queue_timer(el_loop_t *el, el_timer_impl_t *timer, unsigned timeout
     }
 }
 
+/* run on the loop thread, applies a change posted by another thread */
+static void el_timer_op(void *data)
+{
+    el_op_t *op = (el_op_t *)data;
+    el_timer_impl_t *timer = (el_timer_impl_t *)op->obj;
+
+    if (op->destroy) {
+        if (!list_empty(&timer->list)) {
+            list_del_init(&timer->list);
+        }
+        timer->dead = true;
+    } else if (!__atomic_load_n(&timer->dead, __ATOMIC_ACQUIRE)) {
+        if (!list_empty(&timer->list)) {
+            __list_del_entry(&timer->list);
+        }
+        _queue_timer(op->el, timer, op->timeout);
+    }
+
+    if ((__atomic_sub_fetch(&timer->pending, 1, __ATOMIC_ACQ_REL) == 0) && timer->dead) {
+        dealloc_timer(op->el, timer);
+    }
+}
+
+static int el_timer_post(el_loop_t *el, el_timer_impl_t *timer, unsigned timeout, bool destroy)
+{
+    int rv;
+
+    __atomic_add_fetch(&timer->pending, 1, __ATOMIC_ACQ_REL);
+    rv = el_op_post(el, el_timer_op, timer, timeout, destroy);
+    if (rv < 0) {
+        __atomic_sub_fetch(&timer->pending, 1, __ATOMIC_ACQ_REL);
+    }
+
+    return rv;
+}
+
 el_timer_t *el_timer_create(el_loop_t *el, unsigned timeout)
 {
     el_timer_impl_t *timer;
+    EL_CONTEXT ctx;
     
     if (el == NULL) {
         EL_ERROR("%s: null event loop\r\n", __func__);
         return NULL;
     }
-    
-    pthread_mutex_lock(&el->sync_lock);
+
+    ctx = el_enter(el);
+
+    if (ctx == EL_CTX_FOREIGN) {
+        /* the free list and the wheel belong to the loop thread */
+        timer = (el_timer_impl_t *)malloc(sizeof(el_timer_impl_t));
+        if (timer == NULL) {
+            EL_ERROR("%s: not enough memory\r\n", __func__);
+            return NULL;
+        }
+
+        INIT_LIST_HEAD(&timer->list);
+        timer->base.handler = NULL;
+        timer->base.data = 0;
+        timer->pending = 0;
+        timer->dead = false;
+        if (el_timer_post(el, timer, timeout, false) < 0) {
+            free(timer);
+            return NULL;
+        }
+
+        return &timer->base;
+    }
 
     timer = alloc_timer(el);
     if (timer == NULL) {
-        pthread_mutex_unlock(&el->sync_lock);
+        el_leave(el, ctx);
         EL_ERROR("%s: alloc timer failed\r\n", __func__);
         return NULL;
     }
 
     _queue_timer(el, timer, timeout);
     
-    pthread_mutex_unlock(&el->sync_lock);
+    el_leave(el, ctx);
     
     return &timer->base;
 }
@@ -362,6 +646,7 @@ el_timer_t *el_timer_create(el_loop_t *el, unsigned timeout)
 int el_timer_mod(el_loop_t *el, el_timer_t *base, unsigned timeout)
 {
     el_timer_impl_t *timer = (el_timer_impl_t *)base;
+    EL_CONTEXT ctx;
     
     if (el == NULL) {
         EL_ERROR("%s: null event loop\r\n", __func__);
@@ -373,13 +658,17 @@ int el_timer_mod(el_loop_t *el, el_timer_t *base, unsigned timeout)
         return -EINVAL;
     }
 
-    pthread_mutex_lock(&el->sync_lock);
+    ctx = el_enter(el);
 
-    if (timer->list.next == NULL) {
-        pthread_mutex_unlock(&el->sync_lock);
+    if ((timer->list.next == NULL) || __atomic_load_n(&timer->dead, __ATOMIC_ACQUIRE)) {
+        el_leave(el, ctx);
         EL_ERROR("%s: invalid timer\r\n", __func__);
         return -EPERM;
     }
+
+    if (ctx == EL_CTX_FOREIGN) {
+        return el_timer_post(el, timer, timeout, false);
+    }
     
     if (!list_empty(&timer->list)) {
         __list_del_entry(&timer->list);
@@ -387,7 +676,7 @@ int el_timer_mod(el_loop_t *el, el_timer_t *base, unsigned timeout)
 
     _queue_timer(el, timer, timeout);
 
-    pthread_mutex_unlock(&el->sync_lock);
+    el_leave(el, ctx);
 
     return 0;
 }
@@ -395,6 +684,7 @@ int el_timer_mod(el_loop_t *el, el_timer_t *base, unsigned timeout)
 int el_timer_destroy(el_loop_t *el, el_timer_t *base)
 {
     el_timer_impl_t *timer = (el_timer_impl_t *)base;
+    EL_CONTEXT ctx;
     int rv;
     
     if (el == NULL) {
@@ -409,21 +699,33 @@ int el_timer_destroy(el_loop_t *el, el_timer_t *base)
 
     rv = 0;
     
-    pthread_mutex_lock(&el->sync_lock);
+    ctx = el_enter(el);
 
-    if (timer->list.next == NULL) {
-        pthread_mutex_unlock(&el->sync_lock);
+    if ((timer->list.next == NULL) || __atomic_load_n(&timer->dead, __ATOMIC_ACQUIRE)) {
+        el_leave(el, ctx);
         EL_ERROR("%s: invalid timer\r\n", __func__);
         return -EPERM;
     }
+
+    if (ctx == EL_CTX_FOREIGN) {
+        /* stops it firing at once, whether it was queued is only known to the loop */
+        __atomic_store_n(&timer->dead, true, __ATOMIC_RELEASE);
+        rv = el_timer_post(el, timer, 0, true);
+        return (rv < 0) ? rv : 0;
+    }
     
     if (!list_empty(&timer->list)) {
-        __list_del_entry(&timer->list);
+        list_del_init(&timer->list);
         rv = 1;
     }
-    dealloc_timer(el, timer);
 
-    pthread_mutex_unlock(&el->sync_lock);
+    if (__atomic_load_n(&timer->pending, __ATOMIC_ACQUIRE)) {
+        timer->dead = true;     /* the last posted op frees it */
+    } else {
+        dealloc_timer(el, timer);
+    }
+
+    el_leave(el, ctx);
     
     return rv;
 }
@@ -482,7 +784,7 @@ static void recycle_watch(el_loop_t *el)
     el->recy_watch_count = 0;
 
     while (el->free_watch_count > RESERVE_WATCH) {
-        if (list_empty(&el->free_watch_head)) {
+        if (!list_empty(&el->free_watch_head)) {
             watch = list_first_entry(&el->free_watch_head, el_watch_impl_t, list);
             __list_del_entry(&watch->list);
             free(watch);
@@ -539,6 +841,8 @@ static void *event_loop_func(el_loop_t *el)
     struct epoll_event evlist[MAX_EVENTS];
     el_watch_impl_t *watch;
     el_watch_handler handler;
+    uint64_t start;
+    int watch_perf, timer_perf;
     int wait_ms;
     int nfds = 0;
     int rv;
@@ -546,6 +850,11 @@ static void *event_loop_func(el_loop_t *el)
 
     prctl(PR_SET_NAME, "eventloop_pthr");
 
+    el->epoll_thread = pthread_self();
+
+    watch_perf = perf_hist_register("el.watch_callback");
+    timer_perf = perf_hist_register("el.timer_callback");
+
     rv = pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
     if (rv != 0) {
         EL_ERROR("%s: setcancelstate failed cause %s\r\n", __func__, strerror(rv));
@@ -584,7 +893,7 @@ static void *event_loop_func(el_loop_t *el)
 
         for (i = 0; i < nfds; ++i) {
             watch = (el_watch_impl_t *)(evlist[i].data.ptr);
-            if ((watch != NULL) && (watch->fd != -1)) {
+            if ((watch != NULL) && (__atomic_load_n(&watch->fd, __ATOMIC_ACQUIRE) != -1)) {
                 handler = watch->base.handler;
                 if (handler == NULL) {
                     EL_WARN("%s: fd(%d) null handler\r\n", __func__, watch->fd);
@@ -592,7 +901,9 @@ static void *event_loop_func(el_loop_t *el)
                 }
 
                 pthread_mutex_unlock(&el->sync_lock);
+                start = perf_now_ns();
                 handler(&watch->base, evlist[i].events);
+                perf_hist_since(watch_perf, start);
                 pthread_mutex_lock(&el->sync_lock);
             }
         }
@@ -609,13 +920,19 @@ static void *event_loop_func(el_loop_t *el)
                 el_timer_handler handler = timer->base.handler;
 
                 list_del_init(&timer->list);
+                if (__atomic_load_n(&timer->dead, __ATOMIC_ACQUIRE)) {
+                    continue;   /* destroyed by another thread, op not applied yet */
+                }
+
                 if (handler == NULL) {
                     EL_WARN("%s: null handler\r\n", __func__);
                     continue;
                 }
 
                 pthread_mutex_unlock(&el->sync_lock);
+                start = perf_now_ns();
                 handler(&timer->base);
+                perf_hist_since(timer_perf, start);
                 pthread_mutex_lock(&el->sync_lock);
             } while (!list_empty(&el->to_timer));
         }
@@ -648,6 +965,7 @@ exit:
 
 int el_loop_init(el_loop_t *el)
 {
+    struct epoll_event ev;
     struct timespec ts;
     int i;
     int rv;
@@ -680,6 +998,24 @@ int el_loop_init(el_loop_t *el)
         goto out1;
     }
 
+    el->post_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (el->post_fd < 0) {
+        EL_ERROR("%s: create eventfd failed cause %s\r\n", __func__, strerror(errno));
+        goto out2;
+    }
+
+    el->post_head = NULL;
+    el->post_watch.base.handler = el_post_drain;
+    el->post_watch.base.data = el;
+    el->post_watch.fd = el->post_fd;
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = &el->post_watch;
+    if (epoll_ctl(el->epoll_fd, EPOLL_CTL_ADD, el->post_fd, &ev) < 0) {
+        EL_ERROR("%s: epoll_ctl add eventfd failed cause %s\r\n", __func__, strerror(errno));
+        goto out3;
+    }
+
     el->busy = 0;
     el->started = 0;
     INIT_LIST_HEAD(&el->free_watch_head);
@@ -697,7 +1033,7 @@ int el_loop_init(el_loop_t *el)
     rv = clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
     if (rv < 0) {
         EL_ERROR("%s: clock gettime failed cause %s\r\n", __func__, strerror(errno));
-        goto out2;
+        goto out3;
     }
 
     el->curr_tick = ts.tv_sec * (1000 / TIMER_GRANULARITY)
@@ -705,6 +1041,9 @@ int el_loop_init(el_loop_t *el)
     el->inited = true;
     return 0;
 
+out3:
+    close(el->post_fd);
+
 out2:
     close(el->epoll_fd);
 
@@ -741,15 +1080,17 @@ int el_loop_start(el_loop_t *el)
         rv = 0;
     }
 
+    /* from here on other threads hand their changes to the loop thread */
+    __atomic_store_n(&el->started, 1, __ATOMIC_RELEASE);
+
     rv = pthread_create(&el->epoll_thread, NULL, (void*(*)(void*))event_loop_func, el);
     if (rv != 0) {
         EL_ERROR("%s: create thread failed cause %s\r\n", __func__, strerror(rv));
+        __atomic_store_n(&el->started, 0, __ATOMIC_RELEASE);
         rv = -EPERM;
         goto out;
     }
 
-    el->started = 1;
-
 out:
     pthread_mutex_unlock(&el->sync_lock);
     
@@ -15,9 +15,11 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <semaphore.h>
 
 #include "misc/list.h"
 #include "misc/eventloop.h"
+#include "misc/trace.h"
 
 extern bool el_dbg_verbos;
 extern bool el_dbg_warn;
@@ -26,21 +28,21 @@ extern bool el_dbg_err;
 #define EL_ERROR(fmt, args...)                      \
 do {                                                \
     if (el_dbg_err) {                               \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define EL_WARN(fmt, args...)                       \
 do {                                                \
     if (el_dbg_warn) {                              \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define EL_VERBOS(fmt, args...)                     \
 do {                                                \
     if (el_dbg_verbos) {                            \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
@@ -58,6 +60,14 @@ do {                                                \
 /* 豣֤ܱ1000 */
 #define TIMER_GRANULARITY                   (100)
 
+/* a closure in the mailbox, freed by the loop unless a caller waits on done */
+typedef struct el_post_node_s {
+    struct el_post_node_s *next;
+    el_post_handler handler;
+    void *data;
+    sem_t *done;
+} el_post_node_t;
+
 typedef struct el_watch_impl_s {
     union {
         el_watch_t base;
@@ -73,6 +83,8 @@ typedef struct el_timer_impl_s {
     };
     struct list_head list;
     unsigned expires;
+    unsigned pending;               /* ops posted by other threads, not applied yet */
+    bool dead;                      /* destroyed, freed once pending drops to 0 */
 } el_timer_impl_t;
 
 struct el_loop_s {
@@ -95,6 +107,10 @@ struct el_loop_s {
     unsigned curr_tick;
     struct list_head wheel_list[TVR_SIZE + TVN_SIZE * TVN_NUMS];
     struct list_head to_timer;          /* timer already timeout */
+
+    int post_fd;                        /* eventfd, readable while the mailbox is not empty */
+    el_watch_impl_t post_watch;
+    el_post_node_t *post_head;          /* lock-free LIFO, the loop drains and reverses it */
 };
 
 #endif /* _EVENTLOOP_DEF_H_ */
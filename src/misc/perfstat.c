@@ -0,0 +1,443 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * perfstat.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Performance statistics
+ *
+ * History
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+#include "misc/perfstat.h"
+#include "misc/list.h"
+
+typedef struct perf_shard_s {
+    struct list_head list;
+    uint32_t gen;
+    perf_hist_t *hists[PERF_MAX_HIST];
+    uint64_t counters[PERF_MAX_COUNTER];
+} perf_shard_t;
+
+bool perf_enabled = true;
+
+static pthread_mutex_t perf_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t perf_once = PTHREAD_ONCE_INIT;
+static pthread_key_t perf_key;
+
+static LIST_HEAD(perf_shard_list);
+
+/* shards of exited threads are folded in here */
+static perf_shard_t perf_retired;
+
+static uint32_t perf_gen;
+
+static char perf_hist_names[PERF_MAX_HIST][PERF_NAME_MAX] = {"overflow"};
+static uint32_t perf_hist_nums = 1;
+
+static char perf_counter_names[PERF_MAX_COUNTER][PERF_NAME_MAX] = {"overflow"};
+static uint32_t perf_counter_nums = 1;
+
+static __thread perf_shard_t *perf_shard;
+
+static unsigned perf_hist_index(uint64_t v)
+{
+    unsigned msb;
+
+    if (v < (1U << PERF_HIST_SUB_BITS)) {
+        return (unsigned)v;
+    }
+
+    msb = 63 - __builtin_clzll(v);
+
+    return ((msb - PERF_HIST_SUB_BITS + 1) << PERF_HIST_SUB_BITS)
+        + ((v >> (msb - PERF_HIST_SUB_BITS)) & ((1U << PERF_HIST_SUB_BITS) - 1));
+}
+
+static uint64_t perf_hist_value(unsigned idx)
+{
+    unsigned shift;
+
+    if (idx < (1U << PERF_HIST_SUB_BITS)) {
+        return idx;
+    }
+
+    shift = (idx >> PERF_HIST_SUB_BITS) - 1;
+
+    return (uint64_t)((1U << PERF_HIST_SUB_BITS)
+        + (idx & ((1U << PERF_HIST_SUB_BITS) - 1))) << shift;
+}
+
+void perf_hist_add(perf_hist_t *hist, uint64_t ns)
+{
+    hist->count++;
+    hist->total_ns += ns;
+    if (ns > hist->max_ns) {
+        hist->max_ns = ns;
+    }
+    hist->buckets[perf_hist_index(ns)]++;
+}
+
+void perf_hist_merge(perf_hist_t *dst, const perf_hist_t *src)
+{
+    unsigned i;
+
+    if (src->count == 0) {
+        return;
+    }
+
+    dst->count += src->count;
+    dst->total_ns += src->total_ns;
+    if (src->max_ns > dst->max_ns) {
+        dst->max_ns = src->max_ns;
+    }
+
+    for (i = 0; i < PERF_HIST_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+}
+
+uint64_t perf_hist_percentile(const perf_hist_t *hist, uint32_t permille)
+{
+    uint64_t target, sum, value;
+    unsigned i;
+
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    target = (hist->count * permille + 999) / 1000;
+    sum = 0;
+    for (i = 0; i < PERF_HIST_BUCKETS; i++) {
+        sum += hist->buckets[i];
+        if (sum >= target) {
+            value = perf_hist_value(i);
+            return (value < hist->max_ns)? value: hist->max_ns;
+        }
+    }
+
+    return hist->max_ns;
+}
+
+cJSON *perf_hist_to_json(const perf_hist_t *hist)
+{
+    cJSON *result;
+
+    result = cJSON_CreateObject();
+    if (result == NULL) {
+        return NULL;
+    }
+
+    cJSON_AddNumberToObject(result, "count", hist->count);
+    cJSON_AddNumberToObject(result, "avg_ns", hist->count? hist->total_ns / hist->count: 0);
+    cJSON_AddNumberToObject(result, "p50_ns", perf_hist_percentile(hist, 500));
+    cJSON_AddNumberToObject(result, "p90_ns", perf_hist_percentile(hist, 900));
+    cJSON_AddNumberToObject(result, "p99_ns", perf_hist_percentile(hist, 990));
+    cJSON_AddNumberToObject(result, "p999_ns", perf_hist_percentile(hist, 999));
+    cJSON_AddNumberToObject(result, "max_ns", hist->max_ns);
+
+    return result;
+}
+
+static void perf_shard_fold(perf_shard_t *dst, perf_shard_t *src)
+{
+    unsigned i;
+
+    for (i = 0; i < PERF_MAX_HIST; i++) {
+        if (src->hists[i] == NULL) {
+            continue;
+        }
+        if (dst->hists[i] == NULL) {
+            dst->hists[i] = (perf_hist_t *)calloc(1, sizeof(perf_hist_t));
+            if (dst->hists[i] == NULL) {
+                continue;
+            }
+        }
+        perf_hist_merge(dst->hists[i], src->hists[i]);
+    }
+
+    for (i = 0; i < PERF_MAX_COUNTER; i++) {
+        dst->counters[i] += src->counters[i];
+    }
+}
+
+static void perf_shard_destroy(void *arg)
+{
+    perf_shard_t *shard;
+    unsigned i;
+
+    shard = (perf_shard_t *)arg;
+
+    pthread_mutex_lock(&perf_mutex);
+    list_del(&shard->list);
+    if (shard->gen == perf_gen) {
+        perf_shard_fold(&perf_retired, shard);
+    }
+    pthread_mutex_unlock(&perf_mutex);
+
+    for (i = 0; i < PERF_MAX_HIST; i++) {
+        free(shard->hists[i]);
+    }
+    free(shard);
+}
+
+static void perf_key_create(void)
+{
+    (void)pthread_key_create(&perf_key, perf_shard_destroy);
+}
+
+static perf_shard_t *perf_shard_create(void)
+{
+    perf_shard_t *shard;
+
+    (void)pthread_once(&perf_once, perf_key_create);
+
+    shard = (perf_shard_t *)calloc(1, sizeof(perf_shard_t));
+    if (shard == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&perf_mutex);
+    shard->gen = perf_gen;
+    list_add_tail(&shard->list, &perf_shard_list);
+    pthread_mutex_unlock(&perf_mutex);
+
+    (void)pthread_setspecific(perf_key, shard);
+    perf_shard = shard;
+
+    return shard;
+}
+
+static perf_shard_t *perf_get_shard(void)
+{
+    perf_shard_t *shard;
+    uint32_t gen;
+    unsigned i;
+
+    shard = perf_shard;
+    if (__builtin_expect(shard == NULL, 0)) {
+        shard = perf_shard_create();
+        if (shard == NULL) {
+            return NULL;
+        }
+    }
+
+    gen = __atomic_load_n(&perf_gen, __ATOMIC_ACQUIRE);
+    if (__builtin_expect(shard->gen != gen, 0)) {
+        for (i = 0; i < PERF_MAX_HIST; i++) {
+            if (shard->hists[i]) {
+                memset(shard->hists[i], 0, sizeof(perf_hist_t));
+            }
+        }
+        memset(shard->counters, 0, sizeof(shard->counters));
+        __atomic_store_n(&shard->gen, gen, __ATOMIC_RELEASE);
+    }
+
+    return shard;
+}
+
+static int perf_register(char names[][PERF_NAME_MAX], uint32_t *nums, uint32_t max,
+            const char *fmt, va_list ap)
+{
+    char name[PERF_NAME_MAX];
+    uint32_t i;
+    int id;
+
+    (void)vsnprintf(name, sizeof(name), fmt, ap);
+
+    pthread_mutex_lock(&perf_mutex);
+
+    id = PERF_INVALID_ID;
+    for (i = 1; i < *nums; i++) {
+        if (strcmp(names[i], name) == 0) {
+            id = i;
+            goto out;
+        }
+    }
+
+    if (*nums < max) {
+        id = *nums;
+        memcpy(names[id], name, sizeof(name));
+        __atomic_store_n(nums, *nums + 1, __ATOMIC_RELEASE);
+    }
+
+out:
+    pthread_mutex_unlock(&perf_mutex);
+
+    return id;
+}
+
+int perf_hist_register(const char *fmt, ...)
+{
+    va_list ap;
+    int id;
+
+    va_start(ap, fmt);
+    id = perf_register(perf_hist_names, &perf_hist_nums, PERF_MAX_HIST, fmt, ap);
+    va_end(ap);
+
+    return id;
+}
+
+int perf_counter_register(const char *fmt, ...)
+{
+    va_list ap;
+    int id;
+
+    va_start(ap, fmt);
+    id = perf_register(perf_counter_names, &perf_counter_nums, PERF_MAX_COUNTER, fmt, ap);
+    va_end(ap);
+
+    return id;
+}
+
+void perf_hist_record(int id, uint64_t ns)
+{
+    perf_shard_t *shard;
+    perf_hist_t *hist;
+
+    if (!perf_enabled || (id < 0) || (id >= PERF_MAX_HIST)) {
+        return;
+    }
+
+    shard = perf_get_shard();
+    if (shard == NULL) {
+        return;
+    }
+
+    hist = shard->hists[id];
+    if (__builtin_expect(hist == NULL, 0)) {
+        hist = (perf_hist_t *)calloc(1, sizeof(perf_hist_t));
+        if (hist == NULL) {
+            return;
+        }
+        __atomic_store_n(&shard->hists[id], hist, __ATOMIC_RELEASE);
+    }
+
+    perf_hist_add(hist, ns);
+}
+
+void perf_hist_since(int id, uint64_t start)
+{
+    if (start == 0) {
+        return;
+    }
+
+    perf_hist_record(id, perf_now_ns() - start);
+}
+
+void perf_counter_add(int id, uint64_t value)
+{
+    perf_shard_t *shard;
+
+    if (!perf_enabled || (id < 0) || (id >= PERF_MAX_COUNTER)) {
+        return;
+    }
+
+    shard = perf_get_shard();
+    if (shard == NULL) {
+        return;
+    }
+
+    shard->counters[id] += value;
+}
+
+void perf_reset(void)
+{
+    unsigned i;
+
+    pthread_mutex_lock(&perf_mutex);
+
+    __atomic_add_fetch(&perf_gen, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < PERF_MAX_HIST; i++) {
+        free(perf_retired.hists[i]);
+        perf_retired.hists[i] = NULL;
+    }
+    memset(perf_retired.counters, 0, sizeof(perf_retired.counters));
+
+    pthread_mutex_unlock(&perf_mutex);
+}
+
+void perf_set_enable(bool enable)
+{
+    perf_enabled = enable;
+}
+
+cJSON *perf_get_status(void)
+{
+    perf_shard_t *shard;
+    perf_hist_t *sum, *hist;
+    cJSON *reply, *hists, *counters, *tmp;
+    uint64_t value;
+    uint32_t i, gen;
+
+    sum = (perf_hist_t *)malloc(sizeof(perf_hist_t));
+    if (sum == NULL) {
+        return NULL;
+    }
+
+    reply = cJSON_CreateObject();
+    hists = cJSON_CreateObject();
+    counters = cJSON_CreateObject();
+    if ((reply == NULL) || (hists == NULL) || (counters == NULL)) {
+        cJSON_Delete(reply);
+        cJSON_Delete(hists);
+        cJSON_Delete(counters);
+        free(sum);
+        return NULL;
+    }
+    cJSON_AddBoolToObject(reply, "enable", perf_enabled);
+    cJSON_AddItemToObject(reply, "histograms", hists);
+    cJSON_AddItemToObject(reply, "counters", counters);
+
+    pthread_mutex_lock(&perf_mutex);
+
+    gen = perf_gen;
+    for (i = 0; i < perf_hist_nums; i++) {
+        memset(sum, 0, sizeof(perf_hist_t));
+        if (perf_retired.hists[i]) {
+            perf_hist_merge(sum, perf_retired.hists[i]);
+        }
+        list_for_each_entry(shard, &perf_shard_list, list) {
+            hist = __atomic_load_n(&shard->hists[i], __ATOMIC_ACQUIRE);
+            if ((hist != NULL) && (__atomic_load_n(&shard->gen, __ATOMIC_ACQUIRE) == gen)) {
+                perf_hist_merge(sum, hist);
+            }
+        }
+
+        if (sum->count == 0) {
+            continue;
+        }
+
+        tmp = perf_hist_to_json(sum);
+        if (tmp) {
+            cJSON_AddItemToObject(hists, perf_hist_names[i], tmp);
+        }
+    }
+
+    for (i = 0; i < perf_counter_nums; i++) {
+        value = perf_retired.counters[i];
+        list_for_each_entry(shard, &perf_shard_list, list) {
+            if (__atomic_load_n(&shard->gen, __ATOMIC_ACQUIRE) == gen) {
+                value += shard->counters[i];
+            }
+        }
+
+        if (value) {
+            cJSON_AddNumberToObject(counters, perf_counter_names[i], value);
+        }
+    }
+
+    pthread_mutex_unlock(&perf_mutex);
+
+    free(sum);
+
+    return reply;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * rcu.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Userspace read-copy-update
+ *
+ * History
+ */
+
+#include <sched.h>
+#include <pthread.h>
+
+#include "misc/rcu.h"
+
+uint64_t rcu_gp_ctr = 1;
+
+__thread rcu_reader_t rcu_reader;
+
+/* protects rcu_reader_list and serializes grace periods */
+static pthread_mutex_t rcu_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t rcu_once = PTHREAD_ONCE_INIT;
+static pthread_key_t rcu_key;
+
+static LIST_HEAD(rcu_reader_list);
+
+static void rcu_reader_unregister(void *arg)
+{
+    rcu_reader_t *reader;
+
+    reader = (rcu_reader_t *)arg;
+
+    pthread_mutex_lock(&rcu_mutex);
+    list_del(&reader->list);
+    reader->registered = false;
+    pthread_mutex_unlock(&rcu_mutex);
+}
+
+static void rcu_key_create(void)
+{
+    (void)pthread_key_create(&rcu_key, rcu_reader_unregister);
+}
+
+void rcu_reader_register(void)
+{
+    (void)pthread_once(&rcu_once, rcu_key_create);
+
+    pthread_mutex_lock(&rcu_mutex);
+    rcu_reader.ctr = 0;
+    rcu_reader.nesting = 0;
+    list_add_tail(&rcu_reader.list, &rcu_reader_list);
+    rcu_reader.registered = true;
+    pthread_mutex_unlock(&rcu_mutex);
+
+    (void)pthread_setspecific(rcu_key, &rcu_reader);
+}
+
+void synchronize_rcu(void)
+{
+    rcu_reader_t *reader;
+    uint64_t gp, ctr;
+
+    pthread_mutex_lock(&rcu_mutex);
+
+    /* the new pointer is visible to every reader that enters after this */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    gp = __atomic_add_fetch(&rcu_gp_ctr, 1, __ATOMIC_SEQ_CST);
+
+    list_for_each_entry(reader, &rcu_reader_list, list) {
+        if (reader == &rcu_reader) {
+            continue;
+        }
+
+        for (;;) {
+            ctr = __atomic_load_n(&reader->ctr, __ATOMIC_ACQUIRE);
+            if ((ctr == 0) || (ctr >= gp)) {
+                break;
+            }
+            sched_yield();
+        }
+    }
+
+    pthread_mutex_unlock(&rcu_mutex);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * slab.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Fixed-size object slab
+ *
+ * History
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "misc/slab.h"
+
+typedef struct slab_chunk_s {
+    struct list_head node;
+    uint8_t *start;
+    uint8_t *end;
+} __attribute__((aligned(16))) slab_chunk_t;
+
+void slab_init(slab_t *slab, size_t size)
+{
+    if (size < sizeof(void *)) {
+        size = sizeof(void *);
+    }
+
+    slab->size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    slab->grow = SLAB_GROW_MIN;
+    slab->total = 0;
+    slab->used = 0;
+    slab->chunks = 0;
+    slab->bytes = 0;
+    slab->free_list = NULL;
+    slab->next = NULL;
+    slab->limit = NULL;
+    INIT_LIST_HEAD(&slab->chunk_list);
+}
+
+static int _slab_grow(slab_t *slab, uint32_t count)
+{
+    slab_chunk_t *chunk;
+    size_t bytes;
+
+    bytes = sizeof(slab_chunk_t) + (size_t)slab->size * count;
+    chunk = (slab_chunk_t *)malloc(bytes);
+    if (chunk == NULL) {
+        return -ENOMEM;
+    }
+
+    /* the untouched tail of the previous chunk goes to the free list */
+    while (slab->next < slab->limit) {
+        *(void **)slab->next = slab->free_list;
+        slab->free_list = slab->next;
+        slab->next += slab->size;
+    }
+
+    chunk->start = (uint8_t *)(chunk + 1);
+    chunk->end = chunk->start + (size_t)slab->size * count;
+    list_add_tail(&chunk->node, &slab->chunk_list);
+
+    slab->next = chunk->start;
+    slab->limit = chunk->end;
+    slab->total += count;
+    slab->chunks++;
+    slab->bytes += bytes;
+
+    return 0;
+}
+
+int slab_reserve(slab_t *slab, uint32_t count)
+{
+    uint32_t avail;
+
+    avail = slab->total - slab->used;
+    if (avail >= count) {
+        return 0;
+    }
+
+    return _slab_grow(slab, count - avail);
+}
+
+void *slab_alloc(slab_t *slab)
+{
+    void *obj;
+
+    if (slab->free_list) {
+        obj = slab->free_list;
+        slab->free_list = *(void **)obj;
+    } else {
+        if (slab->next >= slab->limit) {
+            if (_slab_grow(slab, slab->grow) < 0) {
+                return NULL;
+            }
+            if (slab->grow < SLAB_GROW_MAX) {
+                slab->grow <<= 1;
+            }
+        }
+        obj = slab->next;
+        slab->next += slab->size;
+    }
+
+    slab->used++;
+    memset(obj, 0, slab->size);
+
+    return obj;
+}
+
+void slab_free(slab_t *slab, void *obj)
+{
+    if (obj == NULL) {
+        return;
+    }
+
+    *(void **)obj = slab->free_list;
+    slab->free_list = obj;
+    slab->used--;
+}
+
+bool slab_owns(const slab_t *slab, const void *obj)
+{
+    slab_chunk_t *chunk;
+
+    list_for_each_entry(chunk, &slab->chunk_list, node) {
+        if (((const uint8_t *)obj >= chunk->start) && ((const uint8_t *)obj < chunk->end)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void slab_destroy(slab_t *slab)
+{
+    slab_chunk_t *chunk, *tmp;
+
+    list_for_each_entry_safe(chunk, tmp, &slab->chunk_list, node) {
+        list_del(&chunk->node);
+        free(chunk);
+    }
+
+    slab_init(slab, slab->size);
+}
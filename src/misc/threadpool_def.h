@@ -16,6 +16,8 @@
 #include <misc/list.h>
 #include <misc/threadpool.h>
 
+#include "misc/trace.h"
+
 extern bool tp_dbg_verbos;
 extern bool tp_dbg_warn;
 extern bool tp_dbg_err;
@@ -23,21 +25,21 @@ extern bool tp_dbg_err;
 #define TP_ERROR(fmt, args...)                      \
 do {                                                \
     if (tp_dbg_err) {                               \
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define TP_WARN(fmt, args...)                       \
 do {                                                \
     if (tp_dbg_warn) {                              \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define TP_VERBOS(fmt, args...)                     \
 do {                                                \
     if (tp_dbg_verbos) {                            \
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
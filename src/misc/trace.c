@@ -0,0 +1,556 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * trace.c
+ * Original Author:  agent, 2026-10-19
+ *
+ * Binary trace ring
+ *
+ * History
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include "trace_def.h"
+
+bool trace_enabled = true;
+
+uint32_t trace_console_level = DEBUG_LEVEL_ERROR | DEBUG_LEVEL_WARN | DEBUG_LEVEL_VERBOS;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t trace_key;
+
+static LIST_HEAD(trace_ring_list);
+
+static __thread trace_ring_t *trace_ring;
+
+/* skip one conversion spec after '%', return its argument kinds */
+static const char *trace_parse_spec(const char *p, uint8_t *kinds, uint32_t *nkinds)
+{
+    uint32_t longs;
+    bool wide;
+
+    *nkinds = 0;
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+
+    if (*p == '*') {
+        kinds[(*nkinds)++] = TRACE_ARG_INT;
+        p++;
+    } else {
+        while ((*p >= '0') && (*p <= '9')) {
+            p++;
+        }
+    }
+
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            kinds[(*nkinds)++] = TRACE_ARG_INT;
+            p++;
+        } else {
+            while ((*p >= '0') && (*p <= '9')) {
+                p++;
+            }
+        }
+    }
+
+    longs = 0;
+    wide = false;
+    while (*p && strchr("hlLqjzt", *p)) {
+        if (*p == 'l') {
+            longs++;
+        } else if ((*p == 'q') || (*p == 'j') || (*p == 'z') || (*p == 't')) {
+            longs = 2;
+        } else if (*p == 'L') {
+            wide = true;
+        }
+        p++;
+    }
+
+    switch (*p) {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        kinds[(*nkinds)++] = (longs == 0)? TRACE_ARG_INT: (longs == 1)? TRACE_ARG_LONG:
+            TRACE_ARG_LLONG;
+        break;
+
+    case 'c':
+        kinds[(*nkinds)++] = longs? TRACE_ARG_NONE: TRACE_ARG_INT;
+        break;
+
+    case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        kinds[(*nkinds)++] = wide? TRACE_ARG_NONE: TRACE_ARG_DOUBLE;
+        break;
+
+    case 's':
+        kinds[(*nkinds)++] = longs? TRACE_ARG_NONE: TRACE_ARG_STR;
+        break;
+
+    case 'p':
+        kinds[(*nkinds)++] = TRACE_ARG_PTR;
+        break;
+
+    default:
+        kinds[(*nkinds)++] = TRACE_ARG_NONE;
+        return p;
+    }
+
+    return p + 1;
+}
+
+static void trace_site_parse(trace_site_t *site)
+{
+    uint8_t kinds[3];
+    const char *p;
+    uint32_t nargs, nkinds, i;
+
+    nargs = 0;
+    p = site->fmt;
+    while ((p = strchr(p, '%')) != NULL) {
+        p++;
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+
+        p = trace_parse_spec(p, kinds, &nkinds);
+        for (i = 0; i < nkinds; i++) {
+            if ((kinds[i] == TRACE_ARG_NONE) || (nargs >= TRACE_MAX_ARGS)) {
+                goto out;
+            }
+            site->kinds[nargs++] = kinds[i];
+        }
+    }
+
+out:
+    site->nargs = nargs;
+    __atomic_store_n(&site->parsed, 1, __ATOMIC_RELEASE);
+}
+
+static void trace_ring_destroy(void *arg)
+{
+    trace_ring_t *ring, *tmp;
+    uint32_t exited;
+
+    ring = (trace_ring_t *)arg;
+
+    pthread_mutex_lock(&trace_mutex);
+
+    ring->exited = true;
+    exited = 0;
+    list_for_each_entry(tmp, &trace_ring_list, list) {
+        if (tmp->exited) {
+            exited++;
+        }
+    }
+
+    if (exited > TRACE_MAX_EXITED_RING) {
+        list_for_each_entry(tmp, &trace_ring_list, list) {
+            if (tmp->exited) {
+                list_del(&tmp->list);
+                free(tmp);
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+static void trace_key_create(void)
+{
+    (void)pthread_key_create(&trace_key, trace_ring_destroy);
+}
+
+static trace_ring_t *trace_ring_create(void)
+{
+    trace_ring_t *ring;
+
+    (void)pthread_once(&trace_once, trace_key_create);
+
+    ring = (trace_ring_t *)calloc(1, sizeof(trace_ring_t));
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->tid = (uint32_t)syscall(SYS_gettid);
+
+    pthread_mutex_lock(&trace_mutex);
+    list_add_tail(&ring->list, &trace_ring_list);
+    pthread_mutex_unlock(&trace_mutex);
+
+    (void)pthread_setspecific(trace_key, ring);
+    trace_ring = ring;
+
+    return ring;
+}
+
+static void trace_record(trace_site_t *site, va_list ap)
+{
+    trace_ring_t *ring;
+    trace_rec_t *rec;
+    struct timespec ts;
+    const char *str;
+    uint64_t head, u64;
+    uint32_t off, len, i;
+    double d;
+
+    ring = trace_ring;
+    if (__builtin_expect(ring == NULL, 0)) {
+        ring = trace_ring_create();
+        if (ring == NULL) {
+            return;
+        }
+    }
+
+    head = ring->head;
+    rec = &ring->recs[head & (TRACE_RING_SIZE - 1)];
+
+    /* head must be visible before the slot is overwritten */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    rec->ts_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    rec->site = site;
+    rec->tid = ring->tid;
+    rec->truncated = 0;
+
+    off = 0;
+    for (i = 0; i < site->nargs; i++) {
+        if (site->kinds[i] == TRACE_ARG_STR) {
+            str = va_arg(ap, const char *);
+            if (off >= TRACE_REC_DATA_SIZE) {
+                rec->truncated = 1;
+                break;
+            }
+            if (str == NULL) {
+                rec->data[off++] = TRACE_STR_NULL;
+                continue;
+            }
+            len = strlen(str);
+            if (len > TRACE_REC_DATA_SIZE - off - 1) {
+                len = TRACE_REC_DATA_SIZE - off - 1;
+                rec->truncated = 1;
+            }
+            if (len >= TRACE_STR_NULL) {
+                len = TRACE_STR_NULL - 1;
+                rec->truncated = 1;
+            }
+            rec->data[off] = len;
+            memcpy(&rec->data[off + 1], str, len);
+            off += len + 1;
+            continue;
+        }
+
+        switch (site->kinds[i]) {
+        case TRACE_ARG_INT:
+            u64 = (uint64_t)(int64_t)va_arg(ap, int);
+            break;
+
+        case TRACE_ARG_LONG:
+            u64 = (uint64_t)(int64_t)va_arg(ap, long);
+            break;
+
+        case TRACE_ARG_LLONG:
+            u64 = (uint64_t)va_arg(ap, long long);
+            break;
+
+        case TRACE_ARG_DOUBLE:
+            d = va_arg(ap, double);
+            memcpy(&u64, &d, sizeof(u64));
+            break;
+
+        default:
+            u64 = (uint64_t)(uintptr_t)va_arg(ap, void *);
+            break;
+        }
+
+        if (off + sizeof(u64) > TRACE_REC_DATA_SIZE) {
+            rec->truncated = 1;
+            break;
+        }
+        memcpy(&rec->data[off], &u64, sizeof(u64));
+        off += sizeof(u64);
+    }
+    rec->len = off;
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void trace_printf(trace_site_t *site, ...)
+{
+    va_list ap;
+
+    if (site->level & trace_console_level) {
+        va_start(ap, site);
+        (void)vprintf(site->fmt, ap);
+        va_end(ap);
+    }
+
+    if (!trace_enabled) {
+        return;
+    }
+
+    if (__builtin_expect(!__atomic_load_n(&site->parsed, __ATOMIC_ACQUIRE), 0)) {
+        trace_site_parse(site);
+    }
+
+    va_start(ap, site);
+    trace_record(site, ap);
+    va_end(ap);
+}
+
+#define TRACE_SNPRINTF(value)                                                   \
+    ((nstar == 0)? snprintf(out, left, spec, value):                           \
+    (nstar == 1)? snprintf(out, left, spec, star[0], value):                   \
+    snprintf(out, left, spec, star[0], star[1], value))
+
+/* format a record back to text, as printf would have printed it */
+static void trace_format(const trace_rec_t *rec, char *buf, uint32_t size)
+{
+    uint8_t kinds[3];
+    char spec[32];
+    char str[TRACE_STR_NULL];
+    const char *p, *start;
+    char *out;
+    uint64_t u64;
+    uint32_t left, off, argi, nkinds, i, len;
+    int star[2], nstar, n;
+    double d;
+
+    out = buf;
+    left = size;
+    off = 0;
+    argi = 0;
+    p = rec->site->fmt;
+    while (*p && (left > 1)) {
+        if (*p != '%') {
+            *out++ = *p++;
+            left--;
+            continue;
+        }
+
+        start = p++;
+        if (*p == '%') {
+            *out++ = *p++;
+            left--;
+            continue;
+        }
+
+        p = trace_parse_spec(p, kinds, &nkinds);
+        if (((uint32_t)(p - start) >= sizeof(spec)) || (argi + nkinds > rec->site->nargs)) {
+            goto out;
+        }
+        memcpy(spec, start, p - start);
+        spec[p - start] = 0;
+
+        nstar = 0;
+        n = 0;
+        for (i = 0; i < nkinds; i++, argi++) {
+            if (kinds[i] == TRACE_ARG_STR) {
+                if (off >= rec->len) {
+                    goto out;
+                }
+                len = rec->data[off++];
+                if (len == TRACE_STR_NULL) {
+                    n = TRACE_SNPRINTF("(null)");
+                    continue;
+                }
+                memcpy(str, &rec->data[off], len);
+                str[len] = 0;
+                off += len;
+                n = TRACE_SNPRINTF(str);
+                continue;
+            }
+
+            if (off + sizeof(u64) > rec->len) {
+                goto out;
+            }
+            memcpy(&u64, &rec->data[off], sizeof(u64));
+            off += sizeof(u64);
+
+            if (i + 1 < nkinds) {
+                star[nstar++] = (int)u64;
+                continue;
+            }
+
+            switch (kinds[i]) {
+            case TRACE_ARG_INT:
+                n = TRACE_SNPRINTF((int)u64);
+                break;
+
+            case TRACE_ARG_LONG:
+                n = TRACE_SNPRINTF((long)u64);
+                break;
+
+            case TRACE_ARG_LLONG:
+                n = TRACE_SNPRINTF((long long)u64);
+                break;
+
+            case TRACE_ARG_DOUBLE:
+                memcpy(&d, &u64, sizeof(d));
+                n = TRACE_SNPRINTF(d);
+                break;
+
+            default:
+                n = TRACE_SNPRINTF((void *)(uintptr_t)u64);
+                break;
+            }
+        }
+
+        if (n < 0) {
+            goto out;
+        }
+        if ((uint32_t)n >= left) {
+            n = left - 1;
+        }
+        out += n;
+        left -= n;
+    }
+
+out:
+    *out = 0;
+
+    if (rec->truncated && (left > 4)) {
+        /* keep line end of the original text */
+        while ((out > buf) && ((out[-1] == '\r') || (out[-1] == '\n'))) {
+            out--;
+            left++;
+        }
+        (void)snprintf(out, left, "...");
+    }
+}
+
+static int trace_rec_compare(const void *a, const void *b)
+{
+    const trace_rec_t *ra = (const trace_rec_t *)a;
+    const trace_rec_t *rb = (const trace_rec_t *)b;
+
+    if (ra->ts_ns < rb->ts_ns) {
+        return -1;
+    }
+
+    return (ra->ts_ns > rb->ts_ns)? 1: 0;
+}
+
+void trace_set_enable(bool enable)
+{
+    trace_enabled = enable;
+}
+
+void trace_set_console_level(uint32_t level)
+{
+    trace_console_level = level;
+}
+
+cJSON *trace_dump(uint64_t since, uint32_t max_len)
+{
+    trace_ring_t *ring;
+    trace_rec_t *recs, *rec;
+    cJSON *reply, *array;
+    char text[TRACE_TEXT_MAX];
+    char line[TRACE_TEXT_MAX + 48];
+    char next[24];
+    struct tm tm;
+    time_t sec;
+    uint64_t head, last, i;
+    uint32_t nrings, nrecs, total, k, len;
+    const char *level;
+
+    reply = cJSON_CreateObject();
+    array = cJSON_CreateArray();
+    if ((reply == NULL) || (array == NULL)) {
+        cJSON_Delete(reply);
+        cJSON_Delete(array);
+        return NULL;
+    }
+    cJSON_AddItemToObject(reply, "records", array);
+
+    pthread_mutex_lock(&trace_mutex);
+
+    nrings = 0;
+    list_for_each_entry(ring, &trace_ring_list, list) {
+        nrings++;
+    }
+
+    recs = NULL;
+    if (nrings) {
+        recs = (trace_rec_t *)malloc((size_t)nrings * TRACE_RING_SIZE * sizeof(trace_rec_t));
+    }
+
+    nrecs = 0;
+    if (recs) {
+        list_for_each_entry(ring, &trace_ring_list, list) {
+            head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+            i = (head > TRACE_RING_SIZE)? head - TRACE_RING_SIZE: 0;
+            for (; i < head; i++) {
+                rec = &recs[nrecs];
+                memcpy(rec, &ring->recs[i & (TRACE_RING_SIZE - 1)], sizeof(trace_rec_t));
+
+                /* drop the slot if the writer has wrapped onto it while copying */
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&ring->head, __ATOMIC_RELAXED) - i >= TRACE_RING_SIZE) {
+                    continue;
+                }
+
+                if (rec->ts_ns > since) {
+                    nrecs++;
+                }
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&trace_mutex);
+
+    qsort(recs, nrecs, sizeof(trace_rec_t), trace_rec_compare);
+
+    last = since;
+    total = 0;
+    for (k = 0; k < nrecs; k++) {
+        rec = &recs[k];
+        trace_format(rec, text, sizeof(text));
+        len = strlen(text);
+        while (len && ((text[len - 1] == '\r') || (text[len - 1] == '\n'))) {
+            text[--len] = 0;
+        }
+
+        if (rec->site->level & DEBUG_LEVEL_ERROR) {
+            level = "E";
+        } else if (rec->site->level & DEBUG_LEVEL_WARN) {
+            level = "W";
+        } else {
+            level = "V";
+        }
+
+        sec = rec->ts_ns / 1000000000ULL;
+        (void)localtime_r(&sec, &tm);
+        len = snprintf(line, sizeof(line), "%02d:%02d:%02d.%06u [%u] %s %s", tm.tm_hour,
+            tm.tm_min, tm.tm_sec, (uint32_t)((rec->ts_ns % 1000000000ULL) / 1000), rec->tid,
+            level, text);
+
+        if ((k > 0) && (total + len + 4 > max_len)) {
+            break;
+        }
+        total += len + 4;
+
+        cJSON_AddItemToArray(array, cJSON_CreateString(line));
+        last = rec->ts_ns;
+    }
+
+    free(recs);
+
+    (void)snprintf(next, sizeof(next), "%llu", (unsigned long long)last);
+    cJSON_AddStringToObject(reply, "next", next);
+    cJSON_AddBoolToObject(reply, "enable", trace_enabled);
+    cJSON_AddNumberToObject(reply, "console_level", trace_console_level);
+
+    return reply;
+}
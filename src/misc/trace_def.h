@@ -0,0 +1,62 @@
+/*
+ * Copyright(C) 2014 SWG. All rights reserved.
+ */
+/*
+ * trace_def.h
+ * Original Author:  agent, 2026-10-19
+ *
+ * Binary trace ring internal header
+ *
+ * History
+ */
+
+#ifndef _TRACE_DEF_H_
+#define _TRACE_DEF_H_
+
+#include <stdint.h>
+
+#include "misc/trace.h"
+#include "misc/list.h"
+
+#define TRACE_RING_SIZE             (512)           /* power of 2 */
+#define TRACE_REC_SIZE              (128)
+#define TRACE_REC_HDR_SIZE          (24)
+#define TRACE_REC_DATA_SIZE         (TRACE_REC_SIZE - TRACE_REC_HDR_SIZE)
+
+/* rings of exited threads kept for dump */
+#define TRACE_MAX_EXITED_RING       (4)
+
+#define TRACE_TEXT_MAX              (512)
+
+/* string argument of len TRACE_STR_NULL is a null pointer */
+#define TRACE_STR_NULL              (0xFF)
+
+typedef enum {
+    TRACE_ARG_INT = 0,
+    TRACE_ARG_LONG,
+    TRACE_ARG_LLONG,
+    TRACE_ARG_DOUBLE,
+    TRACE_ARG_STR,
+    TRACE_ARG_PTR,
+    TRACE_ARG_NONE                      /* unsupported conversion, stop recording */
+} trace_arg_kind_t;
+
+typedef struct trace_rec_s {
+    uint64_t ts_ns;
+    trace_site_t *site;
+    uint32_t tid;
+    uint16_t len;
+    uint8_t truncated;
+    uint8_t reserved;
+    uint8_t data[TRACE_REC_DATA_SIZE];
+} trace_rec_t;
+
+typedef struct trace_ring_s {
+    struct list_head list;
+    uint32_t tid;
+    bool exited;
+    uint64_t head;                      /* written by owner thread only */
+    trace_rec_t recs[TRACE_RING_SIZE];
+} trace_ring_t;
+
+#endif /* _TRACE_DEF_H_ */
@@ -644,6 +644,57 @@ out0:
     return NULL;
 }
 
+/* run on the serial's loop, no completion callback is running meanwhile */
+static void _usb_serial_cancel_async(void *arg)
+{
+    usb_serial_async_impl_t *serial = (usb_serial_async_impl_t*)arg;
+
+    pthread_mutex_lock(&serial->mutex);
+
+    for (std::list<struct libusb_transfer*>::iterator it = serial->in_xfr.begin();
+            it != serial->in_xfr.end(); ++it) {
+        int rv = libusb_cancel_transfer(*it);
+        if (rv != LIBUSB_SUCCESS && rv != LIBUSB_ERROR_NOT_FOUND) {
+            USB_ERROR("%s: cancel in xfr failed: %s\r\n", __func__,
+                    libusb_strerror((enum libusb_error)rv));
+        }
+    }
+
+    for (std::list<struct libusb_transfer*>::iterator it = serial->out_xfr.begin();
+            it != serial->out_xfr.end(); ++it) {
+        int rv = libusb_cancel_transfer(*it);
+        if (rv != LIBUSB_SUCCESS && rv != LIBUSB_ERROR_NOT_FOUND) {
+            USB_ERROR("%s: cancel out xfr failed: %s\r\n", __func__,
+                    libusb_strerror((enum libusb_error)rv));
+        }
+    }
+
+    for (std::list<struct libusb_transfer*>::iterator it = serial->control_xfr.begin();
+            it != serial->control_xfr.end(); ++it) {
+        int rv = libusb_cancel_transfer(*it);
+        if (rv != LIBUSB_SUCCESS && rv != LIBUSB_ERROR_NOT_FOUND) {
+            USB_ERROR("%s: cancel control xfr failed: %s\r\n", __func__,
+                    libusb_strerror((enum libusb_error)rv));
+        }
+    }
+
+    serial->in_xfr.clear();
+    serial->out_xfr.clear();
+    serial->control_xfr.clear();
+    serial->in_xfr_count = 0;
+    serial->out_xfr_count = 0;
+    serial->control_xfr_count = 0;
+
+    pthread_mutex_unlock(&serial->mutex);
+}
+
+static void _usb_serial_reap(void *arg)
+{
+    usb_serial_async_impl_t *async = (usb_serial_async_impl_t*)arg;
+
+    usb_serial_event_handler(async->watcher, 0);
+}
+
 void usb_serial_destroy(usb_serial_t *serial)
 {
     if (serial == NULL) {
@@ -665,9 +716,7 @@ void usb_serial_destroy(usb_serial_t *serial)
         usb_serial_async_impl_t *async = (usb_serial_async_impl_t *)serial;
         usb_serial_cancel_async(serial);
 
-        el_sync(async->el);
-        usb_serial_event_handler(async->watcher, 0); // clean canceled transfer;
-        el_unsync(async->el);
+        (void)el_call(async->el, _usb_serial_reap, async); // clean canceled transfer;
 
         el_watch_destroy(async->el, async->watcher);
         pthread_mutex_destroy(&async->mutex);
@@ -693,47 +742,7 @@ void usb_serial_cancel_async(usb_serial_t *base)
         return;
     }
 
-    el_sync(serial->el);
-
-    pthread_mutex_lock(&serial->mutex);
-
-    for (std::list<struct libusb_transfer*>::iterator it = serial->in_xfr.begin();
-            it != serial->in_xfr.end(); ++it) {
-        int rv = libusb_cancel_transfer(*it);
-        if (rv != LIBUSB_SUCCESS && rv != LIBUSB_ERROR_NOT_FOUND) {
-            USB_ERROR("%s: cancel in xfr failed: %s\r\n", __func__,
-                    libusb_strerror((enum libusb_error)rv));
-        }
-    }
-
-    for (std::list<struct libusb_transfer*>::iterator it = serial->out_xfr.begin();
-            it != serial->out_xfr.end(); ++it) {
-        int rv = libusb_cancel_transfer(*it);
-        if (rv != LIBUSB_SUCCESS && rv != LIBUSB_ERROR_NOT_FOUND) {
-            USB_ERROR("%s: cancel out xfr failed: %s\r\n", __func__,
-                    libusb_strerror((enum libusb_error)rv));
-        }
-    }
-
-    for (std::list<struct libusb_transfer*>::iterator it = serial->control_xfr.begin();
-            it != serial->control_xfr.end(); ++it) {
-        int rv = libusb_cancel_transfer(*it);
-        if (rv != LIBUSB_SUCCESS && rv != LIBUSB_ERROR_NOT_FOUND) {
-            USB_ERROR("%s: cancel control xfr failed: %s\r\n", __func__,
-                    libusb_strerror((enum libusb_error)rv));
-        }
-    }
-
-    serial->in_xfr.clear();
-    serial->out_xfr.clear();
-    serial->control_xfr.clear();
-    serial->in_xfr_count = 0;
-    serial->out_xfr_count = 0;
-    serial->control_xfr_count = 0;
-
-    pthread_mutex_unlock(&serial->mutex);
-
-    el_unsync(serial->el);
+    (void)el_call(serial->el, _usb_serial_cancel_async, serial);
 }
 
 int usb_serial_async_read(usb_serial_t *base, unsigned char *buf, unsigned len)
@@ -14,6 +14,7 @@
 
 #include "misc/usbuartproxy.h"
 #include "misc/eventloop.h"
+#include "misc/trace.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,21 +27,21 @@ extern int usb_dbg_err;
 #define USB_ERROR(fmt, args...)                    	\
 do {                                                \
     if (usb_dbg_err) {                             	\
-       printf(fmt, ##args);                         \
+       TRACE_ERROR(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define USB_WARN(fmt, args...)                     	\
 do {                                                \
     if (usb_dbg_warn) {                            	\
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define USB_VERBOS(fmt, args...)                   	\
 do {                                                \
     if (usb_dbg_verbos) {                          	\
-       printf(fmt, ##args);                         \
+       TRACE_VERBOS(fmt, ##args);                   \
     }                                               \
 } while (0)
 
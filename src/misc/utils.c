@@ -8,10 +8,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
 #include <fcntl.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <pthread.h>
 #include <linux/version.h>
@@ -183,6 +187,626 @@ int save_json_file(cJSON *json, const char *filename)
     return 0;
 }
 
+typedef struct snapshot_hdr_s {
+    uint32_t magic;
+    uint32_t len;
+    uint32_t checksum;
+    uint32_t reserved;
+    int64_t saved_time;
+} snapshot_hdr_t;
+
+/* FNV-1a over 64-bit words, the tail byte by byte */
+uint64_t data_hash64(const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t word;
+
+    while (len >= sizeof(word)) {
+        memcpy(&word, p, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+        p += sizeof(word);
+        len -= sizeof(word);
+    }
+
+    while (len--) {
+        hash ^= *p++;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/* data_hash64 folded to 32 bits */
+static uint32_t snapshot_checksum(const uint8_t *data, uint32_t len)
+{
+    uint64_t hash;
+
+    hash = data_hash64(data, len);
+
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+static int write_all(int fd, const void *data, size_t len)
+{
+    size_t written = 0;
+
+    while (written < len) {
+        ssize_t nwrite = write(fd, (const uint8_t *)data + written, len - written);
+        if (nwrite < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -EPERM;
+        }
+        written += nwrite;
+    }
+
+    return 0;
+}
+
+int save_snapshot_file(const char *filename, uint32_t magic, const void *data, uint32_t len)
+{
+    snapshot_hdr_t hdr;
+    char tmpname[PATH_MAX];
+    int fd;
+
+    if (!filename || (!data && len)) {
+        printf("%s: null arguments\r\n", __func__);
+        return -EINVAL;
+    }
+
+    if (snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename) >= sizeof(tmpname)) {
+        printf("%s: too long filename %s\r\n", __func__, filename);
+        return -EINVAL;
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = magic;
+    hdr.len = len;
+    hdr.checksum = snapshot_checksum((const uint8_t *)data, len);
+    hdr.saved_time = time(NULL);
+
+    fd = open(tmpname, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if (fd == -1) {
+        printf("%s: open %s failed(%s)\r\n", __func__, tmpname, strerror(errno));
+        return -EPERM;
+    }
+
+    if ((write_all(fd, &hdr, sizeof(hdr)) < 0) || (write_all(fd, data, len) < 0)
+            || (fsync(fd) < 0)) {
+        printf("%s: write %s failed(%s)\r\n", __func__, tmpname, strerror(errno));
+        close(fd);
+        (void)unlink(tmpname);
+        return -EPERM;
+    }
+    close(fd);
+
+    /* rename is atomic, a crash leaves the old snapshot intact */
+    if (rename(tmpname, filename) < 0) {
+        printf("%s: rename %s failed(%s)\r\n", __func__, tmpname, strerror(errno));
+        (void)unlink(tmpname);
+        return -EPERM;
+    }
+
+    return 0;
+}
+
+void *load_snapshot_file(const char *filename, uint32_t magic, uint32_t *len, uint32_t *age)
+{
+    snapshot_hdr_t hdr;
+    struct stat st;
+    uint8_t *data;
+    int64_t now;
+    int fd;
+
+    if (!filename || !len) {
+        printf("%s: null arguments\r\n", __func__);
+        return NULL;
+    }
+
+    fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        if (errno != ENOENT) {
+            printf("%s: open %s failed(%s)\r\n", __func__, filename, strerror(errno));
+        }
+        return NULL;
+    }
+
+    data = NULL;
+    if ((fstat(fd, &st) < 0) || (read(fd, &hdr, sizeof(hdr)) != sizeof(hdr))
+            || (hdr.magic != magic) || (st.st_size != sizeof(hdr) + (off_t)hdr.len)) {
+        printf("%s: invalid snapshot %s\r\n", __func__, filename);
+        goto out;
+    }
+
+    data = (uint8_t *)malloc(hdr.len + 1);
+    if (data == NULL) {
+        printf("%s: malloc failed(%u)\r\n", __func__, hdr.len + 1);
+        goto out;
+    }
+
+    if ((read(fd, data, hdr.len) != hdr.len)
+            || (snapshot_checksum(data, hdr.len) != hdr.checksum)) {
+        printf("%s: corrupted snapshot %s\r\n", __func__, filename);
+        free(data);
+        data = NULL;
+        goto out;
+    }
+
+    *len = hdr.len;
+    if (age) {
+        now = time(NULL);
+        *age = (now > hdr.saved_time)? (uint32_t)(now - hdr.saved_time): 0;
+    }
+
+out:
+    close(fd);
+
+    return data;
+}
+
+#define JSON_IMAGE_MAX_DEPTH        (64)
+#define JSON_IMAGE_MAX_KEYS         (65535)
+
+/*
+ * image: json_image_hdr_t, nodes in pre-order, key offsets, string pool.
+ * An object or array is followed by its children, arg of it is their count
+ */
+typedef struct json_image_hdr_s {
+    uint64_t key;
+    uint32_t nodes;
+    uint32_t keys;
+    uint32_t pool_len;
+    uint32_t reserved;
+} json_image_hdr_t;
+
+typedef struct json_image_node_s {
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t key;                   /* index of key offset plus 1, 0 if not in an object */
+    uint32_t arg;                   /* children of array/object, pool offset of string */
+    double value;
+} json_image_node_t;
+
+/* tree of a loaded image, all nodes and strings in one block after it */
+typedef struct json_image_block_s {
+    size_t size;
+} json_image_block_t;
+
+typedef struct json_image_writer_s {
+    json_image_node_t *nodes;
+    uint32_t node_count;
+    uint32_t *key_offs;
+    uint32_t key_count;
+    uint32_t *key_table;            /* open addressing, index of key_offs plus 1 */
+    uint32_t key_mask;
+    char *pool;
+    uint32_t pool_len;
+    uint32_t pool_size;
+} json_image_writer_t;
+
+static uint32_t json_count_nodes(const cJSON *item, int depth)
+{
+    uint32_t count;
+
+    if (depth > JSON_IMAGE_MAX_DEPTH) {
+        return UINT32_MAX;
+    }
+
+    count = 0;
+    while (item) {
+        count++;
+        if (item->child) {
+            uint32_t children = json_count_nodes(item->child, depth + 1);
+            if (children == UINT32_MAX) {
+                return UINT32_MAX;
+            }
+            count += children;
+        }
+        item = item->next;
+    }
+
+    return count;
+}
+
+static int json_pool_add(json_image_writer_t *w, const char *str, uint32_t *off)
+{
+    size_t len;
+    uint32_t size;
+    char *pool;
+
+    len = strlen(str) + 1;
+    if (len > UINT32_MAX - w->pool_len) {
+        return -E2BIG;
+    }
+
+    if (w->pool_len + len > w->pool_size) {
+        size = w->pool_size? w->pool_size: 4096;
+        while (size < w->pool_len + len) {
+            if (size > UINT32_MAX / 2) {
+                return -E2BIG;
+            }
+            size *= 2;
+        }
+        pool = (char *)realloc(w->pool, size);
+        if (pool == NULL) {
+            return -ENOMEM;
+        }
+        w->pool = pool;
+        w->pool_size = size;
+    }
+
+    memcpy(w->pool + w->pool_len, str, len);
+    *off = w->pool_len;
+    w->pool_len += len;
+
+    return 0;
+}
+
+/* object keys repeat for every instance, keep each once */
+static int json_key_add(json_image_writer_t *w, const char *key, uint16_t *index)
+{
+    uint32_t pos, idx, off;
+    int rv;
+
+    pos = (uint32_t)data_hash64(key, strlen(key)) & w->key_mask;
+    while ((idx = w->key_table[pos]) != 0) {
+        if (!strcmp(w->pool + w->key_offs[idx - 1], key)) {
+            *index = (uint16_t)idx;
+            return 0;
+        }
+        pos = (pos + 1) & w->key_mask;
+    }
+
+    if (w->key_count >= JSON_IMAGE_MAX_KEYS) {
+        return -E2BIG;
+    }
+
+    rv = json_pool_add(w, key, &off);
+    if (rv < 0) {
+        return rv;
+    }
+
+    w->key_offs[w->key_count++] = off;
+    w->key_table[pos] = w->key_count;
+    *index = (uint16_t)w->key_count;
+
+    return 0;
+}
+
+static int json_write_item(json_image_writer_t *w, const cJSON *item, bool in_object)
+{
+    json_image_node_t *node;
+    const cJSON *child;
+    int rv;
+
+    node = &w->nodes[w->node_count++];
+    memset(node, 0, sizeof(*node));
+    node->type = (uint8_t)(item->type & 0xff);
+    if (in_object) {
+        if (item->string == NULL) {
+            return -EINVAL;
+        }
+        rv = json_key_add(w, item->string, &node->key);
+        if (rv < 0) {
+            return rv;
+        }
+    }
+
+    switch (node->type) {
+    case cJSON_False:
+    case cJSON_True:
+    case cJSON_NULL:
+        break;
+
+    case cJSON_Number:
+        node->value = item->valuedouble;
+        break;
+
+    case cJSON_String:
+        return json_pool_add(w, item->valuestring? item->valuestring: "", &node->arg);
+
+    case cJSON_Array:
+    case cJSON_Object:
+        for (child = item->child; child; child = child->next) {
+            node->arg++;
+            rv = json_write_item(w, child, item->type == cJSON_Object);
+            if (rv < 0) {
+                return rv;
+            }
+        }
+        break;
+
+    default:
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+int save_json_image(const char *filename, uint32_t magic, cJSON *json, uint64_t key)
+{
+    json_image_writer_t w;
+    json_image_hdr_t *hdr;
+    uint8_t *data;
+    uint64_t len;
+    uint32_t table_size, count;
+    int rv;
+
+    if (!filename || !json) {
+        printf("%s: null arguments\r\n", __func__);
+        return -EINVAL;
+    }
+
+    count = json_count_nodes(json->child, 1);
+    if (count == UINT32_MAX) {
+        printf("%s: json deeper than %d\r\n", __func__, JSON_IMAGE_MAX_DEPTH);
+        return -E2BIG;
+    }
+    count++;
+
+    memset(&w, 0, sizeof(w));
+    table_size = 64;
+    while ((table_size < count * 2) && (table_size < (JSON_IMAGE_MAX_KEYS + 1) * 2)) {
+        table_size <<= 1;
+    }
+    w.key_mask = table_size - 1;
+    w.nodes = (json_image_node_t *)malloc(sizeof(json_image_node_t) * count);
+    w.key_offs = (uint32_t *)malloc(sizeof(uint32_t) * (count < JSON_IMAGE_MAX_KEYS? count:
+        JSON_IMAGE_MAX_KEYS));
+    w.key_table = (uint32_t *)calloc(table_size, sizeof(uint32_t));
+    data = NULL;
+    if (!w.nodes || !w.key_offs || !w.key_table) {
+        printf("%s: malloc failed(%u nodes)\r\n", __func__, count);
+        rv = -ENOMEM;
+        goto out;
+    }
+
+    rv = json_write_item(&w, json, false);
+    if (rv < 0) {
+        printf("%s: encode json failed(%d)\r\n", __func__, rv);
+        goto out;
+    }
+
+    len = sizeof(json_image_hdr_t) + (uint64_t)sizeof(json_image_node_t) * w.node_count
+        + (uint64_t)sizeof(uint32_t) * w.key_count + w.pool_len;
+    if (len > UINT32_MAX) {
+        printf("%s: image too large\r\n", __func__);
+        rv = -E2BIG;
+        goto out;
+    }
+
+    data = (uint8_t *)malloc(len);
+    if (data == NULL) {
+        printf("%s: malloc failed(%u)\r\n", __func__, (uint32_t)len);
+        rv = -ENOMEM;
+        goto out;
+    }
+
+    hdr = (json_image_hdr_t *)data;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->key = key;
+    hdr->nodes = w.node_count;
+    hdr->keys = w.key_count;
+    hdr->pool_len = w.pool_len;
+    len = sizeof(json_image_hdr_t);
+    memcpy(data + len, w.nodes, sizeof(json_image_node_t) * w.node_count);
+    len += sizeof(json_image_node_t) * w.node_count;
+    memcpy(data + len, w.key_offs, sizeof(uint32_t) * w.key_count);
+    len += sizeof(uint32_t) * w.key_count;
+    memcpy(data + len, w.pool, w.pool_len);
+    len += w.pool_len;
+
+    rv = save_snapshot_file(filename, magic, data, (uint32_t)len);
+
+out:
+    free(data);
+    free(w.pool);
+    free(w.key_table);
+    free(w.key_offs);
+    free(w.nodes);
+
+    return rv;
+}
+
+typedef struct json_image_level_s {
+    cJSON *parent;
+    cJSON *last;
+    uint32_t remain;
+} json_image_level_t;
+
+cJSON *load_json_image(const char *filename, uint32_t magic, uint64_t key)
+{
+    json_image_level_t stack[JSON_IMAGE_MAX_DEPTH + 1];
+    const json_image_hdr_t *hdr;
+    const json_image_node_t *in;
+    const uint32_t *key_offs;
+    const char *src_pool;
+    json_image_block_t *block;
+    cJSON *nodes, *item;
+    char *pool;
+    uint8_t *data;
+    uint64_t size;
+    uint32_t len, i;
+    int depth;
+
+    data = (uint8_t *)load_snapshot_file(filename, magic, &len, NULL);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    block = NULL;
+    hdr = (const json_image_hdr_t *)data;
+    if (len < sizeof(json_image_hdr_t)) {
+        goto invalid;
+    }
+
+    if (hdr->key != key) {
+        goto out;
+    }
+
+    size = sizeof(json_image_hdr_t) + (uint64_t)sizeof(json_image_node_t) * hdr->nodes
+        + (uint64_t)sizeof(uint32_t) * hdr->keys + hdr->pool_len;
+    if ((hdr->nodes == 0) || (size != len) || (hdr->pool_len == 0)
+            || (data[len - 1] != '\0')) {
+        goto invalid;
+    }
+
+    in = (const json_image_node_t *)(data + sizeof(json_image_hdr_t));
+    key_offs = (const uint32_t *)(in + hdr->nodes);
+    src_pool = (const char *)(key_offs + hdr->keys);
+    for (i = 0; i < hdr->keys; i++) {
+        if (key_offs[i] >= hdr->pool_len) {
+            goto invalid;
+        }
+    }
+
+    block = (json_image_block_t *)malloc(sizeof(json_image_block_t)
+        + sizeof(cJSON) * hdr->nodes + hdr->pool_len);
+    if (block == NULL) {
+        printf("%s: malloc failed(%u nodes)\r\n", __func__, hdr->nodes);
+        goto out;
+    }
+    block->size = sizeof(cJSON) * hdr->nodes + hdr->pool_len;
+    nodes = (cJSON *)(block + 1);
+    pool = (char *)(nodes + hdr->nodes);
+    memcpy(pool, src_pool, hdr->pool_len);
+
+    depth = -1;
+    for (i = 0; i < hdr->nodes; i++, in++) {
+        item = &nodes[i];
+        memset(item, 0, sizeof(cJSON));
+        item->type = in->type;
+
+        if (depth >= 0) {
+            if (in->key) {
+                if ((stack[depth].parent->type != cJSON_Object) || (in->key > hdr->keys)) {
+                    goto invalid;
+                }
+                item->string = pool + key_offs[in->key - 1];
+            } else if (stack[depth].parent->type == cJSON_Object) {
+                goto invalid;
+            }
+
+            if (stack[depth].last) {
+                stack[depth].last->next = item;
+                item->prev = stack[depth].last;
+            } else {
+                stack[depth].parent->child = item;
+            }
+            stack[depth].last = item;
+            stack[depth].remain--;
+        } else if (i != 0) {
+            /* more than one root */
+            goto invalid;
+        }
+
+        switch (in->type) {
+        case cJSON_False:
+        case cJSON_True:
+        case cJSON_NULL:
+            break;
+
+        case cJSON_Number:
+            item->valuedouble = in->value;
+            item->valueint = (int)in->value;
+            break;
+
+        case cJSON_String:
+            if (in->arg >= hdr->pool_len) {
+                goto invalid;
+            }
+            item->valuestring = pool + in->arg;
+            break;
+
+        case cJSON_Array:
+        case cJSON_Object:
+            if (in->arg > hdr->nodes - i - 1) {
+                goto invalid;
+            }
+            if (in->arg) {
+                if (depth >= JSON_IMAGE_MAX_DEPTH) {
+                    goto invalid;
+                }
+                depth++;
+                stack[depth].parent = item;
+                stack[depth].last = NULL;
+                stack[depth].remain = in->arg;
+                continue;
+            }
+            break;
+
+        default:
+            goto invalid;
+        }
+
+        while ((depth >= 0) && (stack[depth].remain == 0)) {
+            depth--;
+        }
+    }
+
+    if (depth >= 0) {
+        goto invalid;
+    }
+
+    free(data);
+
+    return nodes;
+
+invalid:
+    printf("%s: invalid json image %s\r\n", __func__, filename);
+
+out:
+    free(block);
+    free(data);
+
+    return NULL;
+}
+
+static void json_image_free_added(cJSON *item, const uint8_t *begin, const uint8_t *end)
+{
+    cJSON *child, *next;
+
+    for (child = item->child; child; child = next) {
+        next = child->next;
+        if (((const uint8_t *)child >= begin) && ((const uint8_t *)child < end)) {
+            if (child->child) {
+                json_image_free_added(child, begin, end);
+            }
+            continue;
+        }
+
+        if (child->prev) {
+            child->prev->next = next;
+        } else {
+            item->child = next;
+        }
+        if (next) {
+            next->prev = child->prev;
+        }
+        child->next = NULL;
+        child->prev = NULL;
+        cJSON_Delete(child);
+    }
+}
+
+void free_json_image(cJSON *json)
+{
+    json_image_block_t *block;
+    const uint8_t *begin;
+
+    if (json == NULL) {
+        return;
+    }
+
+    block = (json_image_block_t *)json - 1;
+    begin = (const uint8_t *)json;
+    json_image_free_added(json, begin, begin + block->size);
+    free(block);
+}
+
 pid_t exec_getpid(const char * const argv[], int *infd, int *outfd, int *errfd)
 {
     pid_t child;
@@ -16,6 +16,8 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+#include "misc/trace.h"
+
 extern bool module_mng_dbg_err;
 extern bool module_mng_dbg_warn;
 extern bool module_mng_dbg_verbos;
@@ -23,21 +25,21 @@ extern bool module_mng_dbg_verbos;
 #define MODULE_MNG_ERROR(fmt, args...)              \
 do {                                                \
     if (module_mng_dbg_err) {                       \
-        printf(fmt, ##args);                        \
+        TRACE_ERROR(fmt, ##args);                   \
     }                                               \
 } while (0)
 
 #define MODULE_MNG_WARN(fmt, args...)               \
 do {                                                \
     if (module_mng_dbg_warn) {                      \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
 
 #define MODULE_MNG_VERBOS(fmt, args...)             \
 do {                                                \
     if (module_mng_dbg_verbos) {                    \
-        printf(fmt, ##args);                        \
+        TRACE_VERBOS(fmt, ##args);                  \
     }                                               \
 } while (0)
 
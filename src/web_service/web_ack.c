@@ -28,8 +28,8 @@ static web_cache_entry_t *web_cache = NULL;
 static int web_ack_read_device_object_list(BACNET_READ_PROPERTY_DATA *rp_data, cJSON *reply)
 {
     cJSON *result, *tmp;
-    BACNET_OBJECT_TYPE object_type;
-    uint32_t object_instance;
+    BACNET_OBJECT_ID object_id[64];
+    uint32_t count, i;
     uint8_t *pdu;
     int dec_len, len;
     
@@ -43,8 +43,10 @@ static int web_ack_read_device_object_list(BACNET_READ_PROPERTY_DATA *rp_data, c
     len = 0;
     pdu = rp_data->application_data;
     while (len < rp_data->application_data_len) {
-        dec_len = decode_application_object_id(&pdu[len], &object_type, &object_instance);
-        if (dec_len < 0) {
+        count = sizeof(object_id) / sizeof(object_id[0]);
+        dec_len = decode_application_object_id_array(&pdu[len], rp_data->application_data_len - len,
+            object_id, &count);
+        if ((dec_len < 0) || (count == 0)) {
             WEB_ERROR("%s: decode object_id failed(%d)\r\n", __func__, dec_len);
             cJSON_Delete(result);
             cJSON_AddStringToObject(reply, "reason", "decode object_id failed");
@@ -52,15 +54,19 @@ static int web_ack_read_device_object_list(BACNET_READ_PROPERTY_DATA *rp_data, c
         }
         len += dec_len;
 
-        tmp = cJSON_CreateObject();
-        if (tmp == NULL) {
-            WEB_ERROR("%s: create object failed\r\n", __func__);
-            cJSON_Delete(result);
-            cJSON_AddStringToObject(reply, "reason", "create object failed");
-            return -EPERM;
-        }
+        for (i = 0; i < count; i++) {
+            tmp = cJSON_CreateObject();
+            if (tmp == NULL) {
+                WEB_ERROR("%s: create object failed\r\n", __func__);
+                cJSON_Delete(result);
+                cJSON_AddStringToObject(reply, "reason", "create object failed");
+                return -EPERM;
+            }
 
-        cJSON_AddItemToArray(result, tmp);
+            cJSON_AddNumberToObject(tmp, "object_type", object_id[i].type);
+            cJSON_AddNumberToObject(tmp, "object_instance", object_id[i].instance);
+            cJSON_AddItemToArray(result, tmp);
+        }
     }
 
     cJSON_AddItemToObject(reply, "result", result);
@@ -18,6 +18,7 @@
 
 #include "web_service.h"
 #include "misc/hashtable.h"
+#include "misc/trace.h"
 
 extern bool web_dbg_err;
 extern bool web_dbg_warn;
@@ -26,21 +27,21 @@ extern bool web_dbg_verbos;
 #define WEB_ERROR(fmt, args...)                     \
 do {                                                \
     if (web_dbg_err) {                              \
-        printf(fmt, ##args);                        \
+        TRACE_ERROR(fmt, ##args);                   \
     }                                               \
 } while (0)
  
 #define WEB_WARN(fmt, args...)                      \
 do {                                                \
     if (web_dbg_warn) {                             \
-        printf(fmt, ##args);                        \
+        TRACE_WARN(fmt, ##args);                    \
     }                                               \
 } while (0)
  
 #define WEB_VERBOS(fmt, args...)                    \
 do {                                                \
     if (web_dbg_verbos) {                           \
-        printf(fmt, ##args);                        \
+        TRACE_VERBOS(fmt, ##args);                  \
     }                                               \
 } while (0)
 